@@ -67,6 +67,7 @@ static const char* test_kind_name_table[] = {
   "FillFish",
   "FillDragon",
   "FillWorld",
+  "FillUnevenRound",
   "StrokeRectA",
   "StrokeRectU",
   "StrokeRectRot",
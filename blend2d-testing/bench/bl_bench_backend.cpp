@@ -33,6 +33,16 @@ static void BenchModule_shape_helper(Backend* mod, RenderOp op, ShapeKind shapeK
   mod->render_shape(op, shapeData);
 }
 
+// Renders rounded rectangles only in the top quarter of the screen, which concentrates the load in a few bands. This
+// measures how well an asynchronous renderer distributes uneven work between its threads.
+static void BenchModule_uneven_helper(Backend* mod, RenderOp op) {
+  uint32_t screen_h = mod->_params.screen_h;
+
+  mod->_params.screen_h = screen_h / 4u < mod->_params.shape_size ? mod->_params.shape_size : screen_h / 4u;
+  mod->render_round_f(op);
+  mod->_params.screen_h = screen_h;
+}
+
 void Backend::run(const BenchApp& app, const BenchParams& params) {
   _params = params;
 
@@ -66,6 +76,7 @@ void Backend::run(const BenchApp& app, const BenchParams& params) {
     case TestKind::kFillFish          : BenchModule_shape_helper(this, RenderOp::kFillNonZero, ShapeKind::kFish); break;
     case TestKind::kFillDragon        : BenchModule_shape_helper(this, RenderOp::kFillNonZero, ShapeKind::kDragon); break;
     case TestKind::kFillWorld         : BenchModule_shape_helper(this, RenderOp::kFillNonZero, ShapeKind::kWorld); break;
+    case TestKind::kFillUnevenRound   : BenchModule_uneven_helper(this, RenderOp::kFillNonZero); break;
 
     case TestKind::kStrokeAlignedRect : render_rect_a(RenderOp::kStroke); break;
     case TestKind::kStrokeSmoothRect  : render_rect_f(RenderOp::kStroke); break;
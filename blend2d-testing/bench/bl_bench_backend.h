@@ -47,6 +47,7 @@ enum class TestKind : uint32_t {
   kFillFish,
   kFillDragon,
   kFillWorld,
+  kFillUnevenRound,
 
   kStrokeAlignedRect,
   kStrokeSmoothRect,
@@ -0,0 +1,159 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/blend2d.h>
+#include <blend2d-testing/commons/cmdline.h>
+#include <blend2d-testing/commons/performance_timer.h>
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+// Private headers define static functions, which are not used by this benchmark.
+#if defined(__GNUC__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
+#include <blend2d/opentype/otface_p.h>
+
+#if defined(__GNUC__)
+  #pragma GCC diagnostic pop
+#endif
+
+#include <stdio.h>
+
+#include <vector>
+
+// Benchmarks mapping of text to glyphs (character to glyph mapping) of a font that uses a CMAP format 4 sub-table,
+// which requires a binary search per code point unless the mapping is cached by the font face. The uncached mapping
+// is measured by a font face that uses the search function of its CMAP sub-table directly.
+
+namespace blbench {
+
+static constexpr char sample_text[] = "The quick brown fox jumps over the lazy dog. Grüße, déjà vu! 0123456789 ";
+
+static void fill_latin_text(std::vector<uint32_t>& text, size_t size) {
+  text.resize(size);
+  for (size_t i = 0; i < size; i++)
+    text[i] = uint8_t(sample_text[i % (sizeof(sample_text) - 1u)]);
+}
+
+// Code points spread over the whole BMP, so the mapping cannot be served by the Latin-1 fast path.
+static void fill_bmp_text(std::vector<uint32_t>& text, size_t size) {
+  text.resize(size);
+  for (size_t i = 0; i < size; i++)
+    text[i] = uint32_t((i * 0x9E37u) & 0xFFFFu);
+}
+
+// Makes the font face map text by the search function of its CMAP sub-table, which bypasses the mapping cache.
+static bool disable_cmap_cache(BLFontFace& face) {
+  bl::OpenType::OTFaceImpl* face_impl = bl::FontFaceInternal::get_impl<bl::OpenType::OTFaceImpl>(&face);
+  if (!face_impl->cmap_cache.uncached_func)
+    return false;
+
+  face_impl->funcs.map_text_to_glyphs = face_impl->cmap_cache.uncached_func;
+  return true;
+}
+
+static double bench_mapping(const BLFont& font, const std::vector<uint32_t>& text, uint32_t iterations) {
+  BLGlyphBuffer gb;
+  PerformanceTimer timer;
+
+  timer.start();
+  for (uint32_t i = 0; i < iterations; i++) {
+    gb.set_utf32_text(text.data(), text.size());
+    font.map_text_to_glyphs(gb);
+  }
+  timer.stop();
+
+  return timer.duration();
+}
+
+// Maps the text once by a fresh font face, which has an empty mapping cache. The time required to create the face
+// is measured separately and subtracted.
+static double bench_cold_mapping(const BLFontData& font_data, const std::vector<uint32_t>& text, uint32_t iterations) {
+  PerformanceTimer timer;
+
+  timer.start();
+  for (uint32_t i = 0; i < iterations; i++) {
+    BLFontFace face;
+    BLFont font;
+    face.create_from_data(font_data, 0);
+    font.create_from_face(face, 16.0f);
+  }
+  timer.stop();
+  double create_ms = timer.duration();
+
+  BLGlyphBuffer gb;
+  timer.start();
+  for (uint32_t i = 0; i < iterations; i++) {
+    BLFontFace face;
+    BLFont font;
+    face.create_from_data(font_data, 0);
+    font.create_from_face(face, 16.0f);
+
+    gb.set_utf32_text(text.data(), text.size());
+    font.map_text_to_glyphs(gb);
+  }
+  timer.stop();
+
+  double total_ms = timer.duration();
+  return total_ms > create_ms ? total_ms - create_ms : 0.0;
+}
+
+static int run(int argc, char* argv[]) {
+  CmdLine cmd_line(argc, argv);
+
+  if (cmd_line.has_arg("--help")) {
+    printf("Usage:\n");
+    printf("  bl_bench_cmap [options]\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --size=<n>       - Number of code points to map [default 4096]\n");
+    printf("  --iterations=<n> - Number of iterations [default 256]\n");
+    return 0;
+  }
+
+  size_t size = cmd_line.value_as_uint("--size", 4096);
+  uint32_t iterations = cmd_line.value_as_uint("--iterations", 256);
+
+  BLFontData font_data;
+  BLFontFace face;
+  BLFontFace uncached_face;
+  BLFont font;
+  BLFont uncached_font;
+
+  if (font_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)) != BL_SUCCESS ||
+      face.create_from_data(font_data, 0) != BL_SUCCESS ||
+      uncached_face.create_from_data(font_data, 0) != BL_SUCCESS ||
+      font.create_from_face(face, 16.0f) != BL_SUCCESS) {
+    printf("Failed to load the font\n");
+    return 1;
+  }
+
+  if (!disable_cmap_cache(uncached_face) || uncached_font.create_from_face(uncached_face, 16.0f) != BL_SUCCESS) {
+    printf("The font doesn't use a cached CMAP mapping\n");
+    return 1;
+  }
+
+  std::vector<uint32_t> latin_text;
+  std::vector<uint32_t> bmp_text;
+
+  fill_latin_text(latin_text, size);
+  fill_bmp_text(bmp_text, size);
+
+  printf("Mapping %zu code points %u times:\n", size, iterations);
+  printf("  Latin-1 (uncached) : %10.3f [ms]\n", bench_mapping(uncached_font, latin_text, iterations));
+  printf("  Latin-1 (warm)     : %10.3f [ms]\n", bench_mapping(font, latin_text, iterations));
+  printf("  BMP     (uncached) : %10.3f [ms]\n", bench_mapping(uncached_font, bmp_text, iterations));
+  printf("  BMP     (warm)     : %10.3f [ms]\n", bench_mapping(font, bmp_text, iterations));
+  printf("  BMP     (cold)     : %10.3f [ms]\n", bench_cold_mapping(font_data, bmp_text, iterations));
+
+  return 0;
+}
+
+} // {blbench}
+
+int main(int argc, char* argv[]) {
+  return blbench::run(argc, argv);
+}
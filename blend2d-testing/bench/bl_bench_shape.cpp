@@ -0,0 +1,81 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/blend2d.h>
+#include <blend2d-testing/commons/cmdline.h>
+#include <blend2d-testing/commons/performance_timer.h>
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+#include <stdio.h>
+
+// Benchmarks shaping of a paragraph, which mixes glyphs covered by GPOS lookups (kerning pairs) with glyphs that
+// no lookup covers (digits, spaces, and punctuation).
+
+namespace blbench {
+
+static constexpr char sample_text[] = "Typography: AVAV To Ta Te Yo WA 1024 px, 75 %. ";
+
+static double bench_shaping(const BLFont& font, const BLString& text, uint32_t iterations) {
+  BLGlyphBuffer gb;
+  PerformanceTimer timer;
+
+  timer.start();
+  for (uint32_t i = 0; i < iterations; i++) {
+    gb.set_utf8_text(text.data(), text.size());
+    font.shape(gb);
+  }
+  timer.stop();
+
+  return timer.duration();
+}
+
+static int run(int argc, char* argv[]) {
+  CmdLine cmd_line(argc, argv);
+
+  if (cmd_line.has_arg("--help")) {
+    printf("Usage:\n");
+    printf("  bl_bench_shape [options]\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --repeat=<n>     - Number of sample sentences in the paragraph [default 64]\n");
+    printf("  --iterations=<n> - Number of iterations [default 256]\n");
+    return 0;
+  }
+
+  uint32_t repeat = cmd_line.value_as_uint("--repeat", 64);
+  uint32_t iterations = cmd_line.value_as_uint("--iterations", 256);
+
+  BLFontData font_data;
+  BLFontFace face;
+  BLFont kerned_font;
+  BLFont unkerned_font;
+
+  BLFontFeatureSettings unkerned_settings;
+  unkerned_settings.set_value(BL_MAKE_TAG('k', 'e', 'r', 'n'), 0u);
+
+  if (font_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)) != BL_SUCCESS ||
+      face.create_from_data(font_data, 0) != BL_SUCCESS ||
+      kerned_font.create_from_face(face, 20.0f) != BL_SUCCESS ||
+      unkerned_font.create_from_face(face, 20.0f, unkerned_settings) != BL_SUCCESS) {
+    printf("Failed to load the font\n");
+    return 1;
+  }
+
+  BLString text;
+  for (uint32_t i = 0; i < repeat; i++)
+    text.append(sample_text);
+
+  printf("Shaping %zu characters %u times:\n", text.size(), iterations);
+  printf("  Kerning enabled  : %10.3f [ms]\n", bench_shaping(kerned_font, text, iterations));
+  printf("  Kerning disabled : %10.3f [ms]\n", bench_shaping(unkerned_font, text, iterations));
+
+  return 0;
+}
+
+} // {blbench}
+
+int main(int argc, char* argv[]) {
+  return blbench::run(argc, argv);
+}
@@ -33,10 +33,32 @@ static constexpr CodecFeatureNameEntry codec_features_table[] = {
   { BL_IMAGE_CODEC_FEATURE_XMP        , "xmp"         }
 };
 
+struct CpuFeatureNameEntry {
+  uint32_t arch;
+  uint32_t feature;
+  char name[8];
+};
+
+static constexpr CpuFeatureNameEntry cpu_features_table[] = {
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_SSE2  , "sse2"   },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_SSE3  , "sse3"   },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_SSSE3 , "ssse3"  },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_SSE4_1, "sse4.1" },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_SSE4_2, "sse4.2" },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_AVX   , "avx"    },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_AVX2  , "avx2"   },
+  { BL_RUNTIME_CPU_ARCH_X86, BL_RUNTIME_CPU_FEATURE_X86_AVX512, "avx512" },
+  { BL_RUNTIME_CPU_ARCH_ARM, BL_RUNTIME_CPU_FEATURE_ARM_ASIMD , "asimd"  },
+  { BL_RUNTIME_CPU_ARCH_ARM, BL_RUNTIME_CPU_FEATURE_ARM_CRC32 , "crc32"  },
+  { BL_RUNTIME_CPU_ARCH_ARM, BL_RUNTIME_CPU_FEATURE_ARM_PMULL , "pmull"  }
+};
+
 enum class TestKind : uint8_t {
   kNone,
   kSingleImage,
-  kCompareImages
+  kCompareImages,
+  kEncodeImage,
+  kDecodeImage
 };
 
 struct TestOptions {
@@ -45,6 +67,12 @@ struct TestOptions {
   const char* base_dir {};
   const char* file1 {};
   const char* file2 {};
+  const char* codec {};
+  uint32_t quality {};
+  uint32_t subsampling {};
+  bool optimize {};
+  uint32_t repeat {};
+  uint32_t scale {};
 };
 
 struct LoadedImage {
@@ -92,6 +120,8 @@ public:
 
   bool test_single_file(const char* base_dir, const char* file_name);
   bool compare_files(const char* base_dir, const char* fileName1, const char* fileName2);
+  bool encode_file(const char* base_dir, const char* file_name);
+  bool decode_file(const char* base_dir, const char* file_name);
 
   int run(CmdLine cmd_line);
 };
@@ -104,12 +134,17 @@ TestApp::~TestApp() {}
 
 TestOptions TestApp::make_default_options() {
   TestOptions options {};
+  options.codec = "JPEG";
+  options.quality = 90;
+  options.subsampling = 420;
+  options.repeat = 10;
+  options.scale = 1;
   return options;
 }
 
 int TestApp::help() {
   printf("Usage:\n");
-  printf("  bl_test_image_io [options] --<file|compare> [--help for help]\n");
+  printf("  bl_test_image_io [options] --<file|compare|encode|decode> [--help for help]\n");
   printf("\n");
 
   printf("Purpose:\n");
@@ -125,6 +160,12 @@ int TestApp::help() {
 bool TestApp::parse_options(CmdLine cmd_line) {
   options.base_dir = cmd_line.value_of("--base-dir", nullptr);
   options.quiet = cmd_line.has_arg("--quiet") || default_options.quiet;
+  options.codec = cmd_line.value_of("--codec", default_options.codec);
+  options.quality = cmd_line.value_as_uint("--quality", default_options.quality);
+  options.subsampling = cmd_line.value_as_uint("--subsampling", default_options.subsampling);
+  options.optimize = cmd_line.has_arg("--optimize") || default_options.optimize;
+  options.repeat = cmd_line.value_as_uint("--repeat", default_options.repeat);
+  options.scale = cmd_line.value_as_uint("--scale", default_options.scale);
 
   TestKind kind = TestKind::kNone;
 
@@ -134,6 +175,12 @@ bool TestApp::parse_options(CmdLine cmd_line) {
   else if (cmd_line.has_arg("--compare")) {
     kind = TestKind::kCompareImages;
   }
+  else if (cmd_line.value_of("--encode", nullptr)) {
+    kind = TestKind::kEncodeImage;
+  }
+  else if (cmd_line.value_of("--decode", nullptr)) {
+    kind = TestKind::kDecodeImage;
+  }
 
   switch (kind) {
     case TestKind::kSingleImage: {
@@ -154,6 +201,31 @@ bool TestApp::parse_options(CmdLine cmd_line) {
       break;
     }
 
+    case TestKind::kEncodeImage: {
+      options.file1 = cmd_line.value_of("--encode", nullptr);
+
+      if (options.repeat == 0) {
+        printf("Failed to process command line arguments: Invalid --repeat (must be greater than zero)\n");
+        return false;
+      }
+      break;
+    }
+
+    case TestKind::kDecodeImage: {
+      options.file1 = cmd_line.value_of("--decode", nullptr);
+
+      if (options.repeat == 0) {
+        printf("Failed to process command line arguments: Invalid --repeat (must be greater than zero)\n");
+        return false;
+      }
+
+      if (options.scale == 0) {
+        printf("Failed to process command line arguments: Invalid --scale (must be greater than zero)\n");
+        return false;
+      }
+      break;
+    }
+
     default:
       break;
   }
@@ -186,6 +258,14 @@ void TestApp::print_options() const {
   printf("  --base-dir=<string>         - Base working directory                [default=<none>]\n");
   printf("  --file=<string>             - Path to a single file to decode       [default=<none>]\n");
   printf("  --compare <string> <string> - Path to two files to decode & compare [default=<none>]\n");
+  printf("  --encode=<string>           - Path to a file to decode & encode     [default=<none>]\n");
+  printf("  --decode=<string>           - Path to a file to decode repeatedly   [default=<none>]\n");
+  printf("  --codec=<string>            - Codec used by --encode                [default=%s]\n", options.codec);
+  printf("  --quality=<uint>            - Encoder quality (lossy codecs)        [default=%u]\n", options.quality);
+  printf("  --subsampling=<uint>        - Chroma subsampling (444|422|420)      [default=%u]\n", options.subsampling);
+  printf("  --optimize                  - Optimize entropy coding (JPEG)        [default=%s]\n", bool_to_string(options.optimize));
+  printf("  --scale=<uint>              - Decoder scale denominator (JPEG)      [default=%u]\n", options.scale);
+  printf("  --repeat=<uint>             - Number of codec runs to measure       [default=%u]\n", options.repeat);
   printf("  --quiet                     - Don't write log unless necessary      [default=%s]\n", bool_to_string(options.quiet));
   printf("\n");
 }
@@ -303,6 +383,158 @@ bool TestApp::compare_files(const char* base_dir, const char* fileName1, const c
   return true;
 }
 
+bool TestApp::encode_file(const char* base_dir, const char* file_name) {
+  LoadedImage i = load_image(base_dir, file_name);
+
+  if (i.result != BL_SUCCESS) {
+    printf("[%s] Error loading image (result=0x%08X)\n", file_name, i.result);
+    return false;
+  }
+
+  printf("[%s] loaded in %0.3f [ms] size=%ux%u format=%s\n", file_name, i.duration, i.image.size().w, i.image.size().h, format_to_string(i.image.format()));
+
+  BLImageCodec codec;
+  if (codec.find_by_name(options.codec) != BL_SUCCESS) {
+    printf("Codec '%s' not found\n", options.codec);
+    return false;
+  }
+
+  BLImageEncoder encoder;
+  BLResult result = codec.create_encoder(&encoder);
+
+  if (result != BL_SUCCESS) {
+    printf("[%s] Error creating encoder (result=0x%08X)\n", options.codec, result);
+    return false;
+  }
+
+  BLArray<uint8_t> encoded_data;
+  double best_duration = 0.0;
+
+  for (uint32_t run = 0; run < options.repeat; run++) {
+    PerformanceTimer timer;
+    encoded_data.clear();
+
+    // Restart resets encoder properties, so they have to be set again. Properties not supported by the encoder
+    // are ignored, which makes it possible to benchmark all codecs that provide an encoder.
+    encoder.restart();
+    encoder.set_property("quality", BLVar(options.quality));
+    encoder.set_property("subsampling", BLVar(options.subsampling));
+    encoder.set_property("optimize", BLVar(options.optimize));
+
+    timer.start();
+    result = encoder.write_frame(encoded_data, i.image);
+    timer.stop();
+
+    if (result != BL_SUCCESS) {
+      printf("[%s] Error encoding image (result=0x%08X)\n", options.codec, result);
+      return false;
+    }
+
+    if (run == 0 || timer.duration() < best_duration)
+      best_duration = timer.duration();
+  }
+
+  double pixels = double(i.image.width()) * double(i.image.height());
+  double mpix_per_second = pixels / (best_duration * 1000.0);
+
+  printf("[%s] encoded in %0.3f [ms] (best of %u) size=%zu [bytes] throughput=%0.2f [MPix/s]\n",
+    options.codec, best_duration, options.repeat, encoded_data.size(), mpix_per_second);
+
+  // Verify that the encoded image can be decoded back and report the difference from the source image.
+  BLImage decoded;
+  result = decoded.read_from_data(encoded_data);
+
+  if (result != BL_SUCCESS) {
+    printf("[%s] Error decoding encoded image (result=0x%08X)\n", options.codec, result);
+    return false;
+  }
+
+  ImageUtils::DiffInfo diff = ImageUtils::diff_info(i.image, decoded);
+  if (diff.max_diff != 0xFFFFFFFFu) {
+    printf("[%s] decoded MaximumDifference=%llu AverageDifference=%0.3f\n",
+      options.codec,
+      (unsigned long long)diff.max_diff,
+      double(diff.cumulative_diff) / pixels);
+  }
+
+  return true;
+}
+
+bool TestApp::decode_file(const char* base_dir, const char* file_name) {
+  BLString full_path;
+
+  if (base_dir && !is_absolute_path(file_name)) {
+    full_path.append(base_dir);
+    if (full_path.size() > 0 && full_path[full_path.size() - 1] != '/')
+      full_path.append('/');
+    full_path.append(file_name);
+  }
+  else {
+    full_path.append(file_name);
+  }
+
+  BLArray<uint8_t> encoded_data;
+  BLResult result = BLFileSystem::read_file(full_path.data(), encoded_data);
+
+  if (result != BL_SUCCESS) {
+    printf("[%s] Error reading file (result=0x%08X)\n", file_name, result);
+    return false;
+  }
+
+  BLImageCodec codec;
+  if (codec.find_by_data(encoded_data) != BL_SUCCESS) {
+    printf("[%s] Unknown image format\n", file_name);
+    return false;
+  }
+
+  // Decoder timings depend on which SIMD kernels were selected at runtime, so report CPU features with the results.
+  BLRuntimeSystemInfo system_info;
+  BLRuntime::query_system_info(&system_info);
+
+  BLString features;
+  for (const CpuFeatureNameEntry& entry : cpu_features_table) {
+    if (entry.arch == system_info.cpu_arch && (system_info.cpu_features & entry.feature) != 0) {
+      if (!features.is_empty())
+        features.append("|");
+      features.append(entry.name);
+    }
+  }
+
+  printf("[cpu] %s features=%s\n", system_info.cpu_brand[0] ? system_info.cpu_brand : "unknown", features.is_empty() ? "none" : features.data());
+
+  BLImage image;
+  double best_duration = 0.0;
+
+  for (uint32_t run = 0; run < options.repeat; run++) {
+    PerformanceTimer timer;
+    BLImageDecoder decoder;
+
+    timer.start();
+    result = codec.create_decoder(&decoder);
+    if (result == BL_SUCCESS && options.scale != 1)
+      result = decoder.set_property("scale_denom", BLVar(options.scale));
+    if (result == BL_SUCCESS)
+      result = decoder.read_frame(image, encoded_data);
+    timer.stop();
+
+    if (result != BL_SUCCESS) {
+      printf("[%s] Error decoding image (result=0x%08X)\n", codec.name().data(), result);
+      return false;
+    }
+
+    if (run == 0 || timer.duration() < best_duration)
+      best_duration = timer.duration();
+  }
+
+  double pixels = double(image.width()) * double(image.height());
+  double mpix_per_second = pixels / (best_duration * 1000.0);
+
+  printf("[%s] decoded in %0.3f [ms] (best of %u) size=%ux%u format=%s throughput=%0.2f [MPix/s]\n",
+    codec.name().data(), best_duration, options.repeat, image.width(), image.height(), format_to_string(image.format()), mpix_per_second);
+
+  return true;
+}
+
 int TestApp::run(CmdLine cmd_line) {
   print_app_info("Blend2D Image Codecs Tester", cmd_line.has_arg("--quiet"));
 
@@ -333,6 +565,20 @@ int TestApp::run(CmdLine cmd_line) {
         return 0;
     }
 
+    case TestKind::kEncodeImage: {
+      if (!encode_file(options.base_dir, options.file1))
+        return 1;
+      else
+        return 0;
+    }
+
+    case TestKind::kDecodeImage: {
+      if (!decode_file(options.base_dir, options.file1))
+        return 1;
+      else
+        return 0;
+    }
+
     default:
       return 1;
   }
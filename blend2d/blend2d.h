@@ -48,6 +48,7 @@
 #include <blend2d/core/bitarray.h>
 #include <blend2d/core/bitset.h>
 #include <blend2d/core/context.h>
+#include <blend2d/core/displaylist.h>
 #include <blend2d/core/filesystem.h>
 #include <blend2d/core/font.h>
 #include <blend2d/core/fontdata.h>
@@ -5,6 +5,7 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/format_p.h>
+#include <blend2d/core/imagedecoder_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/pixelconverter.h>
 #include <blend2d/core/rgba.h>
@@ -13,6 +14,7 @@
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/memops_p.h>
 #include <blend2d/support/ptrops_p.h>
+#include <blend2d/support/scopedbuffer_p.h>
 #include <blend2d/support/traits_p.h>
 
 namespace bl::Bmp {
@@ -531,15 +533,10 @@ static BLResult decoder_read_info_internal(BLBmpDecoderImpl* decoder_impl, const
   return BL_SUCCESS;
 }
 
-static BLResult decoder_read_frame_internal(BLBmpDecoderImpl* decoder_impl, BLImage* image_out, const uint8_t* data, size_t size) noexcept {
-  const uint8_t* start = data;
+// Reads the palette (if the image is indexed) and verifies that the whole pixel data is present in the buffer.
+static BLResult decoder_read_palette_and_pixels(BLBmpDecoderImpl* decoder_impl, BLRgba32* pal, const uint8_t** pixels_out, const uint8_t* data, size_t size) noexcept {
   const uint8_t* end = data + size;
 
-  // Image info.
-  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
-  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
-
-  BLFormat format = decoder_impl->fmt.sizes[3] ? BL_FORMAT_PRGB32 : BL_FORMAT_XRGB32;
   uint32_t depth = decoder_impl->image_info.depth;
   uint32_t file_and_info_header_size = 14 + decoder_impl->info.header_size;
 
@@ -547,13 +544,9 @@ static BLResult decoder_read_frame_internal(BLBmpDecoderImpl* decoder_impl, BLIm
     return bl_make_error(BL_ERROR_DATA_TRUNCATED);
   }
 
-  // Palette.
-  BLRgba32 pal[256];
-  uint32_t pal_size;
-
   if (depth <= 8) {
     const uint8_t* pPal = data + file_and_info_header_size;
-    pal_size = decoder_impl->file.image_offset - file_and_info_header_size;
+    uint32_t pal_size = decoder_impl->file.image_offset - file_and_info_header_size;
 
     uint32_t pal_entity_size = decoder_impl->info.header_size == kHeaderSizeOS2_V1 ? 3 : 4;
     uint32_t pal_bytes_total;
@@ -586,7 +579,42 @@ static BLResult decoder_read_frame_internal(BLBmpDecoderImpl* decoder_impl, BLIm
     return bl_make_error(BL_ERROR_DATA_TRUNCATED);
   }
 
-  data += decoder_impl->file.image_offset;
+  *pixels_out = data + decoder_impl->file.image_offset;
+  return BL_SUCCESS;
+}
+
+static BL_INLINE bool decoder_is_rle(const BLBmpDecoderImpl* decoder_impl) noexcept {
+  uint32_t depth = decoder_impl->image_info.depth;
+  uint32_t compression = decoder_impl->info.win.compression;
+
+  return (depth == 4 && compression == kCompressionRLE4) || (depth == 8 && compression == kCompressionRLE8);
+}
+
+static BLResult decoder_create_converter(BLBmpDecoderImpl* decoder_impl, BLPixelConverter& pc, BLFormat format, BLRgba32* pal) noexcept {
+  BLFormatInfo fmt = decoder_impl->fmt;
+
+  if (decoder_impl->image_info.depth <= 8) {
+    fmt.palette = pal;
+  }
+
+  return pc.create(bl_format_info[format], fmt,
+    BLPixelConverterCreateFlags(
+      BL_PIXEL_CONVERTER_CREATE_FLAG_DONT_COPY_PALETTE |
+      BL_PIXEL_CONVERTER_CREATE_FLAG_ALTERABLE_PALETTE));
+}
+
+static BLResult decoder_read_frame_internal(BLBmpDecoderImpl* decoder_impl, BLImage* image_out, const uint8_t* data, size_t size) noexcept {
+  const uint8_t* start = data;
+
+  // Image info.
+  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
+  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
+
+  BLFormat format = decoder_impl->fmt.sizes[3] ? BL_FORMAT_PRGB32 : BL_FORMAT_XRGB32;
+  uint32_t depth = decoder_impl->image_info.depth;
+
+  BLRgba32 pal[256];
+  BL_PROPAGATE(decoder_read_palette_and_pixels(decoder_impl, pal, &data, data, size));
 
   // Make sure that the destination image has the correct pixel format and size.
   BLImageData image_data;
@@ -611,20 +639,73 @@ static BLResult decoder_read_frame_internal(BLBmpDecoderImpl* decoder_impl, BLIm
   }
   else {
     BLPixelConverter pc;
+    BL_PROPAGATE(decoder_create_converter(decoder_impl, pc, format, pal));
+    pc.convert_rect(dst_line, dst_stride, data, intptr_t(decoder_impl->stride), w, h);
+  }
 
-    if (depth <= 8) {
-      decoder_impl->fmt.palette = pal;
-    }
+  decoder_impl->buffer_index = PtrOps::byte_offset(start, data);
+  decoder_impl->frame_index++;
 
-    BL_PROPAGATE(pc.create(bl_format_info[format], decoder_impl->fmt,
-      BLPixelConverterCreateFlags(
-        BL_PIXEL_CONVERTER_CREATE_FLAG_DONT_COPY_PALETTE |
-        BL_PIXEL_CONVERTER_CREATE_FLAG_ALTERABLE_PALETTE)));
-    pc.convert_rect(dst_line, dst_stride, data, intptr_t(decoder_impl->stride), w, h);
+  return BL_SUCCESS;
+}
 
-    if (depth <= 8) {
-      decoder_impl->fmt.palette = nullptr;
-    }
+static BLResult decoder_read_frame_rows_internal(BLBmpDecoderImpl* decoder_impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  // RLE compressed images are stored bottom-up and use escapes that skip pixels, thus the frame is decoded as a whole.
+  if (decoder_is_rle(decoder_impl)) {
+    return ImageDecoderInternal::read_frame_rows_fallback(decoder_impl, roi, func, user_data, data, size);
+  }
+
+  const uint8_t* start = data;
+
+  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
+  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
+
+  BLFormat format = decoder_impl->fmt.sizes[3] ? BL_FORMAT_PRGB32 : BL_FORMAT_XRGB32;
+  uint32_t depth = decoder_impl->image_info.depth;
+
+  BLRgba32 pal[256];
+  BL_PROPAGATE(decoder_read_palette_and_pixels(decoder_impl, pal, &data, data, size));
+
+  BLPixelConverter pc;
+  BL_PROPAGATE(decoder_create_converter(decoder_impl, pc, format, pal));
+
+  // Pixels that are not byte aligned are converted for the whole row and the region is selected after conversion.
+  uint32_t conv_x = depth >= 8 ? uint32_t(roi.x) : 0u;
+  uint32_t conv_w = depth >= 8 ? uint32_t(roi.w) : w;
+  size_t band_offset = depth >= 8 ? size_t(0) : size_t(roi.x) * 4u;
+
+  intptr_t band_stride = intptr_t(IntOps::align_up(size_t(conv_w) * 4u, 16));
+  uint32_t band_h = ImageDecoderInternal::band_height(size_t(band_stride), uint32_t(roi.h));
+
+  ScopedBuffer band_buffer;
+  uint8_t* band_data = static_cast<uint8_t*>(band_buffer.alloc(size_t(band_stride) * band_h));
+
+  if (BL_UNLIKELY(!band_data)) {
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+  }
+
+  // Rows are stored bottom-up unless the height is negative.
+  intptr_t src_stride = intptr_t(decoder_impl->stride);
+  const uint8_t* src_line = data + size_t(conv_x) * depth / 8u;
+
+  if (decoder_impl->info.win.height > 0) {
+    src_line += intptr_t(h - 1) * src_stride;
+    src_stride = -src_stride;
+  }
+
+  src_line += intptr_t(roi.y) * src_stride;
+
+  int y = roi.y;
+  int y_end = roi.y + roi.h;
+
+  while (y < y_end) {
+    uint32_t n = bl_min<uint32_t>(band_h, uint32_t(y_end - y));
+
+    pc.convert_rect(band_data, band_stride, src_line, src_stride, conv_w, n);
+    BL_PROPAGATE(ImageDecoderInternal::emit_band(func, user_data, band_data + band_offset, band_stride, roi.w, int(n), format, y));
+
+    src_line += intptr_t(n) * src_stride;
+    y += int(n);
   }
 
   decoder_impl->buffer_index = PtrOps::byte_offset(start, data);
@@ -680,6 +761,19 @@ static BLResult BL_CDECL decoder_read_frame_impl(BLImageDecoderImpl* impl, BLIma
   return result;
 }
 
+static BLResult BL_CDECL decoder_read_frame_rows_impl(BLImageDecoderImpl* impl, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  BLBmpDecoderImpl* decoder_impl = static_cast<BLBmpDecoderImpl*>(impl);
+  BL_PROPAGATE(decoder_read_info_impl(decoder_impl, nullptr, data, size));
+
+  if (decoder_impl->frame_index)
+    return bl_make_error(BL_ERROR_NO_MORE_DATA);
+
+  BLResult result = decoder_read_frame_rows_internal(decoder_impl, *roi, func, user_data, data, size);
+  if (result != BL_SUCCESS)
+    decoder_impl->last_result = result;
+  return result;
+}
+
 static BLResult BL_CDECL decoder_create_impl(BLImageDecoderCore* self) noexcept {
   BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE_DECODER);
   BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLBmpDecoderImpl>(self, info));
@@ -930,9 +1024,10 @@ void bmp_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noex
   bmp_codec.virt.create_encoder = codec_create_encoder_impl;
 
   bmp_codec.impl->ctor(&bmp_codec.virt);
-  bmp_codec.impl->features = BLImageCodecFeatures(BL_IMAGE_CODEC_FEATURE_READ     |
-                                                  BL_IMAGE_CODEC_FEATURE_WRITE    |
-                                                  BL_IMAGE_CODEC_FEATURE_LOSSLESS);
+  bmp_codec.impl->features = BLImageCodecFeatures(BL_IMAGE_CODEC_FEATURE_READ      |
+                                                  BL_IMAGE_CODEC_FEATURE_WRITE     |
+                                                  BL_IMAGE_CODEC_FEATURE_LOSSLESS  |
+                                                  BL_IMAGE_CODEC_FEATURE_READ_ROWS);
   bmp_codec.impl->name.dcast().assign("BMP");
   bmp_codec.impl->vendor.dcast().assign("Blend2D");
   bmp_codec.impl->mime_type.dcast().assign("image/x-bmp");
@@ -947,6 +1042,7 @@ void bmp_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noex
   bmp_decoder_virt.restart = decoder_restart_impl;
   bmp_decoder_virt.read_info = decoder_read_info_impl;
   bmp_decoder_virt.read_frame = decoder_read_frame_impl;
+  bmp_decoder_virt.read_frame_rows = decoder_read_frame_rows_impl;
 
   // Initialize BMP encoder virtual functions.
   bmp_encoder_virt.base.destroy = encoder_destroy_impl;
@@ -8,11 +8,13 @@
 
 #include <blend2d/core/array.h>
 #include <blend2d/core/context.h>
+#include <blend2d/core/gradient.h>
 #include <blend2d/core/image.h>
 #include <blend2d/core/imagecodec.h>
 #include <blend2d/core/imagedecoder.h>
 #include <blend2d/core/imageencoder.h>
 #include <blend2d/core/random.h>
+#include <blend2d/core/var.h>
 
 #include <blend2d-testing/commons/imagediff.h>
 
@@ -88,6 +90,7 @@ static void render_simple_image(BLImage& image, BLRandom& rnd, uint32_t cmd_coun
 
 struct TestOptions {
   uint32_t compression_level = 0xFFFFFFFFu;
+  uint32_t thread_count = 0;
 
   BL_INLINE bool has_compression_level() const noexcept { return compression_level != 0xFFFFFFFFu; }
 };
@@ -106,6 +109,10 @@ static void test_encoding_decoding_random_images(BLSizeI size, BLFormat fmt, BLI
       EXPECT_SUCCESS(encoder.set_property("compression", BLVar(test_options.compression_level)));
     }
 
+    if (test_options.thread_count) {
+      EXPECT_SUCCESS(encoder.set_property("thread_count", BLVar(test_options.thread_count)));
+    }
+
     BLArray<uint8_t> encoded_data;
     encoder.write_frame(encoded_data, image1);
 
@@ -120,6 +127,77 @@ static void test_encoding_decoding_random_images(BLSizeI size, BLFormat fmt, BLI
   }
 }
 
+//! Minimum area of an image that is checked against `JpegTestOptions::max_average_diff` when the image is not
+//! encoded with the highest quality and without chroma subsampling.
+static constexpr uint32_t kJpegMinToleranceArea = 4096;
+
+struct JpegTestOptions {
+  uint32_t quality;
+  uint32_t subsampling;
+  bool optimize;
+  //! Maximum average difference of a pixel (per-pixel difference is the maximum difference of all channels).
+  double max_average_diff;
+};
+
+static void test_jpeg_encoding_decoding_random_images(BLSizeI size, BLFormat fmt, BLImageCodec& codec, BLRandom& rnd, uint32_t test_count, uint32_t cmd_count, const JpegTestOptions& test_options) noexcept {
+  for (uint32_t i = 0; i < test_count; i++) {
+    BLImage image1;
+
+    EXPECT_SUCCESS(image1.create(size.w, size.h, fmt));
+    render_simple_image(image1, rnd, cmd_count);
+
+    BLImageEncoder encoder;
+    EXPECT_SUCCESS(codec.create_encoder(&encoder));
+    EXPECT_SUCCESS(encoder.set_property("quality", BLVar(test_options.quality)));
+    EXPECT_SUCCESS(encoder.set_property("subsampling", BLVar(test_options.subsampling)));
+    EXPECT_SUCCESS(encoder.set_property("optimize", BLVar(test_options.optimize)));
+
+    BLArray<uint8_t> encoded_data;
+    EXPECT_SUCCESS(encoder.write_frame(encoded_data, image1));
+
+    BLImageDecoder decoder;
+    EXPECT_SUCCESS(codec.create_decoder(&decoder));
+
+    BLImage image2;
+    EXPECT_SUCCESS(decoder.read_frame(image2, encoded_data));
+
+    // JPEG decoder always produces XRGB32 images. Alpha of premultiplied images is dropped by the encoder, which is
+    // the same as compositing them over black, and grayscale images are replicated to all RGB channels.
+    BLImage expected;
+    BLImageData src_data;
+    BLImageData dst_data;
+
+    EXPECT_SUCCESS(image1.get_data(&src_data));
+    EXPECT_SUCCESS(expected.create(size.w, size.h, BL_FORMAT_XRGB32));
+    EXPECT_SUCCESS(expected.make_mutable(&dst_data));
+
+    for (int y = 0; y < size.h; y++) {
+      const uint8_t* src_line = static_cast<const uint8_t*>(src_data.pixel_data) + intptr_t(y) * src_data.stride;
+      uint32_t* dst_line = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(dst_data.pixel_data) + intptr_t(y) * dst_data.stride);
+
+      for (int x = 0; x < size.w; x++) {
+        if (fmt == BL_FORMAT_A8)
+          dst_line[x] = 0xFF000000u | (uint32_t(src_line[x]) * 0x010101u);
+        else
+          dst_line[x] = 0xFF000000u | reinterpret_cast<const uint32_t*>(src_line)[x];
+      }
+    }
+
+    ImageUtils::DiffInfo diff_info = ImageUtils::diff_info(expected, image2);
+    double average_diff = double(diff_info.cumulative_diff) / (double(size.w) * double(size.h));
+
+    // Tiny images are dominated by a few pixels at hard edges (and by chroma averaged across them when subsampled),
+    // so the average difference is only meaningful for them when the image is encoded (almost) losslessly.
+    bool lossless_enough = test_options.quality == 100 && test_options.subsampling == 444;
+    if (!lossless_enough && uint32_t(size.w) * uint32_t(size.h) < kJpegMinToleranceArea)
+      continue;
+
+    EXPECT_LE(average_diff, test_options.max_average_diff)
+      .message("Average difference %.2f exceeds %.2f (quality=%u subsampling=%u optimize=%u)",
+               average_diff, test_options.max_average_diff, test_options.quality, test_options.subsampling, unsigned(test_options.optimize));
+  }
+}
+
 static constexpr BLSizeI image_codec_test_sizes[] = {
   { 1, 1 },
   { 1, 2 },
@@ -176,6 +254,28 @@ UNIT(image_codec_png, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
   }
 }
 
+UNIT(image_codec_png_threads, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
+  static constexpr uint32_t kCmdCount = 50;
+  static constexpr uint32_t kTestCount = 2;
+
+  // Filtered image data must be large enough to be split into multiple parts compressed in parallel.
+  BLSizeI image_size(731, 487);
+  INFO("Testing PNG encoder with parallel compression & decoder with %dx%d images", image_size.w, image_size.h);
+
+  BLImageCodec codec;
+  EXPECT_SUCCESS(codec.find_by_name("PNG"));
+
+  BLRandom rnd(0x0F1E2D3C4B5A6978u);
+  for (uint32_t compression_level : { 0u, 1u, 6u, 9u, 12u }) {
+    TestOptions test_options{};
+    test_options.compression_level = compression_level;
+    test_options.thread_count = 4;
+
+    test_encoding_decoding_random_images(image_size, BL_FORMAT_XRGB32, codec, rnd, kTestCount, kCmdCount, test_options);
+    test_encoding_decoding_random_images(image_size, BL_FORMAT_PRGB32, codec, rnd, kTestCount, kCmdCount, test_options);
+  }
+}
+
 UNIT(image_codec_qoi, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
   static constexpr uint32_t kCmdCount = 10;
   static constexpr uint32_t kTestCount = 100;
@@ -193,6 +293,347 @@ UNIT(image_codec_qoi, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
   }
 }
 
+UNIT(image_codec_jpeg, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
+  static constexpr uint32_t kCmdCount = 10;
+  static constexpr uint32_t kTestCount = 10;
+
+  // JPEG is lossy, thus the tolerance depends on quality and chroma subsampling. Test images have hard edges,
+  // which is the worst case for JPEG, so the tolerance must be higher than what photographs would need.
+  static constexpr JpegTestOptions jpeg_test_options[] = {
+    { 100, 444, false, 2.5  },
+    { 100, 444, true , 2.5  },
+    { 90 , 444, false, 8.0  },
+    { 90 , 422, false, 10.0 },
+    { 90 , 420, true , 12.0 },
+    { 50 , 420, false, 20.0 }
+  };
+
+  for (BLSizeI image_size : image_codec_test_sizes) {
+    INFO("Testing JPEG encoder & decoder with %dx%d images", image_size.w, image_size.h);
+
+    BLImageCodec codec;
+    EXPECT_SUCCESS(codec.find_by_name("JPEG"));
+
+    BLRandom rnd(0x123456789ABCDEFu);
+    for (const JpegTestOptions& test_options : jpeg_test_options) {
+      test_jpeg_encoding_decoding_random_images(image_size, BL_FORMAT_XRGB32, codec, rnd, kTestCount, kCmdCount, test_options);
+      test_jpeg_encoding_decoding_random_images(image_size, BL_FORMAT_PRGB32, codec, rnd, kTestCount, kCmdCount, test_options);
+      test_jpeg_encoding_decoding_random_images(image_size, BL_FORMAT_A8, codec, rnd, kTestCount, kCmdCount, test_options);
+    }
+  }
+}
+
+// Collects rows passed to `BLImageDecoderRowsFunc` and verifies that bands are contiguous.
+struct RowCollector {
+  BLImage image;
+  BLRectI roi {};
+  int next_y = 0;
+  bool contiguous = true;
+};
+
+static BLResult BL_CDECL collect_rows_func(const BLImageData* rows, int y, void* user_data) noexcept {
+  RowCollector* collector = static_cast<RowCollector*>(user_data);
+
+  if (collector->image.is_empty()) {
+    BL_PROPAGATE(collector->image.create(collector->roi.w, collector->roi.h, BLFormat(rows->format)));
+  }
+
+  if (y != collector->next_y || rows->size.w != collector->roi.w || y + rows->size.h > collector->roi.y + collector->roi.h) {
+    collector->contiguous = false;
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+  }
+
+  BLImageData dst;
+  BL_PROPAGATE(collector->image.make_mutable(&dst));
+
+  size_t bytes_per_line = size_t(rows->size.w) * (collector->image.depth() / 8u);
+  for (int i = 0; i < rows->size.h; i++) {
+    memcpy(static_cast<uint8_t*>(dst.pixel_data) + intptr_t(y - collector->roi.y + i) * dst.stride,
+           static_cast<const uint8_t*>(rows->pixel_data) + intptr_t(i) * rows->stride, bytes_per_line);
+  }
+
+  collector->next_y = y + rows->size.h;
+  return BL_SUCCESS;
+}
+
+static bool image_matches_region(const BLImage& full, const BLImage& region, const BLRectI& roi) noexcept {
+  BLImageData a;
+  BLImageData b;
+
+  if (full.get_data(&a) != BL_SUCCESS || region.get_data(&b) != BL_SUCCESS)
+    return false;
+
+  if (a.format != b.format || b.size.w != roi.w || b.size.h != roi.h)
+    return false;
+
+  size_t bpp = full.depth() / 8u;
+  for (int y = 0; y < roi.h; y++) {
+    const uint8_t* a_line = static_cast<const uint8_t*>(a.pixel_data) + intptr_t(roi.y + y) * a.stride + size_t(roi.x) * bpp;
+    const uint8_t* b_line = static_cast<const uint8_t*>(b.pixel_data) + intptr_t(y) * b.stride;
+
+    if (memcmp(a_line, b_line, size_t(roi.w) * bpp) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+// Verifies that decoding rows or a region produces the same pixels as decoding the whole frame.
+static void test_decoding_rows(const BLImageCodec& codec, const BLArray<uint8_t>& encoded_data, BLRandom& rnd, uint32_t scale_denom = 1) noexcept {
+  BLImageDecoder decoder;
+  auto create_decoder = [&]() {
+    EXPECT_SUCCESS(codec.create_decoder(&decoder));
+    if (scale_denom != 1)
+      EXPECT_SUCCESS(decoder.set_property("scale_denom", BLVar(scale_denom)));
+  };
+
+  create_decoder();
+
+  // Built-in codecs decode rows incrementally, see BLImageDecoderVirt::read_frame_rows.
+  EXPECT_TRUE(codec.has_feature(BL_IMAGE_CODEC_FEATURE_READ_ROWS));
+
+  BLImage full;
+  EXPECT_SUCCESS(decoder.read_frame(full, encoded_data));
+
+  BLSizeI size = full.size();
+
+  {
+    RowCollector collector;
+    collector.roi.reset(0, 0, size.w, size.h);
+
+    create_decoder();
+    EXPECT_SUCCESS(decoder.read_frame_rows(collect_rows_func, &collector, encoded_data));
+    EXPECT_TRUE(collector.contiguous);
+    EXPECT_EQ(collector.next_y, size.h);
+    EXPECT_TRUE(image_matches_region(full, collector.image, collector.roi));
+
+    // There is only a single frame.
+    EXPECT_EQ(decoder.read_frame_rows(collect_rows_func, &collector, encoded_data), BL_ERROR_NO_MORE_DATA);
+  }
+
+  for (uint32_t i = 0; i < 8; i++) {
+    int x0 = int(rnd.next_uint32() % uint32_t(size.w));
+    int y0 = int(rnd.next_uint32() % uint32_t(size.h));
+    int x1 = x0 + 1 + int(rnd.next_uint32() % uint32_t(size.w - x0));
+    int y1 = y0 + 1 + int(rnd.next_uint32() % uint32_t(size.h - y0));
+    BLRectI roi(x0, y0, x1 - x0, y1 - y0);
+
+    RowCollector collector;
+    collector.roi = roi;
+    collector.next_y = roi.y;
+
+    create_decoder();
+    EXPECT_SUCCESS(decoder.read_frame_rows(roi, collect_rows_func, &collector, encoded_data));
+    EXPECT_TRUE(collector.contiguous);
+    EXPECT_EQ(collector.next_y, roi.y + roi.h);
+    EXPECT_TRUE(image_matches_region(full, collector.image, roi))
+      .message("Region [%d %d %d %d] of %dx%d image doesn't match", roi.x, roi.y, roi.w, roi.h, size.w, size.h);
+
+    BLImage region;
+    create_decoder();
+    EXPECT_SUCCESS(decoder.read_frame_region(region, roi, encoded_data));
+    EXPECT_TRUE(image_matches_region(full, region, roi));
+  }
+
+  // Regions are clipped to the image, empty regions are rejected.
+  {
+    BLImage region;
+    create_decoder();
+    EXPECT_SUCCESS(decoder.read_frame_region(region, BLRectI(-10, -10, size.w + 20, size.h + 20), encoded_data));
+    EXPECT_TRUE(image_matches_region(full, region, BLRectI(0, 0, size.w, size.h)));
+
+    create_decoder();
+    EXPECT_EQ(decoder.read_frame_region(region, BLRectI(size.w, 0, 10, 10), encoded_data), BL_ERROR_INVALID_VALUE);
+  }
+}
+
+UNIT(image_codec_rows, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
+  static constexpr uint32_t kCmdCount = 10;
+
+  // The last size makes PNG data larger than the decoder's window, which must be compacted while decoding rows.
+  static constexpr BLSizeI sizes[] = {
+    { 1, 1 },
+    { 7, 3 },
+    { 16, 15 },
+    { 99, 54 },
+    { 301, 301 },
+    { 640, 480 }
+  };
+
+  static const char* codec_names[] = { "BMP", "PNG", "QOI", "JPEG" };
+  static constexpr BLFormat formats[] = { BL_FORMAT_XRGB32, BL_FORMAT_PRGB32, BL_FORMAT_A8 };
+  static constexpr uint32_t jpeg_subsampling[] = { 444, 422, 420 };
+
+  BLRandom rnd(0x123456789ABCDEFu);
+
+  for (const char* codec_name : codec_names) {
+    BLImageCodec codec;
+    EXPECT_SUCCESS(codec.find_by_name(codec_name));
+
+    bool is_jpeg = strcmp(codec_name, "JPEG") == 0;
+    INFO("Testing %s decoding of rows and regions", codec_name);
+
+    for (BLSizeI size : sizes) {
+      for (BLFormat format : formats) {
+        if (format == BL_FORMAT_A8 && !is_jpeg)
+          continue;
+
+        BLImage image;
+        EXPECT_SUCCESS(image.create(size.w, size.h, format));
+        render_simple_image(image, rnd, kCmdCount);
+
+        for (uint32_t variant = 0; variant < (is_jpeg ? 3u : 1u); variant++) {
+          BLImageEncoder encoder;
+          EXPECT_SUCCESS(codec.create_encoder(&encoder));
+
+          if (is_jpeg) {
+            EXPECT_SUCCESS(encoder.set_property("subsampling", BLVar(jpeg_subsampling[variant])));
+          }
+
+          BLArray<uint8_t> encoded_data;
+          EXPECT_SUCCESS(encoder.write_frame(encoded_data, image));
+          test_decoding_rows(codec, encoded_data, rnd);
+        }
+      }
+    }
+  }
+}
+
+// Returns the average difference between pixels of `scaled` and `scale x scale` box averages of `full`. Pixels at
+// the right and bottom edges are not compared if they are downscaled from partial boxes, which contain padding.
+static double average_box_diff(const BLImage& full, const BLImage& scaled, uint32_t scale) noexcept {
+  BLImageData full_data;
+  BLImageData scaled_data;
+
+  EXPECT_SUCCESS(full.get_data(&full_data));
+  EXPECT_SUCCESS(scaled.get_data(&scaled_data));
+
+  uint32_t w = uint32_t(full.width()) / scale;
+  uint32_t h = uint32_t(full.height()) / scale;
+  uint64_t cumulative_diff = 0;
+
+  for (uint32_t y = 0; y < h; y++) {
+    const uint32_t* scaled_line = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(scaled_data.pixel_data) + intptr_t(y) * scaled_data.stride);
+
+    for (uint32_t x = 0; x < w; x++) {
+      uint32_t sum[3] {};
+
+      for (uint32_t sy = y * scale; sy < (y + 1) * scale; sy++) {
+        const uint32_t* full_line = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(full_data.pixel_data) + intptr_t(sy) * full_data.stride);
+        for (uint32_t sx = x * scale; sx < (x + 1) * scale; sx++) {
+          for (uint32_t c = 0; c < 3; c++)
+            sum[c] += (full_line[sx] >> (c * 8u)) & 0xFFu;
+        }
+      }
+
+      uint32_t max_diff = 0;
+      for (uint32_t c = 0; c < 3; c++) {
+        int expected = int((sum[c] + scale * scale / 2u) / (scale * scale));
+        int actual = int((scaled_line[x] >> (c * 8u)) & 0xFFu);
+        max_diff = bl_max<uint32_t>(max_diff, uint32_t(bl_abs(expected - actual)));
+      }
+      cumulative_diff += max_diff;
+    }
+  }
+
+  return w && h ? double(cumulative_diff) / (double(w) * double(h)) : 0.0;
+}
+
+// Renders smooth gradients - downscaled decoding is compared against a box filter, which only matches reduced IDCT
+// and chroma upsampling well when the image doesn't have hard edges.
+static void render_smooth_image(BLImage& image, BLRandom& rnd) noexcept {
+  BLContext ctx(image);
+
+  double w = image.width();
+  double h = image.height();
+
+  BLGradient linear(BLLinearGradientValues(0, 0, w, h));
+  linear.add_stop(0.0, BLRgba32(rnd.next_uint32() | 0xFF000000u));
+  linear.add_stop(1.0, BLRgba32(rnd.next_uint32() | 0xFF000000u));
+  ctx.fill_all(linear);
+
+  BLGradient radial(BLRadialGradientValues(w * 0.5, h * 0.5, w * 0.5, h * 0.5, bl_max(w, h) * 0.5));
+  radial.add_stop(0.0, BLRgba32(rnd.next_uint32() | 0x80000000u));
+  radial.add_stop(1.0, BLRgba32(0x00000000u));
+  ctx.fill_all(radial);
+}
+
+UNIT(image_codec_jpeg_scale, BL_TEST_GROUP_IMAGE_CODEC_ROUNDTRIP) {
+
+  static constexpr BLSizeI sizes[] = {
+    { 1, 1 },
+    { 7, 3 },
+    { 17, 33 },
+    { 99, 54 },
+    { 301, 301 },
+    { 640, 360 }
+  };
+
+  static constexpr uint32_t subsampling[] = { 444, 422, 420 };
+  static constexpr BLFormat formats[] = { BL_FORMAT_XRGB32, BL_FORMAT_A8 };
+
+  BLImageCodec codec;
+  EXPECT_SUCCESS(codec.find_by_name("JPEG"));
+
+  BLRandom rnd(0x123456789ABCDEFu);
+
+  for (BLSizeI size : sizes) {
+    INFO("Testing JPEG downscaled decoding of %dx%d images", size.w, size.h);
+
+    for (BLFormat format : formats) {
+      for (uint32_t ss : subsampling) {
+        BLImage image;
+        EXPECT_SUCCESS(image.create(size.w, size.h, format));
+        render_smooth_image(image, rnd);
+
+        BLImageEncoder encoder;
+        EXPECT_SUCCESS(codec.create_encoder(&encoder));
+        EXPECT_SUCCESS(encoder.set_property("quality", BLVar(95)));
+        EXPECT_SUCCESS(encoder.set_property("subsampling", BLVar(ss)));
+
+        BLArray<uint8_t> encoded_data;
+        EXPECT_SUCCESS(encoder.write_frame(encoded_data, image));
+
+        BLImageDecoder decoder;
+        BLImage full;
+        EXPECT_SUCCESS(codec.create_decoder(&decoder));
+        EXPECT_SUCCESS(decoder.read_frame(full, encoded_data));
+
+        for (uint32_t scale = 2; scale <= 8; scale *= 2) {
+          EXPECT_SUCCESS(codec.create_decoder(&decoder));
+          EXPECT_SUCCESS(decoder.set_property("scale_denom", BLVar(scale)));
+
+          BLImageInfo info;
+          EXPECT_SUCCESS(decoder.read_info(info, encoded_data));
+          EXPECT_EQ(info.size, BLSizeI((size.w + int(scale) - 1) / int(scale), (size.h + int(scale) - 1) / int(scale)));
+
+          // The scale cannot be changed once the header was read.
+          EXPECT_EQ(decoder.set_property("scale_denom", BLVar(1)), BL_ERROR_INVALID_STATE);
+
+          BLImage scaled;
+          EXPECT_SUCCESS(decoder.read_frame(scaled, encoded_data));
+          EXPECT_EQ(scaled.size(), info.size);
+
+          // Chroma of small images is upsampled mostly from edge pixels, so only check larger images.
+          if (uint32_t(size.w) * uint32_t(size.h) >= kJpegMinToleranceArea * 16u) {
+            double average_diff = average_box_diff(full, scaled, scale);
+            EXPECT_LE(average_diff, 3.0)
+              .message("Average difference %.2f of 1/%u scaled %dx%d image (subsampling=%u)", average_diff, scale, size.w, size.h, ss);
+          }
+
+          test_decoding_rows(codec, encoded_data, rnd, scale);
+        }
+      }
+    }
+  }
+
+  // Only power of 2 scales up to 8 are supported.
+  BLImageDecoder decoder;
+  EXPECT_SUCCESS(codec.create_decoder(&decoder));
+  EXPECT_EQ(decoder.set_property("scale_denom", BLVar(3)), BL_ERROR_INVALID_VALUE);
+  EXPECT_EQ(decoder.set_property("scale_denom", BLVar(16)), BL_ERROR_INVALID_VALUE);
+}
+
 } // {bl::Codecs::Tests}
 
 #endif // BL_TEST
@@ -8,14 +8,18 @@
 // under Blend2D's ZLIB license or under STB's PUBLIC DOMAIN as well.
 
 #include <blend2d/core/api-build_p.h>
+#include <blend2d/core/array_p.h>
+#include <blend2d/core/imagedecoder_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/runtime_p.h>
 #include <blend2d/core/string_p.h>
+#include <blend2d/core/var_p.h>
 #include <blend2d/codec/jpegcodec_p.h>
 #include <blend2d/codec/jpeghuffman_p.h>
 #include <blend2d/codec/jpegops_p.h>
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/memops_p.h>
+#include <blend2d/support/ptrops_p.h>
 #include <blend2d/support/scopedbuffer_p.h>
 
 namespace bl::Jpeg {
@@ -27,15 +31,13 @@ static BLObjectEternalVirtualImpl<BLJpegCodecImpl, BLImageCodecVirt> jpeg_codec;
 static BLImageCodecCore jpeg_codec_instance;
 
 static BLImageDecoderVirt jpeg_decoder_virt;
-/*
 static BLImageEncoderVirt jpeg_encoder_virt;
-*/
 
-// bl::Jpeg::Decoder - DeZigZag Table
-// ==================================
+// bl::Jpeg::Codec - DeZigZag Table
+// ================================
 
 // Mapping table of zigzagged 8x8 data into a natural order.
-static const uint8_t decoder_de_zig_zag_table[64 + 16] = {
+static const uint8_t de_zig_zag_table[64 + 16] = {
   0 , 1 , 8 , 16, 9 , 2 , 3 , 10,
   17, 24, 32, 25, 18, 11, 4 , 5 ,
   12, 19, 26, 33, 40, 48, 41, 34,
@@ -202,13 +204,18 @@ static BLResult decoder_process_marker(BLJpegDecoderImpl* decoder_impl, uint32_t
     }
 
     // Compute interleaved MCU info.
-    uint32_t mcu_px_w = mcu_sf_w * kDctSize;
-    uint32_t mcu_px_h = mcu_sf_h * kDctSize;
-
-    uint32_t mcu_count_w = (w + mcu_px_w - 1) / mcu_px_w;
-    uint32_t mcu_count_h = (h + mcu_px_h - 1) / mcu_px_h;
+    uint32_t mcu_count_w = (w + mcu_sf_w * kDctSize - 1) / (mcu_sf_w * kDctSize);
+    uint32_t mcu_count_h = (h + mcu_sf_h * kDctSize - 1) / (mcu_sf_h * kDctSize);
     bool is_baseline = sof_marker != kMarkerSOF2;
 
+    // When decoding downscaled each 8x8 block is reconstructed by a reduced IDCT into a smaller block, thus
+    // planes, MCUs in pixels, and the image itself are smaller. Bitstream geometry (`px_w`, `px_h`) is unchanged.
+    uint32_t scale_shift = decoder_impl->scale_shift;
+    uint32_t block_size = kDctSize >> scale_shift;
+
+    uint32_t mcu_px_w = mcu_sf_w * block_size;
+    uint32_t mcu_px_h = mcu_sf_h * block_size;
+
     for (i = 0; i < component_count; i++) {
       DecoderComponent* comp = &decoder_impl->comp[i];
 
@@ -220,13 +227,13 @@ static BLResult decoder_process_marker(BLJpegDecoderImpl* decoder_impl, uint32_t
       comp->bl_w = mcu_count_w * uint32_t(comp->sf_w);
       comp->bl_h = mcu_count_h * uint32_t(comp->sf_h);
 
-      comp->os_w = comp->bl_w * kDctSize;
-      comp->os_h = comp->bl_h * kDctSize;
+      comp->os_w = comp->bl_w * block_size;
+      comp->os_h = comp->bl_h * block_size;
 
-      comp->data = static_cast<uint8_t*>(decoder_impl->allocator.alloc(comp->os_w * comp->os_h));
-      if (comp->data == nullptr) {
-        return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
-      }
+      // Planes are allocated by `decoder_alloc_planes()` when the first scan starts as their height depends on
+      // whether the whole image is decoded at once or in bands.
+      comp->data = nullptr;
+      comp->plane_h = 0;
 
       if (!is_baseline) {
         uint32_t kBlock8x8UInt16 = kDctSize2 * uint32_t(sizeof(int16_t));
@@ -244,7 +251,8 @@ static BLResult decoder_process_marker(BLJpegDecoderImpl* decoder_impl, uint32_t
 
     // Everything seems ok, store the image information.
     image_info.flags = 0;
-    image_info.size.reset(int(w), int(h));
+    image_info.size.reset(int(IntOps::align_up(w, 1u << scale_shift) >> scale_shift),
+                          int(IntOps::align_up(h, 1u << scale_shift) >> scale_shift));
     image_info.depth = uint16_t(component_count * bpp);
     image_info.plane_count = uint16_t(component_count);
     image_info.frame_count = 1;
@@ -339,12 +347,12 @@ static BLResult decoder_process_marker(BLJpegDecoderImpl* decoder_impl, uint32_t
 
       if (q_size == 0) {
         for (uint32_t k = 0; k < 64; k++, p++) {
-          q_table[decoder_de_zig_zag_table[k]] = *p;
+          q_table[de_zig_zag_table[k]] = *p;
         }
       }
       else {
         for (uint32_t k = 0; k < 64; k++, p += 2) {
-          q_table[decoder_de_zig_zag_table[k]] = uint16_t(MemOps::readU16uBE(reinterpret_cast<const uint16_t*>(p)));
+          q_table[de_zig_zag_table[k]] = uint16_t(MemOps::readU16uBE(reinterpret_cast<const uint16_t*>(p)));
         }
       }
 
@@ -673,6 +681,266 @@ static BLResult decoder_process_marker(BLJpegDecoderImpl* decoder_impl, uint32_t
 #undef GET_PAYLOAD_SIZE
 }
 
+// bl::Jpeg::Decoder - Planes
+// ==========================
+
+// Allocates planes of all components. If `mcu_rows` is non-zero, each plane only holds the given number of MCU rows,
+// which is used as a ring buffer by `decoder_process_stream()` when the image is decoded in bands.
+static BLResult decoder_alloc_planes(BLJpegDecoderImpl* decoder_impl, uint32_t mcu_rows) noexcept {
+  uint32_t component_count = decoder_impl->image_info.plane_count;
+
+  for (uint32_t i = 0; i < component_count; i++) {
+    DecoderComponent* comp = &decoder_impl->comp[i];
+
+    uint32_t plane_h = comp->os_h;
+    if (mcu_rows)
+      plane_h = bl_min<uint32_t>(plane_h, uint32_t(comp->sf_h) * (kDctSize >> decoder_impl->scale_shift) * mcu_rows);
+
+    comp->data = static_cast<uint8_t*>(decoder_impl->allocator.alloc(size_t(comp->os_w) * plane_h));
+    if (comp->data == nullptr) {
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+    }
+    comp->plane_h = plane_h;
+  }
+
+  return BL_SUCCESS;
+}
+
+static BL_INLINE uint8_t* decoder_plane_row(const DecoderComponent& comp, uint32_t row) noexcept {
+  return comp.data + size_t(row % comp.plane_h) * comp.os_w;
+}
+
+// Returns IDCT that reconstructs blocks of the size used by planes (reduced when decoding downscaled).
+static BL_INLINE decltype(FuncOpts::idct8) decoder_idct_func(const BLJpegDecoderImpl* decoder_impl) noexcept {
+  switch (decoder_impl->scale_shift) {
+    case 1: return opts.idct4;
+    case 2: return opts.idct2;
+    case 3: return opts.idct1;
+    default: return opts.idct8;
+  }
+}
+
+// bl::Jpeg::Decoder - ConvertToRGB
+// ================================
+
+struct DecoderUpsample {
+  // Expansion factor in each axis.
+  uint32_t hs, vs;
+  // Number of pre-expansion rows.
+  uint32_t h_lores;
+  // First pre-expansion pixel and the number of pre-expansion pixels to upsample.
+  uint32_t x_lores;
+  uint32_t w_lores;
+  // Offset of the first converted pixel in the upsampled row.
+  uint32_t offset;
+  // Selected upsample function.
+  uint8_t* (BL_CDECL* upsample)(uint8_t* out, uint8_t* in0, uint8_t* in1, uint32_t w, uint32_t hs) noexcept;
+};
+
+// Upsamples decoded planes and converts them to XRGB32 pixels. Each output row is computed only from the plane rows
+// it depends on, so rows can be converted in bands as soon as the MCU rows they need are decoded.
+class DecoderConverter {
+public:
+  BL_NONCOPYABLE(DecoderConverter)
+
+  uint32_t _w = 0;
+  uint32_t _component_count = 0;
+  uint8_t* _buffer[4] {};
+  DecoderUpsample _upsample[4] {};
+  ScopedBufferTmp<1024 * 3 + 16> _tmp_mem;
+
+  BL_INLINE DecoderConverter() noexcept {}
+
+  // Initializes the converter to convert `w` pixels starting at `x` of each row.
+  BLResult init(const BLJpegDecoderImpl* decoder_impl, uint32_t x, uint32_t w) noexcept {
+    uint32_t image_w = uint32_t(decoder_impl->image_info.size.w);
+    uint32_t component_count = decoder_impl->image_info.plane_count;
+
+    BL_ASSERT(component_count > 0u && component_count <= 4u);
+    BL_ASSERT(w > 0u && x + w <= image_w);
+
+    // Allocate a line buffer that's big enough for up-sampling off the edges with up-sample factor of 4.
+    uint32_t line_stride = IntOps::align_up(image_w + 3, 16);
+    uint8_t* line_buffer = static_cast<uint8_t*>(_tmp_mem.alloc(line_stride * component_count));
+
+    if (BL_UNLIKELY(!line_buffer))
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+    _w = w;
+    _component_count = component_count;
+
+    for (uint32_t k = 0; k < component_count; k++) {
+      const DecoderComponent& comp = decoder_impl->comp[k];
+      DecoderUpsample* r = &_upsample[k];
+
+      _buffer[k] = line_buffer + k * line_stride;
+
+      r->hs = uint32_t(decoder_impl->mcu.sf.w / comp.sf_w);
+      r->vs = uint32_t(decoder_impl->mcu.sf.h / comp.sf_h);
+      r->h_lores = IntOps::align_up(comp.px_h, 1u << decoder_impl->scale_shift) >> decoder_impl->scale_shift;
+
+      // Horizontal upsampling filters use neighboring pre-expansion pixels, so extend the window by one pixel.
+      uint32_t w_lores = (image_w + r->hs - 1) / r->hs;
+      uint32_t margin = r->hs > 1 ? 1u : 0u;
+      uint32_t x0 = x / r->hs;
+      uint32_t x1 = bl_min((x + w - 1) / r->hs + margin, w_lores - 1);
+
+      x0 -= bl_min(x0, margin);
+      r->x_lores = x0;
+      r->w_lores = x1 - x0 + 1;
+      r->offset = x - x0 * r->hs;
+
+      if      (r->hs == 1 && r->vs == 1) r->upsample = opts.upsample_1x1;
+      else if (r->hs == 1 && r->vs == 2) r->upsample = opts.upsample_1x2;
+      else if (r->hs == 2 && r->vs == 1) r->upsample = opts.upsample_2x1;
+      else if (r->hs == 2 && r->vs == 2) r->upsample = opts.upsample_2x2;
+      else                               r->upsample = opts.upsample_any;
+    }
+
+    return BL_SUCCESS;
+  }
+
+  // Converts rows [y0, y1) to `dst_line`.
+  void convert(const BLJpegDecoderImpl* decoder_impl, uint8_t* dst_line, intptr_t dst_stride, uint32_t y0, uint32_t y1) noexcept {
+    uint32_t w = _w;
+    uint32_t component_count = _component_count;
+    uint8_t* pPlane[4];
+
+    for (uint32_t y = y0; y < y1; y++, dst_line += dst_stride) {
+      for (uint32_t k = 0; k < component_count; k++) {
+        const DecoderComponent& comp = decoder_impl->comp[k];
+        const DecoderUpsample& r = _upsample[k];
+
+        // Each output row is interpolated from the nearest pre-expansion row and the row above or below it.
+        uint32_t half = r.vs >> 1;
+        uint32_t ypos = (y + half) / r.vs;
+        bool y_bot = (y + half) % r.vs >= half;
+
+        uint32_t row1 = bl_min(ypos, r.h_lores - 1);
+        uint32_t row0 = bl_min(ypos ? ypos - 1 : 0u, r.h_lores - 1);
+
+        uint8_t* line0 = decoder_plane_row(comp, y_bot ? row1 : row0) + r.x_lores;
+        uint8_t* line1 = decoder_plane_row(comp, y_bot ? row0 : row1) + r.x_lores;
+
+        pPlane[k] = r.upsample(_buffer[k], line0, line1, r.w_lores, r.hs) + r.offset;
+      }
+
+      uint8_t* pY = pPlane[0];
+      if (component_count == 3) {
+        opts.conv_ycbcr8_to_rgb32(dst_line, pY, pPlane[1], pPlane[2], w);
+      }
+      else {
+        for (uint32_t x = 0; x < w; x++) {
+          MemOps::writeU32a(dst_line + x * 4, 0xFF000000u + uint32_t(pY[x]) * 0x010101u);
+        }
+      }
+    }
+  }
+};
+
+static BLResult decoder_convert_to_rgb(BLJpegDecoderImpl* decoder_impl, BLImageData& dst) noexcept {
+  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
+  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
+
+  BL_ASSERT(uint32_t(dst.size.w) >= w);
+  BL_ASSERT(uint32_t(dst.size.h) >= h);
+
+  DecoderConverter converter;
+  BL_PROPAGATE(converter.init(decoder_impl, 0, w));
+
+  converter.convert(decoder_impl, static_cast<uint8_t*>(dst.pixel_data), dst.stride, 0, h);
+  return BL_SUCCESS;
+}
+
+// bl::Jpeg::Decoder - Band Writer
+// ===============================
+
+// Converts rows within a region of interest to XRGB32 and passes them to the user in bands. When used by
+// `decoder_process_stream()` planes hold only a few MCU rows and MCUs that don't contribute to the region
+// are entropy decoded, but not reconstructed.
+class DecoderBandWriter {
+public:
+  BL_NONCOPYABLE(DecoderBandWriter)
+
+  const BLJpegDecoderImpl* _decoder_impl = nullptr;
+  BLImageDecoderRowsFunc _func = nullptr;
+  void* _user_data = nullptr;
+  BLRectI _roi {};
+
+  // Range of MCUs (inclusive) that have to be reconstructed to convert the region.
+  uint32_t _mcu_x0 = 0;
+  uint32_t _mcu_x1 = 0;
+  uint32_t _mcu_y0 = 0;
+  uint32_t _mcu_y1 = 0;
+
+  // Next row to convert.
+  uint32_t _y = 0;
+  // Whether planes hold only a few MCU rows and are converted as they are decoded.
+  bool _streaming = false;
+
+  uint8_t* _band_data = nullptr;
+  intptr_t _band_stride = 0;
+
+  DecoderConverter _converter;
+  ScopedBuffer _band_buffer;
+
+  BL_INLINE DecoderBandWriter() noexcept {}
+
+  BLResult init(const BLJpegDecoderImpl* decoder_impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data) noexcept {
+    uint32_t mcu_px_w = decoder_impl->mcu.px.w;
+    uint32_t mcu_px_h = decoder_impl->mcu.px.h;
+
+    _decoder_impl = decoder_impl;
+    _func = func;
+    _user_data = user_data;
+    _roi = roi;
+
+    // Upsampling uses pre-expansion pixels around each pixel, which can be in a neighboring MCU.
+    _mcu_x0 = uint32_t(roi.x) / mcu_px_w;
+    _mcu_y0 = uint32_t(roi.y) / mcu_px_h;
+    _mcu_x0 -= bl_min(_mcu_x0, 1u);
+    _mcu_y0 -= bl_min(_mcu_y0, 1u);
+    _mcu_x1 = uint32_t(roi.x + roi.w - 1) / mcu_px_w + 1u;
+    _mcu_y1 = uint32_t(roi.y + roi.h - 1) / mcu_px_h + 1u;
+
+    _y = uint32_t(roi.y);
+    _band_stride = intptr_t(IntOps::align_up(uint32_t(roi.w) * 4u, 16u));
+    _band_data = static_cast<uint8_t*>(_band_buffer.alloc(size_t(_band_stride) * mcu_px_h));
+
+    if (BL_UNLIKELY(!_band_data))
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+    return _converter.init(decoder_impl, uint32_t(roi.x), uint32_t(roi.w));
+  }
+
+  BL_INLINE bool is_mcu_needed(uint32_t mcu_x, uint32_t mcu_y) const noexcept {
+    return mcu_x >= _mcu_x0 && mcu_x <= _mcu_x1 && mcu_y >= _mcu_y0 && mcu_y <= _mcu_y1;
+  }
+
+  BL_INLINE bool is_done() const noexcept { return _y >= uint32_t(_roi.y + _roi.h); }
+
+  // Converts rows of the region above `y_end` that were not converted yet.
+  BLResult convert_rows(uint32_t y_end) noexcept {
+    uint32_t band_h = _decoder_impl->mcu.px.h;
+    y_end = bl_min(y_end, uint32_t(_roi.y + _roi.h));
+
+    while (_y < y_end) {
+      uint32_t n = bl_min(y_end - _y, band_h);
+      _converter.convert(_decoder_impl, _band_data, _band_stride, _y, _y + n);
+      BL_PROPAGATE(ImageDecoderInternal::emit_band(_func, _user_data, _band_data, _band_stride, _roi.w, int(n), BL_FORMAT_XRGB32, int(_y)));
+      _y += n;
+    }
+
+    return BL_SUCCESS;
+  }
+
+  // Called when MCU row `mcu_y` has been decoded. Rows of previous MCU rows are complete at this point as vertical
+  // upsampling only needs the first pre-expansion row of the next MCU row.
+  BL_INLINE BLResult mcu_row_done(uint32_t mcu_y) noexcept {
+    return convert_rows(mcu_y * _decoder_impl->mcu.px.h);
+  }
+};
+
 // bl::Jpeg::Decoder - Process Stream
 // ==================================
 
@@ -769,7 +1037,7 @@ static BLResult decoder_read_baseline_block(BLJpegDecoderImpl* decoder_impl, Dec
       k += (ac >> 4) & 15; // Skip.
       ac >>= 8;
       reader.drop(s);
-      dst[decoder_de_zig_zag_table[k++]] = int16_t(ac);
+      dst[de_zig_zag_table[k++]] = int16_t(ac);
     }
     else {
       BL_PROPAGATE(reader.read_code(ac, ac_table));
@@ -789,7 +1057,7 @@ static BLResult decoder_read_baseline_block(BLJpegDecoderImpl* decoder_impl, Dec
         BL_PROPAGATE(reader.require_bits(s));
 
         ac = reader.read_signed(s);
-        dst[decoder_de_zig_zag_table[k++]] = int16_t(ac);
+        dst[de_zig_zag_table[k++]] = int16_t(ac);
       }
     }
   } while (k < 64);
@@ -865,7 +1133,7 @@ static BLResult decoder_read_progressive_block(BLJpegDecoderImpl* decoder_impl,
           k += (r >> 4) & 15;
           reader.drop(uint32_t(s));
 
-          uint32_t zig = decoder_de_zig_zag_table[k++];
+          uint32_t zig = de_zig_zag_table[k++];
           dst[zig] = int16_t(IntOps::shl(r >> 8, shift));
         }
         else {
@@ -891,7 +1159,7 @@ static BLResult decoder_read_progressive_block(BLJpegDecoderImpl* decoder_impl,
             k += uint32_t(r);
             r = reader.read_signed(uint32_t(s));
 
-            uint32_t zig = decoder_de_zig_zag_table[k++];
+            uint32_t zig = de_zig_zag_table[k++];
             dst[zig] = int16_t(IntOps::shl(r, shift));
           }
         }
@@ -902,7 +1170,7 @@ static BLResult decoder_read_progressive_block(BLJpegDecoderImpl* decoder_impl,
       int32_t bit = int32_t(1) << shift;
       if (stream.eob_run) {
         do {
-          int16_t* p = &dst[decoder_de_zig_zag_table[k++]];
+          int16_t* p = &dst[de_zig_zag_table[k++]];
           int32_t pVal = *p;
 
           if (pVal) {
@@ -950,7 +1218,7 @@ static BLResult decoder_read_progressive_block(BLJpegDecoderImpl* decoder_impl,
 
           // Advance by `r`.
           while (k < k_end) {
-            int16_t* p = &dst[decoder_de_zig_zag_table[k++]];
+            int16_t* p = &dst[de_zig_zag_table[k++]];
             int32_t pVal = *p;
 
             if (pVal) {
@@ -980,7 +1248,9 @@ static BLResult decoder_read_progressive_block(BLJpegDecoderImpl* decoder_impl,
   return BL_SUCCESS;
 }
 
-static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const uint8_t* p, size_t remain, size_t& consumed_bytes) noexcept {
+// If `writer` is provided the scan contains all components and planes only hold a few MCU rows (see
+// `decoder_alloc_planes()`), which are converted and passed to the writer after each MCU row is decoded.
+static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const uint8_t* p, size_t remain, size_t& consumed_bytes, DecoderBandWriter* writer) noexcept {
   DecoderSOS& sos = decoder_impl->sos;
 
   const uint8_t* start = p;
@@ -1001,6 +1271,10 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
   // as coefficients are updated progressively.
   uint32_t unit_size = is_baseline ? 1 : 2;
 
+  // Size of blocks reconstructed by IDCT (baseline only).
+  uint32_t block_size = kDctSize >> decoder_impl->scale_shift;
+  auto idct = decoder_idct_func(decoder_impl);
+
   // Initialize the entropy stream.
   DecoderBitStream stream;
   stream.reset(p, end);
@@ -1040,9 +1314,9 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
 
       for (uint32_t y = 0; y < sf_h; y++) {
         for (uint32_t x = 0; x < sf_w; x++) {
-          run->offset[count++] = intptr_t(offset + x * unit_size * kDctSize);
+          run->offset[count++] = intptr_t(offset + x * unit_size * block_size);
         }
-        offset += stride * kDctSize;
+        offset += stride * block_size;
       }
 
       run->comp = comp;
@@ -1051,8 +1325,8 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
 
       run->count = count;
       run->stride = stride;
-      run->advance[0] = sf_w * unit_size * kDctSize;
-      run->advance[1] = run->advance[0] + (sf_h * kDctSize - 1) * stride;
+      run->advance[0] = sf_w * unit_size * block_size;
+      run->advance[1] = run->advance[0] + (sf_h * block_size - 1) * stride;
     }
     else {
       uint32_t block_size = unit_size * kDctSize2;
@@ -1087,6 +1361,9 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
       // Increment it here so we can use `mcu_x == mcu_w` in the inner loop.
       mcu_x++;
 
+      // MCUs that don't contribute to the region being decoded must be entropy decoded, but don't need IDCT.
+      bool reconstruct = !writer || writer->is_mcu_needed(mcu_x - 1, mcu_y);
+
       // Decode all blocks required by a single MCU.
       for (i = 0; i < sc_count; i++) {
         DecoderRun* run = &runs[i];
@@ -1096,7 +1373,10 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
         for (uint32_t n = 0; n < block_count; n++) {
           tmp_block.reset();
           BL_PROPAGATE(decoder_read_baseline_block(decoder_impl, stream, run->comp, tmp_block.data));
-          opts.idct8(block_data + run->offset[n], intptr_t(run->stride), tmp_block.data, run->q_table->data);
+
+          if (reconstruct) {
+            idct(block_data + run->offset[n], intptr_t(run->stride), tmp_block.data, run->q_table->data);
+          }
         }
 
         run->data = block_data + run->advance[mcu_x == mcu_w];
@@ -1104,6 +1384,21 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
 
       // Advance.
       if (mcu_x == mcu_w) {
+        if (writer) {
+          // Planes hold only a few MCU rows - continue at the beginning when the end of a plane is reached.
+          for (i = 0; i < sc_count; i++) {
+            DecoderRun* run = &runs[i];
+            if (run->data == run->comp->data + size_t(run->comp->plane_h) * run->stride) {
+              run->data = run->comp->data;
+            }
+          }
+
+          BL_PROPAGATE(writer->mcu_row_done(mcu_y));
+          if (writer->is_done()) {
+            break;
+          }
+        }
+
         if (++mcu_y == mcu_h) {
           break;
         }
@@ -1175,6 +1470,8 @@ static BLResult decoder_process_stream(BLJpegDecoderImpl* decoder_impl, const ui
 static BLResult decoder_process_mcus(BLJpegDecoderImpl* decoder_impl) noexcept {
   if (decoder_impl->sof_marker == kMarkerSOF2) {
     uint32_t component_count = decoder_impl->image_info.plane_count;
+    uint32_t block_size = kDctSize >> decoder_impl->scale_shift;
+    auto idct = decoder_idct_func(decoder_impl);
 
     // Dequantize & IDCT.
     for (uint32_t n = 0; n < component_count; n++) {
@@ -1187,108 +1484,10 @@ static BLResult decoder_process_mcus(BLJpegDecoderImpl* decoder_impl) noexcept {
       for (uint32_t j = 0; j < h; j++) {
         for (uint32_t i = 0; i < w; i++) {
           int16_t *data = comp.coeff + 64 * (i + j * comp.bl_w);
-          opts.idct8(comp.data + comp.os_w * j * 8 + i * 8, intptr_t(comp.os_w), data, q_table->data);
-        }
-      }
-    }
-  }
-
-  return BL_SUCCESS;
-}
-
-// bl::Jpeg::Decoder - ConvertToRGB
-// ================================
-
-struct DecoderUpsample {
-  uint8_t* line[2];
-
-  // Expansion factor in each axis.
-  uint32_t hs, vs;
-  // Horizontal pixels pre-expansion.
-  uint32_t w_lores;
-  // How far through vertical expansion we are.
-  uint32_t ystep;
-  // Which pre-expansion row we're on.
-  uint32_t ypos;
-  // Selected upsample function.
-  uint8_t* (BL_CDECL* upsample)(uint8_t* out, uint8_t* in0, uint8_t* in1, uint32_t w, uint32_t hs) noexcept;
-};
-
-static BLResult decoder_convert_to_rgb(BLJpegDecoderImpl* decoder_impl, BLImageData& dst) noexcept {
-  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
-  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
-
-  BL_ASSERT(uint32_t(dst.size.w) >= w);
-  BL_ASSERT(uint32_t(dst.size.h) >= h);
-
-  uint8_t* dst_line = static_cast<uint8_t*>(dst.pixel_data);
-  intptr_t dst_stride = dst.stride;
-
-  bl::ScopedBufferTmp<1024 * 3 + 16> tmp_mem;
-
-  // Allocate a line buffer that's big enough for up-sampling off the edges with up-sample factor of 4.
-  uint32_t component_count = decoder_impl->image_info.plane_count;
-  BL_ASSERT(component_count > 0u && component_count <= 4u);
-
-  uint32_t line_stride = IntOps::align_up(w + 3, 16);
-  uint8_t* line_buffer = static_cast<uint8_t*>(tmp_mem.alloc(line_stride * component_count));
-
-  if (BL_UNLIKELY(!line_buffer))
-    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
-
-  DecoderUpsample upsample[4];
-  uint8_t* pPlane[4];
-  uint8_t* pBuffer[4];
-
-  for (uint32_t k = 0; k < component_count; k++) {
-    DecoderComponent& comp = decoder_impl->comp[k];
-    DecoderUpsample* r = &upsample[k];
-
-    pBuffer[k] = line_buffer + k * line_stride;
-
-    r->hs      = uint32_t(decoder_impl->mcu.sf.w / comp.sf_w);
-    r->vs      = uint32_t(decoder_impl->mcu.sf.h / comp.sf_h);
-    r->ystep   = r->vs >> 1;
-    r->w_lores = (w + r->hs - 1) / r->hs;
-    r->ypos    = 0;
-    r->line[0] = comp.data;
-    r->line[1] = comp.data;
-
-    if      (r->hs == 1 && r->vs == 1) r->upsample = opts.upsample_1x1;
-    else if (r->hs == 1 && r->vs == 2) r->upsample = opts.upsample_1x2;
-    else if (r->hs == 2 && r->vs == 1) r->upsample = opts.upsample_2x1;
-    else if (r->hs == 2 && r->vs == 2) r->upsample = opts.upsample_2x2;
-    else                               r->upsample = opts.upsample_any;
-  }
-
-  // Now go ahead and resample.
-  for (uint32_t y = 0; y < h; y++, dst_line += dst_stride) {
-    for (uint32_t k = 0; k < component_count; k++) {
-      DecoderComponent& comp = decoder_impl->comp[k];
-      DecoderUpsample* r = &upsample[k];
-
-      int y_bot = r->ystep >= (r->vs >> 1);
-      pPlane[k] = r->upsample(pBuffer[k], r->line[y_bot], r->line[1 - y_bot], r->w_lores, r->hs);
-
-      if (++r->ystep >= r->vs) {
-        r->ystep = 0;
-        r->line[0] = r->line[1];
-
-        if (++r->ypos < comp.px_h) {
-          r->line[1] += comp.os_w;
+          idct(comp.data + comp.os_w * j * block_size + i * block_size, intptr_t(comp.os_w), data, q_table->data);
         }
       }
     }
-
-    uint8_t* pY = pPlane[0];
-    if (component_count == 3) {
-      opts.conv_ycbcr8_to_rgb32(dst_line, pY, pPlane[1], pPlane[2], w);
-    }
-    else {
-      for (uint32_t x = 0; x < w; x++) {
-        MemOps::writeU32a(dst_line + x * 4, 0xFF000000u + uint32_t(pY[x]) * 0x010101u);
-      }
-    }
   }
 
   return BL_SUCCESS;
@@ -1359,7 +1558,10 @@ static BLResult decoder_read_info_impl_internal(BLJpegDecoderImpl* decoder_impl,
   return BL_SUCCESS;
 }
 
-static BLResult decoder_read_frame_impl_internal(BLJpegDecoderImpl* decoder_impl, BLImage* image_out, const uint8_t* p, size_t size) noexcept {
+// Processes markers and entropy coded data that follow SOF. If `writer` is provided and the first scan contains all
+// components of a baseline image, the image is decoded in bands and passed to the writer as MCU rows are decoded,
+// otherwise planes hold the whole image and MCUs must be processed by `decoder_process_mcus()` afterwards.
+static BLResult decoder_read_frame_data(BLJpegDecoderImpl* decoder_impl, const uint8_t* p, size_t size, DecoderBandWriter* writer) noexcept {
   const uint8_t* start = p;
   const uint8_t* end = p + size;
 
@@ -1412,15 +1614,46 @@ static BLResult decoder_read_frame_impl_internal(BLJpegDecoderImpl* decoder_impl
 
     // SOS - process the entropy coded data-stream that follows SOS.
     if (m == kMarkerSOS) {
+      if (!decoder_impl->comp[0].data) {
+        // Only a baseline scan that contains all components can be decoded in bands, progressive images and images
+        // having a scan per component need whole planes.
+        if (writer && decoder_impl->sof_marker != kMarkerSOF2 && decoder_impl->sos.sc_count == decoder_impl->image_info.plane_count) {
+          writer->_streaming = true;
+          BL_PROPAGATE(decoder_alloc_planes(decoder_impl, 3));
+        }
+        else {
+          BL_PROPAGATE(decoder_alloc_planes(decoder_impl, 0));
+        }
+      }
+
+      bool streaming = writer && writer->_streaming;
+
       size_t consumed_bytes = 0;
-      BL_PROPAGATE(decoder_process_stream(decoder_impl, p, (size_t)(end - p), consumed_bytes));
+      BL_PROPAGATE(decoder_process_stream(decoder_impl, p, (size_t)(end - p), consumed_bytes, streaming ? writer : nullptr));
 
       BL_ASSERT((size_t)(end - p) >= consumed_bytes);
       p += consumed_bytes;
       decoder_impl->status_flags |= DecoderStatusFlags::kDoneSOS;
+
+      // The scan contained all components, so it's the last one.
+      if (streaming) {
+        break;
+      }
     }
   }
 
+  // No scan - keep the previous behavior and convert uninitialized planes.
+  if (!decoder_impl->comp[0].data) {
+    BL_PROPAGATE(decoder_alloc_planes(decoder_impl, 0));
+  }
+
+  decoder_impl->buffer_index = (size_t)(p - start);
+  return BL_SUCCESS;
+}
+
+static BLResult decoder_read_frame_impl_internal(BLJpegDecoderImpl* decoder_impl, BLImage* image_out, const uint8_t* p, size_t size) noexcept {
+  BL_PROPAGATE(decoder_read_frame_data(decoder_impl, p, size, nullptr));
+
   // Process MCUs.
   BL_PROPAGATE(decoder_process_mcus(decoder_impl));
 
@@ -1434,9 +1667,23 @@ static BLResult decoder_read_frame_impl_internal(BLJpegDecoderImpl* decoder_impl
   BL_PROPAGATE(image_out->make_mutable(&image_data));
   BL_PROPAGATE(decoder_convert_to_rgb(decoder_impl, image_data));
 
-  decoder_impl->buffer_index = (size_t)(p - start);
   decoder_impl->frame_index++;
+  return BL_SUCCESS;
+}
+
+static BLResult decoder_read_frame_rows_internal(BLJpegDecoderImpl* decoder_impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* p, size_t size) noexcept {
+  DecoderBandWriter writer;
+  BL_PROPAGATE(writer.init(decoder_impl, roi, func, user_data));
+  BL_PROPAGATE(decoder_read_frame_data(decoder_impl, p, size, &writer));
+
+  // Planes of images that were not decoded in bands hold the whole image, convert the rest of the region from them.
+  if (!writer._streaming) {
+    BL_PROPAGATE(decoder_process_mcus(decoder_impl));
+  }
+
+  BL_PROPAGATE(writer.convert_rows(uint32_t(decoder_impl->image_info.size.h)));
 
+  decoder_impl->frame_index++;
   return BL_SUCCESS;
 }
 
@@ -1470,6 +1717,39 @@ static BLResult BL_CDECL decoder_restart_impl(BLImageDecoderImpl* impl) noexcept
   return BL_SUCCESS;
 }
 
+static BLResult BL_CDECL decoder_get_property_impl(const BLObjectImpl* impl, const char* name, size_t name_size, BLVarCore* value_out) noexcept {
+  const BLJpegDecoderImpl* decoder_impl = static_cast<const BLJpegDecoderImpl*>(impl);
+
+  if (bl_match_property(name, name_size, "scale_denom")) {
+    return bl_var_assign_uint64(value_out, uint64_t(1) << decoder_impl->scale_shift);
+  }
+
+  return bl_object_impl_get_property(decoder_impl, name, name_size, value_out);
+}
+
+static BLResult BL_CDECL decoder_set_property_impl(BLObjectImpl* impl, const char* name, size_t name_size, const BLVarCore* value) noexcept {
+  BLJpegDecoderImpl* decoder_impl = static_cast<BLJpegDecoderImpl*>(impl);
+
+  // Decodes images downscaled by 1, 2, 4, or 8 by using reduced IDCTs. The scale affects the size reported by
+  // `read_info()`, thus it cannot be changed after the header has been read, unless the decoder is restarted.
+  if (bl_match_property(name, name_size, "scale_denom")) {
+    uint64_t v;
+    BL_PROPAGATE(bl_var_to_uint64(value, &v));
+
+    if (v != 1 && v != 2 && v != 4 && v != 8)
+      return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+    uint8_t scale_shift = uint8_t(IntOps::ctz(uint32_t(v)));
+    if (decoder_impl->sof_marker != 0 && scale_shift != decoder_impl->scale_shift)
+      return bl_make_error(BL_ERROR_INVALID_STATE);
+
+    decoder_impl->scale_shift = scale_shift;
+    return BL_SUCCESS;
+  }
+
+  return bl_object_impl_set_property(decoder_impl, name, name_size, value);
+}
+
 static BLResult BL_CDECL decoder_read_info_impl(BLImageDecoderImpl* impl, BLImageInfo* info_out, const uint8_t* p, size_t size) noexcept {
   BLJpegDecoderImpl* decoder_impl = static_cast<BLJpegDecoderImpl*>(impl);
   BLResult result = decoder_impl->last_result;
@@ -1499,6 +1779,19 @@ static BLResult BL_CDECL decoder_read_frame_impl(BLImageDecoderImpl* impl, BLIma
   return result;
 }
 
+static BLResult BL_CDECL decoder_read_frame_rows_impl(BLImageDecoderImpl* impl, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* p, size_t size) noexcept {
+  BLJpegDecoderImpl* decoder_impl = static_cast<BLJpegDecoderImpl*>(impl);
+  BL_PROPAGATE(decoder_read_info_impl(decoder_impl, nullptr, p, size));
+
+  if (decoder_impl->frame_index)
+    return bl_make_error(BL_ERROR_NO_MORE_DATA);
+
+  BLResult result = decoder_read_frame_rows_internal(decoder_impl, *roi, func, user_data, p, size);
+  if (result != BL_SUCCESS)
+    decoder_impl->last_result = result;
+  return result;
+}
+
 static BLResult BL_CDECL bl_jpeg_decoder_impl_create(BLImageDecoderCore* self) noexcept {
   BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE_DECODER);
   BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLJpegDecoderImpl>(self, info));
@@ -1506,6 +1799,7 @@ static BLResult BL_CDECL bl_jpeg_decoder_impl_create(BLImageDecoderCore* self) n
   BLJpegDecoderImpl* decoder_impl = static_cast<BLJpegDecoderImpl*>(self->_d.impl);
   decoder_impl->ctor(&jpeg_decoder_virt, &jpeg_codec_instance);
   bl_call_ctor(decoder_impl->allocator);
+  decoder_impl->scale_shift = 0;
   return decoder_restart_impl(decoder_impl);
 }
 
@@ -1517,6 +1811,679 @@ static BLResult BL_CDECL decoder_destroy_impl(BLObjectImpl* impl) noexcept {
   return bl_object_free_impl(decoder_impl);
 }
 
+// bl::Jpeg::Encoder - Tables
+// ==========================
+
+// Standard luminance and chrominance quantization tables (JPEG specification, Annex K.1) in natural order.
+static const uint8_t encoder_std_q_table[2][64] = {
+  {
+    16 , 11 , 10 , 16 , 24 , 40 , 51 , 61 ,
+    12 , 12 , 14 , 19 , 26 , 58 , 60 , 55 ,
+    14 , 13 , 16 , 24 , 40 , 57 , 69 , 56 ,
+    14 , 17 , 22 , 29 , 51 , 87 , 80 , 62 ,
+    18 , 22 , 37 , 56 , 68 , 109, 103, 77 ,
+    24 , 35 , 55 , 64 , 81 , 104, 113, 92 ,
+    49 , 64 , 78 , 87 , 103, 121, 120, 101,
+    72 , 92 , 95 , 98 , 112, 100, 103, 99
+  },
+  {
+    17 , 18 , 24 , 47 , 99 , 99 , 99 , 99 ,
+    18 , 21 , 26 , 66 , 99 , 99 , 99 , 99 ,
+    24 , 26 , 56 , 99 , 99 , 99 , 99 , 99 ,
+    47 , 66 , 99 , 99 , 99 , 99 , 99 , 99 ,
+    99 , 99 , 99 , 99 , 99 , 99 , 99 , 99 ,
+    99 , 99 , 99 , 99 , 99 , 99 , 99 , 99 ,
+    99 , 99 , 99 , 99 , 99 , 99 , 99 , 99 ,
+    99 , 99 , 99 , 99 , 99 , 99 , 99 , 99
+  }
+};
+
+// Standard luminance and chrominance DC Huffman tables (JPEG specification, Annex K.3).
+static const HuffmanSpec encoder_std_dc_spec[2] = {
+  {
+    { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }
+  },
+  {
+    { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }
+  }
+};
+
+// Standard luminance and chrominance AC Huffman tables (JPEG specification, Annex K.3).
+static const HuffmanSpec encoder_std_ac_spec[2] = {
+  {
+    { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D },
+    {
+      0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+      0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+      0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+      0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+      0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+      0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+      0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+      0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+      0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+      0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+      0xF9, 0xFA
+    }
+  },
+  {
+    { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 },
+    {
+      0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+      0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+      0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+      0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+      0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+      0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+      0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+      0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+      0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+      0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+      0xF9, 0xFA
+    }
+  }
+};
+
+// bl::Jpeg::Encoder - Context
+// ===========================
+
+//! Maximum size of all markers that precede the entropy coded data.
+static constexpr size_t kEncoderMaxHeaderSize = 2048;
+
+//! Maximum size of a single entropy coded block - the worst case is a DC code followed by 63 AC codes, each having
+//! 16 bits of a Huffman code and up to 11 additional bits, where each byte could require escaping.
+static constexpr size_t kEncoderMaxBlockSize = ((27 * 64 + 7) / 8) * 2;
+
+struct EncoderComponent {
+  //! Component ID (as written to SOF and SOS markers).
+  uint8_t comp_id;
+  //! Quantization and Huffman table ID (0 = luminance, 1 = chrominance).
+  uint8_t table_id;
+  //! Horizontal sampling factor.
+  uint8_t sf_w;
+  //! Vertical sampling factor.
+  uint8_t sf_h;
+
+  //! Plane data of a single MCU row (either full resolution or downsampled).
+  uint8_t* plane;
+  //! Plane stride.
+  uint32_t stride;
+  //! DC prediction (modified during encoding).
+  int32_t dc_pred;
+};
+
+struct EncoderContext {
+  //! Image width.
+  uint32_t w;
+  //! Image height.
+  uint32_t h;
+  //! Number of components (1 or 3).
+  uint32_t comp_count;
+  //! Number of blocks of all components in a single MCU.
+  uint32_t blocks_per_mcu;
+
+  //! JPEG encoder MCU information.
+  MCUInfo mcu;
+  //! JPEG encoder components.
+  EncoderComponent comp[3];
+
+  //! Quantization tables in natural order.
+  uint8_t q_table[2][kDctSize2];
+  //! Reciprocals of quantization tables scaled by FDCT output scale.
+  float q_recip[2][kDctSize2];
+
+  //! DC and AC Huffman table specifications.
+  HuffmanSpec dc_spec[2];
+  HuffmanSpec ac_spec[2];
+
+  //! DC and AC Huffman tables.
+  EncoderHuffmanTable dc_table[2];
+  EncoderHuffmanTable ac_table[2];
+};
+
+static void encoder_init_q_tables(EncoderContext& ctx, uint32_t quality) noexcept {
+  // Quality scaling as used by IJG's libjpeg, which is what most users expect the quality to mean.
+  quality = bl_clamp<uint32_t>(quality, 1, 100);
+  uint32_t scale = quality < 50 ? 5000u / quality : 200u - quality * 2u;
+
+  for (uint32_t t = 0; t < 2; t++) {
+    for (uint32_t i = 0; i < kDctSize2; i++) {
+      uint32_t q = bl_clamp<uint32_t>((uint32_t(encoder_std_q_table[t][i]) * scale + 50u) / 100u, 1u, 255u);
+      ctx.q_table[t][i] = uint8_t(q);
+      ctx.q_recip[t][i] = 1.0f / float(q * 8u);
+    }
+  }
+}
+
+// bl::Jpeg::Encoder - Huffman Emitters
+// ====================================
+
+//! Collects symbol frequencies, which are used to build optimal Huffman tables.
+//!
+//! Frequencies are 64-bit as a single AC symbol can be emitted up to 63 times per block, which would overflow 32-bit
+//! counters of large images.
+struct EncoderHuffmanStats {
+  uint64_t dc_freq[2][257];
+  uint64_t ac_freq[2][257];
+
+  BL_INLINE void reset() noexcept { memset(this, 0, sizeof(*this)); }
+
+  BL_INLINE void dc_symbol(uint32_t table_id, uint32_t symbol) noexcept { dc_freq[table_id][symbol]++; }
+  BL_INLINE void ac_symbol(uint32_t table_id, uint32_t symbol) noexcept { ac_freq[table_id][symbol]++; }
+  BL_INLINE void extra_bits(uint32_t bits, uint32_t n) noexcept { bl_unused(bits, n); }
+};
+
+//! Writes Huffman coded symbols to a bit-stream.
+struct EncoderHuffmanWriter {
+  EncoderBitWriter& writer;
+  const EncoderContext& ctx;
+
+  BL_INLINE void dc_symbol(uint32_t table_id, uint32_t symbol) noexcept {
+    const EncoderHuffmanTable& table = ctx.dc_table[table_id];
+    BL_ASSERT(table.size[symbol] != 0);
+    writer.write_bits(table.code[symbol], table.size[symbol]);
+  }
+
+  BL_INLINE void ac_symbol(uint32_t table_id, uint32_t symbol) noexcept {
+    const EncoderHuffmanTable& table = ctx.ac_table[table_id];
+    BL_ASSERT(table.size[symbol] != 0);
+    writer.write_bits(table.code[symbol], table.size[symbol]);
+  }
+
+  BL_INLINE void extra_bits(uint32_t bits, uint32_t n) noexcept {
+    writer.write_bits(bits, n);
+  }
+};
+
+// Returns the number of bits required to encode `value` (magnitude category).
+static BL_INLINE uint32_t encoder_value_size(int32_t value) noexcept {
+  uint32_t abs_value = uint32_t(bl_abs(value));
+  return abs_value ? 32u - IntOps::clz(abs_value) : 0u;
+}
+
+// Returns additional bits of `value` having `size` bits - negative values are stored as `value - 1`.
+static BL_INLINE uint32_t encoder_value_bits(int32_t value, uint32_t size) noexcept {
+  return uint32_t(value < 0 ? value - 1 : value) & ((1u << size) - 1u);
+}
+
+template<typename Emitter>
+static BL_INLINE void encoder_encode_block(Emitter& emitter, const int16_t* block, int32_t& dc_pred, uint32_t table_id) noexcept {
+  int32_t dc = block[0];
+  int32_t diff = dc - dc_pred;
+  dc_pred = dc;
+
+  uint32_t size = encoder_value_size(diff);
+  emitter.dc_symbol(table_id, size);
+  emitter.extra_bits(encoder_value_bits(diff, size), size);
+
+  uint32_t run = 0;
+  for (uint32_t k = 1; k < kDctSize2; k++) {
+    int32_t ac = block[de_zig_zag_table[k]];
+    if (ac == 0) {
+      run++;
+      continue;
+    }
+
+    // ZRL - a run of 16 zeros.
+    while (run >= 16) {
+      emitter.ac_symbol(table_id, 0xF0u);
+      run -= 16;
+    }
+
+    size = encoder_value_size(ac);
+    emitter.ac_symbol(table_id, (run << 4) | size);
+    emitter.extra_bits(encoder_value_bits(ac, size), size);
+    run = 0;
+  }
+
+  // EOB - all remaining coefficients are zero.
+  if (run)
+    emitter.ac_symbol(table_id, 0x00u);
+}
+
+template<typename Emitter>
+static void encoder_encode_mcus(EncoderContext& ctx, Emitter& emitter, const int16_t* blocks, uint32_t mcu_count) noexcept {
+  for (uint32_t i = 0; i < mcu_count; i++) {
+    for (uint32_t c = 0; c < ctx.comp_count; c++) {
+      EncoderComponent& comp = ctx.comp[c];
+      uint32_t block_count = uint32_t(comp.sf_w) * comp.sf_h;
+
+      for (uint32_t j = 0; j < block_count; j++, blocks += kDctSize2) {
+        encoder_encode_block(emitter, blocks, comp.dc_pred, comp.table_id);
+      }
+    }
+  }
+}
+
+// bl::Jpeg::Encoder - Transform
+// =============================
+
+static BL_INLINE void encoder_downsample_2x1(uint8_t* dst, const uint8_t* src, uint32_t w) noexcept {
+  for (uint32_t x = 0; x < w; x++)
+    dst[x] = uint8_t((uint32_t(src[x * 2]) + src[x * 2 + 1] + 1u) >> 1);
+}
+
+static BL_INLINE void encoder_downsample_2x2(uint8_t* dst, const uint8_t* src0, const uint8_t* src1, uint32_t w) noexcept {
+  for (uint32_t x = 0; x < w; x++)
+    dst[x] = uint8_t((uint32_t(src0[x * 2]) + src0[x * 2 + 1] + src1[x * 2] + src1[x * 2 + 1] + 2u) >> 2);
+}
+
+//! Converts a single MCU row of `image_data` to YCbCr (or Y), downsamples chroma, and performs FDCT and quantization
+//! of all blocks. Blocks are stored to `blocks` in the order in which they are encoded.
+static void encoder_transform_mcu_row(EncoderContext& ctx, const BLImageData& image_data, uint8_t* const* full_planes, uint32_t mcu_y, int16_t* blocks) noexcept {
+  uint32_t w = ctx.w;
+  uint32_t h = ctx.h;
+  uint32_t padded_w = ctx.mcu.count.w * ctx.mcu.px.w;
+  uint32_t y0 = mcu_y * ctx.mcu.px.h;
+
+  // Convert pixels to planar YCbCr (or Y) and replicate the right-most pixel and the bottom-most row to fill MCUs.
+  for (uint32_t y = 0; y < ctx.mcu.px.h; y++) {
+    uint32_t sy = bl_min(y0 + y, h - 1u);
+    const uint8_t* src_line = static_cast<const uint8_t*>(image_data.pixel_data) + intptr_t(sy) * image_data.stride;
+
+    uint8_t* lines[3];
+    for (uint32_t c = 0; c < ctx.comp_count; c++)
+      lines[c] = full_planes[c] + size_t(y) * padded_w;
+
+    if (ctx.comp_count == 1)
+      memcpy(lines[0], src_line, w);
+    else
+      opts.conv_rgb32_to_ycbcr8(lines[0], lines[1], lines[2], src_line, w);
+
+    for (uint32_t c = 0; c < ctx.comp_count; c++)
+      memset(lines[c] + w, lines[c][w - 1], padded_w - w);
+  }
+
+  // Downsample chroma components, if subsampled.
+  for (uint32_t c = 1; c < ctx.comp_count; c++) {
+    EncoderComponent& comp = ctx.comp[c];
+    if (comp.plane == full_planes[c])
+      continue;
+
+    uint32_t dst_h = uint32_t(comp.sf_h) * kDctSize;
+    for (uint32_t y = 0; y < dst_h; y++) {
+      uint8_t* dst_line = comp.plane + size_t(y) * comp.stride;
+      if (ctx.mcu.sf.h == 2)
+        encoder_downsample_2x2(dst_line, full_planes[c] + size_t(y * 2 + 0) * padded_w, full_planes[c] + size_t(y * 2 + 1) * padded_w, comp.stride);
+      else
+        encoder_downsample_2x1(dst_line, full_planes[c] + size_t(y) * padded_w, comp.stride);
+    }
+  }
+
+  // FDCT and quantization.
+  for (uint32_t mcu_x = 0; mcu_x < ctx.mcu.count.w; mcu_x++) {
+    for (uint32_t c = 0; c < ctx.comp_count; c++) {
+      const EncoderComponent& comp = ctx.comp[c];
+      const float* q_recip = ctx.q_recip[comp.table_id];
+
+      for (uint32_t by = 0; by < comp.sf_h; by++) {
+        const uint8_t* src = comp.plane + size_t(by * kDctSize) * comp.stride + size_t(mcu_x * comp.sf_w) * kDctSize;
+        for (uint32_t bx = 0; bx < comp.sf_w; bx++, blocks += kDctSize2) {
+          opts.fdct8(blocks, src + bx * kDctSize, intptr_t(comp.stride), q_recip);
+        }
+      }
+    }
+  }
+}
+
+// bl::Jpeg::Encoder - Markers
+// ===========================
+
+static BL_INLINE uint8_t* encoder_write_marker(uint8_t* p, uint32_t marker, uint32_t size) noexcept {
+  p[0] = 0xFFu;
+  p[1] = uint8_t(marker);
+  MemOps::writeU16uBE(p + 2, uint16_t(size));
+  return p + 4;
+}
+
+static uint8_t* encoder_write_headers(uint8_t* p, const EncoderContext& ctx) noexcept {
+  uint32_t table_count = ctx.comp_count > 1 ? 2u : 1u;
+
+  // SOI.
+  p[0] = 0xFFu;
+  p[1] = uint8_t(kMarkerSOI);
+  p += 2;
+
+  // APP0 - JFIF 1.01, no density, no thumbnail.
+  p = encoder_write_marker(p, kMarkerAPP0, 16);
+  memcpy(p, "JFIF\0\x01\x01\x00\x00\x01\x00\x01\x00\x00", 14);
+  p += 14;
+
+  // DQT - 8-bit tables stored in zigzag order.
+  p = encoder_write_marker(p, kMarkerDQT, 2 + table_count * (1 + kDctSize2));
+  for (uint32_t t = 0; t < table_count; t++) {
+    *p++ = uint8_t(t);
+    for (uint32_t k = 0; k < kDctSize2; k++)
+      *p++ = ctx.q_table[t][de_zig_zag_table[k]];
+  }
+
+  // SOF0 - Baseline DCT.
+  p = encoder_write_marker(p, kMarkerSOF0, 8 + ctx.comp_count * 3);
+  p[0] = 8;
+  MemOps::writeU16uBE(p + 1, uint16_t(ctx.h));
+  MemOps::writeU16uBE(p + 3, uint16_t(ctx.w));
+  p[5] = uint8_t(ctx.comp_count);
+  p += 6;
+
+  for (uint32_t c = 0; c < ctx.comp_count; c++) {
+    const EncoderComponent& comp = ctx.comp[c];
+    p[0] = comp.comp_id;
+    p[1] = uint8_t((comp.sf_w << 4) | comp.sf_h);
+    p[2] = comp.table_id;
+    p += 3;
+  }
+
+  // DHT - all tables are stored in a single marker.
+  size_t dht_size = 2;
+  for (uint32_t t = 0; t < table_count; t++)
+    dht_size += 34 + ctx.dc_spec[t].count() + ctx.ac_spec[t].count();
+
+  p = encoder_write_marker(p, kMarkerDHT, uint32_t(dht_size));
+  for (uint32_t t = 0; t < table_count; t++) {
+    for (uint32_t table_class = 0; table_class < kTableCount; table_class++) {
+      const HuffmanSpec& spec = table_class == kTableDC ? ctx.dc_spec[t] : ctx.ac_spec[t];
+      uint32_t count = spec.count();
+
+      *p++ = uint8_t((table_class << 4) | t);
+      memcpy(p, spec.bits, 16);
+      memcpy(p + 16, spec.values, count);
+      p += 16 + count;
+    }
+  }
+
+  // SOS - a single interleaved scan.
+  p = encoder_write_marker(p, kMarkerSOS, 6 + ctx.comp_count * 2);
+  *p++ = uint8_t(ctx.comp_count);
+
+  for (uint32_t c = 0; c < ctx.comp_count; c++) {
+    const EncoderComponent& comp = ctx.comp[c];
+    p[0] = comp.comp_id;
+    p[1] = uint8_t((comp.table_id << 4) | comp.table_id);
+    p += 2;
+  }
+
+  p[0] = 0;                // Start of spectral selection.
+  p[1] = kDctSize2 - 1;    // End of spectral selection.
+  p[2] = 0;                // Successive approximation.
+  return p + 3;
+}
+
+// bl::Jpeg::Encoder - Write Frame
+// ===============================
+
+// Makes sure that `writer` has at least `n` bytes available, grows the `dst` array if necessary.
+static BLResult encoder_ensure_space(BLArrayCore* dst, EncoderBitWriter& writer, size_t n) noexcept {
+  if (writer.remaining_size() >= n)
+    return BL_SUCCESS;
+
+  // Trim the array to the data written so far, which is only known when the writer has been initialized.
+  BLArray<uint8_t>& buf = *static_cast<BLArray<uint8_t>*>(dst);
+  if (writer.ptr)
+    ArrayInternal::set_size(dst, PtrOps::byte_offset(buf.data(), writer.ptr));
+
+  uint8_t* p;
+  BL_PROPAGATE(buf.modify_op(BL_MODIFY_OP_APPEND_GROW, n, &p));
+
+  writer.ptr = p;
+  writer.end = p + n;
+  return BL_SUCCESS;
+}
+
+static BLResult encoder_write_frame_internal(BLJpegEncoderImpl* encoder_impl, BLArrayCore* dst, const BLImageData& image_data) noexcept {
+  EncoderContext ctx;
+  memset(&ctx, 0, sizeof(ctx));
+
+  ctx.w = uint32_t(image_data.size.w);
+  ctx.h = uint32_t(image_data.size.h);
+
+  // Setup components - A8 images are encoded as grayscale, XRGB32 and PRGB32 images as YCbCr. PRGB32 images are
+  // premultiplied, so dropping alpha is the same as compositing them over black.
+  if (image_data.format == BL_FORMAT_A8) {
+    ctx.comp_count = 1;
+    ctx.comp[0] = EncoderComponent{1, 0, 1, 1, nullptr, 0, 0};
+  }
+  else {
+    uint8_t sf_w = uint8_t(encoder_impl->subsampling == kSubsampling444 ? 1 : 2);
+    uint8_t sf_h = uint8_t(encoder_impl->subsampling == kSubsampling420 ? 2 : 1);
+
+    ctx.comp_count = 3;
+    ctx.comp[0] = EncoderComponent{1, 0, sf_w, sf_h, nullptr, 0, 0};
+    ctx.comp[1] = EncoderComponent{2, 1, 1, 1, nullptr, 0, 0};
+    ctx.comp[2] = EncoderComponent{3, 1, 1, 1, nullptr, 0, 0};
+  }
+
+  ctx.mcu.sf.w = ctx.comp[0].sf_w;
+  ctx.mcu.sf.h = ctx.comp[0].sf_h;
+  ctx.mcu.px.w = uint8_t(ctx.mcu.sf.w * kDctSize);
+  ctx.mcu.px.h = uint8_t(ctx.mcu.sf.h * kDctSize);
+  ctx.mcu.count.w = (ctx.w + ctx.mcu.px.w - 1) / ctx.mcu.px.w;
+  ctx.mcu.count.h = (ctx.h + ctx.mcu.px.h - 1) / ctx.mcu.px.h;
+
+  for (uint32_t c = 0; c < ctx.comp_count; c++)
+    ctx.blocks_per_mcu += uint32_t(ctx.comp[c].sf_w) * ctx.comp[c].sf_h;
+
+  encoder_init_q_tables(ctx, encoder_impl->quality);
+
+  // Allocate planes of a single MCU row - full resolution planes of all components followed by downsampled planes
+  // of chroma components (if subsampled) and blocks of a single MCU row (or all blocks if Huffman tables are
+  // optimized, which requires two passes).
+  uint32_t padded_w = ctx.mcu.count.w * ctx.mcu.px.w;
+  size_t full_plane_size = size_t(padded_w) * ctx.mcu.px.h;
+  size_t chroma_plane_size = size_t(padded_w / ctx.mcu.sf.w) * kDctSize;
+  bool subsampled = ctx.comp_count > 1 && (ctx.mcu.sf.w | ctx.mcu.sf.h) != 1;
+
+  size_t row_block_count = size_t(ctx.mcu.count.w) * ctx.blocks_per_mcu;
+  size_t block_count = encoder_impl->optimize_huffman ? row_block_count * ctx.mcu.count.h : row_block_count;
+
+  size_t planes_size = full_plane_size * ctx.comp_count + (subsampled ? chroma_plane_size * 2u : size_t(0));
+  size_t blocks_size = block_count * kDctSize2 * sizeof(int16_t);
+
+  ScopedBuffer buffer;
+  uint8_t* buffer_data = static_cast<uint8_t*>(buffer.alloc(blocks_size + planes_size + 16u));
+
+  if (BL_UNLIKELY(!buffer_data))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  // Blocks must be aligned to 16 bytes.
+  int16_t* blocks = reinterpret_cast<int16_t*>(IntOps::align_up(buffer_data, 16));
+  uint8_t* full_planes[3] {};
+
+  {
+    uint8_t* p = reinterpret_cast<uint8_t*>(blocks) + blocks_size;
+    for (uint32_t c = 0; c < ctx.comp_count; c++, p += full_plane_size) {
+      full_planes[c] = p;
+      ctx.comp[c].plane = p;
+      ctx.comp[c].stride = padded_w;
+    }
+
+    if (subsampled) {
+      for (uint32_t c = 1; c < ctx.comp_count; c++, p += chroma_plane_size) {
+        ctx.comp[c].plane = p;
+        ctx.comp[c].stride = padded_w / ctx.mcu.sf.w;
+      }
+    }
+  }
+
+  // Setup Huffman tables - optimal tables require the whole image to be transformed first.
+  uint32_t table_count = ctx.comp_count > 1 ? 2u : 1u;
+
+  if (encoder_impl->optimize_huffman) {
+    EncoderHuffmanStats stats;
+    stats.reset();
+
+    for (uint32_t mcu_y = 0; mcu_y < ctx.mcu.count.h; mcu_y++) {
+      int16_t* row_blocks = blocks + size_t(mcu_y) * row_block_count * kDctSize2;
+      encoder_transform_mcu_row(ctx, image_data, full_planes, mcu_y, row_blocks);
+      encoder_encode_mcus(ctx, stats, row_blocks, ctx.mcu.count.w);
+    }
+
+    for (uint32_t t = 0; t < table_count; t++) {
+      build_optimal_huffman_spec(&ctx.dc_spec[t], stats.dc_freq[t]);
+      build_optimal_huffman_spec(&ctx.ac_spec[t], stats.ac_freq[t]);
+    }
+
+    for (uint32_t c = 0; c < ctx.comp_count; c++)
+      ctx.comp[c].dc_pred = 0;
+  }
+  else {
+    for (uint32_t t = 0; t < table_count; t++) {
+      ctx.dc_spec[t] = encoder_std_dc_spec[t];
+      ctx.ac_spec[t] = encoder_std_ac_spec[t];
+    }
+  }
+
+  for (uint32_t t = 0; t < table_count; t++) {
+    BL_PROPAGATE(build_huffman_encoder_table(&ctx.dc_table[t], ctx.dc_spec[t]));
+    BL_PROPAGATE(build_huffman_encoder_table(&ctx.ac_table[t], ctx.ac_spec[t]));
+  }
+
+  // Write markers and entropy coded data.
+  EncoderBitWriter writer;
+  writer.reset(nullptr, nullptr);
+
+  BL_PROPAGATE(encoder_ensure_space(dst, writer, kEncoderMaxHeaderSize));
+  writer.ptr = encoder_write_headers(writer.ptr, ctx);
+
+  EncoderHuffmanWriter huffman_writer{writer, ctx};
+  size_t row_max_size = row_block_count * kEncoderMaxBlockSize;
+
+  for (uint32_t mcu_y = 0; mcu_y < ctx.mcu.count.h; mcu_y++) {
+    int16_t* row_blocks = blocks;
+
+    if (encoder_impl->optimize_huffman)
+      row_blocks += size_t(mcu_y) * row_block_count * kDctSize2;
+    else
+      encoder_transform_mcu_row(ctx, image_data, full_planes, mcu_y, row_blocks);
+
+    BL_PROPAGATE(encoder_ensure_space(dst, writer, row_max_size));
+    encoder_encode_mcus(ctx, huffman_writer, row_blocks, ctx.mcu.count.w);
+  }
+
+  // Flush remaining bits and write EOI.
+  BL_PROPAGATE(encoder_ensure_space(dst, writer, 16));
+  writer.flush();
+
+  writer.ptr[0] = 0xFFu;
+  writer.ptr[1] = uint8_t(kMarkerEOI);
+  writer.ptr += 2;
+
+  BLArray<uint8_t>& buf = *static_cast<BLArray<uint8_t>*>(dst);
+  ArrayInternal::set_size(dst, PtrOps::byte_offset(buf.data(), writer.ptr));
+  return BL_SUCCESS;
+}
+
+// bl::Jpeg::Encoder - Interface
+// =============================
+
+static BLResult BL_CDECL encoder_restart_impl(BLImageEncoderImpl* impl) noexcept {
+  BLJpegEncoderImpl* encoder_impl = static_cast<BLJpegEncoderImpl*>(impl);
+
+  encoder_impl->last_result = BL_SUCCESS;
+  encoder_impl->frame_index = 0;
+  encoder_impl->buffer_index = 0;
+  encoder_impl->subsampling = uint16_t(kSubsampling420);
+  encoder_impl->quality = 90;
+  encoder_impl->optimize_huffman = 0;
+
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL encoder_get_property_impl(const BLObjectImpl* impl, const char* name, size_t name_size, BLVarCore* value_out) noexcept {
+  const BLJpegEncoderImpl* encoder_impl = static_cast<const BLJpegEncoderImpl*>(impl);
+
+  if (bl_match_property(name, name_size, "quality")) {
+    return bl_var_assign_uint64(value_out, encoder_impl->quality);
+  }
+
+  if (bl_match_property(name, name_size, "subsampling")) {
+    return bl_var_assign_uint64(value_out, encoder_impl->subsampling);
+  }
+
+  if (bl_match_property(name, name_size, "optimize")) {
+    return bl_var_assign_bool(value_out, encoder_impl->optimize_huffman != 0);
+  }
+
+  return bl_object_impl_get_property(encoder_impl, name, name_size, value_out);
+}
+
+static BLResult BL_CDECL encoder_set_property_impl(BLObjectImpl* impl, const char* name, size_t name_size, const BLVarCore* value) noexcept {
+  BLJpegEncoderImpl* encoder_impl = static_cast<BLJpegEncoderImpl*>(impl);
+
+  if (bl_match_property(name, name_size, "quality")) {
+    uint64_t v;
+    BL_PROPAGATE(bl_var_to_uint64(value, &v));
+    encoder_impl->quality = uint8_t(bl_clamp<uint64_t>(v, 1, 100));
+    return BL_SUCCESS;
+  }
+
+  if (bl_match_property(name, name_size, "subsampling")) {
+    uint64_t v;
+    BL_PROPAGATE(bl_var_to_uint64(value, &v));
+
+    if (v != kSubsampling444 && v != kSubsampling422 && v != kSubsampling420)
+      return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+    encoder_impl->subsampling = uint16_t(v);
+    return BL_SUCCESS;
+  }
+
+  if (bl_match_property(name, name_size, "optimize")) {
+    bool v;
+    BL_PROPAGATE(bl_var_to_bool(value, &v));
+    encoder_impl->optimize_huffman = uint8_t(v);
+    return BL_SUCCESS;
+  }
+
+  return bl_object_impl_set_property(encoder_impl, name, name_size, value);
+}
+
+static BLResult BL_CDECL encoder_write_frame_impl(BLImageEncoderImpl* impl, BLArrayCore* dst, const BLImageCore* image) noexcept {
+  BLJpegEncoderImpl* encoder_impl = static_cast<BLJpegEncoderImpl*>(impl);
+  BL_PROPAGATE(encoder_impl->last_result);
+
+  const BLImage& img = *static_cast<const BLImage*>(image);
+  if (img.is_empty())
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BLImageData image_data;
+  BL_PROPAGATE(img.get_data(&image_data));
+
+  // JPEG stores width and height as 16-bit integers.
+  if (image_data.size.w > 65535 || image_data.size.h > 65535)
+    return bl_make_error(BL_ERROR_IMAGE_TOO_LARGE);
+
+  if (image_data.format != BL_FORMAT_PRGB32 && image_data.format != BL_FORMAT_XRGB32 && image_data.format != BL_FORMAT_A8)
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  size_t prev_size = static_cast<BLArray<uint8_t>*>(dst)->size();
+  BLResult result = encoder_write_frame_internal(encoder_impl, dst, image_data);
+
+  // Don't leave partially written data in `dst` in case of failure.
+  if (BL_UNLIKELY(result != BL_SUCCESS))
+    ArrayInternal::set_size(dst, prev_size);
+  else
+    encoder_impl->frame_index++;
+
+  return result;
+}
+
+static BLResult encoder_create_impl(BLImageEncoderCore* self) noexcept {
+  BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE_ENCODER);
+  BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLJpegEncoderImpl>(self, info));
+
+  BLJpegEncoderImpl* encoder_impl = static_cast<BLJpegEncoderImpl*>(self->_d.impl);
+  encoder_impl->ctor(&jpeg_encoder_virt, &jpeg_codec_instance);
+  return encoder_restart_impl(encoder_impl);
+}
+
+static BLResult BL_CDECL encoder_destroy_impl(BLObjectImpl* impl) noexcept {
+  BLJpegEncoderImpl* encoder_impl = static_cast<BLJpegEncoderImpl*>(impl);
+  encoder_impl->dtor();
+  return bl_object_free_impl(encoder_impl);
+}
+
 // bl::Jpeg::Codec - Interface
 // ===========================
 
@@ -1550,16 +2517,10 @@ static BLResult BL_CDECL codec_create_decoder_impl(const BLImageCodecImpl* impl,
 
 static BLResult BL_CDECL codec_create_encoder_impl(const BLImageCodecImpl* impl, BLImageEncoderCore* dst) noexcept {
   bl_unused(impl);
-  bl_unused(dst);
-
-  return bl_make_error(BL_ERROR_IMAGE_ENCODER_NOT_PROVIDED);
 
-  // TODO: [JPEG] Encoder
-  /*
   BLImageEncoderCore tmp;
-  BL_PROPAGATE(bl_jpeg_encoder_impl_create(tmp._d));
+  BL_PROPAGATE(encoder_create_impl(&tmp));
   return bl_image_encoder_assign_move(dst, &tmp);
-  */
 }
 
 // bl::Jpeg::Codec - Runtime Registration
@@ -1568,24 +2529,10 @@ static BLResult BL_CDECL codec_create_encoder_impl(const BLImageCodecImpl* impl,
 void jpeg_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noexcept {
   using namespace bl::Jpeg;
 
-  bl_unused(rt);
-
   BL_DEFINE_STATIC_STRING(jpeg_extensions, "jpg|jpeg|jif|jfi|jfif");
 
   // Initialize JPEG opts.
-  opts.idct8 = idct8;
-  opts.conv_ycbcr8_to_rgb32 = rgb32_from_ycbcr8;
-
-#ifdef BL_BUILD_OPT_SSE2
-  opts.idct8 = idct8_sse2;
-  opts.conv_ycbcr8_to_rgb32 = rgb32_from_ycbcr8_sse2;
-#endif
-
-  opts.upsample_1x1 = upsample_1x1;
-  opts.upsample_1x2 = upsample_1x2;
-  opts.upsample_2x1 = upsample_2x1;
-  opts.upsample_2x2 = upsample_2x2;
-  opts.upsample_any = upsample_generic;
+  init_func_opts(rt);
 
   // Initialize JPEG codec.
   jpeg_codec.virt.base.destroy = codec_destroy_impl;
@@ -1597,9 +2544,10 @@ void jpeg_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noe
 
   jpeg_codec.impl->ctor(&jpeg_codec.virt);
   jpeg_codec.impl->features =
-    BL_IMAGE_CODEC_FEATURE_READ  |
-    BL_IMAGE_CODEC_FEATURE_WRITE |
-    BL_IMAGE_CODEC_FEATURE_LOSSY ;
+    BL_IMAGE_CODEC_FEATURE_READ      |
+    BL_IMAGE_CODEC_FEATURE_WRITE     |
+    BL_IMAGE_CODEC_FEATURE_LOSSY     |
+    BL_IMAGE_CODEC_FEATURE_READ_ROWS ;
   jpeg_codec.impl->name.dcast().assign("JPEG");
   jpeg_codec.impl->vendor.dcast().assign("Blend2D");
   jpeg_codec.impl->mime_type.dcast().assign("image/jpeg");
@@ -1609,14 +2557,19 @@ void jpeg_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noe
 
   // Initialize JPEG decoder virtual functions.
   jpeg_decoder_virt.base.destroy = decoder_destroy_impl;
-  jpeg_decoder_virt.base.get_property = bl_object_impl_get_property;
-  jpeg_decoder_virt.base.set_property = bl_object_impl_set_property;
+  jpeg_decoder_virt.base.get_property = decoder_get_property_impl;
+  jpeg_decoder_virt.base.set_property = decoder_set_property_impl;
   jpeg_decoder_virt.restart = decoder_restart_impl;
   jpeg_decoder_virt.read_info = decoder_read_info_impl;
   jpeg_decoder_virt.read_frame = decoder_read_frame_impl;
+  jpeg_decoder_virt.read_frame_rows = decoder_read_frame_rows_impl;
 
   // Initialize JPEG encoder virtual functions.
-  // TODO: [JPEG] Encoder
+  jpeg_encoder_virt.base.destroy = encoder_destroy_impl;
+  jpeg_encoder_virt.base.get_property = encoder_get_property_impl;
+  jpeg_encoder_virt.base.set_property = encoder_set_property_impl;
+  jpeg_encoder_virt.restart = encoder_restart_impl;
+  jpeg_encoder_virt.write_frame = encoder_write_frame_impl;
 
   codecs->append(jpeg_codec_instance.dcast());
 }
@@ -116,6 +116,11 @@ static constexpr uint32_t kTableDC            = 0; //!< DC table.
 static constexpr uint32_t kTableAC            = 1; //!< AC table.
 static constexpr uint32_t kTableCount         = 2; //!< Number of tables.
 
+// JPEG encoder's chroma subsampling (values match the "subsampling" property of the encoder):
+static constexpr uint32_t kSubsampling444     = 444; //!< No chroma subsampling.
+static constexpr uint32_t kSubsampling422     = 422; //!< Chroma subsampled horizontally.
+static constexpr uint32_t kSubsampling420     = 420; //!< Chroma subsampled horizontally and vertically.
+
 //! JPEG decoder flags - bits of information collected from JPEG markers.
 enum class DecoderStatusFlags : uint32_t {
   kNoFlags  = 0u,
@@ -187,6 +192,8 @@ struct DecoderComponent {
   uint32_t os_w;
   //! Oversized height to match the total height required by all MCUs.
   uint32_t os_h;
+  //! Number of rows allocated in `data` - either `os_h` or a few MCU rows used as a ring buffer when decoding in bands.
+  uint32_t plane_h;
   //! Number of 8x8 blocks in horizontal direction.
   uint32_t bl_w;
   //! Number of 8x8 blocks in vertical direction.
@@ -271,6 +278,8 @@ struct BLJpegDecoderImpl : public BLImageDecoderImpl {
   uint8_t ac_table_mask;
   //! Mask of all defined (de)quantization tables.
   uint8_t q_table_mask;
+  //! Downscale factor of decoded images as a power of 2 (0-3), see `scale_denom` property. Not reset by restart.
+  uint8_t scale_shift;
 
   //! JPEG decoder MCU information.
   bl::Jpeg::MCUInfo mcu;
@@ -288,7 +297,14 @@ struct BLJpegDecoderImpl : public BLImageDecoderImpl {
   bl::Jpeg::Block<uint16_t> q_table[4];
 };
 
-struct BLJpegEncoderImpl : public BLImageEncoderImpl {};
+struct BLJpegEncoderImpl : public BLImageEncoderImpl {
+  //! Chroma subsampling (444, 422, or 420).
+  uint16_t subsampling;
+  //! Quality in [1, 100] range.
+  uint8_t quality;
+  //! Whether to compute optimal Huffman tables instead of using the standard ones (requires two passes).
+  uint8_t optimize_huffman;
+};
 
 struct BLJpegCodecImpl : public BLImageCodecImpl {};
 
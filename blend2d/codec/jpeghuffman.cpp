@@ -122,4 +122,140 @@ BLResult build_huffman_ac(DecoderHuffmanACTable* table, const uint8_t* data, siz
   return BL_SUCCESS;
 }
 
+// bl::Jpeg::Huffman - BuildHuffmanEncoderTable
+// ============================================
+
+BLResult build_huffman_encoder_table(EncoderHuffmanTable* table, const HuffmanSpec& spec) noexcept {
+  uint32_t n = spec.count();
+  if (BL_UNLIKELY(n > 256))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  memset(table->size, 0, sizeof(table->size));
+
+  uint32_t code = 0;
+  uint32_t k = 0;
+
+  for (uint32_t i = 1; i <= 16; i++, code <<= 1) {
+    uint32_t count = spec.bits[i - 1];
+    for (uint32_t j = 0; j < count; j++) {
+      uint32_t symbol = spec.values[k++];
+      table->code[symbol] = uint16_t(code++);
+      table->size[symbol] = uint8_t(i);
+    }
+
+    if (BL_UNLIKELY(code > (1u << i)))
+      return bl_make_error(BL_ERROR_INVALID_VALUE);
+  }
+
+  return BL_SUCCESS;
+}
+
+// bl::Jpeg::Huffman - BuildOptimalHuffmanSpec
+// ===========================================
+
+void build_optimal_huffman_spec(HuffmanSpec* spec, uint64_t* freq) noexcept {
+  // The maximum code length before it's limited to 16 bits. Since frequencies are 64-bit integers the depth of
+  // the tree cannot exceed the length of a Fibonacci sequence, which sum fits into 64 bits.
+  constexpr uint32_t kMaxCodeSize = 127;
+
+  uint8_t bits[kMaxCodeSize + 1] {};
+  uint8_t code_size[257] {};
+  int32_t others[257];
+
+  for (uint32_t i = 0; i < 257; i++)
+    others[i] = -1;
+
+  // Make sure there is at least one symbol, a table that has no symbols is invalid.
+  uint64_t used_symbols = 0;
+  for (uint32_t i = 0; i < 256; i++)
+    used_symbols |= freq[i];
+
+  if (!used_symbols)
+    freq[0] = 1;
+
+  // Reserve one code point to guarantee that no real code is all ones.
+  freq[256] = 1;
+
+  for (;;) {
+    // Find the smallest nonzero frequency, the largest symbol is picked on a tie.
+    int32_t c1 = -1;
+    int32_t c2 = -1;
+    uint64_t v1 = UINT64_MAX;
+    uint64_t v2 = UINT64_MAX;
+
+    for (uint32_t i = 0; i < 257; i++) {
+      if (freq[i] && freq[i] <= v1) {
+        v1 = freq[i];
+        c1 = int32_t(i);
+      }
+    }
+
+    // Find the next smallest nonzero frequency.
+    for (uint32_t i = 0; i < 257; i++) {
+      if (freq[i] && freq[i] <= v2 && int32_t(i) != c1) {
+        v2 = freq[i];
+        c2 = int32_t(i);
+      }
+    }
+
+    // Done if there is only one tree left.
+    if (c2 < 0)
+      break;
+
+    // Merge the two trees and increment code sizes of all symbols in both of them.
+    freq[c1] += freq[c2];
+    freq[c2] = 0;
+
+    code_size[c1]++;
+    while (others[c1] >= 0) {
+      c1 = others[c1];
+      code_size[c1]++;
+    }
+    others[c1] = c2;
+
+    code_size[c2]++;
+    while (others[c2] >= 0) {
+      c2 = others[c2];
+      code_size[c2]++;
+    }
+  }
+
+  for (uint32_t i = 0; i < 257; i++) {
+    if (code_size[i])
+      bits[bl_min<uint32_t>(code_size[i], kMaxCodeSize)]++;
+  }
+
+  // Limit code sizes to 16 bits - a pair of the longest codes is replaced by a single code, which is one bit shorter,
+  // and a shorter code is split into two codes, which are one bit longer.
+  uint32_t i = kMaxCodeSize;
+  for (; i > 16; i--) {
+    while (bits[i] > 0) {
+      uint32_t j = i - 2;
+      while (bits[j] == 0)
+        j--;
+
+      bits[i] -= 2;
+      bits[i - 1]++;
+      bits[j + 1] += 2;
+      bits[j]--;
+    }
+  }
+
+  // Remove the reserved code point from the longest codes.
+  while (bits[i] == 0)
+    i--;
+  bits[i]--;
+
+  memcpy(spec->bits, bits + 1, 16);
+
+  // Symbols are sorted by their code size first and their value second, the reserved symbol is not emitted.
+  uint32_t k = 0;
+  for (uint32_t size = 1; size <= kMaxCodeSize; size++) {
+    for (uint32_t symbol = 0; symbol < 256; symbol++) {
+      if (code_size[symbol] == size)
+        spec->values[k++] = uint8_t(symbol);
+    }
+  }
+}
+
 } // {bl::Jpeg}
@@ -8,6 +8,7 @@
 
 #include <blend2d/core/api-internal_p.h>
 #include <blend2d/support/intops_p.h>
+#include <blend2d/support/memops_p.h>
 #include <blend2d/support/ptrops_p.h>
 
 //! \cond INTERNAL
@@ -229,6 +230,105 @@ struct DecoderBitReader {
 BL_HIDDEN BLResult build_huffman_ac(DecoderHuffmanACTable* table, const uint8_t* data, size_t data_size, size_t* bytes_consumed) noexcept;
 BL_HIDDEN BLResult build_huffman_dc(DecoderHuffmanDCTable* table, const uint8_t* data, size_t data_size, size_t* bytes_consumed) noexcept;
 
+//! JPEG Huffman table specification - the content of a single table stored in DHT marker.
+struct HuffmanSpec {
+  //! Number of codes of each length [1, 16].
+  uint8_t bits[16];
+  //! Huffman symbols, in order of increasing code length.
+  uint8_t values[256];
+
+  //! Returns the number of symbols described by `bits`.
+  BL_INLINE uint32_t count() const noexcept {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < 16; i++)
+      n += bits[i];
+    return n;
+  }
+};
+
+//! JPEG Huffman compression table.
+struct EncoderHuffmanTable {
+  //! Huffman code of each symbol.
+  uint16_t code[256];
+  //! Huffman code size of each symbol, zero if the symbol has no code.
+  uint8_t size[256];
+};
+
+//! JPEG encoder's bit-writer.
+//!
+//! Writes Huffman codes and additional bits MSB first and escapes each [0xFF] byte by [0xFF, 0x00]. The writer
+//! doesn't check bounds, so the caller must make sure there is enough space in the output buffer.
+struct EncoderBitWriter {
+  //! Data pointer (points to the byte to be written).
+  uint8_t* ptr;
+  //! End of output.
+  uint8_t* end;
+  //! Accumulated bits (only `bit_count` low bits are valid).
+  uint64_t bit_data;
+  //! Number of valid bits in `bit_data`.
+  size_t bit_count;
+
+  BL_INLINE void reset(uint8_t* ptr_, uint8_t* end_) noexcept {
+    ptr = ptr_;
+    end = end_;
+    bit_data = 0;
+    bit_count = 0;
+  }
+
+  BL_INLINE size_t remaining_size() const noexcept { return PtrOps::bytes_until(ptr, end); }
+
+  BL_INLINE void write_byte(uint32_t b) noexcept {
+    *ptr++ = uint8_t(b);
+    if (b == 0xFFu)
+      *ptr++ = 0x00u;
+  }
+
+  BL_INLINE void write_bits(uint32_t bits, size_t n) noexcept {
+    BL_ASSERT(n <= 16);
+
+    bit_data = (bit_data << n) | bits;
+    bit_count += n;
+
+    if (bit_count >= 32) {
+      bit_count -= 32;
+      uint32_t v = uint32_t(bit_data >> bit_count);
+
+      // Fast case - no byte has to be escaped (there is no zero byte in `~v`).
+      uint32_t inv = ~v;
+      if (((inv - 0x01010101u) & ~inv & 0x80808080u) == 0) {
+        MemOps::writeU32uBE(ptr, v);
+        ptr += 4;
+      }
+      else {
+        write_byte((v >> 24) & 0xFFu);
+        write_byte((v >> 16) & 0xFFu);
+        write_byte((v >>  8) & 0xFFu);
+        write_byte((v      ) & 0xFFu);
+      }
+    }
+  }
+
+  //! Pads the remaining bits by ones (as required by the specification) and writes them.
+  BL_INLINE void flush() noexcept {
+    size_t padding = (8u - (bit_count & 7u)) & 7u;
+    bit_data = (bit_data << padding) | ((1u << padding) - 1u);
+    bit_count += padding;
+
+    while (bit_count) {
+      bit_count -= 8;
+      write_byte(uint32_t(bit_data >> bit_count) & 0xFFu);
+    }
+
+    bit_data = 0;
+  }
+};
+
+BL_HIDDEN BLResult build_huffman_encoder_table(EncoderHuffmanTable* table, const HuffmanSpec& spec) noexcept;
+
+//! Builds an optimal Huffman table specification from symbol frequencies as described by JPEG specification
+//! (Annex K.2). The `freq` array must have 257 entries, the last one is reserved and is modified by the function.
+BL_HIDDEN void build_optimal_huffman_spec(HuffmanSpec* spec, uint64_t* freq) noexcept;
+
 } // {bl::Jpeg}
 
 //! \}
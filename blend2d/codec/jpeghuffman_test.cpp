@@ -0,0 +1,77 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/codec/jpeghuffman_p.h>
+
+// bl::Jpeg::Huffman - Tests
+// =========================
+
+namespace bl::Jpeg::Tests {
+
+// Returns code sizes of all symbols described by `spec`, unused symbols have zero size.
+static void get_code_sizes(const HuffmanSpec& spec, uint32_t* code_sizes) noexcept {
+  for (uint32_t i = 0; i < 256; i++)
+    code_sizes[i] = 0;
+
+  uint32_t k = 0;
+  for (uint32_t size = 1; size <= 16; size++) {
+    for (uint32_t j = 0; j < spec.bits[size - 1]; j++)
+      code_sizes[spec.values[k++]] = size;
+  }
+}
+
+UNIT(codec_jpeg_huffman, BL_TEST_GROUP_IMAGE_CODEC_OPS) {
+  INFO("Testing optimal Huffman tables built from frequencies that exceed 32 bits");
+  {
+    // Sums of any two of these frequencies don't fit into 32 bits, so 32-bit counters would wrap and produce
+    // a tree that is deeper than necessary.
+    uint64_t freq[257] {};
+    freq[0x00] = 3000000000u;
+    freq[0x01] = 3000000000u;
+    freq[0x11] = 3000000000u;
+    freq[0x22] = 3000000000u;
+    freq[0xF0] = 3000000000u;
+
+    HuffmanSpec spec;
+    build_optimal_huffman_spec(&spec, freq);
+    EXPECT_EQ(spec.count(), 5u);
+
+    EncoderHuffmanTable table;
+    EXPECT_SUCCESS(build_huffman_encoder_table(&table, spec));
+
+    // Two codes have 2 bits and three codes have 3 bits (the reserved code point would be the fourth 3-bit code).
+    EXPECT_EQ(spec.bits[0], 0u);
+    EXPECT_EQ(spec.bits[1], 2u);
+    EXPECT_EQ(spec.bits[2], 3u);
+    EXPECT_EQ(spec.bits[3], 0u);
+  }
+
+  INFO("Testing optimal Huffman tables of symbols having the same frequency");
+  {
+    uint64_t freq[257] {};
+    for (uint32_t i = 0; i < 256; i++)
+      freq[i] = uint64_t(1) << 40;
+
+    HuffmanSpec spec;
+    build_optimal_huffman_spec(&spec, freq);
+    EXPECT_EQ(spec.count(), 256u);
+
+    EncoderHuffmanTable table;
+    EXPECT_SUCCESS(build_huffman_encoder_table(&table, spec));
+
+    uint32_t code_sizes[256];
+    get_code_sizes(spec, code_sizes);
+
+    for (uint32_t i = 0; i < 256; i++)
+      EXPECT_TRUE(code_sizes[i] == 8u || code_sizes[i] == 9u).message("Symbol %u has code size %u", i, code_sizes[i]);
+  }
+}
+
+} // {bl::Jpeg::Tests}
+
+#endif // BL_TEST
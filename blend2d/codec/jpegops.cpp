@@ -9,9 +9,11 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/rgba_p.h>
+#include <blend2d/core/runtime_p.h>
 #include <blend2d/codec/jpegcodec_p.h>
 #include <blend2d/codec/jpegops_p.h>
 #include <blend2d/support/intops_p.h>
+#include <blend2d/support/math_p.h>
 #include <blend2d/support/memops_p.h>
 
 namespace bl::Jpeg {
@@ -129,6 +131,265 @@ void BL_CDECL idct8(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const
   }
 }
 
+// bl::Jpeg::Opts - Reduced IDCT
+// =============================
+
+// Reduced IDCTs produce 4x4, 2x2, or 1x1 pixels from a block of 8x8 coefficients, which is used to decode images
+// downscaled by 2, 4, or 8. They only use low frequencies that contribute to the output. Derived from jidctred's
+// `jpeg_idct_4x4` and `jpeg_idct_2x2`.
+
+#define BL_JPEG_IDCT_M_0_211164243 (-BL_JPEG_IDCT_FIXED(0.211164243))
+#define BL_JPEG_IDCT_M_0_509795579 (-BL_JPEG_IDCT_FIXED(0.509795579))
+#define BL_JPEG_IDCT_M_0_601344887 (-BL_JPEG_IDCT_FIXED(0.601344887))
+#define BL_JPEG_IDCT_M_0_720959822 (-BL_JPEG_IDCT_FIXED(0.720959822))
+#define BL_JPEG_IDCT_M_0_765366865 (-BL_JPEG_IDCT_FIXED(0.765366865))
+#define BL_JPEG_IDCT_M_1_272758580 (-BL_JPEG_IDCT_FIXED(1.272758580))
+#define BL_JPEG_IDCT_M_2_172734803 (-BL_JPEG_IDCT_FIXED(2.172734803))
+#define BL_JPEG_IDCT_P_0_850430095 ( BL_JPEG_IDCT_FIXED(0.850430095))
+#define BL_JPEG_IDCT_P_0_899976223 ( BL_JPEG_IDCT_FIXED(0.899976223))
+#define BL_JPEG_IDCT_P_1_061594337 ( BL_JPEG_IDCT_FIXED(1.061594337))
+#define BL_JPEG_IDCT_P_1_451774981 ( BL_JPEG_IDCT_FIXED(1.451774981))
+#define BL_JPEG_IDCT_P_1_847759065 ( BL_JPEG_IDCT_FIXED(1.847759065))
+#define BL_JPEG_IDCT_P_2_562915447 ( BL_JPEG_IDCT_FIXED(2.562915447))
+#define BL_JPEG_IDCT_P_3_624509785 ( BL_JPEG_IDCT_FIXED(3.624509785))
+
+#define BL_JPEG_IDCT_IDCT4(s0, s1, s2, s3, s5, s6, s7)    \
+  int t0, t2, t10, t12;                                \
+                                                       \
+  t0 = (s0) << (BL_JPEG_IDCT_PREC + 1);                \
+  t2 = (s2) * BL_JPEG_IDCT_P_1_847759065 + (s6) * BL_JPEG_IDCT_M_0_765366865; \
+                                                       \
+  t10 = t0 + t2;                                       \
+  t12 = t0 - t2;                                       \
+                                                       \
+  t0 = (s7) * BL_JPEG_IDCT_M_0_211164243 + (s5) * BL_JPEG_IDCT_P_1_451774981 + \
+       (s3) * BL_JPEG_IDCT_M_2_172734803 + (s1) * BL_JPEG_IDCT_P_1_061594337;  \
+  t2 = (s7) * BL_JPEG_IDCT_M_0_509795579 + (s5) * BL_JPEG_IDCT_M_0_601344887 + \
+       (s3) * BL_JPEG_IDCT_P_0_899976223 + (s1) * BL_JPEG_IDCT_P_2_562915447;
+
+#define BL_JPEG_IDCT_IDCT2(s0, s1, s3, s5, s7)            \
+  int t0, t10;                                         \
+                                                       \
+  t10 = (s0) << (BL_JPEG_IDCT_PREC + 2);               \
+  t0 = (s7) * BL_JPEG_IDCT_M_0_720959822 + (s5) * BL_JPEG_IDCT_P_0_850430095 + \
+       (s3) * BL_JPEG_IDCT_M_1_272758580 + (s1) * BL_JPEG_IDCT_P_3_624509785;
+
+void BL_CDECL idct4(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept {
+  constexpr uint32_t kColNorm = BL_JPEG_IDCT_COL_NORM + 1;
+  constexpr uint32_t kRowNorm = BL_JPEG_IDCT_ROW_NORM + 1;
+
+  constexpr int kColBias = BL_JPEG_IDCT_HALF(kColNorm);
+  constexpr int kRowBias = BL_JPEG_IDCT_HALF(kRowNorm) + (128 << kRowNorm);
+
+  uint32_t i;
+  int32_t* tmp;
+  int32_t tmp_data[32];
+
+  // Column 4 doesn't contribute to the output.
+  for (i = 0, tmp = tmp_data; i < 8; i++, src++, tmp++, q_table++) {
+    if (i == 4)
+      continue;
+
+    // Avoid dequantizing and IDCTing zeros.
+    if (src[8] == 0 && src[16] == 0 && src[24] == 0 && src[40] == 0 && src[48] == 0 && src[56] == 0) {
+      int32_t dc_term = (int32_t(src[0]) * int32_t(q_table[0])) << (BL_JPEG_IDCT_PREC - BL_JPEG_IDCT_COL_NORM);
+      tmp[0] = tmp[8] = tmp[16] = tmp[24] = dc_term;
+    }
+    else {
+      BL_JPEG_IDCT_IDCT4(
+        int32_t(src[ 0]) * int32_t(q_table[ 0]),
+        int32_t(src[ 8]) * int32_t(q_table[ 8]),
+        int32_t(src[16]) * int32_t(q_table[16]),
+        int32_t(src[24]) * int32_t(q_table[24]),
+        int32_t(src[40]) * int32_t(q_table[40]),
+        int32_t(src[48]) * int32_t(q_table[48]),
+        int32_t(src[56]) * int32_t(q_table[56]));
+
+      tmp[ 0] = (t10 + t2 + kColBias) >> kColNorm;
+      tmp[24] = (t10 - t2 + kColBias) >> kColNorm;
+      tmp[ 8] = (t12 + t0 + kColBias) >> kColNorm;
+      tmp[16] = (t12 - t0 + kColBias) >> kColNorm;
+    }
+  }
+
+  for (i = 0, tmp = tmp_data; i < 4; i++, dst += dst_stride, tmp += 8) {
+    BL_JPEG_IDCT_IDCT4(tmp[0], tmp[1], tmp[2], tmp[3], tmp[5], tmp[6], tmp[7])
+
+    dst[0] = IntOps::clamp_to_byte((t10 + t2 + kRowBias) >> kRowNorm);
+    dst[3] = IntOps::clamp_to_byte((t10 - t2 + kRowBias) >> kRowNorm);
+    dst[1] = IntOps::clamp_to_byte((t12 + t0 + kRowBias) >> kRowNorm);
+    dst[2] = IntOps::clamp_to_byte((t12 - t0 + kRowBias) >> kRowNorm);
+  }
+}
+
+void BL_CDECL idct2(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept {
+  constexpr uint32_t kColNorm = BL_JPEG_IDCT_COL_NORM + 2;
+  constexpr uint32_t kRowNorm = BL_JPEG_IDCT_ROW_NORM + 2;
+
+  constexpr int kColBias = BL_JPEG_IDCT_HALF(kColNorm);
+  constexpr int kRowBias = BL_JPEG_IDCT_HALF(kRowNorm) + (128 << kRowNorm);
+
+  uint32_t i;
+  int32_t* tmp;
+  int32_t tmp_data[16];
+
+  // Even columns except the first one don't contribute to the output.
+  for (i = 0, tmp = tmp_data; i < 8; i++, src++, tmp++, q_table++) {
+    if (i == 2 || i == 4 || i == 6)
+      continue;
+
+    // Avoid dequantizing and IDCTing zeros.
+    if (src[8] == 0 && src[24] == 0 && src[40] == 0 && src[56] == 0) {
+      int32_t dc_term = (int32_t(src[0]) * int32_t(q_table[0])) << (BL_JPEG_IDCT_PREC - BL_JPEG_IDCT_COL_NORM);
+      tmp[0] = tmp[8] = dc_term;
+    }
+    else {
+      BL_JPEG_IDCT_IDCT2(
+        int32_t(src[ 0]) * int32_t(q_table[ 0]),
+        int32_t(src[ 8]) * int32_t(q_table[ 8]),
+        int32_t(src[24]) * int32_t(q_table[24]),
+        int32_t(src[40]) * int32_t(q_table[40]),
+        int32_t(src[56]) * int32_t(q_table[56]));
+
+      tmp[0] = (t10 + t0 + kColBias) >> kColNorm;
+      tmp[8] = (t10 - t0 + kColBias) >> kColNorm;
+    }
+  }
+
+  for (i = 0, tmp = tmp_data; i < 2; i++, dst += dst_stride, tmp += 8) {
+    BL_JPEG_IDCT_IDCT2(tmp[0], tmp[1], tmp[3], tmp[5], tmp[7])
+
+    dst[0] = IntOps::clamp_to_byte((t10 + t0 + kRowBias) >> kRowNorm);
+    dst[1] = IntOps::clamp_to_byte((t10 - t0 + kRowBias) >> kRowNorm);
+  }
+}
+
+void BL_CDECL idct1(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept {
+  bl_unused(dst_stride);
+
+  // DC coefficient is an average of the block scaled by 8.
+  int32_t dc = int32_t(src[0]) * int32_t(q_table[0]);
+  dst[0] = IntOps::clamp_to_byte(((dc + 4) >> 3) + 128);
+}
+
+// bl::Jpeg::Opts - FDCT
+// =====================
+
+// Derived from jfdctint's `jpeg_fdct_islow`. Outputs unscaled even (r0, r4) and scaled (r1, r2, r3, r5, r6, r7)
+// terms, which are then normalized differently by the first and the second pass.
+#define BL_JPEG_FDCT_FDCT(s0, s1, s2, s3, s4, s5, s6, s7) \
+  int t0 = (s0) + (s7);                           \
+  int t7 = (s0) - (s7);                           \
+  int t1 = (s1) + (s6);                           \
+  int t6 = (s1) - (s6);                           \
+  int t2 = (s2) + (s5);                           \
+  int t5 = (s2) - (s5);                           \
+  int t3 = (s3) + (s4);                           \
+  int t4 = (s3) - (s4);                           \
+                                                  \
+  int t10 = t0 + t3;                              \
+  int t13 = t0 - t3;                              \
+  int t11 = t1 + t2;                              \
+  int t12 = t1 - t2;                              \
+                                                  \
+  int r0 = t10 + t11;                             \
+  int r4 = t10 - t11;                             \
+                                                  \
+  int z1 = (t12 + t13) * BL_JPEG_IDCT_P_0_541196100; \
+  int r2 = z1 + t13 * BL_JPEG_IDCT_P_0_765366865; \
+  int r6 = z1 + t12 * BL_JPEG_IDCT_M_1_847759065; \
+                                                  \
+  int z3 = t4 + t6;                               \
+  int z4 = t5 + t7;                               \
+  int z5 = (z3 + z4) * BL_JPEG_IDCT_P_1_175875602; \
+                                                  \
+  z1 = (t4 + t7) * BL_JPEG_IDCT_M_0_899976223;    \
+  int z2 = (t5 + t6) * BL_JPEG_IDCT_M_2_562915447; \
+  z3 = z3 * BL_JPEG_IDCT_M_1_961570560 + z5;      \
+  z4 = z4 * BL_JPEG_IDCT_M_0_390180644 + z5;      \
+                                                  \
+  int r7 = t4 * BL_JPEG_IDCT_P_0_298631336 + z1 + z3; \
+  int r5 = t5 * BL_JPEG_IDCT_P_2_053119869 + z2 + z4; \
+  int r3 = t6 * BL_JPEG_IDCT_P_3_072711026 + z2 + z3; \
+  int r1 = t7 * BL_JPEG_IDCT_P_1_501321110 + z1 + z4;
+
+void BL_CDECL fdct8(int16_t* dst, const uint8_t* src, intptr_t src_stride, const float* q_recip) noexcept {
+  uint32_t i;
+  int32_t* tmp;
+  int32_t tmp_data[64];
+
+  constexpr int kPass1Bias = BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS1_NORM);
+  constexpr int kPass2Bias = BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS2_NORM);
+  constexpr int kPass2DcBias = BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS1_BITS);
+
+  // Columns - samples are converted from `0..255` to `-128..127` range first.
+  for (i = 0, tmp = tmp_data; i < 8; i++, src++, tmp++) {
+    BL_JPEG_FDCT_FDCT(
+      int(src[0 * src_stride]) - 128,
+      int(src[1 * src_stride]) - 128,
+      int(src[2 * src_stride]) - 128,
+      int(src[3 * src_stride]) - 128,
+      int(src[4 * src_stride]) - 128,
+      int(src[5 * src_stride]) - 128,
+      int(src[6 * src_stride]) - 128,
+      int(src[7 * src_stride]) - 128)
+
+    tmp[ 0] = r0 << BL_JPEG_FDCT_PASS1_BITS;
+    tmp[32] = r4 << BL_JPEG_FDCT_PASS1_BITS;
+    tmp[ 8] = (r1 + kPass1Bias) >> BL_JPEG_FDCT_PASS1_NORM;
+    tmp[16] = (r2 + kPass1Bias) >> BL_JPEG_FDCT_PASS1_NORM;
+    tmp[24] = (r3 + kPass1Bias) >> BL_JPEG_FDCT_PASS1_NORM;
+    tmp[40] = (r5 + kPass1Bias) >> BL_JPEG_FDCT_PASS1_NORM;
+    tmp[48] = (r6 + kPass1Bias) >> BL_JPEG_FDCT_PASS1_NORM;
+    tmp[56] = (r7 + kPass1Bias) >> BL_JPEG_FDCT_PASS1_NORM;
+  }
+
+  // Rows - quantized results are rounded to nearest even, which matches what SIMD implementations do.
+  for (i = 0, tmp = tmp_data; i < 8; i++, dst += 8, tmp += 8, q_recip += 8) {
+    BL_JPEG_FDCT_FDCT(tmp[0], tmp[1], tmp[2], tmp[3], tmp[4], tmp[5], tmp[6], tmp[7])
+
+    int out[8] = {
+      (r0 + kPass2DcBias) >> BL_JPEG_FDCT_PASS1_BITS,
+      (r1 + kPass2Bias) >> BL_JPEG_FDCT_PASS2_NORM,
+      (r2 + kPass2Bias) >> BL_JPEG_FDCT_PASS2_NORM,
+      (r3 + kPass2Bias) >> BL_JPEG_FDCT_PASS2_NORM,
+      (r4 + kPass2DcBias) >> BL_JPEG_FDCT_PASS1_BITS,
+      (r5 + kPass2Bias) >> BL_JPEG_FDCT_PASS2_NORM,
+      (r6 + kPass2Bias) >> BL_JPEG_FDCT_PASS2_NORM,
+      (r7 + kPass2Bias) >> BL_JPEG_FDCT_PASS2_NORM
+    };
+
+    for (uint32_t j = 0; j < 8; j++)
+      dst[j] = int16_t(Math::nearby_to_int(float(out[j]) * q_recip[j]));
+  }
+}
+
+// bl::Jpeg::Opts - YCbCr8 From RGB32
+// ==================================
+
+void BL_CDECL ycbcr8_from_rgb32(uint8_t* pY, uint8_t* pCb, uint8_t* pCr, const uint8_t* src, uint32_t count) noexcept {
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t pixel = MemOps::readU32a(src);
+
+    int r = int((pixel >> 16) & 0xFFu);
+    int g = int((pixel >>  8) & 0xFFu);
+    int b = int((pixel      ) & 0xFFu);
+
+    int yy = r * BL_JPEG_YCBCR_FIXED(0.29900) + g * BL_JPEG_YCBCR_FIXED(0.58700) + b * BL_JPEG_YCBCR_FIXED(0.11400);
+    int cb = b * BL_JPEG_YCBCR_FIXED(0.50000) - r * BL_JPEG_YCBCR_FIXED(0.16874) - g * BL_JPEG_YCBCR_FIXED(0.33126);
+    int cr = r * BL_JPEG_YCBCR_FIXED(0.50000) - g * BL_JPEG_YCBCR_FIXED(0.41869) - b * BL_JPEG_YCBCR_FIXED(0.08131);
+
+    constexpr int kBias = 1 << (BL_JPEG_YCBCR_PREC - 1);
+    constexpr int kChromaBias = kBias + BL_JPEG_YCBCR_SCALE(128);
+
+    pY[i] = IntOps::clamp_to_byte((yy + kBias) >> BL_JPEG_YCBCR_PREC);
+    pCb[i] = IntOps::clamp_to_byte((cb + kChromaBias) >> BL_JPEG_YCBCR_PREC);
+    pCr[i] = IntOps::clamp_to_byte((cr + kChromaBias) >> BL_JPEG_YCBCR_PREC);
+
+    src += 4;
+  }
+}
+
 // bl::Jpeg::Opts - RGB32 From YCbCr8
 // ==================================
 
@@ -228,4 +489,47 @@ uint8_t* BL_CDECL upsample_generic(uint8_t* dst, uint8_t* src0, uint8_t* src1, u
   return dst;
 }
 
+// bl::Jpeg::Opts - Init
+// =====================
+
+void init_func_opts_ref(FuncOpts& fo) noexcept {
+  fo.idct8 = idct8;
+  fo.idct4 = idct4;
+  fo.idct2 = idct2;
+  fo.idct1 = idct1;
+
+  fo.upsample_1x1 = upsample_1x1;
+  fo.upsample_1x2 = upsample_1x2;
+  fo.upsample_2x1 = upsample_2x1;
+  fo.upsample_2x2 = upsample_2x2;
+  fo.upsample_any = upsample_generic;
+
+  fo.conv_ycbcr8_to_rgb32 = rgb32_from_ycbcr8;
+  fo.fdct8 = fdct8;
+  fo.conv_rgb32_to_ycbcr8 = ycbcr8_from_rgb32;
+}
+
+void init_func_opts(BLRuntimeContext* rt) noexcept {
+  FuncOpts& fo = opts;
+  init_func_opts_ref(fo);
+
+#if defined(BL_BUILD_OPT_SSE2)
+  if (bl_runtime_has_sse2(rt)) {
+    init_func_opts_sse2(fo);
+  }
+#endif // BL_BUILD_OPT_SSE2
+
+#if defined(BL_BUILD_OPT_AVX2)
+  if (bl_runtime_has_avx2(rt)) {
+    init_func_opts_avx2(fo);
+  }
+#endif // BL_BUILD_OPT_AVX2
+
+#if defined(BL_BUILD_OPT_ASIMD)
+  if (bl_runtime_has_asimd(rt)) {
+    init_func_opts_asimd(fo);
+  }
+#endif // BL_BUILD_OPT_ASIMD
+}
+
 } // {bl::Jpeg}
@@ -0,0 +1,19 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#if defined(BL_TARGET_OPT_AVX2)
+
+#include <blend2d/codec/jpegopssimdimpl_p.h>
+
+namespace bl::Jpeg {
+
+void init_func_opts_avx2(FuncOpts& fo) noexcept {
+  init_simd_functions(fo);
+}
+
+} // {bl::Jpeg}
+
+#endif // BL_TARGET_OPT_AVX2
@@ -7,6 +7,7 @@
 #define BLEND2D_CODEC_JPEGOPS_P_H_INCLUDED
 
 #include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/runtime_p.h>
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_codec_impl
@@ -43,6 +44,13 @@ namespace bl::Jpeg {
 #define BL_JPEG_IDCT_ROW_NORM (BL_JPEG_IDCT_PREC + 2 + 3)
 #define BL_JPEG_IDCT_ROW_BIAS (BL_JPEG_IDCT_HALF(BL_JPEG_IDCT_ROW_NORM) + (128 << BL_JPEG_IDCT_ROW_NORM))
 
+// Forward DCT uses the same constants as IDCT, but the first (vertical) pass keeps 2 extra bits of precision,
+// which are then consumed by the second (horizontal) pass. The output is scaled up by 8 (as in jfdctint's
+// `jpeg_fdct_islow`), which is compensated by quantization.
+#define BL_JPEG_FDCT_PASS1_BITS 2
+#define BL_JPEG_FDCT_PASS1_NORM (BL_JPEG_IDCT_PREC - BL_JPEG_FDCT_PASS1_BITS)
+#define BL_JPEG_FDCT_PASS2_NORM (BL_JPEG_IDCT_PREC + BL_JPEG_FDCT_PASS1_BITS)
+
 #define BL_JPEG_YCBCR_PREC 12
 #define BL_JPEG_YCBCR_SCALE(x) ((x) << BL_JPEG_YCBCR_PREC)
 #define BL_JPEG_YCBCR_FIXED(x) int(double(x) * double(1 << BL_JPEG_YCBCR_PREC) + 0.5)
@@ -54,6 +62,12 @@ namespace bl::Jpeg {
 struct FuncOpts {
   //! Dequantize and perform IDCT and store clamped 8-bit results to `dst`.
   void (BL_CDECL* idct8)(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
+  //! Dequantize and perform reduced IDCT that produces 4x4 pixels (decoding downscaled by 2).
+  void (BL_CDECL* idct4)(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
+  //! Dequantize and perform reduced IDCT that produces 2x2 pixels (decoding downscaled by 4).
+  void (BL_CDECL* idct2)(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
+  //! Dequantize DC coefficient and store it as a single pixel (decoding downscaled by 8).
+  void (BL_CDECL* idct1)(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
 
   //! No upsampling (stub).
   uint8_t* (BL_CDECL* upsample_1x1)(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
@@ -68,6 +82,13 @@ struct FuncOpts {
 
   //! Perform planar YCbCr to RGB conversion and pack to XRGB32.
   void (BL_CDECL* conv_ycbcr8_to_rgb32)(uint8_t* dst, const uint8_t* pY, const uint8_t* pCb, const uint8_t* pCr, uint32_t count) noexcept;
+
+  //! Perform FDCT of 8x8 block of 8-bit samples at `src`, quantize it by using `q_recip` (reciprocals of
+  //! quantization table scaled by FDCT output scale) and store the result to `dst` in natural order.
+  void (BL_CDECL* fdct8)(int16_t* dst, const uint8_t* src, intptr_t src_stride, const float* q_recip) noexcept;
+
+  //! Perform XRGB32 to planar YCbCr conversion.
+  void (BL_CDECL* conv_rgb32_to_ycbcr8)(uint8_t* pY, uint8_t* pCb, uint8_t* pCr, const uint8_t* src, uint32_t count) noexcept;
 };
 extern FuncOpts opts;
 
@@ -75,21 +96,39 @@ extern FuncOpts opts;
 // =========================
 
 BL_HIDDEN void BL_CDECL idct8(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
+BL_HIDDEN void BL_CDECL idct4(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
+BL_HIDDEN void BL_CDECL idct2(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
+BL_HIDDEN void BL_CDECL idct1(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
 BL_HIDDEN void BL_CDECL rgb32_from_ycbcr8(uint8_t* dst, const uint8_t* pY, const uint8_t* pCb, const uint8_t* pCr, uint32_t count) noexcept;
 
+BL_HIDDEN void BL_CDECL fdct8(int16_t* dst, const uint8_t* src, intptr_t src_stride, const float* q_recip) noexcept;
+BL_HIDDEN void BL_CDECL ycbcr8_from_rgb32(uint8_t* pY, uint8_t* pCb, uint8_t* pCr, const uint8_t* src, uint32_t count) noexcept;
+
 BL_HIDDEN uint8_t* BL_CDECL upsample_1x1(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
 BL_HIDDEN uint8_t* BL_CDECL upsample_1x2(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
 BL_HIDDEN uint8_t* BL_CDECL upsample_2x1(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
 BL_HIDDEN uint8_t* BL_CDECL upsample_2x2(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
 BL_HIDDEN uint8_t* BL_CDECL upsample_generic(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
 
-// bl::Jpeg::Opts - SSE2
-// ========================
+// bl::Jpeg::Opts - Init
+// =====================
+
+//! Initializes JPEG `opts` to use the best implementation available on the host CPU.
+BL_HIDDEN void init_func_opts(BLRuntimeContext* rt) noexcept;
+//! Initializes `fo` to use reference (portable C++) implementation.
+BL_HIDDEN void init_func_opts_ref(FuncOpts& fo) noexcept;
 
 #ifdef BL_BUILD_OPT_SSE2
-BL_HIDDEN void BL_CDECL idct8_sse2(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept;
-BL_HIDDEN void BL_CDECL rgb32_from_ycbcr8_sse2(uint8_t* dst, const uint8_t* pY, const uint8_t* pCb, const uint8_t* pCr, uint32_t count) noexcept;
-#endif
+BL_HIDDEN void init_func_opts_sse2(FuncOpts& fo) noexcept;
+#endif // BL_BUILD_OPT_SSE2
+
+#ifdef BL_BUILD_OPT_AVX2
+BL_HIDDEN void init_func_opts_avx2(FuncOpts& fo) noexcept;
+#endif // BL_BUILD_OPT_AVX2
+
+#ifdef BL_BUILD_OPT_ASIMD
+BL_HIDDEN void init_func_opts_asimd(FuncOpts& fo) noexcept;
+#endif // BL_BUILD_OPT_ASIMD
 
 } // {bl::Jpeg}
 
@@ -0,0 +1,745 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+// The JPEG codec is based on stb_image <https://github.com/nothings/stb>
+// released into PUBLIC DOMAIN. Blend2D's JPEG codec can be distributed
+// under Blend2D's ZLIB license or under STB's PUBLIC DOMAIN as well.
+
+#ifndef BLEND2D_CODEC_JPEGOPSSIMDIMPL_P_H_INCLUDED
+#define BLEND2D_CODEC_JPEGOPSSIMDIMPL_P_H_INCLUDED
+
+#include <blend2d/codec/jpegops_p.h>
+#include <blend2d/simd/simd_p.h>
+#include <blend2d/support/intops_p.h>
+#include <blend2d/support/memops_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_codec_impl
+//! \{
+
+namespace bl::Jpeg {
+namespace {
+
+// bl::Jpeg::Opts - SimdImpl
+// =========================
+//
+// The implementation is shared by SSE2, AVX2, and ASIMD targets and produces the same results as the reference
+// implementation (all kernels are bit-exact):
+//
+//   - IDCT and FDCT always use 128-bit vectors as a single 8x8 block of 16-bit coefficients fits into 8 registers.
+//
+//   - Color conversion and upsampling process whole rows and use the widest vectors available (JpegVecU8). Wide
+//     vectors operate on 128-bit lanes, so results of lane-wise interleaving are reordered when stored.
+
+#if BL_SIMD_WIDTH_I >= 256
+using JpegVecU8 = SIMD::Vec32xU8;
+using JpegVecU16 = SIMD::Vec16xU16;
+using JpegVecI16 = SIMD::Vec16xI16;
+using JpegVecI32 = SIMD::Vec8xI32;
+#else
+using JpegVecU8 = SIMD::Vec16xU8;
+using JpegVecU16 = SIMD::Vec8xU16;
+using JpegVecI16 = SIMD::Vec8xI16;
+using JpegVecI32 = SIMD::Vec4xI32;
+#endif
+
+template<typename V>
+static BL_INLINE V jpeg_make_u32(uint32_t x) noexcept {
+#if BL_SIMD_WIDTH_I >= 256
+  return SIMD::make256_u32<V>(x);
+#else
+  return SIMD::make128_u32<V>(x);
+#endif
+}
+
+// Packs two 16-bit multipliers into a 32-bit pattern used by `maddw_i16_i32()` - `a` multiplies even elements.
+static BL_INLINE constexpr uint32_t jpeg_i16_pair(int a, int b) noexcept {
+  return uint32_t(uint16_t(int16_t(a))) | (uint32_t(uint16_t(int16_t(b))) << 16);
+}
+
+// Stores `a` and `b` that hold consecutive 16-byte chunks within each 128-bit lane (lane N of `a` is followed by
+// lane N of `b` in memory).
+static BL_INLINE void jpeg_store_lanes_2x(uint8_t* dst, const JpegVecU8& a, const JpegVecU8& b) noexcept {
+  using namespace SIMD;
+
+#if BL_SIMD_WIDTH_I >= 256
+  storeu(dst +  0, permute_i128<2, 0>(a, b));
+  storeu(dst + 32, permute_i128<3, 1>(a, b));
+#else
+  storeu(dst +  0, a);
+  storeu(dst + 16, b);
+#endif
+}
+
+// Stores `a`, `b`, `c`, and `d` that hold consecutive 16-byte chunks within each 128-bit lane.
+static BL_INLINE void jpeg_store_lanes_4x(uint8_t* dst, const JpegVecU8& a, const JpegVecU8& b, const JpegVecU8& c, const JpegVecU8& d) noexcept {
+  using namespace SIMD;
+
+#if BL_SIMD_WIDTH_I >= 256
+  storeu(dst +  0, permute_i128<2, 0>(a, b));
+  storeu(dst + 32, permute_i128<2, 0>(c, d));
+  storeu(dst + 64, permute_i128<3, 1>(a, b));
+  storeu(dst + 96, permute_i128<3, 1>(c, d));
+#else
+  storeu(dst +  0, a);
+  storeu(dst + 16, b);
+  storeu(dst + 32, c);
+  storeu(dst + 48, d);
+#endif
+}
+
+// Returns `x * 3` (16-bit).
+static BL_INLINE JpegVecU16 jpeg_mul3_u16(const JpegVecU16& x) noexcept {
+  using namespace SIMD;
+  return add_i16(slli_i16<1>(x), x);
+}
+
+// bl::Jpeg::Opts - SimdImpl - Constants
+// =====================================
+
+struct alignas(16) OptConstSimd {
+  // IDCT.
+  int16_t idct_rot0a[8], idct_rot0b[8];
+  int16_t idct_rot1a[8], idct_rot1b[8];
+  int16_t idct_rot2a[8], idct_rot2b[8];
+  int16_t idct_rot3a[8], idct_rot3b[8];
+
+  int32_t idct_col_bias[4];
+  int32_t idct_row_bias[4];
+
+  // YCbCr.
+  int16_t ycbcr_tosigned[8];
+
+  // FDCT.
+  int16_t fdct_rot0a[8], fdct_rot0b[8];
+  int16_t fdct_rot1a[8], fdct_rot1b[8];
+  int16_t fdct_rot2a[8], fdct_rot2b[8];
+  int16_t fdct_rot3a[8], fdct_rot3b[8];
+
+  int32_t fdct_pass1_bias[4];
+  int32_t fdct_pass2_bias[4];
+  int16_t fdct_pass2_dc_bias[8];
+
+  // RGB.
+  int32_t rgb_y_round[4];
+  int32_t rgb_c_round[4];
+  int16_t rgb_y_br_mul[8];
+  int16_t rgb_y_ga_mul[8];
+  int16_t rgb_cb_br_mul[8];
+  int16_t rgb_cb_ga_mul[8];
+  int16_t rgb_cr_br_mul[8];
+  int16_t rgb_cr_ga_mul[8];
+};
+
+#define DATA_4X(...) { __VA_ARGS__, __VA_ARGS__, __VA_ARGS__, __VA_ARGS__ }
+static const OptConstSimd opt_const_simd = {
+  // IDCT.
+  DATA_4X(BL_JPEG_IDCT_P_0_541196100                              ,
+          BL_JPEG_IDCT_P_0_541196100 + BL_JPEG_IDCT_M_1_847759065),
+  DATA_4X(BL_JPEG_IDCT_P_0_541196100 + BL_JPEG_IDCT_P_0_765366865 ,
+          BL_JPEG_IDCT_P_0_541196100                             ),
+  DATA_4X(BL_JPEG_IDCT_P_1_175875602 + BL_JPEG_IDCT_M_0_899976223 ,
+          BL_JPEG_IDCT_P_1_175875602                             ),
+  DATA_4X(BL_JPEG_IDCT_P_1_175875602                              ,
+          BL_JPEG_IDCT_P_1_175875602 + BL_JPEG_IDCT_M_2_562915447),
+  DATA_4X(BL_JPEG_IDCT_M_1_961570560 + BL_JPEG_IDCT_P_0_298631336 ,
+          BL_JPEG_IDCT_M_1_961570560                             ),
+  DATA_4X(BL_JPEG_IDCT_M_1_961570560                              ,
+          BL_JPEG_IDCT_M_1_961570560 + BL_JPEG_IDCT_P_3_072711026),
+  DATA_4X(BL_JPEG_IDCT_M_0_390180644 + BL_JPEG_IDCT_P_2_053119869 ,
+          BL_JPEG_IDCT_M_0_390180644                             ),
+  DATA_4X(BL_JPEG_IDCT_M_0_390180644                              ,
+          BL_JPEG_IDCT_M_0_390180644 + BL_JPEG_IDCT_P_1_501321110),
+
+  DATA_4X(BL_JPEG_IDCT_COL_BIAS),
+  DATA_4X(BL_JPEG_IDCT_ROW_BIAS),
+
+  // YCbCr.
+  DATA_4X(-128, -128),
+
+  // FDCT.
+  DATA_4X(BL_JPEG_IDCT_P_0_541196100 + BL_JPEG_IDCT_P_0_765366865 ,
+          BL_JPEG_IDCT_P_0_541196100                             ),
+  DATA_4X(BL_JPEG_IDCT_P_0_541196100                              ,
+          BL_JPEG_IDCT_P_0_541196100 + BL_JPEG_IDCT_M_1_847759065),
+  DATA_4X(BL_JPEG_IDCT_P_1_175875602 + BL_JPEG_IDCT_M_1_961570560 ,
+          BL_JPEG_IDCT_P_1_175875602                             ),
+  DATA_4X(BL_JPEG_IDCT_P_1_175875602                              ,
+          BL_JPEG_IDCT_P_1_175875602 + BL_JPEG_IDCT_M_0_390180644),
+  DATA_4X(BL_JPEG_IDCT_P_0_298631336 + BL_JPEG_IDCT_M_0_899976223 ,
+          BL_JPEG_IDCT_M_0_899976223                             ),
+  DATA_4X(BL_JPEG_IDCT_M_0_899976223                              ,
+          BL_JPEG_IDCT_P_1_501321110 + BL_JPEG_IDCT_M_0_899976223),
+  DATA_4X(BL_JPEG_IDCT_P_2_053119869 + BL_JPEG_IDCT_M_2_562915447 ,
+          BL_JPEG_IDCT_M_2_562915447                             ),
+  DATA_4X(BL_JPEG_IDCT_M_2_562915447                              ,
+          BL_JPEG_IDCT_P_3_072711026 + BL_JPEG_IDCT_M_2_562915447),
+
+  DATA_4X(BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS1_NORM)),
+  DATA_4X(BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS2_NORM)),
+  DATA_4X(BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS1_BITS), BL_JPEG_IDCT_HALF(BL_JPEG_FDCT_PASS1_BITS)),
+
+  // RGB.
+  DATA_4X(1 << (BL_JPEG_YCBCR_PREC - 1)),
+  DATA_4X((1 << (BL_JPEG_YCBCR_PREC - 1)) + BL_JPEG_YCBCR_SCALE(128)),
+  DATA_4X( BL_JPEG_YCBCR_FIXED(0.11400),  BL_JPEG_YCBCR_FIXED(0.29900)),
+  DATA_4X( BL_JPEG_YCBCR_FIXED(0.58700),  0),
+  DATA_4X( BL_JPEG_YCBCR_FIXED(0.50000), -BL_JPEG_YCBCR_FIXED(0.16874)),
+  DATA_4X(-BL_JPEG_YCBCR_FIXED(0.33126),  0),
+  DATA_4X(-BL_JPEG_YCBCR_FIXED(0.08131),  BL_JPEG_YCBCR_FIXED(0.50000)),
+  DATA_4X(-BL_JPEG_YCBCR_FIXED(0.41869),  0)
+};
+#undef DATA_4X
+
+// bl::Jpeg::Opts - SimdImpl - IDCT
+// ================================
+
+#define BL_JPEG_IDCT_INTERLEAVE8_XMM(a, b) { auto t = a; a = interleave_lo_u8(a, b); b = interleave_hi_u8(t, b); }
+#define BL_JPEG_IDCT_INTERLEAVE16_XMM(a, b) { auto t = a; a = interleave_lo_u16(a, b); b = interleave_hi_u16(t, b); }
+
+// out(0) = c0[even]*x + c0[odd]*y (in 16-bit, out 32-bit).
+// out(1) = c1[even]*x + c1[odd]*y (in 16-bit, out 32-bit).
+#define BL_JPEG_IDCT_ROTATE_XMM(dst0, dst1, x, y, c0, c1)               \
+  VecPair<Vec4xI32> dst0;                                               \
+  VecPair<Vec4xI32> dst1;                                               \
+                                                                        \
+  {                                                                     \
+    VecPair<Vec4xI32> tmp;                                              \
+                                                                        \
+    tmp[0] = vec_i32(interleave_lo_u16(x, y));                          \
+    tmp[1] = vec_i32(interleave_hi_u16(x, y));                          \
+    dst0[0] = maddw_i16_i32(tmp[0], vec_const<Vec4xI32>(constants.c0)); \
+    dst0[1] = maddw_i16_i32(tmp[1], vec_const<Vec4xI32>(constants.c0)); \
+    dst1[0] = maddw_i16_i32(tmp[0], vec_const<Vec4xI32>(constants.c1)); \
+    dst1[1] = maddw_i16_i32(tmp[1], vec_const<Vec4xI32>(constants.c1)); \
+  }
+
+// out = in << 12 (in 16-bit, out 32-bit)
+#define BL_JPEG_IDCT_WIDEN_XMM(dst, in)                                        \
+  VecPair<Vec4xI32> dst;                                                       \
+  dst[0] = srai_i32<4>(vec_i32(interleave_lo_u16(make_zero<Vec8xI16>(), in))); \
+  dst[1] = srai_i32<4>(vec_i32(interleave_hi_u16(make_zero<Vec8xI16>(), in)));
+
+// Wide add (32-bit).
+#define BL_JPEG_IDCT_WADD_XMM(dst, a, b) \
+  VecPair<Vec4xI32> dst{add_i32(a[0], b[0]), add_i32(a[1], b[1])};
+
+// Wide sub (32-bit).
+#define BL_JPEG_IDCT_WSUB_XMM(dst, a, b) \
+  VecPair<Vec4xI32> dst{sub_i32(a[0], b[0]), sub_i32(a[1], b[1])};
+
+// Butterfly a/b, add bias, then shift by `norm` and pack to 16-bit.
+#define BL_JPEG_IDCT_BFLY_XMM(dst0, dst1, a, b, bias, norm)                              \
+  {                                                                                      \
+    VecPair<Vec4xI32> a_biased{add_i32(a[0], bias), add_i32(a[1], bias)};                \
+    BL_JPEG_IDCT_WADD_XMM(sum, a_biased, b)                                              \
+    BL_JPEG_IDCT_WSUB_XMM(diff, a_biased, b)                                             \
+                                                                                         \
+    dst0 = vec_i16(packs_128_i32_i16(srai_i32<norm>(sum[0]), srai_i32<norm>(sum[1])));   \
+    dst1 = vec_i16(packs_128_i32_i16(srai_i32<norm>(diff[0]), srai_i32<norm>(diff[1]))); \
+  }
+
+#define BL_JPEG_IDCT_IDCT_PASS_XMM(bias, norm) {                         \
+  /* Even part. */                                                       \
+  BL_JPEG_IDCT_ROTATE_XMM(t2e, t3e, row2, row6, idct_rot0a, idct_rot0b)  \
+                                                                         \
+  Vec8xI16 sum04 = add_i16(row0, row4);                                  \
+  Vec8xI16 dif04 = sub_i16(row0, row4);                                  \
+                                                                         \
+  BL_JPEG_IDCT_WIDEN_XMM(t0e, sum04)                                     \
+  BL_JPEG_IDCT_WIDEN_XMM(t1e, dif04)                                     \
+                                                                         \
+  BL_JPEG_IDCT_WADD_XMM(x0, t0e, t3e)                                    \
+  BL_JPEG_IDCT_WSUB_XMM(x3, t0e, t3e)                                    \
+  BL_JPEG_IDCT_WADD_XMM(x1, t1e, t2e)                                    \
+  BL_JPEG_IDCT_WSUB_XMM(x2, t1e, t2e)                                    \
+                                                                         \
+  /* Odd part */                                                         \
+  BL_JPEG_IDCT_ROTATE_XMM(y0o, y2o, row7, row3, idct_rot2a, idct_rot2b)  \
+  BL_JPEG_IDCT_ROTATE_XMM(y1o, y3o, row5, row1, idct_rot3a, idct_rot3b)  \
+  Vec8xI16 sum17 = add_i16(row1, row7);                                  \
+  Vec8xI16 sum35 = add_i16(row3, row5);                                  \
+  BL_JPEG_IDCT_ROTATE_XMM(y4o,y5o, sum17, sum35, idct_rot1a, idct_rot1b) \
+                                                                         \
+  BL_JPEG_IDCT_WADD_XMM(x4, y0o, y4o)                                    \
+  BL_JPEG_IDCT_WADD_XMM(x5, y1o, y5o)                                    \
+  BL_JPEG_IDCT_WADD_XMM(x6, y2o, y5o)                                    \
+  BL_JPEG_IDCT_WADD_XMM(x7, y3o, y4o)                                    \
+                                                                         \
+  BL_JPEG_IDCT_BFLY_XMM(row0, row7, x0, x7, bias, norm)                  \
+  BL_JPEG_IDCT_BFLY_XMM(row1, row6, x1, x6, bias, norm)                  \
+  BL_JPEG_IDCT_BFLY_XMM(row2, row5, x2, x5, bias, norm)                  \
+  BL_JPEG_IDCT_BFLY_XMM(row3, row4, x3, x4, bias, norm)                  \
+}
+
+static void BL_CDECL idct8_simd(uint8_t* dst, intptr_t dst_stride, const int16_t* src, const uint16_t* q_table) noexcept {
+  using namespace SIMD;
+
+  const OptConstSimd& constants = opt_const_simd;
+
+  // Load and dequantize (`src` is aligned to 16 bytes, `q_table` doesn't have to be).
+  Vec8xI16 row0 = mul_i16(loadu<Vec8xI16>(q_table +  0), loada<Vec8xI16>(src +  0));
+  Vec8xI16 row1 = mul_i16(loadu<Vec8xI16>(q_table +  8), loada<Vec8xI16>(src +  8));
+  Vec8xI16 row2 = mul_i16(loadu<Vec8xI16>(q_table + 16), loada<Vec8xI16>(src + 16));
+  Vec8xI16 row3 = mul_i16(loadu<Vec8xI16>(q_table + 24), loada<Vec8xI16>(src + 24));
+  Vec8xI16 row4 = mul_i16(loadu<Vec8xI16>(q_table + 32), loada<Vec8xI16>(src + 32));
+  Vec8xI16 row5 = mul_i16(loadu<Vec8xI16>(q_table + 40), loada<Vec8xI16>(src + 40));
+  Vec8xI16 row6 = mul_i16(loadu<Vec8xI16>(q_table + 48), loada<Vec8xI16>(src + 48));
+  Vec8xI16 row7 = mul_i16(loadu<Vec8xI16>(q_table + 56), loada<Vec8xI16>(src + 56));
+
+  // IDCT columns.
+  BL_JPEG_IDCT_IDCT_PASS_XMM(vec_const<Vec4xI32>(constants.idct_col_bias), BL_JPEG_IDCT_COL_NORM)
+
+  // Transpose.
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row0, row4) // [a0a4|b0b4|c0c4|d0d4] | [e0e4|f0f4|g0g4|h0h4]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row2, row6) // [a2a6|b2b6|c2c6|d2d6] | [e2e6|f2f6|g2g6|h2h6]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row1, row5) // [a1a5|b1b5|c2c5|d1d5] | [e1e5|f1f5|g1g5|h1h5]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row3, row7) // [a3a7|b3b7|c3c7|d3d7] | [e3e7|f3f7|g3g7|h3h7]
+
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row0, row2) // [a0a2|a4a6|b0b2|b4b6] | [c0c2|c4c6|d0d2|d4d6]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row1, row3) // [a1a3|a5a7|b1b3|b5b7] | [c1c3|c5c7|d1d3|d5d7]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row4, row6) // [e0e2|e4e6|f0f2|f4f6] | [g0g2|g4g6|h0h2|h4h6]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row5, row7) // [e1e3|e5e7|f1f3|f5f7] | [g1g3|g5g7|h1h3|h5h7]
+
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row0, row1) // [a0a1|a2a3|a4a5|a6a7] | [b0b1|b2b3|b4b5|b6b7]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row2, row3) // [c0c1|c2c3|c4c5|c6c7] | [d0d1|d2d3|d4d5|d6d7]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row4, row5) // [e0e1|e2e3|e4e5|e6e7] | [f0f1|f2f3|f4f5|f6f7]
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row6, row7) // [g0g1|g2g3|g4g5|g6g7] | [h0h1|h2h3|h4h5|h6h7]
+
+  // IDCT rows.
+  BL_JPEG_IDCT_IDCT_PASS_XMM(vec_const<Vec4xI32>(constants.idct_row_bias), BL_JPEG_IDCT_ROW_NORM)
+
+  // Pack to 8-bit unsigned integers with saturation.
+  row0 = packs_128_i16_u8(row0, row1);      // [a0a1a2a3|a4a5a6a7|b0b1b2b3|b4b5b6b7]
+  row2 = packs_128_i16_u8(row2, row3);      // [c0c1c2c3|c4c5c6c7|d0d1d2d3|d4d5d6d7]
+  row4 = packs_128_i16_u8(row4, row5);      // [e0e1e2e3|e4e5e6e7|f0f1f2f3|f4f5f6f7]
+  row6 = packs_128_i16_u8(row6, row7);      // [g0g1g2g3|g4g5g6g7|h0h1h2h3|h4h5h6h7]
+
+  // Transpose.
+  BL_JPEG_IDCT_INTERLEAVE8_XMM(row0, row4)  // [a0e0a1e1|a2e2a3e3|a4e4a5e5|a6e6a7e7] | [b0f0b1f1|b2f2b3f3|b4f4b5f5|b6f6b7f7]
+  BL_JPEG_IDCT_INTERLEAVE8_XMM(row2, row6)  // [c0g0c1g1|c2g2c3g3|c4g4c5g5|c6g6c7g7] | [d0h0d1h1|d2h2d3h3|d4h4d5h5|d6h6d7h7]
+  BL_JPEG_IDCT_INTERLEAVE8_XMM(row0, row2)  // [a0c0e0g0|a1c1e1g1|a2c2e2g2|a3c3e3g3] | [a4c4e4g4|a5c5e5g5|a6c6e6g6|a7c7e7g7]
+  BL_JPEG_IDCT_INTERLEAVE8_XMM(row4, row6)  // [b0d0f0h0|b1d1f1h1|b2d2f2h2|b3d3f3h3| | [b4d4f4h4|b5d5f5h5|b6d6f6h6|b7d7f7h7]
+  BL_JPEG_IDCT_INTERLEAVE8_XMM(row0, row4)  // [a0b0c0d0|e0f0g0h0|a1b1c1d1|e1f1g1h1] | [a2b2c2d2|e2f2g2h2|a3b3c3d3|e3f3g3h3]
+  BL_JPEG_IDCT_INTERLEAVE8_XMM(row2, row6)  // [a4b4c4d4|e4f4g4h4|a5b5c5d5|e5f5g5h5] | [a6b6c6d6|e6f6g6h6|a7b7c7d7|e7f7g7h7]
+
+  // Store.
+  uint8_t* dst0 = dst;
+  uint8_t* dst1 = dst + dst_stride;
+  intptr_t dstStride2 = dst_stride * 2;
+
+  storeu_64(dst0, row0); dst0 += dstStride2;
+  storeh_64(dst1, row0); dst1 += dstStride2;
+
+  storeu_64(dst0, row4); dst0 += dstStride2;
+  storeh_64(dst1, row4); dst1 += dstStride2;
+
+  storeu_64(dst0, row2); dst0 += dstStride2;
+  storeh_64(dst1, row2); dst1 += dstStride2;
+
+  storeu_64(dst0, row6);
+  storeh_64(dst1, row6);
+}
+
+// bl::Jpeg::Opts - SimdImpl - FDCT
+// ================================
+
+// Transposes 8x8 matrix of 16-bit elements stored in `row0..row7`.
+#define BL_JPEG_FDCT_TRANSPOSE_XMM()            \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row0, row4)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row2, row6)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row1, row5)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row3, row7)     \
+                                                \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row0, row2)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row1, row3)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row4, row6)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row5, row7)     \
+                                                \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row0, row1)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row2, row3)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row4, row5)     \
+  BL_JPEG_IDCT_INTERLEAVE16_XMM(row6, row7)
+
+// Add bias, then shift by `norm` and pack to 16-bit.
+#define BL_JPEG_FDCT_DESCALE_XMM(dst, a, bias, norm) \
+  dst = vec_i16(packs_128_i32_i16(srai_i32<norm>(add_i32(a[0], bias)), srai_i32<norm>(add_i32(a[1], bias))));
+
+// The DC terms of the first pass are only scaled up, the DC terms of the second pass only scaled down. The sum of
+// the second pass is always within [-32768, 32512] range, so it's safe to keep it 16-bit.
+#define BL_JPEG_FDCT_DC_PASS1_XMM(x) slli_i16<BL_JPEG_FDCT_PASS1_BITS>(x)
+#define BL_JPEG_FDCT_DC_PASS2_XMM(x) srai_i16<BL_JPEG_FDCT_PASS1_BITS>(add_i16(x, vec_const<Vec8xI16>(constants.fdct_pass2_dc_bias)))
+
+#define BL_JPEG_FDCT_FDCT_PASS_XMM(bias, norm, dc_op) {                    \
+  Vec8xI16 t0 = add_i16(row0, row7);                                      \
+  Vec8xI16 t7 = sub_i16(row0, row7);                                      \
+  Vec8xI16 t1 = add_i16(row1, row6);                                      \
+  Vec8xI16 t6 = sub_i16(row1, row6);                                      \
+  Vec8xI16 t2 = add_i16(row2, row5);                                      \
+  Vec8xI16 t5 = sub_i16(row2, row5);                                      \
+  Vec8xI16 t3 = add_i16(row3, row4);                                      \
+  Vec8xI16 t4 = sub_i16(row3, row4);                                      \
+                                                                          \
+  /* Even part. */                                                        \
+  Vec8xI16 t10 = add_i16(t0, t3);                                         \
+  Vec8xI16 t13 = sub_i16(t0, t3);                                         \
+  Vec8xI16 t11 = add_i16(t1, t2);                                         \
+  Vec8xI16 t12 = sub_i16(t1, t2);                                         \
+                                                                          \
+  row0 = dc_op(add_i16(t10, t11));                                        \
+  row4 = dc_op(sub_i16(t10, t11));                                        \
+                                                                          \
+  BL_JPEG_IDCT_ROTATE_XMM(r2, r6, t13, t12, fdct_rot0a, fdct_rot0b)       \
+  BL_JPEG_FDCT_DESCALE_XMM(row2, r2, bias, norm)                          \
+  BL_JPEG_FDCT_DESCALE_XMM(row6, r6, bias, norm)                          \
+                                                                          \
+  /* Odd part. */                                                         \
+  Vec8xI16 z3 = add_i16(t4, t6);                                          \
+  Vec8xI16 z4 = add_i16(t5, t7);                                          \
+                                                                          \
+  BL_JPEG_IDCT_ROTATE_XMM(z3r, z4r, z3, z4, fdct_rot1a, fdct_rot1b)       \
+  BL_JPEG_IDCT_ROTATE_XMM(r7a, r1a, t4, t7, fdct_rot2a, fdct_rot2b)       \
+  BL_JPEG_IDCT_ROTATE_XMM(r5a, r3a, t5, t6, fdct_rot3a, fdct_rot3b)       \
+                                                                          \
+  BL_JPEG_IDCT_WADD_XMM(r1, r1a, z4r)                                     \
+  BL_JPEG_IDCT_WADD_XMM(r3, r3a, z3r)                                     \
+  BL_JPEG_IDCT_WADD_XMM(r5, r5a, z4r)                                     \
+  BL_JPEG_IDCT_WADD_XMM(r7, r7a, z3r)                                     \
+                                                                          \
+  BL_JPEG_FDCT_DESCALE_XMM(row1, r1, bias, norm)                          \
+  BL_JPEG_FDCT_DESCALE_XMM(row3, r3, bias, norm)                          \
+  BL_JPEG_FDCT_DESCALE_XMM(row5, r5, bias, norm)                          \
+  BL_JPEG_FDCT_DESCALE_XMM(row7, r7, bias, norm)                          \
+}
+
+// Quantize a row of coefficients by multiplying them by reciprocals (rounding to nearest even) and store them.
+#define BL_JPEG_FDCT_QUANTIZE_XMM(row, index) {                                                                    \
+  Vec4xF32 q0 = mul_f32(cvt_i32_f32(vec_i32(unpack_lo64_i16_i32(row))), loadu<Vec4xF32>(q_recip + index * 8 + 0)); \
+  Vec4xF32 q1 = mul_f32(cvt_i32_f32(vec_i32(unpack_hi64_i16_i32(row))), loadu<Vec4xF32>(q_recip + index * 8 + 4)); \
+  storea(dst + index * 8, packs_128_i32_i16(cvt_f32_i32(q0), cvt_f32_i32(q1)));                                     \
+}
+
+static void BL_CDECL fdct8_simd(int16_t* dst, const uint8_t* src, intptr_t src_stride, const float* q_recip) noexcept {
+  using namespace SIMD;
+
+  const OptConstSimd& constants = opt_const_simd;
+
+  // Load and convert samples from `0..255` to `-128..127` range.
+  Vec8xI16 tosigned = vec_const<Vec8xI16>(constants.ycbcr_tosigned);
+  Vec8xI16 row0 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 0 * src_stride)), tosigned);
+  Vec8xI16 row1 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 1 * src_stride)), tosigned);
+  Vec8xI16 row2 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 2 * src_stride)), tosigned);
+  Vec8xI16 row3 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 3 * src_stride)), tosigned);
+  Vec8xI16 row4 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 4 * src_stride)), tosigned);
+  Vec8xI16 row5 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 5 * src_stride)), tosigned);
+  Vec8xI16 row6 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 6 * src_stride)), tosigned);
+  Vec8xI16 row7 = add_i16(unpack_lo64_u8_u16(loadu_64<Vec8xI16>(src + 7 * src_stride)), tosigned);
+
+  // FDCT columns.
+  BL_JPEG_FDCT_FDCT_PASS_XMM(vec_const<Vec4xI32>(constants.fdct_pass1_bias), BL_JPEG_FDCT_PASS1_NORM, BL_JPEG_FDCT_DC_PASS1_XMM)
+
+  // FDCT rows.
+  BL_JPEG_FDCT_TRANSPOSE_XMM()
+  BL_JPEG_FDCT_FDCT_PASS_XMM(vec_const<Vec4xI32>(constants.fdct_pass2_bias), BL_JPEG_FDCT_PASS2_NORM, BL_JPEG_FDCT_DC_PASS2_XMM)
+  BL_JPEG_FDCT_TRANSPOSE_XMM()
+
+  // Quantize and store (`dst` is aligned to 16 bytes, `q_recip` doesn't have to be).
+  BL_JPEG_FDCT_QUANTIZE_XMM(row0, 0)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row1, 1)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row2, 2)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row3, 3)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row4, 4)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row5, 5)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row6, 6)
+  BL_JPEG_FDCT_QUANTIZE_XMM(row7, 7)
+}
+
+// bl::Jpeg::Opts - SimdImpl - YCbCr8 From RGB32
+// =============================================
+
+static void BL_CDECL ycbcr8_from_rgb32_simd(uint8_t* pY, uint8_t* pCb, uint8_t* pCr, const uint8_t* src, uint32_t count) noexcept {
+  using namespace SIMD;
+  uint32_t i = count;
+
+  const OptConstSimd& constants = opt_const_simd;
+  Vec4xI32 br_mask = make128_u32<Vec4xI32>(0x00FF00FFu);
+
+  while (i >= 8) {
+    Vec4xI32 p0 = loadu<Vec4xI32>(src +  0);
+    Vec4xI32 p1 = loadu<Vec4xI32>(src + 16);
+
+    // Each pixel is represented by [B, R] and [G, A] pairs of 16-bit values, which are then multiplied and
+    // horizontally added by `maddw_i16_i32`. Multipliers of A are always zero.
+    Vec4xI32 br0 = and_(p0, br_mask);
+    Vec4xI32 br1 = and_(p1, br_mask);
+    Vec4xI32 ga0 = srli_u16<8>(p0);
+    Vec4xI32 ga1 = srli_u16<8>(p1);
+
+    Vec4xI32 y0 = add_i32(maddw_i16_i32(br0, vec_const<Vec4xI32>(constants.rgb_y_br_mul)), maddw_i16_i32(ga0, vec_const<Vec4xI32>(constants.rgb_y_ga_mul)));
+    Vec4xI32 y1 = add_i32(maddw_i16_i32(br1, vec_const<Vec4xI32>(constants.rgb_y_br_mul)), maddw_i16_i32(ga1, vec_const<Vec4xI32>(constants.rgb_y_ga_mul)));
+    Vec4xI32 cb0 = add_i32(maddw_i16_i32(br0, vec_const<Vec4xI32>(constants.rgb_cb_br_mul)), maddw_i16_i32(ga0, vec_const<Vec4xI32>(constants.rgb_cb_ga_mul)));
+    Vec4xI32 cb1 = add_i32(maddw_i16_i32(br1, vec_const<Vec4xI32>(constants.rgb_cb_br_mul)), maddw_i16_i32(ga1, vec_const<Vec4xI32>(constants.rgb_cb_ga_mul)));
+    Vec4xI32 cr0 = add_i32(maddw_i16_i32(br0, vec_const<Vec4xI32>(constants.rgb_cr_br_mul)), maddw_i16_i32(ga0, vec_const<Vec4xI32>(constants.rgb_cr_ga_mul)));
+    Vec4xI32 cr1 = add_i32(maddw_i16_i32(br1, vec_const<Vec4xI32>(constants.rgb_cr_br_mul)), maddw_i16_i32(ga1, vec_const<Vec4xI32>(constants.rgb_cr_ga_mul)));
+
+    y0 = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(y0, vec_const<Vec4xI32>(constants.rgb_y_round)));
+    y1 = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(y1, vec_const<Vec4xI32>(constants.rgb_y_round)));
+    cb0 = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(cb0, vec_const<Vec4xI32>(constants.rgb_c_round)));
+    cb1 = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(cb1, vec_const<Vec4xI32>(constants.rgb_c_round)));
+    cr0 = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(cr0, vec_const<Vec4xI32>(constants.rgb_c_round)));
+    cr1 = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(cr1, vec_const<Vec4xI32>(constants.rgb_c_round)));
+
+    storeu_64(pY, packs_128_i16_u8(packs_128_i32_i16(y0, y1)));
+    storeu_64(pCb, packs_128_i16_u8(packs_128_i32_i16(cb0, cb1)));
+    storeu_64(pCr, packs_128_i16_u8(packs_128_i32_i16(cr0, cr1)));
+
+    src += 32;
+    pY  += 8;
+    pCb += 8;
+    pCr += 8;
+    i   -= 8;
+  }
+
+  if (i)
+    ycbcr8_from_rgb32(pY, pCb, pCr, src, i);
+}
+
+// bl::Jpeg::Opts - SimdImpl - RGB32 From YCbCr8
+// =============================================
+
+// Converts 16-bit Y, Cb, and Cr values to 16-bit R, G, and B values (not clamped yet).
+static BL_INLINE void rgb16_from_ycbcr16(JpegVecI16& r, JpegVecI16& g, JpegVecI16& b, const JpegVecI16& yy, const JpegVecI16& cb_u, const JpegVecI16& cr_u) noexcept {
+  using namespace SIMD;
+
+  JpegVecI16 tosigned = jpeg_make_u32<JpegVecI16>(jpeg_i16_pair(-128, -128));
+  JpegVecI16 yycr_mul = jpeg_make_u32<JpegVecI16>(jpeg_i16_pair(BL_JPEG_YCBCR_FIXED(1.00000), BL_JPEG_YCBCR_FIXED(1.40200)));
+  JpegVecI16 yycb_mul = jpeg_make_u32<JpegVecI16>(jpeg_i16_pair(BL_JPEG_YCBCR_FIXED(1.00000), BL_JPEG_YCBCR_FIXED(1.77200)));
+  JpegVecI16 cbcr_mul = jpeg_make_u32<JpegVecI16>(jpeg_i16_pair(-BL_JPEG_YCBCR_FIXED(0.34414), -BL_JPEG_YCBCR_FIXED(0.71414)));
+  JpegVecI32 round = jpeg_make_u32<JpegVecI32>(1u << (BL_JPEG_YCBCR_PREC - 1));
+
+  JpegVecI16 cb = add_i16(cb_u, tosigned);
+  JpegVecI16 cr = add_i16(cr_u, tosigned);
+
+  JpegVecI32 r_l = vec_i32(maddw_i16_i32(interleave_lo_u16(yy, cr), yycr_mul));
+  JpegVecI32 r_h = vec_i32(maddw_i16_i32(interleave_hi_u16(yy, cr), yycr_mul));
+  JpegVecI32 b_l = vec_i32(maddw_i16_i32(interleave_lo_u16(yy, cb), yycb_mul));
+  JpegVecI32 b_h = vec_i32(maddw_i16_i32(interleave_hi_u16(yy, cb), yycb_mul));
+  JpegVecI32 g_l = vec_i32(maddw_i16_i32(interleave_lo_u16(cb, cr), cbcr_mul));
+  JpegVecI32 g_h = vec_i32(maddw_i16_i32(interleave_hi_u16(cb, cr), cbcr_mul));
+
+  g_l = add_i32(g_l, slli_i32<BL_JPEG_YCBCR_PREC>(vec_i32(unpack_lo64_u16_u32(yy))));
+  g_h = add_i32(g_h, slli_i32<BL_JPEG_YCBCR_PREC>(vec_i32(unpack_hi64_u16_u32(yy))));
+
+  r_l = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(r_l, round));
+  r_h = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(r_h, round));
+  g_l = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(g_l, round));
+  g_h = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(g_h, round));
+  b_l = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(b_l, round));
+  b_h = srai_i32<BL_JPEG_YCBCR_PREC>(add_i32(b_h, round));
+
+  r = vec_i16(packs_128_i32_i16(r_l, r_h));
+  g = vec_i16(packs_128_i32_i16(g_l, g_h));
+  b = vec_i16(packs_128_i32_i16(b_l, b_h));
+}
+
+static void BL_CDECL rgb32_from_ycbcr8_simd(uint8_t* dst, const uint8_t* pY, const uint8_t* pCb, const uint8_t* pCr, uint32_t count) noexcept {
+  using namespace SIMD;
+
+  constexpr uint32_t kN = uint32_t(JpegVecU8::kW);
+
+  uint32_t i = count;
+  JpegVecU8 alpha = jpeg_make_u32<JpegVecU8>(0xFFFFFFFFu);
+
+  while (i >= kN) {
+    JpegVecU8 yy = loadu<JpegVecU8>(pY);
+    JpegVecU8 cb = loadu<JpegVecU8>(pCb);
+    JpegVecU8 cr = loadu<JpegVecU8>(pCr);
+
+    JpegVecI16 r0, g0, b0;
+    JpegVecI16 r1, g1, b1;
+
+    rgb16_from_ycbcr16(r0, g0, b0, vec_i16(unpack_lo64_u8_u16(yy)), vec_i16(unpack_lo64_u8_u16(cb)), vec_i16(unpack_lo64_u8_u16(cr)));
+    rgb16_from_ycbcr16(r1, g1, b1, vec_i16(unpack_hi64_u8_u16(yy)), vec_i16(unpack_hi64_u8_u16(cb)), vec_i16(unpack_hi64_u8_u16(cr)));
+
+    // Saturating packs clamp the results to [0, 255] range.
+    JpegVecU8 r = vec_u8(packs_128_i16_u8(r0, r1));
+    JpegVecU8 g = vec_u8(packs_128_i16_u8(g0, g1));
+    JpegVecU8 b = vec_u8(packs_128_i16_u8(b0, b1));
+
+    JpegVecU8 bg0 = interleave_lo_u8(b, g);
+    JpegVecU8 bg1 = interleave_hi_u8(b, g);
+    JpegVecU8 ra0 = interleave_lo_u8(r, alpha);
+    JpegVecU8 ra1 = interleave_hi_u8(r, alpha);
+
+    jpeg_store_lanes_4x(dst, interleave_lo_u16(bg0, ra0), interleave_hi_u16(bg0, ra0),
+                             interleave_lo_u16(bg1, ra1), interleave_hi_u16(bg1, ra1));
+
+    dst += kN * 4u;
+    pY  += kN;
+    pCb += kN;
+    pCr += kN;
+    i   -= kN;
+  }
+
+  if (i)
+    rgb32_from_ycbcr8(dst, pY, pCb, pCr, i);
+}
+
+// bl::Jpeg::Opts - SimdImpl - Upsample
+// ====================================
+//
+// Upsampling uses 16-bit intermediates, which cannot overflow - the highest value is `16 * 255 + 8` in 2x2 case.
+
+static uint8_t* BL_CDECL upsample_1x2_simd(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept {
+  using namespace SIMD;
+  bl_unused(hs);
+
+  constexpr uint32_t kN = uint32_t(JpegVecU8::kW);
+
+  uint32_t i = 0;
+  JpegVecU16 bias = jpeg_make_u32<JpegVecU16>(0x00020002u);
+
+  while (w - i >= kN) {
+    JpegVecU8 a = loadu<JpegVecU8>(src0 + i);
+    JpegVecU8 b = loadu<JpegVecU8>(src1 + i);
+
+    JpegVecU16 lo = srli_u16<2>(add_i16(jpeg_mul3_u16(vec_u16(unpack_lo64_u8_u16(a))), add_i16(vec_u16(unpack_lo64_u8_u16(b)), bias)));
+    JpegVecU16 hi = srli_u16<2>(add_i16(jpeg_mul3_u16(vec_u16(unpack_hi64_u8_u16(a))), add_i16(vec_u16(unpack_hi64_u8_u16(b)), bias)));
+
+    storeu(dst + i, vec_u8(packs_128_i16_u8(vec_i16(lo), vec_i16(hi))));
+    i += kN;
+  }
+
+  for (; i < w; i++)
+    dst[i] = uint8_t((3 * src0[i] + src1[i] + 2) >> 2);
+
+  return dst;
+}
+
+static uint8_t* BL_CDECL upsample_2x1_simd(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept {
+  using namespace SIMD;
+  bl_unused(src1, hs);
+
+  constexpr uint32_t kN = uint32_t(JpegVecU8::kW);
+
+  // If only one sample, can't do any interpolation.
+  if (w == 1) {
+    dst[0] = dst[1] = src0[0];
+    return dst;
+  }
+
+  dst[0] = src0[0];
+  dst[1] = uint8_t((src0[0] * 3 + src0[1] + 2) >> 2);
+
+  uint32_t i = 1;
+  JpegVecU16 bias = jpeg_make_u32<JpegVecU16>(0x00020002u);
+
+  // Each iteration reads samples `[i - 1, i + kN]`, which must not go past the last sample at `w - 1`.
+  while (w - 1u - i >= kN) {
+    JpegVecU8 prev = loadu<JpegVecU8>(src0 + i - 1);
+    JpegVecU8 curr = loadu<JpegVecU8>(src0 + i);
+    JpegVecU8 next = loadu<JpegVecU8>(src0 + i + 1);
+
+    JpegVecU16 n0 = add_i16(jpeg_mul3_u16(vec_u16(unpack_lo64_u8_u16(curr))), bias);
+    JpegVecU16 n1 = add_i16(jpeg_mul3_u16(vec_u16(unpack_hi64_u8_u16(curr))), bias);
+
+    JpegVecU16 e0 = srli_u16<2>(add_i16(n0, vec_u16(unpack_lo64_u8_u16(prev))));
+    JpegVecU16 e1 = srli_u16<2>(add_i16(n1, vec_u16(unpack_hi64_u8_u16(prev))));
+    JpegVecU16 o0 = srli_u16<2>(add_i16(n0, vec_u16(unpack_lo64_u8_u16(next))));
+    JpegVecU16 o1 = srli_u16<2>(add_i16(n1, vec_u16(unpack_hi64_u8_u16(next))));
+
+    // Interleaves even (low byte) and odd (high byte) samples.
+    jpeg_store_lanes_2x(dst + i * 2u, vec_u8(or_(e0, slli_i16<8>(o0))), vec_u8(or_(e1, slli_i16<8>(o1))));
+    i += kN;
+  }
+
+  for (; i < w - 1; i++) {
+    uint32_t n = 3 * src0[i] + 2;
+    dst[i * 2 + 0] = uint8_t((n + src0[i - 1]) >> 2);
+    dst[i * 2 + 1] = uint8_t((n + src0[i + 1]) >> 2);
+  }
+
+  dst[i * 2 + 0] = uint8_t((src0[w - 2] * 3 + src0[w - 1] + 2) >> 2);
+  dst[i * 2 + 1] = src0[w - 1];
+
+  return dst;
+}
+
+static uint8_t* BL_CDECL upsample_2x2_simd(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept {
+  using namespace SIMD;
+  bl_unused(hs);
+
+  constexpr uint32_t kN = uint32_t(JpegVecU8::kW);
+
+  if (w == 1) {
+    dst[0] = dst[1] = uint8_t((3 * src0[0] + src1[0] + 2) >> 2);
+    return dst;
+  }
+
+  dst[0] = uint8_t((3 * src0[0] + src1[0] + 2) >> 2);
+
+  uint32_t i = 1;
+  JpegVecU16 bias = jpeg_make_u32<JpegVecU16>(0x00080008u);
+
+  // Each iteration reads samples `[i - 1, i + kN - 1]` and produces output pixels `[i * 2 - 1, i * 2 + kN * 2 - 1)`.
+  while (w - i >= kN) {
+    JpegVecU8 a_prev = loadu<JpegVecU8>(src0 + i - 1);
+    JpegVecU8 a_curr = loadu<JpegVecU8>(src0 + i);
+    JpegVecU8 b_prev = loadu<JpegVecU8>(src1 + i - 1);
+    JpegVecU8 b_curr = loadu<JpegVecU8>(src1 + i);
+
+    // Vertically interpolated samples: `t = 3 * src0 + src1`.
+    JpegVecU16 tp0 = add_i16(jpeg_mul3_u16(vec_u16(unpack_lo64_u8_u16(a_prev))), vec_u16(unpack_lo64_u8_u16(b_prev)));
+    JpegVecU16 tp1 = add_i16(jpeg_mul3_u16(vec_u16(unpack_hi64_u8_u16(a_prev))), vec_u16(unpack_hi64_u8_u16(b_prev)));
+    JpegVecU16 tc0 = add_i16(jpeg_mul3_u16(vec_u16(unpack_lo64_u8_u16(a_curr))), vec_u16(unpack_lo64_u8_u16(b_curr)));
+    JpegVecU16 tc1 = add_i16(jpeg_mul3_u16(vec_u16(unpack_hi64_u8_u16(a_curr))), vec_u16(unpack_hi64_u8_u16(b_curr)));
+
+    JpegVecU16 o0 = srli_u16<4>(add_i16(add_i16(jpeg_mul3_u16(tp0), tc0), bias));
+    JpegVecU16 o1 = srli_u16<4>(add_i16(add_i16(jpeg_mul3_u16(tp1), tc1), bias));
+    JpegVecU16 e0 = srli_u16<4>(add_i16(add_i16(jpeg_mul3_u16(tc0), tp0), bias));
+    JpegVecU16 e1 = srli_u16<4>(add_i16(add_i16(jpeg_mul3_u16(tc1), tp1), bias));
+
+    // Interleaves odd (low byte) and even (high byte) output pixels, starting at `i * 2 - 1`.
+    jpeg_store_lanes_2x(dst + i * 2u - 1u, vec_u8(or_(o0, slli_i16<8>(e0))), vec_u8(or_(o1, slli_i16<8>(e1))));
+    i += kN;
+  }
+
+  uint32_t t0;
+  uint32_t t1 = 3 * src0[i - 1] + src1[i - 1];
+
+  for (; i < w; i++) {
+    t0 = t1;
+    t1 = 3 * src0[i] + src1[i];
+
+    dst[i * 2 - 1] = uint8_t((3 * t0 + t1 + 8) >> 4);
+    dst[i * 2    ] = uint8_t((3 * t1 + t0 + 8) >> 4);
+  }
+  dst[w * 2 - 1] = uint8_t((t1 + 2) >> 2);
+
+  return dst;
+}
+
+// bl::Jpeg::Opts - SimdImpl - Init
+// ================================
+
+static BL_INLINE void init_simd_functions(FuncOpts& fo) noexcept {
+  fo.idct8 = idct8_simd;
+  fo.conv_ycbcr8_to_rgb32 = rgb32_from_ycbcr8_simd;
+
+  fo.upsample_1x2 = upsample_1x2_simd;
+  fo.upsample_2x1 = upsample_2x1_simd;
+  fo.upsample_2x2 = upsample_2x2_simd;
+
+  fo.fdct8 = fdct8_simd;
+  fo.conv_rgb32_to_ycbcr8 = ycbcr8_from_rgb32_simd;
+}
+
+} // {anonymous}
+} // {bl::Jpeg}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_CODEC_JPEGOPSSIMDIMPL_P_H_INCLUDED
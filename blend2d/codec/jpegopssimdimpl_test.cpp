@@ -0,0 +1,178 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/random.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/codec/jpegops_p.h>
+#include <blend2d/support/intops_p.h>
+
+// bl::Jpeg::Opts - Tests
+// ======================
+
+namespace bl::Jpeg::Tests {
+
+static constexpr uint32_t kMaxRowSize = 300;
+static constexpr uint32_t kGuardSize = 64;
+static constexpr uint8_t kGuardByte = 0xCD;
+
+static void fill_random_bytes(uint8_t* p, size_t n, BLRandom& rnd) noexcept {
+  for (size_t i = 0; i < n; i++)
+    p[i] = uint8_t(rnd.next_uint32() >> 24u);
+}
+
+static void test_idct_fdct(const FuncOpts& reference, const FuncOpts& optimized, const char* impl_name) noexcept {
+  BLRandom rnd(0x5A5AA5A5DEADBEEFu);
+
+  alignas(16) int16_t coefficients[64];
+  alignas(16) int16_t ref_coefficients[64];
+  alignas(16) int16_t opt_coefficients[64];
+  uint16_t q_table[64];
+  float q_recip[64];
+
+  uint8_t pixels[8 * 8];
+  uint8_t ref_pixels[8 * 8];
+  uint8_t opt_pixels[8 * 8];
+
+  for (uint32_t iter = 0; iter < 2000; iter++) {
+    // Coefficients are mostly small in real data, test both sparse and dense blocks.
+    uint32_t density = 1u + (iter & 7u);
+    for (uint32_t i = 0; i < 64; i++) {
+      coefficients[i] = (rnd.next_uint32() & 7u) < density ? int16_t(int32_t(rnd.next_uint32() & 0xFFu) - 128) : int16_t(0);
+      q_table[i] = uint16_t(1u + (rnd.next_uint32() & 3u));
+      q_recip[i] = 1.0f / (8.0f * float(1u + (rnd.next_uint32() & 63u)));
+    }
+
+    reference.idct8(ref_pixels, 8, coefficients, q_table);
+    optimized.idct8(opt_pixels, 8, coefficients, q_table);
+
+    EXPECT_EQ(memcmp(ref_pixels, opt_pixels, sizeof(ref_pixels)), 0)
+      .message("IDCT mismatch: Iteration=%u Impl=%s", iter, impl_name);
+
+    fill_random_bytes(pixels, sizeof(pixels), rnd);
+    reference.fdct8(ref_coefficients, pixels, 8, q_recip);
+    optimized.fdct8(opt_coefficients, pixels, 8, q_recip);
+
+    EXPECT_EQ(memcmp(ref_coefficients, opt_coefficients, sizeof(ref_coefficients)), 0)
+      .message("FDCT mismatch: Iteration=%u Impl=%s", iter, impl_name);
+  }
+}
+
+static void test_color_conversion(const FuncOpts& reference, const FuncOpts& optimized, const char* impl_name) noexcept {
+  BLRandom rnd(0x0123456789ABCDEFu);
+
+  uint8_t planes[3][kMaxRowSize];
+  uint8_t ref_planes[3][kMaxRowSize];
+  uint8_t opt_planes[3][kMaxRowSize];
+
+  alignas(16) uint8_t pixels[kMaxRowSize * 4];
+  alignas(16) uint8_t ref_pixels[kMaxRowSize * 4 + kGuardSize];
+  alignas(16) uint8_t opt_pixels[kMaxRowSize * 4 + kGuardSize];
+
+  for (uint32_t w = 0; w <= kMaxRowSize - 16; w += (w < 80 ? 1u : 13u)) {
+    fill_random_bytes(&planes[0][0], sizeof(planes), rnd);
+    memset(ref_pixels, kGuardByte, sizeof(ref_pixels));
+    memset(opt_pixels, kGuardByte, sizeof(opt_pixels));
+
+    reference.conv_ycbcr8_to_rgb32(ref_pixels, planes[0], planes[1], planes[2], w);
+    optimized.conv_ycbcr8_to_rgb32(opt_pixels, planes[0], planes[1], planes[2], w);
+
+    EXPECT_EQ(memcmp(ref_pixels, opt_pixels, sizeof(ref_pixels)), 0)
+      .message("YCbCr8 to RGB32 mismatch: Width=%u Impl=%s", w, impl_name);
+
+    fill_random_bytes(pixels, sizeof(pixels), rnd);
+    reference.conv_rgb32_to_ycbcr8(ref_planes[0], ref_planes[1], ref_planes[2], pixels, w);
+    optimized.conv_rgb32_to_ycbcr8(opt_planes[0], opt_planes[1], opt_planes[2], pixels, w);
+
+    for (uint32_t i = 0; i < 3; i++) {
+      EXPECT_EQ(memcmp(ref_planes[i], opt_planes[i], w), 0)
+        .message("RGB32 to YCbCr8 mismatch: Width=%u Plane=%u Impl=%s", w, i, impl_name);
+    }
+  }
+}
+
+static void test_upsampling(const FuncOpts& reference, const FuncOpts& optimized, const char* impl_name) noexcept {
+  using UpsampleFunc = uint8_t* (BL_CDECL*)(uint8_t* dst, uint8_t* src0, uint8_t* src1, uint32_t w, uint32_t hs) noexcept;
+
+  struct UpsampleTest {
+    const char* name;
+    UpsampleFunc ref;
+    UpsampleFunc opt;
+    uint32_t hs;
+  };
+
+  const UpsampleTest tests[] = {
+    { "1x2", reference.upsample_1x2, optimized.upsample_1x2, 1 },
+    { "2x1", reference.upsample_2x1, optimized.upsample_2x1, 2 },
+    { "2x2", reference.upsample_2x2, optimized.upsample_2x2, 2 }
+  };
+
+  BLRandom rnd(0xFEDCBA9876543210u);
+
+  uint8_t src0[kMaxRowSize];
+  uint8_t src1[kMaxRowSize];
+  uint8_t ref_dst[kMaxRowSize * 2 + kGuardSize];
+  uint8_t opt_dst[kMaxRowSize * 2 + kGuardSize];
+
+  for (const UpsampleTest& test : tests) {
+    for (uint32_t w = 1; w <= kMaxRowSize; w += (w < 80 ? 1u : 11u)) {
+      fill_random_bytes(src0, sizeof(src0), rnd);
+      fill_random_bytes(src1, sizeof(src1), rnd);
+      memset(ref_dst, kGuardByte, sizeof(ref_dst));
+      memset(opt_dst, kGuardByte, sizeof(opt_dst));
+
+      uint8_t* ref_out = test.ref(ref_dst, src0, src1, w, test.hs);
+      uint8_t* opt_out = test.opt(opt_dst, src0, src1, w, test.hs);
+
+      EXPECT_EQ(ref_out, ref_dst);
+      EXPECT_EQ(opt_out, opt_dst);
+      EXPECT_EQ(memcmp(ref_dst, opt_dst, sizeof(ref_dst)), 0)
+        .message("Upsample %s mismatch: Width=%u Impl=%s", test.name, w, impl_name);
+    }
+  }
+}
+
+static void test_simd_impl(const FuncOpts& reference, const FuncOpts& optimized, const char* impl_name) noexcept {
+  INFO("Testing %s implementation", impl_name);
+
+  test_idct_fdct(reference, optimized, impl_name);
+  test_color_conversion(reference, optimized, impl_name);
+  test_upsampling(reference, optimized, impl_name);
+}
+
+UNIT(codec_jpeg_simd_ops, BL_TEST_GROUP_IMAGE_CODEC_OPS) {
+  FuncOpts reference {};
+  init_func_opts_ref(reference);
+
+#ifdef BL_BUILD_OPT_SSE2
+  if (bl_runtime_has_sse2(&bl_runtime_context)) {
+    FuncOpts optimized = reference;
+    init_func_opts_sse2(optimized);
+    test_simd_impl(reference, optimized, "SSE2");
+  }
+#endif // BL_BUILD_OPT_SSE2
+
+#ifdef BL_BUILD_OPT_AVX2
+  if (bl_runtime_has_avx2(&bl_runtime_context)) {
+    FuncOpts optimized = reference;
+    init_func_opts_avx2(optimized);
+    test_simd_impl(reference, optimized, "AVX2");
+  }
+#endif // BL_BUILD_OPT_AVX2
+
+#ifdef BL_BUILD_OPT_ASIMD
+  if (bl_runtime_has_asimd(&bl_runtime_context)) {
+    FuncOpts optimized = reference;
+    init_func_opts_asimd(optimized);
+    test_simd_impl(reference, optimized, "ASIMD");
+  }
+#endif // BL_BUILD_OPT_ASIMD
+}
+
+} // {bl::Jpeg::Tests}
+
+#endif // BL_TEST
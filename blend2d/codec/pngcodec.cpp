@@ -9,7 +9,8 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/array_p.h>
-#include <blend2d/core/format.h>
+#include <blend2d/core/format_p.h>
+#include <blend2d/core/imagedecoder_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/runtime_p.h>
 #include <blend2d/core/var_p.h>
@@ -1296,31 +1297,8 @@ static void zero_pixels(uint8_t* dst_data, intptr_t dst_stride, size_t w, uint32
   }
 }
 
-static BLResult decoder_read_pixel_data(BLPngDecoderImpl* decoder_impl, BLImage* image_out, const uint8_t* input, size_t size) noexcept {
-  // Number of bytes to overallocate so the DEFLATE decoder doesn't have to run the slow loop at the end.
-  constexpr uint32_t kOutputSizeScratch = 1024u;
-
-  // Make sure we won't initialize our chunk reader out of range.
-  if (BL_UNLIKELY(size < decoder_impl->buffer_index)) {
-    return bl_make_error(BL_ERROR_INVALID_STATE);
-  }
-
-  ChunkReader chunk_reader(input + decoder_impl->buffer_index, input + size);
-
-  uint32_t x = 0u;
-  uint32_t y = 0u;
-  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
-  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
-
-  // Advance Chunks
-  // --------------
-
-  uint32_t frame_tag =
-    (decoder_impl->frame_index == 0u)
-      ? BL_MAKE_TAG('I', 'D', 'A', 'T')
-      : BL_MAKE_TAG('f', 'd', 'A', 'T');
-
-  // Process all preceding chunks, which are not 'IDAT' or 'fdAT'.
+// Processes all chunks preceding the first chunk of pixel data of the current frame ('IDAT' or 'fdAT').
+static BLResult decoder_advance_to_pixel_data(BLPngDecoderImpl* decoder_impl, ChunkReader& chunk_reader, const uint8_t* input, uint32_t frame_tag) noexcept {
   for (;;) {
     if (BL_UNLIKELY(!chunk_reader.has_chunk())) {
       return bl_make_error(BL_ERROR_DATA_TRUNCATED);
@@ -1360,6 +1338,35 @@ static BLResult decoder_read_pixel_data(BLPngDecoderImpl* decoder_impl, BLImage*
     chunk_reader.advance(size_t(kPngChunkBaseSize) + chunk_size);
   }
 
+  return BL_SUCCESS;
+}
+
+static BLResult decoder_read_pixel_data(BLPngDecoderImpl* decoder_impl, BLImage* image_out, const uint8_t* input, size_t size) noexcept {
+  // Number of bytes to overallocate so the DEFLATE decoder doesn't have to run the slow loop at the end.
+  constexpr uint32_t kOutputSizeScratch = 1024u;
+
+  // Make sure we won't initialize our chunk reader out of range.
+  if (BL_UNLIKELY(size < decoder_impl->buffer_index)) {
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+  }
+
+  ChunkReader chunk_reader(input + decoder_impl->buffer_index, input + size);
+
+  uint32_t x = 0u;
+  uint32_t y = 0u;
+  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
+  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
+
+  // Advance Chunks
+  // --------------
+
+  uint32_t frame_tag =
+    (decoder_impl->frame_index == 0u)
+      ? BL_MAKE_TAG('I', 'D', 'A', 'T')
+      : BL_MAKE_TAG('f', 'd', 'A', 'T');
+
+  BL_PROPAGATE(decoder_advance_to_pixel_data(decoder_impl, chunk_reader, input, frame_tag));
+
   // Handle APNG Frame Window
   // ------------------------
 
@@ -1611,6 +1618,193 @@ static BLResult decoder_read_pixel_data(BLPngDecoderImpl* decoder_impl, BLImage*
   return BL_SUCCESS;
 }
 
+// Decodes pixel data of a non-interlaced image in bands. The DEFLATE decoder writes into a sliding window, which only
+// holds the last 32kB of the decompressed stream and the rows that were not consumed yet, and the rows are copied from
+// it to a band buffer where the inverse filter is applied (the window cannot be modified as it's used by the decoder).
+static BLResult decoder_read_pixel_data_rows(BLPngDecoderImpl* decoder_impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* input, size_t size) noexcept {
+  // Maximum distance of a DEFLATE back-reference - this part of the window must always be kept.
+  constexpr size_t kDeflateWindowSize = 32768u;
+  // The decoder copies stored blocks at once, so the window must always have space for the largest one.
+  constexpr size_t kDeflateStoredBlockSize = 65535u + 1024u;
+
+  constexpr uint32_t frame_tag = BL_MAKE_TAG('I', 'D', 'A', 'T');
+
+  if (BL_UNLIKELY(size < decoder_impl->buffer_index)) {
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+  }
+
+  ChunkReader chunk_reader(input + decoder_impl->buffer_index, input + size);
+  BL_PROPAGATE(decoder_advance_to_pixel_data(decoder_impl, chunk_reader, input, frame_tag));
+
+  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
+  uint32_t h = uint32_t(decoder_impl->image_info.size.h);
+
+  uint32_t sample_depth = decoder_impl->sample_depth;
+  uint32_t sample_count = decoder_impl->sample_count;
+
+  InterlaceStep step;
+  if (BL_UNLIKELY(calculate_interlace_steps(&step, interlace_table_none, 1, sample_depth, sample_count, w, h) == 0)) {
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+  }
+
+  // Prepare Band Buffers
+  // --------------------
+
+  uint32_t depth = sample_depth * sample_count;
+  uint32_t bytes_per_pixel = bl_max<uint32_t>(depth / 8u, 1);
+  uint32_t output_bpp = bl_format_info[decoder_impl->output_format].depth / 8u;
+
+  // Bytes per line including the filter byte.
+  size_t bpl = step.bpl;
+
+  // Pixels that are not byte aligned are converted for the whole row and the region is selected after conversion.
+  uint32_t conv_x = depth >= 8 ? uint32_t(roi.x) : 0u;
+  uint32_t conv_w = depth >= 8 ? uint32_t(roi.w) : w;
+  size_t src_offset = 1u + size_t(conv_x) * bytes_per_pixel;
+  size_t band_offset = depth >= 8 ? size_t(0) : size_t(roi.x) * output_bpp;
+
+  intptr_t band_stride = intptr_t(IntOps::align_up(size_t(conv_w) * output_bpp, 16));
+  uint32_t band_h = ImageDecoderInternal::band_height(bl_max<size_t>(size_t(band_stride), bpl), h);
+
+  // The row buffer holds the previous (already unfiltered) row followed by `band_h` filtered rows.
+  size_t rows_size = IntOps::align_up(bpl * (band_h + 1u), 16);
+
+  ScopedBuffer buffer;
+  uint8_t* rows_data = static_cast<uint8_t*>(buffer.alloc(rows_size + size_t(band_stride) * band_h));
+
+  if (BL_UNLIKELY(!rows_data)) {
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+  }
+
+  uint8_t* band_data = rows_data + rows_size;
+
+  // The row preceding the first row is all zeros, and its filter is None, so it's not changed by the inverse filter.
+  memset(rows_data, 0, bpl);
+
+  BLArray<uint8_t>& window = decoder_impl->png_pixel_data;
+  BL_PROPAGATE(decoder_impl->deflate_decoder.init(decoder_impl->deflate_format(), Compression::Deflate::DecoderOptions::kStreamOutput));
+  BL_PROPAGATE(window.clear());
+  BL_PROPAGATE(window.reserve(kDeflateWindowSize + bpl + bl_max<size_t>(bpl * band_h, kDeflateStoredBlockSize)));
+
+  // Decode Pixel Data (DEFLATE)
+  // ---------------------------
+
+  // Offset of the first byte in `window`, which was not copied to the row buffer yet.
+  size_t pending = 0;
+
+  uint32_t y = 0;
+  uint32_t y_end = uint32_t(roi.y + roi.h);
+  uint32_t band_count = 0;
+
+  uint32_t chunk_size = chunk_reader.read_chunk_size();
+  BL_ASSERT(chunk_reader.has_chunk_with_size(chunk_size));
+
+  for (;;) {
+    BLDataView chunk{chunk_reader.ptr + kPngChunkHeaderSize, chunk_size};
+    chunk_reader.advance(size_t(kPngChunkBaseSize) + chunk_size);
+
+    // Zero chunks are allowed, however, they don't contain any data, thus don't call the DEFLATE decoder with these.
+    // When the window gets full the decoder must be called again even when the whole chunk was consumed, because it
+    // can still hold input bits that were not decoded yet.
+    bool window_full = false;
+
+    while (chunk.size || window_full) {
+      uint64_t processed_bytes = decoder_impl->deflate_decoder._processed_bytes;
+      BLResult result = decoder_impl->deflate_decoder.decode(window, chunk);
+
+      if (result != BL_SUCCESS && result != BL_ERROR_DATA_TRUNCATED) {
+        return result;
+      }
+
+      size_t consumed = size_t(decoder_impl->deflate_decoder._processed_bytes - processed_bytes);
+      chunk.data += consumed;
+      chunk.size -= consumed;
+
+      // Copy all complete rows to the row buffer and process them in bands.
+      const uint8_t* window_data = window.data();
+      size_t window_size = window.size();
+
+      while (window_size - pending >= bpl && y < y_end) {
+        memcpy(rows_data + (band_count + 1u) * bpl, window_data + pending, bpl);
+        pending += bpl;
+        band_count++;
+        y++;
+
+        // Bands are aligned to the region so the first band that is passed to the user starts at its first row.
+        if (band_count == band_h || y == uint32_t(roi.y) || y == y_end) {
+          uint32_t band_y = y - band_count;
+          BL_PROPAGATE(Ops::func_table.inverse_filter[bytes_per_pixel](rows_data, bytes_per_pixel, uint32_t(bpl), band_count + 1u));
+
+          if (y > uint32_t(roi.y)) {
+            uint32_t n = y - bl_max<uint32_t>(band_y, uint32_t(roi.y));
+            decoder_impl->pixel_converter.convert_rect(band_data, band_stride, rows_data + (y - n - band_y + 1u) * bpl + src_offset, intptr_t(bpl), conv_w, n);
+            BL_PROPAGATE(ImageDecoderInternal::emit_band(func, user_data, band_data + band_offset, band_stride, roi.w, int(n), decoder_impl->output_format, int(y - n)));
+          }
+
+          // The last row becomes the previous row of the next band.
+          memcpy(rows_data, rows_data + band_count * bpl, bpl);
+          rows_data[0] = uint8_t(kFilterTypeNone);
+          band_count = 0;
+        }
+      }
+
+      // Stop decoding once the last row of the region was processed.
+      if (y == y_end) {
+        goto Done;
+      }
+
+      if (decoder_impl->deflate_decoder.is_done()) {
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+      }
+
+      window_full = result == BL_SUCCESS;
+      if (!window_full) {
+        continue;
+      }
+
+      // The window is full - discard everything except the DEFLATE window and bytes that were not consumed yet.
+      size_t keep_from = bl_min(pending, window_size > kDeflateWindowSize ? window_size - kDeflateWindowSize : size_t(0));
+      BL_ASSERT(keep_from != 0u);
+
+      uint8_t* window_mutable;
+      BL_PROPAGATE(window.make_mutable(&window_mutable));
+      memmove(window_mutable, window_mutable + keep_from, window_size - keep_from);
+      BL_PROPAGATE(window.truncate(window_size - keep_from));
+      pending -= keep_from;
+    }
+
+    // Consecutive chunks required.
+    if (BL_UNLIKELY(!chunk_reader.has_chunk())) {
+      return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+    }
+
+    chunk_size = chunk_reader.read_chunk_size();
+    if (BL_UNLIKELY(!chunk_reader.has_chunk_with_size(chunk_size))) {
+      return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+    }
+
+    uint32_t chunk_tag = chunk_reader.read_chunk_tag();
+    if (BL_UNLIKELY(chunk_tag != frame_tag)) {
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+    }
+  }
+
+Done:
+  // Skip pixel data chunks that were not needed to decode the region.
+  while (chunk_reader.has_chunk() && chunk_reader.read_chunk_tag() == frame_tag) {
+    chunk_size = chunk_reader.read_chunk_size();
+    if (!chunk_reader.has_chunk_with_size(chunk_size)) {
+      break;
+    }
+    chunk_reader.advance(size_t(kPngChunkBaseSize) + chunk_size);
+  }
+
+  decoder_impl->buffer_index = PtrOps::byte_offset(input, chunk_reader.ptr);
+  decoder_impl->frame_index++;
+
+  return BL_SUCCESS;
+}
+
 static BLResult BL_CDECL decoder_read_info_impl(BLImageDecoderImpl* impl, BLImageInfo* info_out, const uint8_t* data, size_t size) noexcept {
   BLPngDecoderImpl* decoder_impl = static_cast<BLPngDecoderImpl*>(impl);
   BLResult result = decoder_impl->last_result;
@@ -1654,6 +1848,31 @@ static BLResult BL_CDECL decoder_read_frame_impl(BLImageDecoderImpl* impl, BLIma
   }
 }
 
+static BLResult BL_CDECL decoder_read_frame_rows_impl(BLImageDecoderImpl* impl, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  BLPngDecoderImpl* decoder_impl = static_cast<BLPngDecoderImpl*>(impl);
+  BL_PROPAGATE(decoder_read_info_impl(decoder_impl, nullptr, data, size));
+
+  // Interlaced images cannot be decoded in bands and animation frames are composed over the previous frame.
+  if (decoder_impl->isAPNG() || (decoder_impl->image_info.flags & BL_IMAGE_INFO_FLAG_PROGRESSIVE) != 0u) {
+    return ImageDecoderInternal::read_frame_rows_fallback(decoder_impl, *roi, func, user_data, data, size);
+  }
+
+  if (decoder_impl->frame_index != 0u) {
+    return bl_make_error(BL_ERROR_NO_MORE_DATA);
+  }
+
+  BLResult result = decoder_read_important_chunks(decoder_impl, data, size);
+  if (result == BL_SUCCESS) {
+    result = decoder_read_pixel_data_rows(decoder_impl, *roi, func, user_data, data, size);
+  }
+
+  if (result != BL_SUCCESS) {
+    decoder_impl->last_result = result;
+  }
+
+  return result;
+}
+
 static BLResult BL_CDECL decoder_create_impl(BLImageDecoderCore* self) noexcept {
   BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE_DECODER);
   BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLPngDecoderImpl>(self, info));
@@ -1794,14 +2013,15 @@ public:
     output.appendUInt32BE(tag);
   }
 
-  BL_INLINE void done(OutputBuffer& output) noexcept {
+  //! Finalizes the chunk - CRC of large chunks is calculated by up to `thread_count` threads.
+  BL_INLINE void done(OutputBuffer& output, uint32_t thread_count = 0) noexcept {
     const uint8_t* start = chunk_data + 8;
     size_t chunk_length = PtrOps::byte_offset(start, output.ptr());
 
     // PNG Specification: CRC is calculated on the preceding bytes in the chunk, including
     // the chunk type code and chunk data fields, but not including the length field.
     MemOps::writeU32uBE(chunk_data, uint32_t(chunk_length));
-    output.appendUInt32BE(Compression::Checksum::crc32(start - 4, chunk_length + 4));
+    output.appendUInt32BE(Compression::Checksum::crc32_parallel(start - 4, chunk_length + 4, thread_count));
   }
 };
 
@@ -1815,6 +2035,7 @@ static BLResult BL_CDECL encoder_restart_impl(BLImageEncoderImpl* impl) noexcept
   encoder_impl->frame_index = 0;
   encoder_impl->buffer_index = 0;
   encoder_impl->compression_level = 6;
+  encoder_impl->thread_count = 0;
 
   return BL_SUCCESS;
 }
@@ -1826,6 +2047,10 @@ static BLResult BL_CDECL encoder_get_property_impl(const BLObjectImpl* impl, con
     return bl_var_assign_uint64(value_out, encoder_impl->compression_level);
   }
 
+  if (bl_match_property(name, name_size, "thread_count")) {
+    return bl_var_assign_uint64(value_out, encoder_impl->thread_count);
+  }
+
   return bl_object_impl_get_property(encoder_impl, name, name_size, value_out);
 }
 
@@ -1839,15 +2064,108 @@ static BLResult BL_CDECL encoder_set_property_impl(BLObjectImpl* impl, const cha
     return BL_SUCCESS;
   }
 
+  if (bl_match_property(name, name_size, "thread_count")) {
+    uint64_t v;
+    BL_PROPAGATE(bl_var_to_uint64(value, &v));
+    encoder_impl->thread_count = uint32_t(bl_min<uint64_t>(v, UINT32_MAX));
+    return BL_SUCCESS;
+  }
+
   return bl_object_impl_set_property(encoder_impl, name, name_size, value);
 }
 
-static BLResult filter_image_data(uint8_t* data, intptr_t stride, uint32_t bits_per_pixel, uint32_t w, uint32_t h) noexcept {
-  bl_unused(bits_per_pixel, w);
+// Filter selection strategy of the encoder, which depends on the compression level.
+enum class FilterStrategy : uint32_t {
+  //! No filtering - used when the data is stored uncompressed.
+  kNone = 0,
+  //! Adaptive filtering - selects a filter having the minimum sum of absolute values of filtered bytes per row.
+  kMinSum = 1,
+  //! Brute-force filtering - compresses each row filtered by all filters and selects the one that compresses best
+  //! (only used by the highest compression level as it's much slower than adaptive filtering).
+  kBruteForce = 2
+};
+
+//! Compression level used to compress rows when selecting filters by brute force.
+static constexpr uint32_t kBruteForceTrialCompressionLevel = 4;
 
-  for (uint32_t y = 0; y < h; y++) {
-    data[0] = 0;
-    data += stride;
+static BL_INLINE FilterStrategy filter_strategy_from_compression_level(uint32_t compression_level) noexcept {
+  return compression_level == 0u ? FilterStrategy::kNone :
+         compression_level < Compression::Deflate::kMaxCompressionLevel ? FilterStrategy::kMinSum : FilterStrategy::kBruteForce;
+}
+
+// Filters `h` rows of `data` in place - each row starts with a filter byte followed by `stride - 1` bytes of pixels.
+static BLResult filter_image_data(uint8_t* data, size_t stride, uint32_t bytes_per_pixel, uint32_t h, FilterStrategy strategy) noexcept {
+  if (strategy == FilterStrategy::kNone) {
+    for (uint32_t y = 0; y < h; y++) {
+      data[size_t(y) * stride] = uint8_t(kFilterTypeNone);
+    }
+    return BL_SUCCESS;
+  }
+
+  size_t row_size = stride - 1u;
+
+  // Unfiltered previous and current rows are followed by rows filtered by each filter type (candidates).
+  ScopedBufferTmp<4096> rows_buffer;
+  uint8_t* prev = static_cast<uint8_t*>(rows_buffer.alloc(row_size * (2u + kFilterTypeCount)));
+
+  if (BL_UNLIKELY(!prev)) {
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+  }
+
+  uint8_t* cur = prev + row_size;
+  uint8_t* candidates = cur + row_size;
+  memset(prev, 0, row_size);
+
+  Compression::Deflate::Encoder trial_encoder;
+  ScopedBuffer trial_buffer;
+  uint8_t* trial_output = nullptr;
+  size_t trial_output_size = 0;
+
+  if (strategy == FilterStrategy::kBruteForce) {
+    BL_PROPAGATE(trial_encoder.init(Compression::Deflate::FormatType::kRaw, kBruteForceTrialCompressionLevel));
+    trial_output_size = trial_encoder.minimum_output_buffer_size(stride);
+    trial_output = static_cast<uint8_t*>(trial_buffer.alloc(trial_output_size));
+
+    if (BL_UNLIKELY(!trial_output)) {
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+    }
+  }
+
+  uint8_t* row = data;
+  for (uint32_t y = 0; y < h; y++, row += stride) {
+    memcpy(cur, row + 1, row_size);
+
+    uint32_t costs[kFilterTypeCount];
+    uint32_t best_filter = kFilterTypeNone;
+
+    for (uint32_t filter = 0; filter < kFilterTypeCount; filter++) {
+      costs[filter] = Ops::func_table.filter_row[filter](candidates + filter * row_size, cur, prev, bytes_per_pixel, uint32_t(row_size));
+      if (costs[filter] < costs[best_filter])
+        best_filter = filter;
+    }
+
+    if (strategy == FilterStrategy::kBruteForce) {
+      // The previous filtered row precedes the row in `data`, so it's used as a dictionary of the trial encoder. Using
+      // more rows makes trials much slower without improving the selection (it's more local when only one row is used).
+      size_t dict_size = bl_min<size_t>(PtrOps::byte_offset(data, row), bl_min<size_t>(stride, Compression::Deflate::kMaxWindowSize));
+      size_t best_size = SIZE_MAX;
+
+      for (uint32_t filter = 0; filter < kFilterTypeCount; filter++) {
+        row[0] = uint8_t(filter);
+        memcpy(row + 1, candidates + filter * row_size, row_size);
+
+        size_t size = trial_encoder.compress_part_to(trial_output, trial_output_size, row, stride, dict_size, true);
+        if (size < best_size || (size == best_size && costs[filter] < costs[best_filter])) {
+          best_size = size;
+          best_filter = filter;
+        }
+      }
+    }
+
+    row[0] = uint8_t(best_filter);
+    memcpy(row + 1, candidates + best_filter * row_size, row_size);
+
+    BLInternal::swap(prev, cur);
   }
 
   return BL_SUCCESS;
@@ -1920,15 +2238,29 @@ static BLResult BL_CDECL encoder_write_frame_impl(BLImageEncoderImpl* impl, BLAr
   }
 
   BL_PROPAGATE(pc.convert_rect(uncompressed_data + 1, intptr_t(uncompressed_stride), image_data.pixel_data, image_data.stride, w, h));
-  BL_PROPAGATE(filter_image_data(uncompressed_data, intptr_t(uncompressed_stride), png_format_info.depth, w, h));
+  BL_PROPAGATE(filter_image_data(uncompressed_data, uncompressed_stride, png_format_info.depth / 8u, h, filter_strategy_from_compression_level(encoder_impl->compression_level)));
 
-  // Setup a deflate encoder - higher compression levels require more space, so init it now.
+  // Compress image data - either by a single deflate encoder, which writes directly to the output buffer, or in
+  // parallel when enough threads are allowed and the image data is large enough to be split into multiple parts.
   Compression::Deflate::Encoder deflate_encoder;
-  BL_PROPAGATE(deflate_encoder.init(Compression::Deflate::FormatType::kZlib, encoder_impl->compression_level));
+  BLArray<uint8_t> compressed_data;
 
-  // Create PNG file.
-  size_t output_worst_case_size = deflate_encoder.minimum_output_buffer_size(uncompressed_data_size);
+  bool compress_in_parallel = encoder_impl->thread_count > 1u && uncompressed_data_size > Compression::Deflate::kParallelPartSize;
+  size_t output_worst_case_size = 0;
 
+  if (compress_in_parallel) {
+    BL_PROPAGATE(Compression::Deflate::compress_parallel(compressed_data, BL_MODIFY_OP_ASSIGN_FIT,
+      BLDataView{uncompressed_data, uncompressed_data_size},
+      Compression::Deflate::FormatType::kZlib, encoder_impl->compression_level, encoder_impl->thread_count));
+    output_worst_case_size = compressed_data.size();
+  }
+  else {
+    // Higher compression levels require more space, so init the encoder now.
+    BL_PROPAGATE(deflate_encoder.init(Compression::Deflate::FormatType::kZlib, encoder_impl->compression_level));
+    output_worst_case_size = deflate_encoder.minimum_output_buffer_size(uncompressed_data_size);
+  }
+
+  // Create PNG file.
   size_t ihdr_size = kPngChunkBaseSize + kPngChunkDataSize_IHDR;
   size_t idat_size = kPngChunkBaseSize + output_worst_case_size;
   size_t iend_size = kPngChunkBaseSize;
@@ -1957,8 +2289,11 @@ static BLResult BL_CDECL encoder_write_frame_impl(BLImageEncoderImpl* impl, BLAr
 
   // Write IDAT chunk.
   chunk.start(output, BL_MAKE_TAG('I', 'D', 'A', 'T'));
-  output._ptr += deflate_encoder.compress_to(output.ptr(), output.remaining_size(), uncompressed_data, uncompressed_data_size);
-  chunk.done(output);
+  if (compress_in_parallel)
+    output.append_data(compressed_data.data(), compressed_data.size());
+  else
+    output._ptr += deflate_encoder.compress_to(output.ptr(), output.remaining_size(), uncompressed_data, uncompressed_data_size);
+  chunk.done(output, encoder_impl->thread_count);
 
   // Write IEND chunk.
   chunk.start(output, BL_MAKE_TAG('I', 'E', 'N', 'D'));
@@ -2037,9 +2372,10 @@ void png_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noex
 
   png_codec.impl->ctor(&png_codec.virt);
   png_codec.impl->features =
-    BL_IMAGE_CODEC_FEATURE_READ     |
-    BL_IMAGE_CODEC_FEATURE_WRITE    |
-    BL_IMAGE_CODEC_FEATURE_LOSSLESS ;
+    BL_IMAGE_CODEC_FEATURE_READ      |
+    BL_IMAGE_CODEC_FEATURE_WRITE     |
+    BL_IMAGE_CODEC_FEATURE_LOSSLESS  |
+    BL_IMAGE_CODEC_FEATURE_READ_ROWS ;
   png_codec.impl->name.dcast().assign("PNG");
   png_codec.impl->vendor.dcast().assign("Blend2D");
   png_codec.impl->mime_type.dcast().assign("image/png");
@@ -2054,6 +2390,7 @@ void png_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noex
   png_decoder_virt.restart = decoder_restart_impl;
   png_decoder_virt.read_info = decoder_read_info_impl;
   png_decoder_virt.read_frame = decoder_read_frame_impl;
+  png_decoder_virt.read_frame_rows = decoder_read_frame_rows_impl;
 
   // Initialize PNG encoder virtual functions.
   png_encoder_virt.base.destroy = encoder_destroy_impl;
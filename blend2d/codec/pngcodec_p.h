@@ -180,6 +180,8 @@ struct BLPngDecoderImpl : public BLImageDecoderImpl {
 
 struct BLPngEncoderImpl : public BLImageEncoderImpl {
   uint8_t compression_level;
+  //! Maximum number of threads used to compress image data, values lesser than 2 disable parallel compression.
+  uint32_t thread_count;
 };
 
 struct BLPngCodecImpl : public BLImageCodecImpl {};
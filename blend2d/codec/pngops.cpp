@@ -105,6 +105,22 @@ static BLResult BL_CDECL inverse_filter_impl(uint8_t* p, uint32_t bpp, uint32_t
   return BL_SUCCESS;
 }
 
+// bl::Png::Ops - Filter
+// =====================
+
+template<uint32_t kFilterType>
+static uint32_t BL_CDECL filter_row_impl(uint8_t* dst, const uint8_t* src, const uint8_t* prev, uint32_t bpp, uint32_t n) noexcept {
+  uint32_t cost = 0;
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t x = apply_forward_filter<kFilterType>(src, prev, bpp, i);
+    dst[i] = x;
+    cost += filtered_byte_cost(x);
+  }
+
+  return cost;
+}
+
 void init_func_table_ref(FunctionTable& ft) noexcept {
   ft.inverse_filter[1] = inverse_filter_impl;
   ft.inverse_filter[2] = inverse_filter_impl;
@@ -112,6 +128,12 @@ void init_func_table_ref(FunctionTable& ft) noexcept {
   ft.inverse_filter[4] = inverse_filter_impl;
   ft.inverse_filter[6] = inverse_filter_impl;
   ft.inverse_filter[8] = inverse_filter_impl;
+
+  ft.filter_row[kFilterTypeNone ] = filter_row_impl<kFilterTypeNone>;
+  ft.filter_row[kFilterTypeSub  ] = filter_row_impl<kFilterTypeSub>;
+  ft.filter_row[kFilterTypeUp   ] = filter_row_impl<kFilterTypeUp>;
+  ft.filter_row[kFilterTypeAvg  ] = filter_row_impl<kFilterTypeAvg>;
+  ft.filter_row[kFilterTypePaeth] = filter_row_impl<kFilterTypePaeth>;
 }
 
 void init_func_table(BLRuntimeContext* rt) noexcept {
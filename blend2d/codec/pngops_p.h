@@ -120,6 +120,26 @@ BL_INLINE uint32_t apply_paeth_filter(uint32_t a, uint32_t b, uint32_t c) noexce
   return t1;
 }
 
+//! Filters a byte at index `i` of `src` row by `kFilterType` filter - used by the encoder.
+template<uint32_t kFilterType>
+BL_INLINE uint8_t apply_forward_filter(const uint8_t* src, const uint8_t* prev, uint32_t bpp, uint32_t i) noexcept {
+  uint32_t a = i >= bpp ? src[i - bpp] : 0u;
+  uint32_t b = prev[i];
+  uint32_t c = i >= bpp ? prev[i - bpp] : 0u;
+
+  switch (kFilterType) {
+    case kFilterTypeSub  : return uint8_t(src[i] - a);
+    case kFilterTypeUp   : return uint8_t(src[i] - b);
+    case kFilterTypeAvg  : return uint8_t(src[i] - apply_avg_filter(a, b));
+    case kFilterTypePaeth: return uint8_t(src[i] - apply_paeth_filter(a, b, c));
+    default              : return src[i];
+  }
+}
+
+//! Returns the cost of a filtered byte used by adaptive filter selection - filtered bytes are interpreted as signed
+//! values, so the cost of the whole row is a sum of absolute differences.
+BL_INLINE uint32_t filtered_byte_cost(uint8_t x) noexcept { return uint32_t(bl_abs(int32_t(int8_t(x)))); }
+
 } // {anonymous}
 
 // bl::Png::Ops - Function Table
@@ -129,7 +149,12 @@ BL_INLINE uint32_t apply_paeth_filter(uint32_t a, uint32_t b, uint32_t c) noexce
 struct FunctionTable {
   using InverseFilterFunc = BLResult (BL_CDECL*)(uint8_t* p, uint32_t bpp, uint32_t bpl, uint32_t h) noexcept;
 
+  //! Filters `n` bytes of `src` row into `dst` row and returns the sum of absolute values of filtered bytes. The
+  //! `prev` row is the previous unfiltered row, which must be all zeros in case of the first row of an image.
+  using FilterRowFunc = uint32_t (BL_CDECL*)(uint8_t* dst, const uint8_t* src, const uint8_t* prev, uint32_t bpp, uint32_t n) noexcept;
+
   InverseFilterFunc inverse_filter[9];
+  FilterRowFunc filter_row[kFilterTypeCount];
 };
 extern FunctionTable func_table;
 
@@ -1098,6 +1098,97 @@ BLResult BL_CDECL inverse_filter_simd_impl(uint8_t* p, uint32_t bpp, uint32_t bp
   return BL_SUCCESS;
 }
 
+// Returns sums of absolute values of signed bytes in `x` - the result is horizontally summed by `filter_cost_sum()`.
+static BL_INLINE SIMD::Vec4xU32 v_filter_cost(const SIMD::Vec16xU8& x) noexcept {
+  using namespace SIMD;
+
+  Vec16xU8 x_abs = abs_i8(x);
+
+#if BL_TARGET_ARCH_X86
+  return vec_cast<Vec4xU32>(sad_u8_u64(x_abs, make_zero<Vec16xU8>()));
+#else
+  Vec8xU16 a16 = addl_lo_u8_to_u16(x_abs, make_zero<Vec16xU8>());
+  Vec8xU16 b16 = addl_hi_u8_to_u16(x_abs, make_zero<Vec16xU8>());
+  return addl_lo_u16_to_u32(a16, b16) + addl_hi_u16_to_u32(a16, b16);
+#endif
+}
+
+static BL_INLINE uint32_t filter_cost_sum(SIMD::Vec4xU32 v) noexcept {
+  using namespace SIMD;
+
+  v += swizzle_u32<1, 0, 3, 2>(v);
+  v += swizzle_u32<2, 3, 0, 1>(v);
+  return cast_to_u32(v);
+}
+
+// Calculates AVG or PAETH predictor of 8 bytes widened to 16-bit lanes.
+template<uint32_t kFilterType>
+static BL_INLINE SIMD::Vec8xU16 v_filter_predictor(const SIMD::Vec8xU16& a, const SIMD::Vec8xU16& b, const SIMD::Vec8xU16& c) noexcept {
+  using namespace SIMD;
+
+  if constexpr (kFilterType == kFilterTypeAvg)
+    return srli_u16<1>(add_i16(a, b));
+  else
+    return v_paeth(a, b, c, v_precalc_d(b, c));
+}
+
+// Forward filter used by the encoder - unlike the inverse filter there is no dependency between bytes of the same
+// row as the predictor only uses unfiltered data, so the implementation is the same for all BPPs. The first `bpp`
+// bytes (where `a` and `c` are zero) and the tail, which doesn't fill a whole vector, are filtered by scalar code.
+template<uint32_t kFilterType>
+static uint32_t BL_CDECL filter_row_simd_impl(uint8_t* dst, const uint8_t* src, const uint8_t* prev, uint32_t bpp, uint32_t n) noexcept {
+  using namespace SIMD;
+
+  uint32_t i = 0;
+  uint32_t cost = 0;
+
+  for (uint32_t end = bl_min(bpp, n); i < end; i++) {
+    dst[i] = apply_forward_filter<kFilterType>(src, prev, bpp, i);
+    cost += filtered_byte_cost(dst[i]);
+  }
+
+  if (n - i >= 16u) {
+    Vec4xU32 acc = make_zero<Vec4xU32>();
+
+    do {
+      Vec16xU8 x = loadu<Vec16xU8>(src + i);
+
+      if constexpr (kFilterType == kFilterTypeSub) {
+        x = sub_i8(x, loadu<Vec16xU8>(src + i - bpp));
+      }
+      else if constexpr (kFilterType == kFilterTypeUp) {
+        x = sub_i8(x, loadu<Vec16xU8>(prev + i));
+      }
+      else if constexpr (kFilterType == kFilterTypeAvg || kFilterType == kFilterTypePaeth) {
+        Vec16xU8 a = loadu<Vec16xU8>(src + i - bpp);
+        Vec16xU8 b = loadu<Vec16xU8>(prev + i);
+        Vec16xU8 c = loadu<Vec16xU8>(prev + i - bpp);
+
+        Vec8xU16 pred_lo = v_filter_predictor<kFilterType>(
+          vec_cast<Vec8xU16>(unpack_lo64_u8_u16(a)), vec_cast<Vec8xU16>(unpack_lo64_u8_u16(b)), vec_cast<Vec8xU16>(unpack_lo64_u8_u16(c)));
+        Vec8xU16 pred_hi = v_filter_predictor<kFilterType>(
+          vec_cast<Vec8xU16>(unpack_hi64_u8_u16(a)), vec_cast<Vec8xU16>(unpack_hi64_u8_u16(b)), vec_cast<Vec8xU16>(unpack_hi64_u8_u16(c)));
+
+        x = sub_i8(x, vec_cast<Vec16xU8>(packz_128_u16_u8(pred_lo, pred_hi)));
+      }
+
+      storeu(dst + i, x);
+      acc = add_i32(acc, v_filter_cost(x));
+
+      i += 16;
+    } while (n - i >= 16u);
+
+    cost += filter_cost_sum(acc);
+  }
+
+  for (; i < n; i++) {
+    dst[i] = apply_forward_filter<kFilterType>(src, prev, bpp, i);
+    cost += filtered_byte_cost(dst[i]);
+  }
+
+  return cost;
+}
+
 void init_simd_functions(FunctionTable& ft) noexcept {
   ft.inverse_filter[1] = inverse_filter_simd_impl<1>;
   ft.inverse_filter[2] = inverse_filter_simd_impl<2>;
@@ -1105,6 +1196,12 @@ void init_simd_functions(FunctionTable& ft) noexcept {
   ft.inverse_filter[4] = inverse_filter_simd_impl<4>;
   ft.inverse_filter[6] = inverse_filter_simd_impl<6>;
   ft.inverse_filter[8] = inverse_filter_simd_impl<8>;
+
+  ft.filter_row[kFilterTypeNone ] = filter_row_simd_impl<kFilterTypeNone>;
+  ft.filter_row[kFilterTypeSub  ] = filter_row_simd_impl<kFilterTypeSub>;
+  ft.filter_row[kFilterTypeUp   ] = filter_row_simd_impl<kFilterTypeUp>;
+  ft.filter_row[kFilterTypeAvg  ] = filter_row_simd_impl<kFilterTypeAvg>;
+  ft.filter_row[kFilterTypePaeth] = filter_row_simd_impl<kFilterTypePaeth>;
 }
 
 } // {anonymous}
@@ -116,6 +116,106 @@ static void test_simd_impl(
   }
 }
 
+static void test_forward_filter(Ops::FunctionTable& reference, Ops::FunctionTable& optimized, const char* impl_name) noexcept {
+  BLRandom rnd(0x0123FEED4567BEEFu);
+
+  INFO("Testing %s implementation", impl_name);
+
+  uint32_t h = 8;
+  uint32_t buffer_overrun_guard_size = BL_ARRAY_SIZE(buffer_overrun_guard);
+
+  for (uint32_t w = 1; w <= 111; w++) {
+    for (uint32_t bpp : png_bpp_data) {
+      uint32_t row_size = w * bpp;
+      uint32_t bpl = row_size + 1u;
+
+      uint8_t* image = static_cast<uint8_t*>(malloc(size_t(row_size) * (h + 1u)));
+      uint8_t* filtered = static_cast<uint8_t*>(malloc(size_t(bpl) * h));
+      uint8_t* ref_row = static_cast<uint8_t*>(malloc(row_size));
+      uint8_t* opt_row = static_cast<uint8_t*>(malloc(row_size + buffer_overrun_guard_size));
+
+      EXPECT_NOT_NULL(image);
+      EXPECT_NOT_NULL(filtered);
+      EXPECT_NOT_NULL(ref_row);
+      EXPECT_NOT_NULL(opt_row);
+
+      // The first row of `image` is all zeros - it's the previous row of the first image row.
+      memset(image, 0, row_size);
+      for (uint32_t i = row_size; i < row_size * (h + 1u); i++) {
+        image[i] = uint8_t(rnd.next_uint32() >> 24u);
+      }
+
+      for (uint32_t y = 0; y < h; y++) {
+        const uint8_t* prev = image + size_t(y) * row_size;
+        const uint8_t* src = prev + row_size;
+        uint32_t filter = (y + w) % kFilterTypeCount;
+
+        for (uint32_t f = 0; f < kFilterTypeCount; f++) {
+          memcpy(opt_row + row_size, buffer_overrun_guard, buffer_overrun_guard_size);
+
+          uint32_t ref_cost = reference.filter_row[f](ref_row, src, prev, bpp, row_size);
+          uint32_t opt_cost = optimized.filter_row[f](opt_row, src, prev, bpp, row_size);
+
+          EXPECT_EQ(memcmp(ref_row, opt_row, row_size), 0)
+            .message("Invalid Output: W=%u Y=%u Bpp=%u Filter=%s Impl=%s", w, y, bpp, png_filter_names[f], impl_name);
+          EXPECT_EQ(ref_cost, opt_cost)
+            .message("Invalid Cost: W=%u Y=%u Bpp=%u Filter=%s Impl=%s", w, y, bpp, png_filter_names[f], impl_name);
+          EXPECT_EQ(memcmp(opt_row + row_size, buffer_overrun_guard, buffer_overrun_guard_size), 0)
+            .message("BUFFER OVERRUN: W=%u Y=%u Bpp=%u Filter=%s Impl=%s", w, y, bpp, png_filter_names[f], impl_name);
+        }
+
+        uint8_t* dst = filtered + size_t(y) * bpl;
+        dst[0] = uint8_t(filter);
+        optimized.filter_row[filter](dst + 1, src, prev, bpp, row_size);
+      }
+
+      // Inverse filter must reconstruct the original image.
+      reference.inverse_filter[bpp](filtered, bpp, bpl, h);
+      for (uint32_t y = 0; y < h; y++) {
+        EXPECT_EQ(memcmp(filtered + size_t(y) * bpl + 1u, image + size_t(y + 1u) * row_size, row_size), 0)
+          .message("Inverse filter doesn't match: W=%u Y=%u Bpp=%u Impl=%s", w, y, bpp, impl_name);
+      }
+
+      free(opt_row);
+      free(ref_row);
+      free(filtered);
+      free(image);
+    }
+  }
+}
+
+UNIT(codec_png_simd_filter, BL_TEST_GROUP_IMAGE_CODEC_OPS) {
+  Ops::FunctionTable reference;
+  Ops::init_func_table_ref(reference);
+
+  // The reference implementation is tested as well as it's verified by the inverse filter.
+  test_forward_filter(reference, reference, "Reference");
+
+#ifdef BL_BUILD_OPT_SSE2
+  if (bl_runtime_has_sse2(&bl_runtime_context)) {
+    Ops::FunctionTable optimized;
+    init_func_table_sse2(optimized);
+    test_forward_filter(reference, optimized, "SSE2");
+  }
+#endif // BL_BUILD_OPT_SSE2
+
+#ifdef BL_BUILD_OPT_AVX
+  if (bl_runtime_has_avx(&bl_runtime_context)) {
+    Ops::FunctionTable optimized;
+    init_func_table_avx(optimized);
+    test_forward_filter(reference, optimized, "AVX");
+  }
+#endif // BL_BUILD_OPT_AVX
+
+#ifdef BL_BUILD_OPT_ASIMD
+  if (bl_runtime_has_asimd(&bl_runtime_context)) {
+    Ops::FunctionTable optimized;
+    init_func_table_asimd(optimized);
+    test_forward_filter(reference, optimized, "ASIMD");
+  }
+#endif // BL_BUILD_OPT_ASIMD
+}
+
 UNIT(codec_png_simd_inverse_filter, BL_TEST_GROUP_IMAGE_CODEC_OPS) {
   Ops::FunctionTable reference;
   Ops::init_func_table_ref(reference);
@@ -6,14 +6,17 @@
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/array_p.h>
 #include <blend2d/core/format_p.h>
+#include <blend2d/core/imagedecoder_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/rgba.h>
 #include <blend2d/core/runtime_p.h>
 #include <blend2d/codec/qoicodec_p.h>
 #include <blend2d/pixelops/scalar_p.h>
+#include <blend2d/support/intops_p.h>
 #include <blend2d/support/memops_p.h>
 #include <blend2d/support/ptrops_p.h>
 #include <blend2d/support/lookuptable_p.h>
+#include <blend2d/support/scopedbuffer_p.h>
 
 #if BL_TARGET_ARCH_BITS >= 64
   #define BL_QOI_USE_64_BIT_ARITHMETIC
@@ -245,15 +248,48 @@ static BLResult decoder_read_info_internal(BLQoiDecoderImpl* decoder_impl, const
   return BL_SUCCESS;
 }
 
+// Decoding state, which is preserved between calls to `decode_qoi_data()` so the image can be decoded in bands.
+struct DecodeState {
+  const uint8_t* src;
+  uint32_t packed_pixel;
+  UnpackedPixel unpacked_pixel;
+  // Remaining pixels of QOI_OP_RUN that spans across the last decoded row.
+  uint32_t run;
+
+  uint32_t packed_table[64];
+  UnpackedPixel unpacked_table[64];
+
+  BL_INLINE void init(const uint8_t* data, uint32_t depth) noexcept {
+    src = data;
+    packed_pixel = 0xFF000000;
+    unpacked_pixel = UnpackedPixel::unpack(packed_pixel);
+    run = 0;
+
+    fillRgba32(packed_table, depth == 32 ? 0u : 0xFF000000u, 64);
+    for (UnpackedPixel& pixel : unpacked_table) {
+      pixel = UnpackedPixel{};
+    }
+
+    // Edge case: If the image starts with QOI_OP_RUN, the repeated pixel must be
+    // added to the pixel table, otherwise the decoder may produce incorrect result.
+    uint32_t hbyte0 = src[0];
+
+    if (hbyte0 >= kQoiOpRun && hbyte0 < kQoiOpRun + 62u) {
+      uint32_t hash = unpacked_pixel.hash();
+      packed_table[hash] = packed_pixel;
+      unpacked_table[hash] = unpacked_pixel;
+    }
+  }
+};
+
+// Decodes next `h` rows to `dst_row`.
 template<bool kHasAlpha>
 static BL_INLINE BLResult decode_qoi_data(
+  DecodeState& state,
   uint8_t* dst_row,
   intptr_t dst_stride,
   uint32_t w,
   uint32_t h,
-  uint32_t packed_table[64],
-  UnpackedPixel unpacked_table[64],
-  const uint8_t* src,
   const uint8_t* end) noexcept {
 
   constexpr size_t kMinRemainingBytesOfNextChunk = kQoiEndMarkerSize + 1u;
@@ -261,19 +297,31 @@ static BL_INLINE BLResult decode_qoi_data(
   uint32_t* dst_ptr = reinterpret_cast<uint32_t*>(dst_row);
   uint32_t* dst_end = dst_ptr + w;
 
-  uint32_t packed_pixel = 0xFF000000;
-  UnpackedPixel unpacked_pixel = UnpackedPixel::unpack(packed_pixel);
+  const uint8_t* src = state.src;
+  uint32_t* packed_table = state.packed_table;
+  UnpackedPixel* unpacked_table = state.unpacked_table;
 
-  // Edge case: If the image starts with QOI_OP_RUN, the repeated pixel must be
-  // added to the pixel table, otherwise the decoder may produce incorrect result.
-  {
-    uint32_t hbyte0 = src[0];
+  uint32_t packed_pixel = state.packed_pixel;
+  UnpackedPixel unpacked_pixel = state.unpacked_pixel;
 
-    if (hbyte0 >= kQoiOpRun && hbyte0 < kQoiOpRun + 62u) {
-      uint32_t hash = unpacked_pixel.hash();
-      packed_table[hash] = packed_pixel;
-      unpacked_table[hash] = unpacked_pixel;
+  // Finish QOI_OP_RUN that didn't fit into the previous band.
+  while (state.run) {
+    size_t fill = bl_min<size_t>(state.run, w);
+
+    state.run -= uint32_t(fill);
+    dst_ptr = fillRgba32(dst_ptr, packed_pixel, fill);
+
+    if (dst_ptr != dst_end) {
+      break;
+    }
+
+    if (BL_UNLIKELY(--h == 0)) {
+      return BL_SUCCESS;
     }
+
+    dst_row += dst_stride;
+    dst_ptr = reinterpret_cast<uint32_t*>(dst_row);
+    dst_end = dst_ptr + w;
   }
 
   for (;;) {
@@ -373,6 +421,10 @@ store_rle:
     }
 
     if (BL_UNLIKELY(--h == 0)) {
+      state.src = src;
+      state.packed_pixel = packed_pixel;
+      state.unpacked_pixel = unpacked_pixel;
+      state.run = hbyte0;
       return BL_SUCCESS;
     }
 
@@ -411,15 +463,67 @@ static BLResult decoder_read_frame_internal(BLQoiDecoderImpl* decoder_impl, BLIm
   uint8_t* dst_row = static_cast<uint8_t*>(image_data.pixel_data);
   intptr_t dst_stride = image_data.stride;
 
-  uint32_t packed_table[64];
-  fillRgba32(packed_table, depth == 32 ? 0u : 0xFF000000u, 64);
-
-  UnpackedPixel unpacked_table[64] {};
+  DecodeState state;
+  state.init(data, depth);
 
   if (depth == 32)
-    BL_PROPAGATE(decode_qoi_data<true>(dst_row, dst_stride, w, h, packed_table, unpacked_table, data, end));
+    BL_PROPAGATE(decode_qoi_data<true>(state, dst_row, dst_stride, w, h, end));
   else
-    BL_PROPAGATE(decode_qoi_data<false>(dst_row, dst_stride, w, h, packed_table, unpacked_table, data, end));
+    BL_PROPAGATE(decode_qoi_data<false>(state, dst_row, dst_stride, w, h, end));
+
+  decoder_impl->buffer_index = PtrOps::byte_offset(start, data);
+  decoder_impl->frame_index++;
+
+  return BL_SUCCESS;
+}
+
+static BLResult decoder_read_frame_rows_internal(BLQoiDecoderImpl* decoder_impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  if (size < kQoiHeaderSize)
+    return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+
+  const uint8_t* start = data;
+  const uint8_t* end = data + size;
+
+  uint32_t w = uint32_t(decoder_impl->image_info.size.w);
+  uint32_t depth = decoder_impl->image_info.depth;
+  BLFormat format = depth == 32 ? BL_FORMAT_PRGB32 : BL_FORMAT_XRGB32;
+
+  data += kQoiHeaderSize;
+  if (data >= end)
+    return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+
+  // QOI stream can only be decoded sequentially, so rows above the region are decoded too, but only a single band
+  // is kept in memory and the decoding stops after the last row of the region.
+  intptr_t band_stride = intptr_t(IntOps::align_up(size_t(w) * 4u, 16));
+  uint32_t band_h = ImageDecoderInternal::band_height(size_t(band_stride), uint32_t(roi.y + roi.h));
+
+  ScopedBuffer band_buffer;
+  uint8_t* band_data = static_cast<uint8_t*>(band_buffer.alloc(size_t(band_stride) * band_h));
+
+  if (BL_UNLIKELY(!band_data))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  DecodeState state;
+  state.init(data, depth);
+
+  uint8_t* band_roi = band_data + size_t(roi.x) * 4u;
+  int y = 0;
+  int y_end = roi.y + roi.h;
+
+  while (y < y_end) {
+    // Bands are aligned to the region so the first band starts exactly at its first row.
+    int n = bl_min<int>(int(band_h), (y < roi.y ? roi.y : y_end) - y);
+
+    if (depth == 32)
+      BL_PROPAGATE(decode_qoi_data<true>(state, band_data, band_stride, w, uint32_t(n), end));
+    else
+      BL_PROPAGATE(decode_qoi_data<false>(state, band_data, band_stride, w, uint32_t(n), end));
+
+    if (y >= roi.y)
+      BL_PROPAGATE(ImageDecoderInternal::emit_band(func, user_data, band_roi, band_stride, roi.w, n, format, y));
+
+    y += n;
+  }
 
   decoder_impl->buffer_index = PtrOps::byte_offset(start, data);
   decoder_impl->frame_index++;
@@ -470,6 +574,19 @@ static BLResult BL_CDECL decoder_read_frame_impl(BLImageDecoderImpl* impl, BLIma
   return result;
 }
 
+static BLResult BL_CDECL decoder_read_frame_rows_impl(BLImageDecoderImpl* impl, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  BLQoiDecoderImpl* decoder_impl = static_cast<BLQoiDecoderImpl*>(impl);
+  BL_PROPAGATE(decoder_read_info_impl(decoder_impl, nullptr, data, size));
+
+  if (decoder_impl->frame_index)
+    return bl_make_error(BL_ERROR_NO_MORE_DATA);
+
+  BLResult result = decoder_read_frame_rows_internal(decoder_impl, *roi, func, user_data, data, size);
+  if (result != BL_SUCCESS)
+    decoder_impl->last_result = result;
+  return result;
+}
+
 static BLResult BL_CDECL decoder_create_impl(BLImageDecoderCore* self) noexcept {
   BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE_DECODER);
   BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLQoiDecoderImpl>(self, info));
@@ -960,9 +1077,10 @@ void qoi_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noex
   qoi_codec.virt.create_encoder = codec_create_encoder_impl;
 
   qoi_codec.impl->ctor(&qoi_codec.virt);
-  qoi_codec.impl->features = BLImageCodecFeatures(BL_IMAGE_CODEC_FEATURE_READ     |
-                                                 BL_IMAGE_CODEC_FEATURE_WRITE    |
-                                                 BL_IMAGE_CODEC_FEATURE_LOSSLESS);
+  qoi_codec.impl->features = BLImageCodecFeatures(BL_IMAGE_CODEC_FEATURE_READ      |
+                                                 BL_IMAGE_CODEC_FEATURE_WRITE     |
+                                                 BL_IMAGE_CODEC_FEATURE_LOSSLESS  |
+                                                 BL_IMAGE_CODEC_FEATURE_READ_ROWS);
   qoi_codec.impl->name.dcast().assign("QOI");
   qoi_codec.impl->vendor.dcast().assign("Blend2D");
   qoi_codec.impl->mime_type.dcast().assign("image/qoi");
@@ -977,6 +1095,7 @@ void qoi_codec_on_init(BLRuntimeContext* rt, BLArray<BLImageCodec>* codecs) noex
   qoi_decoder_virt.restart = decoder_restart_impl;
   qoi_decoder_virt.read_info = decoder_read_info_impl;
   qoi_decoder_virt.read_frame = decoder_read_frame_impl;
+  qoi_decoder_virt.read_frame_rows = decoder_read_frame_rows_impl;
 
   // Initialize QOI encoder virtual functions.
   qoi_encoder_virt.base.destroy = encoder_destroy_impl;
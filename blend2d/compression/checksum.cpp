@@ -7,6 +7,9 @@
 #include <blend2d/core/runtime_p.h>
 #include <blend2d/compression/checksum_p.h>
 #include <blend2d/support/ptrops_p.h>
+#include <blend2d/support/scopedbuffer_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/paralleljob_p.h>
 
 namespace bl::Compression::Checksum {
 
@@ -63,6 +66,20 @@ uint32_t adler32(const uint8_t* data, size_t size) noexcept {
   return function_table.adler32(kAdler32Initial, data, size);
 }
 
+uint32_t adler32_combine(uint32_t checksum1, uint32_t checksum2, size_t size2) noexcept {
+  // Appending `size2` bytes to the first sequence adds `size2 * s1` to its s2 sum. The second checksum started with
+  // s1 equal to one, which was counted `size2` times in its s2 sum and once in its s1 sum, so it must be subtracted.
+  uint32_t r = uint32_t(size2 % kAdler32Divisor);
+
+  uint32_t s1 = (checksum1 & 0xFFFFu) + (checksum2 & 0xFFFFu) + kAdler32Divisor - 1u;
+  uint32_t s2 = (((checksum1 & 0xFFFFu) * r) % kAdler32Divisor) + (checksum1 >> 16) + (checksum2 >> 16) + kAdler32Divisor - r;
+
+  s1 %= kAdler32Divisor;
+  s2 %= kAdler32Divisor;
+
+  return (s2 << 16) | s1;
+}
+
 // bl::Compression - CheckSum - Crc32
 // ==================================
 
@@ -144,6 +161,127 @@ uint32_t crc32(const uint8_t* data, size_t size) noexcept {
   return crc32_finalize(function_table.crc32(kCrc32Initial, data, size));
 }
 
+// Multiplies `a` and `b` modulo CRC32 polynomial (both are bit-reflected, so x^0 is represented by the MSB).
+static uint32_t crc32_multiply_mod_p(uint32_t a, uint32_t b) noexcept {
+  uint32_t m = 0x80000000u;
+  uint32_t p = 0u;
+
+  for (;;) {
+    if (a & m) {
+      p ^= b;
+      if ((a & (m - 1u)) == 0u)
+        break;
+    }
+    m >>= 1;
+    b = (b >> 1) ^ (0xEDB88320u & (0u - (b & 1u)));
+  }
+
+  return p;
+}
+
+// Returns x^(8 * size) modulo CRC32 polynomial - each bit of `size` multiplies the result by x^(2^k), which is
+// calculated by repeated squaring.
+static uint32_t crc32_x8n_mod_p(size_t size) noexcept {
+  uint32_t p = 0x80000000u; // x^0
+  uint32_t x2k = 0x00800000u; // x^8
+
+  while (size) {
+    if (size & 1u)
+      p = crc32_multiply_mod_p(x2k, p);
+
+    size >>= 1;
+    if (size)
+      x2k = crc32_multiply_mod_p(x2k, x2k);
+  }
+
+  return p;
+}
+
+uint32_t crc32_combine(uint32_t checksum1, uint32_t checksum2, size_t size2) noexcept {
+  // Appending `size2` bytes to the first sequence multiplies its CRC by x^(8 * size2). Pre and post conditioning
+  // (initial value and final inversion) of both checksums cancels out, so finalized checksums can be combined.
+  return crc32_multiply_mod_p(crc32_x8n_mod_p(size2), checksum1) ^ checksum2;
+}
+
+// bl::Compression - CheckSum - Parallel
+// =====================================
+
+// Checksums are calculated per chunk and combined by the calling thread, which also checksums chunks while waiting
+// for worker threads - so the data is checksummed even when no thread could be acquired from the thread pool.
+struct ParallelJob {
+  using UpdateFunc = uint32_t (BL_CDECL*)(uint32_t checksum, const uint8_t* data, size_t size) noexcept;
+
+  UpdateFunc update;
+  uint32_t initial;
+
+  const uint8_t* data;
+  size_t size;
+
+  uint32_t* chunk_checksums;
+  size_t chunk_count;
+
+  size_t chunk_index;
+};
+
+static void BL_CDECL parallel_checksum_chunks(void* data) noexcept {
+  ParallelJob* job = static_cast<ParallelJob*>(data);
+
+  for (;;) {
+    size_t chunk_index = bl_atomic_fetch_add_strong(&job->chunk_index);
+    if (chunk_index >= job->chunk_count)
+      break;
+
+    size_t offset = chunk_index * kParallelChunkSize;
+    size_t size = bl_min(job->size - offset, kParallelChunkSize);
+    job->chunk_checksums[chunk_index] = job->update(job->initial, job->data + offset, size);
+  }
+}
+
+template<typename CombineFunc, typename FinalizeFunc>
+static BL_INLINE uint32_t checksum_parallel(
+  const uint8_t* data, size_t size, uint32_t thread_count,
+  ParallelJob::UpdateFunc update, uint32_t initial, const CombineFunc& combine, const FinalizeFunc& finalize) noexcept {
+
+  size_t chunk_count = (size + kParallelChunkSize - 1u) / kParallelChunkSize;
+  if (thread_count <= 1u || chunk_count <= 1u)
+    return finalize(update(initial, data, size));
+
+  ScopedBufferTmp<sizeof(uint32_t) * 256> chunk_buffer;
+  uint32_t* chunk_checksums = static_cast<uint32_t*>(chunk_buffer.alloc(chunk_count * sizeof(uint32_t)));
+
+  // Checksum cannot fail, so use a single thread if there is not enough memory to store checksums of all chunks.
+  if (BL_UNLIKELY(!chunk_checksums))
+    return finalize(update(initial, data, size));
+
+  ParallelJob job;
+  job.update = update;
+  job.initial = initial;
+  job.data = data;
+  job.size = size;
+  job.chunk_checksums = chunk_checksums;
+  job.chunk_count = chunk_count;
+  job.chunk_index = 0;
+
+  bl_run_parallel_job(parallel_checksum_chunks, &job, uint32_t(bl_min<size_t>(thread_count, chunk_count)));
+
+  uint32_t checksum = finalize(chunk_checksums[0]);
+  for (size_t i = 1; i < chunk_count; i++) {
+    size_t chunk_size = bl_min(size - i * kParallelChunkSize, kParallelChunkSize);
+    checksum = combine(checksum, finalize(chunk_checksums[i]), chunk_size);
+  }
+  return checksum;
+}
+
+uint32_t crc32_parallel(const uint8_t* data, size_t size, uint32_t thread_count) noexcept {
+  return checksum_parallel(data, size, thread_count, function_table.crc32, kCrc32Initial, crc32_combine,
+    [](uint32_t checksum) noexcept { return crc32_finalize(checksum); });
+}
+
+uint32_t adler32_parallel(const uint8_t* data, size_t size, uint32_t thread_count) noexcept {
+  return checksum_parallel(data, size, thread_count, function_table.adler32, kAdler32Initial, adler32_combine,
+    [](uint32_t checksum) noexcept { return checksum; });
+}
+
 } // {bl::Compression::Checksum}
 
 void bl_compression_rt_init(BLRuntimeContext* rt) noexcept {
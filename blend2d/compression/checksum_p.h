@@ -37,6 +37,9 @@ static constexpr uint32_t kAdler32Divisor = 65521u;
 // byte in the input equals 0xFF and that s1 and s2 started with the highest possible values modulo the divisor.
 static constexpr uint32_t kAdler32MaxBytesPerChunk = 5552u;
 
+// Size of a chunk checksummed by a single thread by \ref crc32_parallel() and \ref adler32_parallel().
+static constexpr size_t kParallelChunkSize = 1024u * 1024u;
+
 namespace {
 static BL_INLINE uint32_t crc32_update_byte(uint32_t checksum, uint8_t b) noexcept { return (checksum >> 8) ^ crc32_table[(checksum ^ b) & 0xFFu]; }
 static BL_INLINE uint32_t crc32_finalize(uint32_t checksum) noexcept { return ~checksum; }
@@ -54,6 +57,10 @@ BL_HIDDEN uint32_t BL_CDECL crc32_update_asimd(uint32_t checksum, const uint8_t*
 #endif // BL_BUILD_OPT_ASIMD_CRYPTO
 
 BL_HIDDEN uint32_t BL_CDECL adler32(const uint8_t* data, size_t size) noexcept;
+
+//! Combines `checksum1` of a first sequence with `checksum2` of a second sequence having `size2` bytes into the
+//! ADLER32 checksum of both sequences concatenated.
+BL_HIDDEN uint32_t adler32_combine(uint32_t checksum1, uint32_t checksum2, size_t size2) noexcept;
 BL_HIDDEN uint32_t BL_CDECL adler32_update_ref(uint32_t checksum, const uint8_t* data, size_t size) noexcept;
 
 #if defined(BL_BUILD_OPT_SSE2)
@@ -64,6 +71,17 @@ BL_HIDDEN uint32_t BL_CDECL adler32_update_sse2(uint32_t checksum, const uint8_t
 BL_HIDDEN uint32_t BL_CDECL adler32_update_asimd(uint32_t checksum, const uint8_t* data, size_t size) noexcept;
 #endif // BL_TARGET_OPT_ASIMD
 
+//! Combines `checksum1` of a first sequence with `checksum2` of a second sequence having `size2` bytes into the
+//! CRC32 checksum of both sequences concatenated. Both checksums must be finalized (as returned by \ref crc32()).
+BL_HIDDEN uint32_t crc32_combine(uint32_t checksum1, uint32_t checksum2, size_t size2) noexcept;
+
+//! Calculates CRC32 checksum of `data` by splitting it into chunks of \ref kParallelChunkSize bytes, which are
+//! checksummed by up to `thread_count` threads (including the calling thread) and combined by \ref crc32_combine().
+BL_HIDDEN uint32_t crc32_parallel(const uint8_t* data, size_t size, uint32_t thread_count) noexcept;
+
+//! Calculates ADLER32 checksum of `data` in parallel, see \ref crc32_parallel().
+BL_HIDDEN uint32_t adler32_parallel(const uint8_t* data, size_t size, uint32_t thread_count) noexcept;
+
 } // {bl::Compression::Checksum}
 
 //! \endcond
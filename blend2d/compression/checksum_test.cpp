@@ -94,6 +94,36 @@ UNIT(compression_checksum_adler32, BL_TEST_GROUP_COMPRESSION_CHECKSUMS) {
   }
 }
 
+UNIT(compression_checksum_adler32_combine, BL_TEST_GROUP_COMPRESSION_CHECKSUMS) {
+  BLArray<uint8_t> input;
+  fill_array_for_checksum(input, kCheckSumInputSize);
+
+  uint32_t expected = adler32(input.data(), kCheckSumInputSize);
+
+  for (uint32_t i = 0; i <= kCheckSumInputSize; i += (i >> 8) + 1u) {
+    uint32_t checksum1 = adler32(input.data(), i);
+    uint32_t checksum2 = adler32(input.data() + i, kCheckSumInputSize - i);
+    uint32_t checksum = adler32_combine(checksum1, checksum2, kCheckSumInputSize - i);
+
+    EXPECT_EQ(checksum, expected).message(
+      "ADLER32 checksum combined at %u doesn't match (checksum=0x%08X expected=0x%08X", i, checksum, expected);
+  }
+
+  input.clear();
+  fill_array_with_same_value(input, 0xFFu, kCheckSumLargeInputSize);
+
+  {
+    size_t size1 = 12345u;
+    size_t size2 = kCheckSumLargeInputSize - size1;
+
+    uint32_t checksum = adler32_combine(adler32(input.data(), size1), adler32(input.data() + size1, size2), size2);
+    uint32_t expected_ff = adler32(input.data(), kCheckSumLargeInputSize);
+
+    EXPECT_EQ(checksum, expected_ff).message(
+      "ADLER32 checksum of %u '0xFF' bytes combined doesn't match (checksum=0x%08X expected=0x%08X", kCheckSumLargeInputSize, checksum, expected_ff);
+  }
+}
+
 UNIT(compression_checksum_crc32, BL_TEST_GROUP_COMPRESSION_CHECKSUMS) {
   const uint8_t* lowercase_letters = reinterpret_cast<const uint8_t*>("abcdefghijklmnopqrstuvwxyz");
 
@@ -148,6 +178,46 @@ UNIT(compression_checksum_crc32, BL_TEST_GROUP_COMPRESSION_CHECKSUMS) {
   }
 }
 
+UNIT(compression_checksum_crc32_combine, BL_TEST_GROUP_COMPRESSION_CHECKSUMS) {
+  BLArray<uint8_t> input;
+  fill_array_for_checksum(input, kCheckSumInputSize);
+
+  uint32_t expected = crc32(input.data(), kCheckSumInputSize);
+
+  for (uint32_t i = 0; i <= kCheckSumInputSize; i += (i >> 8) + 1u) {
+    uint32_t checksum1 = crc32(input.data(), i);
+    uint32_t checksum2 = crc32(input.data() + i, kCheckSumInputSize - i);
+    uint32_t checksum = crc32_combine(checksum1, checksum2, kCheckSumInputSize - i);
+
+    EXPECT_EQ(checksum, expected).message(
+      "CRC32 checksum combined at %u doesn't match (checksum=0x%08X expected=0x%08X", i, checksum, expected);
+  }
+}
+
+UNIT(compression_checksum_parallel, BL_TEST_GROUP_COMPRESSION_CHECKSUMS) {
+  // Not a multiple of the chunk size, so the last chunk is shorter than others.
+  constexpr size_t kInputSize = kParallelChunkSize * 5u + 12345u;
+
+  BLArray<uint8_t> input;
+  fill_array_for_checksum(input, kInputSize);
+
+  uint32_t expected_crc32 = crc32(input.data(), kInputSize);
+  uint32_t expected_adler32 = adler32(input.data(), kInputSize);
+
+  for (uint32_t thread_count : { 0u, 1u, 2u, 4u, 64u }) {
+    uint32_t checksum_crc32 = crc32_parallel(input.data(), kInputSize, thread_count);
+    uint32_t checksum_adler32 = adler32_parallel(input.data(), kInputSize, thread_count);
+
+    EXPECT_EQ(checksum_crc32, expected_crc32).message(
+      "CRC32 checksum calculated by %u threads doesn't match (checksum=0x%08X expected=0x%08X", thread_count, checksum_crc32, expected_crc32);
+    EXPECT_EQ(checksum_adler32, expected_adler32).message(
+      "ADLER32 checksum calculated by %u threads doesn't match (checksum=0x%08X expected=0x%08X", thread_count, checksum_adler32, expected_adler32);
+  }
+
+  EXPECT_EQ(crc32_parallel(input.data(), 100u, 4u), crc32(input.data(), 100u));
+  EXPECT_EQ(adler32_parallel(input.data(), 100u, 4u), adler32(input.data(), 100u));
+}
+
 } // {bl::Compression::Checksum::Tests}
 
 #endif // BL_TEST
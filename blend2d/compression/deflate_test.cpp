@@ -775,10 +775,13 @@ static void test_deflate_invalid_streams() noexcept {
   test_deflate_invalid_stream_with_data("stream4", Deflate::FormatType::kZlib, BL_ERROR_DECOMPRESSION_FAILED, BLDataView{stream4, sizeof(stream4)});
 }
 
-static void test_deflate_roundtrip(BLDataView input, Deflate::FormatType format, uint32_t compression_level, const char* test_data_name) noexcept {
+static void test_deflate_roundtrip(BLDataView input, Deflate::FormatType format, uint32_t compression_level, const char* test_data_name, uint32_t thread_count = 0) noexcept {
   BLArray<uint8_t> encoded;
 
-  {
+  if (thread_count) {
+    EXPECT_SUCCESS(Deflate::compress_parallel(encoded, BL_MODIFY_OP_APPEND_GROW, input, format, compression_level, thread_count));
+  }
+  else {
     Deflate::Encoder encoder;
     EXPECT_SUCCESS(encoder.init(format, compression_level))
       .message("Failed to initialize the encoder");
@@ -898,6 +901,47 @@ static void test_deflate_random_data(size_t min_bytes, size_t max_bytes, size_t
   }
 }
 
+static void test_deflate_parallel(uint32_t compression_level) noexcept {
+  static const TestRandomMode random_modes[] = {
+    TestRandomMode::kRandomDataWithRepeats,
+    TestRandomMode::kRandomDataWithNibbles,
+    TestRandomMode::kAllZeros
+  };
+
+  // The last part is intentionally small to test parts that are stored uncompressed.
+  static const size_t sizes[] = {
+    Deflate::kParallelPartSize + 1u,
+    Deflate::kParallelPartSize * 4u + 12345u
+  };
+
+  for (TestRandomMode random_mode : random_modes) {
+    for (size_t n : sizes) {
+      BLArray<uint8_t> input;
+      BLRandom rnd(0x5678u + n * 7u);
+      EXPECT_SUCCESS(append_random_bytes(input, rnd, n, random_mode));
+
+      test_deflate_roundtrip(input.view(), Deflate::FormatType::kRaw, compression_level, stringify_random_mode(random_mode), 4);
+      test_deflate_roundtrip(input.view(), Deflate::FormatType::kZlib, compression_level, stringify_random_mode(random_mode), 4);
+
+      // The output must not depend on the number of threads used.
+      BLArray<uint8_t> encoded1;
+      BLArray<uint8_t> encoded4;
+
+      EXPECT_SUCCESS(Deflate::compress_parallel(encoded1, BL_MODIFY_OP_ASSIGN_GROW, input.view(), Deflate::FormatType::kZlib, compression_level, 1));
+      EXPECT_SUCCESS(Deflate::compress_parallel(encoded4, BL_MODIFY_OP_ASSIGN_GROW, input.view(), Deflate::FormatType::kZlib, compression_level, 4));
+      EXPECT_TRUE(encoded1.equals(encoded4))
+        .message("Parallel compression output depends on the number of threads (%s): input.size=%zu", stringify_random_mode(random_mode), n);
+    }
+  }
+}
+
+UNIT(compression_deflate_parallel, BL_TEST_GROUP_COMPRESSION_ALGORITHM) {
+  for (uint32_t level : { 0u, 1u, 4u, 6u, 8u, 12u }) {
+    INFO("Testing parallel deflate round-trip compression/decompression with level %u", level);
+    test_deflate_parallel(level);
+  }
+}
+
 UNIT(compression_deflate, BL_TEST_GROUP_COMPRESSION_ALGORITHM) {
   INFO("Testing basic deflate tests");
 
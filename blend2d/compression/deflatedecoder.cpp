@@ -1516,6 +1516,11 @@ NotEnoughOutputBytes:
       _processed_bytes += PtrOps::byte_offset(src_data, src_ptr);
       src_data = src_ptr;
 
+      // The caller consumes the output and decides how much of it to keep, see `DecoderOptions::kStreamOutput`.
+      if (bl_test_flag(_options, DecoderOptions::kStreamOutput)) {
+        return BL_SUCCESS;
+      }
+
       // When decoding data where the uncompressed size is known (for example decoding PNG pixel data) it's desired
       // to fail early if the buffer decompresses to more bytes than it should. The implementation has to check the
       // size of the decompressed data anyway, but we don't want to grow above the threshold.
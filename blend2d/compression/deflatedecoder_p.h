@@ -67,7 +67,13 @@ enum class DecoderOptions : uint8_t {
   kNone = 0,
 
   //! The output buffer has enough capacity for the decoded stream, thus the decoder should never realloc.
-  kNeverReallocOutputBuffer = 0x01u
+  kNeverReallocOutputBuffer = 0x01u,
+
+  //! The output buffer is used as a sliding window - when it's full, `decode()` returns \ref BL_SUCCESS before the
+  //! stream is fully decoded (see `Decoder::is_done()`), so the caller can consume the output and continue. The caller
+  //! must keep at least 32kB of the most recent output (the DEFLATE window) in the buffer before calling `decode()`
+  //! again and the buffer should always have space for a whole stored block (64kB).
+  kStreamOutput = 0x02u
 };
 
 BL_DEFINE_ENUM_FLAGS(DecoderOptions);
@@ -395,6 +401,9 @@ public:
 
   BLResult init(FormatType format, DecoderOptions options = DecoderOptions::kNone) noexcept;
   BLResult decode(BLArray<uint8_t>& dst, BLDataView input) noexcept;
+
+  //! Tests whether the whole stream has been decoded.
+  BL_INLINE_NODEBUG bool is_done() const noexcept { return _state == DecoderState::kDone; }
 };
 
 } // {bl::Compression::Deflate}
@@ -24,6 +24,9 @@
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/lookuptable_p.h>
 #include <blend2d/support/ptrops_p.h>
+#include <blend2d/support/scopedbuffer_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/paralleljob_p.h>
 
 namespace bl::Compression::Deflate {
 
@@ -327,7 +330,7 @@ struct BlockSplitStats {
 // Deflate encoder implementation.
 struct EncoderImpl {
   using PrepareFunc = void (BL_CDECL*)(EncoderImpl* impl) noexcept;
-  using CompressFunc = size_t (BL_CDECL*)(EncoderImpl* impl, const uint8_t *, size_t, uint8_t *, size_t) noexcept;
+  using CompressFunc = size_t (BL_CDECL*)(EncoderImpl* impl, const uint8_t *, size_t, size_t, bool, uint8_t *, size_t) noexcept;
 
   //! The pointer, which must be freed in order to free the Impl, because of an alignment requirement of Impl.
   void* allocated_ptr;
@@ -1105,6 +1108,12 @@ static void write_uncompressed_blocks(OutputStream& os, const uint8_t* data, siz
   os.buffer.ptr = buf.ptr;
 }
 
+// Terminates a non-final part of a stream by an empty uncompressed block, which aligns the output to bytes so the
+// next part of the stream, which was compressed independently, can be simply appended to it.
+static BL_INLINE void write_sync_block(OutputStream& os) noexcept {
+  write_uncompressed_blocks(os, os.buffer.ptr, 0, false);
+}
+
 // bl::Compression::Deflate::Encoder - Block Writing
 // =================================================
 
@@ -1510,11 +1519,19 @@ static void BL_CDECL prepare_near_optimal(EncoderImpl* impl) noexcept {
   init_offset_slot_full(static_cast<NearOptimalEncoderImpl*>(impl));
 }
 
+// Inserts `dict_nbytes` bytes preceding the input (`*in_base_p` points to the first of them) into the hash chains,
+// so matches can refer to data that was compressed as a previous part of the stream.
+static BL_INLINE void hc_matchfinder_load_dictionary(hc_matchfinder* mf, const uint8_t** in_base_p, const uint8_t* in_end, size_t dict_nbytes, uint32_t* next_hashes) noexcept {
+  if (dict_nbytes) {
+    hc_matchfinder_skip_positions(mf, in_base_p, *in_base_p, in_end, uint32_t(dict_nbytes), next_hashes);
+  }
+}
+
 // bl::Compression::Deflate::Encoder - Greedy Compressor
 // =====================================================
 
 // This is the "greedy" DEFLATE compressor. It always chooses the longest match.
-static size_t BL_CDECL compress_greedy(EncoderImpl* impl_, const uint8_t* BL_RESTRICT in, size_t in_nbytes, uint8_t* BL_RESTRICT out, size_t out_nbytes_avail) noexcept {
+static size_t BL_CDECL compress_greedy(EncoderImpl* impl_, const uint8_t* BL_RESTRICT in, size_t in_nbytes, size_t dict_nbytes, bool is_final, uint8_t* BL_RESTRICT out, size_t out_nbytes_avail) noexcept {
   GreedyEncoderImpl* impl = static_cast<GreedyEncoderImpl*>(impl_);
 
   OutputStream os{};
@@ -1522,13 +1539,14 @@ static size_t BL_CDECL compress_greedy(EncoderImpl* impl_, const uint8_t* BL_RES
 
   const uint8_t* in_next = in;
   const uint8_t* in_end = in_next + in_nbytes;
-  const uint8_t* in_cur_base = in_next;
+  const uint8_t* in_cur_base = in_next - dict_nbytes;
 
   uint32_t max_len = kMaxMatchLen;
   uint32_t nice_len = bl_min(impl->nice_match_length, max_len);
   uint32_t next_hashes[2] = {0, 0};
 
   hc_matchfinder_init(&impl->hc_mf);
+  hc_matchfinder_load_dictionary(&impl->hc_mf, &in_cur_base, in_end, dict_nbytes, next_hashes);
 
   do {
     // Starting a new DEFLATE block.
@@ -1568,9 +1586,13 @@ static size_t BL_CDECL compress_greedy(EncoderImpl* impl_, const uint8_t* BL_RES
     } while (in_next < in_max_block_end && !should_end_block(&impl->split_stats, in_block_begin, in_next, in_end));
 
     finish_sequence(next_seq, litrunlen);
-    flush_block(impl, os, in_block_begin, uint32_t(in_next - in_block_begin), in_next == in_end, false);
+    flush_block(impl, os, in_block_begin, uint32_t(in_next - in_block_begin), is_final && in_next == in_end, false);
   } while (in_next != in_end);
 
+  if (!is_final) {
+    write_sync_block(os);
+  }
+
   os.bits.flush_final_byte(os.buffer);
   return os.buffer.byte_offset();
 }
@@ -1580,7 +1602,7 @@ static size_t BL_CDECL compress_greedy(EncoderImpl* impl_, const uint8_t* BL_RES
 
 // This is the "lazy" DEFLATE compressor. Before choosing a match, it checks to see if there's a longer match at the
 // next position. If yes, it outputs a literal and continues to the next position. If no, it outputs the match.
-static size_t BL_CDECL compress_lazy(EncoderImpl* impl_, const uint8_t* BL_RESTRICT in, size_t in_nbytes, uint8_t* BL_RESTRICT out, size_t out_nbytes_avail) noexcept {
+static size_t BL_CDECL compress_lazy(EncoderImpl* impl_, const uint8_t* BL_RESTRICT in, size_t in_nbytes, size_t dict_nbytes, bool is_final, uint8_t* BL_RESTRICT out, size_t out_nbytes_avail) noexcept {
   GreedyEncoderImpl* impl = static_cast<GreedyEncoderImpl*>(impl_);
 
   OutputStream os{};
@@ -1588,12 +1610,13 @@ static size_t BL_CDECL compress_lazy(EncoderImpl* impl_, const uint8_t* BL_RESTR
 
   const uint8_t *in_next = in;
   const uint8_t *in_end = in_next + in_nbytes;
-  const uint8_t *in_cur_base = in_next;
+  const uint8_t *in_cur_base = in_next - dict_nbytes;
   uint32_t max_len = kMaxMatchLen;
   uint32_t nice_len = bl_min(impl->nice_match_length, max_len);
   uint32_t next_hashes[2] = {0, 0};
 
   hc_matchfinder_init(&impl->hc_mf);
+  hc_matchfinder_load_dictionary(&impl->hc_mf, &in_cur_base, in_end, dict_nbytes, next_hashes);
 
   do {
     // Starting a new DEFLATE block.
@@ -1670,9 +1693,13 @@ have_cur_match:
     } while (in_next < in_max_block_end && !should_end_block(&impl->split_stats, in_block_begin, in_next, in_end));
 
     finish_sequence(next_seq, litrunlen);
-    flush_block(impl, os, in_block_begin, uint32_t(in_next - in_block_begin), in_next == in_end, false);
+    flush_block(impl, os, in_block_begin, uint32_t(in_next - in_block_begin), is_final && in_next == in_end, false);
   } while (in_next != in_end);
 
+  if (!is_final) {
+    write_sync_block(os);
+  }
+
   os.bits.flush_final_byte(os.buffer);
   return os.buffer.byte_offset();
 }
@@ -1899,7 +1926,7 @@ static void near_optimal_optimize_block(NearOptimalEncoderImpl* impl, uint32_t b
 //   - Heuristic limitations on which matches are actually considered
 //   - Symbol costs are unknown until the symbols have already been chosen
 //     (so iterative optimization must be used)
-static size_t BL_CDECL compress_near_optimal(EncoderImpl* impl_, const uint8_t* BL_RESTRICT in, size_t in_nbytes, uint8_t* BL_RESTRICT out, size_t out_nbytes_avail) noexcept {
+static size_t BL_CDECL compress_near_optimal(EncoderImpl* impl_, const uint8_t* BL_RESTRICT in, size_t in_nbytes, size_t dict_nbytes, bool is_final, uint8_t* BL_RESTRICT out, size_t out_nbytes_avail) noexcept {
   NearOptimalEncoderImpl* impl = static_cast<NearOptimalEncoderImpl*>(impl_);
 
   OutputStream os{};
@@ -1907,8 +1934,8 @@ static size_t BL_CDECL compress_near_optimal(EncoderImpl* impl_, const uint8_t*
 
   const uint8_t *in_next = in;
   const uint8_t *in_end = in_next + in_nbytes;
-  const uint8_t *in_cur_base = in_next;
-  const uint8_t *in_next_slide = in_next + bl_min<size_t>(PtrOps::bytes_until(in_next, in_end), MATCHFINDER_WINDOW_SIZE);
+  const uint8_t *in_cur_base = in_next - dict_nbytes;
+  const uint8_t *in_next_slide = in_cur_base + bl_min<size_t>(PtrOps::bytes_until(in_cur_base, in_end), MATCHFINDER_WINDOW_SIZE);
 
   uint32_t max_len = kMaxMatchLen;
   uint32_t nice_len = bl_min(impl->nice_match_length, max_len);
@@ -1916,6 +1943,16 @@ static size_t BL_CDECL compress_near_optimal(EncoderImpl* impl_, const uint8_t*
 
   bt_matchfinder_init(&impl->bt_mf);
 
+  // Insert all dictionary positions into the binary trees - the dictionary never exceeds the window, so the window
+  // cannot slide here. Matches found at dictionary positions must not extend past the end of the input.
+  for (const uint8_t* in_dict = in_cur_base; in_dict != in_next; in_dict++) {
+    uint32_t dict_nice_len = uint32_t(bl_min<size_t>(PtrOps::bytes_until(in_dict, in_end), nice_len));
+    if (dict_nice_len < BT_MATCHFINDER_REQUIRED_NBYTES) {
+      break;
+    }
+    bt_matchfinder_skip_position(&impl->bt_mf, in_cur_base, in_dict - in_cur_base, dict_nice_len, impl->max_search_depth, next_hashes);
+  }
+
   do {
     // Starting a new DEFLATE block.
     lz_match* cache_ptr = impl->match_cache;
@@ -2005,9 +2042,13 @@ static size_t BL_CDECL compress_near_optimal(EncoderImpl* impl_, const uint8_t*
 
     // All the matches for this block have been cached. Now choose the sequence of items to output and flush the block.
     near_optimal_optimize_block(impl, uint32_t(in_next - in_block_begin), cache_ptr, in_block_begin == in);
-    flush_block(impl, os, in_block_begin, uint32_t(in_next - in_block_begin), in_next == in_end, true);
+    flush_block(impl, os, in_block_begin, uint32_t(in_next - in_block_begin), is_final && in_next == in_end, true);
   } while (in_next != in_end);
 
+  if (!is_final) {
+    write_sync_block(os);
+  }
+
   os.bits.flush_final_byte(os.buffer);
   return os.buffer.byte_offset();
 }
@@ -2106,21 +2147,23 @@ void Encoder::reset() noexcept {
 // The worst case is all uncompressed blocks where one block has `length <= kEncoderMinBlockLength` and
 // the others have length `kEncoderMinBlockLength`. Each uncompressed block has 5 bytes of overhead: 1
 // for BFINAL, BTYPE, and alignment to a byte boundary; 2 for LEN; and 2 for NLEN.
-size_t Encoder::minimum_output_buffer_size(size_t input_size) const noexcept {
-  constexpr size_t kUncompressedBlockOverhead = 1u + 2u + 2u;
+static constexpr size_t kUncompressedBlockOverhead = 1u + 2u + 2u;
 
+static size_t raw_output_buffer_size(size_t input_size) noexcept {
   size_t max_block_count = bl_max<size_t>(DIV_ROUND_UP(input_size, kEncoderMinBlockLength), 1);
-  size_t extra_bytes = size_t(kMinOutputBufferPadding) + kDeflateMinOutputSizeByFormat[size_t(impl->format)] + 1u;
+  return size_t(kMinOutputBufferPadding) + 1u + (max_block_count * kUncompressedBlockOverhead) + input_size;
+}
 
-  return extra_bytes + (max_block_count * kUncompressedBlockOverhead) + input_size;
+size_t Encoder::minimum_output_buffer_size(size_t input_size) const noexcept {
+  return kDeflateMinOutputSizeByFormat[size_t(impl->format)] + raw_output_buffer_size(input_size);
 }
 
-static BL_NOINLINE size_t compress_deflate(EncoderImpl* impl, uint8_t* output, size_t output_size, const void* input, size_t input_size) noexcept {
+static BL_NOINLINE size_t compress_deflate(EncoderImpl* impl, uint8_t* output, size_t output_size, const uint8_t* input, size_t input_size, size_t dict_size, bool is_final) noexcept {
   if (input_size <= impl->min_input_size) {
     // For extremely small inputs just use uncompressed blocks.
     OutputStream os{};
     os.buffer.init(output, output_size);
-    write_uncompressed_blocks(os, static_cast<const uint8_t*>(input), input_size, true);
+    write_uncompressed_blocks(os, input, input_size, is_final);
     return os.buffer.byte_offset();
   }
   else {
@@ -2128,35 +2171,39 @@ static BL_NOINLINE size_t compress_deflate(EncoderImpl* impl, uint8_t* output, s
     BL_ASSERT(impl->compress_func != nullptr);
 
     impl->prepare_func(impl);
-    return impl->compress_func(impl, static_cast<const uint8_t*>(input), input_size, static_cast<uint8_t*>(output), output_size);
+    return impl->compress_func(impl, input, input_size, dict_size, is_final, output, output_size);
   }
 }
 
+static void write_zlib_header(uint8_t* output, uint32_t compression_level) noexcept {
+  static constexpr uint32_t kZlibCompressionMethodDeflate = 8;
+  static constexpr uint32_t kZlibCompressionWindow32KiB = 7;
+
+  // Zlib header - 2 bytes (CMF and FLG).
+  uint32_t hdr = (get_zlib_compression_level_hint(compression_level) << 6) |
+                 (kZlibCompressionMethodDeflate << 8) |
+                 (kZlibCompressionWindow32KiB << 12);
+
+  hdr |= 31u - (hdr % 31u);
+  MemOps::writeU16uBE(output, hdr);
+}
+
 size_t Encoder::compress_to(uint8_t* output, size_t output_size, const uint8_t* input, size_t input_size) noexcept {
   if (BL_UNLIKELY(output_size < kMinOutputBufferPadding + kDeflateMinOutputSizeByFormat[size_t(impl->format)]))
     return 0;
 
   switch (impl->format) {
     case FormatType::kRaw: {
-      return compress_deflate(impl, output, output_size, input, input_size);
+      return compress_deflate(impl, output, output_size, input, input_size, 0, true);
     }
 
     case FormatType::kZlib: {
-      static constexpr uint32_t kZlibCompressionMethodDeflate = 8;
-      static constexpr uint32_t kZlibCompressionWindow32KiB = 7;
-
-      size_t compressed_size = compress_deflate(impl, static_cast<uint8_t*>(output) + 2, output_size - 6, input, input_size);
+      size_t compressed_size = compress_deflate(impl, static_cast<uint8_t*>(output) + 2, output_size - 6, input, input_size, 0, true);
       if (compressed_size == 0) {
         return 0;
       }
 
-      // Zlib header - 2 bytes (CMF and FLG).
-      uint32_t hdr = (get_zlib_compression_level_hint(impl->compression_level) << 6) |
-                     (kZlibCompressionMethodDeflate << 8) |
-                     (kZlibCompressionWindow32KiB << 12);
-
-      hdr |= 31u - (hdr % 31u);
-      MemOps::writeU16uBE(output, hdr);
+      write_zlib_header(output, impl->compression_level);
 
       // Zlib checksum - ADLER32 (4 bytes).
       uint32_t checksum = Checksum::adler32(static_cast<const uint8_t*>(input), input_size);
@@ -2170,6 +2217,16 @@ size_t Encoder::compress_to(uint8_t* output, size_t output_size, const uint8_t*
   }
 }
 
+size_t Encoder::compress_part_to(uint8_t* output, size_t output_size, const uint8_t* input, size_t input_size, size_t dict_size, bool is_final) noexcept {
+  BL_ASSERT(impl->format == FormatType::kRaw);
+  BL_ASSERT(dict_size <= kMaxWindowSize);
+
+  if (BL_UNLIKELY(output_size < kMinOutputBufferPadding + kUncompressedBlockOverhead))
+    return 0;
+
+  return compress_deflate(impl, output, output_size, input, input_size, dict_size, is_final);
+}
+
 BLResult Encoder::compress(BLArray<uint8_t>& dst, BLModifyOp modify_op, BLDataView input) noexcept {
   size_t input_size = input.size;
 
@@ -2186,4 +2243,138 @@ BLResult Encoder::compress(BLArray<uint8_t>& dst, BLModifyOp modify_op, BLDataVi
   return dst.truncate(output_size);
 }
 
+// bl::Compression::Deflate - Parallel Compression
+// ===============================================
+
+struct ParallelPart {
+  BLResult result;
+  uint32_t checksum;
+  size_t output_size;
+};
+
+struct ParallelJob {
+  uint32_t compression_level;
+
+  const uint8_t* input;
+  size_t input_size;
+
+  uint8_t* output;
+  size_t part_output_capacity;
+
+  ParallelPart* parts;
+  size_t part_count;
+
+  size_t part_index;
+};
+
+static void BL_CDECL parallel_compress_parts(void* data) noexcept {
+  ParallelJob* job = static_cast<ParallelJob*>(data);
+  Encoder encoder;
+
+  for (;;) {
+    size_t part_index = bl_atomic_fetch_add_strong(&job->part_index);
+    if (part_index >= job->part_count)
+      break;
+
+    // A part that could not be compressed stores its error in `result`, which is checked by the calling thread.
+    ParallelPart& part = job->parts[part_index];
+    if (!encoder.is_initialized()) {
+      part.result = encoder.init(FormatType::kRaw, job->compression_level);
+      if (part.result != BL_SUCCESS)
+        continue;
+    }
+
+    size_t offset = part_index * kParallelPartSize;
+    size_t size = bl_min(job->input_size - offset, kParallelPartSize);
+    size_t dict_size = bl_min<size_t>(offset, kMaxWindowSize);
+
+    const uint8_t* part_data = job->input + offset;
+    uint8_t* part_output = job->output + part_index * job->part_output_capacity;
+    bool is_final = part_index == job->part_count - 1u;
+
+    part.output_size = encoder.compress_part_to(part_output, job->part_output_capacity, part_data, size, dict_size, is_final);
+    if (BL_UNLIKELY(part.output_size == 0)) {
+      // The output slot of each part is large enough to hold even uncompressed data, so this should never happen.
+      part.result = bl_make_error(BL_ERROR_INVALID_STATE);
+      continue;
+    }
+
+    part.checksum = Checksum::function_table.adler32(Checksum::kAdler32Initial, part_data, size);
+  }
+}
+
+BLResult compress_parallel(BLArray<uint8_t>& dst, BLModifyOp modify_op, BLDataView input, FormatType format, uint32_t compression_level, uint32_t thread_count) noexcept {
+  size_t input_size = input.size;
+  if (input_size == 0) {
+    return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+  }
+
+  compression_level = bl_min(compression_level, kMaxCompressionLevel);
+  size_t part_count = (input_size + kParallelPartSize - 1u) / kParallelPartSize;
+
+  if (part_count == 1u) {
+    Encoder encoder;
+    BL_PROPAGATE(encoder.init(format, compression_level));
+    return encoder.compress(dst, modify_op, input);
+  }
+
+  ScopedBufferTmp<sizeof(ParallelPart) * 64> parts_buffer;
+  ParallelPart* parts = static_cast<ParallelPart*>(parts_buffer.alloc(part_count * sizeof(ParallelPart)));
+
+  if (BL_UNLIKELY(!parts)) {
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+  }
+
+  memset(parts, 0, part_count * sizeof(ParallelPart));
+
+  // Each part is compressed into its own slot of the output buffer, slots are concatenated when all parts are done.
+  size_t header_size = format == FormatType::kZlib ? size_t(2) : size_t(0);
+  size_t part_output_capacity = raw_output_buffer_size(kParallelPartSize) + kUncompressedBlockOverhead;
+  size_t reserve_size = kDeflateMinOutputSizeByFormat[size_t(format)] + part_count * part_output_capacity;
+
+  uint8_t* output;
+  BL_PROPAGATE(dst.modify_op(modify_op, reserve_size, &output));
+  size_t output_offset = PtrOps::byte_offset(dst.data(), output);
+
+  ParallelJob job;
+  job.compression_level = compression_level;
+  job.input = input.data;
+  job.input_size = input_size;
+  job.output = output + header_size;
+  job.part_output_capacity = part_output_capacity;
+  job.parts = parts;
+  job.part_count = part_count;
+  job.part_index = 0;
+
+  bl_run_parallel_job(parallel_compress_parts, &job, uint32_t(bl_min<size_t>(thread_count, part_count)));
+
+  // Concatenate compressed parts and combine their checksums.
+  uint8_t* output_ptr = output + header_size;
+  uint32_t checksum = Checksum::kAdler32Initial;
+
+  for (size_t i = 0; i < part_count; i++) {
+    if (BL_UNLIKELY(parts[i].result != BL_SUCCESS)) {
+      BLResult result = parts[i].result;
+      dst.truncate(output_offset);
+      return result;
+    }
+
+    size_t part_output_size = parts[i].output_size;
+
+    memmove(output_ptr, job.output + i * part_output_capacity, part_output_size);
+    output_ptr += part_output_size;
+
+    size_t part_size = bl_min(input_size - i * kParallelPartSize, kParallelPartSize);
+    checksum = Checksum::adler32_combine(checksum, parts[i].checksum, part_size);
+  }
+
+  if (format == FormatType::kZlib) {
+    write_zlib_header(output, compression_level);
+    MemOps::writeU32uBE(output_ptr, checksum);
+    output_ptr += 4;
+  }
+
+  return dst.truncate(output_offset + PtrOps::byte_offset(output, output_ptr));
+}
+
 } // {bl::Compression::Deflate}
@@ -33,8 +33,24 @@ public:
   size_t minimum_output_buffer_size(size_t input_size) const noexcept;
   size_t compress_to(uint8_t* output, size_t output_size, const uint8_t* input, size_t input_size) noexcept;
   BLResult compress(BLArray<uint8_t>& dst, BLModifyOp modify_op, BLDataView input) noexcept;
+
+  //! Compresses `input` as a part of a larger raw DEFLATE stream (the encoder must use \ref FormatType::kRaw).
+  //!
+  //! The `dict_size` bytes that immediately precede `input` (at most 32kB) are used as a dictionary, thus matches can
+  //! refer to them. If `is_final` is false the last block is not marked as final and the output is terminated by an
+  //! empty uncompressed block, which aligns it to bytes, so the next part can be appended to it as is.
+  size_t compress_part_to(uint8_t* output, size_t output_size, const uint8_t* input, size_t input_size, size_t dict_size, bool is_final) noexcept;
 };
 
+//! Number of input bytes compressed as a single part by \ref compress_parallel().
+static constexpr size_t kParallelPartSize = 256u * 1024u;
+
+//! Compresses `input` into a single stream of the given `format` by splitting it into parts of \ref kParallelPartSize
+//! bytes, which are compressed independently by up to `thread_count` threads (including the calling thread). Each
+//! part uses the preceding 32kB of input as a dictionary and the checksum of the whole input is combined from the
+//! checksums of all parts. The output only depends on `input` and `compression_level`, not on the number of threads.
+BL_HIDDEN BLResult compress_parallel(BLArray<uint8_t>& dst, BLModifyOp modify_op, BLDataView input, FormatType format, uint32_t compression_level, uint32_t thread_count) noexcept;
+
 } // {bl::Compression::Deflate}
 
 //! \endcond
@@ -360,6 +360,12 @@
 //!     - \ref BLClipMode - clip mode
 //!     - \ref BLCompOp - composition operator
 //!     - \ref BLRenderingQuality - rendering quality (aliased rendering or the quality of anti-aliasing)
+//!
+//! ### Display Lists
+//!
+//!   - \ref BLDisplayList - immutable list of rendering commands that can be recorded and replayed by \ref BLContext
+//!     - \ref BLDisplayListCore - C API type representing \ref BLDisplayList
+//!     - \ref BLDisplayListTileInfo - options that can be used by tiled rendering of a display list
 
 
 //! \defgroup bl_runtime Runtime
@@ -904,6 +910,7 @@ BL_FORWARD_DECLARE_STRUCT(BLRuntimeScopeCore);
 BL_FORWARD_DECLARE_STRUCT(BLRuntimeBuildInfo);
 BL_FORWARD_DECLARE_STRUCT(BLRuntimeSystemInfo);
 BL_FORWARD_DECLARE_STRUCT(BLRuntimeResourceInfo);
+BL_FORWARD_DECLARE_STRUCT(BLAllocator);
 
 BL_FORWARD_DECLARE_STRUCT(BLRgba);
 BL_FORWARD_DECLARE_STRUCT(BLRgba32);
@@ -997,6 +1004,10 @@ BL_FORWARD_DECLARE_STRUCT(BLContextCore);
 BL_FORWARD_DECLARE_STRUCT(BLContextImpl);
 BL_FORWARD_DECLARE_STRUCT(BLContextVirt);
 
+BL_FORWARD_DECLARE_STRUCT(BLDisplayListCore);
+BL_FORWARD_DECLARE_STRUCT(BLDisplayListImpl);
+BL_FORWARD_DECLARE_STRUCT(BLDisplayListTileInfo);
+
 BL_FORWARD_DECLARE_STRUCT(BLGlyphBufferCore);
 BL_FORWARD_DECLARE_STRUCT(BLGlyphBufferImpl);
 BL_FORWARD_DECLARE_STRUCT(BLGlyphInfo);
@@ -1062,6 +1073,7 @@ class BLImageEncoder;
 class BLPattern;
 class BLGradient;
 class BLContext;
+class BLDisplayList;
 class BLPixelConverter;
 class BLGlyphBuffer;
 class BLGlyphRunIterator;
@@ -1600,6 +1612,7 @@ struct TypeTraits<BLArray<T>> {
 BL_DEFINE_OBJECT_TRAITS(BLBitArray             , kTypeNoFlags)
 BL_DEFINE_OBJECT_TRAITS(BLBitSet               , kTypeNoFlags)
 BL_DEFINE_OBJECT_TRAITS(BLContext              , kTypeNoFlags)
+BL_DEFINE_OBJECT_TRAITS(BLDisplayList          , kTypeNoFlags)
 BL_DEFINE_OBJECT_TRAITS(BLFont                 , kTypeNoFlags)
 BL_DEFINE_OBJECT_TRAITS(BLFontData             , kTypeNoFlags)
 BL_DEFINE_OBJECT_TRAITS(BLFontFace             , kTypeNoFlags)
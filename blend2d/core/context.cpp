@@ -5,6 +5,7 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/context_p.h>
+#include <blend2d/core/displaylistcontext_p.h>
 #include <blend2d/core/gradient_p.h>
 #include <blend2d/core/image_p.h>
 #include <blend2d/core/pattern_p.h>
@@ -40,6 +41,7 @@ static BLResult BL_CDECL set_fill_rule_impl(BLContextImpl* impl, BLFillRule) noe
 
 static BLResult BL_CDECL save_impl(BLContextImpl* impl, BLContextCookie*) noexcept { return bl_make_error(BL_ERROR_INVALID_STATE); }
 static BLResult BL_CDECL restore_impl(BLContextImpl* impl, const BLContextCookie*) noexcept { return bl_make_error(BL_ERROR_INVALID_STATE); }
+static BLResult BL_CDECL begin_layer_impl(BLContextImpl* impl, const BLRect*, double, BLCompOp) noexcept { return bl_make_error(BL_ERROR_INVALID_STATE); }
 
 static BLResult BL_CDECL get_style_impl(const BLContextImpl* impl, BLContextStyleSlot, bool, BLVarCore*) noexcept { return bl_make_error(BL_ERROR_INVALID_STATE); }
 static BLResult BL_CDECL set_style_impl(BLContextImpl* impl, BLContextStyleSlot, const BLObjectCore*, BLContextStyleTransformMode) noexcept { return bl_make_error(BL_ERROR_INVALID_STATE); }
@@ -116,6 +118,8 @@ static void init_null_context_virt(BLContextVirt* virt) noexcept {
 
   virt->save                        = NullContext::save_impl;
   virt->restore                     = NullContext::restore_impl;
+  virt->begin_layer                 = NullContext::begin_layer_impl;
+  virt->end_layer                   = NullContext::no_args_impl;
 
   virt->user_to_meta                = NullContext::no_args_impl;
   virt->apply_transform_op          = NullContext::apply_transform_op_impl;
@@ -154,6 +158,7 @@ static void init_null_context_virt(BLContextVirt* virt) noexcept {
   virt->clip_to_rect_i              = NullContext::doRectIImpl;
   virt->clip_to_rect_d              = NullContext::doRectDImpl;
   virt->restore_clipping            = NullContext::no_args_impl;
+  virt->clip_to_geometry            = NullContext::do_geometry_impl;
 
   virt->clear_all                   = NullContext::no_args_impl;
   virt->clear_recti                 = NullContext::doRectIImpl;
@@ -332,6 +337,25 @@ BL_API_IMPL BLResult bl_context_end(BLContextCore* self) noexcept {
   return bl_context_reset(self);
 }
 
+// bl::Context - API - Display List
+// ================================
+
+BL_API_IMPL BLResult bl_context_begin_recording(BLContextCore* self, BLDisplayListCore* display_list, const BLSize* size) noexcept {
+  BL_ASSERT(display_list->_d.is_display_list());
+
+  BLContextCore newO;
+  BL_PROPAGATE(bl_display_list_context_init_impl(&newO, display_list, size));
+
+  return bl::ObjectInternal::replace_virtual_instance(self, &newO);
+}
+
+BL_API_IMPL BLResult bl_context_replay(BLContextCore* self, const BLDisplayListCore* display_list, const BLMatrix2D* transform) noexcept {
+  BL_ASSERT(self->_d.is_context());
+  BL_ASSERT(display_list->_d.is_display_list());
+
+  return bl::DisplayListInternal::replay(display_list, self, transform);
+}
+
 // bl::Context - API - Flush
 // =========================
 
@@ -359,6 +383,23 @@ BL_API_IMPL BLResult bl_context_restore(BLContextCore* self, const BLContextCook
   return impl->virt->restore(impl, cookie);
 }
 
+// bl::Context - API - Layers
+// ==========================
+
+BL_API_IMPL BLResult bl_context_begin_layer(BLContextCore* self, const BLRect* bounds, double alpha, BLCompOp comp_op) noexcept {
+  BL_ASSERT(self->_d.is_context());
+  BLContextImpl* impl = self->_impl();
+
+  return impl->virt->begin_layer(impl, bounds, alpha, comp_op);
+}
+
+BL_API_IMPL BLResult bl_context_end_layer(BLContextCore* self) noexcept {
+  BL_ASSERT(self->_d.is_context());
+  BLContextImpl* impl = self->_impl();
+
+  return impl->virt->end_layer(impl);
+}
+
 // bl::Context - API - Transformations
 // ===================================
 
@@ -809,6 +850,13 @@ BL_API_IMPL BLResult bl_context_restore_clipping(BLContextCore* self) noexcept {
   return impl->virt->restore_clipping(impl);
 }
 
+BL_API_IMPL BLResult bl_context_clip_to_geometry(BLContextCore* self, BLGeometryType type, const void* data) noexcept {
+  BL_ASSERT(self->_d.is_context());
+  BLContextImpl* impl = self->_impl();
+
+  return impl->virt->clip_to_geometry(impl, type, data);
+}
+
 // bl::Context - API - Clear Geometry Operations
 // =============================================
 
@@ -1760,4 +1808,5 @@ void bl_context_rt_init(BLRuntimeContext* rt) noexcept {
 
   // Initialize built-in rendering context implementations.
   bl_raster_context_on_init(rt);
+  bl_display_list_context_on_init(rt);
 }
@@ -6,6 +6,7 @@
 #ifndef BLEND2D_CONTEXT_H_INCLUDED
 #define BLEND2D_CONTEXT_H_INCLUDED
 
+#include <blend2d/core/displaylist.h>
 #include <blend2d/core/font.h>
 #include <blend2d/core/geometry.h>
 #include <blend2d/core/glyphrun.h>
@@ -31,10 +32,8 @@ BL_DEFINE_ENUM(BLContextType) {
   //! Dummy rendering context.
   BL_CONTEXT_TYPE_DUMMY = 1,
 
-  /*
-  //! Proxy rendering context.
+  //! Proxy rendering context that records render calls into a \ref BLDisplayList.
   BL_CONTEXT_TYPE_PROXY = 2,
-  */
 
   //! Software-accelerated rendering context.
   BL_CONTEXT_TYPE_RASTER = 3,
@@ -117,6 +116,41 @@ BL_DEFINE_ENUM(BLContextCreateFlags) {
   //! Disables JIT pipeline generator.
   BL_CONTEXT_CREATE_FLAG_DISABLE_JIT = 0x00000001u,
 
+  //! Compiles JIT pipelines asynchronously.
+  //!
+  //! When a pipeline that has not been compiled yet is needed, the rendering context schedules its compilation on a
+  //! background thread acquired from the global thread-pool and uses a pipeline provided by the static (non-JIT)
+  //! runtime until the compiled pipeline is available. This prevents stalls caused by compiling pipelines of new
+  //! style combinations, especially when rendering the first frame. Pipelines not provided by the static runtime
+  //! are still compiled synchronously.
+  //!
+  //! \note Pipelines provided by the static runtime can produce slightly different results (in rounding) than the
+  //! compiled ones. This flag has no effect if JIT pipeline compilation is either not supported or disabled.
+  BL_CONTEXT_CREATE_FLAG_ASYNC_JIT_COMPILATION = 0x00000002u,
+
+  //! Enables a glyph mask cache, which is used to render filled text.
+  //!
+  //! When enabled, glyphs are rasterized into A8 coverage masks that are stored in a global, bounded, and thread-safe
+  //! cache shared by all rendering contexts. Masks are keyed by font face, font size, the linear part of the final
+  //! transform, glyph id, and a subpixel phase of the glyph origin, which is quantized to 1/4 of a pixel. Text that
+  //! is redrawn at the same size is then only composited instead of rasterized again.
+  //!
+  //! \note The glyph origin is quantized, thus the rendered text can slightly differ from text rendered without the
+  //! cache. The cache is not used by text larger than 128 pixels (em-size), by stroked text, and when clipping to an
+  //! unaligned rectangle is in effect.
+  BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE = 0x00000100u,
+
+  //! Processes rendering batches by a scheduler shared by all rendering contexts instead of threads acquired by the
+  //! rendering context exclusively.
+  //!
+  //! The shared scheduler uses a fixed number of threads (based on the number of hardware threads), thus the total
+  //! throughput scales with the number of cores regardless of how many rendering contexts are alive. Jobs and bands
+  //! of a batch are claimed dynamically by the user thread and by any scheduler thread that picks the batch up, so a
+  //! rendering context never waits for a scheduler thread that is busy with another rendering context. This flag
+  //! only makes sense when the asynchronous mode was specified by having `thread_count` greater than 1, which limits
+  //! the number of threads that can work on a single batch.
+  BL_CONTEXT_CREATE_FLAG_SHARED_SCHEDULER = 0x00000200u,
+
   //! Fallbacks to a synchronous rendering in case that the rendering engine wasn't able to acquire threads. This
   //! flag only makes sense when the asynchronous mode was specified by having `thread_count` greater than 0. If the
   //! rendering context fails to acquire at least one thread it would fallback to synchronous mode with no worker
@@ -572,6 +606,13 @@ struct BLContextVirt BL_CLASS_INHERITS(BLObjectVirt) {
 
   BLResult (BL_CDECL* blit_image_d               )(BLContextImpl* impl, const BLPoint* origin, const BLImageCore* img, const BLRectI* img_area) BL_NOEXCEPT_C;
   BLResult (BL_CDECL* blit_scaled_image_d        )(BLContextImpl* impl, const BLRect* rect, const BLImageCore* img, const BLRectI* img_area) BL_NOEXCEPT_C;
+
+  // NOTE: Slots below were added later and must stay at the end to keep the layout of the slots above unchanged.
+
+  BLResult (BL_CDECL* clip_to_geometry           )(BLContextImpl* impl, BLGeometryType type, const void* data) BL_NOEXCEPT_C;
+
+  BLResult (BL_CDECL* begin_layer                )(BLContextImpl* impl, const BLRect* bounds, double alpha, BLCompOp comp_op) BL_NOEXCEPT_C;
+  BLResult (BL_CDECL* end_layer                  )(BLContextImpl* impl) BL_NOEXCEPT_C;
 };
 
 //! Rendering context state.
@@ -646,11 +687,17 @@ BL_API BLImageCore* BL_CDECL bl_context_get_target_image(const BLContextCore* se
 BL_API BLResult BL_CDECL bl_context_begin(BLContextCore* self, BLImageCore* image, const BLContextCreateInfo* cci) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_end(BLContextCore* self) BL_NOEXCEPT_C;
 
+BL_API BLResult BL_CDECL bl_context_begin_recording(BLContextCore* self, BLDisplayListCore* display_list, const BLSize* size) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_context_replay(BLContextCore* self, const BLDisplayListCore* display_list, const BLMatrix2D* transform) BL_NOEXCEPT_C;
+
 BL_API BLResult BL_CDECL bl_context_flush(BLContextCore* self, BLContextFlushFlags flags) BL_NOEXCEPT_C;
 
 BL_API BLResult BL_CDECL bl_context_save(BLContextCore* self, BLContextCookie* cookie) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_restore(BLContextCore* self, const BLContextCookie* cookie) BL_NOEXCEPT_C;
 
+BL_API BLResult BL_CDECL bl_context_begin_layer(BLContextCore* self, const BLRect* bounds, double alpha, BLCompOp comp_op) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_context_end_layer(BLContextCore* self) BL_NOEXCEPT_C;
+
 BL_API BLResult BL_CDECL bl_context_get_meta_transform(const BLContextCore* self, BLMatrix2D* transform_out) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_get_user_transform(const BLContextCore* self, BLMatrix2D* transform_out) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_get_final_transform(const BLContextCore* self, BLMatrix2D* transform_out) BL_NOEXCEPT_C;
@@ -727,6 +774,7 @@ BL_API BLResult BL_CDECL bl_context_set_stroke_options(BLContextCore* self, cons
 BL_API BLResult BL_CDECL bl_context_clip_to_rect_i(BLContextCore* self, const BLRectI* rect) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_clip_to_rect_d(BLContextCore* self, const BLRect* rect) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_restore_clipping(BLContextCore* self) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_context_clip_to_geometry(BLContextCore* self, BLGeometryType type, const void* data) BL_NOEXCEPT_C;
 
 BL_API BLResult BL_CDECL bl_context_clear_all(BLContextCore* self) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_context_clear_rect_i(BLContextCore* self, const BLRectI* rect) BL_NOEXCEPT_C;
@@ -1189,6 +1237,16 @@ public:
     return bl_context_begin(this, &image, create_info);
   }
 
+  //! Begins recording render calls into the given `display_list`.
+  //!
+  //! The rendering context created by this function is a proxy rendering context (\ref BL_CONTEXT_TYPE_PROXY), which
+  //! doesn't render anything - it validates and records all render calls and state changes into `display_list`, which
+  //! is replaced by a new display list of the given `size`. The recording ends by \ref end(), which makes the display
+  //! list immutable so it can be replayed by \ref replay().
+  BL_INLINE_NODEBUG BLResult begin(BLDisplayListCore& display_list, const BLSize& size) noexcept {
+    return bl_context_begin_recording(this, &display_list, &size);
+  }
+
   //! Waits for completion of all render commands and detaches the rendering context from the rendering target.
   //! After `end()` completes the rendering context implementation would be released and replaced by a built-in
   //! null instance (no context).
@@ -1299,6 +1357,46 @@ public:
 
   //! \}
 
+  //! \name Layers
+  //! \{
+
+  //! Begins a new layer that covers `bounds` (in user coordinates), which would be composited by using `alpha` and
+  //! `comp_op` when the layer ends.
+  //!
+  //! A layer is a transparent offscreen surface that replaces the render target until \ref end_layer() is called.
+  //! It's used to apply group opacity or a composition operator to a group of render calls instead of applying them
+  //! to each render call separately. The layer saves the rendering context state (like \ref save() does) and clips
+  //! to `bounds`, so the content of the layer never exceeds them - rendering state can be changed freely within the
+  //! layer and it would be restored by \ref end_layer().
+  //!
+  //! Layers are implemented by the rendering context, so they don't require flushing - asynchronous rendering context
+  //! renders and composites layers in the same bands as all other render calls.
+  //!
+  //! \note Calling \ref restore() to restore a state saved by \ref begin_layer() ends the layer as well. Layers that
+  //! have not ended when the rendering context ends are discarded.
+  BL_INLINE_NODEBUG BLResult begin_layer(const BLRect& bounds, double alpha = 1.0, BLCompOp comp_op = BL_COMP_OP_SRC_OVER) noexcept {
+    BL_CONTEXT_CALL_RETURN(begin_layer, impl, &bounds, alpha, comp_op);
+  }
+
+  //! Begins a new layer that covers the current clip region, see \ref begin_layer(const BLRect&, double, BLCompOp).
+  BL_INLINE_NODEBUG BLResult begin_layer(double alpha = 1.0, BLCompOp comp_op = BL_COMP_OP_SRC_OVER) noexcept {
+    BL_CONTEXT_CALL_RETURN(begin_layer, impl, nullptr, alpha, comp_op);
+  }
+
+  //! Ends the top-most layer - restores all states saved since the layer began and composites the layer to the
+  //! previous render target.
+  //!
+  //! Possible return conditions:
+  //!
+  //!   - \ref BL_SUCCESS - The layer was composited and its state restored successfully.
+  //!   - \ref BL_ERROR_INVALID_STATE - There is no layer to end.
+  //!   - \ref BL_ERROR_NO_MATCHING_COOKIE - A state saved with a cookie after the layer began has not been restored.
+  BL_INLINE_NODEBUG BLResult end_layer() noexcept {
+    BL_CONTEXT_CALL_RETURN(end_layer, impl);
+  }
+
+  //! \}
+
   //! \cond INTERNAL
   //! \name Transformations (Internal)
   //! \{
@@ -2025,6 +2123,20 @@ public:
     return clip_to_rect(BLRect(x, y, w, h));
   }
 
+  //! Intersects the current clip with the area of the given geometry, see \ref clip_to_path() for more details.
+  BL_INLINE_NODEBUG BLResult clip_to_geometry(BLGeometryType type, const void* data) noexcept {
+    BL_CONTEXT_CALL_RETURN(clip_to_geometry, impl, type, data);
+  }
+
+  //! Intersects the current clip with the area of the given `path`.
+  //!
+  //! The path is transformed by the current transformation and filled by using the current fill rule. The rendering
+  //! context rasterizes the clip only once into a coverage mask, which is then combined with the coverage of all
+  //! subsequent render calls until the clipping is restored by \ref restore_clipping() or \ref restore().
+  BL_INLINE_NODEBUG BLResult clip_to_path(const BLPathCore& path) noexcept {
+    return clip_to_geometry(BL_GEOMETRY_TYPE_PATH, &path);
+  }
+
   //! \}
 
   //! \name Clear Geometry Operations
@@ -3898,6 +4010,25 @@ public:
 
   //! \}
 
+  //! \name Display List Operations
+  //! \{
+
+  //! Replays all commands recorded in `display_list`.
+  //!
+  //! The rendering context state is saved before and restored after replaying, and the display list is replayed with
+  //! the state of a newly started rendering context, in the coordinate system given by the current transformation.
+  BL_INLINE_NODEBUG BLResult replay(const BLDisplayListCore& display_list) noexcept {
+    return bl_context_replay(this, &display_list, nullptr);
+  }
+
+  //! Replays all commands recorded in `display_list` transformed by `transform`, which is applied on top of the
+  //! current transformation.
+  BL_INLINE_NODEBUG BLResult replay(const BLDisplayListCore& display_list, const BLMatrix2D& transform) noexcept {
+    return bl_context_replay(this, &display_list, &transform);
+  }
+
+  //! \}
+
   #undef BL_CONTEXT_CALL_RETURN
   #undef BL_CONTEXT_IMPL
 };
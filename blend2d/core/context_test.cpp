@@ -10,6 +10,7 @@
 #include <blend2d/core/gradient_p.h>
 #include <blend2d/core/image_p.h>
 #include <blend2d/core/pattern_p.h>
+#include <blend2d/support/ptrops_p.h>
 
 // bl::Context - Tests
 // ===================
@@ -587,12 +588,158 @@ static void test_context_blit_fill_clip(BLContext& ctx) {
   }
 }
 
+static uint32_t get_pixel32(const BLImage& image, int x, int y) {
+  BLImageData data;
+  image.get_data(&data);
+  return static_cast<const uint32_t*>(PtrOps::offset(data.pixel_data, intptr_t(y) * data.stride))[x];
+}
+
+static void render_clip_to_path(BLImage& image, const BLContextCreateInfo& create_info) {
+  BLPath triangle;
+  triangle.move_to(8, 8);
+  triangle.line_to(120, 8);
+  triangle.line_to(8, 120);
+  triangle.close();
+
+  BLImage mask(64, 64, BL_FORMAT_A8);
+  {
+    BLContext mask_ctx(mask);
+    mask_ctx.clear_all();
+    mask_ctx.fill_all(BLRgba32(0x80FFFFFFu));
+  }
+
+  BLContext ctx(image, create_info);
+  ctx.clear_all();
+
+  ctx.save();
+  ctx.clip_to_path(triangle);
+  ctx.fill_all(BLRgba32(0xFFFF0000u));
+  ctx.fill_rect(BLRectI(64, 0, 64, 32), BLRgba32(0xFF0000FFu));
+  ctx.fill_rect(BLRect(0.5, 64.5, 32.0, 32.0), BLRgba32(0xFFFFFF00u));
+  ctx.fill_circle(BLCircle(40, 40, 16), BLRgba32(0xFF00FF00u));
+  ctx.fill_mask(BLPointI(0, 96), mask, BLRgba32(0xFF00FFFFu));
+
+  // Clipping to another geometry must intersect both clips.
+  BLCircle circle(16, 112, 8);
+  ctx.clip_to_geometry(BL_GEOMETRY_TYPE_CIRCLE, &circle);
+  ctx.fill_all(BLRgba32(0xFFFF00FFu));
+  ctx.restore();
+
+  // Restored state must not be clipped.
+  ctx.fill_rect(BLRectI(120, 120, 8, 8), BLRgba32(0xFFFFFFFFu));
+  ctx.end();
+}
+
+static void test_context_clip_to_path() {
+  INFO("Testing clipping to a path");
+
+  BLImage sync_image(128, 128, BL_FORMAT_PRGB32);
+  BLImage async_image(128, 128, BL_FORMAT_PRGB32);
+
+  BLContextCreateInfo sync_info {};
+  BLContextCreateInfo async_info {};
+  async_info.thread_count = 2;
+
+  render_clip_to_path(sync_image, sync_info);
+  render_clip_to_path(async_image, async_info);
+
+  // Inside of the triangle, outside of the triangle, and the unclipped fill after `restore()`.
+  EXPECT_EQ(get_pixel32(sync_image, 12, 20), 0xFFFF0000u);
+  EXPECT_EQ(get_pixel32(sync_image, 70, 10), 0xFF0000FFu);
+  EXPECT_EQ(get_pixel32(sync_image, 10, 80), 0xFFFFFF00u);
+  EXPECT_EQ(get_pixel32(sync_image, 40, 40), 0xFF00FF00u);
+  EXPECT_EQ(get_pixel32(sync_image, 100, 100), 0u);
+  EXPECT_EQ(get_pixel32(sync_image, 100, 40), 0u);
+  EXPECT_EQ(get_pixel32(sync_image, 124, 124), 0xFFFFFFFFu);
+  EXPECT_NE(get_pixel32(sync_image, 10, 100), 0u);
+  EXPECT_EQ(get_pixel32(sync_image, 40, 100), 0u);
+  EXPECT_EQ(get_pixel32(sync_image, 12, 110), 0xFFFF00FFu);
+  EXPECT_EQ(get_pixel32(sync_image, 22, 112), 0u);
+
+  EXPECT_TRUE(sync_image.equals(async_image));
+}
+
+static void render_layers(BLImage& image, const BLContextCreateInfo& create_info) {
+  BLPath triangle;
+  triangle.move_to(0, 64);
+  triangle.line_to(64, 64);
+  triangle.line_to(0, 128);
+  triangle.close();
+
+  BLContext ctx(image, create_info);
+  ctx.clear_all();
+
+  // Overlapping fills within a layer are composited as a single group.
+  ctx.begin_layer(0.5);
+  ctx.fill_rect(BLRectI(0, 0, 40, 40), BLRgba32(0xFFFF0000u));
+  ctx.fill_rect(BLRectI(20, 20, 40, 40), BLRgba32(0xFFFF0000u));
+
+  // Nested layer that has bounds, the fill cannot escape them. Restoring the state that began the layer ends it.
+  ctx.begin_layer(BLRect(64.0, 0.0, 32.0, 32.0), 1.0, BL_COMP_OP_SRC_COPY);
+  ctx.fill_all(BLRgba32(0xFF0000FFu));
+  ctx.restore_clipping();
+  ctx.fill_rect(BLRectI(80, 16, 48, 48), BLRgba32(0xFF0000FFu));
+  ctx.restore();
+  ctx.end_layer();
+
+  // A layer is clipped by the clip mask of its parent when it's composited.
+  ctx.save();
+  ctx.clip_to_path(triangle);
+  ctx.begin_layer(0.5);
+  ctx.fill_all(BLRgba32(0xFF00FF00u));
+  ctx.end_layer();
+  ctx.restore();
+
+  ctx.end();
+}
+
+static void test_context_layers() {
+  INFO("Testing layers");
+
+  BLImage sync_image(128, 128, BL_FORMAT_PRGB32);
+  BLImage async_image(128, 128, BL_FORMAT_PRGB32);
+
+  BLContextCreateInfo sync_info {};
+  BLContextCreateInfo async_info {};
+  async_info.thread_count = 2;
+
+  render_layers(sync_image, sync_info);
+  render_layers(async_image, async_info);
+
+  EXPECT_EQ(get_pixel32(sync_image, 10, 10), 0x80800000u);
+  EXPECT_EQ(get_pixel32(sync_image, 30, 30), 0x80800000u);
+  EXPECT_EQ(get_pixel32(sync_image, 70, 10), 0x80000080u);
+  EXPECT_EQ(get_pixel32(sync_image, 90, 20), 0x80000080u);
+  EXPECT_EQ(get_pixel32(sync_image, 100, 20), 0u);
+  EXPECT_EQ(get_pixel32(sync_image, 90, 40), 0u);
+  EXPECT_EQ(get_pixel32(sync_image, 8, 72), 0x80008000u);
+  EXPECT_EQ(get_pixel32(sync_image, 56, 120), 0u);
+
+  EXPECT_TRUE(sync_image.equals(async_image));
+
+  BLContext ctx(sync_image);
+  BLContextCookie cookie;
+
+  EXPECT_EQ(ctx.end_layer(), BL_ERROR_INVALID_STATE);
+  EXPECT_EQ(ctx.begin_layer(Math::nan<double>()), BL_ERROR_INVALID_VALUE);
+
+  // A state saved with a cookie can only be restored by using the cookie.
+  EXPECT_SUCCESS(ctx.begin_layer());
+  EXPECT_SUCCESS(ctx.save(cookie));
+  EXPECT_EQ(ctx.end_layer(), BL_ERROR_NO_MATCHING_COOKIE);
+  EXPECT_SUCCESS(ctx.restore(cookie));
+  EXPECT_SUCCESS(ctx.end_layer());
+  EXPECT_EQ(ctx.saved_state_count(), 0u);
+}
+
 UNIT(context, BL_TEST_GROUP_RENDERING_CONTEXT) {
   BLImage img(256, 256, BL_FORMAT_PRGB32);
   BLContext ctx(img);
 
   test_context_state(ctx);
   test_context_blit_fill_clip(ctx);
+  test_context_clip_to_path();
+  test_context_layers();
 }
 
 } // {Tests}
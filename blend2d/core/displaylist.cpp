@@ -0,0 +1,745 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/array_p.h>
+#include <blend2d/core/displaylist_p.h>
+#include <blend2d/core/object_p.h>
+#include <blend2d/core/path_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/core/var_p.h>
+#include <blend2d/geometry/commons_p.h>
+#include <blend2d/raster/rastercontext_p.h>
+#include <blend2d/support/math_p.h>
+#include <blend2d/support/traits_p.h>
+
+namespace bl {
+namespace DisplayListInternal {
+
+// bl::DisplayList - Globals
+// =========================
+
+static BLObjectEternalImpl<BLDisplayListPrivateImpl> default_impl;
+
+//! Default width and height of tiles used by tiled rendering.
+static constexpr int kDefaultTileSize = 512;
+
+// bl::DisplayList - Internals
+// ===========================
+
+static BL_INLINE BLResult alloc_impl(BLDisplayListCore* self, const BLSize& size) noexcept {
+  BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_DISPLAY_LIST);
+  BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLDisplayListPrivateImpl>(self, info));
+
+  BLDisplayListPrivateImpl* impl = get_impl(self);
+  bl_array_init(&impl->commands, BL_OBJECT_TYPE_ARRAY_UINT64);
+  bl_array_init(&impl->objects, BL_OBJECT_TYPE_ARRAY_OBJECT);
+  bl_array_init(&impl->command_bounds, BL_OBJECT_TYPE_ARRAY_STRUCT_24);
+  impl->size = size;
+  impl->command_count = 0;
+  impl->recording = 0;
+
+  return BL_SUCCESS;
+}
+
+BLResult free_impl(BLDisplayListPrivateImpl* impl) noexcept {
+  bl_array_destroy(&impl->command_bounds);
+  bl_array_destroy(&impl->objects);
+  bl_array_destroy(&impl->commands);
+  return ObjectInternal::free_impl(impl);
+}
+
+BLResult begin_recording(BLDisplayListCore* self, const BLSize& size) noexcept {
+  BLDisplayListCore newO;
+  BL_PROPAGATE(alloc_impl(&newO, size));
+
+  get_impl(&newO)->recording = 1;
+  return replace_instance(self, &newO);
+}
+
+// bl::DisplayList - Replay
+// ========================
+
+struct ArrayViewData {
+  const void* data;
+  size_t size;
+};
+
+static BL_INLINE const BLObjectCore* object_at(const BLVar* objects, uint32_t index) noexcept {
+  return static_cast<const BLObjectCore*>(&objects[index]);
+}
+
+template<typename T>
+static BL_INLINE const T* object_as(const BLVar* objects, uint32_t index) noexcept {
+  return static_cast<const T*>(object_at(objects, index));
+}
+
+// Resets the state of the rendering context to the state of a newly started rendering context, which is the state
+// the display list was recorded with.
+static BLResult reset_to_initial_state(BLContextImpl* ctx_impl) noexcept {
+  const BLContextVirt* virt = ctx_impl->virt;
+
+  BLContextHints hints = make_initial_hints();
+  BLApproximationOptions approximation_options = PathInternal::make_default_approximation_options();
+  BLStrokeOptions stroke_options;
+
+  BL_PROPAGATE(virt->set_hints(ctx_impl, &hints));
+  BL_PROPAGATE(virt->set_approximation_options(ctx_impl, &approximation_options));
+  BL_PROPAGATE(virt->set_stroke_options(ctx_impl, &stroke_options));
+  BL_PROPAGATE(virt->set_comp_op(ctx_impl, BL_COMP_OP_SRC_OVER));
+  BL_PROPAGATE(virt->set_fill_rule(ctx_impl, BL_FILL_RULE_NON_ZERO));
+  BL_PROPAGATE(virt->set_global_alpha(ctx_impl, 1.0));
+  BL_PROPAGATE(virt->set_style_rgba32(ctx_impl, BL_CONTEXT_STYLE_SLOT_FILL, kInitialStyleRgba32));
+  BL_PROPAGATE(virt->set_style_rgba32(ctx_impl, BL_CONTEXT_STYLE_SLOT_STROKE, kInitialStyleRgba32));
+  BL_PROPAGATE(virt->set_style_alpha(ctx_impl, BL_CONTEXT_STYLE_SLOT_FILL, 1.0));
+  BL_PROPAGATE(virt->set_style_alpha(ctx_impl, BL_CONTEXT_STYLE_SLOT_STROKE, 1.0));
+
+  return BL_SUCCESS;
+}
+
+// Dispatches a render call to `FUNC`, `FUNC_rgba32`, or `FUNC_ext` depending on the style kind of the command.
+#define BL_DISPLAY_LIST_CALL_STYLED(FUNC, ...)                                                 \
+  (header.style == StyleKind::kImplicit ? virt->FUNC(ctx_impl, __VA_ARGS__) :                  \
+   header.style == StyleKind::kRgba32   ? virt->FUNC##_rgba32(ctx_impl, __VA_ARGS__, header.value) \
+                                        : virt->FUNC##_ext(ctx_impl, __VA_ARGS__, object_at(objects, header.value)))
+
+static BLResult replay_commands(BLContextImpl* ctx_impl, const BLDisplayListPrivateImpl* impl, const BLBoxI* cull_box) noexcept {
+  const BLContextVirt* virt = ctx_impl->virt;
+
+  const BLArray<uint64_t>& commands = impl->commands.dcast<BLArray<uint64_t>>();
+  const BLVar* objects = impl->objects.dcast<BLArray<BLVar>>().data();
+  const CommandBounds* bounds = impl->command_bounds.dcast<BLArray<CommandBounds>>().data();
+
+  const uint64_t* ptr = commands.begin();
+  const uint64_t* end = commands.end();
+
+  // Replay continues after a failed command (like rendering directly would), but the first error is reported.
+  BLResult result = BL_SUCCESS;
+
+  while (ptr != end) {
+    CommandHeader header;
+    memcpy(&header, ptr, sizeof(CommandHeader));
+
+    // Render commands that cannot change any pixel within `cull_box` are skipped without decoding their payload.
+    if (cull_box && is_render_command(header.id)) {
+      const CommandBounds& command_bounds = *bounds++;
+      if (!Geometry::overlaps(command_bounds.box, *cull_box)) {
+        ptr = commands.data() + command_bounds.end;
+        continue;
+      }
+    }
+
+    CommandReader reader(ptr + 1);
+    BLResult local_result = BL_SUCCESS;
+
+    switch (header.id) {
+      case CommandId::kSave: {
+        local_result = virt->save(ctx_impl, nullptr);
+        break;
+      }
+
+      case CommandId::kRestore: {
+        for (uint32_t i = 0; i < header.value && local_result == BL_SUCCESS; i++)
+          local_result = virt->restore(ctx_impl, nullptr);
+        break;
+      }
+
+      case CommandId::kBeginLayer: {
+        BLRect bounds = reader.read<BLRect>();
+        double alpha = reader.read<double>();
+        local_result = virt->begin_layer(ctx_impl, header.a ? &bounds : nullptr, alpha, BLCompOp(header.value));
+        break;
+      }
+
+      case CommandId::kEndLayer: {
+        local_result = virt->end_layer(ctx_impl);
+        break;
+      }
+
+      case CommandId::kUserToMeta: {
+        local_result = virt->user_to_meta(ctx_impl);
+        break;
+      }
+
+      case CommandId::kResetTransform: {
+        local_result = virt->apply_transform_op(ctx_impl, BL_TRANSFORM_OP_RESET, nullptr);
+        break;
+      }
+
+      case CommandId::kSetTransform: {
+        BLMatrix2D transform = reader.read<BLMatrix2D>();
+        local_result = virt->apply_transform_op(ctx_impl, BL_TRANSFORM_OP_ASSIGN, &transform);
+        break;
+      }
+
+      case CommandId::kSetHints: {
+        BLContextHints hints = reader.read<BLContextHints>();
+        local_result = virt->set_hints(ctx_impl, &hints);
+        break;
+      }
+
+      case CommandId::kSetApproximationOptions: {
+        BLApproximationOptions options = reader.read<BLApproximationOptions>();
+        local_result = virt->set_approximation_options(ctx_impl, &options);
+        break;
+      }
+
+      case CommandId::kSetStrokeOptions: {
+        // The dash array is stored in the object array, the stroke options only borrow it.
+        BLStrokeOptionsCore options;
+        options.hints = reader.read<uint64_t>();
+        options.width = reader.read<double>();
+        options.miter_limit = reader.read<double>();
+        options.dash_offset = reader.read<double>();
+        options.dash_array._d = object_at(objects, header.value)->_d;
+        local_result = virt->set_stroke_options(ctx_impl, &options);
+        break;
+      }
+
+      case CommandId::kSetStyle: {
+        BLContextStyleSlot slot = BLContextStyleSlot(header.a);
+        switch (header.style) {
+          case StyleKind::kRgba32: {
+            local_result = virt->set_style_rgba32(ctx_impl, slot, header.value);
+            break;
+          }
+
+          case StyleKind::kRgba64: {
+            local_result = virt->set_style_rgba64(ctx_impl, slot, reader.read<uint64_t>());
+            break;
+          }
+
+          case StyleKind::kRgba: {
+            BLRgba rgba = reader.read<BLRgba>();
+            local_result = virt->set_style_rgba(ctx_impl, slot, &rgba);
+            break;
+          }
+
+          default: {
+            local_result = virt->set_style(ctx_impl, slot, object_at(objects, header.value), BLContextStyleTransformMode(header.b));
+            break;
+          }
+        }
+        break;
+      }
+
+      case CommandId::kDisableStyle: {
+        local_result = virt->disable_style(ctx_impl, BLContextStyleSlot(header.a));
+        break;
+      }
+
+      case CommandId::kSetStyleAlpha: {
+        local_result = virt->set_style_alpha(ctx_impl, BLContextStyleSlot(header.a), reader.read<double>());
+        break;
+      }
+
+      case CommandId::kSwapStyles: {
+        local_result = virt->swap_styles(ctx_impl, BLContextStyleSwapMode(header.value));
+        break;
+      }
+
+      case CommandId::kSetGlobalAlpha: {
+        local_result = virt->set_global_alpha(ctx_impl, reader.read<double>());
+        break;
+      }
+
+      case CommandId::kSetCompOp: {
+        local_result = virt->set_comp_op(ctx_impl, BLCompOp(header.value));
+        break;
+      }
+
+      case CommandId::kSetFillRule: {
+        local_result = virt->set_fill_rule(ctx_impl, BLFillRule(header.value));
+        break;
+      }
+
+      case CommandId::kClipToRectI: {
+        BLRectI rect = reader.read<BLRectI>();
+        local_result = virt->clip_to_rect_i(ctx_impl, &rect);
+        break;
+      }
+
+      case CommandId::kClipToRectD: {
+        BLRect rect = reader.read<BLRect>();
+        local_result = virt->clip_to_rect_d(ctx_impl, &rect);
+        break;
+      }
+
+      case CommandId::kRestoreClipping: {
+        local_result = virt->restore_clipping(ctx_impl);
+        break;
+      }
+
+      case CommandId::kClearAll: {
+        local_result = virt->clear_all(ctx_impl);
+        break;
+      }
+
+      case CommandId::kClearRectI: {
+        BLRectI rect = reader.read<BLRectI>();
+        local_result = virt->clear_recti(ctx_impl, &rect);
+        break;
+      }
+
+      case CommandId::kClearRectD: {
+        BLRect rect = reader.read<BLRect>();
+        local_result = virt->clear_rectd(ctx_impl, &rect);
+        break;
+      }
+
+      case CommandId::kFillAll: {
+        if (header.style == StyleKind::kImplicit)
+          local_result = virt->fill_all(ctx_impl);
+        else if (header.style == StyleKind::kRgba32)
+          local_result = virt->fill_all_rgba32(ctx_impl, header.value);
+        else
+          local_result = virt->fill_all_ext(ctx_impl, object_at(objects, header.value));
+        break;
+      }
+
+      case CommandId::kFillRectI: {
+        BLRectI rect = reader.read<BLRectI>();
+        local_result = BL_DISPLAY_LIST_CALL_STYLED(fill_rect_i, &rect);
+        break;
+      }
+
+      case CommandId::kFillRectD: {
+        BLRect rect = reader.read<BLRect>();
+        local_result = BL_DISPLAY_LIST_CALL_STYLED(fill_rect_d, &rect);
+        break;
+      }
+
+      case CommandId::kFillPath:
+      case CommandId::kStrokePath: {
+        BLPoint origin = reader.read<BLPoint>();
+        const BLPathCore* path = object_as<BLPathCore>(objects, reader.read<uint32_t>());
+
+        if (header.id == CommandId::kFillPath)
+          local_result = BL_DISPLAY_LIST_CALL_STYLED(fill_path_d, &origin, path);
+        else
+          local_result = BL_DISPLAY_LIST_CALL_STYLED(stroke_path_d, &origin, path);
+        break;
+      }
+
+      case CommandId::kClipToGeometry:
+      case CommandId::kFillGeometry:
+      case CommandId::kStrokeGeometry: {
+        BLGeometryType type = BLGeometryType(header.a);
+        ArrayViewData view {};
+        const void* data;
+
+        if (type == BL_GEOMETRY_TYPE_PATH) {
+          data = object_at(objects, reader.read<uint32_t>());
+        }
+        else if (type <= BL_GEOMETRY_TYPE_SIMPLE_LAST) {
+          data = reader.read_data(Geometry::geometry_type_size_table[type]);
+        }
+        else {
+          // Polylines and polygons are stored inline as `count` followed by points.
+          bool is_int = type == BL_GEOMETRY_TYPE_POLYLINEI || type == BL_GEOMETRY_TYPE_POLYGONI;
+          view.size = reader.read<size_t>();
+          view.data = reader.read_data(view.size * (is_int ? sizeof(BLPointI) : sizeof(BLPoint)));
+          data = &view;
+        }
+
+        if (header.id == CommandId::kClipToGeometry)
+          local_result = virt->clip_to_geometry(ctx_impl, type, data);
+        else if (header.id == CommandId::kFillGeometry)
+          local_result = BL_DISPLAY_LIST_CALL_STYLED(fill_geometry, type, data);
+        else
+          local_result = BL_DISPLAY_LIST_CALL_STYLED(stroke_geometry, type, data);
+        break;
+      }
+
+      case CommandId::kFillGlyphRun:
+      case CommandId::kStrokeGlyphRun: {
+        GlyphRunPayload payload = reader.read<GlyphRunPayload>();
+        const BLFontCore* font = object_as<BLFontCore>(objects, payload.font_index);
+
+        BLGlyphRun glyph_run {};
+        glyph_run.size = payload.size;
+        glyph_run.placement_type = uint8_t(payload.placement_type);
+        glyph_run.flags = payload.flags;
+        glyph_run.set_glyph_data(reader.read_data(payload.size * sizeof(uint32_t)), intptr_t(sizeof(uint32_t)));
+
+        if (payload.placement_type != BL_GLYPH_PLACEMENT_TYPE_NONE)
+          glyph_run.set_placement_data(reader.read_data(payload.size * sizeof(BLPoint)), intptr_t(sizeof(BLPoint)));
+
+        const BLPoint* origin = &payload.origin;
+        if (header.id == CommandId::kFillGlyphRun)
+          local_result = BL_DISPLAY_LIST_CALL_STYLED(fill_text_op_d, origin, font, BL_CONTEXT_RENDER_TEXT_OP_GLYPH_RUN, &glyph_run);
+        else
+          local_result = BL_DISPLAY_LIST_CALL_STYLED(stroke_text_op_d, origin, font, BL_CONTEXT_RENDER_TEXT_OP_GLYPH_RUN, &glyph_run);
+        break;
+      }
+
+      case CommandId::kFillMaskI: {
+        BLPointI origin = reader.read<BLPointI>();
+        const BLImageCore* mask = object_as<BLImageCore>(objects, reader.read<uint32_t>());
+
+        BLRectI area;
+        const BLRectI* area_ptr = nullptr;
+
+        if (header.b) {
+          area = reader.read<BLRectI>();
+          area_ptr = &area;
+        }
+
+        local_result = BL_DISPLAY_LIST_CALL_STYLED(fill_mask_i, &origin, mask, area_ptr);
+        break;
+      }
+
+      case CommandId::kFillMaskD: {
+        BLPoint origin = reader.read<BLPoint>();
+        const BLImageCore* mask = object_as<BLImageCore>(objects, reader.read<uint32_t>());
+
+        BLRectI area;
+        const BLRectI* area_ptr = nullptr;
+
+        if (header.b) {
+          area = reader.read<BLRectI>();
+          area_ptr = &area;
+        }
+
+        if (header.style == StyleKind::kImplicit)
+          local_result = virt->fill_mask_d(ctx_impl, &origin, mask, area_ptr);
+        else if (header.style == StyleKind::kRgba32)
+          local_result = virt->fill_mask_d_Rgba32(ctx_impl, &origin, mask, area_ptr, header.value);
+        else
+          local_result = virt->fill_mask_d_ext(ctx_impl, &origin, mask, area_ptr, object_at(objects, header.value));
+        break;
+      }
+
+      case CommandId::kBlitImageI:
+      case CommandId::kBlitImageD:
+      case CommandId::kBlitScaledImageI:
+      case CommandId::kBlitScaledImageD: {
+        // All blit commands store a destination (point or rectangle) first, then an image index and an optional area.
+        const void* dst = reader.read_data(header.value);
+        const BLImageCore* image = object_as<BLImageCore>(objects, reader.read<uint32_t>());
+
+        BLRectI area;
+        const BLRectI* area_ptr = nullptr;
+
+        if (header.b) {
+          area = reader.read<BLRectI>();
+          area_ptr = &area;
+        }
+
+        switch (header.id) {
+          case CommandId::kBlitImageI:
+            local_result = virt->blit_image_i(ctx_impl, static_cast<const BLPointI*>(dst), image, area_ptr);
+            break;
+
+          case CommandId::kBlitImageD:
+            local_result = virt->blit_image_d(ctx_impl, static_cast<const BLPoint*>(dst), image, area_ptr);
+            break;
+
+          case CommandId::kBlitScaledImageI:
+            local_result = virt->blit_scaled_image_i(ctx_impl, static_cast<const BLRectI*>(dst), image, area_ptr);
+            break;
+
+          default:
+            local_result = virt->blit_scaled_image_d(ctx_impl, static_cast<const BLRect*>(dst), image, area_ptr);
+            break;
+        }
+        break;
+      }
+
+      default: {
+        BL_NOT_REACHED();
+      }
+    }
+
+    if (BL_UNLIKELY(local_result != BL_SUCCESS && result == BL_SUCCESS))
+      result = local_result;
+
+    ptr = reader._ptr;
+  }
+
+  return result;
+}
+
+#undef BL_DISPLAY_LIST_CALL_STYLED
+
+BLResult replay(const BLDisplayListCore* self, BLContextCore* ctx, const BLMatrix2D* transform, const BLBoxI* cull_box) noexcept {
+  const BLDisplayListPrivateImpl* impl = get_impl(self);
+
+  if (BL_UNLIKELY(impl->recording))
+    return bl_make_error(BL_ERROR_BUSY);
+
+  if (!impl->command_count)
+    return BL_SUCCESS;
+
+  BLContextImpl* ctx_impl = ctx->_impl();
+  const BLContextVirt* virt = ctx_impl->virt;
+
+  // The whole replay is enclosed in a saved state, so the state of the rendering context is not changed by it, and
+  // the current user transformation (combined with `transform`) becomes the meta transformation of the display list.
+  BLContextCookie cookie;
+  BL_PROPAGATE(virt->save(ctx_impl, &cookie));
+
+  BLResult result = BL_SUCCESS;
+  if (transform)
+    result = virt->apply_transform_op(ctx_impl, BL_TRANSFORM_OP_TRANSFORM, transform);
+
+  if (result == BL_SUCCESS)
+    result = virt->user_to_meta(ctx_impl);
+
+  if (result == BL_SUCCESS)
+    result = reset_to_initial_state(ctx_impl);
+
+  if (result == BL_SUCCESS)
+    result = replay_commands(ctx_impl, impl, cull_box);
+
+  BLResult restore_result = virt->restore(ctx_impl, &cookie);
+  return result != BL_SUCCESS ? result : restore_result;
+}
+
+} // {DisplayListInternal}
+} // {bl}
+
+// bl::DisplayList - API - Init & Destroy
+// ======================================
+
+BL_API_IMPL BLResult bl_display_list_init(BLDisplayListCore* self) noexcept {
+  self->_d = bl_object_defaults[BL_OBJECT_TYPE_DISPLAY_LIST]._d;
+  return BL_SUCCESS;
+}
+
+BL_API_IMPL BLResult bl_display_list_init_move(BLDisplayListCore* self, BLDisplayListCore* other) noexcept {
+  BL_ASSERT(self != other);
+  BL_ASSERT(other->_d.is_display_list());
+
+  self->_d = other->_d;
+  other->_d = bl_object_defaults[BL_OBJECT_TYPE_DISPLAY_LIST]._d;
+
+  return BL_SUCCESS;
+}
+
+BL_API_IMPL BLResult bl_display_list_init_weak(BLDisplayListCore* self, const BLDisplayListCore* other) noexcept {
+  using namespace bl::DisplayListInternal;
+
+  BL_ASSERT(self != other);
+  BL_ASSERT(other->_d.is_display_list());
+
+  self->_d = other->_d;
+  return retain_instance(self);
+}
+
+BL_API_IMPL BLResult bl_display_list_destroy(BLDisplayListCore* self) noexcept {
+  using namespace bl::DisplayListInternal;
+  BL_ASSERT(self->_d.is_display_list());
+
+  return release_instance(self);
+}
+
+// bl::DisplayList - API - Reset
+// =============================
+
+BL_API_IMPL BLResult bl_display_list_reset(BLDisplayListCore* self) noexcept {
+  using namespace bl::DisplayListInternal;
+  BL_ASSERT(self->_d.is_display_list());
+
+  return replace_instance(self, static_cast<BLDisplayListCore*>(&bl_object_defaults[BL_OBJECT_TYPE_DISPLAY_LIST]));
+}
+
+// bl::DisplayList - API - Assign
+// ==============================
+
+BL_API_IMPL BLResult bl_display_list_assign_move(BLDisplayListCore* self, BLDisplayListCore* other) noexcept {
+  using namespace bl::DisplayListInternal;
+
+  BL_ASSERT(self->_d.is_display_list());
+  BL_ASSERT(other->_d.is_display_list());
+
+  BLDisplayListCore tmp = *other;
+  other->_d = bl_object_defaults[BL_OBJECT_TYPE_DISPLAY_LIST]._d;
+  return replace_instance(self, &tmp);
+}
+
+BL_API_IMPL BLResult bl_display_list_assign_weak(BLDisplayListCore* self, const BLDisplayListCore* other) noexcept {
+  using namespace bl::DisplayListInternal;
+
+  BL_ASSERT(self->_d.is_display_list());
+  BL_ASSERT(other->_d.is_display_list());
+
+  retain_instance(other);
+  return replace_instance(self, other);
+}
+
+// bl::DisplayList - API - Accessors
+// =================================
+
+BL_API_IMPL bool bl_display_list_is_recording(const BLDisplayListCore* self) noexcept {
+  using namespace bl::DisplayListInternal;
+  BL_ASSERT(self->_d.is_display_list());
+
+  return get_impl(self)->recording != 0;
+}
+
+BL_API_IMPL BLResult bl_display_list_get_size(const BLDisplayListCore* self, BLSize* size_out) noexcept {
+  using namespace bl::DisplayListInternal;
+  BL_ASSERT(self->_d.is_display_list());
+
+  *size_out = get_impl(self)->size;
+  return BL_SUCCESS;
+}
+
+BL_API_IMPL size_t bl_display_list_get_command_count(const BLDisplayListCore* self) noexcept {
+  using namespace bl::DisplayListInternal;
+  BL_ASSERT(self->_d.is_display_list());
+
+  return get_impl(self)->command_count;
+}
+
+// bl::DisplayList - API - Equality & Comparison
+// =============================================
+
+BL_API_IMPL bool bl_display_list_equals(const BLDisplayListCore* a, const BLDisplayListCore* b) noexcept {
+  BL_ASSERT(a->_d.is_display_list());
+  BL_ASSERT(b->_d.is_display_list());
+
+  return a->_d.impl == b->_d.impl;
+}
+
+// bl::DisplayList - API - Tiled Rendering
+// ========================================
+
+BL_API_IMPL BLResult bl_display_list_render_tiles(const BLDisplayListCore* self, const BLDisplayListTileInfo* info, BLDisplayListTileFunc acquire_func, BLDisplayListTileFunc release_func, void* user_data) noexcept {
+  using namespace bl::DisplayListInternal;
+  BL_ASSERT(self->_d.is_display_list());
+
+  const BLDisplayListPrivateImpl* self_impl = get_impl(self);
+
+  if (BL_UNLIKELY(!release_func))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  if (BL_UNLIKELY(self_impl->recording))
+    return bl_make_error(BL_ERROR_BUSY);
+
+  BLDisplayListTileInfo tile_info {};
+  if (info)
+    tile_info = *info;
+
+  int tile_w = tile_info.tile_size.w ? tile_info.tile_size.w : kDefaultTileSize;
+  int tile_h = tile_info.tile_size.h ? tile_info.tile_size.h : kDefaultTileSize;
+  BLFormat format = tile_info.format ? BLFormat(tile_info.format) : BL_FORMAT_PRGB32;
+
+  if (BL_UNLIKELY(tile_w < 0 || tile_w > int(BL_RUNTIME_MAX_IMAGE_SIZE) ||
+                  tile_h < 0 || tile_h > int(BL_RUNTIME_MAX_IMAGE_SIZE) ||
+                  uint32_t(format) > BL_FORMAT_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  // The rendered area is not limited by the maximum image size as it's never allocated as a whole.
+  double area_w = bl::Math::ceil(self_impl->size.w);
+  double area_h = bl::Math::ceil(self_impl->size.h);
+
+  if (BL_UNLIKELY(!(area_w <= double(bl::Traits::max_value<int>()) && area_h <= double(bl::Traits::max_value<int>()))))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  int target_w = int(area_w);
+  int target_h = int(area_h);
+
+  BLContextCreateInfo create_info {};
+  create_info.thread_count = tile_info.thread_count;
+
+  // Tile image owned by the renderer, allocated on demand and reused by all tiles.
+  BLImage own_tile;
+  BLImageData own_data {};
+
+  // Rendering context is reused by all tiles that use the same target image, which is always the case of tiles owned
+  // by the renderer. This avoids creating a rendering context (and acquiring its worker threads) for each tile.
+  BLContext ctx;
+  BLImage ctx_target;
+
+  for (int y = 0; y < target_h; y += tile_h) {
+    for (int x = 0; x < target_w; x += tile_w) {
+      BLRectI tile_rect(x, y, bl_min(tile_w, target_w - x), bl_min(tile_h, target_h - y));
+      BLImage tile;
+
+      if (acquire_func)
+        BL_PROPAGATE(acquire_func(&tile, &tile_rect, user_data));
+
+      bool is_own_tile = tile.is_empty();
+      if (is_own_tile) {
+        // The whole tile image is made mutable before a rendering context refers to it, otherwise it would be copied.
+        if (own_tile.is_empty()) {
+          BL_PROPAGATE(own_tile.create(tile_w, tile_h, format));
+          BL_PROPAGATE(own_tile.make_mutable(&own_data));
+        }
+
+        // Tiles at the right and bottom edges use only a part of the tile image.
+        BL_PROPAGATE(tile.create_from_data(tile_rect.w, tile_rect.h, format, own_data.pixel_data, own_data.stride));
+      }
+      else if (BL_UNLIKELY(tile.width() < tile_rect.w || tile.height() < tile_rect.h)) {
+        return bl_make_error(BL_ERROR_INVALID_VALUE);
+      }
+
+      BLImage& target = is_own_tile ? own_tile : tile;
+      if (ctx_target._d.impl != target._d.impl) {
+        if (!ctx_target.is_empty())
+          BL_PROPAGATE(ctx.end());
+
+        // Pixel origin keeps effects that depend on pixel coordinates (like dithering) continuous across tiles.
+        create_info.pixel_origin.reset(x, y);
+
+        BL_PROPAGATE(ctx.begin(target, create_info));
+        ctx_target = target;
+      }
+      else {
+        BL_PROPAGATE(bl_raster_context_set_pixel_origin(&ctx, BLPointI(x, y)));
+      }
+
+      BLResult result = ctx.save();
+      if (result == BL_SUCCESS) {
+        if (is_own_tile)
+          ctx.clear_all();
+
+        if (target.width() != tile_rect.w || target.height() != tile_rect.h)
+          ctx.clip_to_rect(BLRectI(0, 0, tile_rect.w, tile_rect.h));
+
+        // Commands that don't overlap the tile cannot change its pixels, so they are culled.
+        BLBoxI cull_box(x, y, x + tile_rect.w, y + tile_rect.h);
+        BLMatrix2D transform = BLMatrix2D::make_translation(-double(x), -double(y));
+
+        result = replay(self, &ctx, &transform, &cull_box);
+        BLResult restore_result = ctx.restore();
+
+        if (result == BL_SUCCESS)
+          result = restore_result;
+      }
+
+      // Pixels of the tile must be final before it's released.
+      BLResult flush_result = ctx.flush(BL_CONTEXT_FLUSH_SYNC);
+
+      BL_PROPAGATE(result);
+      BL_PROPAGATE(flush_result);
+      BL_PROPAGATE(release_func(&tile, &tile_rect, user_data));
+    }
+  }
+
+  if (!ctx_target.is_empty())
+    BL_PROPAGATE(ctx.end());
+
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - Runtime Registration
+// ======================================
+
+void bl_display_list_rt_init(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+
+  BLDisplayListPrivateImpl* impl = &bl::DisplayListInternal::default_impl.impl;
+  bl_array_init(&impl->commands, BL_OBJECT_TYPE_ARRAY_UINT64);
+  bl_array_init(&impl->objects, BL_OBJECT_TYPE_ARRAY_OBJECT);
+  bl_array_init(&impl->command_bounds, BL_OBJECT_TYPE_ARRAY_STRUCT_24);
+  impl->size.reset();
+
+  bl_object_defaults[BL_OBJECT_TYPE_DISPLAY_LIST]._d.init_dynamic(
+    BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_DISPLAY_LIST),
+    &bl::DisplayListInternal::default_impl.impl);
+}
@@ -0,0 +1,242 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_DISPLAYLIST_H_INCLUDED
+#define BLEND2D_DISPLAYLIST_H_INCLUDED
+
+#include <blend2d/core/array.h>
+#include <blend2d/core/geometry.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/object.h>
+
+//! \addtogroup bl_c_api
+//! \{
+
+//! \name BLDisplayList - C API
+//! \{
+
+//! Tile callback used by \ref bl_display_list_render_tiles().
+//!
+//! The callback receives a `tile` image and `tile_rect`, which describes the area of the display list that is (or
+//! will be) rendered into the top-left corner of the tile.
+typedef BLResult (BL_CDECL* BLDisplayListTileFunc)(BLImageCore* tile, const BLRectI* tile_rect, void* user_data) BL_NOEXCEPT_C;
+
+//! Options that can be used to customize tiled rendering of a display list.
+struct BLDisplayListTileInfo {
+  //! Size of a tile (zero width or height means the default tile size, which is 512x512 pixels).
+  //!
+  //! Tiles that are narrow enough keep the whole band storage of the rendering context in CPU cache.
+  BLSizeI tile_size;
+  //! Pixel format of tiles allocated by the renderer, \ref BL_FORMAT_NONE means \ref BL_FORMAT_PRGB32.
+  uint32_t format;
+  //! Number of threads used to render each tile, see \ref BLContextCreateInfo::thread_count.
+  uint32_t thread_count;
+
+#ifdef __cplusplus
+  BL_INLINE_NODEBUG void reset() noexcept { *this = BLDisplayListTileInfo{}; }
+#endif
+};
+
+//! Display list [C API].
+struct BLDisplayListCore BL_CLASS_INHERITS(BLObjectCore) {
+  BL_DEFINE_OBJECT_DETAIL
+  BL_DEFINE_OBJECT_DCAST(BLDisplayList)
+};
+
+//! \cond INTERNAL
+//! Display list [C API Impl].
+struct BLDisplayListImpl BL_CLASS_INHERITS(BLObjectImpl) {
+  //! Recorded commands (an array of 64-bit words).
+  BLArrayCore commands;
+  //! Objects referenced by recorded commands (paths, images, fonts, styles, and dash arrays).
+  BLArrayCore objects;
+  //! Size of the recording area, see \ref BLContext::begin(BLDisplayList&, const BLSize&).
+  BLSize size;
+  //! Number of recorded commands.
+  size_t command_count;
+};
+//! \endcond
+
+BL_BEGIN_C_DECLS
+
+BL_API BLResult BL_CDECL bl_display_list_init(BLDisplayListCore* self) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_init_move(BLDisplayListCore* self, BLDisplayListCore* other) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_init_weak(BLDisplayListCore* self, const BLDisplayListCore* other) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_destroy(BLDisplayListCore* self) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_reset(BLDisplayListCore* self) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_assign_move(BLDisplayListCore* self, BLDisplayListCore* other) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_assign_weak(BLDisplayListCore* self, const BLDisplayListCore* other) BL_NOEXCEPT_C;
+BL_API bool BL_CDECL bl_display_list_is_recording(const BLDisplayListCore* self) BL_NOEXCEPT_C BL_PURE;
+BL_API BLResult BL_CDECL bl_display_list_get_size(const BLDisplayListCore* self, BLSize* size_out) BL_NOEXCEPT_C;
+BL_API size_t BL_CDECL bl_display_list_get_command_count(const BLDisplayListCore* self) BL_NOEXCEPT_C BL_PURE;
+BL_API bool BL_CDECL bl_display_list_equals(const BLDisplayListCore* a, const BLDisplayListCore* b) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_display_list_render_tiles(const BLDisplayListCore* self, const BLDisplayListTileInfo* info, BLDisplayListTileFunc acquire_func, BLDisplayListTileFunc release_func, void* user_data) BL_NOEXCEPT_C;
+
+BL_END_C_DECLS
+
+//! \}
+//! \}
+
+//! \addtogroup bl_rendering
+//! \{
+
+//! \name BLDisplayList - C++ API
+//! \{
+#ifdef __cplusplus
+
+//! Display list [C++ API].
+//!
+//! Display list is an immutable sequence of rendering commands recorded by a \ref BLContext, which was started by
+//! \ref BLContext::begin(BLDisplayList&, const BLSize&). Recording captures render calls, styles, and the rendering
+//! context state (transformations, stroke options, clipping, saved states) in a compact form. All arguments are
+//! validated and all referenced objects are retained during recording, text is shaped to glyph runs, and geometries
+//! that would be converted to a path by each render call are converted once.
+//!
+//! When the recording ends (by \ref BLContext::end()) the display list becomes immutable and can be replayed by
+//! \ref BLContext::replay() into any rendering context any number of times, optionally with a transformation. Since
+//! replaying only reads the display list it's possible to replay a single display list into multiple rendering
+//! contexts concurrently.
+class BLDisplayList final : public BLDisplayListCore {
+public:
+  //! \cond INTERNAL
+
+  //! Object info values of a default constructed BLDisplayList.
+  static inline constexpr uint32_t kDefaultSignature =
+    BLObjectInfo::pack_type_with_marker(BL_OBJECT_TYPE_DISPLAY_LIST) | BL_OBJECT_INFO_D_FLAG;
+
+  [[nodiscard]]
+  BL_INLINE_NODEBUG BLDisplayListImpl* _impl() const noexcept { return static_cast<BLDisplayListImpl*>(_d.impl); }
+
+  //! \endcond
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE BLDisplayList() noexcept {
+    bl_display_list_init(this);
+
+    // Assume a default constructed BLDisplayList.
+    BL_ASSUME(_d.info.bits == kDefaultSignature);
+  }
+
+  BL_INLINE BLDisplayList(BLDisplayList&& other) noexcept {
+    bl_display_list_init_move(this, &other);
+
+    // Assume a default initialized `other`.
+    BL_ASSUME(other._d.info.bits == kDefaultSignature);
+  }
+
+  BL_INLINE BLDisplayList(const BLDisplayList& other) noexcept {
+    bl_display_list_init_weak(this, &other);
+  }
+
+  BL_INLINE ~BLDisplayList() noexcept {
+    if (BLInternal::object_needs_cleanup(_d.info.bits)) {
+      bl_display_list_destroy(this);
+    }
+  }
+
+  //! \}
+
+  //! \name Overloaded Operators
+  //! \{
+
+  BL_INLINE BLDisplayList& operator=(BLDisplayList&& other) noexcept { bl_display_list_assign_move(this, &other); return *this; }
+  BL_INLINE BLDisplayList& operator=(const BLDisplayList& other) noexcept { bl_display_list_assign_weak(this, &other); return *this; }
+
+  [[nodiscard]]
+  BL_INLINE bool operator==(const BLDisplayList& other) const noexcept { return  equals(other); }
+
+  [[nodiscard]]
+  BL_INLINE bool operator!=(const BLDisplayList& other) const noexcept { return !equals(other); }
+
+  //! \}
+
+  //! \name Common Functionality
+  //! \{
+
+  BL_INLINE BLResult reset() noexcept {
+    BLResult result = bl_display_list_reset(this);
+
+    // Reset operation always succeeds.
+    BL_ASSUME(result == BL_SUCCESS);
+    // Assume a default constructed BLDisplayList after reset.
+    BL_ASSUME(_d.info.bits == kDefaultSignature);
+
+    return result;
+  }
+
+  BL_INLINE void swap(BLDisplayList& other) noexcept { _d.swap(other._d); }
+
+  BL_INLINE BLResult assign(BLDisplayList&& other) noexcept { return bl_display_list_assign_move(this, &other); }
+  BL_INLINE BLResult assign(const BLDisplayList& other) noexcept { return bl_display_list_assign_weak(this, &other); }
+
+  //! Tests whether the display list is identical to `other` (display lists are compared by identity as their
+  //! content is immutable).
+  [[nodiscard]]
+  BL_INLINE bool equals(const BLDisplayList& other) const noexcept { return bl_display_list_equals(this, &other); }
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  //! Tests whether the display list is empty (has no recorded commands).
+  [[nodiscard]]
+  BL_INLINE bool is_empty() const noexcept { return command_count() == 0; }
+
+  //! Tests whether the display list is being recorded by a rendering context - such display list cannot be replayed.
+  [[nodiscard]]
+  BL_INLINE bool is_recording() const noexcept { return bl_display_list_is_recording(this); }
+
+  //! Returns the size of the recording area passed to \ref BLContext::begin(BLDisplayList&, const BLSize&).
+  [[nodiscard]]
+  BL_INLINE BLSize size() const noexcept {
+    BLSize size_out;
+    bl_display_list_get_size(this, &size_out);
+    return size_out;
+  }
+
+  //! Returns the number of recorded commands.
+  [[nodiscard]]
+  BL_INLINE size_t command_count() const noexcept { return bl_display_list_get_command_count(this); }
+
+  //! \}
+
+  //! \name Tiled Rendering
+  //! \{
+
+  //! Renders the display list tile by tile and passes each rendered tile to `release_func`.
+  //!
+  //! The rendered area starts at [0, 0] and covers \ref size() rounded up to whole pixels. Tiles are rendered in
+  //! row-major order, and tiles at the right and bottom edges are clipped to the rendered area. Tiles are rendered
+  //! into a tile image allocated by the renderer, which is cleared before rendering and reused by subsequent tiles
+  //! (together with its rendering context) - its content is only valid during `release_func` call. This makes it
+  //! possible to render and stream images much larger than what would fit into memory as a single \ref BLImage.
+  //!
+  //! Render commands that don't overlap a tile are skipped when rendering that tile.
+  BL_INLINE BLResult render_tiles(const BLDisplayListTileInfo& info, BLDisplayListTileFunc release_func, void* user_data) const noexcept {
+    return bl_display_list_render_tiles(this, &info, nullptr, release_func, user_data);
+  }
+
+  //! \overload
+  //!
+  //! Tiles are first pulled from `acquire_func`, which can assign an image of at least the tile size to `tile` (for
+  //! example from a tile cache). Such tiles are not cleared before rendering. If `acquire_func` keeps `tile` empty the
+  //! renderer uses its own tile image instead. A rendering context is only reused by consecutive tiles that share the
+  //! same image, the renderer keeps a reference to such image until the next tile uses a different one.
+  BL_INLINE BLResult render_tiles(const BLDisplayListTileInfo& info, BLDisplayListTileFunc acquire_func, BLDisplayListTileFunc release_func, void* user_data) const noexcept {
+    return bl_display_list_render_tiles(this, &info, acquire_func, release_func, user_data);
+  }
+
+  //! \}
+};
+
+#endif
+//! \}
+
+//! \}
+
+#endif // BLEND2D_DISPLAYLIST_H_INCLUDED
@@ -0,0 +1,284 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_DISPLAYLIST_P_H_INCLUDED
+#define BLEND2D_DISPLAYLIST_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/array_p.h>
+#include <blend2d/core/context.h>
+#include <blend2d/core/displaylist.h>
+#include <blend2d/core/object_p.h>
+#include <blend2d/support/traits_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+//! \name BLDisplayList - Private Structs
+//! \{
+
+//! Private implementation that extends \ref BLDisplayListImpl.
+struct BLDisplayListPrivateImpl : public BLDisplayListImpl {
+  //! Bounds of render commands, see \ref bl::DisplayListInternal::CommandBounds.
+  BLArrayCore command_bounds;
+  //! Non-zero while the display list is being recorded by a rendering context.
+  uint32_t recording;
+};
+
+//! \}
+
+namespace bl {
+namespace DisplayListInternal {
+
+//! \name BLDisplayList - Internals - Commands
+//! \{
+
+//! Command identifier.
+//!
+//! Each command starts with a 64-bit \ref CommandHeader followed by a payload, which is always aligned to 64-bit
+//! words. Payloads are written by \ref CommandWriter and read by \ref CommandReader in the same order.
+enum class CommandId : uint8_t {
+  kSave,
+  kRestore,
+  kBeginLayer,
+  kEndLayer,
+  kUserToMeta,
+  kResetTransform,
+  kSetTransform,
+
+  kSetHints,
+  kSetApproximationOptions,
+  kSetStrokeOptions,
+
+  kSetStyle,
+  kDisableStyle,
+  kSetStyleAlpha,
+  kSwapStyles,
+  kSetGlobalAlpha,
+  kSetCompOp,
+  kSetFillRule,
+
+  kClipToRectI,
+  kClipToRectD,
+  kRestoreClipping,
+  kClipToGeometry,
+
+  kClearAll,
+  kClearRectI,
+  kClearRectD,
+
+  kFillAll,
+  kFillRectI,
+  kFillRectD,
+  kFillPath,
+  kFillGeometry,
+  kFillGlyphRun,
+  kFillMaskI,
+  kFillMaskD,
+
+  kStrokePath,
+  kStrokeGeometry,
+  kStrokeGlyphRun,
+
+  kBlitImageI,
+  kBlitImageD,
+  kBlitScaledImageI,
+  kBlitScaledImageD
+};
+
+//! Describes how a style is stored in \ref CommandHeader::value.
+enum class StyleKind : uint8_t {
+  //! Render command uses the current style of the rendering context (no value).
+  kImplicit,
+  //! Style is a 32-bit RGBA color stored in \ref CommandHeader::value.
+  kRgba32,
+  //! Style is a 64-bit RGBA color stored in the payload (\ref CommandId::kSetStyle only).
+  kRgba64,
+  //! Style is a floating point RGBA color stored in the payload (\ref CommandId::kSetStyle only).
+  kRgba,
+  //! Style is an object (or a \ref BLVar) stored in the object array, \ref CommandHeader::value is its index.
+  kObject
+};
+
+//! Header of each recorded command.
+struct CommandHeader {
+  //! Command identifier, see \ref CommandId.
+  CommandId id;
+  //! Style kind, see \ref StyleKind.
+  StyleKind style;
+  //! Command specific argument (style slot, geometry type, hint, etc...).
+  uint8_t a;
+  //! Command specific argument (style transform mode, whether an area is present, etc...).
+  uint8_t b;
+  //! Either a 32-bit RGBA color, index of a style object, or a command specific 32-bit value.
+  uint32_t value;
+};
+
+static_assert(sizeof(CommandHeader) == sizeof(uint64_t), "CommandHeader must be exactly one 64-bit word");
+
+//! Returns the number of 64-bit words required to store `size` bytes.
+static BL_INLINE constexpr size_t word_count_of(size_t size) noexcept { return (size + sizeof(uint64_t) - 1u) / sizeof(uint64_t); }
+
+//! Writes command payload into 64-bit words.
+class CommandWriter {
+public:
+  uint64_t* _ptr;
+
+  BL_INLINE explicit CommandWriter(uint64_t* ptr) noexcept
+    : _ptr(ptr) {}
+
+  template<typename T>
+  BL_INLINE void write(const T& value) noexcept { write_data(&value, sizeof(T)); }
+
+  BL_INLINE void write_data(const void* data, size_t size) noexcept {
+    if (size)
+      memcpy(reserve_data(size), data, size);
+  }
+
+  //! Returns a pointer to `size` bytes of payload to be filled by the caller and skips them.
+  BL_INLINE void* reserve_data(size_t size) noexcept {
+    void* data = _ptr;
+    if (size) {
+      // Clear the last word so the padding is deterministic.
+      _ptr[word_count_of(size) - 1u] = 0u;
+      _ptr += word_count_of(size);
+    }
+    return data;
+  }
+};
+
+//! Reads command payload written by \ref CommandWriter.
+class CommandReader {
+public:
+  const uint64_t* _ptr;
+
+  BL_INLINE explicit CommandReader(const uint64_t* ptr) noexcept
+    : _ptr(ptr) {}
+
+  template<typename T>
+  BL_INLINE T read() noexcept {
+    T value;
+    memcpy(&value, _ptr, sizeof(T));
+    _ptr += word_count_of(sizeof(T));
+    return value;
+  }
+
+  //! Returns a pointer to `size` bytes of inline data and skips them.
+  BL_INLINE const void* read_data(size_t size) noexcept {
+    const void* data = _ptr;
+    _ptr += word_count_of(size);
+    return data;
+  }
+};
+
+//! Payload of glyph-run commands, followed by glyph ids (`uint32_t[size]`) and optionally by glyph placements
+//! (16 bytes per glyph, either \ref BLGlyphPlacement or \ref BLPoint depending on `placement_type`).
+struct GlyphRunPayload {
+  BLPoint origin;
+  uint32_t font_index;
+  uint32_t size;
+  uint32_t placement_type;
+  uint32_t flags;
+};
+
+//! Bounds of a render command (\ref CommandId::kClearAll and all commands that follow it).
+//!
+//! Bounds are recorded for each render command in recording order and are used by tiled rendering to skip commands
+//! that cannot change pixels of a tile. State commands have no bounds as they must always be replayed.
+struct CommandBounds {
+  //! Conservative bounding box of pixels the command can change in display list coordinates, or \ref infinite_bounds()
+  //! if the bounds are not known.
+  BLBoxI box;
+  //! Index of the first 64-bit word that follows the command, used to skip the command without decoding its payload.
+  uint64_t end;
+};
+
+static_assert(sizeof(CommandBounds) == 24, "CommandBounds must be 24 bytes long to be stored in BLArray");
+
+//! Returns bounds of a render command that can change any pixel.
+static BL_INLINE BLBoxI infinite_bounds() noexcept {
+  return BLBoxI(Traits::min_value<int>(), Traits::min_value<int>(), Traits::max_value<int>(), Traits::max_value<int>());
+}
+
+//! Tests whether `id` is a render command, which has \ref CommandBounds.
+static BL_INLINE bool is_render_command(CommandId id) noexcept { return id >= CommandId::kClearAll; }
+
+//! \}
+
+//! \name BLDisplayList - Internals - Initial State
+//! \{
+
+//! Fill and stroke style of a newly started rendering context and of each replayed display list.
+static constexpr uint32_t kInitialStyleRgba32 = 0xFF000000u;
+
+//! Returns rendering hints of a newly started rendering context and of each replayed display list.
+static BL_INLINE BLContextHints make_initial_hints() noexcept {
+  BLContextHints hints {};
+  hints.pattern_quality = uint8_t(BL_PATTERN_QUALITY_BILINEAR);
+  return hints;
+}
+
+//! \}
+
+//! \name BLDisplayList - Internals - Common Functionality (Impl)
+//! \{
+
+static BL_INLINE bool is_impl_mutable(BLDisplayListImpl* impl) noexcept {
+  return ObjectInternal::is_impl_mutable(impl);
+}
+
+BL_HIDDEN BLResult free_impl(BLDisplayListPrivateImpl* impl) noexcept;
+
+template<RCMode kRCMode>
+static BL_INLINE BLResult release_impl(BLDisplayListPrivateImpl* impl) noexcept {
+  return ObjectInternal::deref_impl_and_test<kRCMode>(impl) ? free_impl(impl) : BLResult(BL_SUCCESS);
+}
+
+//! \}
+
+//! \name BLDisplayList - Internals - Common Functionality (Instance)
+//! \{
+
+static BL_INLINE BLDisplayListPrivateImpl* get_impl(const BLDisplayListCore* self) noexcept {
+  return static_cast<BLDisplayListPrivateImpl*>(self->_d.impl);
+}
+
+static BL_INLINE BLResult retain_instance(const BLDisplayListCore* self, size_t n = 1) noexcept {
+  return ObjectInternal::retain_instance(self, n);
+}
+
+static BL_INLINE BLResult release_instance(BLDisplayListCore* self) noexcept {
+  return release_impl<RCMode::kMaybe>(get_impl(self));
+}
+
+static BL_INLINE BLResult replace_instance(BLDisplayListCore* self, const BLDisplayListCore* other) noexcept {
+  BLDisplayListPrivateImpl* impl = get_impl(self);
+  self->_d = other->_d;
+  return release_impl<RCMode::kMaybe>(impl);
+}
+
+//! \}
+
+//! \name BLDisplayList - Internals - Recording & Replay
+//! \{
+
+//! Allocates a new display list of the given `size`, which is marked as recording, and assigns it to `self`.
+BL_HIDDEN BLResult begin_recording(BLDisplayListCore* self, const BLSize& size) noexcept;
+
+//! Replays the display list `self` into the rendering context `ctx`, optionally transformed by `transform`.
+//!
+//! If `cull_box` is provided, render commands that don't overlap it (in display list coordinates) are skipped.
+BL_HIDDEN BLResult replay(const BLDisplayListCore* self, BLContextCore* ctx, const BLMatrix2D* transform, const BLBoxI* cull_box = nullptr) noexcept;
+
+//! \}
+
+} // {DisplayListInternal}
+} // {bl}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_DISPLAYLIST_P_H_INCLUDED
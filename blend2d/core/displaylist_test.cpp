@@ -0,0 +1,368 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/context.h>
+#include <blend2d/core/displaylist.h>
+#include <blend2d/core/displaylist_p.h>
+#include <blend2d/core/gradient.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/path.h>
+#include <blend2d/core/pattern.h>
+
+// bl::DisplayList - Tests
+// =======================
+
+namespace bl {
+namespace Tests {
+
+static void render_scene(BLContext& ctx) noexcept {
+  BLGradient gradient(BLLinearGradientValues(0.0, 0.0, 0.0, 200.0));
+  gradient.add_stop(0.0, BLRgba32(0xFFFFFFFFu));
+  gradient.add_stop(1.0, BLRgba32(0xFF1F7FFFu));
+
+  BLImage sprite(16, 16, BL_FORMAT_PRGB32);
+  {
+    BLContext sprite_ctx(sprite);
+    sprite_ctx.fill_all(BLRgba32(0xFF00FF00u));
+    sprite_ctx.fill_circle(8.0, 8.0, 5.0, BLRgba32(0xFFFF0000u));
+  }
+
+  BLPath path;
+  path.move_to(26, 31);
+  path.cubic_to(642, 132, 587, -136, 25, 464);
+  path.close();
+
+  ctx.fill_all(BLRgba32(0xFF202020u));
+  ctx.fill_rect(BLRectI(10, 10, 60, 40), BLRgba32(0xFFFF8000u));
+
+  ctx.save();
+  ctx.translate(20.0, 30.0);
+  ctx.rotate(0.25);
+  ctx.set_fill_style(gradient);
+  ctx.fill_path(path);
+  ctx.set_stroke_width(3.0);
+  ctx.set_stroke_caps(BL_STROKE_CAP_ROUND);
+  ctx.stroke_path(path, BLRgba32(0xFFFFFFFFu));
+  ctx.restore();
+
+  BLPointI polygon[] = { BLPointI(120, 10), BLPointI(180, 80), BLPointI(110, 60) };
+  ctx.set_fill_rule(BL_FILL_RULE_EVEN_ODD);
+  ctx.fill_polygon(polygon, BL_ARRAY_SIZE(polygon), BLRgba64(0xFFFF00000000FFFFu));
+
+  ctx.begin_layer(BLRect(60.0, 60.0, 100.0, 80.0), 0.5);
+  ctx.fill_rect(BLRectI(50, 70, 60, 40), BLRgba32(0xFFFF0000u));
+  ctx.fill_circle(110.0, 90.0, 30.0, BLRgba32(0xFF0000FFu));
+  ctx.end_layer();
+
+  BLRect rects[] = { BLRect(5, 150, 20, 20), BLRect(30, 155, 20, 20) };
+  ctx.set_global_alpha(0.5);
+  ctx.set_comp_op(BL_COMP_OP_SRC_COPY);
+  ctx.fill_rect_array(rects, BL_ARRAY_SIZE(rects), BLRgba32(0xFF00FFFFu));
+
+  ctx.set_comp_op(BL_COMP_OP_SRC_OVER);
+  ctx.clip_to_rect(BLRect(100.0, 100.0, 80.0, 80.0));
+  ctx.blit_image(BLPointI(110, 110), sprite);
+  ctx.blit_image(BLRect(130.0, 130.0, 40.5, 40.5), sprite, BLRectI(4, 4, 8, 8));
+  ctx.restore_clipping();
+
+  ctx.set_fill_style(BLPattern(sprite));
+  ctx.fill_round_rect(BLRoundRect(190.0, 190.0, 50.0, 50.0, 8.0));
+}
+
+static void render_direct(BLImage& image, const BLMatrix2D* transform) noexcept {
+  EXPECT_SUCCESS(image.create(256, 256, BL_FORMAT_PRGB32));
+
+  BLContext ctx(image);
+  ctx.clear_all();
+
+  if (transform) {
+    ctx.apply_transform(*transform);
+    ctx.user_to_meta();
+  }
+
+  render_scene(ctx);
+  ctx.end();
+}
+
+static void render_replay(BLImage& image, const BLDisplayList& display_list, const BLMatrix2D* transform) noexcept {
+  EXPECT_SUCCESS(image.create(256, 256, BL_FORMAT_PRGB32));
+
+  BLContext ctx(image);
+  ctx.clear_all();
+
+  // The state of the target rendering context must not leak into the replayed display list.
+  ctx.set_fill_style(BLRgba32(0xFFFF0000u));
+  ctx.set_comp_op(BL_COMP_OP_SRC_COPY);
+
+  if (transform)
+    EXPECT_SUCCESS(ctx.replay(display_list, *transform));
+  else
+    EXPECT_SUCCESS(ctx.replay(display_list));
+
+  // ...and the state of the target rendering context must be restored after replaying.
+  EXPECT_EQ(ctx.comp_op(), BL_COMP_OP_SRC_COPY);
+  EXPECT_EQ(ctx.saved_state_count(), 0u);
+  ctx.end();
+}
+
+static uint32_t max_pixel_difference(const BLImage& a, const BLImage& b) noexcept {
+  BLImageData a_data;
+  BLImageData b_data;
+
+  a.get_data(&a_data);
+  b.get_data(&b_data);
+
+  uint32_t max_diff = 0;
+  for (int y = 0; y < a_data.size.h; y++) {
+    const uint8_t* a_line = static_cast<const uint8_t*>(a_data.pixel_data) + intptr_t(y) * a_data.stride;
+    const uint8_t* b_line = static_cast<const uint8_t*>(b_data.pixel_data) + intptr_t(y) * b_data.stride;
+
+    for (size_t x = 0; x < size_t(a_data.size.w) * 4u; x++) {
+      uint32_t diff = uint32_t(bl_abs(int(a_line[x]) - int(b_line[x])));
+      max_diff = bl_max(max_diff, diff);
+    }
+  }
+
+  return max_diff;
+}
+
+struct TileCompositor {
+  BLImage image;
+  uint32_t tile_count;
+};
+
+static BLResult BL_CDECL acquire_padded_tile(BLImageCore* tile, const BLRectI* tile_rect, void* user_data) noexcept {
+  bl_unused(user_data);
+
+  // Tiles provided by the user can be larger than the tile area, rendering must be clipped to it.
+  BLImage& image = tile->dcast();
+  BL_PROPAGATE(image.create(tile_rect->w + 7, tile_rect->h + 5, BL_FORMAT_PRGB32));
+
+  BLContext ctx(image);
+  ctx.clear_all();
+  return ctx.end();
+}
+
+static BLResult BL_CDECL release_tile(BLImageCore* tile, const BLRectI* tile_rect, void* user_data) noexcept {
+  TileCompositor* compositor = static_cast<TileCompositor*>(user_data);
+  compositor->tile_count++;
+
+  BLContext ctx(compositor->image);
+  ctx.set_comp_op(BL_COMP_OP_SRC_COPY);
+  ctx.blit_image(BLPointI(tile_rect->x, tile_rect->y), tile->dcast(), BLRectI(0, 0, tile_rect->w, tile_rect->h));
+  return ctx.end();
+}
+
+UNIT(display_list, BL_TEST_GROUP_RENDERING_CONTEXT) {
+  BLDisplayList display_list;
+  EXPECT_TRUE(display_list.is_empty());
+  EXPECT_FALSE(display_list.is_recording());
+
+  INFO("Testing recording of a display list");
+  {
+    BLContext ctx;
+    EXPECT_SUCCESS(ctx.begin(display_list, BLSize(256.0, 256.0)));
+    EXPECT_EQ(ctx.context_type(), BL_CONTEXT_TYPE_PROXY);
+    EXPECT_EQ(ctx.target_size(), BLSize(256.0, 256.0));
+    EXPECT_TRUE(display_list.is_recording());
+
+    // A display list cannot be replayed while it's being recorded.
+    BLImage image(16, 16, BL_FORMAT_PRGB32);
+    BLContext other(image);
+    EXPECT_EQ(other.replay(display_list), BL_ERROR_BUSY);
+
+    // Recording validates arguments like any other rendering context.
+    EXPECT_EQ(ctx.set_comp_op(BLCompOp(0xFF)), BL_ERROR_INVALID_VALUE);
+    EXPECT_EQ(ctx.restore(), BL_ERROR_NO_STATES_TO_RESTORE);
+
+    render_scene(ctx);
+    EXPECT_SUCCESS(ctx.end());
+  }
+
+  EXPECT_FALSE(display_list.is_recording());
+  EXPECT_FALSE(display_list.is_empty());
+  EXPECT_EQ(display_list.size(), BLSize(256.0, 256.0));
+
+  INFO("Testing whether a replayed display list matches direct rendering");
+  {
+    BLImage expected;
+    BLImage actual;
+
+    render_direct(expected, nullptr);
+    render_replay(actual, display_list, nullptr);
+    EXPECT_TRUE(expected.equals(actual));
+
+    // The same display list can be replayed into multiple rendering contexts.
+    BLImage actual2;
+    render_replay(actual2, display_list, nullptr);
+    EXPECT_TRUE(expected.equals(actual2));
+  }
+
+  INFO("Testing whether a transformed display list matches direct rendering");
+  {
+    BLMatrix2D transform = BLMatrix2D::make_scaling(0.5, 0.75);
+    transform.translate(20.0, 10.0);
+
+    BLImage expected;
+    BLImage actual;
+
+    render_direct(expected, &transform);
+    render_replay(actual, display_list, &transform);
+    EXPECT_TRUE(expected.equals(actual));
+  }
+
+  INFO("Testing whether a tiled rendering of a display list matches direct rendering");
+  {
+    BLImage expected;
+    render_direct(expected, nullptr);
+
+    BLDisplayListTileInfo tile_info {};
+    tile_info.tile_size.reset(96, 80);
+
+    for (uint32_t acquire = 0; acquire < 2; acquire++) {
+      TileCompositor compositor {};
+      EXPECT_SUCCESS(compositor.image.create(256, 256, BL_FORMAT_PRGB32));
+
+      if (acquire)
+        EXPECT_SUCCESS(display_list.render_tiles(tile_info, acquire_padded_tile, release_tile, &compositor));
+      else
+        EXPECT_SUCCESS(display_list.render_tiles(tile_info, release_tile, &compositor));
+
+      EXPECT_EQ(compositor.tile_count, 12u);
+
+      // Tiles translate geometry by a non-zero offset, which can round differently in few edge pixels.
+      EXPECT_LE(max_pixel_difference(expected, compositor.image), 1u);
+    }
+  }
+
+  INFO("Testing whether a display list can be replayed into another display list");
+  {
+    BLDisplayList outer;
+    {
+      BLContext ctx;
+      EXPECT_SUCCESS(ctx.begin(outer, BLSize(256.0, 256.0)));
+      EXPECT_SUCCESS(ctx.replay(display_list));
+      EXPECT_SUCCESS(ctx.end());
+    }
+
+    BLImage expected;
+    BLImage actual;
+
+    render_direct(expected, nullptr);
+    render_replay(actual, outer, nullptr);
+    EXPECT_TRUE(expected.equals(actual));
+  }
+
+  INFO("Testing whether a replayed clip to no geometry matches direct rendering");
+  {
+    auto render_clipped = [](BLContext& ctx) noexcept {
+      ctx.fill_rect(BLRect(10.0, 10.0, 100.0, 100.0), BLRgba32(0xFF0000FFu));
+      ctx.clip_to_geometry(BL_GEOMETRY_TYPE_NONE, nullptr);
+      ctx.fill_all(BLRgba32(0xFFFF0000u));
+      ctx.restore_clipping();
+      ctx.fill_rect(BLRect(50.0, 50.0, 100.0, 100.0), BLRgba32(0x8000FF00u));
+    };
+
+    BLDisplayList display_list;
+    {
+      BLContext ctx;
+      EXPECT_SUCCESS(ctx.begin(display_list, BLSize(256.0, 256.0)));
+      render_clipped(ctx);
+      EXPECT_SUCCESS(ctx.end());
+    }
+
+    BLImage expected;
+    EXPECT_SUCCESS(expected.create(256, 256, BL_FORMAT_PRGB32));
+    {
+      BLContext ctx(expected);
+      ctx.clear_all();
+      render_clipped(ctx);
+      EXPECT_SUCCESS(ctx.end());
+    }
+
+    BLImage actual;
+    EXPECT_SUCCESS(actual.create(256, 256, BL_FORMAT_PRGB32));
+    {
+      BLContext ctx(actual);
+      ctx.clear_all();
+      EXPECT_SUCCESS(ctx.replay(display_list));
+      EXPECT_SUCCESS(ctx.end());
+    }
+
+    EXPECT_TRUE(expected.equals(actual));
+  }
+
+  INFO("Testing whether render commands outside of a cull box are skipped");
+  {
+    BLDisplayList grid;
+    {
+      BLContext ctx;
+      EXPECT_SUCCESS(ctx.begin(grid, BLSize(256.0, 256.0)));
+
+      for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+          ctx.fill_rect(BLRectI(x * 32 + 4, y * 32 + 4, 24, 24), BLRgba32(0xFF000000u | uint32_t(x * 32 + y)));
+        }
+      }
+
+      // Stroke extent and transformation must be part of the bounds of a command.
+      ctx.set_stroke_width(12.0);
+      ctx.set_stroke_join(BL_STROKE_JOIN_MITER_CLIP);
+      ctx.translate(8.0, 8.0);
+      ctx.stroke_triangle(BLTriangle(120.0, 120.0, 200.0, 150.0, 130.0, 200.0), BLRgba32(0xFFFFFFFFu));
+      ctx.fill_all(BLRgba32(0x10FF0000u));
+      EXPECT_SUCCESS(ctx.end());
+    }
+
+    auto count_replayed = [&](const BLBoxI* cull_box) noexcept -> size_t {
+      BLDisplayList dst;
+      BLContext ctx;
+      EXPECT_SUCCESS(ctx.begin(dst, BLSize(256.0, 256.0)));
+      EXPECT_SUCCESS(DisplayListInternal::replay(&grid, &ctx, nullptr, cull_box));
+      EXPECT_SUCCESS(ctx.end());
+      return dst.command_count();
+    };
+
+    size_t all_count = count_replayed(nullptr);
+    BLBoxI first_cell(0, 0, 32, 32);
+    BLBoxI empty_area(-100, -100, -50, -50);
+
+    // Only one of 64 rectangles overlaps the first cell, other 63 rectangles and the stroke are culled, `fill_all()`
+    // is never culled. In the empty area everything but `fill_all()` is culled.
+    EXPECT_EQ(count_replayed(&first_cell), all_count - 64u);
+    EXPECT_EQ(count_replayed(&empty_area), all_count - 65u);
+
+    BLImage expected;
+    EXPECT_SUCCESS(expected.create(256, 256, BL_FORMAT_PRGB32));
+    {
+      BLContext ctx(expected);
+      ctx.clear_all();
+      EXPECT_SUCCESS(ctx.replay(grid));
+      EXPECT_SUCCESS(ctx.end());
+    }
+
+    // Small tiles cull most commands, the result must be the same regardless of the number of threads used.
+    for (uint32_t thread_count = 0; thread_count < 3; thread_count += 2) {
+      TileCompositor compositor {};
+      EXPECT_SUCCESS(compositor.image.create(256, 256, BL_FORMAT_PRGB32));
+
+      BLDisplayListTileInfo tile_info {};
+      tile_info.tile_size.reset(40, 24);
+      tile_info.thread_count = thread_count;
+
+      EXPECT_SUCCESS(grid.render_tiles(tile_info, release_tile, &compositor));
+      EXPECT_EQ(compositor.tile_count, 7u * 11u);
+      EXPECT_LE(max_pixel_difference(expected, compositor.image), 1u);
+    }
+  }
+}
+
+} // {Tests}
+} // {bl}
+
+#endif // BL_TEST
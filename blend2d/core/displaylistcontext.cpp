@@ -0,0 +1,1616 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/array_p.h>
+#include <blend2d/core/context_p.h>
+#include <blend2d/core/displaylist_p.h>
+#include <blend2d/core/displaylistcontext_p.h>
+#include <blend2d/core/font_p.h>
+#include <blend2d/core/glyphbuffer.h>
+#include <blend2d/core/gradient.h>
+#include <blend2d/core/matrix_p.h>
+#include <blend2d/core/path_p.h>
+#include <blend2d/core/pattern.h>
+#include <blend2d/core/rgba_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/core/var_p.h>
+#include <blend2d/geometry/commons_p.h>
+#include <blend2d/support/math_p.h>
+#include <blend2d/support/traits_p.h>
+#include <blend2d/threading/uniqueidgenerator_p.h>
+
+namespace bl {
+namespace DisplayListInternal {
+
+// bl::DisplayList - RecordingContext - Constants
+// ==============================================
+
+//! Maximum number of saved states if not overridden.
+static constexpr uint32_t kDefaultSavedStateLimit = 4096;
+
+//! Number of most recently added objects that are checked before a new object is added to the object array.
+static constexpr size_t kObjectCacheSize = 8;
+
+//! State that was changed, but not recorded yet.
+//!
+//! These states are usually changed multiple times in a row (for example by setting stroke width, caps, and join
+//! separately), so they are recorded only once before a command that depends on them.
+enum class DirtyFlags : uint32_t {
+  kNone          = 0x00000000u,
+  kTransform     = 0x00000001u,
+  kHints         = 0x00000002u,
+  kApproximation = 0x00000004u,
+  kStroke        = 0x00000008u
+};
+BL_DEFINE_ENUM_FLAGS(DirtyFlags)
+
+// bl::DisplayList - RecordingContext - Structs
+// ============================================
+
+struct SavedState {
+  SavedState* prev_state;
+  uint64_t state_id;
+  //! Whether the state was saved by `begin_layer()`.
+  bool has_layer;
+
+  BLContextState state;
+  BLVarCore style[2];
+  BLMatrix2D style_transform[2];
+};
+
+struct RecordingContextImpl : public BLContextImpl {
+  //! State exposed by \ref BLContextImpl::state, mirrors the state of a rendering context that replays the commands.
+  BLContextState internal_state;
+  //! Display list being recorded.
+  BLDisplayListCore display_list;
+
+  //! Fill and stroke styles (used by `get_style()`).
+  BLVarCore style[2];
+  //! Transformations associated with fill and stroke styles (depend on \ref BLContextStyleTransformMode).
+  BLMatrix2D style_transform[2];
+
+  //! Top of the saved state stack.
+  SavedState* saved_state;
+  //! Context origin id used to verify cookies.
+  uint64_t context_origin_id;
+  //! Used to generate unique IDs of saved states that use cookies.
+  uint64_t state_id_counter;
+  //! Maximum number of saved states.
+  uint32_t saved_state_limit;
+  //! States that were changed, but not recorded yet.
+  DirtyFlags dirty_flags;
+
+  //! Glyph buffer used to shape text at record time.
+  BLGlyphBuffer glyph_buffer;
+};
+
+struct StyleRef {
+  StyleKind kind;
+  uint32_t value;
+};
+
+// bl::DisplayList - RecordingContext - Globals
+// ============================================
+
+static BLContextVirt recording_context_virt;
+
+// bl::DisplayList - RecordingContext - Internals - Commands
+// =========================================================
+
+static BL_INLINE RecordingContextImpl* recording_impl(BLContextImpl* base_impl) noexcept {
+  return static_cast<RecordingContextImpl*>(base_impl);
+}
+
+static BL_INLINE BLDisplayListPrivateImpl* display_list_impl(RecordingContextImpl* ctx_impl) noexcept {
+  return get_impl(&ctx_impl->display_list);
+}
+
+static BLResult add_object(RecordingContextImpl* ctx_impl, const BLObjectCore* object, uint32_t* index_out) noexcept {
+  BLDisplayListPrivateImpl* dl_impl = display_list_impl(ctx_impl);
+  const BLArray<BLVar>& objects = dl_impl->objects.dcast<BLArray<BLVar>>();
+
+  // The same object is often used by consecutive commands (a path filled and stroked, a gradient used by multiple
+  // shapes, etc...), so check few most recently added objects first to avoid storing duplicates.
+  size_t size = objects.size();
+  size_t start = size - bl_min(size, kObjectCacheSize);
+
+  for (size_t i = size; i > start;) {
+    i--;
+    if (objects[i]._d == object->_d) {
+      *index_out = uint32_t(i);
+      return BL_SUCCESS;
+    }
+  }
+
+  if (BL_UNLIKELY(size >= size_t(Traits::max_value<uint32_t>())))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  BL_PROPAGATE(bl_array_append_item(&dl_impl->objects, object));
+  *index_out = uint32_t(size);
+  return BL_SUCCESS;
+}
+
+// Appends a command without recording pending states.
+//
+// Render commands also record their `bounds` (in display list coordinates), which are used to cull them by tiled
+// rendering. Bounds are ignored by other commands.
+static BLResult append_command_raw(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, uint32_t a, uint32_t b, size_t payload_words, uint64_t** payload_out, const BLBoxI& bounds = infinite_bounds()) noexcept {
+  BLDisplayListPrivateImpl* dl_impl = display_list_impl(ctx_impl);
+  bool is_render = is_render_command(id);
+
+  if (is_render) {
+    CommandBounds command_bounds;
+    command_bounds.box = bounds;
+    command_bounds.end = dl_impl->commands.dcast<BLArray<uint64_t>>().size() + 1u + payload_words;
+    BL_PROPAGATE(bl_array_append_item(&dl_impl->command_bounds, &command_bounds));
+  }
+
+  uint64_t* dst;
+  BLResult result = bl_array_modify_op(&dl_impl->commands, BL_MODIFY_OP_APPEND_GROW, 1u + payload_words, reinterpret_cast<void**>(&dst));
+
+  if (BL_UNLIKELY(result != BL_SUCCESS)) {
+    // Keep command bounds in sync with commands - shrinking an array cannot fail.
+    if (is_render)
+      bl_array_resize(&dl_impl->command_bounds, dl_impl->command_bounds.dcast<BLArray<CommandBounds>>().size() - 1u, nullptr);
+    return result;
+  }
+
+  CommandHeader header;
+  header.id = id;
+  header.style = style.kind;
+  header.a = uint8_t(a);
+  header.b = uint8_t(b);
+  header.value = style.value;
+
+  memcpy(dst, &header, sizeof(CommandHeader));
+  dl_impl->command_count++;
+
+  *payload_out = dst + 1;
+  return BL_SUCCESS;
+}
+
+static BLResult flush_dirty_state(RecordingContextImpl* ctx_impl) noexcept {
+  DirtyFlags dirty_flags = ctx_impl->dirty_flags;
+  const BLContextState& state = ctx_impl->internal_state;
+
+  uint64_t* payload;
+
+  if (bl_test_flag(dirty_flags, DirtyFlags::kTransform)) {
+    if (state.user_transform.type() == BL_TRANSFORM_TYPE_IDENTITY) {
+      BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kResetTransform, StyleRef{}, 0, 0, 0, &payload));
+    }
+    else {
+      BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kSetTransform, StyleRef{}, 0, 0, word_count_of(sizeof(BLMatrix2D)), &payload));
+      CommandWriter(payload).write(state.user_transform);
+    }
+  }
+
+  if (bl_test_flag(dirty_flags, DirtyFlags::kHints)) {
+    BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kSetHints, StyleRef{}, 0, 0, word_count_of(sizeof(BLContextHints)), &payload));
+    CommandWriter(payload).write(state.hints);
+  }
+
+  if (bl_test_flag(dirty_flags, DirtyFlags::kApproximation)) {
+    BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kSetApproximationOptions, StyleRef{}, 0, 0, word_count_of(sizeof(BLApproximationOptions)), &payload));
+    CommandWriter(payload).write(state.approximation_options);
+  }
+
+  if (bl_test_flag(dirty_flags, DirtyFlags::kStroke)) {
+    uint32_t dash_array_index;
+    BL_PROPAGATE(add_object(ctx_impl, &state.stroke_options.dash_array, &dash_array_index));
+    BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kSetStrokeOptions, StyleRef{StyleKind::kImplicit, dash_array_index}, 0, 0, 4, &payload));
+
+    CommandWriter writer(payload);
+    writer.write(state.stroke_options.hints);
+    writer.write(state.stroke_options.width);
+    writer.write(state.stroke_options.miter_limit);
+    writer.write(state.stroke_options.dash_offset);
+  }
+
+  ctx_impl->dirty_flags = DirtyFlags::kNone;
+  return BL_SUCCESS;
+}
+
+// Appends a command, pending states are recorded first as the command can depend on them.
+static BL_INLINE BLResult append_command(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, uint32_t a, uint32_t b, size_t payload_words, uint64_t** payload_out, const BLBoxI& bounds = infinite_bounds()) noexcept {
+  if (ctx_impl->dirty_flags != DirtyFlags::kNone)
+    BL_PROPAGATE(flush_dirty_state(ctx_impl));
+  return append_command_raw(ctx_impl, id, style, a, b, payload_words, payload_out, bounds);
+}
+
+template<typename T>
+static BL_INLINE BLResult append_command_with_payload(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, uint32_t a, const T& value, const BLBoxI& bounds = infinite_bounds()) noexcept {
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, id, style, a, 0, word_count_of(sizeof(T)), &payload, bounds));
+
+  CommandWriter(payload).write(value);
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Internals - Command Bounds
+// ===============================================================
+
+//! Bounds outside of this range are considered infinite as they would cover any tile anyway.
+static constexpr double kMaxBoundsCoordinate = 1073741824.0;
+
+// Converts a `box` in user coordinates to conservative bounds of pixels in display list coordinates. The bounds are
+// expanded by one pixel to cover antialiasing, and by the extent of the current stroke if `stroke` is true.
+static BLBoxI box_to_bounds(const RecordingContextImpl* ctx_impl, const BLBox& box, bool stroke) noexcept {
+  const BLContextState& state = ctx_impl->internal_state;
+
+  BLBox user_box = box;
+  double margin = 1.0;
+
+  if (stroke) {
+    // Miter joins extend up to `miter_limit * width / 2` from the path, caps (square and triangle) up to `width`.
+    const BLStrokeOptionsCore& stroke_options = state.stroke_options;
+    double extent = 0.5 * bl_abs(stroke_options.width) * bl_max(stroke_options.miter_limit, 2.0);
+
+    if (stroke_options.transform_order == BL_STROKE_TRANSFORM_ORDER_AFTER)
+      user_box.reset(user_box.x0 - extent, user_box.y0 - extent, user_box.x1 + extent, user_box.y1 + extent);
+    else
+      margin += extent;
+  }
+
+  BLBox dl_box = TransformInternal::map_box(state.final_transform, user_box);
+  double x0 = dl_box.x0 - margin;
+  double y0 = dl_box.y0 - margin;
+  double x1 = dl_box.x1 + margin;
+  double y1 = dl_box.y1 + margin;
+
+  // Also catches NaNs, which can be produced by a degenerate transformation or invalid geometry.
+  if (!(x0 >= -kMaxBoundsCoordinate && y0 >= -kMaxBoundsCoordinate && x1 <= kMaxBoundsCoordinate && y1 <= kMaxBoundsCoordinate))
+    return infinite_bounds();
+
+  return BLBoxI(int(Math::floor(x0)), int(Math::floor(y0)), int(Math::ceil(x1)), int(Math::ceil(y1)));
+}
+
+template<typename T>
+static BL_INLINE BLBox rect_to_box(const T& rect) noexcept {
+  return BLBox(double(rect.x), double(rect.y), double(rect.x) + double(rect.w), double(rect.y) + double(rect.h));
+}
+
+template<typename T>
+static BL_INLINE BLBox box_to_box(const T& box) noexcept {
+  return BLBox(double(box.x0), double(box.y0), double(box.x1), double(box.y1));
+}
+
+template<typename T, typename BoxFunc>
+static BL_INLINE BLBox array_view_box(const void* data, BoxFunc&& box_func) noexcept {
+  const BLArrayView<T>* view = static_cast<const BLArrayView<T>*>(data);
+  if (!view->size)
+    return BLBox(0.0, 0.0, 0.0, 0.0);
+
+  BLBox box = box_func(view->data[0]);
+  for (size_t i = 1; i < view->size; i++)
+    Geometry::bound(box, box_func(view->data[i]));
+  return box;
+}
+
+template<typename T>
+static BL_INLINE BLBox point_to_box(const T& p) noexcept {
+  return BLBox(double(p.x), double(p.y), double(p.x), double(p.y));
+}
+
+// Returns bounds of a geometry of the given `type` rendered by a fill or stroke command.
+static BLBoxI geometry_bounds(const RecordingContextImpl* ctx_impl, BLGeometryType type, const void* data, bool stroke) noexcept {
+  BLBox box;
+
+  switch (type) {
+    case BL_GEOMETRY_TYPE_BOXI: box = box_to_box(*static_cast<const BLBoxI*>(data)); break;
+    case BL_GEOMETRY_TYPE_BOXD: box = *static_cast<const BLBox*>(data); break;
+    case BL_GEOMETRY_TYPE_RECTI: box = rect_to_box(*static_cast<const BLRectI*>(data)); break;
+    case BL_GEOMETRY_TYPE_RECTD: box = rect_to_box(*static_cast<const BLRect*>(data)); break;
+
+    case BL_GEOMETRY_TYPE_CIRCLE: {
+      const BLCircle* circle = static_cast<const BLCircle*>(data);
+      double r = bl_abs(circle->r);
+      box.reset(circle->cx - r, circle->cy - r, circle->cx + r, circle->cy + r);
+      break;
+    }
+
+    case BL_GEOMETRY_TYPE_ELLIPSE: {
+      const BLEllipse* ellipse = static_cast<const BLEllipse*>(data);
+      double rx = bl_abs(ellipse->rx);
+      double ry = bl_abs(ellipse->ry);
+      box.reset(ellipse->cx - rx, ellipse->cy - ry, ellipse->cx + rx, ellipse->cy + ry);
+      break;
+    }
+
+    case BL_GEOMETRY_TYPE_ROUND_RECT: {
+      const BLRoundRect* round_rect = static_cast<const BLRoundRect*>(data);
+      box = rect_to_box(*round_rect);
+      break;
+    }
+
+    // Arcs, chords, and pies are always within the bounds of their ellipse.
+    case BL_GEOMETRY_TYPE_ARC:
+    case BL_GEOMETRY_TYPE_CHORD:
+    case BL_GEOMETRY_TYPE_PIE: {
+      const BLArc* arc = static_cast<const BLArc*>(data);
+      double rx = bl_abs(arc->rx);
+      double ry = bl_abs(arc->ry);
+      box.reset(arc->cx - rx, arc->cy - ry, arc->cx + rx, arc->cy + ry);
+      break;
+    }
+
+    case BL_GEOMETRY_TYPE_LINE: {
+      const BLLine* line = static_cast<const BLLine*>(data);
+      box.reset(bl_min(line->x0, line->x1), bl_min(line->y0, line->y1), bl_max(line->x0, line->x1), bl_max(line->y0, line->y1));
+      break;
+    }
+
+    case BL_GEOMETRY_TYPE_TRIANGLE: {
+      const BLTriangle* triangle = static_cast<const BLTriangle*>(data);
+      box.reset(bl_min(triangle->x0, triangle->x1, triangle->x2), bl_min(triangle->y0, triangle->y1, triangle->y2),
+                bl_max(triangle->x0, triangle->x1, triangle->x2), bl_max(triangle->y0, triangle->y1, triangle->y2));
+      break;
+    }
+
+    case BL_GEOMETRY_TYPE_POLYLINEI:
+    case BL_GEOMETRY_TYPE_POLYGONI:
+      box = array_view_box<BLPointI>(data, point_to_box<BLPointI>);
+      break;
+
+    case BL_GEOMETRY_TYPE_POLYLINED:
+    case BL_GEOMETRY_TYPE_POLYGOND:
+      box = array_view_box<BLPoint>(data, point_to_box<BLPoint>);
+      break;
+
+    case BL_GEOMETRY_TYPE_ARRAY_VIEW_BOXI: box = array_view_box<BLBoxI>(data, box_to_box<BLBoxI>); break;
+    case BL_GEOMETRY_TYPE_ARRAY_VIEW_BOXD: box = array_view_box<BLBox>(data, box_to_box<BLBox>); break;
+    case BL_GEOMETRY_TYPE_ARRAY_VIEW_RECTI: box = array_view_box<BLRectI>(data, rect_to_box<BLRectI>); break;
+    case BL_GEOMETRY_TYPE_ARRAY_VIEW_RECTD: box = array_view_box<BLRect>(data, rect_to_box<BLRect>); break;
+
+    case BL_GEOMETRY_TYPE_PATH: {
+      if (static_cast<const BLPath*>(data)->get_control_box(&box) != BL_SUCCESS)
+        return infinite_bounds();
+      break;
+    }
+
+    default:
+      return infinite_bounds();
+  }
+
+  return box_to_bounds(ctx_impl, box, stroke);
+}
+
+// bl::DisplayList - RecordingContext - Internals - Styles
+// =======================================================
+
+static BL_INLINE StyleRef implicit_style() noexcept { return StyleRef{StyleKind::kImplicit, 0}; }
+static BL_INLINE StyleRef rgba32_style(uint32_t rgba32) noexcept { return StyleRef{StyleKind::kRgba32, rgba32}; }
+
+static BLResult object_style(RecordingContextImpl* ctx_impl, const BLObjectCore* style, StyleRef* out) noexcept {
+  if (style->_d.is_rgba32()) {
+    *out = rgba32_style(style->_d.rgba32.value);
+    return BL_SUCCESS;
+  }
+
+  if (BL_UNLIKELY(!style->_d.is_style()))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  out->kind = StyleKind::kObject;
+  return add_object(ctx_impl, style, &out->value);
+}
+
+// bl::DisplayList - RecordingContext - Internals - Saved States
+// =============================================================
+
+static void free_saved_state(SavedState* saved_state) noexcept {
+  ContextInternal::destroy_state(&saved_state->state);
+  bl_var_destroy(&saved_state->style[0]);
+  bl_var_destroy(&saved_state->style[1]);
+  free(saved_state);
+}
+
+static uint32_t get_num_states_to_restore(SavedState* saved_state, uint64_t state_id) noexcept {
+  uint32_t n = 1;
+  do {
+    uint64_t saved_id = saved_state->state_id;
+    if (saved_id <= state_id)
+      return saved_id == state_id ? n : uint32_t(0);
+    n++;
+    saved_state = saved_state->prev_state;
+  } while (saved_state);
+
+  return 0;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Flush & Save & Restore
+// ======================================================================
+
+static BLResult BL_CDECL flush_impl(BLContextImpl* base_impl, BLContextFlushFlags flags) noexcept {
+  // Nothing to flush - commands are appended to the display list immediately.
+  bl_unused(base_impl, flags);
+  return BL_SUCCESS;
+}
+
+// Links `new_state`, which holds a copy of the current state, to the list of saved states.
+static void push_saved_state(RecordingContextImpl* ctx_impl, SavedState* new_state, bool has_layer) noexcept {
+  memcpy(static_cast<void*>(&new_state->state), &ctx_impl->internal_state, sizeof(BLContextState));
+  ArrayInternal::retain_instance(&new_state->state.stroke_options.dash_array);
+
+  for (uint32_t slot = 0; slot <= BL_CONTEXT_STYLE_SLOT_MAX_VALUE; slot++) {
+    bl_var_init_weak(&new_state->style[slot], &ctx_impl->style[slot]);
+    new_state->style_transform[slot] = ctx_impl->style_transform[slot];
+  }
+
+  new_state->prev_state = ctx_impl->saved_state;
+  new_state->state_id = Traits::max_value<uint64_t>();
+  new_state->has_layer = has_layer;
+
+  ctx_impl->saved_state = new_state;
+  ctx_impl->internal_state.saved_state_count++;
+}
+
+// Restores `n` saved states - the caller must record the command that restores them.
+static void pop_saved_states(RecordingContextImpl* ctx_impl, uint32_t n) noexcept {
+  SavedState* saved_state = ctx_impl->saved_state;
+  ctx_impl->dirty_flags = DirtyFlags::kNone;
+
+  do {
+    ContextInternal::destroy_state(&ctx_impl->internal_state);
+    memcpy(static_cast<void*>(&ctx_impl->internal_state), &saved_state->state, sizeof(BLContextState));
+
+    for (uint32_t slot = 0; slot <= BL_CONTEXT_STYLE_SLOT_MAX_VALUE; slot++) {
+      bl_var_destroy(&ctx_impl->style[slot]);
+      ctx_impl->style[slot]._d = saved_state->style[slot]._d;
+      ctx_impl->style_transform[slot] = saved_state->style_transform[slot];
+    }
+
+    SavedState* prev_state = saved_state->prev_state;
+    free(saved_state);
+    saved_state = prev_state;
+  } while (--n);
+
+  ctx_impl->saved_state = saved_state;
+}
+
+static BLResult BL_CDECL save_impl(BLContextImpl* base_impl, BLContextCookie* cookie) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(ctx_impl->internal_state.saved_state_count >= ctx_impl->saved_state_limit))
+    return bl_make_error(BL_ERROR_TOO_MANY_SAVED_STATES);
+
+  SavedState* new_state = static_cast<SavedState*>(malloc(sizeof(SavedState)));
+  if (BL_UNLIKELY(!new_state))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  uint64_t* payload;
+  BLResult result = append_command(ctx_impl, CommandId::kSave, implicit_style(), 0, 0, 0, &payload);
+
+  if (BL_UNLIKELY(result != BL_SUCCESS)) {
+    free(new_state);
+    return result;
+  }
+
+  push_saved_state(ctx_impl, new_state, false);
+
+  if (!cookie)
+    return BL_SUCCESS;
+
+  // Setup the given `cookie` and make the state cookie dependent.
+  uint64_t state_id = ++ctx_impl->state_id_counter;
+  new_state->state_id = state_id;
+
+  cookie->reset(ctx_impl->context_origin_id, state_id);
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL restore_impl(BLContextImpl* base_impl, const BLContextCookie* cookie) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+  SavedState* saved_state = ctx_impl->saved_state;
+
+  if (BL_UNLIKELY(!saved_state))
+    return bl_make_error(BL_ERROR_NO_STATES_TO_RESTORE);
+
+  // By default there would be only one state to restore if `cookie` was not provided.
+  uint32_t n = 1;
+
+  if (cookie) {
+    // Verify context origin.
+    if (BL_UNLIKELY(cookie->data[0] != ctx_impl->context_origin_id))
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+
+    // Verify cookie payload and get the number of states we have to restore (if valid).
+    n = get_num_states_to_restore(saved_state, cookie->data[1]);
+    if (BL_UNLIKELY(n == 0))
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+  }
+  else {
+    // A state that has a `state_id` assigned cannot be restored without a matching cookie.
+    if (saved_state->state_id != Traits::max_value<uint64_t>())
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+  }
+
+  // Pending states are discarded by restore, so there is no reason to record them. Cookies are not recorded, the
+  // number of states to restore is recorded instead, which is always valid when replayed.
+  uint64_t* payload;
+  BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kRestore, StyleRef{StyleKind::kImplicit, n}, 0, 0, 0, &payload));
+
+  ctx_impl->internal_state.saved_state_count -= n;
+  pop_saved_states(ctx_impl, n);
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Layers
+// ======================================================
+
+static BLResult BL_CDECL begin_layer_impl(BLContextImpl* base_impl, const BLRect* bounds, double alpha, BLCompOp comp_op) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(Math::is_nan(alpha) || uint32_t(comp_op) > BL_COMP_OP_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  if (BL_UNLIKELY(ctx_impl->internal_state.saved_state_count >= ctx_impl->saved_state_limit))
+    return bl_make_error(BL_ERROR_TOO_MANY_SAVED_STATES);
+
+  SavedState* new_state = static_cast<SavedState*>(malloc(sizeof(SavedState)));
+  if (BL_UNLIKELY(!new_state))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  // The payload always holds the bounds, `a` specifies whether they were passed.
+  uint64_t* payload;
+  BLResult result = append_command(ctx_impl, CommandId::kBeginLayer, StyleRef{StyleKind::kImplicit, uint32_t(comp_op)},
+                                   bounds != nullptr, 0, word_count_of(sizeof(BLRect)) + 1u, &payload);
+
+  if (BL_UNLIKELY(result != BL_SUCCESS)) {
+    free(new_state);
+    return result;
+  }
+
+  CommandWriter writer(payload);
+  writer.write(bounds ? *bounds : BLRect());
+  writer.write(bl_clamp(alpha, 0.0, 1.0));
+
+  push_saved_state(ctx_impl, new_state, true);
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL end_layer_impl(BLContextImpl* base_impl) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+  SavedState* saved_state = ctx_impl->saved_state;
+
+  // Ending a layer restores all states saved since the layer began, which cannot be done if one of them needs a cookie.
+  uint32_t n = 1;
+  while (saved_state && !saved_state->has_layer) {
+    if (saved_state->state_id != Traits::max_value<uint64_t>())
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+    saved_state = saved_state->prev_state;
+    n++;
+  }
+
+  if (BL_UNLIKELY(!saved_state))
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command_raw(ctx_impl, CommandId::kEndLayer, implicit_style(), 0, 0, 0, &payload));
+
+  ctx_impl->internal_state.saved_state_count -= n;
+  pop_saved_states(ctx_impl, n);
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Transformations
+// ===============================================================
+
+static BLResult BL_CDECL apply_transform_op_impl(BLContextImpl* base_impl, BLTransformOp op_type, const void* op_data) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+  BLContextState& state = ctx_impl->internal_state;
+
+  BL_PROPAGATE(bl_matrix2d_apply_op(&state.user_transform, op_type, op_data));
+  TransformInternal::multiply(state.final_transform, state.user_transform, state.meta_transform);
+
+  ctx_impl->dirty_flags |= DirtyFlags::kTransform;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL user_to_meta_impl(BLContextImpl* base_impl) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+  BLContextState& state = ctx_impl->internal_state;
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kUserToMeta, implicit_style(), 0, 0, 0, &payload));
+
+  state.meta_transform = state.final_transform;
+  state.user_transform.reset();
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Rendering Hints
+// ===============================================================
+
+static BLResult BL_CDECL set_hint_impl(BLContextImpl* base_impl, BLContextHint hint_type, uint32_t value) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+  BLContextHints& hints = ctx_impl->internal_state.hints;
+
+  switch (hint_type) {
+    case BL_CONTEXT_HINT_RENDERING_QUALITY:
+      if (BL_UNLIKELY(value > BL_RENDERING_QUALITY_MAX_VALUE))
+        return bl_make_error(BL_ERROR_INVALID_VALUE);
+      break;
+
+    case BL_CONTEXT_HINT_GRADIENT_QUALITY:
+      if (BL_UNLIKELY(value > BL_GRADIENT_QUALITY_MAX_VALUE))
+        return bl_make_error(BL_ERROR_INVALID_VALUE);
+      break;
+
+    case BL_CONTEXT_HINT_PATTERN_QUALITY:
+      if (BL_UNLIKELY(value > BL_PATTERN_QUALITY_MAX_VALUE))
+        return bl_make_error(BL_ERROR_INVALID_VALUE);
+      break;
+
+    default:
+      return bl_make_error(BL_ERROR_INVALID_VALUE);
+  }
+
+  hints.hints[hint_type] = uint8_t(value);
+  ctx_impl->dirty_flags |= DirtyFlags::kHints;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL set_hints_impl(BLContextImpl* base_impl, const BLContextHints* hints) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  uint8_t rendering_quality = hints->rendering_quality;
+  uint8_t pattern_quality = hints->pattern_quality;
+  uint8_t gradient_quality = hints->gradient_quality;
+
+  if (BL_UNLIKELY(rendering_quality > BL_RENDERING_QUALITY_MAX_VALUE ||
+                  pattern_quality   > BL_PATTERN_QUALITY_MAX_VALUE   ||
+                  gradient_quality  > BL_GRADIENT_QUALITY_MAX_VALUE  ))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  ctx_impl->internal_state.hints.rendering_quality = rendering_quality;
+  ctx_impl->internal_state.hints.pattern_quality = pattern_quality;
+  ctx_impl->internal_state.hints.gradient_quality = gradient_quality;
+
+  ctx_impl->dirty_flags |= DirtyFlags::kHints;
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Approximation Options
+// =====================================================================
+
+static BLResult BL_CDECL set_flatten_mode_impl(BLContextImpl* base_impl, BLFlattenMode mode) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(mode) > BL_FLATTEN_MODE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  ctx_impl->internal_state.approximation_options.flatten_mode = uint8_t(mode);
+  ctx_impl->dirty_flags |= DirtyFlags::kApproximation;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL set_flatten_tolerance_impl(BLContextImpl* base_impl, double tolerance) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(Math::is_nan(tolerance)))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  tolerance = bl_clamp(tolerance, ContextInternal::kMinimumTolerance, ContextInternal::kMaximumTolerance);
+  ctx_impl->internal_state.approximation_options.flatten_tolerance = tolerance;
+  ctx_impl->dirty_flags |= DirtyFlags::kApproximation;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL set_approximation_options_impl(BLContextImpl* base_impl, const BLApproximationOptions* options) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  uint32_t flatten_mode = options->flatten_mode;
+  uint32_t offset_mode = options->offset_mode;
+
+  double flatten_tolerance = options->flatten_tolerance;
+  double offset_parameter = options->offset_parameter;
+
+  if (BL_UNLIKELY(flatten_mode > BL_FLATTEN_MODE_MAX_VALUE ||
+                  offset_mode > BL_OFFSET_MODE_MAX_VALUE ||
+                  Math::is_nan(flatten_tolerance) ||
+                  Math::is_nan(offset_parameter)))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BLApproximationOptions& dst = ctx_impl->internal_state.approximation_options;
+  dst.flatten_mode = uint8_t(flatten_mode);
+  dst.offset_mode = uint8_t(offset_mode);
+  dst.flatten_tolerance = bl_clamp(flatten_tolerance, ContextInternal::kMinimumTolerance, ContextInternal::kMaximumTolerance);
+  dst.offset_parameter = offset_parameter;
+
+  ctx_impl->dirty_flags |= DirtyFlags::kApproximation;
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Fill & Stroke Style
+// ===================================================================
+
+static BLResult BL_CDECL get_style_impl(const BLContextImpl* base_impl, BLContextStyleSlot slot, bool transformed, BLVarCore* var_out) noexcept {
+  const RecordingContextImpl* ctx_impl = static_cast<const RecordingContextImpl*>(base_impl);
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE)) {
+    bl_var_assign_null(var_out);
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+  }
+
+  BL_PROPAGATE(bl_var_assign_weak(var_out, &ctx_impl->style[slot]));
+
+  if (!transformed)
+    return BL_SUCCESS;
+
+  BLMatrix2D adjusted_transform;
+  switch (ctx_impl->internal_state.style_type[slot]) {
+    case BL_OBJECT_TYPE_PATTERN: {
+      BLPattern& pattern = var_out->dcast().as<BLPattern>();
+      TransformInternal::multiply(adjusted_transform, pattern.transform(), ctx_impl->style_transform[slot]);
+      return pattern.set_transform(adjusted_transform);
+    }
+
+    case BL_OBJECT_TYPE_GRADIENT: {
+      BLGradient& gradient = var_out->dcast().as<BLGradient>();
+      TransformInternal::multiply(adjusted_transform, gradient.transform(), ctx_impl->style_transform[slot]);
+      return gradient.set_transform(adjusted_transform);
+    }
+
+    default:
+      return BL_SUCCESS;
+  }
+}
+
+static BLResult BL_CDECL disable_style_impl(BLContextImpl* base_impl, BLContextStyleSlot slot) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kDisableStyle, implicit_style(), slot, 0, 0, &payload));
+
+  ctx_impl->internal_state.style_type[slot] = uint8_t(BL_OBJECT_TYPE_NULL);
+  return bl_var_assign_null(&ctx_impl->style[slot]);
+}
+
+static BLResult BL_CDECL set_style_rgba32_impl(BLContextImpl* base_impl, BLContextStyleSlot slot, uint32_t rgba32) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kSetStyle, rgba32_style(rgba32), slot, 0, 0, &payload));
+
+  ctx_impl->internal_state.style_type[slot] = uint8_t(BL_OBJECT_TYPE_RGBA32);
+  return bl_var_assign_rgba32(&ctx_impl->style[slot], rgba32);
+}
+
+static BLResult BL_CDECL set_style_rgba64_impl(BLContextImpl* base_impl, BLContextStyleSlot slot, uint64_t rgba64) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BL_PROPAGATE(append_command_with_payload(ctx_impl, CommandId::kSetStyle, StyleRef{StyleKind::kRgba64, 0}, slot, rgba64));
+
+  ctx_impl->internal_state.style_type[slot] = uint8_t(BL_OBJECT_TYPE_RGBA64);
+  return bl_var_assign_rgba64(&ctx_impl->style[slot], rgba64);
+}
+
+static BLResult BL_CDECL set_style_rgba_impl(BLContextImpl* base_impl, BLContextStyleSlot slot, const BLRgba* rgba) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (!RgbaInternal::is_valid(*rgba))
+    return disable_style_impl(base_impl, slot);
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BLRgba norm = bl_clamp(*rgba, BLRgba(0.0f, 0.0f, 0.0f, 0.0f), BLRgba(1.0f, 1.0f, 1.0f, 1.0f));
+  BL_PROPAGATE(append_command_with_payload(ctx_impl, CommandId::kSetStyle, StyleRef{StyleKind::kRgba, 0}, slot, norm));
+
+  ctx_impl->internal_state.style_type[slot] = uint8_t(BL_OBJECT_TYPE_RGBA);
+  return bl_var_assign_rgba(&ctx_impl->style[slot], &norm);
+}
+
+static BLResult BL_CDECL set_style_impl(BLContextImpl* base_impl, BLContextStyleSlot slot, const BLObjectCore* style, BLContextStyleTransformMode transform_mode) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+  BLObjectType style_type = style->_d.get_type();
+
+  if (style_type <= BL_OBJECT_TYPE_NULL) {
+    if (style_type == BL_OBJECT_TYPE_RGBA32)
+      return set_style_rgba32_impl(base_impl, slot, style->_d.rgba32.value);
+
+    if (style_type == BL_OBJECT_TYPE_RGBA64)
+      return set_style_rgba64_impl(base_impl, slot, style->_d.rgba64.value);
+
+    if (style_type == BL_OBJECT_TYPE_RGBA)
+      return set_style_rgba_impl(base_impl, slot, &style->_d.rgba);
+
+    return disable_style_impl(base_impl, slot);
+  }
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE ||
+                  style_type > BL_OBJECT_TYPE_MAX_STYLE ||
+                  transform_mode > BL_CONTEXT_STYLE_TRANSFORM_MODE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  uint32_t index;
+  BL_PROPAGATE(add_object(ctx_impl, style, &index));
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kSetStyle, StyleRef{StyleKind::kObject, index}, slot, transform_mode, 0, &payload));
+
+  const BLContextState& state = ctx_impl->internal_state;
+  BLMatrix2D& style_transform = ctx_impl->style_transform[slot];
+
+  switch (transform_mode) {
+    case BL_CONTEXT_STYLE_TRANSFORM_MODE_USER: style_transform = state.final_transform; break;
+    case BL_CONTEXT_STYLE_TRANSFORM_MODE_META: style_transform = state.meta_transform; break;
+    default                                  : style_transform.reset(); break;
+  }
+
+  ctx_impl->internal_state.style_type[slot] = uint8_t(style_type);
+  return bl_var_assign_weak(&ctx_impl->style[slot], style);
+}
+
+static BLResult BL_CDECL set_style_alpha_impl(BLContextImpl* base_impl, BLContextStyleSlot slot, double alpha) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(slot > BL_CONTEXT_STYLE_SLOT_MAX_VALUE || Math::is_nan(alpha)))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  alpha = bl_clamp(alpha, 0.0, 1.0);
+  BL_PROPAGATE(append_command_with_payload(ctx_impl, CommandId::kSetStyleAlpha, implicit_style(), slot, alpha));
+
+  ctx_impl->internal_state.style_alpha[slot] = alpha;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL swap_styles_impl(BLContextImpl* base_impl, BLContextStyleSwapMode mode) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(mode > BL_CONTEXT_STYLE_SWAP_MODE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kSwapStyles, StyleRef{StyleKind::kImplicit, uint32_t(mode)}, 0, 0, 0, &payload));
+
+  BLContextState& state = ctx_impl->internal_state;
+  BLInternal::swap(ctx_impl->style[0]._d, ctx_impl->style[1]._d);
+  BLInternal::swap(ctx_impl->style_transform[0], ctx_impl->style_transform[1]);
+  BLInternal::swap(state.style_type[0], state.style_type[1]);
+
+  if (mode == BL_CONTEXT_STYLE_SWAP_MODE_STYLES_WITH_ALPHA)
+    BLInternal::swap(state.style_alpha[0], state.style_alpha[1]);
+
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Composition & Fill Options
+// ==========================================================================
+
+static BLResult BL_CDECL set_global_alpha_impl(BLContextImpl* base_impl, double alpha) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(Math::is_nan(alpha)))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  alpha = bl_clamp(alpha, 0.0, 1.0);
+  BL_PROPAGATE(append_command_with_payload(ctx_impl, CommandId::kSetGlobalAlpha, implicit_style(), 0, alpha));
+
+  ctx_impl->internal_state.global_alpha = alpha;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL set_comp_op_impl(BLContextImpl* base_impl, BLCompOp comp_op) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(comp_op) > BL_COMP_OP_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kSetCompOp, StyleRef{StyleKind::kImplicit, uint32_t(comp_op)}, 0, 0, 0, &payload));
+
+  ctx_impl->internal_state.comp_op = uint8_t(comp_op);
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL set_fill_rule_impl(BLContextImpl* base_impl, BLFillRule fill_rule) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(fill_rule) > BL_FILL_RULE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, CommandId::kSetFillRule, StyleRef{StyleKind::kImplicit, uint32_t(fill_rule)}, 0, 0, 0, &payload));
+
+  ctx_impl->internal_state.fill_rule = uint8_t(fill_rule);
+  return BL_SUCCESS;
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Stroke Options
+// ==============================================================
+
+static BL_INLINE BLResult on_stroke_changed(RecordingContextImpl* ctx_impl) noexcept {
+  ctx_impl->dirty_flags |= DirtyFlags::kStroke;
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL set_stroke_width_impl(BLContextImpl* base_impl, double width) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  ctx_impl->internal_state.stroke_options.width = width;
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_miter_limit_impl(BLContextImpl* base_impl, double miter_limit) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  ctx_impl->internal_state.stroke_options.miter_limit = miter_limit;
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_cap_impl(BLContextImpl* base_impl, BLStrokeCapPosition position, BLStrokeCap stroke_cap) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(position) > BL_STROKE_CAP_POSITION_MAX_VALUE ||
+                  uint32_t(stroke_cap) > BL_STROKE_CAP_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  ctx_impl->internal_state.stroke_options.caps[position] = uint8_t(stroke_cap);
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_caps_impl(BLContextImpl* base_impl, BLStrokeCap stroke_cap) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(stroke_cap) > BL_STROKE_CAP_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  for (uint32_t i = 0; i <= BL_STROKE_CAP_POSITION_MAX_VALUE; i++)
+    ctx_impl->internal_state.stroke_options.caps[i] = uint8_t(stroke_cap);
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_join_impl(BLContextImpl* base_impl, BLStrokeJoin stroke_join) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(stroke_join) > BL_STROKE_JOIN_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  ctx_impl->internal_state.stroke_options.join = uint8_t(stroke_join);
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_dash_offset_impl(BLContextImpl* base_impl, double dash_offset) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  ctx_impl->internal_state.stroke_options.dash_offset = dash_offset;
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_dash_array_impl(BLContextImpl* base_impl, const BLArrayCore* dash_array) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(dash_array->_d.raw_type() != BL_OBJECT_TYPE_ARRAY_FLOAT64))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BL_PROPAGATE(bl_array_assign_weak(&ctx_impl->internal_state.stroke_options.dash_array, dash_array));
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_transform_order_impl(BLContextImpl* base_impl, BLStrokeTransformOrder transform_order) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(transform_order) > BL_STROKE_TRANSFORM_ORDER_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  ctx_impl->internal_state.stroke_options.transform_order = uint8_t(transform_order);
+  return on_stroke_changed(ctx_impl);
+}
+
+static BLResult BL_CDECL set_stroke_options_impl(BLContextImpl* base_impl, const BLStrokeOptionsCore* options) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  if (BL_UNLIKELY(options->start_cap > BL_STROKE_CAP_MAX_VALUE ||
+                  options->end_cap > BL_STROKE_CAP_MAX_VALUE ||
+                  options->join > BL_STROKE_JOIN_MAX_VALUE ||
+                  options->transform_order > BL_STROKE_TRANSFORM_ORDER_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BL_PROPAGATE(bl_stroke_options_assign_weak(&ctx_impl->internal_state.stroke_options, options));
+  return on_stroke_changed(ctx_impl);
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Clip & Clear & Fill All
+// =======================================================================
+
+template<typename Rect>
+static BL_INLINE BLResult record_rect(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, const Rect* rect) noexcept {
+  return append_command_with_payload(ctx_impl, id, style, 0, *rect, box_to_bounds(ctx_impl, rect_to_box(*rect), false));
+}
+
+static BLResult BL_CDECL clip_to_rect_i_impl(BLContextImpl* base_impl, const BLRectI* rect) noexcept {
+  return append_command_with_payload(recording_impl(base_impl), CommandId::kClipToRectI, implicit_style(), 0, *rect);
+}
+
+static BLResult BL_CDECL clip_to_rect_d_impl(BLContextImpl* base_impl, const BLRect* rect) noexcept {
+  return append_command_with_payload(recording_impl(base_impl), CommandId::kClipToRectD, implicit_style(), 0, *rect);
+}
+
+static BLResult BL_CDECL restore_clipping_impl(BLContextImpl* base_impl) noexcept {
+  uint64_t* payload;
+  return append_command(recording_impl(base_impl), CommandId::kRestoreClipping, implicit_style(), 0, 0, 0, &payload);
+}
+
+static BLResult BL_CDECL clear_all_impl(BLContextImpl* base_impl) noexcept {
+  uint64_t* payload;
+  return append_command(recording_impl(base_impl), CommandId::kClearAll, implicit_style(), 0, 0, 0, &payload);
+}
+
+static BLResult BL_CDECL clear_rect_i_impl(BLContextImpl* base_impl, const BLRectI* rect) noexcept {
+  return record_rect(recording_impl(base_impl), CommandId::kClearRectI, implicit_style(), rect);
+}
+
+static BLResult BL_CDECL clear_rect_d_impl(BLContextImpl* base_impl, const BLRect* rect) noexcept {
+  return record_rect(recording_impl(base_impl), CommandId::kClearRectD, implicit_style(), rect);
+}
+
+static BLResult BL_CDECL fill_all_impl(BLContextImpl* base_impl) noexcept {
+  uint64_t* payload;
+  return append_command(recording_impl(base_impl), CommandId::kFillAll, implicit_style(), 0, 0, 0, &payload);
+}
+
+static BLResult BL_CDECL fill_all_rgba32_impl(BLContextImpl* base_impl, uint32_t rgba32) noexcept {
+  uint64_t* payload;
+  return append_command(recording_impl(base_impl), CommandId::kFillAll, rgba32_style(rgba32), 0, 0, 0, &payload);
+}
+
+static BLResult BL_CDECL fill_all_ext_impl(BLContextImpl* base_impl, const BLObjectCore* style) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  StyleRef style_ref;
+  BL_PROPAGATE(object_style(ctx_impl, style, &style_ref));
+
+  uint64_t* payload;
+  return append_command(ctx_impl, CommandId::kFillAll, style_ref, 0, 0, 0, &payload);
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Fill & Stroke Rect
+// ==================================================================
+
+static BLResult BL_CDECL fill_rect_i_impl(BLContextImpl* base_impl, const BLRectI* rect) noexcept {
+  return record_rect(recording_impl(base_impl), CommandId::kFillRectI, implicit_style(), rect);
+}
+
+static BLResult BL_CDECL fill_rect_i_rgba32_impl(BLContextImpl* base_impl, const BLRectI* rect, uint32_t rgba32) noexcept {
+  return record_rect(recording_impl(base_impl), CommandId::kFillRectI, rgba32_style(rgba32), rect);
+}
+
+static BLResult BL_CDECL fill_rect_i_ext_impl(BLContextImpl* base_impl, const BLRectI* rect, const BLObjectCore* style) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  StyleRef style_ref;
+  BL_PROPAGATE(object_style(ctx_impl, style, &style_ref));
+  return record_rect(ctx_impl, CommandId::kFillRectI, style_ref, rect);
+}
+
+static BLResult BL_CDECL fill_rect_d_impl(BLContextImpl* base_impl, const BLRect* rect) noexcept {
+  return record_rect(recording_impl(base_impl), CommandId::kFillRectD, implicit_style(), rect);
+}
+
+static BLResult BL_CDECL fill_rect_d_rgba32_impl(BLContextImpl* base_impl, const BLRect* rect, uint32_t rgba32) noexcept {
+  return record_rect(recording_impl(base_impl), CommandId::kFillRectD, rgba32_style(rgba32), rect);
+}
+
+static BLResult BL_CDECL fill_rect_d_ext_impl(BLContextImpl* base_impl, const BLRect* rect, const BLObjectCore* style) noexcept {
+  RecordingContextImpl* ctx_impl = recording_impl(base_impl);
+
+  StyleRef style_ref;
+  BL_PROPAGATE(object_style(ctx_impl, style, &style_ref));
+  return record_rect(ctx_impl, CommandId::kFillRectD, style_ref, rect);
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Fill & Stroke Path
+// ==================================================================
+
+static BLResult record_path(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, const BLPoint* origin, const BLPathCore* path) noexcept {
+  BL_ASSERT(path->_d.is_path());
+
+  uint32_t index;
+  BL_PROPAGATE(add_object(ctx_impl, path, &index));
+
+  BLBox box;
+  BLBoxI bounds = infinite_bounds();
+
+  if (path->dcast().get_control_box(&box) == BL_SUCCESS) {
+    box.reset(box.x0 + origin->x, box.y0 + origin->y, box.x1 + origin->x, box.y1 + origin->y);
+    bounds = box_to_bounds(ctx_impl, box, id == CommandId::kStrokePath);
+  }
+
+  uint64_t* payload;
+  BL_PROPAGATE(append_command(ctx_impl, id, style, 0, 0, word_count_of(sizeof(BLPoint)) + 1u, &payload, bounds));
+
+  CommandWriter writer(payload);
+  writer.write(*origin);
+  writer.write(index);
+  return BL_SUCCESS;
+}
+
+#define BL_RECORDING_DEFINE_STYLED_OP(NAME, ARGS_DECL, RECORD_FN, ...)                                               \
+  static BLResult BL_CDECL NAME##_impl(BLContextImpl* base_impl, BL_RECORDING_UNPACK ARGS_DECL) noexcept {          \
+    return RECORD_FN(recording_impl(base_impl), __VA_ARGS__, implicit_style());                                      \
+  }                                                                                                                  \
+                                                                                                                     \
+  static BLResult BL_CDECL NAME##_rgba32_impl(BLContextImpl* base_impl, BL_RECORDING_UNPACK ARGS_DECL, uint32_t rgba32) noexcept { \
+    return RECORD_FN(recording_impl(base_impl), __VA_ARGS__, rgba32_style(rgba32));                                  \
+  }                                                                                                                  \
+                                                                                                                     \
+  static BLResult BL_CDECL NAME##_ext_impl(BLContextImpl* base_impl, BL_RECORDING_UNPACK ARGS_DECL, const BLObjectCore* style) noexcept { \
+    RecordingContextImpl* ctx_impl = recording_impl(base_impl);                                                      \
+                                                                                                                     \
+    StyleRef style_ref;                                                                                              \
+    BL_PROPAGATE(object_style(ctx_impl, style, &style_ref));                                                         \
+    return RECORD_FN(ctx_impl, __VA_ARGS__, style_ref);                                                              \
+  }
+
+#define BL_RECORDING_UNPACK(...) __VA_ARGS__
+
+static BL_INLINE BLResult record_fill_path(RecordingContextImpl* ctx_impl, const BLPoint* origin, const BLPathCore* path, StyleRef style) noexcept {
+  return record_path(ctx_impl, CommandId::kFillPath, style, origin, path);
+}
+
+static BL_INLINE BLResult record_stroke_path(RecordingContextImpl* ctx_impl, const BLPoint* origin, const BLPathCore* path, StyleRef style) noexcept {
+  return record_path(ctx_impl, CommandId::kStrokePath, style, origin, path);
+}
+
+BL_RECORDING_DEFINE_STYLED_OP(fill_path_d, (const BLPoint* origin, const BLPathCore* path), record_fill_path, origin, path)
+BL_RECORDING_DEFINE_STYLED_OP(stroke_path_d, (const BLPoint* origin, const BLPathCore* path), record_stroke_path, origin, path)
+
+// bl::DisplayList - RecordingContext - Frontend - Fill & Stroke Geometry
+// ======================================================================
+
+static BLResult record_geometry(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, BLGeometryType type, const void* data) noexcept {
+  if (BL_UNLIKELY(uint32_t(type) > BL_GEOMETRY_TYPE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  if (type == BL_GEOMETRY_TYPE_NONE) {
+    // Clipping to no geometry clips everything, which is the same as clipping to an empty rectangle.
+    if (id == CommandId::kClipToGeometry)
+      return append_command_with_payload(ctx_impl, CommandId::kClipToRectD, implicit_style(), 0, BLRect(0.0, 0.0, 0.0, 0.0));
+    return BL_SUCCESS;
+  }
+
+  // Clip commands have no bounds, only render commands do.
+  BLBoxI bounds = infinite_bounds();
+  if (is_render_command(id))
+    bounds = geometry_bounds(ctx_impl, type, data, id == CommandId::kStrokeGeometry);
+
+  uint64_t* payload;
+
+  if (type <= BL_GEOMETRY_TYPE_SIMPLE_LAST) {
+    size_t size = Geometry::geometry_type_size_table[type];
+    BL_PROPAGATE(append_command(ctx_impl, id, style, type, 0, word_count_of(size), &payload, bounds));
+
+    CommandWriter(payload).write_data(data, size);
+    return BL_SUCCESS;
+  }
+
+  // Polygons and polylines are filled directly by the rendering context, so keep them inline. Stroked polygons and
+  // polylines, and array views are always converted to a path by the rendering context, so convert them only once.
+  if (id != CommandId::kStrokeGeometry && type <= BL_GEOMETRY_TYPE_POLYGOND) {
+    bool is_int = type == BL_GEOMETRY_TYPE_POLYLINEI || type == BL_GEOMETRY_TYPE_POLYGONI;
+    size_t point_size = is_int ? sizeof(BLPointI) : sizeof(BLPoint);
+
+    const BLArrayView<uint8_t>* view = static_cast<const BLArrayView<uint8_t>*>(data);
+    size_t data_size = view->size * point_size;
+
+    BL_PROPAGATE(append_command(ctx_impl, id, style, type, 0, 1u + word_count_of(data_size), &payload, bounds));
+
+    CommandWriter writer(payload);
+    writer.write(view->size);
+    writer.write_data(view->data, data_size);
+    return BL_SUCCESS;
+  }
+
+  const BLPathCore* path;
+  BLPath tmp_path;
+
+  if (type == BL_GEOMETRY_TYPE_PATH) {
+    path = static_cast<const BLPathCore*>(data);
+  }
+  else {
+    BL_PROPAGATE(tmp_path.add_geometry(type, data));
+    path = &tmp_path;
+  }
+
+  uint32_t index;
+  BL_PROPAGATE(add_object(ctx_impl, path, &index));
+  BL_PROPAGATE(append_command(ctx_impl, id, style, BL_GEOMETRY_TYPE_PATH, 0, 1u, &payload, bounds));
+
+  CommandWriter(payload).write(index);
+  return BL_SUCCESS;
+}
+
+static BL_INLINE BLResult record_fill_geometry(RecordingContextImpl* ctx_impl, BLGeometryType type, const void* data, StyleRef style) noexcept {
+  return record_geometry(ctx_impl, CommandId::kFillGeometry, style, type, data);
+}
+
+static BL_INLINE BLResult record_stroke_geometry(RecordingContextImpl* ctx_impl, BLGeometryType type, const void* data, StyleRef style) noexcept {
+  return record_geometry(ctx_impl, CommandId::kStrokeGeometry, style, type, data);
+}
+
+BL_RECORDING_DEFINE_STYLED_OP(fill_geometry, (BLGeometryType type, const void* data), record_fill_geometry, type, data)
+BL_RECORDING_DEFINE_STYLED_OP(stroke_geometry, (BLGeometryType type, const void* data), record_stroke_geometry, type, data)
+
+// Clip geometry is recorded the same way as filled geometry, it's just not styled.
+static BLResult BL_CDECL clip_to_geometry_impl(BLContextImpl* base_impl, BLGeometryType type, const void* data) noexcept {
+  return record_geometry(recording_impl(base_impl), CommandId::kClipToGeometry, implicit_style(), type, data);
+}
+
+// bl::DisplayList - RecordingContext - Frontend - Fill & Stroke Text
+// ==================================================================
+
+static BLResult record_text(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data) noexcept {
+  BL_ASSERT(font->_d.is_font());
+
+  if (BL_UNLIKELY(!font->dcast().is_valid()))
+    return bl_make_error(BL_ERROR_FONT_NOT_INITIALIZED);
+
+  // Text is shaped only once at record time, the display list only contains glyph runs.
+  const BLGlyphRun* glyph_run;
+  if (op_type <= BLContextRenderTextOp(BL_TEXT_ENCODING_MAX_VALUE)) {
+    const BLDataView* view = static_cast<const BLDataView*>(op_data);
+    BLTextEncoding encoding = static_cast<BLTextEncoding>(op_type);
+
+    BLGlyphBuffer& gb = ctx_impl->glyph_buffer;
+    BL_PROPAGATE(gb.set_text(view->data, view->size, encoding));
+    BL_PROPAGATE(font->dcast().shape(gb));
+    glyph_run = &gb.glyph_run();
+  }
+  else if (op_type == BL_CONTEXT_RENDER_TEXT_OP_GLYPH_RUN) {
+    glyph_run = static_cast<const BLGlyphRun*>(op_data);
+  }
+  else {
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+  }
+
+  size_t size = glyph_run->size;
+  if (!size)
+    return BL_SUCCESS;
+
+  if (BL_UNLIKELY(size > size_t(Traits::max_value<uint32_t>()) || glyph_run->placement_type > BL_GLYPH_PLACEMENT_TYPE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  bool has_placement = glyph_run->placement_type != BL_GLYPH_PLACEMENT_TYPE_NONE;
+  size_t glyph_data_size = size * sizeof(uint32_t);
+  size_t placement_data_size = has_placement ? size * sizeof(BLPoint) : size_t(0);
+
+  GlyphRunPayload glyph_run_payload;
+  glyph_run_payload.origin = *origin;
+  glyph_run_payload.size = uint32_t(size);
+  glyph_run_payload.placement_type = glyph_run->placement_type;
+  glyph_run_payload.flags = glyph_run->flags;
+  BL_PROPAGATE(add_object(ctx_impl, font, &glyph_run_payload.font_index));
+
+  // Glyph runs have infinite bounds as glyph bounds would have to be queried from the font, which is expensive.
+  uint64_t* payload;
+  size_t payload_words = word_count_of(sizeof(GlyphRunPayload)) + word_count_of(glyph_data_size) + word_count_of(placement_data_size);
+  BL_PROPAGATE(append_command(ctx_impl, id, style, 0, 0, payload_words, &payload));
+
+  CommandWriter writer(payload);
+  writer.write(glyph_run_payload);
+
+  // Glyph run data can be interleaved with other data, so both glyph ids and placements are copied by advance.
+  uint8_t* glyph_dst = static_cast<uint8_t*>(writer.reserve_data(glyph_data_size));
+  const uint8_t* glyph_src = static_cast<const uint8_t*>(glyph_run->glyph_data);
+
+  for (size_t i = 0; i < size; i++) {
+    memcpy(glyph_dst, glyph_src, sizeof(uint32_t));
+    glyph_dst += sizeof(uint32_t);
+    glyph_src += glyph_run->glyph_advance;
+  }
+
+  if (has_placement) {
+    uint8_t* placement_dst = static_cast<uint8_t*>(writer.reserve_data(placement_data_size));
+    const uint8_t* placement_src = static_cast<const uint8_t*>(glyph_run->placement_data);
+
+    for (size_t i = 0; i < size; i++) {
+      memcpy(placement_dst, placement_src, sizeof(BLPoint));
+      placement_dst += sizeof(BLPoint);
+      placement_src += glyph_run->placement_advance;
+    }
+  }
+
+  return BL_SUCCESS;
+}
+
+static BL_INLINE BLResult record_fill_text_d(RecordingContextImpl* ctx_impl, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data, StyleRef style) noexcept {
+  return record_text(ctx_impl, CommandId::kFillGlyphRun, style, origin, font, op_type, op_data);
+}
+
+static BL_INLINE BLResult record_fill_text_i(RecordingContextImpl* ctx_impl, const BLPointI* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data, StyleRef style) noexcept {
+  BLPoint origin_d(*origin);
+  return record_text(ctx_impl, CommandId::kFillGlyphRun, style, &origin_d, font, op_type, op_data);
+}
+
+static BL_INLINE BLResult record_stroke_text_d(RecordingContextImpl* ctx_impl, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data, StyleRef style) noexcept {
+  return record_text(ctx_impl, CommandId::kStrokeGlyphRun, style, origin, font, op_type, op_data);
+}
+
+static BL_INLINE BLResult record_stroke_text_i(RecordingContextImpl* ctx_impl, const BLPointI* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data, StyleRef style) noexcept {
+  BLPoint origin_d(*origin);
+  return record_text(ctx_impl, CommandId::kStrokeGlyphRun, style, &origin_d, font, op_type, op_data);
+}
+
+BL_RECORDING_DEFINE_STYLED_OP(fill_text_op_d, (const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data), record_fill_text_d, origin, font, op_type, op_data)
+BL_RECORDING_DEFINE_STYLED_OP(fill_text_op_i, (const BLPointI* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data), record_fill_text_i, origin, font, op_type, op_data)
+BL_RECORDING_DEFINE_STYLED_OP(stroke_text_op_d, (const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data), record_stroke_text_d, origin, font, op_type, op_data)
+BL_RECORDING_DEFINE_STYLED_OP(stroke_text_op_i, (const BLPointI* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* op_data), record_stroke_text_i, origin, font, op_type, op_data)
+
+// bl::DisplayList - RecordingContext - Frontend - Fill Mask & Blit Image
+// ======================================================================
+
+template<typename Dst>
+static BLResult record_image_op(RecordingContextImpl* ctx_impl, CommandId id, StyleRef style, const Dst* dst, const BLImageCore* image, const BLRectI* area) noexcept {
+  BL_ASSERT(image->_d.is_image());
+
+  uint32_t index;
+  BL_PROPAGATE(add_object(ctx_impl, image, &index));
+
+  // Blit commands don't use a style, so the header value stores the size of the destination instead.
+  if (id >= CommandId::kBlitImageI)
+    style = StyleRef{StyleKind::kImplicit, uint32_t(sizeof(Dst))};
+
+  BLBox box;
+  if constexpr (std::is_same_v<Dst, BLPointI> || std::is_same_v<Dst, BLPoint>) {
+    // Unscaled images and masks are rendered at `dst` by using the size of the area or the whole image.
+    BLSizeI size = area ? BLSizeI(area->w, area->h) : image->dcast().size();
+    box.reset(double(dst->x), double(dst->y), double(dst->x) + double(size.w), double(dst->y) + double(size.h));
+  }
+  else {
+    box = rect_to_box(*dst);
+  }
+
+  uint64_t* payload;
+  size_t payload_words = word_count_of(sizeof(Dst)) + 1u + (area ? word_count_of(sizeof(BLRectI)) : size_t(0));
+  BL_PROPAGATE(append_command(ctx_impl, id, style, 0, area != nullptr, payload_words, &payload, box_to_bounds(ctx_impl, box, false)));
+
+  CommandWriter writer(payload);
+  writer.write(*dst);
+  writer.write(index);
+
+  if (area)
+    writer.write(*area);
+
+  return BL_SUCCESS;
+}
+
+static BL_INLINE BLResult record_fill_mask_i(RecordingContextImpl* ctx_impl, const BLPointI* origin, const BLImageCore* mask, const BLRectI* mask_area, StyleRef style) noexcept {
+  return record_image_op(ctx_impl, CommandId::kFillMaskI, style, origin, mask, mask_area);
+}
+
+static BL_INLINE BLResult record_fill_mask_d(RecordingContextImpl* ctx_impl, const BLPoint* origin, const BLImageCore* mask, const BLRectI* mask_area, StyleRef style) noexcept {
+  return record_image_op(ctx_impl, CommandId::kFillMaskD, style, origin, mask, mask_area);
+}
+
+BL_RECORDING_DEFINE_STYLED_OP(fill_mask_i, (const BLPointI* origin, const BLImageCore* mask, const BLRectI* mask_area), record_fill_mask_i, origin, mask, mask_area)
+BL_RECORDING_DEFINE_STYLED_OP(fill_mask_d, (const BLPoint* origin, const BLImageCore* mask, const BLRectI* mask_area), record_fill_mask_d, origin, mask, mask_area)
+
+#undef BL_RECORDING_UNPACK
+#undef BL_RECORDING_DEFINE_STYLED_OP
+
+static BLResult BL_CDECL blit_image_i_impl(BLContextImpl* base_impl, const BLPointI* origin, const BLImageCore* img, const BLRectI* img_area) noexcept {
+  return record_image_op(recording_impl(base_impl), CommandId::kBlitImageI, implicit_style(), origin, img, img_area);
+}
+
+static BLResult BL_CDECL blit_image_d_impl(BLContextImpl* base_impl, const BLPoint* origin, const BLImageCore* img, const BLRectI* img_area) noexcept {
+  return record_image_op(recording_impl(base_impl), CommandId::kBlitImageD, implicit_style(), origin, img, img_area);
+}
+
+static BLResult BL_CDECL blit_scaled_image_i_impl(BLContextImpl* base_impl, const BLRectI* rect, const BLImageCore* img, const BLRectI* img_area) noexcept {
+  return record_image_op(recording_impl(base_impl), CommandId::kBlitScaledImageI, implicit_style(), rect, img, img_area);
+}
+
+static BLResult BL_CDECL blit_scaled_image_d_impl(BLContextImpl* base_impl, const BLRect* rect, const BLImageCore* img, const BLRectI* img_area) noexcept {
+  return record_image_op(recording_impl(base_impl), CommandId::kBlitScaledImageD, implicit_style(), rect, img, img_area);
+}
+
+// bl::DisplayList - RecordingContext - Destroy
+// ============================================
+
+static BLResult BL_CDECL destroy_impl(BLObjectImpl* impl) noexcept {
+  RecordingContextImpl* ctx_impl = static_cast<RecordingContextImpl*>(impl);
+
+  SavedState* saved_state = ctx_impl->saved_state;
+  while (saved_state) {
+    SavedState* prev_state = saved_state->prev_state;
+    free_saved_state(saved_state);
+    saved_state = prev_state;
+  }
+
+  // The display list becomes immutable and can be replayed after the recording ends.
+  display_list_impl(ctx_impl)->recording = 0;
+  release_instance(&ctx_impl->display_list);
+
+  ContextInternal::destroy_state(&ctx_impl->internal_state);
+  bl_var_destroy(&ctx_impl->style[0]);
+  bl_var_destroy(&ctx_impl->style[1]);
+  bl_call_dtor(ctx_impl->glyph_buffer);
+
+  return bl_object_free_impl(ctx_impl);
+}
+
+// bl::DisplayList - RecordingContext - Virtual Function Table
+// ===========================================================
+
+static void init_virt(BLContextVirt* virt) noexcept {
+  virt->base.destroy                = destroy_impl;
+  virt->base.get_property           = bl_object_impl_get_property;
+  virt->base.set_property           = bl_object_impl_set_property;
+  virt->flush                       = flush_impl;
+
+  virt->save                        = save_impl;
+  virt->restore                     = restore_impl;
+  virt->begin_layer                 = begin_layer_impl;
+  virt->end_layer                   = end_layer_impl;
+
+  virt->apply_transform_op          = apply_transform_op_impl;
+  virt->user_to_meta                = user_to_meta_impl;
+
+  virt->set_hint                    = set_hint_impl;
+  virt->set_hints                   = set_hints_impl;
+
+  virt->set_flatten_mode            = set_flatten_mode_impl;
+  virt->set_flatten_tolerance       = set_flatten_tolerance_impl;
+  virt->set_approximation_options   = set_approximation_options_impl;
+
+  virt->get_style                   = get_style_impl;
+  virt->set_style                   = set_style_impl;
+  virt->disable_style               = disable_style_impl;
+  virt->set_style_rgba              = set_style_rgba_impl;
+  virt->set_style_rgba32            = set_style_rgba32_impl;
+  virt->set_style_rgba64            = set_style_rgba64_impl;
+  virt->set_style_alpha             = set_style_alpha_impl;
+  virt->swap_styles                 = swap_styles_impl;
+
+  virt->set_global_alpha            = set_global_alpha_impl;
+  virt->set_comp_op                 = set_comp_op_impl;
+
+  virt->set_fill_rule               = set_fill_rule_impl;
+  virt->set_stroke_width            = set_stroke_width_impl;
+  virt->set_stroke_miter_limit      = set_stroke_miter_limit_impl;
+  virt->set_stroke_cap              = set_stroke_cap_impl;
+  virt->set_stroke_caps             = set_stroke_caps_impl;
+  virt->set_stroke_join             = set_stroke_join_impl;
+  virt->set_stroke_transform_order  = set_stroke_transform_order_impl;
+  virt->set_stroke_dash_offset      = set_stroke_dash_offset_impl;
+  virt->set_stroke_dash_array       = set_stroke_dash_array_impl;
+  virt->set_stroke_options          = set_stroke_options_impl;
+
+  virt->clip_to_rect_i              = clip_to_rect_i_impl;
+  virt->clip_to_rect_d              = clip_to_rect_d_impl;
+  virt->restore_clipping            = restore_clipping_impl;
+  virt->clip_to_geometry            = clip_to_geometry_impl;
+
+  virt->clear_all                   = clear_all_impl;
+  virt->clear_recti                 = clear_rect_i_impl;
+  virt->clear_rectd                 = clear_rect_d_impl;
+
+  virt->fill_all                    = fill_all_impl;
+  virt->fill_all_rgba32             = fill_all_rgba32_impl;
+  virt->fill_all_ext                = fill_all_ext_impl;
+
+  virt->fill_rect_i                 = fill_rect_i_impl;
+  virt->fill_rect_i_rgba32          = fill_rect_i_rgba32_impl;
+  virt->fill_rect_i_ext             = fill_rect_i_ext_impl;
+
+  virt->fill_rect_d                 = fill_rect_d_impl;
+  virt->fill_rect_d_rgba32          = fill_rect_d_rgba32_impl;
+  virt->fill_rect_d_ext             = fill_rect_d_ext_impl;
+
+  virt->fill_path_d                 = fill_path_d_impl;
+  virt->fill_path_d_rgba32          = fill_path_d_rgba32_impl;
+  virt->fill_path_d_ext             = fill_path_d_ext_impl;
+
+  virt->fill_geometry               = fill_geometry_impl;
+  virt->fill_geometry_rgba32        = fill_geometry_rgba32_impl;
+  virt->fill_geometry_ext           = fill_geometry_ext_impl;
+
+  virt->fill_text_op_i              = fill_text_op_i_impl;
+  virt->fill_text_op_i_rgba32       = fill_text_op_i_rgba32_impl;
+  virt->fill_text_op_i_ext          = fill_text_op_i_ext_impl;
+
+  virt->fill_text_op_d              = fill_text_op_d_impl;
+  virt->fill_text_op_d_rgba32       = fill_text_op_d_rgba32_impl;
+  virt->fill_text_op_d_ext          = fill_text_op_d_ext_impl;
+
+  virt->fill_mask_i                 = fill_mask_i_impl;
+  virt->fill_mask_i_rgba32          = fill_mask_i_rgba32_impl;
+  virt->fill_mask_i_ext             = fill_mask_i_ext_impl;
+
+  virt->fill_mask_d                 = fill_mask_d_impl;
+  virt->fill_mask_d_Rgba32          = fill_mask_d_rgba32_impl;
+  virt->fill_mask_d_ext             = fill_mask_d_ext_impl;
+
+  virt->stroke_path_d               = stroke_path_d_impl;
+  virt->stroke_path_d_rgba32        = stroke_path_d_rgba32_impl;
+  virt->stroke_path_d_ext           = stroke_path_d_ext_impl;
+
+  virt->stroke_geometry             = stroke_geometry_impl;
+  virt->stroke_geometry_rgba32      = stroke_geometry_rgba32_impl;
+  virt->stroke_geometry_ext         = stroke_geometry_ext_impl;
+
+  virt->stroke_text_op_i            = stroke_text_op_i_impl;
+  virt->stroke_text_op_i_rgba32     = stroke_text_op_i_rgba32_impl;
+  virt->stroke_text_op_i_ext        = stroke_text_op_i_ext_impl;
+
+  virt->stroke_text_op_d            = stroke_text_op_d_impl;
+  virt->stroke_text_op_d_rgba32     = stroke_text_op_d_rgba32_impl;
+  virt->stroke_text_op_d_ext        = stroke_text_op_d_ext_impl;
+
+  virt->blit_image_i                = blit_image_i_impl;
+  virt->blit_image_d                = blit_image_d_impl;
+
+  virt->blit_scaled_image_i         = blit_scaled_image_i_impl;
+  virt->blit_scaled_image_d         = blit_scaled_image_d_impl;
+}
+
+} // {DisplayListInternal}
+} // {bl}
+
+// bl::DisplayList - RecordingContext - Runtime Registration
+// =========================================================
+
+BLResult bl_display_list_context_init_impl(BLContextCore* self, BLDisplayListCore* display_list, const BLSize* size) noexcept {
+  using namespace bl::DisplayListInternal;
+
+  if (BL_UNLIKELY(!(size->w > 0.0 && size->h > 0.0 && bl::Math::is_finite(size->w, size->h))))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_CONTEXT);
+  BL_PROPAGATE(bl::ObjectInternal::alloc_impl_t<RecordingContextImpl>(self, info));
+
+  RecordingContextImpl* ctx_impl = static_cast<RecordingContextImpl*>(self->_d.impl);
+  BLResult result = begin_recording(display_list, *size);
+
+  if (BL_UNLIKELY(result != BL_SUCCESS)) {
+    bl_object_free_impl(ctx_impl);
+    return result;
+  }
+
+  ctx_impl->virt = &recording_context_virt;
+  ctx_impl->state = &ctx_impl->internal_state;
+  ctx_impl->context_type = BL_CONTEXT_TYPE_PROXY;
+
+  // The initial state must match the state `replay()` resets the target rendering context to.
+  BLContextState& state = ctx_impl->internal_state;
+  bl::ContextInternal::init_state(&state);
+  state.target_size = *size;
+  state.hints = make_initial_hints();
+  state.final_transform.reset();
+
+  for (uint32_t slot = 0; slot <= BL_CONTEXT_STYLE_SLOT_MAX_VALUE; slot++) {
+    bl_var_init_rgba32(&ctx_impl->style[slot], kInitialStyleRgba32);
+    ctx_impl->style_transform[slot].reset();
+    state.style_type[slot] = uint8_t(BL_OBJECT_TYPE_RGBA32);
+  }
+
+  ctx_impl->display_list._d = display_list->_d;
+  retain_instance(&ctx_impl->display_list);
+
+  ctx_impl->saved_state = nullptr;
+  ctx_impl->context_origin_id = BLUniqueIdGenerator::generate_id(BLUniqueIdGenerator::Domain::kContext);
+  ctx_impl->state_id_counter = 0;
+  ctx_impl->saved_state_limit = kDefaultSavedStateLimit;
+  ctx_impl->dirty_flags = DirtyFlags::kNone;
+  bl_call_ctor(ctx_impl->glyph_buffer);
+
+  return BL_SUCCESS;
+}
+
+void bl_display_list_context_on_init(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+  bl::DisplayListInternal::init_virt(&bl::DisplayListInternal::recording_context_virt);
+}
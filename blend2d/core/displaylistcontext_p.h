@@ -0,0 +1,28 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_DISPLAYLISTCONTEXT_P_H_INCLUDED
+#define BLEND2D_DISPLAYLISTCONTEXT_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/context_p.h>
+#include <blend2d/core/displaylist_p.h>
+#include <blend2d/core/runtime_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+//! Creates a proxy rendering context (\ref BL_CONTEXT_TYPE_PROXY) that records into `display_list` and assigns it to
+//! `self`, which must be an uninitialized \ref BLContextCore.
+BL_HIDDEN BLResult bl_display_list_context_init_impl(BLContextCore* self, BLDisplayListCore* display_list, const BLSize* size) noexcept;
+
+//! Initializes the virtual function table of the proxy rendering context, called by `bl_context_rt_init()`.
+BL_HIDDEN void bl_display_list_context_on_init(BLRuntimeContext* rt) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_DISPLAYLISTCONTEXT_P_H_INCLUDED
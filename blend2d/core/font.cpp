@@ -10,6 +10,7 @@
 #include <blend2d/core/font_p.h>
 #include <blend2d/core/fontface_p.h>
 #include <blend2d/core/fontfeaturesettings_p.h>
+#include <blend2d/core/fontshapecache_p.h>
 #include <blend2d/core/matrix.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/path.h>
@@ -410,10 +411,7 @@ BL_API_IMPL BLResult bl_font_reset_variation_settings(BLFontCore* self) noexcept
 // bl::Font - Shaping
 // ==================
 
-BL_API_IMPL BLResult bl_font_shape(const BLFontCore* self, BLGlyphBufferCore* gb) noexcept {
-  using namespace bl::FontInternal;
-  BL_ASSERT(self->_d.is_font());
-
+static BLResult bl_font_shape_uncached(const BLFontCore* self, BLGlyphBufferCore* gb) noexcept {
   BL_PROPAGATE(bl_font_map_text_to_glyphs(self, gb, nullptr));
 
   bl::OpenType::OTFaceImpl* ot_face_impl = bl::FontFaceInternal::get_impl<bl::OpenType::OTFaceImpl>(&self->dcast().face());
@@ -426,6 +424,52 @@ BL_API_IMPL BLResult bl_font_shape(const BLFontCore* self, BLGlyphBufferCore* gb
   return bl_font_position_glyphs(self, gb);
 }
 
+BL_API_IMPL BLResult bl_font_shape(const BLFontCore* self, BLGlyphBufferCore* gb) noexcept {
+  using namespace bl::FontInternal;
+  BL_ASSERT(self->_d.is_font());
+
+  BLFontPrivateImpl* self_impl = get_impl(self);
+  BLGlyphBufferPrivateImpl* gb_impl = bl_glyph_buffer_get_impl(gb);
+
+  size_t size = gb_impl->size;
+  ShapeCache& cache = shape_cache_global;
+
+  // Only short text, which was not mapped to glyphs yet, is cached. Shaping is never cached when a debug sink
+  // is used, as the sink wants to see messages produced by the shaper.
+  if (!cache.is_enabled() ||
+      size == 0u || size > kShapeCacheMaxTextSize ||
+      !(gb_impl->flags & BL_GLYPH_RUN_FLAG_UCS4_CONTENT) ||
+      gb_impl->debug_sink) {
+    return bl_font_shape_uncached(self, gb);
+  }
+
+  // Shaping modifies the glyph buffer in place, so the text has to be copied to form a key of a new entry.
+  uint32_t text[kShapeCacheMaxTextSize];
+  BLGlyphInfo info[kShapeCacheMaxTextSize];
+
+  memcpy(text, gb_impl->content, size * sizeof(uint32_t));
+  memcpy(info, gb_impl->info_data, size * sizeof(BLGlyphInfo));
+
+  ShapeCacheKey key{
+    self_impl->face.dcast().unique_id(),
+    &self_impl->feature_settings.dcast(),
+    &self_impl->variation_settings.dcast(),
+    text,
+    info,
+    size,
+    gb_impl->flags
+  };
+
+  bool found;
+  BL_PROPAGATE(cache.get(key, gb_impl, found));
+
+  if (found)
+    return BL_SUCCESS;
+
+  BL_PROPAGATE(bl_font_shape_uncached(self, gb));
+  return cache.put(key, gb_impl);
+}
+
 BL_API_IMPL BLResult bl_font_map_text_to_glyphs(const BLFontCore* self, BLGlyphBufferCore* gb, BLGlyphMappingState* state_out) noexcept {
   using namespace bl::FontInternal;
   BL_ASSERT(self->_d.is_font());
@@ -620,6 +664,39 @@ static BLResult BL_CDECL bl_font_dummy_path_sink(BLPathCore* path, const void* i
   return BL_SUCCESS;
 }
 
+namespace bl {
+namespace FontInternal {
+
+//! Decodes glyph outlines of a font, which is either a default or a variable instance of its font face.
+struct GlyphOutlineDecoder {
+  BLFontFacePrivateImpl* face_impl;
+  bool is_variable;
+  FontVariationCoords coords;
+
+  BL_INLINE BLResult init(const BLFontPrivateImpl* font_impl, BLFontFacePrivateImpl* face_impl_) noexcept {
+    face_impl = face_impl_;
+    is_variable = false;
+
+    if (font_impl->variation_settings.dcast().is_empty())
+      return BL_SUCCESS;
+
+    // Normalized coordinates are resolved once per call, they are also used as a key to look up cached outlines.
+    BL_PROPAGATE(face_impl->funcs.get_variation_coords(face_impl, &font_impl->variation_settings, &coords));
+    is_variable = !coords.is_default();
+    return BL_SUCCESS;
+  }
+
+  BL_INLINE BLResult decode(BLGlyphId glyph_id, const BLMatrix2D* transform, BLPath* out, size_t* contour_count_out, ScopedBuffer* tmp_buffer) const noexcept {
+    if (is_variable)
+      return face_impl->funcs.get_glyph_outlines_var(face_impl, glyph_id, &coords, transform, out, contour_count_out, tmp_buffer);
+    else
+      return face_impl->funcs.get_glyph_outlines(face_impl, glyph_id, transform, out, contour_count_out, tmp_buffer);
+  }
+};
+
+} // {FontInternal}
+} // {bl}
+
 BL_API_IMPL BLResult bl_font_get_glyph_outlines(const BLFontCore* self, BLGlyphId glyph_id, const BLMatrix2D* user_transform, BLPathCore* out, BLPathSinkFunc sink, void* user_data) noexcept {
   using namespace bl::FontInternal;
   BL_ASSERT(self->_d.is_font());
@@ -635,9 +712,12 @@ BL_API_IMPL BLResult bl_font_get_glyph_outlines(const BLFontCore* self, BLGlyphI
   else
     final_transform.reset(fMat.m00, fMat.m01, fMat.m10, fMat.m11, 0.0, 0.0);
 
+  GlyphOutlineDecoder decoder;
+  BL_PROPAGATE(decoder.init(self_impl, face_impl));
+
   bl::ScopedBufferTmp<BL_FONT_GET_GLYPH_OUTLINE_BUFFER_SIZE> tmp_buffer;
   BLGlyphOutlineSinkInfo sink_info;
-  BL_PROPAGATE(face_impl->funcs.get_glyph_outlines(face_impl, glyph_id, &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
+  BL_PROPAGATE(decoder.decode(glyph_id, &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
 
   if (!sink)
     return BL_SUCCESS;
@@ -673,9 +753,11 @@ BL_API_IMPL BLResult bl_font_get_glyph_run_outlines(const BLFontCore* self, cons
   bl::ScopedBufferTmp<BL_FONT_GET_GLYPH_OUTLINE_BUFFER_SIZE> tmp_buffer;
   BLGlyphOutlineSinkInfo sink_info;
 
+  GlyphOutlineDecoder decoder;
+  BL_PROPAGATE(decoder.init(self_impl, face_impl));
+
   uint32_t placement_type = glyph_run->placement_type;
   BLGlyphRunIterator it(*glyph_run);
-  auto get_glyph_outlines_func = face_impl->funcs.get_glyph_outlines;
 
   if (it.has_placement() && placement_type != BL_GLYPH_PLACEMENT_TYPE_NONE) {
     BLMatrix2D offset_transform(1.0, 0.0, 0.0, 1.0, final_transform.m20, final_transform.m21);
@@ -712,7 +794,7 @@ BL_API_IMPL BLResult bl_font_get_glyph_run_outlines(const BLFontCore* self, cons
         final_transform.m21 = px * offset_transform.m01 + py * offset_transform.m11 + oy;
 
         sink_info.glyph_index = it.index;
-        BL_PROPAGATE(get_glyph_outlines_func(face_impl, it.glyph_id(), &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
+        BL_PROPAGATE(decoder.decode(it.glyph_id(), &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
         BL_PROPAGATE(sink(out, &sink_info, user_data));
         it.advance();
 
@@ -729,7 +811,7 @@ BL_API_IMPL BLResult bl_font_get_glyph_run_outlines(const BLFontCore* self, cons
         final_transform.m21 = placement.x * offset_transform.m01 + placement.y * offset_transform.m11 + offset_transform.m21;
 
         sink_info.glyph_index = it.index;
-        BL_PROPAGATE(get_glyph_outlines_func(face_impl, it.glyph_id(), &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
+        BL_PROPAGATE(decoder.decode(it.glyph_id(), &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
         BL_PROPAGATE(sink(out, &sink_info, user_data));
         it.advance();
       }
@@ -738,7 +820,7 @@ BL_API_IMPL BLResult bl_font_get_glyph_run_outlines(const BLFontCore* self, cons
   else {
     while (!it.at_end()) {
       sink_info.glyph_index = it.index;
-      BL_PROPAGATE(get_glyph_outlines_func(face_impl, it.glyph_id(), &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
+      BL_PROPAGATE(decoder.decode(it.glyph_id(), &final_transform, static_cast<BLPath*>(out), &sink_info.contour_count, &tmp_buffer));
       BL_PROPAGATE(sink(out, &sink_info, user_data));
       it.advance();
     }
@@ -751,12 +833,12 @@ BL_API_IMPL BLResult bl_font_get_glyph_run_outlines(const BLFontCore* self, cons
 // ===============================
 
 void bl_font_rt_init(BLRuntimeContext* rt) noexcept {
-  bl_unused(rt);
-
   // Initialize BLFont built-ins.
   bl_font_impl_ctor(&bl::FontInternal::default_font.impl);
 
   bl_object_defaults[BL_OBJECT_TYPE_FONT]._d.init_dynamic(
     BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_FONT),
     &bl::FontInternal::default_font.impl);
+
+  bl_font_shape_cache_rt_init(rt);
 }
@@ -78,6 +78,28 @@ static BLResult BL_CDECL bl_null_font_face_get_glyph_outlines(
   return bl_make_error(BL_ERROR_FONT_NOT_INITIALIZED);
 }
 
+static BLResult BL_CDECL bl_null_font_face_get_variation_coords(
+  const BLFontFaceImpl* impl,
+  const BLFontVariationSettingsCore* settings,
+  bl::FontVariationCoords* coords_out) noexcept {
+
+  coords_out->reset();
+  return BL_SUCCESS;
+}
+
+static BLResult BL_CDECL bl_null_font_face_get_glyph_outlines_var(
+  const BLFontFaceImpl* impl,
+  BLGlyphId glyph_id,
+  const bl::FontVariationCoords* coords,
+  const BLMatrix2D* user_transform,
+  BLPath* out,
+  size_t* contour_count_out,
+  bl::ScopedBuffer* tmp_buffer) noexcept {
+
+  *contour_count_out = 0;
+  return bl_make_error(BL_ERROR_FONT_NOT_INITIALIZED);
+}
+
 static BLResult BL_CDECL bl_null_font_face_apply_kern(
   const BLFontFaceImpl* face_impl,
   uint32_t* glyph_data,
@@ -377,6 +399,8 @@ void bl_font_face_rt_init(BLRuntimeContext* rt) noexcept {
   bl_null_font_face_funcs.get_glyph_bounds = bl_null_font_face_get_glyph_bounds;
   bl_null_font_face_funcs.get_glyph_advances = bl_null_font_face_get_glyph_advances;
   bl_null_font_face_funcs.get_glyph_outlines = bl_null_font_face_get_glyph_outlines;
+  bl_null_font_face_funcs.get_variation_coords = bl_null_font_face_get_variation_coords;
+  bl_null_font_face_funcs.get_glyph_outlines_var = bl_null_font_face_get_glyph_outlines_var;
   bl_null_font_face_funcs.apply_kern = bl_null_font_face_apply_kern;
   bl_null_font_face_funcs.apply_gsub = bl_null_font_face_apply_gsub;
   bl_null_font_face_funcs.apply_gpos = bl_null_font_face_apply_gpos;
@@ -24,6 +24,39 @@ struct OTFaceImpl;
 //! \addtogroup blend2d_internal
 //! \{
 
+namespace bl {
+
+//! Maximum number of variation axes of a font face that are considered when applying font variations.
+static constexpr uint32_t kFontVariationMaxAxes = 64;
+
+//! Normalized variation coordinates of a font instance.
+//!
+//! Coordinates are normalized to [-1, 1] range (including 'avar' mapping) and stored as F2Dot14 values in the same
+//! order as the axes of the font face. A default instance has all coordinates zero.
+struct FontVariationCoords {
+  uint32_t axis_count;
+  int16_t values[kFontVariationMaxAxes];
+
+  BL_INLINE void reset() noexcept {
+    axis_count = 0;
+  }
+
+  [[nodiscard]]
+  BL_INLINE bool is_default() const noexcept {
+    for (uint32_t i = 0; i < axis_count; i++)
+      if (values[i] != 0)
+        return false;
+    return true;
+  }
+
+  [[nodiscard]]
+  BL_INLINE bool equals(const FontVariationCoords& other) const noexcept {
+    return axis_count == other.axis_count && memcmp(values, other.values, axis_count * sizeof(int16_t)) == 0;
+  }
+};
+
+} // {bl}
+
 //! \name BLFontFace - Internal Memory Management
 //! \{
 
@@ -56,6 +89,20 @@ struct BLFontFacePrivateFuncs {
     size_t* contour_count_out,
     bl::ScopedBuffer* tmp_buffer) noexcept;
 
+  BLResult (BL_CDECL* get_variation_coords)(
+    const BLFontFaceImpl* impl,
+    const BLFontVariationSettingsCore* settings,
+    bl::FontVariationCoords* coords_out) noexcept;
+
+  BLResult (BL_CDECL* get_glyph_outlines_var)(
+    const BLFontFaceImpl* impl,
+    BLGlyphId glyph_id,
+    const bl::FontVariationCoords* coords,
+    const BLMatrix2D* user_transform,
+    BLPath* out,
+    size_t* contour_count_out,
+    bl::ScopedBuffer* tmp_buffer) noexcept;
+
   BLResult (BL_CDECL* apply_kern)(
     const BLFontFaceImpl* face_impl,
     uint32_t* glyph_data,
@@ -0,0 +1,194 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/fontshapecache_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/hashops_p.h>
+
+namespace bl {
+namespace FontInternal {
+
+// bl::Font - ShapeCache - Globals
+// ===============================
+
+Wrap<ShapeCache> shape_cache_global;
+
+// bl::Font - ShapeCache - Key
+// ===========================
+
+uint32_t ShapeCacheKey::hash_code() const noexcept {
+  BLFontFeatureSettingsView feature_view;
+  BLFontVariationSettingsView variation_view;
+
+  feature_settings->get_view(&feature_view);
+  variation_settings->get_view(&variation_view);
+
+  uint32_t hash = HashOps::hash_mix_u64(0, face_id);
+  hash = HashOps::hash_mix_u64(hash, (uint64_t(size) << 32) | flags);
+
+  for (size_t i = 0; i < feature_view.size; i++)
+    hash = HashOps::hash_mix_u64(hash, (uint64_t(feature_view.data[i].tag) << 32) | feature_view.data[i].value);
+
+  for (size_t i = 0; i < variation_view.size; i++) {
+    uint32_t value_bits;
+    memcpy(&value_bits, &variation_view.data[i].value, sizeof(value_bits));
+    hash = HashOps::hash_mix_u64(hash, (uint64_t(variation_view.data[i].tag) << 32) | value_bits);
+  }
+
+  for (size_t i = 0; i < size; i++)
+    hash = HashOps::hash_mix_u64(hash, (uint64_t(text[i]) << 32) | info[i].cluster);
+
+  return hash;
+}
+
+bool ShapeCache::KeyMatcher::matches(const Node* node) const noexcept {
+  return node->face_id == _key.face_id &&
+         node->text_size == _key.size &&
+         node->text_flags == _key.flags &&
+         memcmp(node->text(), _key.text, _key.size * sizeof(uint32_t)) == 0 &&
+         memcmp(node->text_info(), _key.info, _key.size * sizeof(BLGlyphInfo)) == 0 &&
+         node->feature_settings.equals(*_key.feature_settings) &&
+         node->variation_settings.equals(*_key.variation_settings);
+}
+
+// bl::Font - ShapeCache - Interface
+// =================================
+
+void ShapeCache::set_limit(size_t count_limit) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  bl_atomic_store_relaxed(&_count_limit, count_limit);
+  _evict(0);
+}
+
+BLResult ShapeCache::get(const ShapeCacheKey& key, BLGlyphBufferPrivateImpl* gb_impl, bool& found) noexcept {
+  KeyMatcher matcher{key, key.hash_code()};
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  Node* node = _map.get(matcher);
+  if (!node) {
+    _miss_count++;
+    found = false;
+    return BL_SUCCESS;
+  }
+
+  _hit_count++;
+  if (node != _lru.first()) {
+    _lru.unlink(node);
+    _lru.prepend(node);
+  }
+
+  // The result is copied while the lock is held as the node could be evicted by another thread otherwise.
+  size_t glyph_size = node->glyph_size;
+  BL_PROPAGATE(gb_impl->ensure_buffer(0, 0, glyph_size));
+
+  gb_impl->size = glyph_size;
+  memcpy(gb_impl->content, node->glyphs(), glyph_size * sizeof(uint32_t));
+  memcpy(gb_impl->info_data, node->glyph_info(), glyph_size * sizeof(BLGlyphInfo));
+
+  BL_PROPAGATE(gb_impl->ensure_placement());
+  memcpy(gb_impl->placement_data, node->placements(), glyph_size * sizeof(BLGlyphPlacement));
+
+  gb_impl->flags = node->glyph_flags;
+  gb_impl->glyph_run.placement_type = node->placement_type;
+
+  found = true;
+  return BL_SUCCESS;
+}
+
+BLResult ShapeCache::put(const ShapeCacheKey& key, const BLGlyphBufferPrivateImpl* gb_impl) noexcept {
+  size_t glyph_size = gb_impl->size;
+
+  KeyMatcher matcher{key, key.hash_code()};
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  if (!_count_limit || !gb_impl->placement_data)
+    return BL_SUCCESS;
+
+  // Another thread could have inserted the same result while this one was shaping the text.
+  if (_map.get(matcher))
+    return BL_SUCCESS;
+
+  _evict(1);
+
+  Node* node = static_cast<Node*>(malloc(Node::size_of(key.size, glyph_size)));
+  if (BL_UNLIKELY(!node))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  bl_call_ctor(*node, matcher.hash_code(), key, glyph_size, gb_impl->flags, gb_impl->glyph_run.placement_type);
+  memcpy(node->text(), key.text, key.size * sizeof(uint32_t));
+  memcpy(node->text_info(), key.info, key.size * sizeof(BLGlyphInfo));
+  memcpy(node->glyphs(), gb_impl->content, glyph_size * sizeof(uint32_t));
+  memcpy(node->glyph_info(), gb_impl->info_data, glyph_size * sizeof(BLGlyphInfo));
+  memcpy(node->placements(), gb_impl->placement_data, glyph_size * sizeof(BLGlyphPlacement));
+
+  _map.insert(node);
+  _lru.prepend(node);
+
+  return BL_SUCCESS;
+}
+
+void ShapeCache::clear() noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  while (!_lru.is_empty())
+    _remove_node(_lru.last());
+
+  _map.reset();
+  _allocator.reset();
+}
+
+// bl::Font - ShapeCache - Internals
+// =================================
+
+void ShapeCache::_evict(size_t required_count) noexcept {
+  while (!_lru.is_empty() && _map.size() + required_count > _count_limit)
+    _remove_node(_lru.last());
+}
+
+void ShapeCache::_remove_node(Node* node) noexcept {
+  _map.remove(node);
+  _lru.unlink(node);
+
+  bl_call_dtor(*node);
+  free(node);
+}
+
+} // {FontInternal}
+} // {bl}
+
+// bl::Font - ShapeCache - Runtime Registration
+// ============================================
+
+static void BL_CDECL bl_font_shape_cache_rt_shutdown(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+  bl::FontInternal::shape_cache_global.destroy();
+}
+
+static void BL_CDECL bl_font_shape_cache_rt_cleanup(BLRuntimeContext* rt, BLRuntimeCleanupFlags cleanup_flags) noexcept {
+  bl_unused(rt);
+  if (cleanup_flags & BL_RUNTIME_CLEANUP_SHAPE_CACHE)
+    bl::FontInternal::shape_cache_global->clear();
+}
+
+static void BL_CDECL bl_font_shape_cache_rt_resource_info(BLRuntimeContext* rt, BLRuntimeResourceInfo* resource_info) noexcept {
+  bl_unused(rt);
+  resource_info->shape_cache_count = bl::FontInternal::shape_cache_global->size();
+  resource_info->shape_cache_hit_count = size_t(bl::FontInternal::shape_cache_global->hit_count());
+  resource_info->shape_cache_miss_count = size_t(bl::FontInternal::shape_cache_global->miss_count());
+}
+
+void bl_font_rt_set_shape_cache_limit(size_t count_limit) noexcept {
+  bl::FontInternal::shape_cache_global->set_limit(count_limit);
+}
+
+void bl_font_shape_cache_rt_init(BLRuntimeContext* rt) noexcept {
+  bl::FontInternal::shape_cache_global.init();
+
+  rt->shutdown_handlers.add(bl_font_shape_cache_rt_shutdown);
+  rt->cleanup_handlers.add(bl_font_shape_cache_rt_cleanup);
+  rt->resource_info_handlers.add(bl_font_shape_cache_rt_resource_info);
+}
@@ -0,0 +1,188 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_FONTSHAPECACHE_P_H_INCLUDED
+#define BLEND2D_FONTSHAPECACHE_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/font.h>
+#include <blend2d/core/fontfeaturesettings.h>
+#include <blend2d/core/fontvariationsettings.h>
+#include <blend2d/core/glyphbuffer_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/arenahashmap_p.h>
+#include <blend2d/support/arenalist_p.h>
+#include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/mutex_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+namespace bl {
+namespace FontInternal {
+
+//! Maximum number of characters of a text that can have its shaping result cached. The cache is designed for short
+//! strings that are shaped repeatedly (labels, numbers, units), longer text is always shaped directly.
+static constexpr size_t kShapeCacheMaxTextSize = 128u;
+
+//! Key that identifies a shaping result.
+//!
+//! Shaping results are stored in font units, so the font size is not part of the key and results are shared by
+//! all fonts that use the same face and settings. Clusters are part of the key as they are copied to the result.
+struct ShapeCacheKey {
+  //! Font face unique id.
+  BLUniqueId face_id;
+  //! Font feature settings.
+  const BLFontFeatureSettings* feature_settings;
+  //! Font variation settings.
+  const BLFontVariationSettings* variation_settings;
+  //! Text (unicode code points).
+  const uint32_t* text;
+  //! Text info (clusters).
+  const BLGlyphInfo* info;
+  //! Text size.
+  size_t size;
+  //! Glyph buffer flags before shaping (shaping preserves flags describing the text).
+  uint32_t flags;
+
+  BL_HIDDEN uint32_t hash_code() const noexcept;
+};
+
+//! Bounded and thread-safe cache of shaping results.
+//!
+//! Entries are kept in a LRU list and the least recently used entries are evicted when the count limit is reached.
+//! The cache is disabled by default (the count limit is zero) and can be enabled by \ref bl_runtime_set_shape_cache_limit().
+class ShapeCache {
+public:
+  BL_NONCOPYABLE(ShapeCache)
+
+  //! Cache node, which is followed by its key data (text and text info) and result data (glyphs, glyph info, and
+  //! placements) allocated together with the node.
+  class Node : public ArenaHashMapNode, public ArenaListNode<Node> {
+  public:
+    BL_NONCOPYABLE(Node)
+
+    BLUniqueId face_id;
+    BLFontFeatureSettings feature_settings;
+    BLFontVariationSettings variation_settings;
+
+    size_t text_size;
+    size_t glyph_size;
+    uint32_t text_flags;
+    uint32_t glyph_flags;
+    uint8_t placement_type;
+
+    BL_INLINE Node(uint32_t hash_code, const ShapeCacheKey& key, size_t glyph_size, uint32_t glyph_flags, uint8_t placement_type) noexcept
+      : ArenaHashMapNode(hash_code),
+        face_id(key.face_id),
+        feature_settings(*key.feature_settings),
+        variation_settings(*key.variation_settings),
+        text_size(key.size),
+        glyph_size(glyph_size),
+        text_flags(key.flags),
+        glyph_flags(glyph_flags),
+        placement_type(placement_type) {}
+
+    BL_INLINE uint32_t* text() const noexcept { return reinterpret_cast<uint32_t*>(const_cast<Node*>(this) + 1); }
+    BL_INLINE BLGlyphInfo* text_info() const noexcept { return reinterpret_cast<BLGlyphInfo*>(text() + text_size); }
+    BL_INLINE uint32_t* glyphs() const noexcept { return reinterpret_cast<uint32_t*>(text_info() + text_size); }
+    BL_INLINE BLGlyphInfo* glyph_info() const noexcept { return reinterpret_cast<BLGlyphInfo*>(glyphs() + glyph_size); }
+    BL_INLINE BLGlyphPlacement* placements() const noexcept { return reinterpret_cast<BLGlyphPlacement*>(glyph_info() + glyph_size); }
+
+    static BL_INLINE size_t size_of(size_t text_size, size_t glyph_size) noexcept {
+      return sizeof(Node) + text_size * (sizeof(uint32_t) + sizeof(BLGlyphInfo)) +
+                            glyph_size * (sizeof(uint32_t) + sizeof(BLGlyphInfo) + sizeof(BLGlyphPlacement));
+    }
+  };
+
+  struct KeyMatcher {
+    const ShapeCacheKey& _key;
+    uint32_t _hash_code;
+
+    BL_INLINE uint32_t hash_code() const noexcept { return _hash_code; }
+    BL_HIDDEN bool matches(const Node* node) const noexcept;
+  };
+
+  //! \name Members
+  //! \{
+
+  BLMutex _mutex;
+  ArenaAllocator _allocator;
+  ArenaHashMap<Node> _map;
+  //! LRU list - the first node is the most recently used one.
+  ArenaList<Node> _lru;
+
+  size_t _count_limit = 0;
+  uint64_t _hit_count = 0;
+  uint64_t _miss_count = 0;
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE ShapeCache() noexcept
+    : _allocator(4096),
+      _map(&_allocator) {}
+
+  BL_INLINE ~ShapeCache() noexcept { clear(); }
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  //! Tests whether the cache is enabled - it's only a hint used to avoid locking when the cache is disabled.
+  BL_INLINE bool is_enabled() const noexcept { return bl_atomic_fetch_relaxed(&_count_limit) != 0u; }
+
+  BL_INLINE size_t size() noexcept { return _mutex.protect([&] { return _map.size(); }); }
+  BL_INLINE size_t count_limit() noexcept { return _mutex.protect([&] { return _count_limit; }); }
+  BL_INLINE uint64_t hit_count() noexcept { return _mutex.protect([&] { return _hit_count; }); }
+  BL_INLINE uint64_t miss_count() noexcept { return _mutex.protect([&] { return _miss_count; }); }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Sets the count limit and evicts entries that exceed it. Zero count limit disables the cache.
+  BL_HIDDEN void set_limit(size_t count_limit) noexcept;
+
+  //! Looks up a shaping result matching `key` and copies it to the glyph buffer `gb_impl` if found.
+  //!
+  //! Returns `BL_SUCCESS` and sets `found` to true on a hit, otherwise `found` is set to false.
+  BL_HIDDEN BLResult get(const ShapeCacheKey& key, BLGlyphBufferPrivateImpl* gb_impl, bool& found) noexcept;
+
+  //! Inserts a shaping result stored in the glyph buffer `gb_impl` matching `key` into the cache.
+  BL_HIDDEN BLResult put(const ShapeCacheKey& key, const BLGlyphBufferPrivateImpl* gb_impl) noexcept;
+
+  //! Removes all shaping results from the cache.
+  BL_HIDDEN void clear() noexcept;
+
+  //! \}
+
+  //! \name Internals
+  //! \{
+
+  BL_HIDDEN void _evict(size_t required_count) noexcept;
+  BL_HIDDEN void _remove_node(Node* node) noexcept;
+
+  //! \}
+};
+
+BL_HIDDEN extern Wrap<ShapeCache> shape_cache_global;
+
+} // {FontInternal}
+} // {bl}
+
+BL_HIDDEN void bl_font_shape_cache_rt_init(BLRuntimeContext* rt) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_FONTSHAPECACHE_P_H_INCLUDED
@@ -0,0 +1,126 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/font.h>
+#include <blend2d/core/fontdata.h>
+#include <blend2d/core/fontface.h>
+#include <blend2d/core/glyphbuffer.h>
+#include <blend2d/core/runtime.h>
+
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+// bl::Font - ShapeCache - Tests
+// =============================
+
+namespace bl {
+namespace Tests {
+
+static BLRuntimeResourceInfo query_shape_cache_info() noexcept {
+  BLRuntimeResourceInfo info{};
+  BLRuntime::query_resource_info(&info);
+  return info;
+}
+
+static void expect_same_glyphs(const BLGlyphBuffer& actual, const BLGlyphBuffer& expected) noexcept {
+  EXPECT_EQ(actual.size(), expected.size());
+  EXPECT_EQ(actual.flags(), expected.flags());
+  EXPECT_EQ(actual.glyph_run().placement_type, expected.glyph_run().placement_type);
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(actual.content()[i], expected.content()[i]).message("Glyph at #%zu doesn't match", i);
+    EXPECT_EQ(actual.info_data()[i].cluster, expected.info_data()[i].cluster).message("Cluster at #%zu doesn't match", i);
+    EXPECT_TRUE(actual.placement_data()[i].placement == expected.placement_data()[i].placement).message("Placement at #%zu doesn't match", i);
+    EXPECT_TRUE(actual.placement_data()[i].advance == expected.placement_data()[i].advance).message("Advance at #%zu doesn't match", i);
+  }
+}
+
+UNIT(font_shape_cache, BL_TEST_GROUP_TEXT_COMBINED) {
+  BLFontData font_data;
+  BLFontFace font_face;
+  BLFont font;
+
+  EXPECT_SUCCESS(font_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)));
+  EXPECT_SUCCESS(font_face.create_from_data(font_data, 0));
+  EXPECT_SUCCESS(font.create_from_face(font_face, 20.0f));
+
+  static const char label[] = "Width: 1024 px (AVA)";
+
+  BLGlyphBuffer expected;
+  EXPECT_SUCCESS(expected.set_utf8_text(label));
+  EXPECT_SUCCESS(font.shape(expected));
+
+  INFO("Testing whether cached shaping results match uncached shaping");
+  {
+    EXPECT_SUCCESS(BLRuntime::set_shape_cache_limit(16));
+    BLRuntimeResourceInfo before = query_shape_cache_info();
+
+    BLGlyphBuffer gb;
+    EXPECT_SUCCESS(gb.set_utf8_text(label));
+    EXPECT_SUCCESS(font.shape(gb));
+    expect_same_glyphs(gb, expected);
+
+    EXPECT_SUCCESS(gb.set_utf8_text(label));
+    EXPECT_SUCCESS(font.shape(gb));
+    expect_same_glyphs(gb, expected);
+
+    BLRuntimeResourceInfo after = query_shape_cache_info();
+    EXPECT_EQ(after.shape_cache_count, 1u);
+    EXPECT_EQ(after.shape_cache_miss_count - before.shape_cache_miss_count, 1u);
+    EXPECT_EQ(after.shape_cache_hit_count - before.shape_cache_hit_count, 1u);
+  }
+
+  INFO("Testing whether feature settings are part of the key");
+  {
+    BLFontFeatureSettings feature_settings;
+    EXPECT_SUCCESS(feature_settings.set_value(BL_MAKE_TAG('k', 'e', 'r', 'n'), 0u));
+
+    BLFont unkerned_font;
+    EXPECT_SUCCESS(unkerned_font.create_from_face(font_face, 20.0f, feature_settings));
+
+    BLGlyphBuffer gb;
+    EXPECT_SUCCESS(gb.set_utf8_text(label));
+    EXPECT_SUCCESS(unkerned_font.shape(gb));
+    EXPECT_EQ(query_shape_cache_info().shape_cache_count, 2u);
+  }
+
+  INFO("Testing eviction of least recently used shaping results");
+  {
+    EXPECT_SUCCESS(BLRuntime::set_shape_cache_limit(2));
+
+    static const char* const strings[] = { "0", "1", "2", "3" };
+    for (const char* s : strings) {
+      BLGlyphBuffer gb;
+      EXPECT_SUCCESS(gb.set_utf8_text(s));
+      EXPECT_SUCCESS(font.shape(gb));
+    }
+    EXPECT_EQ(query_shape_cache_info().shape_cache_count, 2u);
+  }
+
+  INFO("Testing runtime cleanup of the shaping result cache");
+  {
+    EXPECT_SUCCESS(BLRuntime::cleanup(BL_RUNTIME_CLEANUP_SHAPE_CACHE));
+    EXPECT_EQ(query_shape_cache_info().shape_cache_count, 0u);
+
+    EXPECT_SUCCESS(BLRuntime::set_shape_cache_limit(0));
+    BLRuntimeResourceInfo before = query_shape_cache_info();
+
+    BLGlyphBuffer gb;
+    EXPECT_SUCCESS(gb.set_utf8_text(label));
+    EXPECT_SUCCESS(font.shape(gb));
+    expect_same_glyphs(gb, expected);
+
+    BLRuntimeResourceInfo after = query_shape_cache_info();
+    EXPECT_EQ(after.shape_cache_count, 0u);
+    EXPECT_EQ(after.shape_cache_miss_count, before.shape_cache_miss_count);
+  }
+}
+
+} // {Tests}
+} // {bl}
+
+#endif // BL_TEST
@@ -126,6 +126,26 @@ static BL_INLINE BLResult bl_internal_glyph_buffer_data_set_unicode_text(BLGlyph
   BLGlyphInfo* info_data = d->info_data;
 
   while (reader.has_next()) {
+    // UTF-8 text is mostly ASCII, which maps 1:1 to UCS4 content, so ASCII runs are converted by an optimized function.
+    // The content buffer has at least `size` items, so it can hold the remaining bytes converted to code points.
+    if constexpr (std::is_same_v<Reader, bl::Unicode::Utf8Reader>) {
+      size_t remaining = reader.remaining_byte_size();
+      if (remaining >= bl::Unicode::kAsciiFastForwardThreshold) {
+        size_t cluster = reader.native_index(src);
+        size_t n = bl::Unicode::function_table.ascii_to_utf32(text_data, reinterpret_cast<const uint8_t*>(reader._ptr), remaining);
+
+        for (size_t i = 0; i < n; i++)
+          info_data[i] = bl_glyph_info_from_cluster(cluster + i);
+
+        text_data += n;
+        info_data += n;
+        reader.skip_ascii(n);
+
+        if (!reader.has_next())
+          break;
+      }
+    }
+
     uint32_t uc;
     uint32_t cluster = uint32_t(reader.native_index(src));
     BLResult result = reader.next(uc);
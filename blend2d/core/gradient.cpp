@@ -7,6 +7,7 @@
 #include <blend2d/core/array_p.h>
 #include <blend2d/core/format_p.h>
 #include <blend2d/core/gradient_p.h>
+#include <blend2d/core/gradientlutcache_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/rgba_p.h>
 #include <blend2d/core/runtime_p.h>
@@ -286,6 +287,34 @@ BLGradientInfo ensure_info(BLGradientPrivateImpl* impl) noexcept {
   return info;
 }
 
+// Returns a retained LUT of the given `lut_size` and `pixel_size`, which is either shared through the LUT cache or
+// interpolated from gradient stops.
+static BLGradientLUT* acquire_lut(const BLGradientPrivateImpl* impl, uint32_t lut_size, uint32_t pixel_size) noexcept {
+  LUTCache& cache = lut_cache_global;
+  LUTCacheKey key{impl->stops, impl->size, lut_size, pixel_size};
+
+  bool cache_enabled = cache.is_enabled();
+  if (cache_enabled) {
+    BLGradientLUT* lut = cache.get(key);
+    if (lut)
+      return lut;
+  }
+
+  BLGradientLUT* lut = BLGradientLUT::alloc(lut_size, pixel_size);
+  if (BL_UNLIKELY(!lut))
+    return nullptr;
+
+  if (pixel_size == 4u)
+    PixelOps::funcs.interpolate_prgb32(lut->data<uint32_t>(), lut_size, impl->stops, impl->size);
+  else
+    PixelOps::funcs.interpolate_prgb64(lut->data<uint64_t>(), lut_size, impl->stops, impl->size);
+
+  if (cache_enabled)
+    cache.put(key, lut);
+
+  return lut;
+}
+
 BLGradientLUT* ensure_lut32(BLGradientPrivateImpl* impl, uint32_t lut_size) noexcept {
   BLGradientLUT* lut = impl->lut32;
   if (lut) {
@@ -293,18 +322,15 @@ BLGradientLUT* ensure_lut32(BLGradientPrivateImpl* impl, uint32_t lut_size) noex
     return lut;
   }
 
-  lut = BLGradientLUT::alloc(lut_size, 4);
+  lut = acquire_lut(impl, lut_size, 4);
   if (BL_UNLIKELY(!lut))
     return nullptr;
 
-  const BLGradientStop* stops = impl->stops;
-  PixelOps::funcs.interpolate_prgb32(lut->data<uint32_t>(), lut_size, stops, impl->size);
-
   // We must drop this LUT if another thread created it meanwhile.
   BLGradientLUT* expected = nullptr;
   if (!bl_atomic_compare_exchange(&impl->lut32, &expected, lut)) {
     BL_ASSERT(expected != nullptr);
-    BLGradientLUT::destroy(lut);
+    lut->release();
     lut = expected;
   }
 
@@ -318,18 +344,15 @@ BLGradientLUT* ensure_lut64(BLGradientPrivateImpl* impl, uint32_t lut_size) noex
     return lut;
   }
 
-  lut = BLGradientLUT::alloc(lut_size, 8);
+  lut = acquire_lut(impl, lut_size, 8);
   if (BL_UNLIKELY(!lut))
     return nullptr;
 
-  const BLGradientStop* stops = impl->stops;
-  PixelOps::funcs.interpolate_prgb64(lut->data<uint64_t>(), lut_size, stops, impl->size);
-
   // We must drop this LUT if another thread created it meanwhile.
   BLGradientLUT* expected = nullptr;
   if (!bl_atomic_compare_exchange(&impl->lut64, &expected, lut)) {
     BL_ASSERT(expected != nullptr);
-    BLGradientLUT::destroy(lut);
+    lut->release();
     lut = expected;
   }
 
@@ -1022,11 +1045,11 @@ BL_API_IMPL bool bl_gradient_equals(const BLGradientCore* a, const BLGradientCor
 // ===================================
 
 void bl_gradient_rt_init(BLRuntimeContext* rt) noexcept {
-  bl_unused(rt);
-
   bl::GradientInternal::default_impl.impl->transform.reset();
 
   bl_object_defaults[BL_OBJECT_TYPE_GRADIENT]._d.init_dynamic(
     BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_GRADIENT),
     &bl::GradientInternal::default_impl.impl);
+
+  bl_gradient_lut_cache_rt_init(rt);
 }
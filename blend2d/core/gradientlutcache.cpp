@@ -0,0 +1,161 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/gradientlutcache_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/hashops_p.h>
+
+namespace bl {
+namespace GradientInternal {
+
+// bl::Gradient - LUTCache - Globals
+// =================================
+
+Wrap<LUTCache> lut_cache_global;
+
+// bl::Gradient - LUTCache - Key
+// =============================
+
+uint32_t LUTCacheKey::hash_code() const noexcept {
+  uint32_t hash = HashOps::hash_mix_u64(0, (uint64_t(lut_size) << 32) | pixel_size);
+
+  for (size_t i = 0; i < stop_count; i++) {
+    uint64_t offset_bits;
+    memcpy(&offset_bits, &stops[i].offset, sizeof(offset_bits));
+
+    hash = HashOps::hash_mix_u64(hash, offset_bits);
+    hash = HashOps::hash_mix_u64(hash, stops[i].rgba.value);
+  }
+
+  return hash;
+}
+
+bool LUTCache::KeyMatcher::matches(const Node* node) const noexcept {
+  return node->lut->size == _key.lut_size &&
+         node->pixel_size == _key.pixel_size &&
+         node->stop_count == _key.stop_count &&
+         memcmp(node->stops(), _key.stops, _key.stop_count * sizeof(BLGradientStop)) == 0;
+}
+
+// bl::Gradient - LUTCache - Interface
+// ===================================
+
+void LUTCache::set_limit(size_t size_limit) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  bl_atomic_store_relaxed(&_size_limit, size_limit);
+  _evict(0);
+}
+
+BLGradientLUT* LUTCache::get(const LUTCacheKey& key) noexcept {
+  KeyMatcher matcher{key, key.hash_code()};
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  Node* node = _map.get(matcher);
+  if (!node) {
+    _miss_count++;
+    return nullptr;
+  }
+
+  _hit_count++;
+  if (node != _lru.first()) {
+    _lru.unlink(node);
+    _lru.prepend(node);
+  }
+
+  return node->lut->retain();
+}
+
+void LUTCache::put(const LUTCacheKey& key, BLGradientLUT* lut) noexcept {
+  KeyMatcher matcher{key, key.hash_code()};
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  size_t lut_data_size = size_t(key.lut_size) * key.pixel_size;
+  if (lut_data_size > _size_limit)
+    return;
+
+  // Another thread could have inserted the same LUT while this one was interpolating it.
+  if (_map.get(matcher))
+    return;
+
+  _evict(lut_data_size);
+
+  Node* node = static_cast<Node*>(malloc(Node::size_of(key.stop_count)));
+  if (BL_UNLIKELY(!node))
+    return;
+
+  bl_call_ctor(*node, matcher.hash_code(), key, lut->retain());
+  memcpy(node->stops(), key.stops, key.stop_count * sizeof(BLGradientStop));
+
+  _map.insert(node);
+  _lru.prepend(node);
+  _lut_data_size += lut_data_size;
+}
+
+void LUTCache::clear() noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  while (!_lru.is_empty())
+    _remove_node(_lru.last());
+
+  _map.reset();
+  _allocator.reset();
+}
+
+// bl::Gradient - LUTCache - Internals
+// ===================================
+
+void LUTCache::_evict(size_t required_size) noexcept {
+  while (!_lru.is_empty() && _lut_data_size + required_size > _size_limit)
+    _remove_node(_lru.last());
+}
+
+void LUTCache::_remove_node(Node* node) noexcept {
+  _map.remove(node);
+  _lru.unlink(node);
+  _lut_data_size -= node->lut_data_size();
+
+  node->lut->release();
+  bl_call_dtor(*node);
+  free(node);
+}
+
+} // {GradientInternal}
+} // {bl}
+
+// bl::Gradient - LUTCache - Runtime Registration
+// ==============================================
+
+static void BL_CDECL bl_gradient_lut_cache_rt_shutdown(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+  bl::GradientInternal::lut_cache_global.destroy();
+}
+
+static void BL_CDECL bl_gradient_lut_cache_rt_cleanup(BLRuntimeContext* rt, BLRuntimeCleanupFlags cleanup_flags) noexcept {
+  bl_unused(rt);
+  if (cleanup_flags & BL_RUNTIME_CLEANUP_GRADIENT_CACHE)
+    bl::GradientInternal::lut_cache_global->clear();
+}
+
+static void BL_CDECL bl_gradient_lut_cache_rt_memory_info(BLRuntimeContext* rt, BLRuntimeMemoryInfo* memory_info) noexcept {
+  bl_unused(rt);
+  memory_info->gradient_lut_cache_count = bl::GradientInternal::lut_cache_global->size();
+  memory_info->gradient_lut_cache_size = bl::GradientInternal::lut_cache_global->lut_data_size();
+  memory_info->gradient_lut_cache_hit_count = size_t(bl::GradientInternal::lut_cache_global->hit_count());
+  memory_info->gradient_lut_cache_miss_count = size_t(bl::GradientInternal::lut_cache_global->miss_count());
+}
+
+void bl_gradient_rt_set_lut_cache_limit(size_t size_limit) noexcept {
+  bl::GradientInternal::lut_cache_global->set_limit(size_limit);
+}
+
+void bl_gradient_lut_cache_rt_init(BLRuntimeContext* rt) noexcept {
+  bl::GradientInternal::lut_cache_global.init();
+
+  rt->shutdown_handlers.add(bl_gradient_lut_cache_rt_shutdown);
+  rt->cleanup_handlers.add(bl_gradient_lut_cache_rt_cleanup);
+  rt->memory_info_handlers.add(bl_gradient_lut_cache_rt_memory_info);
+}
@@ -0,0 +1,162 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_GRADIENTLUTCACHE_P_H_INCLUDED
+#define BLEND2D_GRADIENTLUTCACHE_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/gradient_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/arenahashmap_p.h>
+#include <blend2d/support/arenalist_p.h>
+#include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/mutex_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+namespace bl {
+namespace GradientInternal {
+
+//! Default size limit of LUTs kept by the gradient LUT cache (in bytes).
+static constexpr size_t kLUTCacheDefaultSizeLimit = 1024u * 1024u;
+
+//! Key that identifies a gradient LUT.
+//!
+//! The content of a LUT only depends on gradient stops, its size, and pixel format - gradient type, values, extend
+//! mode, and transformation are applied when the LUT is fetched, so they are not part of the key.
+struct LUTCacheKey {
+  //! Gradient stops.
+  const BLGradientStop* stops;
+  //! Count of gradient stops.
+  size_t stop_count;
+  //! Size of the LUT (count of pixels).
+  uint32_t lut_size;
+  //! Size of a LUT pixel - either 4 (PRGB32) or 8 (PRGB64).
+  uint32_t pixel_size;
+
+  BL_HIDDEN uint32_t hash_code() const noexcept;
+};
+
+//! Bounded and thread-safe cache of gradient LUTs shared by all gradients that have the same stops.
+//!
+//! The cache holds a reference to each LUT it stores, gradients that use a cached LUT hold their own references,
+//! so evicting a LUT from the cache never invalidates a LUT used by a gradient or a rendering context. Entries are
+//! kept in a LRU list and the least recently used entries are evicted when the size limit is reached.
+class LUTCache {
+public:
+  BL_NONCOPYABLE(LUTCache)
+
+  //! Cache node, which is followed by a copy of gradient stops allocated together with the node.
+  class Node : public ArenaHashMapNode, public ArenaListNode<Node> {
+  public:
+    BL_NONCOPYABLE(Node)
+
+    BLGradientLUT* lut;
+    size_t stop_count;
+    uint32_t pixel_size;
+
+    BL_INLINE Node(uint32_t hash_code, const LUTCacheKey& key, BLGradientLUT* lut) noexcept
+      : ArenaHashMapNode(hash_code),
+        lut(lut),
+        stop_count(key.stop_count),
+        pixel_size(key.pixel_size) {}
+
+    BL_INLINE BLGradientStop* stops() const noexcept { return reinterpret_cast<BLGradientStop*>(const_cast<Node*>(this) + 1); }
+    BL_INLINE size_t lut_data_size() const noexcept { return lut->size * pixel_size; }
+
+    static BL_INLINE size_t size_of(size_t stop_count) noexcept {
+      return sizeof(Node) + stop_count * sizeof(BLGradientStop);
+    }
+  };
+
+  struct KeyMatcher {
+    const LUTCacheKey& _key;
+    uint32_t _hash_code;
+
+    BL_INLINE uint32_t hash_code() const noexcept { return _hash_code; }
+    BL_HIDDEN bool matches(const Node* node) const noexcept;
+  };
+
+  //! \name Members
+  //! \{
+
+  BLMutex _mutex;
+  ArenaAllocator _allocator;
+  ArenaHashMap<Node> _map;
+  //! LRU list - the first node is the most recently used one.
+  ArenaList<Node> _lru;
+
+  size_t _size_limit = kLUTCacheDefaultSizeLimit;
+  size_t _lut_data_size = 0;
+  uint64_t _hit_count = 0;
+  uint64_t _miss_count = 0;
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE LUTCache() noexcept
+    : _allocator(4096),
+      _map(&_allocator) {}
+
+  BL_INLINE ~LUTCache() noexcept { clear(); }
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  //! Tests whether the cache is enabled - it's only a hint used to avoid locking when the cache is disabled.
+  BL_INLINE bool is_enabled() const noexcept { return bl_atomic_fetch_relaxed(&_size_limit) != 0u; }
+
+  BL_INLINE size_t size() noexcept { return _mutex.protect([&] { return _map.size(); }); }
+  BL_INLINE size_t lut_data_size() noexcept { return _mutex.protect([&] { return _lut_data_size; }); }
+  BL_INLINE uint64_t hit_count() noexcept { return _mutex.protect([&] { return _hit_count; }); }
+  BL_INLINE uint64_t miss_count() noexcept { return _mutex.protect([&] { return _miss_count; }); }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Sets the size limit of cached LUT data and evicts entries that exceed it. Zero size limit disables the cache.
+  BL_HIDDEN void set_limit(size_t size_limit) noexcept;
+
+  //! Returns a retained LUT matching `key` or null if there is no such LUT in the cache.
+  BL_HIDDEN BLGradientLUT* get(const LUTCacheKey& key) noexcept;
+
+  //! Inserts `lut` matching `key` into the cache (the cache retains it).
+  BL_HIDDEN void put(const LUTCacheKey& key, BLGradientLUT* lut) noexcept;
+
+  //! Removes all LUTs from the cache.
+  BL_HIDDEN void clear() noexcept;
+
+  //! \}
+
+  //! \name Internals
+  //! \{
+
+  BL_HIDDEN void _evict(size_t required_size) noexcept;
+  BL_HIDDEN void _remove_node(Node* node) noexcept;
+
+  //! \}
+};
+
+BL_HIDDEN extern Wrap<LUTCache> lut_cache_global;
+
+} // {GradientInternal}
+} // {bl}
+
+BL_HIDDEN void bl_gradient_lut_cache_rt_init(BLRuntimeContext* rt) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_GRADIENTLUTCACHE_P_H_INCLUDED
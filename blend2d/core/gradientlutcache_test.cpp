@@ -0,0 +1,116 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/gradient_p.h>
+#include <blend2d/core/gradientlutcache_p.h>
+#include <blend2d/core/runtime.h>
+
+// bl::Gradient - LUTCache - Tests
+// ===============================
+
+namespace bl {
+namespace Tests {
+
+static BLRuntimeMemoryInfo query_gradient_lut_cache_info() noexcept {
+  BLRuntimeMemoryInfo info{};
+  BLRuntime::query_memory_info(&info);
+  return info;
+}
+
+static void init_lut_cache_gradient(BLGradient& g, BLExtendMode extend_mode, uint32_t last_color) noexcept {
+  g.create(BLLinearGradientValues(0, 0, 100, 0), extend_mode);
+  g.add_stop(0.0, BLRgba32(0xFF000000u));
+  g.add_stop(0.5, BLRgba32(0xFF00FF00u));
+  g.add_stop(1.0, BLRgba32(last_color));
+}
+
+UNIT(gradient_lut_cache, BL_TEST_GROUP_RENDERING_STYLES) {
+  EXPECT_SUCCESS(BLRuntime::set_gradient_lut_cache_limit(1024u * 1024u));
+  EXPECT_SUCCESS(BLRuntime::cleanup(BL_RUNTIME_CLEANUP_GRADIENT_CACHE));
+
+  INFO("Testing whether gradients having the same stops share a LUT");
+  {
+    BLGradient a;
+    BLGradient b;
+
+    init_lut_cache_gradient(a, BL_EXTEND_MODE_PAD, 0xFFFFFFFFu);
+    init_lut_cache_gradient(b, BL_EXTEND_MODE_REFLECT, 0xFFFFFFFFu);
+
+    BLRuntimeMemoryInfo before = query_gradient_lut_cache_info();
+
+    BLGradientLUT* lut_a = GradientInternal::ensure_lut32(GradientInternal::get_impl(&a), 256);
+    BLGradientLUT* lut_b = GradientInternal::ensure_lut32(GradientInternal::get_impl(&b), 256);
+
+    EXPECT_NE(lut_a, nullptr);
+    EXPECT_EQ(lut_a, lut_b);
+
+    BLRuntimeMemoryInfo after = query_gradient_lut_cache_info();
+    EXPECT_EQ(after.gradient_lut_cache_count, before.gradient_lut_cache_count + 1u);
+    EXPECT_EQ(after.gradient_lut_cache_size, before.gradient_lut_cache_size + 256u * 4u);
+    EXPECT_EQ(after.gradient_lut_cache_hit_count - before.gradient_lut_cache_hit_count, 1u);
+    EXPECT_EQ(after.gradient_lut_cache_miss_count - before.gradient_lut_cache_miss_count, 1u);
+
+    // A different LUT size or pixel format must not match the cached LUT.
+    BLGradientLUT* lut_c = GradientInternal::ensure_lut64(GradientInternal::get_impl(&a), 256);
+    EXPECT_NE(lut_c, nullptr);
+    EXPECT_NE(static_cast<void*>(lut_c), static_cast<void*>(lut_a));
+  }
+
+  INFO("Testing whether gradients having different stops don't share a LUT");
+  {
+    BLGradient a;
+    BLGradient b;
+
+    init_lut_cache_gradient(a, BL_EXTEND_MODE_PAD, 0xFFFFFFFFu);
+    init_lut_cache_gradient(b, BL_EXTEND_MODE_PAD, 0xFF0000FFu);
+
+    BLGradientLUT* lut_a = GradientInternal::ensure_lut32(GradientInternal::get_impl(&a), 256);
+    BLGradientLUT* lut_b = GradientInternal::ensure_lut32(GradientInternal::get_impl(&b), 256);
+
+    EXPECT_NE(lut_a, lut_b);
+    EXPECT_NE(lut_a->data<uint32_t>()[255], lut_b->data<uint32_t>()[255]);
+  }
+
+  INFO("Testing whether a LUT stays valid after it was evicted from the cache");
+  {
+    BLGradient a;
+    init_lut_cache_gradient(a, BL_EXTEND_MODE_PAD, 0xFFFFFFFFu);
+
+    BLGradientLUT* lut = GradientInternal::ensure_lut32(GradientInternal::get_impl(&a), 256);
+    uint32_t last_pixel = lut->data<uint32_t>()[255];
+
+    EXPECT_SUCCESS(BLRuntime::cleanup(BL_RUNTIME_CLEANUP_GRADIENT_CACHE));
+    EXPECT_EQ(query_gradient_lut_cache_info().gradient_lut_cache_count, 0u);
+    EXPECT_EQ(query_gradient_lut_cache_info().gradient_lut_cache_size, 0u);
+    EXPECT_EQ(lut->data<uint32_t>()[255], last_pixel);
+  }
+
+  INFO("Testing whether the cache can be disabled");
+  {
+    EXPECT_SUCCESS(BLRuntime::set_gradient_lut_cache_limit(0));
+
+    BLGradient a;
+    BLGradient b;
+
+    init_lut_cache_gradient(a, BL_EXTEND_MODE_PAD, 0xFFFFFFFFu);
+    init_lut_cache_gradient(b, BL_EXTEND_MODE_PAD, 0xFFFFFFFFu);
+
+    BLGradientLUT* lut_a = GradientInternal::ensure_lut32(GradientInternal::get_impl(&a), 256);
+    BLGradientLUT* lut_b = GradientInternal::ensure_lut32(GradientInternal::get_impl(&b), 256);
+
+    EXPECT_NE(lut_a, lut_b);
+    EXPECT_EQ(query_gradient_lut_cache_info().gradient_lut_cache_count, 0u);
+  }
+
+  EXPECT_SUCCESS(BLRuntime::set_gradient_lut_cache_limit(GradientInternal::kLUTCacheDefaultSizeLimit));
+}
+
+} // {Tests}
+} // {bl}
+
+#endif // BL_TEST
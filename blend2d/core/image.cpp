@@ -11,6 +11,7 @@
 #include <blend2d/core/imagecodec.h>
 #include <blend2d/core/imagedecoder.h>
 #include <blend2d/core/imageencoder.h>
+#include <blend2d/core/imagepool_p.h>
 #include <blend2d/core/imagescale_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/pixelconverter_p.h>
@@ -133,11 +134,29 @@ static BL_NOINLINE BLResult alloc_impl(BLImageCore* self, int w, int h, BLFormat
   size_t kBaseImplSize = IntOps::align_up(sizeof(BLImagePrivateImpl), BL_OBJECT_IMPL_ALIGNMENT);
   size_t pixel_data_size = size_t(h) * size_t(stride);
 
+  BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE);
+
+  // Large images use a pooled buffer if the pool is enabled, the buffer is returned to the pool on destruction.
+  if (pixel_data_size >= ImagePool::kMinBufferSize && image_pool_global->is_enabled()) {
+    ImagePool::Buffer* buffer = image_pool_global->acquire(pixel_data_size);
+    if (buffer) {
+      BLResult result = ObjectInternal::alloc_impl_external_t<BLImagePrivateImpl>(self, info, false, release_pooled_buffer, buffer);
+      if (BL_UNLIKELY(result != BL_SUCCESS)) {
+        image_pool_global->release(buffer);
+        return result;
+      }
+
+      BLImagePrivateImpl* impl = get_impl(self);
+      init_impl_data(impl, w, h, format, buffer->data(), stride);
+      impl->writer_count = 0;
+      return BL_SUCCESS;
+    }
+  }
+
   BLObjectImplSize impl_size(kBaseImplSize + pixel_data_size);
   if (pixel_data_size >= kLargeDataThreshold)
     impl_size += kLargeDataAlignment - BL_OBJECT_IMPL_ALIGNMENT;
 
-  BLObjectInfo info = BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE);
   BL_PROPAGATE(ObjectInternal::alloc_impl_t<BLImagePrivateImpl>(self, info, impl_size));
 
   BLImagePrivateImpl* impl = get_impl(self);
@@ -320,7 +339,7 @@ BL_API_IMPL BLResult bl_image_create(BLImageCore* self, int w, int h, BLFormat f
 
   BLImagePrivateImpl* self_impl = get_impl(self);
   if (self_impl->size == BLSizeI(w, h) && self_impl->format == format)
-    if (bl::ObjectInternal::is_impl_mutable(self_impl) && !bl::ObjectInternal::is_impl_external(self_impl))
+    if (bl::ObjectInternal::is_impl_mutable(self_impl) && (!bl::ObjectInternal::is_impl_external(self_impl) || is_impl_pooled(self_impl)))
       return BL_SUCCESS;
 
   BLImageCore newO;
@@ -522,6 +541,10 @@ BL_API_IMPL bool bl_image_equals(const BLImageCore* a, const BLImageCore* b) noe
 // =======================
 
 BL_API_IMPL BLResult bl_image_scale(BLImageCore* dst, const BLImageCore* src, const BLSizeI* size, BLImageScaleFilter filter) noexcept {
+  return bl_image_scale_threaded(dst, src, size, filter, 1);
+}
+
+BL_API_IMPL BLResult bl_image_scale_threaded(BLImageCore* dst, const BLImageCore* src, const BLSizeI* size, BLImageScaleFilter filter, uint32_t thread_count) noexcept {
   using namespace bl::ImageInternal;
 
   BL_ASSERT(dst->_d.is_image());
@@ -534,6 +557,10 @@ BL_API_IMPL BLResult bl_image_scale(BLImageCore* dst, const BLImageCore* src, co
   bl::ImageScaleContext scale_ctx;
   BL_PROPAGATE(scale_ctx.create(*size, src_impl->size, filter));
 
+  // Threads are opt-in and only used if the vertical pass is large enough to benefit from them.
+  if (thread_count > 1u)
+    thread_count = bl_min(thread_count, scale_ctx.suggested_vert_thread_count());
+
   BLFormat format = BLFormat(src_impl->format);
   int tw = scale_ctx.dst_width();
   int th = scale_ctx.src_height();
@@ -554,7 +581,7 @@ BL_API_IMPL BLResult bl_image_scale(BLImageCore* dst, const BLImageCore* src, co
     if (th == scale_ctx.dst_height())
       scale_ctx.process_horz_data(static_cast<uint8_t*>(buf.pixel_data), buf.stride, static_cast<const uint8_t*>(src_impl->pixel_data), src_impl->stride, format);
     else
-      scale_ctx.process_vert_data(static_cast<uint8_t*>(buf.pixel_data), buf.stride, static_cast<const uint8_t*>(src_impl->pixel_data), src_impl->stride, format);
+      scale_ctx.process_vert_data(static_cast<uint8_t*>(buf.pixel_data), buf.stride, static_cast<const uint8_t*>(src_impl->pixel_data), src_impl->stride, format, thread_count);
   }
   else {
     // Both horizontal and vertical scale.
@@ -566,7 +593,7 @@ BL_API_IMPL BLResult bl_image_scale(BLImageCore* dst, const BLImageCore* src, co
     BL_PROPAGATE(bl_image_create(dst, scale_ctx.dst_width(), scale_ctx.dst_height(), format));
     BL_PROPAGATE(bl_image_make_mutable(dst, &buf));
 
-    scale_ctx.process_vert_data(static_cast<uint8_t*>(buf.pixel_data), buf.stride, static_cast<const uint8_t*>(src_impl->pixel_data), src_impl->stride, format);
+    scale_ctx.process_vert_data(static_cast<uint8_t*>(buf.pixel_data), buf.stride, static_cast<const uint8_t*>(src_impl->pixel_data), src_impl->stride, format, thread_count);
   }
 
   return BL_SUCCESS;
@@ -671,11 +698,11 @@ BL_API_IMPL BLResult bl_image_write_to_data(const BLImageCore* self, BLArrayCore
 // ================================
 
 void bl_image_rt_init(BLRuntimeContext* rt) noexcept {
-  bl_unused(rt);
-
   auto& default_image = bl::ImageInternal::default_image;
 
   bl_object_defaults[BL_OBJECT_TYPE_IMAGE]._d.init_dynamic(
     BLObjectInfo::from_type_with_marker(BL_OBJECT_TYPE_IMAGE),
     &default_image.impl);
+
+  bl_image_pool_rt_init(rt);
 }
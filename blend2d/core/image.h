@@ -161,6 +161,7 @@ BL_API BLResult BL_CDECL bl_image_make_mutable(BLImageCore* self, BLImageData* d
 BL_API BLResult BL_CDECL bl_image_convert(BLImageCore* self, BLFormat format) BL_NOEXCEPT_C;
 BL_API bool BL_CDECL bl_image_equals(const BLImageCore* a, const BLImageCore* b) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_image_scale(BLImageCore* dst, const BLImageCore* src, const BLSizeI* size, BLImageScaleFilter filter) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_image_scale_threaded(BLImageCore* dst, const BLImageCore* src, const BLSizeI* size, BLImageScaleFilter filter, uint32_t thread_count) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_image_read_from_file(BLImageCore* self, const char* file_name, const BLArrayCore* codecs) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_image_read_from_data(BLImageCore* self, const void* data, size_t size, const BLArrayCore* codecs) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_image_write_to_file(const BLImageCore* self, const char* file_name, const BLImageCodecCore* codec) BL_NOEXCEPT_C;
@@ -506,6 +507,13 @@ public:
   static BL_INLINE_NODEBUG BLResult scale(BLImage& dst, const BLImage& src, const BLSizeI& size, BLImageScaleFilter filter) noexcept {
     return bl_image_scale(&dst, &src, &size, filter);
   }
+
+  //! Scales the `src` image like \ref scale(), but lets the vertical pass use up to `thread_count` threads (including
+  //! the calling thread) acquired from the global thread pool. Threads are only used when the image is large enough
+  //! to benefit from it, and `thread_count` lower than 2 means the same as \ref scale().
+  static BL_INLINE_NODEBUG BLResult scale(BLImage& dst, const BLImage& src, const BLSizeI& size, BLImageScaleFilter filter, uint32_t thread_count) noexcept {
+    return bl_image_scale_threaded(&dst, &src, &size, filter, thread_count);
+  }
 };
 
 #endif
@@ -128,6 +128,9 @@ BL_DEFINE_ENUM(BLImageCodecFeatures) {
   BL_IMAGE_CODEC_FEATURE_LOSSY = 0x00000008u,
   //! Image codec supports writing multiple frames (GIF).
   BL_IMAGE_CODEC_FEATURE_MULTI_FRAME = 0x00000010u,
+  //! Image decoder implements `read_frame_rows` of its virtual function table, which decodes rows in bands. Decoders
+  //! of codecs that don't advertise this feature are read by `read_frame` and their rows are emitted afterwards.
+  BL_IMAGE_CODEC_FEATURE_READ_ROWS = 0x00000020u,
   //! Image codec supports IPTC metadata.
   BL_IMAGE_CODEC_FEATURE_IPTC = 0x10000000u,
   //! Image codec supports EXIF metadata.
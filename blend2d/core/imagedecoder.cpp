@@ -4,7 +4,8 @@
 // SPDX-License-Identifier: Zlib
 
 #include <blend2d/core/api-build_p.h>
-#include <blend2d/core/imagedecoder.h>
+#include <blend2d/core/format_p.h>
+#include <blend2d/core/imagedecoder_p.h>
 #include <blend2d/core/object_p.h>
 #include <blend2d/core/runtime_p.h>
 
@@ -19,6 +20,110 @@ static BLObjectEternalVirtualImpl<BLImageDecoderImpl, BLImageDecoderVirt> defaul
 } // {ImageDecoderInternal}
 } // {bl}
 
+// bl::ImageDecoder - Row Streaming
+// ================================
+
+namespace bl {
+namespace ImageDecoderInternal {
+
+// Clips `roi` to `frame_size` - a null `roi` selects the whole frame.
+static BLResult resolve_roi(BLRectI& out, const BLRectI* roi, const BLSizeI& frame_size) noexcept {
+  if (!roi) {
+    out.reset(0, 0, frame_size.w, frame_size.h);
+  }
+  else {
+    int64_t x0 = bl_max<int64_t>(roi->x, 0);
+    int64_t y0 = bl_max<int64_t>(roi->y, 0);
+    int64_t x1 = bl_min<int64_t>(int64_t(roi->x) + roi->w, frame_size.w);
+    int64_t y1 = bl_min<int64_t>(int64_t(roi->y) + roi->h, frame_size.h);
+
+    if (x0 >= x1 || y0 >= y1) {
+      return bl_make_error(BL_ERROR_INVALID_VALUE);
+    }
+
+    out.reset(int(x0), int(y0), int(x1 - x0), int(y1 - y0));
+  }
+
+  if (out.w <= 0 || out.h <= 0) {
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+  }
+
+  return BL_SUCCESS;
+}
+
+BLResult emit_image_rows(const BLImageData& image, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data) noexcept {
+  BL_ASSERT(roi.x >= 0 && roi.y >= 0);
+  BL_ASSERT(roi.x + roi.w <= image.size.w && roi.y + roi.h <= image.size.h);
+
+  uint32_t bpp = bl_format_info[image.format].depth / 8u;
+  intptr_t stride = image.stride;
+  uint8_t* pixel_data = static_cast<uint8_t*>(image.pixel_data) + intptr_t(roi.y) * stride + intptr_t(roi.x) * intptr_t(bpp);
+
+  uint32_t band_h = band_height(size_t(roi.w) * bpp, uint32_t(roi.h));
+  int y = roi.y;
+  int y_end = roi.y + roi.h;
+
+  while (y < y_end) {
+    int h = bl_min<int>(int(band_h), y_end - y);
+    BL_PROPAGATE(emit_band(func, user_data, pixel_data, stride, roi.w, h, image.format, y));
+
+    pixel_data += intptr_t(h) * stride;
+    y += h;
+  }
+
+  return BL_SUCCESS;
+}
+
+BLResult read_frame_rows_fallback(BLImageDecoderImpl* impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  BLImage image;
+  BL_PROPAGATE(impl->virt->read_frame(impl, &image, data, size));
+
+  BLImageData image_data;
+  BL_PROPAGATE(image.get_data(&image_data));
+
+  if (BL_UNLIKELY(roi.x + roi.w > image_data.size.w || roi.y + roi.h > image_data.size.h)) {
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+  }
+
+  return emit_image_rows(image_data, roi, func, user_data);
+}
+
+// Copies bands received by `bl_image_decoder_read_frame_region()` into the destination image.
+struct RegionSink {
+  BLImage image;
+  BLImageData image_data;
+  BLRectI roi;
+};
+
+static BLResult BL_CDECL region_sink_func(const BLImageData* rows, int y, void* user_data) noexcept {
+  RegionSink* sink = static_cast<RegionSink*>(user_data);
+
+  if (sink->image.is_empty()) {
+    BL_PROPAGATE(sink->image.create(sink->roi.w, sink->roi.h, BLFormat(rows->format)));
+    BL_PROPAGATE(sink->image.make_mutable(&sink->image_data));
+  }
+
+  if (BL_UNLIKELY(rows->format != sink->image_data.format || rows->size.w != sink->roi.w)) {
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+  }
+
+  size_t row_size = size_t(rows->size.w) * (bl_format_info[rows->format].depth / 8u);
+  intptr_t dst_stride = sink->image_data.stride;
+  uint8_t* dst_line = static_cast<uint8_t*>(sink->image_data.pixel_data) + intptr_t(y - sink->roi.y) * dst_stride;
+  const uint8_t* src_line = static_cast<const uint8_t*>(rows->pixel_data);
+
+  for (int i = 0; i < rows->size.h; i++) {
+    memcpy(dst_line, src_line, row_size);
+    dst_line += dst_stride;
+    src_line += rows->stride;
+  }
+
+  return BL_SUCCESS;
+}
+
+} // {ImageDecoderInternal}
+} // {bl}
+
 // bl::ImageDecoder - API - Init & Destroy
 // =======================================
 
@@ -100,6 +205,48 @@ BL_API_IMPL BLResult bl_image_decoder_read_frame(BLImageDecoderCore* self, BLIma
   return self_impl->virt->read_frame(self_impl, image_out, data, size);
 }
 
+static BL_INLINE BLResult read_frame_rows_dispatch(BLImageDecoderImpl* impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  if (impl->codec.dcast().has_feature(BL_IMAGE_CODEC_FEATURE_READ_ROWS))
+    return impl->virt->read_frame_rows(impl, &roi, func, user_data, data, size);
+  else
+    return bl::ImageDecoderInternal::read_frame_rows_fallback(impl, roi, func, user_data, data, size);
+}
+
+BL_API_IMPL BLResult bl_image_decoder_read_frame_rows(BLImageDecoderCore* self, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  BL_ASSERT(self->_d.is_image_decoder());
+  BLImageDecoderImpl* self_impl = self->_impl();
+
+  if (BL_UNLIKELY(!func)) {
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+  }
+
+  BLImageInfo info;
+  BL_PROPAGATE(self_impl->virt->read_info(self_impl, &info, data, size));
+
+  BLRectI resolved_roi;
+  BL_PROPAGATE(bl::ImageDecoderInternal::resolve_roi(resolved_roi, roi, info.size));
+
+  return read_frame_rows_dispatch(self_impl, resolved_roi, func, user_data, data, size);
+}
+
+BL_API_IMPL BLResult bl_image_decoder_read_frame_region(BLImageDecoderCore* self, BLImageCore* image_out, const BLRectI* roi, const uint8_t* data, size_t size) noexcept {
+  using namespace bl::ImageDecoderInternal;
+
+  BL_ASSERT(self->_d.is_image_decoder());
+  BL_ASSERT(image_out->_d.is_image());
+
+  BLImageDecoderImpl* self_impl = self->_impl();
+
+  BLImageInfo info;
+  BL_PROPAGATE(self_impl->virt->read_info(self_impl, &info, data, size));
+
+  RegionSink sink;
+  BL_PROPAGATE(resolve_roi(sink.roi, roi, info.size));
+  BL_PROPAGATE(read_frame_rows_dispatch(self_impl, sink.roi, region_sink_func, &sink, data, size));
+
+  return bl_image_assign_move(image_out, &sink.image);
+}
+
 // bl::ImageDecoder - Virtual Functions (Null)
 // ===========================================
 
@@ -123,6 +270,11 @@ static BLResult BL_CDECL bl_image_decoder_impl_read_frame(BLImageDecoderImpl* im
   return BL_ERROR_INVALID_STATE;
 }
 
+static BLResult BL_CDECL bl_image_decoder_impl_read_frame_rows(BLImageDecoderImpl* impl, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept {
+  bl_unused(impl, roi, func, user_data, data, size);
+  return BL_ERROR_INVALID_STATE;
+}
+
 // bl::ImageDecoder - Runtime Registration
 // =======================================
 
@@ -138,6 +290,7 @@ void bl_image_decoder_rt_init(BLRuntimeContext* rt) noexcept {
   default_decoder.virt.restart = bl_image_decoder_impl_restart;
   default_decoder.virt.read_info = bl_image_decoder_impl_read_info;
   default_decoder.virt.read_frame = bl_image_decoder_impl_read_frame;
+  default_decoder.virt.read_frame_rows = bl_image_decoder_impl_read_frame_rows;
   default_decoder.impl->ctor(
     &default_decoder.virt,
     static_cast<BLImageCodecCore*>(&bl_object_defaults[BL_OBJECT_TYPE_IMAGE_CODEC]));
@@ -13,6 +13,19 @@
 //! \addtogroup bl_c_api
 //! \{
 
+//! \name BLImageDecoder - Types
+//! \{
+
+//! Callback used by \ref bl_image_decoder_read_frame_rows() to consume decoded rows.
+//!
+//! The callback receives a band of consecutive rows clipped to the requested region - `rows->size.w` is the width
+//! of the region and `rows->size.h` is the number of rows in the band. The `y` parameter specifies the index of the
+//! first row of the band in frame coordinates. The pixel data is only valid during the call. Returning anything but
+//! \ref BL_SUCCESS stops decoding and the returned value is propagated to the caller.
+typedef BLResult (BL_CDECL* BLImageDecoderRowsFunc)(const BLImageData* rows, int y, void* user_data) BL_NOEXCEPT_C;
+
+//! \}
+
 //! \name BLImageDecoder - C API
 //! \{
 
@@ -42,6 +55,12 @@ struct BLImageDecoderVirt BL_CLASS_INHERITS(BLObjectVirt) {
   BLResult (BL_CDECL* restart)(BLImageDecoderImpl* impl) BL_NOEXCEPT_C;
   BLResult (BL_CDECL* read_info)(BLImageDecoderImpl* impl, BLImageInfo* info_out, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
   BLResult (BL_CDECL* read_frame)(BLImageDecoderImpl* impl, BLImageCore* image_out, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
+
+  // NOTE: Slots below were added later and are only called when the codec advertises the corresponding feature, so
+  // decoders having a shorter virtual function table (built against an older version of Blend2D) keep working.
+
+  //! Only called when the codec has \ref BL_IMAGE_CODEC_FEATURE_READ_ROWS feature.
+  BLResult (BL_CDECL* read_frame_rows)(BLImageDecoderImpl* impl, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
 };
 
 //! Image decoder [C API Impl].
@@ -103,6 +122,8 @@ BL_API BLResult BL_CDECL bl_image_decoder_assign_weak(BLImageDecoderCore* self,
 BL_API BLResult BL_CDECL bl_image_decoder_restart(BLImageDecoderCore* self) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_image_decoder_read_info(BLImageDecoderCore* self, BLImageInfo* info_out, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_image_decoder_read_frame(BLImageDecoderCore* self, BLImageCore* image_out, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_image_decoder_read_frame_rows(BLImageDecoderCore* self, const BLRectI* roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL bl_image_decoder_read_frame_region(BLImageDecoderCore* self, BLImageCore* image_out, const BLRectI* roi, const uint8_t* data, size_t size) BL_NOEXCEPT_C;
 
 BL_END_C_DECLS
 
@@ -264,6 +285,58 @@ public:
     return bl_image_decoder_read_frame(this, &dst, static_cast<const uint8_t*>(data), size);
   }
 
+  //! Decodes the next frame and passes its rows to `func` in bands instead of storing them in a \ref BLImage.
+  //!
+  //! The decoder keeps only a few rows in memory when the format and the stream allow it, so the peak memory use
+  //! doesn't depend on the height of the image. See \ref BLImageDecoderRowsFunc for more details.
+  BL_INLINE_NODEBUG BLResult read_frame_rows(BLImageDecoderRowsFunc func, void* user_data, const BLArray<uint8_t>& buffer) noexcept {
+    return bl_image_decoder_read_frame_rows(this, nullptr, func, user_data, buffer.data(), buffer.size());
+  }
+
+  //! \overload
+  BL_INLINE_NODEBUG BLResult read_frame_rows(BLImageDecoderRowsFunc func, void* user_data, const BLArrayView<uint8_t>& view) noexcept {
+    return bl_image_decoder_read_frame_rows(this, nullptr, func, user_data, view.data, view.size);
+  }
+
+  //! \overload
+  BL_INLINE_NODEBUG BLResult read_frame_rows(BLImageDecoderRowsFunc func, void* user_data, const void* data, size_t size) noexcept {
+    return bl_image_decoder_read_frame_rows(this, nullptr, func, user_data, static_cast<const uint8_t*>(data), size);
+  }
+
+  //! Decodes the next frame and passes rows within `roi` to `func` in bands.
+  //!
+  //! The region is clipped to the frame and decoding fails with \ref BL_ERROR_INVALID_VALUE if the clipped region
+  //! is empty. Decoders stop as soon as the last row of the region was passed to `func` and JPEG decoder skips the
+  //! reconstruction of MCUs that don't contribute to the region.
+  BL_INLINE_NODEBUG BLResult read_frame_rows(const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const BLArray<uint8_t>& buffer) noexcept {
+    return bl_image_decoder_read_frame_rows(this, &roi, func, user_data, buffer.data(), buffer.size());
+  }
+
+  //! \overload
+  BL_INLINE_NODEBUG BLResult read_frame_rows(const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const BLArrayView<uint8_t>& view) noexcept {
+    return bl_image_decoder_read_frame_rows(this, &roi, func, user_data, view.data, view.size);
+  }
+
+  //! \overload
+  BL_INLINE_NODEBUG BLResult read_frame_rows(const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const void* data, size_t size) noexcept {
+    return bl_image_decoder_read_frame_rows(this, &roi, func, user_data, static_cast<const uint8_t*>(data), size);
+  }
+
+  //! Decodes only pixels within `roi` of the next frame into `dst`, which would have the size of the clipped region.
+  BL_INLINE_NODEBUG BLResult read_frame_region(BLImageCore& dst, const BLRectI& roi, const BLArray<uint8_t>& buffer) noexcept {
+    return bl_image_decoder_read_frame_region(this, &dst, &roi, buffer.data(), buffer.size());
+  }
+
+  //! \overload
+  BL_INLINE_NODEBUG BLResult read_frame_region(BLImageCore& dst, const BLRectI& roi, const BLArrayView<uint8_t>& view) noexcept {
+    return bl_image_decoder_read_frame_region(this, &dst, &roi, view.data, view.size);
+  }
+
+  //! \overload
+  BL_INLINE_NODEBUG BLResult read_frame_region(BLImageCore& dst, const BLRectI& roi, const void* data, size_t size) noexcept {
+    return bl_image_decoder_read_frame_region(this, &dst, &roi, static_cast<const uint8_t*>(data), size);
+  }
+
   //! \}
 };
 
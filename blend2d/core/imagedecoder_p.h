@@ -0,0 +1,58 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_IMAGEDECODER_P_H_INCLUDED
+#define BLEND2D_IMAGEDECODER_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/imagedecoder.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+namespace bl {
+namespace ImageDecoderInternal {
+
+//! \name BLImageDecoder - Internals - Row Streaming
+//! \{
+
+//! Preferred size of a single band of rows (in bytes) passed to \ref BLImageDecoderRowsFunc.
+static constexpr uint32_t kRowBandSize = 256u * 1024u;
+
+//! Returns the number of rows of a band having `bytes_per_line` bytes per row, in `[1, max_height]` range.
+static BL_INLINE uint32_t band_height(size_t bytes_per_line, uint32_t max_height) noexcept {
+  size_t n = size_t(kRowBandSize) / bl_max<size_t>(bytes_per_line, 1u);
+  return uint32_t(bl_clamp<size_t>(n, 1u, bl_max<uint32_t>(max_height, 1u)));
+}
+
+//! Passes a band of `h` rows, which starts at frame row `y`, to `func`.
+static BL_INLINE BLResult emit_band(BLImageDecoderRowsFunc func, void* user_data, void* pixel_data, intptr_t stride, int w, int h, uint32_t format, int y) noexcept {
+  BLImageData rows;
+  rows.pixel_data = pixel_data;
+  rows.stride = stride;
+  rows.size.reset(w, h);
+  rows.format = format;
+  rows.flags = 0;
+  return func(&rows, y, user_data);
+}
+
+//! Passes pixels of `image` within `roi` to `func` in bands - used when the whole frame is in memory.
+BL_HIDDEN BLResult emit_image_rows(const BLImageData& image, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data) noexcept;
+
+//! Implements `read_frame_rows()` by decoding the whole frame by `read_frame()` and passing its pixels within `roi`
+//! to `func`. Used by decoders or streams that cannot be decoded incrementally (for example interlaced images).
+BL_HIDDEN BLResult read_frame_rows_fallback(BLImageDecoderImpl* impl, const BLRectI& roi, BLImageDecoderRowsFunc func, void* user_data, const uint8_t* data, size_t size) noexcept;
+
+//! \}
+
+} // {ImageDecoderInternal}
+} // {bl}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_IMAGEDECODER_P_H_INCLUDED
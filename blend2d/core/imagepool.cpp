@@ -0,0 +1,282 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/imagepool_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/heap_p.h>
+#include <blend2d/support/intops_p.h>
+
+#if !defined(_WIN32)
+  #include <sys/mman.h>
+#endif
+
+namespace bl {
+namespace ImageInternal {
+
+// bl::Image - Pool - Globals
+// ==========================
+
+Wrap<ImagePool> image_pool_global;
+
+// bl::Image - Pool - Buffer Allocation
+// ====================================
+
+#if !defined(_WIN32)
+static void* map_huge_pages(size_t size, size_t* mapped_size) noexcept {
+  constexpr int kMapFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+  constexpr size_t kHugePageSize = ImagePool::kHugePageSize;
+
+  size_t aligned_size = IntOps::align_up(size, kHugePageSize);
+
+#if defined(MAP_HUGETLB)
+  // Explicit huge pages only work when the system has a reserved huge page pool, which is not the default.
+  void* huge_ptr = mmap(nullptr, aligned_size, PROT_READ | PROT_WRITE, kMapFlags | MAP_HUGETLB, -1, 0);
+  if (huge_ptr != MAP_FAILED) {
+    *mapped_size = aligned_size;
+    return huge_ptr;
+  }
+#endif
+
+  // Map more memory than required and unmap the unaligned head and tail, so the mapping is aligned to a huge page
+  // boundary, which is required by transparent huge pages to back the whole mapping.
+  size_t reserved_size = aligned_size + kHugePageSize;
+  void* reserved_ptr = mmap(nullptr, reserved_size, PROT_READ | PROT_WRITE, kMapFlags, -1, 0);
+
+  if (reserved_ptr == MAP_FAILED)
+    return nullptr;
+
+  uint8_t* ptr = static_cast<uint8_t*>(reserved_ptr);
+  uint8_t* aligned_ptr = IntOps::align_up(ptr, kHugePageSize);
+  size_t head_size = size_t(aligned_ptr - ptr);
+  size_t tail_size = reserved_size - head_size - aligned_size;
+
+  if (head_size)
+    munmap(ptr, head_size);
+
+  if (tail_size)
+    munmap(aligned_ptr + aligned_size, tail_size);
+
+#if defined(MADV_HUGEPAGE)
+  madvise(aligned_ptr, aligned_size, MADV_HUGEPAGE);
+#endif
+
+  *mapped_size = aligned_size;
+  return aligned_ptr;
+}
+
+static void unmap_huge_pages(void* ptr, size_t size) noexcept {
+  munmap(ptr, size);
+}
+#else
+// Large pages require SeLockMemoryPrivilege on Windows, which is not something a library should require, so huge
+// pages are not used and buffers are always allocated by `Heap`.
+static void* map_huge_pages(size_t size, size_t* mapped_size) noexcept {
+  bl_unused(size, mapped_size);
+  return nullptr;
+}
+
+static void unmap_huge_pages(void* ptr, size_t size) noexcept {
+  bl_unused(ptr, size);
+}
+#endif
+
+static ImagePool::Buffer* alloc_buffer(uint32_t size_class, uint32_t flags) noexcept {
+  size_t capacity = ImagePool::capacity_of(size_class);
+  size_t required_size = capacity + sizeof(ImagePool::Buffer);
+
+  void* raw_ptr = nullptr;
+  size_t raw_size = 0;
+  ImagePool::BufferKind kind = ImagePool::BufferKind::kHeap;
+  uint8_t* buffer_ptr = nullptr;
+
+  if ((flags & BL_IMAGE_POOL_FLAG_HUGE_PAGES) && required_size >= ImagePool::kHugePageSize) {
+    raw_ptr = map_huge_pages(required_size, &raw_size);
+    if (raw_ptr) {
+      kind = ImagePool::BufferKind::kHugePages;
+      buffer_ptr = static_cast<uint8_t*>(raw_ptr);
+    }
+  }
+
+  if (!raw_ptr) {
+    raw_size = required_size + ImagePool::kBufferAlignment;
+    raw_ptr = Heap::alloc(BL_ALLOCATOR_CATEGORY_OBJECT, raw_size);
+
+    if (BL_UNLIKELY(!raw_ptr))
+      return nullptr;
+
+    buffer_ptr = IntOps::align_up(static_cast<uint8_t*>(raw_ptr), ImagePool::kBufferAlignment);
+  }
+
+  ImagePool::Buffer* buffer = reinterpret_cast<ImagePool::Buffer*>(buffer_ptr);
+  buffer->next = nullptr;
+  buffer->raw_ptr = raw_ptr;
+  buffer->raw_size = raw_size;
+  buffer->capacity = capacity;
+  buffer->size_class = size_class;
+  buffer->kind = kind;
+  return buffer;
+}
+
+static void free_buffer(ImagePool::Buffer* buffer) noexcept {
+  if (buffer->kind == ImagePool::BufferKind::kHugePages)
+    unmap_huge_pages(buffer->raw_ptr, buffer->raw_size);
+  else
+    Heap::free(BL_ALLOCATOR_CATEGORY_OBJECT, buffer->raw_ptr);
+}
+
+static void free_buffer_list(ImagePool::Buffer* buffer) noexcept {
+  while (buffer) {
+    ImagePool::Buffer* next = buffer->next;
+    free_buffer(buffer);
+    buffer = next;
+  }
+}
+
+// bl::Image - Pool - Interface
+// ============================
+
+void ImagePool::set_limit(size_t size_limit, uint32_t flags) noexcept {
+  Buffer* evicted = nullptr;
+
+  _mutex.protect([&] {
+    bl_atomic_store_relaxed(&_size_limit, size_limit);
+    _flags = flags;
+
+    // Evict larger buffers first as they are less likely to be reused than smaller ones.
+    uint32_t size_class = kSizeClassCount;
+    while (_idle_size > size_limit && size_class) {
+      Buffer*& list = _free_lists[--size_class];
+      while (list && _idle_size > size_limit) {
+        Buffer* buffer = list;
+        list = buffer->next;
+
+        _idle_count--;
+        _idle_size -= buffer->capacity;
+
+        buffer->next = evicted;
+        evicted = buffer;
+      }
+    }
+  });
+
+  free_buffer_list(evicted);
+}
+
+ImagePool::Buffer* ImagePool::acquire(size_t size) noexcept {
+  if (!is_enabled() || size < kMinBufferSize)
+    return nullptr;
+
+  uint32_t size_class = size_class_of(size);
+  if (size_class >= kSizeClassCount)
+    return nullptr;
+
+  uint32_t flags = 0;
+  Buffer* buffer = _mutex.protect([&]() -> Buffer* {
+    Buffer* b = _free_lists[size_class];
+    if (b) {
+      _free_lists[size_class] = b->next;
+      _idle_count--;
+      _idle_size -= b->capacity;
+      _hit_count++;
+    }
+    else {
+      _miss_count++;
+      flags = _flags;
+    }
+    return b;
+  });
+
+  if (buffer) {
+    buffer->next = nullptr;
+    return buffer;
+  }
+
+  return alloc_buffer(size_class, flags);
+}
+
+void ImagePool::release(Buffer* buffer) noexcept {
+  bool pooled = _mutex.protect([&] {
+    if (buffer->capacity > _size_limit - bl_min(_idle_size, _size_limit))
+      return false;
+
+    buffer->next = _free_lists[buffer->size_class];
+    _free_lists[buffer->size_class] = buffer;
+    _idle_count++;
+    _idle_size += buffer->capacity;
+    return true;
+  });
+
+  if (!pooled)
+    free_buffer(buffer);
+}
+
+void ImagePool::clear() noexcept {
+  Buffer* evicted = nullptr;
+
+  _mutex.protect([&] {
+    for (uint32_t size_class = 0; size_class < kSizeClassCount; size_class++) {
+      Buffer* list = _free_lists[size_class];
+      _free_lists[size_class] = nullptr;
+
+      while (list) {
+        Buffer* next = list->next;
+        list->next = evicted;
+        evicted = list;
+        list = next;
+      }
+    }
+
+    _idle_count = 0;
+    _idle_size = 0;
+  });
+
+  free_buffer_list(evicted);
+}
+
+void BL_CDECL release_pooled_buffer(void* impl, void* external_data, void* user_data) noexcept {
+  bl_unused(impl, external_data);
+  image_pool_global->release(static_cast<ImagePool::Buffer*>(user_data));
+}
+
+} // {ImageInternal}
+} // {bl}
+
+// bl::Image - Pool - Runtime Registration
+// =======================================
+
+static void BL_CDECL bl_image_pool_rt_shutdown(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+
+  // The pool is not destroyed as images that use pooled buffers can still be alive. Disabling the pool makes sure
+  // that such buffers are freed when their images are destroyed.
+  bl::ImageInternal::image_pool_global->set_limit(0, 0);
+}
+
+static void BL_CDECL bl_image_pool_rt_cleanup(BLRuntimeContext* rt, BLRuntimeCleanupFlags cleanup_flags) noexcept {
+  bl_unused(rt);
+  if (cleanup_flags & BL_RUNTIME_CLEANUP_IMAGE_POOL)
+    bl::ImageInternal::image_pool_global->clear();
+}
+
+static void BL_CDECL bl_image_pool_rt_memory_info(BLRuntimeContext* rt, BLRuntimeMemoryInfo* memory_info) noexcept {
+  bl_unused(rt);
+  memory_info->image_pool_count = bl::ImageInternal::image_pool_global->idle_count();
+  memory_info->image_pool_size = bl::ImageInternal::image_pool_global->idle_size();
+  memory_info->image_pool_hit_count = size_t(bl::ImageInternal::image_pool_global->hit_count());
+  memory_info->image_pool_miss_count = size_t(bl::ImageInternal::image_pool_global->miss_count());
+}
+
+void bl_image_rt_set_pool_limit(size_t size_limit, uint32_t flags) noexcept {
+  bl::ImageInternal::image_pool_global->set_limit(size_limit, flags);
+}
+
+void bl_image_pool_rt_init(BLRuntimeContext* rt) noexcept {
+  bl::ImageInternal::image_pool_global.init();
+
+  rt->shutdown_handlers.add(bl_image_pool_rt_shutdown);
+  rt->cleanup_handlers.add(bl_image_pool_rt_cleanup);
+  rt->memory_info_handlers.add(bl_image_pool_rt_memory_info);
+}
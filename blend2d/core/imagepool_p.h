@@ -0,0 +1,170 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_IMAGEPOOL_P_H_INCLUDED
+#define BLEND2D_IMAGEPOOL_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/image_p.h>
+#include <blend2d/core/object_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/mutex_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+namespace bl {
+namespace ImageInternal {
+
+//! Pool of pixel buffers used by images created by \ref bl_image_create().
+//!
+//! Pixel buffers of released images are kept in the pool and reused by images of the same size class, which
+//! avoids allocating (and page faulting) the same amount of memory again when images of the same size are
+//! repeatedly created and destroyed. Buffers are grouped by size classes, there are 4 size classes per power
+//! of two, so a buffer is at most 25% larger than requested.
+//!
+//! The pool is disabled by default (the size limit is zero) and can be enabled by \ref bl_runtime_set_image_pool_limit().
+class ImagePool {
+public:
+  BL_NONCOPYABLE(ImagePool)
+
+  //! Minimum size of pixel data of an image to use the pool, smaller images are allocated together with their Impl.
+  static inline constexpr size_t kMinBufferSize = 64u * 1024u;
+  //! Alignment of pixel data of pooled buffers.
+  static inline constexpr size_t kBufferAlignment = 64u;
+  //! Size of a huge page, only buffers greater than or equal to this size can use huge pages.
+  static inline constexpr size_t kHugePageSize = 2u * 1024u * 1024u;
+  //! Number of size classes.
+  static inline constexpr uint32_t kSizeClassCount = 4u * (BL_TARGET_ARCH_BITS - 16u);
+
+  //! How the memory of a buffer was allocated.
+  enum class BufferKind : uint32_t {
+    //! Allocated by `Heap`.
+    kHeap = 0,
+    //! Allocated by mapping virtual memory backed by huge pages.
+    kHugePages = 1
+  };
+
+  //! Pixel buffer, which is followed by its pixel data.
+  struct alignas(kBufferAlignment) Buffer {
+    //! Next buffer in a free list of a size class.
+    Buffer* next;
+    //! Start of the allocation.
+    void* raw_ptr;
+    //! Size of the allocation.
+    size_t raw_size;
+    //! Capacity of pixel data.
+    size_t capacity;
+    //! Size class.
+    uint32_t size_class;
+    //! Buffer kind.
+    BufferKind kind;
+
+    BL_INLINE uint8_t* data() noexcept { return reinterpret_cast<uint8_t*>(this + 1); }
+  };
+
+  //! \name Members
+  //! \{
+
+  BLMutex _mutex;
+  //! Free lists of idle buffers, one per size class.
+  Buffer* _free_lists[kSizeClassCount] {};
+
+  size_t _size_limit = 0;
+  uint32_t _flags = 0;
+  size_t _idle_count = 0;
+  size_t _idle_size = 0;
+  uint64_t _hit_count = 0;
+  uint64_t _miss_count = 0;
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE ImagePool() noexcept {}
+  BL_INLINE ~ImagePool() noexcept { clear(); }
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  //! Tests whether the pool is enabled - it's only a hint used to avoid locking when the pool is disabled.
+  BL_INLINE bool is_enabled() const noexcept { return bl_atomic_fetch_relaxed(&_size_limit) != 0u; }
+
+  BL_INLINE size_t idle_count() noexcept { return _mutex.protect([&] { return _idle_count; }); }
+  BL_INLINE size_t idle_size() noexcept { return _mutex.protect([&] { return _idle_size; }); }
+  BL_INLINE uint64_t hit_count() noexcept { return _mutex.protect([&] { return _hit_count; }); }
+  BL_INLINE uint64_t miss_count() noexcept { return _mutex.protect([&] { return _miss_count; }); }
+
+  //! \}
+
+  //! \name Size Classes
+  //! \{
+
+  //! Returns a size class of a buffer that can hold `size` bytes (`size` must be at least `kMinBufferSize`).
+  static BL_INLINE uint32_t size_class_of(size_t size) noexcept {
+    BL_ASSERT(size >= kMinBufferSize);
+
+    size_t s = size - 1u;
+    uint32_t log2 = uint32_t(IntOps::bit_size_of<size_t>() - 1u - IntOps::clz(s));
+    uint32_t sub = uint32_t(s >> (log2 - 2u)) & 0x3u;
+    return (log2 - 15u) * 4u + sub;
+  }
+
+  //! Returns the capacity of buffers of the given `size_class`.
+  static BL_INLINE size_t capacity_of(uint32_t size_class) noexcept {
+    uint32_t log2 = size_class / 4u + 15u;
+    size_t sub = size_class & 0x3u;
+    return (size_t(5u) + sub) << (log2 - 2u);
+  }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Sets the size limit of idle buffers and `flags` (see \ref BLImagePoolFlags), idle buffers that exceed the new
+  //! limit are released. Zero size limit disables the pool.
+  BL_HIDDEN void set_limit(size_t size_limit, uint32_t flags) noexcept;
+
+  //! Returns a buffer that can hold at least `size` bytes of pixel data, either reused or newly allocated.
+  //!
+  //! Returns null if the pool is disabled, the size is not suitable for pooling, or the allocation failed.
+  BL_HIDDEN Buffer* acquire(size_t size) noexcept;
+
+  //! Returns `buffer` to the pool or releases it if the pool would exceed its size limit.
+  BL_HIDDEN void release(Buffer* buffer) noexcept;
+
+  //! Releases all idle buffers.
+  BL_HIDDEN void clear() noexcept;
+
+  //! \}
+};
+
+BL_HIDDEN extern Wrap<ImagePool> image_pool_global;
+
+//! Destroy function of images that use a pooled buffer, passed to \ref ObjectInternal::alloc_impl_external_t().
+BL_HIDDEN void BL_CDECL release_pooled_buffer(void* impl, void* external_data, void* user_data) noexcept;
+
+//! Tests whether the image `impl` uses a pooled buffer.
+static BL_INLINE bool is_impl_pooled(BLImagePrivateImpl* impl) noexcept {
+  return ObjectInternal::is_impl_external(impl) &&
+         ObjectInternal::get_external_info(impl)->destroy_func == release_pooled_buffer;
+}
+
+} // {ImageInternal}
+} // {bl}
+
+BL_HIDDEN void bl_image_pool_rt_init(BLRuntimeContext* rt) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_IMAGEPOOL_P_H_INCLUDED
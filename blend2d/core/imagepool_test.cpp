@@ -0,0 +1,114 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/image.h>
+#include <blend2d/core/runtime.h>
+
+// bl::Image - Pool - Tests
+// ========================
+
+namespace bl {
+namespace Tests {
+
+static BLRuntimeMemoryInfo query_image_pool_info() noexcept {
+  BLRuntimeMemoryInfo info{};
+  BLRuntime::query_memory_info(&info);
+  return info;
+}
+
+static void fill_image_pattern(BLImage& img, uint32_t seed) noexcept {
+  BLImageData data;
+  EXPECT_SUCCESS(img.make_mutable(&data));
+
+  for (int y = 0; y < data.size.h; y++) {
+    uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(data.pixel_data) + intptr_t(y) * data.stride);
+    for (int x = 0; x < data.size.w; x++)
+      row[x] = 0xFF000000u | (seed + uint32_t(y * data.size.w + x));
+  }
+}
+
+UNIT(image_pool, BL_TEST_GROUP_IMAGE_CONTAINERS) {
+  INFO("Testing whether pixel buffers of destroyed images are reused");
+  {
+    EXPECT_SUCCESS(BLRuntime::set_image_pool_limit(16u * 1024u * 1024u));
+    BLRuntimeMemoryInfo before = query_image_pool_info();
+
+    void* pixel_data = nullptr;
+    {
+      BLImage img(256, 256, BL_FORMAT_PRGB32);
+      fill_image_pattern(img, 0);
+
+      BLImageData data;
+      EXPECT_SUCCESS(img.get_data(&data));
+      pixel_data = data.pixel_data;
+      EXPECT_EQ(uintptr_t(pixel_data) % 64u, 0u);
+    }
+
+    EXPECT_EQ(query_image_pool_info().image_pool_count, before.image_pool_count + 1u);
+
+    BLImage img(256, 256, BL_FORMAT_XRGB32);
+    BLImageData data;
+    EXPECT_SUCCESS(img.get_data(&data));
+    EXPECT_EQ(data.pixel_data, pixel_data);
+
+    BLRuntimeMemoryInfo after = query_image_pool_info();
+    EXPECT_EQ(after.image_pool_count, before.image_pool_count);
+    EXPECT_EQ(after.image_pool_hit_count - before.image_pool_hit_count, 1u);
+    EXPECT_EQ(after.image_pool_miss_count - before.image_pool_miss_count, 1u);
+
+    // Creating an image of the same size and format must keep the pooled buffer.
+    EXPECT_SUCCESS(img.create(256, 256, BL_FORMAT_XRGB32));
+    EXPECT_SUCCESS(img.get_data(&data));
+    EXPECT_EQ(data.pixel_data, pixel_data);
+  }
+
+  INFO("Testing whether pooled images can be copied and compared");
+  {
+    BLImage a(300, 200, BL_FORMAT_PRGB32);
+    BLImage b(300, 200, BL_FORMAT_PRGB32);
+
+    fill_image_pattern(a, 1);
+    fill_image_pattern(b, 1);
+    EXPECT_TRUE(a.equals(b));
+
+    BLImage c;
+    EXPECT_SUCCESS(c.assign_deep(a));
+    EXPECT_TRUE(c.equals(a));
+  }
+
+  INFO("Testing huge page backed pixel buffers");
+  {
+    EXPECT_SUCCESS(BLRuntime::set_image_pool_limit(32u * 1024u * 1024u, BL_IMAGE_POOL_FLAG_HUGE_PAGES));
+
+    BLImage a(1024, 1024, BL_FORMAT_PRGB32);
+    BLImage b(1024, 1024, BL_FORMAT_PRGB32);
+
+    fill_image_pattern(a, 2);
+    fill_image_pattern(b, 2);
+    EXPECT_TRUE(a.equals(b));
+  }
+
+  INFO("Testing runtime cleanup of the image buffer pool");
+  {
+    EXPECT_NE(query_image_pool_info().image_pool_count, 0u);
+    EXPECT_SUCCESS(BLRuntime::cleanup(BL_RUNTIME_CLEANUP_IMAGE_POOL));
+    EXPECT_EQ(query_image_pool_info().image_pool_count, 0u);
+    EXPECT_EQ(query_image_pool_info().image_pool_size, 0u);
+
+    EXPECT_SUCCESS(BLRuntime::set_image_pool_limit(0));
+    {
+      BLImage img(256, 256, BL_FORMAT_PRGB32);
+    }
+    EXPECT_EQ(query_image_pool_info().image_pool_count, 0u);
+  }
+}
+
+} // {Tests}
+} // {bl}
+
+#endif // BL_TEST
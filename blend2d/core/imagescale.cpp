@@ -13,19 +13,14 @@
 #include <blend2d/support/memops_p.h>
 #include <blend2d/support/ptrops_p.h>
 #include <blend2d/support/scopedbuffer_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/paralleljob_p.h>
 
 namespace bl {
 
-typedef void (BL_CDECL* ImageScaleFilterFunc)(double* dst, const double* t_array, size_t n) noexcept;
-
 // bl::ImageScale - Ops
 // ====================
 
-struct ImageScaleOps {
-  BLResult (BL_CDECL* weights)(ImageScaleContext::Data* d, uint32_t dir, ImageScaleFilterFunc filter_func) noexcept;
-  void (BL_CDECL* horz[BL_FORMAT_MAX_VALUE + 1])(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept;
-  void (BL_CDECL* vert[BL_FORMAT_MAX_VALUE + 1])(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept;
-};
 static ImageScaleOps image_scale_ops;
 
 // bl::ImageScale - Filter Implementations
@@ -791,6 +786,76 @@ static void BL_CDECL image_scale_vert_a8(const ImageScaleContext::Data* d, uint8
   bl_image_scale_vert_bytes(d, dst_line, dst_stride, src_line, src_stride, 1);
 }
 
+// bl::ImageScale - Vert (Multithreaded)
+// =====================================
+
+//! Minimum number of destination rows processed by a single thread.
+static constexpr uint32_t kImageScaleMinBandHeight = 32;
+
+//! Minimum amount of work (destination bytes multiplied by vertical kernel size) per thread.
+static constexpr uint64_t kImageScaleMinWorkPerThread = 4u * 1024u * 1024u;
+
+struct ImageScaleVertJob {
+  ImageScaleProcessFunc func;
+  const ImageScaleContext::Data* d;
+
+  uint8_t* dst_line;
+  intptr_t dst_stride;
+  const uint8_t* src_line;
+  intptr_t src_stride;
+
+  uint32_t band_height;
+  uint32_t band_count;
+  size_t band_index;
+};
+
+static void BL_CDECL image_scale_vert_process_bands(void* data) noexcept {
+  ImageScaleVertJob* job = static_cast<ImageScaleVertJob*>(data);
+
+  const ImageScaleContext::Data* d = job->d;
+  uint32_t dh = uint32_t(d->dst_size[ImageScaleContext::kDirVert]);
+  size_t kernel_size = size_t(unsigned(d->kernel_size[ImageScaleContext::kDirVert]));
+
+  for (;;) {
+    size_t band = bl_atomic_fetch_add_strong(&job->band_index);
+    if (band >= job->band_count)
+      break;
+
+    uint32_t y0 = uint32_t(band) * job->band_height;
+    uint32_t h = bl_min(job->band_height, dh - y0);
+
+    // Each band is described by a copy of the context data that only sees its own rows - records and weights are
+    // per destination row and source positions stored in records are absolute, so nothing else has to be adjusted.
+    ImageScaleContext::Data band_data = *d;
+    band_data.dst_size[ImageScaleContext::kDirVert] = int(h);
+    band_data.record_list[ImageScaleContext::kDirVert] += y0;
+    band_data.weight_list[ImageScaleContext::kDirVert] += size_t(y0) * kernel_size;
+
+    job->func(&band_data, job->dst_line + intptr_t(y0) * job->dst_stride, job->dst_stride, job->src_line, job->src_stride);
+  }
+}
+
+static void image_scale_vert_mt(ImageScaleProcessFunc func, const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t thread_count) noexcept {
+  uint32_t dh = uint32_t(d->dst_size[ImageScaleContext::kDirVert]);
+
+  // Use more bands than threads so the work is balanced when some threads start later than others.
+  uint32_t band_count = bl_min<uint32_t>(bl_min<uint32_t>(thread_count, 32u) * 4u, (dh + kImageScaleMinBandHeight - 1u) / kImageScaleMinBandHeight);
+  uint32_t band_height = (dh + band_count - 1u) / band_count;
+
+  ImageScaleVertJob job;
+  job.func = func;
+  job.d = d;
+  job.dst_line = dst_line;
+  job.dst_stride = dst_stride;
+  job.src_line = src_line;
+  job.src_stride = src_stride;
+  job.band_height = band_height;
+  job.band_count = (dh + band_height - 1u) / band_height;
+  job.band_index = 0;
+
+  bl_run_parallel_job(image_scale_vert_process_bands, &job, thread_count);
+}
+
 // bl::ImageScaleContext - Reset
 // =============================
 
@@ -900,18 +965,52 @@ BLResult ImageScaleContext::create(const BLSizeI& to, const BLSizeI& from, uint3
 // bl::ImageScale - Process
 // ========================
 
+uint32_t ImageScaleContext::suggested_vert_thread_count() const noexcept {
+  BL_ASSERT(is_initialized());
+
+  uint32_t max_threads = bl_runtime_context.system_info.thread_count;
+  if (max_threads <= 1u)
+    return 1u;
+
+  uint32_t dh = uint32_t(data->dst_size[kDirVert]);
+  uint64_t work = uint64_t(unsigned(data->dst_size[kDirHorz])) * 4u * dh * unsigned(data->kernel_size[kDirVert]);
+
+  uint64_t n = bl_min<uint64_t>(work / kImageScaleMinWorkPerThread, dh / kImageScaleMinBandHeight);
+  return uint32_t(bl_clamp<uint64_t>(n, 1u, max_threads));
+}
+
 BLResult ImageScaleContext::process_horz_data(uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t format) const noexcept {
   BL_ASSERT(is_initialized());
   image_scale_ops.horz[format](this->data, dst_line, dst_stride, src_line, src_stride);
   return BL_SUCCESS;
 }
 
-BLResult ImageScaleContext::process_vert_data(uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t format) const noexcept {
+BLResult ImageScaleContext::process_vert_data(uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t format, uint32_t thread_count) const noexcept {
   BL_ASSERT(is_initialized());
-  image_scale_ops.vert[format](this->data, dst_line, dst_stride, src_line, src_stride);
+
+  if (thread_count > 1u && uint32_t(this->data->dst_size[kDirVert]) > kImageScaleMinBandHeight)
+    image_scale_vert_mt(image_scale_ops.vert[format], this->data, dst_line, dst_stride, src_line, src_stride, thread_count);
+  else
+    image_scale_ops.vert[format](this->data, dst_line, dst_stride, src_line, src_stride);
+
   return BL_SUCCESS;
 }
 
+// bl::ImageScale - Init
+// =====================
+
+void image_scale_init_ref(ImageScaleOps& ops) noexcept {
+  ops.weights = image_scale_weights;
+
+  ops.horz[BL_FORMAT_PRGB32] = image_scale_horz_prgb32;
+  ops.horz[BL_FORMAT_XRGB32] = image_scale_horz_xrgb32;
+  ops.horz[BL_FORMAT_A8    ] = image_scale_horz_a8;
+
+  ops.vert[BL_FORMAT_PRGB32] = image_scale_vert_prgb32;
+  ops.vert[BL_FORMAT_XRGB32] = image_scale_vert_xrgb32;
+  ops.vert[BL_FORMAT_A8    ] = image_scale_vert_a8;
+}
+
 } // {bl}
 
 // bl::ImageScale - Runtime Registration
@@ -920,13 +1019,24 @@ BLResult ImageScaleContext::process_vert_data(uint8_t* dst_line, intptr_t dst_st
 void bl_image_scale_rt_init(BLRuntimeContext* rt) noexcept {
   bl_unused(rt);
 
-  bl::image_scale_ops.weights = bl::image_scale_weights;
+  bl::ImageScaleOps& ops = bl::image_scale_ops;
+  bl::image_scale_init_ref(ops);
 
-  bl::image_scale_ops.horz[BL_FORMAT_PRGB32] = bl::image_scale_horz_prgb32;
-  bl::image_scale_ops.horz[BL_FORMAT_XRGB32] = bl::image_scale_horz_xrgb32;
-  bl::image_scale_ops.horz[BL_FORMAT_A8    ] = bl::image_scale_horz_a8;
+#if defined(BL_BUILD_OPT_SSE2)
+  if (bl_runtime_has_sse2(rt)) {
+    bl::image_scale_init_sse2(ops);
+  }
+#endif // BL_BUILD_OPT_SSE2
+
+#if defined(BL_BUILD_OPT_AVX2)
+  if (bl_runtime_has_avx2(rt)) {
+    bl::image_scale_init_avx2(ops);
+  }
+#endif // BL_BUILD_OPT_AVX2
 
-  bl::image_scale_ops.vert[BL_FORMAT_PRGB32] = bl::image_scale_vert_prgb32;
-  bl::image_scale_ops.vert[BL_FORMAT_XRGB32] = bl::image_scale_vert_xrgb32;
-  bl::image_scale_ops.vert[BL_FORMAT_A8    ] = bl::image_scale_vert_a8;
+#if defined(BL_BUILD_OPT_ASIMD)
+  if (bl_runtime_has_asimd(rt)) {
+    bl::image_scale_init_asimd(ops);
+  }
+#endif // BL_BUILD_OPT_ASIMD
 }
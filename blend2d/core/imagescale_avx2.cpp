@@ -0,0 +1,19 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#if defined(BL_TARGET_OPT_AVX2)
+
+#include <blend2d/core/imagescalesimdimpl_p.h>
+
+namespace bl {
+
+void image_scale_init_avx2(ImageScaleOps& ops) noexcept {
+  image_scale_init_simd(ops);
+}
+
+} // {bl}
+
+#endif // BL_TARGET_OPT_AVX2
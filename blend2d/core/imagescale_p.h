@@ -60,10 +60,47 @@ public:
   BL_HIDDEN BLResult reset() noexcept;
   BL_HIDDEN BLResult create(const BLSizeI& to, const BLSizeI& from, uint32_t filter) noexcept;
 
+  //! Returns the number of threads that is worth using by `process_vert_data()` - returns 1 if the vertical pass is
+  //! too small to benefit from splitting it into bands processed by the runtime thread pool.
+  BL_HIDDEN uint32_t suggested_vert_thread_count() const noexcept;
+
   BL_HIDDEN BLResult process_horz_data(uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t format) const noexcept;
-  BL_HIDDEN BLResult process_vert_data(uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t format) const noexcept;
+
+  //! Processes the vertical pass. If `thread_count` is greater than 1 the destination rows are split into bands that
+  //! are processed by the calling thread and by up to `thread_count - 1` threads acquired from the global thread pool.
+  BL_HIDDEN BLResult process_vert_data(uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride, uint32_t format, uint32_t thread_count = 1) const noexcept;
+};
+
+// bl::ImageScale - Ops
+// ====================
+
+typedef void (BL_CDECL* ImageScaleFilterFunc)(double* dst, const double* t_array, size_t n) noexcept;
+typedef void (BL_CDECL* ImageScaleProcessFunc)(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept;
+
+//! Image scaling functions - reference implementations are replaced by SIMD ones during runtime initialization.
+//!
+//! All implementations consume the same fixed-point weights (8-bit fraction, sum of weights is `0x100`) and must
+//! produce bit-exact results.
+struct ImageScaleOps {
+  BLResult (BL_CDECL* weights)(ImageScaleContext::Data* d, uint32_t dir, ImageScaleFilterFunc filter_func) noexcept;
+  ImageScaleProcessFunc horz[BL_FORMAT_MAX_VALUE + 1];
+  ImageScaleProcessFunc vert[BL_FORMAT_MAX_VALUE + 1];
 };
 
+BL_HIDDEN void image_scale_init_ref(ImageScaleOps& ops) noexcept;
+
+#if defined(BL_BUILD_OPT_SSE2)
+BL_HIDDEN void image_scale_init_sse2(ImageScaleOps& ops) noexcept;
+#endif // BL_BUILD_OPT_SSE2
+
+#if defined(BL_BUILD_OPT_AVX2)
+BL_HIDDEN void image_scale_init_avx2(ImageScaleOps& ops) noexcept;
+#endif // BL_BUILD_OPT_AVX2
+
+#if defined(BL_BUILD_OPT_ASIMD)
+BL_HIDDEN void image_scale_init_asimd(ImageScaleOps& ops) noexcept;
+#endif // BL_BUILD_OPT_ASIMD
+
 } // {bl}
 
 //! \}
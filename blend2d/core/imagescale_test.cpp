@@ -0,0 +1,185 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/format_p.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/imagescale_p.h>
+#include <blend2d/core/random.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/intops_p.h>
+
+// bl::ImageScale - Tests
+// ======================
+
+namespace bl::Tests {
+
+static const uint32_t image_scale_formats[] = { BL_FORMAT_PRGB32, BL_FORMAT_XRGB32, BL_FORMAT_A8 };
+static const char* image_scale_filter_names[] = { "None", "Nearest", "Bilinear", "Bicubic", "Lanczos" };
+
+struct ImageScaleTestBuffer {
+  uint8_t* data;
+  intptr_t stride;
+  size_t size;
+
+  // Rows are aligned the same way as `BLImage` aligns them - the reference A8 implementation relies on it.
+  ImageScaleTestBuffer(uint32_t w, uint32_t h, uint32_t bpp) noexcept
+    : data(nullptr),
+      stride(intptr_t(IntOps::align_up(w * bpp, 16u))),
+      size(size_t(stride) * h) {
+    data = static_cast<uint8_t*>(malloc(size));
+  }
+
+  ~ImageScaleTestBuffer() noexcept { free(data); }
+
+  void fill_random(BLRandom& rnd) noexcept {
+    for (size_t i = 0; i < size; i++)
+      data[i] = uint8_t(rnd.next_uint32() >> 24u);
+  }
+
+  void fill_zero() noexcept { memset(data, 0, size); }
+};
+
+static void test_image_scale_impl(const ImageScaleOps& reference, const ImageScaleOps& optimized, const char* impl_name) noexcept {
+  static const uint32_t sizes[] = { 1, 2, 3, 5, 7, 16, 17, 31, 45, 64, 77 };
+
+  INFO("Testing %s implementation", impl_name);
+  BLRandom rnd(0x1234FEED5678ABCDu);
+
+  for (uint32_t format : image_scale_formats) {
+    uint32_t bpp = bl_format_info[format].depth / 8u;
+
+    for (uint32_t filter = BL_IMAGE_SCALE_FILTER_NEAREST; filter <= BL_IMAGE_SCALE_FILTER_MAX_VALUE; filter++) {
+      for (uint32_t src_size : sizes) {
+        for (uint32_t dst_size : sizes) {
+          ImageScaleContext ctx;
+          EXPECT_SUCCESS(ctx.create(BLSizeI(int(dst_size), int(dst_size)), BLSizeI(int(src_size), int(src_size)), filter));
+
+          // Horizontal pass: [src_size x src_size] -> [dst_size x src_size].
+          {
+            ImageScaleTestBuffer src(src_size, src_size, bpp);
+            ImageScaleTestBuffer ref(dst_size, src_size, bpp);
+            ImageScaleTestBuffer opt(dst_size, src_size, bpp);
+
+            src.fill_random(rnd);
+            ref.fill_zero();
+            opt.fill_zero();
+
+            reference.horz[format](ctx.data, ref.data, ref.stride, src.data, src.stride);
+            optimized.horz[format](ctx.data, opt.data, opt.stride, src.data, src.stride);
+
+            EXPECT_EQ(memcmp(ref.data, opt.data, ref.size), 0)
+              .message("Horz mismatch: Format=%u Filter=%s Src=%u Dst=%u Impl=%s",
+                       format, image_scale_filter_names[filter], src_size, dst_size, impl_name);
+          }
+
+          // Vertical pass: [dst_size x src_size] -> [dst_size x dst_size].
+          {
+            ImageScaleTestBuffer src(dst_size, src_size, bpp);
+            ImageScaleTestBuffer ref(dst_size, dst_size, bpp);
+            ImageScaleTestBuffer opt(dst_size, dst_size, bpp);
+
+            src.fill_random(rnd);
+            ref.fill_zero();
+            opt.fill_zero();
+
+            reference.vert[format](ctx.data, ref.data, ref.stride, src.data, src.stride);
+            optimized.vert[format](ctx.data, opt.data, opt.stride, src.data, src.stride);
+
+            EXPECT_EQ(memcmp(ref.data, opt.data, ref.size), 0)
+              .message("Vert mismatch: Format=%u Filter=%s Src=%u Dst=%u Impl=%s",
+                       format, image_scale_filter_names[filter], src_size, dst_size, impl_name);
+          }
+        }
+      }
+    }
+  }
+}
+
+UNIT(image_scale_simd, BL_TEST_GROUP_IMAGE_UTILITIES) {
+  ImageScaleOps reference {};
+  image_scale_init_ref(reference);
+
+#if defined(BL_BUILD_OPT_SSE2)
+  if (bl_runtime_has_sse2(&bl_runtime_context)) {
+    ImageScaleOps optimized = reference;
+    image_scale_init_sse2(optimized);
+    test_image_scale_impl(reference, optimized, "SSE2");
+  }
+#endif // BL_BUILD_OPT_SSE2
+
+#if defined(BL_BUILD_OPT_AVX2)
+  if (bl_runtime_has_avx2(&bl_runtime_context)) {
+    ImageScaleOps optimized = reference;
+    image_scale_init_avx2(optimized);
+    test_image_scale_impl(reference, optimized, "AVX2");
+  }
+#endif // BL_BUILD_OPT_AVX2
+
+#if defined(BL_BUILD_OPT_ASIMD)
+  if (bl_runtime_has_asimd(&bl_runtime_context)) {
+    ImageScaleOps optimized = reference;
+    image_scale_init_asimd(optimized);
+    test_image_scale_impl(reference, optimized, "ASIMD");
+  }
+#endif // BL_BUILD_OPT_ASIMD
+}
+
+UNIT(image_scale_threads, BL_TEST_GROUP_IMAGE_UTILITIES) {
+  BLRandom rnd(0xABCDEF0123456789u);
+
+  for (uint32_t format : image_scale_formats) {
+    uint32_t bpp = bl_format_info[format].depth / 8u;
+
+    for (uint32_t filter = BL_IMAGE_SCALE_FILTER_NEAREST; filter <= BL_IMAGE_SCALE_FILTER_MAX_VALUE; filter++) {
+      BLSizeI src_size(301, 257);
+      BLSizeI dst_size(301, 611);
+
+      ImageScaleContext ctx;
+      EXPECT_SUCCESS(ctx.create(dst_size, src_size, filter));
+
+      ImageScaleTestBuffer src(uint32_t(src_size.w), uint32_t(src_size.h), bpp);
+      ImageScaleTestBuffer st(uint32_t(dst_size.w), uint32_t(dst_size.h), bpp);
+      ImageScaleTestBuffer mt(uint32_t(dst_size.w), uint32_t(dst_size.h), bpp);
+
+      src.fill_random(rnd);
+      st.fill_zero();
+      mt.fill_zero();
+
+      EXPECT_SUCCESS(ctx.process_vert_data(st.data, st.stride, src.data, src.stride, format, 1));
+      EXPECT_SUCCESS(ctx.process_vert_data(mt.data, mt.stride, src.data, src.stride, format, 4));
+
+      EXPECT_EQ(memcmp(st.data, mt.data, st.size), 0)
+        .message("Multithreaded vert mismatch: Format=%u Filter=%s", format, image_scale_filter_names[filter]);
+    }
+  }
+
+  INFO("Testing BLImage::scale() with and without threads");
+  {
+    BLImage src;
+    EXPECT_SUCCESS(src.create(1024, 256, BL_FORMAT_PRGB32));
+
+    BLImageData src_data;
+    EXPECT_SUCCESS(src.make_mutable(&src_data));
+
+    for (int y = 0; y < src_data.size.h; y++) {
+      uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(src_data.pixel_data) + intptr_t(y) * src_data.stride);
+      for (int x = 0; x < src_data.size.w; x++)
+        row[x] = 0xFF000000u | (rnd.next_uint32() & 0x00FFFFFFu);
+    }
+
+    BLImage st;
+    BLImage mt;
+    EXPECT_SUCCESS(BLImage::scale(st, src, BLSizeI(1024, 1024), BL_IMAGE_SCALE_FILTER_BICUBIC));
+    EXPECT_SUCCESS(BLImage::scale(mt, src, BLSizeI(1024, 1024), BL_IMAGE_SCALE_FILTER_BICUBIC, 8));
+    EXPECT_TRUE(st.equals(mt));
+  }
+}
+
+} // {bl::Tests}
+
+#endif // BL_TEST
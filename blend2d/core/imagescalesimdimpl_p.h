@@ -0,0 +1,348 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_IMAGESCALESIMDIMPL_P_H_INCLUDED
+#define BLEND2D_IMAGESCALESIMDIMPL_P_H_INCLUDED
+
+#include <blend2d/core/format_p.h>
+#include <blend2d/core/imagescale_p.h>
+#include <blend2d/simd/simd_p.h>
+#include <blend2d/support/intops_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+namespace bl {
+namespace {
+
+// bl::ImageScale - SimdImpl
+// =========================
+//
+// All kernels use the same 8-bit fixed-point weights as the reference implementation and produce bit-exact results:
+//
+//   - Bound weights (all weights are positive, sum is 0x100) are accumulated in 16-bit lanes, which cannot overflow
+//     as the highest possible result is `255 * 256 + 0x80`.
+//
+//   - Unbound weights (at least one weight is negative - bicubic and lanczos filters) are accumulated in 32-bit lanes
+//     by using `maddw_i16_i32()`, which multiplies two pixels by two weights at once. Weights always fit into
+//     16-bit signed integers as their sum is 0x100 and the negative lobes of supported filters are small.
+
+#if BL_SIMD_WIDTH_I >= 256
+using ImageScaleVecN = SIMD::Vec32xU8;
+#else
+using ImageScaleVecN = SIMD::Vec16xU8;
+#endif
+
+template<typename V>
+static BL_INLINE V image_scale_make_u32(uint32_t x) noexcept;
+
+template<>
+BL_INLINE SIMD::Vec16xU8 image_scale_make_u32(uint32_t x) noexcept { return SIMD::make128_u32<SIMD::Vec16xU8>(x); }
+
+#if BL_SIMD_WIDTH_I >= 256
+template<>
+BL_INLINE SIMD::Vec32xU8 image_scale_make_u32(uint32_t x) noexcept { return SIMD::make256_u32<SIMD::Vec32xU8>(x); }
+#endif // BL_SIMD_WIDTH_I >= 256
+
+// Loads either a whole vector or a single 32-bit quantity (a pixel or 4 bytes of A8 data) into V.
+template<typename V, uint32_t kN>
+static BL_INLINE V image_scale_load(const uint8_t* p) noexcept {
+  if constexpr (kN == 4u)
+    return SIMD::loadu_32<V>(p);
+  else
+    return SIMD::loadu<V>(p);
+}
+
+template<uint32_t kN, typename V>
+static BL_INLINE void image_scale_store(uint8_t* p, const V& v) noexcept {
+  if constexpr (kN == 4u)
+    SIMD::storeu_32(p, v);
+  else
+    SIMD::storeu(p, v);
+}
+
+// Packs a pair of 16-bit weights, which is then broadcasted and used by `maddw_i16_i32()`.
+static BL_INLINE uint32_t image_scale_weight_pair(int32_t w0, int32_t w1) noexcept {
+  return (uint32_t(w0) & 0xFFFFu) | (uint32_t(w1) << 16);
+}
+
+// Clamps RGB components to alpha of 2 pixels (or 4 pixels in case of 256-bit vectors) stored as 16-bit integers.
+//
+// Clamping to an unclamped alpha is fine as it's followed by packing with unsigned saturation: if the alpha is
+// negative everything becomes zero and if it's greater than 255 all components would saturate to 255 anyway.
+template<typename V>
+static BL_INLINE V image_scale_clamp_to_alpha_i16(const V& v) noexcept {
+  using namespace SIMD;
+  return min_i16(v, swizzle_hi_u16<3, 3, 3, 3>(swizzle_lo_u16<3, 3, 3, 3>(v)));
+}
+
+// bl::ImageScale - SimdImpl - Vert
+// ================================
+
+// Processes `kN` bytes of a single destination row.
+template<uint32_t kFormat, bool kUnbound, typename V, uint32_t kN>
+static BL_INLINE void image_scale_vert_chunk(uint8_t* dp, const uint8_t* sp, intptr_t src_stride, const int32_t* wp, uint32_t count) noexcept {
+  using namespace SIMD;
+
+  V zero = make_zero<V>();
+  V result;
+
+  if constexpr (!kUnbound) {
+    V acc0 = image_scale_make_u32<V>(0x00800080u);
+    V acc1 = acc0;
+
+    for (uint32_t i = count; i; i--) {
+      V p = image_scale_load<V, kN>(sp);
+      V w = image_scale_make_u32<V>(uint32_t(wp[0]) * 0x00010001u);
+
+      acc0 = add_i16(acc0, mul_i16(interleave_lo_u8(p, zero), w));
+      if constexpr (kN > 8u)
+        acc1 = add_i16(acc1, mul_i16(interleave_hi_u8(p, zero), w));
+
+      sp += src_stride;
+      wp += 1;
+    }
+
+    result = packs_128_i16_u8(srli_u16<8>(acc0), srli_u16<8>(acc1));
+  }
+  else {
+    V acc0 = image_scale_make_u32<V>(0x80u);
+    V acc1 = acc0;
+    V acc2 = acc0;
+    V acc3 = acc0;
+
+    uint32_t i = count;
+    while (i >= 2u) {
+      V p0 = image_scale_load<V, kN>(sp);
+      V p1 = image_scale_load<V, kN>(sp + src_stride);
+      V w = image_scale_make_u32<V>(image_scale_weight_pair(wp[0], wp[1]));
+
+      V t0 = interleave_lo_u8(p0, p1);
+      acc0 = add_i32(acc0, maddw_i16_i32(interleave_lo_u8(t0, zero), w));
+      if constexpr (kN > 4u)
+        acc1 = add_i32(acc1, maddw_i16_i32(interleave_hi_u8(t0, zero), w));
+
+      if constexpr (kN > 8u) {
+        V t1 = interleave_hi_u8(p0, p1);
+        acc2 = add_i32(acc2, maddw_i16_i32(interleave_lo_u8(t1, zero), w));
+        acc3 = add_i32(acc3, maddw_i16_i32(interleave_hi_u8(t1, zero), w));
+      }
+
+      sp += src_stride * 2;
+      wp += 2;
+      i -= 2u;
+    }
+
+    if (i) {
+      V p0 = image_scale_load<V, kN>(sp);
+      V w = image_scale_make_u32<V>(image_scale_weight_pair(wp[0], 0));
+
+      V t0 = interleave_lo_u8(p0, zero);
+      acc0 = add_i32(acc0, maddw_i16_i32(interleave_lo_u8(t0, zero), w));
+      if constexpr (kN > 4u)
+        acc1 = add_i32(acc1, maddw_i16_i32(interleave_hi_u8(t0, zero), w));
+
+      if constexpr (kN > 8u) {
+        V t1 = interleave_hi_u8(p0, zero);
+        acc2 = add_i32(acc2, maddw_i16_i32(interleave_lo_u8(t1, zero), w));
+        acc3 = add_i32(acc3, maddw_i16_i32(interleave_hi_u8(t1, zero), w));
+      }
+    }
+
+    V s0 = packs_128_i32_i16(srai_i32<8>(acc0), srai_i32<8>(acc1));
+    V s1 = packs_128_i32_i16(srai_i32<8>(acc2), srai_i32<8>(acc3));
+
+    if constexpr (kFormat == BL_FORMAT_PRGB32) {
+      s0 = image_scale_clamp_to_alpha_i16(s0);
+      s1 = image_scale_clamp_to_alpha_i16(s1);
+    }
+
+    result = packs_128_i16_u8(s0, s1);
+  }
+
+  if constexpr (kFormat == BL_FORMAT_XRGB32)
+    result = result | image_scale_make_u32<V>(0xFF000000u);
+
+  image_scale_store<kN>(dp, result);
+}
+
+template<uint32_t kFormat, bool kUnbound>
+static BL_INLINE void image_scale_vert_simd_impl(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept {
+  using namespace SIMD;
+
+  constexpr uint32_t kBpp = kFormat == BL_FORMAT_A8 ? 1u : 4u;
+  constexpr uint32_t kVecSize = uint32_t(ImageScaleVecN::kW);
+
+  uint32_t bytes_per_line = uint32_t(d->dst_size[0]) * kBpp;
+  uint32_t dh = uint32_t(d->dst_size[1]);
+  uint32_t kernel_size = uint32_t(d->kernel_size[ImageScaleContext::kDirVert]);
+
+  const ImageScaleContext::Record* record_list = d->record_list[ImageScaleContext::kDirVert];
+  const int32_t* weight_list = d->weight_list[ImageScaleContext::kDirVert];
+
+  for (uint32_t y = 0; y < dh; y++) {
+    const uint8_t* src_data = src_line + intptr_t(record_list->pos) * src_stride;
+    uint8_t* dp = dst_line;
+
+    uint32_t count = record_list->count;
+    uint32_t i = bytes_per_line;
+
+    BL_NOUNROLL
+    while (i >= kVecSize) {
+      image_scale_vert_chunk<kFormat, kUnbound, ImageScaleVecN, kVecSize>(dp, src_data, src_stride, weight_list, count);
+      dp += kVecSize;
+      src_data += kVecSize;
+      i -= kVecSize;
+    }
+
+#if BL_SIMD_WIDTH_I >= 256
+    if (i >= 16u) {
+      image_scale_vert_chunk<kFormat, kUnbound, Vec16xU8, 16>(dp, src_data, src_stride, weight_list, count);
+      dp += 16;
+      src_data += 16;
+      i -= 16u;
+    }
+#endif // BL_SIMD_WIDTH_I >= 256
+
+    BL_NOUNROLL
+    while (i >= 4u) {
+      image_scale_vert_chunk<kFormat, kUnbound, Vec16xU8, 4>(dp, src_data, src_stride, weight_list, count);
+      dp += 4;
+      src_data += 4;
+      i -= 4u;
+    }
+
+    if constexpr (kFormat == BL_FORMAT_A8) {
+      // Bound weights never produce values outside of [0, 255] range, so the clamp is a no-op in that case.
+      while (i) {
+        const uint8_t* sp = src_data;
+        const int32_t* wp = weight_list;
+
+        int32_t c0 = 0x80;
+        for (uint32_t j = count; j; j--) {
+          c0 += int32_t(sp[0]) * wp[0];
+          sp += src_stride;
+          wp += 1;
+        }
+
+        dp[0] = IntOps::clamp_to_byte(c0 >> 8);
+        dp += 1;
+        src_data += 1;
+        i--;
+      }
+    }
+
+    record_list += 1;
+    weight_list += kernel_size;
+
+    dst_line += dst_stride;
+  }
+}
+
+template<uint32_t kFormat>
+static void BL_CDECL image_scale_vert_simd(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept {
+  if (!d->is_unbound[ImageScaleContext::kDirVert])
+    image_scale_vert_simd_impl<kFormat, false>(d, dst_line, dst_stride, src_line, src_stride);
+  else
+    image_scale_vert_simd_impl<kFormat, true>(d, dst_line, dst_stride, src_line, src_stride);
+}
+
+// bl::ImageScale - SimdImpl - Horz
+// ================================
+
+// Horizontal pass processes one destination pixel at a time - two source pixels are interleaved so each 32-bit
+// lane of `maddw_i16_i32()` result contains a single component of both pixels multiplied by their weights.
+template<uint32_t kFormat, bool kUnbound>
+static BL_INLINE void image_scale_horz_simd_impl(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept {
+  using namespace SIMD;
+
+  uint32_t dw = uint32_t(d->dst_size[0]);
+  uint32_t sh = uint32_t(d->src_size[1]);
+  uint32_t kernel_size = uint32_t(d->kernel_size[ImageScaleContext::kDirHorz]);
+
+  Vec16xU8 zero = make_zero<Vec16xU8>();
+  Vec16xU8 bias = make128_u32<Vec16xU8>(0x80u);
+
+  for (uint32_t y = 0; y < sh; y++) {
+    const ImageScaleContext::Record* record_list = d->record_list[ImageScaleContext::kDirHorz];
+    const int32_t* weight_list = d->weight_list[ImageScaleContext::kDirHorz];
+
+    uint8_t* dp = dst_line;
+
+    for (uint32_t x = 0; x < dw; x++) {
+      const uint8_t* sp = src_line + record_list->pos * 4;
+      const int32_t* wp = weight_list;
+
+      Vec16xU8 acc = bias;
+      uint32_t i = record_list->count;
+
+      while (i >= 2u) {
+        Vec16xU8 p = interleave_lo_u8(loadu_32<Vec16xU8>(sp), loadu_32<Vec16xU8>(sp + 4));
+        Vec16xU8 w = make128_u32<Vec16xU8>(image_scale_weight_pair(wp[0], wp[1]));
+
+        acc = add_i32(acc, maddw_i16_i32(interleave_lo_u8(p, zero), w));
+
+        sp += 8;
+        wp += 2;
+        i -= 2u;
+      }
+
+      if (i) {
+        Vec16xU8 p = interleave_lo_u8(loadu_32<Vec16xU8>(sp), zero);
+        Vec16xU8 w = make128_u32<Vec16xU8>(image_scale_weight_pair(wp[0], 0));
+
+        acc = add_i32(acc, maddw_i16_i32(interleave_lo_u8(p, zero), w));
+      }
+
+      Vec16xU8 s = packs_128_i32_i16(srai_i32<8>(acc));
+      if constexpr (kUnbound && kFormat == BL_FORMAT_PRGB32)
+        s = image_scale_clamp_to_alpha_i16(s);
+      s = packs_128_i16_u8(s);
+
+      if constexpr (kFormat == BL_FORMAT_XRGB32)
+        s = s | make128_u32<Vec16xU8>(0xFF000000u);
+
+      storeu_32(dp, s);
+      dp += 4;
+
+      record_list += 1;
+      weight_list += kernel_size;
+    }
+
+    dst_line += dst_stride;
+    src_line += src_stride;
+  }
+}
+
+template<uint32_t kFormat>
+static void BL_CDECL image_scale_horz_simd(const ImageScaleContext::Data* d, uint8_t* dst_line, intptr_t dst_stride, const uint8_t* src_line, intptr_t src_stride) noexcept {
+  if (!d->is_unbound[ImageScaleContext::kDirHorz])
+    image_scale_horz_simd_impl<kFormat, false>(d, dst_line, dst_stride, src_line, src_stride);
+  else
+    image_scale_horz_simd_impl<kFormat, true>(d, dst_line, dst_stride, src_line, src_stride);
+}
+
+// bl::ImageScale - SimdImpl - Init
+// ================================
+
+// Horizontal A8 scaling is not replaced - a single byte per pixel doesn't provide enough data to fill SIMD lanes
+// when processing one destination pixel at a time, so the reference implementation is used instead.
+static BL_INLINE void image_scale_init_simd(ImageScaleOps& ops) noexcept {
+  ops.horz[BL_FORMAT_PRGB32] = image_scale_horz_simd<BL_FORMAT_PRGB32>;
+  ops.horz[BL_FORMAT_XRGB32] = image_scale_horz_simd<BL_FORMAT_XRGB32>;
+
+  ops.vert[BL_FORMAT_PRGB32] = image_scale_vert_simd<BL_FORMAT_PRGB32>;
+  ops.vert[BL_FORMAT_XRGB32] = image_scale_vert_simd<BL_FORMAT_XRGB32>;
+  ops.vert[BL_FORMAT_A8    ] = image_scale_vert_simd<BL_FORMAT_A8>;
+}
+
+} // {anonymous}
+} // {bl}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_IMAGESCALESIMDIMPL_P_H_INCLUDED
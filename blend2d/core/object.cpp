@@ -6,6 +6,7 @@
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/array_p.h>
 #include <blend2d/core/bitset_p.h>
+#include <blend2d/core/displaylist_p.h>
 #include <blend2d/core/font_p.h>
 #include <blend2d/core/fontfeaturesettings_p.h>
 #include <blend2d/core/fontmanager_p.h>
@@ -44,7 +45,7 @@ static BL_INLINE BLResult bl_object_alloc_impl_internal(BLObjectCore* self, uint
   size_t header_size = sizeof(BLObjectImplHeader) + (is_external ? sizeof(BLObjectExternalInfo) : size_t(0));
   size_t allocation_size = impl_size + header_size + impl_alignment;
 
-  void* ptr = malloc(allocation_size);
+  void* ptr = bl::Heap::alloc(BL_ALLOCATOR_CATEGORY_OBJECT, allocation_size);
   if (BL_UNLIKELY(!ptr))
     return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
 
@@ -113,6 +114,9 @@ BLResult bl_object_destroy_unknown_impl(BLObjectImpl* impl, BLObjectInfo info) n
     case BL_OBJECT_TYPE_PATH:
       return bl::PathInternal::free_impl(static_cast<BLPathPrivateImpl*>(impl));
 
+    case BL_OBJECT_TYPE_DISPLAY_LIST:
+      return bl::DisplayListInternal::free_impl(static_cast<BLDisplayListPrivateImpl*>(impl));
+
     case BL_OBJECT_TYPE_IMAGE:
       return bl::ImageInternal::free_impl(static_cast<BLImagePrivateImpl*>(impl));
 
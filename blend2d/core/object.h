@@ -251,6 +251,8 @@ BL_DEFINE_ENUM(BLObjectType) {
   BL_OBJECT_TYPE_IMAGE = 9,
   //! Object is \ref BLPath.
   BL_OBJECT_TYPE_PATH = 10,
+  //! Object is \ref BLDisplayList.
+  BL_OBJECT_TYPE_DISPLAY_LIST = 11,
 
   //! Object is \ref BLFont.
   BL_OBJECT_TYPE_FONT = 16,
@@ -561,6 +563,8 @@ struct BLObjectInfo {
   BL_INLINE_CONSTEXPR bool is_bool() const noexcept { return check_object_signature_and_raw_type(BL_OBJECT_TYPE_BOOL); }
   //! Tests whether the object info represents `BLContext`.
   BL_INLINE_CONSTEXPR bool is_context() const noexcept { return check_object_signature_and_raw_type(BL_OBJECT_TYPE_CONTEXT); }
+  //! Tests whether the object info represents `BLDisplayList`.
+  BL_INLINE_CONSTEXPR bool is_display_list() const noexcept { return check_object_signature_and_raw_type(BL_OBJECT_TYPE_DISPLAY_LIST); }
   //! Tests whether the object info represents a boxed `double` value.
   BL_INLINE_CONSTEXPR bool is_double() const noexcept { return check_object_signature_and_raw_type(BL_OBJECT_TYPE_DOUBLE); }
   //! Tests whether the object info represents `BLFont`.
@@ -864,6 +868,10 @@ union BLObjectDetail {
   [[nodiscard]]
   BL_INLINE_NODEBUG bool is_context() const noexcept { return info.is_context(); }
 
+  //! Tests whether this BLObjectDetail represents `BLDisplayList`.
+  [[nodiscard]]
+  BL_INLINE_NODEBUG bool is_display_list() const noexcept { return info.is_display_list(); }
+
   //! Tests whether this BLObjectDetail represents a boxed `double` value.
   [[nodiscard]]
   BL_INLINE_NODEBUG bool is_double() const noexcept { return info.is_double(); }
@@ -9,6 +9,7 @@
 #include <blend2d/core/api-internal_p.h>
 #include <blend2d/core/api-impl.h>
 #include <blend2d/core/object.h>
+#include <blend2d/support/heap_p.h>
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/ptrops_p.h>
 #include <blend2d/support/wrap_p.h>
@@ -257,7 +258,7 @@ static BL_INLINE BLResult alloc_impl_external_t(BLObjectCore* self, BLObjectInfo
 
 static BL_INLINE BLResult free_impl(BLObjectImpl* impl) noexcept {
   void* ptr = get_allocated_ptr(impl);
-  free(ptr);
+  Heap::free(BL_ALLOCATOR_CATEGORY_OBJECT, ptr);
   return BL_SUCCESS;
 }
 
@@ -5,6 +5,7 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/runtime_p.h>
+#include <blend2d/support/heap_p.h>
 #include <blend2d/support/intops_p.h>
 
 // PTHREAD_STACK_MIN would be defined either by <pthread.h> or <limits.h>.
@@ -274,9 +275,11 @@ BL_API_IMPL BLResult bl_runtime_init() noexcept {
   bl_fuxex_rt_init(rt);
   bl_thread_rt_init(rt);
   bl_thread_pool_rt_init(rt);
+  bl_heap_rt_init(rt);
   bl_zero_allocator_rt_init(rt);
 
   bl_compression_rt_init(rt);
+  bl_unicode_rt_init(rt);
   bl_pixel_ops_rt_init(rt);
   bl_bit_array_rt_init(rt);
   bl_bit_set_rt_init(rt);
@@ -291,6 +294,7 @@ BL_API_IMPL BLResult bl_runtime_init() noexcept {
   bl_image_scale_rt_init(rt);
   bl_pattern_rt_init(rt);
   bl_gradient_rt_init(rt);
+  bl_display_list_rt_init(rt);
   bl_font_feature_settings_rt_init(rt);
   bl_font_variation_settings_rt_init(rt);
   bl_font_data_rt_init(rt);
@@ -319,6 +323,7 @@ BL_API_IMPL BLResult bl_runtime_shutdown() noexcept {
   rt->shutdown_handlers.reset();
   rt->cleanup_handlers.reset();
   rt->resource_info_handlers.reset();
+  rt->memory_info_handlers.reset();
 
   return BL_SUCCESS;
 }
@@ -360,11 +365,74 @@ BL_API_IMPL BLResult bl_runtime_query_info(BLRuntimeInfoType info_type, void* in
       return BL_SUCCESS;
     }
 
+    case BL_RUNTIME_INFO_TYPE_MEMORY: {
+      BLRuntimeMemoryInfo* memory_info = static_cast<BLRuntimeMemoryInfo*>(info_out);
+      memory_info->reset();
+      rt->memory_info_handlers.call(rt, memory_info);
+      return BL_SUCCESS;
+    }
+
     default:
       return bl_make_error(BL_ERROR_INVALID_VALUE);
   }
 }
 
+// BLRuntime - API - Pipeline Cache
+// ================================
+
+BL_API_IMPL BLResult bl_runtime_load_pipeline_cache(const char* file_name) noexcept {
+#if !defined(BL_BUILD_NO_JIT)
+  return bl_dynamic_pipeline_rt_load_cache(file_name);
+#else
+  bl_unused(file_name);
+  return bl_make_error(BL_ERROR_NOT_IMPLEMENTED);
+#endif
+}
+
+BL_API_IMPL BLResult bl_runtime_save_pipeline_cache(const char* file_name) noexcept {
+#if !defined(BL_BUILD_NO_JIT)
+  return bl_dynamic_pipeline_rt_save_cache(file_name);
+#else
+  bl_unused(file_name);
+  return bl_make_error(BL_ERROR_NOT_IMPLEMENTED);
+#endif
+}
+
+// BLRuntime - API - Shape Cache
+// =============================
+
+BL_API_IMPL BLResult bl_runtime_set_shape_cache_limit(size_t count_limit) noexcept {
+  bl_font_rt_set_shape_cache_limit(count_limit);
+  return BL_SUCCESS;
+}
+
+// BLRuntime - API - Image Pool
+// ============================
+
+BL_API_IMPL BLResult bl_runtime_set_image_pool_limit(size_t size_limit, BLImagePoolFlags flags) noexcept {
+  bl_image_rt_set_pool_limit(size_limit, uint32_t(flags));
+  return BL_SUCCESS;
+}
+
+// BLRuntime - API - Gradient LUT Cache
+// ====================================
+
+BL_API_IMPL BLResult bl_runtime_set_gradient_lut_cache_limit(size_t size_limit) noexcept {
+  bl_gradient_rt_set_lut_cache_limit(size_limit);
+  return BL_SUCCESS;
+}
+
+// BLRuntime - API - Allocator
+// ===========================
+
+BL_API_IMPL BLResult bl_runtime_set_allocator(const BLAllocator* allocator) noexcept {
+  return bl::Heap::set_allocator(allocator);
+}
+
+BL_API_IMPL BLResult bl_runtime_get_allocator(BLAllocator* allocator_out) noexcept {
+  return bl::Heap::get_allocator(allocator_out);
+}
+
 // BLRuntime - API - Message
 // =========================
 
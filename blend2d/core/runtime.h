@@ -33,9 +33,11 @@ BL_DEFINE_ENUM(BLRuntimeInfoType) {
   BL_RUNTIME_INFO_TYPE_SYSTEM = 1,
   //! Resources information (includes Blend2D memory consumption)
   BL_RUNTIME_INFO_TYPE_RESOURCE = 2,
+  //! Memory information (includes memory used by allocators, pools, and caches), see \ref BLRuntimeMemoryInfo.
+  BL_RUNTIME_INFO_TYPE_MEMORY = 3,
 
   //! Count of runtime information types.
-  BL_RUNTIME_INFO_TYPE_MAX_VALUE = 2
+  BL_RUNTIME_INFO_TYPE_MAX_VALUE = 3
 
   BL_FORCE_ENUM_UINT32(BL_RUNTIME_INFO_TYPE)
 };
@@ -92,6 +94,14 @@ BL_DEFINE_ENUM(BLRuntimeCleanupFlags) {
   BL_RUNTIME_CLEANUP_ZEROED_POOL = 0x00000002u,
   //! Cleanup thread pool (would join unused threads).
   BL_RUNTIME_CLEANUP_THREAD_POOL = 0x00000010u,
+  //! Cleanup glyph mask cache used by rendering contexts.
+  BL_RUNTIME_CLEANUP_GLYPH_CACHE = 0x00000020u,
+  //! Cleanup shaping result cache used by \ref BLFont::shape().
+  BL_RUNTIME_CLEANUP_SHAPE_CACHE = 0x00000040u,
+  //! Cleanup pixel buffers kept by the image buffer pool.
+  BL_RUNTIME_CLEANUP_IMAGE_POOL = 0x00000080u,
+  //! Cleanup gradient lookup tables kept by the gradient LUT cache.
+  BL_RUNTIME_CLEANUP_GRADIENT_CACHE = 0x00000100u,
 
   //! Cleanup everything.
   BL_RUNTIME_CLEANUP_EVERYTHING = 0xFFFFFFFFu
@@ -99,11 +109,67 @@ BL_DEFINE_ENUM(BLRuntimeCleanupFlags) {
   BL_FORCE_ENUM_UINT32(BL_RUNTIME_CLEANUP_FLAG)
 };
 
+//! Image buffer pool flags that can be used through \ref bl_runtime_set_image_pool_limit().
+BL_DEFINE_ENUM(BLImagePoolFlags) {
+  //! No flags.
+  BL_IMAGE_POOL_NO_FLAGS = 0u,
+  //! Back pixel buffers of large images (2MiB and more) by huge pages if supported by the operating system.
+  //!
+  //! On Linux explicit huge pages (`MAP_HUGETLB`) are used if the system has a reserved huge page pool, otherwise
+  //! the buffers are aligned to a huge page boundary and marked as eligible for transparent huge pages.
+  BL_IMAGE_POOL_FLAG_HUGE_PAGES = 0x00000001u
+
+  BL_FORCE_ENUM_UINT32(BL_IMAGE_POOL_FLAG)
+};
+
+//! Category of memory allocated through \ref BLAllocator.
+BL_DEFINE_ENUM(BLAllocatorCategory) {
+  //! Memory used by Impls of Blend2D objects (including pixel data of images and data of containers).
+  BL_ALLOCATOR_CATEGORY_OBJECT = 0,
+  //! Memory used by blocks of arena allocators (temporary data of rendering contexts, caches, etc...).
+  BL_ALLOCATOR_CATEGORY_ARENA = 1,
+  //! Memory used by blocks of the zeroed memory pool (analytic rasterizer cells, etc...).
+  BL_ALLOCATOR_CATEGORY_ZEROED = 2,
+
+  //! Maximum value of `BLAllocatorCategory`.
+  BL_ALLOCATOR_CATEGORY_MAX_VALUE = 2
+
+  BL_FORCE_ENUM_UINT32(BL_ALLOCATOR_CATEGORY)
+};
+
 //! \}
 
 //! \name Runtime - Structs
 //! \{
 
+//! A function that allocates `size` bytes aligned to `alignment`, see \ref BLAllocator.
+typedef void* (BL_CDECL* BLAllocatorAllocFunc)(void* user_data, size_t size, size_t alignment, BLAllocatorCategory category) BL_NOEXCEPT_C;
+//! A function that reallocates `ptr` of `old_size` to `new_size` bytes aligned to `alignment`, see \ref BLAllocator.
+typedef void* (BL_CDECL* BLAllocatorReallocFunc)(void* user_data, void* ptr, size_t old_size, size_t new_size, size_t alignment, BLAllocatorCategory category) BL_NOEXCEPT_C;
+//! A function that releases `ptr` of `size` bytes allocated by \ref BLAllocatorAllocFunc, see \ref BLAllocator.
+typedef void (BL_CDECL* BLAllocatorFreeFunc)(void* user_data, void* ptr, size_t size, size_t alignment, BLAllocatorCategory category) BL_NOEXCEPT_C;
+
+//! Allocator that can be installed by \ref bl_runtime_set_allocator() to allocate memory of Blend2D objects, arenas,
+//! and the zeroed memory pool.
+//!
+//! Blend2D always passes the size and alignment of the original allocation to `realloc` and `free`, so sized
+//! deallocation functions (such as jemalloc's `sdallocx()`) can be used directly. The alignment is always a power
+//! of two that is at least `sizeof(void*)`.
+struct BLAllocator {
+  //! Allocation function (required).
+  BLAllocatorAllocFunc alloc_func;
+  //! Reallocation function (optional, Blend2D would allocate, copy, and free if not provided).
+  BLAllocatorReallocFunc realloc_func;
+  //! Deallocation function (required).
+  BLAllocatorFreeFunc free_func;
+  //! User data passed to all functions.
+  void* user_data;
+
+#ifdef __cplusplus
+  BL_INLINE_NODEBUG void reset() noexcept { *this = BLAllocator{}; }
+#endif
+};
+
 //! Blend2D build information.
 struct BLRuntimeBuildInfo {
   //! Major version number.
@@ -199,15 +265,76 @@ struct BLRuntimeResourceInfo {
 
   //! Count of dynamic pipelines created and cached.
   size_t dynamic_pipeline_count;
+  //! Count of dynamic pipelines compiled ahead of time by \ref bl_runtime_load_pipeline_cache() (also included
+  //! in `dynamic_pipeline_count`).
+  size_t dynamic_pipeline_preloaded_count;
+
+  //! Count of glyph masks cached by rendering contexts.
+  size_t glyph_mask_count;
+  //! Size of all glyph masks cached by rendering contexts (in bytes).
+  size_t glyph_mask_size;
+
+  //! Count of shaping results cached by \ref BLFont::shape().
+  size_t shape_cache_count;
+  //! Count of shaping requests served by the shaping result cache.
+  size_t shape_cache_hit_count;
+  //! Count of shaping requests that were not found in the shaping result cache.
+  size_t shape_cache_miss_count;
 
   //! Reserved for future use.
-  size_t reserved[7];
+  size_t reserved[1];
 
 #ifdef __cplusplus
   BL_INLINE_NODEBUG void reset() noexcept { *this = BLRuntimeResourceInfo{}; }
 #endif
 };
 
+#ifdef __cplusplus
+static_assert(sizeof(BLRuntimeResourceInfo) == 16 * sizeof(size_t), "'BLRuntimeResourceInfo' struct must be exactly 16 words long");
+#endif
+
+//! Provides information about memory used by Blend2D allocators, pools, and caches.
+//!
+//! \note The size of \ref BLRuntimeResourceInfo is part of the ABI, so new counters are provided by this struct,
+//! which is queried separately through \ref BL_RUNTIME_INFO_TYPE_MEMORY.
+struct BLRuntimeMemoryInfo {
+  //! Memory allocated for Impls of Blend2D objects (in bytes), see \ref BL_ALLOCATOR_CATEGORY_OBJECT.
+  size_t object_heap_used;
+  //! Memory allocated for blocks of arena allocators (in bytes), see \ref BL_ALLOCATOR_CATEGORY_ARENA.
+  size_t arena_heap_used;
+  //! Memory allocated for blocks of the zeroed memory pool (in bytes), see \ref BL_ALLOCATOR_CATEGORY_ZEROED.
+  size_t zeroed_heap_used;
+
+  //! Count of idle pixel buffers kept by the image buffer pool.
+  size_t image_pool_count;
+  //! Size of idle pixel buffers kept by the image buffer pool (in bytes).
+  size_t image_pool_size;
+  //! Count of images that reused a pixel buffer kept by the image buffer pool.
+  size_t image_pool_hit_count;
+  //! Count of images that had to allocate a new pixel buffer while the image buffer pool was enabled.
+  size_t image_pool_miss_count;
+
+  //! Count of gradient lookup tables kept by the gradient LUT cache.
+  size_t gradient_lut_cache_count;
+  //! Size of gradient lookup tables kept by the gradient LUT cache (in bytes).
+  size_t gradient_lut_cache_size;
+  //! Count of gradient lookup tables shared through the gradient LUT cache instead of being interpolated.
+  size_t gradient_lut_cache_hit_count;
+  //! Count of gradient lookup tables that were not found in the gradient LUT cache.
+  size_t gradient_lut_cache_miss_count;
+
+  //! Reserved for future use.
+  size_t reserved[5];
+
+#ifdef __cplusplus
+  BL_INLINE_NODEBUG void reset() noexcept { *this = BLRuntimeMemoryInfo{}; }
+#endif
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(BLRuntimeMemoryInfo) == 16 * sizeof(size_t), "'BLRuntimeMemoryInfo' struct must be exactly 16 words long");
+#endif
+
 //! \}
 //! \}
 
@@ -230,6 +357,62 @@ BL_API BLResult BL_CDECL bl_runtime_message_out(const char* msg) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_runtime_message_fmt(const char* fmt, ...) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL bl_runtime_message_vfmt(const char* fmt, va_list ap) BL_NOEXCEPT_C;
 
+//! Compiles dynamic pipelines stored in a pipeline cache file `file_name` ahead of time.
+//!
+//! Pipeline cache files are written by \ref bl_runtime_save_pipeline_cache() and only store signatures of pipelines,
+//! so pipelines are compiled again, however, it's done before any rendering context needs them, so short-lived
+//! processes can load the cache at startup instead of compiling pipelines during rendering of the first frame.
+//!
+//! Returns \ref BL_ERROR_INVALID_SIGNATURE if the file was written by a different version of Blend2D and
+//! \ref BL_ERROR_NOT_IMPLEMENTED if Blend2D was built without JIT support.
+BL_API BLResult BL_CDECL bl_runtime_load_pipeline_cache(const char* file_name) BL_NOEXCEPT_C;
+
+//! Writes signatures of all dynamic pipelines compiled so far to a pipeline cache file `file_name`.
+//!
+//! \note Pipelines compiled by isolated JIT runtimes (see \ref BL_CONTEXT_CREATE_FLAG_ISOLATED_JIT_RUNTIME) are
+//! not stored.
+BL_API BLResult BL_CDECL bl_runtime_save_pipeline_cache(const char* file_name) BL_NOEXCEPT_C;
+
+//! Sets the maximum number of shaping results cached by \ref bl_font_shape().
+//!
+//! The cache is keyed by font face, feature settings, variation settings, and text, so repeatedly shaped short
+//! strings (labels, numbers, units) are copied from the cache instead of running GSUB and GPOS lookups again.
+//! The cache is disabled by default, zero `count_limit` disables it and releases all cached results.
+BL_API BLResult BL_CDECL bl_runtime_set_shape_cache_limit(size_t count_limit) BL_NOEXCEPT_C;
+
+//! Sets the maximum size of idle pixel buffers kept by the image buffer pool and pool `flags`.
+//!
+//! Pixel buffers of images created by \ref bl_image_create() that are at least 64KiB are taken from the pool and
+//! returned to it when the image is destroyed, so creating and destroying images of the same size doesn't allocate
+//! and page fault the same memory again. The pool is disabled by default, zero `size_limit` disables it and releases
+//! all idle buffers. See \ref BLImagePoolFlags for available flags.
+BL_API BLResult BL_CDECL bl_runtime_set_image_pool_limit(size_t size_limit, BLImagePoolFlags flags) BL_NOEXCEPT_C;
+
+//! Sets the maximum size of gradient lookup tables kept by the gradient LUT cache (in bytes).
+//!
+//! Lookup tables are keyed by gradient stops, lookup table size, and pixel format, so gradients that have the same
+//! stops share a single lookup table instead of interpolating their own. The cache is enabled by default with a limit
+//! of 1MiB, zero `size_limit` disables it and releases all cached lookup tables (lookup tables still used by gradients
+//! stay valid).
+BL_API BLResult BL_CDECL bl_runtime_set_gradient_lut_cache_limit(size_t size_limit) BL_NOEXCEPT_C;
+
+//! Installs `allocator` to allocate memory of Blend2D objects, arenas, and the zeroed memory pool.
+//!
+//! Passing a null `allocator` restores the default allocator, which uses C library `malloc()` and `free()`. Memory
+//! is always released by the allocator that allocated it, so objects created before the allocator was changed stay
+//! valid. Allocators remain referenced until the process ends, only a limited number of distinct allocators (having
+//! different functions or user data) can be installed during the lifetime of the process.
+//!
+//! Returns \ref BL_ERROR_INVALID_VALUE if `alloc_func` or `free_func` are not provided, and
+//! \ref BL_ERROR_OUT_OF_MEMORY if the maximum number of distinct allocators was reached.
+//!
+//! \note Installing an allocator is thread-safe, however, allocations done concurrently by other threads may still
+//! use the previous allocator.
+BL_API BLResult BL_CDECL bl_runtime_set_allocator(const BLAllocator* allocator) BL_NOEXCEPT_C;
+
+//! Retrieves the allocator installed by \ref bl_runtime_set_allocator() or the default allocator.
+BL_API BLResult BL_CDECL bl_runtime_get_allocator(BLAllocator* allocator_out) BL_NOEXCEPT_C;
+
 #ifdef _WIN32
 BL_API BLResult BL_CDECL bl_result_from_win_error(uint32_t e) BL_NOEXCEPT_C;
 #else
@@ -292,6 +475,38 @@ static BL_INLINE_NODEBUG BLResult query_resource_info(BLRuntimeResourceInfo* out
   return bl_runtime_query_info(BL_RUNTIME_INFO_TYPE_RESOURCE, out);
 }
 
+static BL_INLINE_NODEBUG BLResult query_memory_info(BLRuntimeMemoryInfo* out) noexcept {
+  return bl_runtime_query_info(BL_RUNTIME_INFO_TYPE_MEMORY, out);
+}
+
+static BL_INLINE_NODEBUG BLResult load_pipeline_cache(const char* file_name) noexcept {
+  return bl_runtime_load_pipeline_cache(file_name);
+}
+
+static BL_INLINE_NODEBUG BLResult save_pipeline_cache(const char* file_name) noexcept {
+  return bl_runtime_save_pipeline_cache(file_name);
+}
+
+static BL_INLINE_NODEBUG BLResult set_shape_cache_limit(size_t count_limit) noexcept {
+  return bl_runtime_set_shape_cache_limit(count_limit);
+}
+
+static BL_INLINE_NODEBUG BLResult set_image_pool_limit(size_t size_limit, BLImagePoolFlags flags = BL_IMAGE_POOL_NO_FLAGS) noexcept {
+  return bl_runtime_set_image_pool_limit(size_limit, flags);
+}
+
+static BL_INLINE_NODEBUG BLResult set_gradient_lut_cache_limit(size_t size_limit) noexcept {
+  return bl_runtime_set_gradient_lut_cache_limit(size_limit);
+}
+
+static BL_INLINE_NODEBUG BLResult set_allocator(const BLAllocator* allocator) noexcept {
+  return bl_runtime_set_allocator(allocator);
+}
+
+static BL_INLINE_NODEBUG BLResult get_allocator(BLAllocator* allocator_out) noexcept {
+  return bl_runtime_get_allocator(allocator_out);
+}
+
 static BL_INLINE_NODEBUG BLResult message(const char* msg) noexcept {
   return bl_runtime_message_out(msg);
 }
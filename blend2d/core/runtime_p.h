@@ -80,8 +80,10 @@ struct BLRuntimeContext {
   typedef void (BL_CDECL* ShutdownFunc)(BLRuntimeContext* rt) noexcept;
   //! Cleanup handler.
   typedef void (BL_CDECL* CleanupFunc)(BLRuntimeContext* rt, BLRuntimeCleanupFlags cleanup_flags) noexcept;
-  //! MemoryInfo handler.
+  //! ResourceInfo handler.
   typedef void (BL_CDECL* ResourceInfoFunc)(BLRuntimeContext* rt, BLRuntimeResourceInfo* resource_info) noexcept;
+  //! MemoryInfo handler.
+  typedef void (BL_CDECL* MemoryInfoFunc)(BLRuntimeContext* rt, BLRuntimeMemoryInfo* memory_info) noexcept;
 
   //! Counts how many times `bl_runtime_init()` has been called.
   //!
@@ -106,11 +108,13 @@ struct BLRuntimeContext {
   // handlers and let them register cleanup/shutdown handlers when needed.
 
   //! Shutdown handlers (always traversed from last to first).
-  BLRuntimeHandlers<ShutdownFunc, 8> shutdown_handlers;
+  BLRuntimeHandlers<ShutdownFunc, 16> shutdown_handlers;
   //! Cleanup handlers (always executed from first to last).
-  BLRuntimeHandlers<CleanupFunc, 8> cleanup_handlers;
+  BLRuntimeHandlers<CleanupFunc, 16> cleanup_handlers;
+  //! ResourceInfo handlers (always traversed from first to last).
+  BLRuntimeHandlers<ResourceInfoFunc, 16> resource_info_handlers;
   //! MemoryInfo handlers (always traversed from first to last).
-  BLRuntimeHandlers<ResourceInfoFunc, 8> resource_info_handlers;
+  BLRuntimeHandlers<MemoryInfoFunc, 16> memory_info_handlers;
 };
 
 //! Instance of a global runtime context.
@@ -201,9 +205,11 @@ BL_HIDDEN void bl_runtime_failure(const char* fmt, ...) noexcept;
 BL_HIDDEN void bl_fuxex_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_thread_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_thread_pool_rt_init(BLRuntimeContext* rt) noexcept;
+BL_HIDDEN void bl_heap_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_zero_allocator_rt_init(BLRuntimeContext* rt) noexcept;
 
 BL_HIDDEN void bl_compression_rt_init(BLRuntimeContext* rt) noexcept;
+BL_HIDDEN void bl_unicode_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_pixel_ops_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_bit_array_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_bit_set_rt_init(BLRuntimeContext* rt) noexcept;
@@ -212,24 +218,30 @@ BL_HIDDEN void bl_string_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_transform_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_path_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_image_rt_init(BLRuntimeContext* rt) noexcept;
+BL_HIDDEN void bl_image_rt_set_pool_limit(size_t size_limit, uint32_t flags) noexcept;
 BL_HIDDEN void bl_image_codec_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_image_decoder_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_image_encoder_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_image_scale_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_pattern_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_gradient_rt_init(BLRuntimeContext* rt) noexcept;
+BL_HIDDEN void bl_gradient_rt_set_lut_cache_limit(size_t size_limit) noexcept;
+BL_HIDDEN void bl_display_list_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_font_feature_settings_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_font_variation_settings_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_font_data_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_font_face_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_open_type_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_font_rt_init(BLRuntimeContext* rt) noexcept;
+BL_HIDDEN void bl_font_rt_set_shape_cache_limit(size_t count_limit) noexcept;
 BL_HIDDEN void bl_font_manager_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_context_rt_init(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void bl_static_pipeline_rt_init(BLRuntimeContext* rt) noexcept;
 
 #if !defined(BL_BUILD_NO_JIT)
 BL_HIDDEN void bl_dynamic_pipeline_rt_init(BLRuntimeContext* rt) noexcept;
+BL_HIDDEN BLResult bl_dynamic_pipeline_rt_load_cache(const char* file_name) noexcept;
+BL_HIDDEN BLResult bl_dynamic_pipeline_rt_save_cache(const char* file_name) noexcept;
 #endif
 
 BL_HIDDEN void bl_register_built_in_codecs(BLRuntimeContext* rt) noexcept;
@@ -8,6 +8,7 @@
 #include <blend2d/core/array_p.h>
 #include <blend2d/core/bitarray_p.h>
 #include <blend2d/core/bitset_p.h>
+#include <blend2d/core/displaylist_p.h>
 #include <blend2d/core/font_p.h>
 #include <blend2d/core/fontfeaturesettings_p.h>
 #include <blend2d/core/fontvariationsettings_p.h>
@@ -657,6 +658,9 @@ BL_API_IMPL bool bl_var_equals(const BLUnknown* a, const BLUnknown* b) noexcept
     case BL_OBJECT_TYPE_PATH:
       return bl_path_equals(static_cast<const BLPathCore*>(a), static_cast<const BLPathCore*>(b));
 
+    case BL_OBJECT_TYPE_DISPLAY_LIST:
+      return bl_display_list_equals(static_cast<const BLDisplayListCore*>(a), static_cast<const BLDisplayListCore*>(b));
+
     case BL_OBJECT_TYPE_FONT:
       return bl_font_equals(static_cast<const BLFontCore*>(a), static_cast<const BLFontCore*>(b));
 
@@ -425,9 +425,7 @@ static constexpr uint32_t kCFFCallStackSize = 16;
 static constexpr uint32_t kCFFStorageSize = 32;
 
 static constexpr uint32_t kCFFValueStackSizeV1 = 48;
-
-// TODO: [OpenType] Required by CFF2.
-// static constexpr uint32_t kCFFValueStackSizeV2 = 513;
+static constexpr uint32_t kCFFValueStackSizeV2 = 513;
 
 // We use `double` precision in our implementation, so this constant is used to convert a fixed-point.
 static constexpr double kCFFDoubleFromF16x16 = (1.0 / 65536.0);
@@ -793,6 +791,7 @@ static BLResult get_glyph_outlines_t(
   const BLFontFaceImpl* face_impl,
   BLGlyphId glyph_id,
   const BLMatrix2D* transform,
+  const FontVariationCoords* coords,
   Consumer& consumer,
   ScopedBuffer* tmp_buffer) noexcept {
 
@@ -812,7 +811,7 @@ static BLResult get_glyph_outlines_t(
   const uint8_t* ip_end = nullptr;             // End of the instruction array.
 
   ExecutionState c_buf[kCFFCallStackSize + 1]; // Call stack.
-  double v_buf[kCFFValueStackSizeV1 + 1];      // Value stack.
+  double v_buf[kCFFValueStackSizeV2 + 1];      // Value stack (CFF2 stack is used by both versions).
 
   uint32_t c_idx = 0;                          // Call stack index.
   uint32_t v_idx = 0;                          // Value stack index.
@@ -834,7 +833,15 @@ static BLResult get_glyph_outlines_t(
 
   // Execution features describe either CFFv1 or CFFv2 environment. It contains minimum operand count for each
   // opcode (or operator) and some other data.
-  const ExecutionFeaturesInfo* execution_features = &execution_features_info[0];
+  const ExecutionFeaturesInfo* execution_features = &execution_features_info[cff_info.version];
+  const uint32_t v_limit = cff_info.version == CFFData::kVersion1 ? kCFFValueStackSizeV1 : kCFFValueStackSizeV2;
+
+  // CFF2 variations - region scalars of the ItemVariationData selected by 'vsindex' are only calculated when the
+  // first 'blend' operator is executed. When `coords` is null (default instance) all scalars are zero.
+  double region_scalars[kCFFValueStackSizeV2];
+  uint32_t region_count = 0;
+  uint32_t vs_index = 0;
+  bool region_scalars_valid = false;
 
   // This is used to perform a function (subroutine) call. Initially we set it to the charstring referenced by the
   // `glyph_id`. Later, when we process a function call opcode it would be changed to either GSubR or LSubR index.
@@ -949,7 +956,7 @@ OnSubRCall:
     b0 = *ip++;
 
     if (b0 >= 32) {
-      if (BL_UNLIKELY(++v_idx > kCFFValueStackSizeV1)) {
+      if (BL_UNLIKELY(++v_idx > v_limit)) {
         goto InvalidData;
       }
       else {
@@ -969,7 +976,7 @@ OnSubRCall:
             if (b0 < 32)
               goto OnOperator;
 
-            if (BL_UNLIKELY(++v_idx > kCFFValueStackSizeV1))
+            if (BL_UNLIKELY(++v_idx > v_limit))
               goto InvalidData;
 
             if (b0 <= 246) {
@@ -1039,7 +1046,7 @@ OnOperator:
 
         case kCSOpPushI16: {
           ip += 2;
-          if (BL_UNLIKELY(ip > ip_end || ++v_idx > kCFFValueStackSizeV1))
+          if (BL_UNLIKELY(ip > ip_end || ++v_idx > v_limit))
             goto InvalidData;
 
           int v = MemOps::readI16uBE(ip - 2);
@@ -1388,15 +1395,47 @@ OnVHCurveTo:
 
         // |- ivs vsindex (15) |-
         case kCSOpVSIndex: {
-          // TODO: [OpenType] CFF VARIATIONS
+          BL_ASSERT(v_min_operands >= 1);
+          double ivs = v_buf[v_idx - 1];
+          if (BL_UNLIKELY(!(ivs >= 0.0 && ivs <= 65535.0)))
+            goto InvalidData;
+
+          vs_index = uint32_t(ivs);
+          region_scalars_valid = false;
+
           v_idx = 0;
           continue;
         }
 
         // in(0)...in(N-1), d(0,0)...d(K-1,0), d(0,1)...d(K-1,1) ... d(0,N-1)...d(K-1,N-1) N blend (16) out(0)...(N-1)
         case kCSOpBlend: {
-          // TODO: [OpenType] CFF VARIATIONS
-          v_idx = 0;
+          BL_ASSERT(v_min_operands >= 1);
+          double n_value = v_buf[--v_idx];
+          if (BL_UNLIKELY(!(n_value >= 0.0 && n_value <= double(v_idx))))
+            goto InvalidData;
+
+          if (!region_scalars_valid) {
+            region_count = VarImpl::calc_region_scalars(ot_face_impl->var.cff2_var_store, vs_index, coords, region_scalars, kCFFValueStackSizeV2);
+            region_scalars_valid = true;
+          }
+
+          uint32_t n = uint32_t(n_value);
+          uint32_t k = region_count;
+
+          if (BL_UNLIKELY(size_t(n) * (k + 1u) > v_idx))
+            goto InvalidData;
+
+          uint32_t base = v_idx - n * (k + 1u);
+          const double* deltas = v_buf + base + n;
+
+          for (uint32_t i = 0; i < n; i++, deltas += k) {
+            double v = v_buf[base + i];
+            for (uint32_t j = 0; j < k; j++)
+              v += deltas[j] * region_scalars[j];
+            v_buf[base + i] = v;
+          }
+
+          v_idx = base + n;
           continue;
         }
 
@@ -1701,7 +1740,7 @@ OnReturn:
 
             // random (12 23) out
             case kCSOpRandom & 0xFFu: {
-              if (BL_UNLIKELY(++v_idx > kCFFValueStackSizeV1))
+              if (BL_UNLIKELY(++v_idx > v_limit))
                 goto InvalidData;
 
               // NOTE: Don't allow anything random.
@@ -1712,7 +1751,7 @@ OnReturn:
             // in dup (12 27) out out
             case kCSOpDup & 0xFFu: {
               BL_ASSERT(v_min_operands >= 1);
-              if (BL_UNLIKELY(++v_idx > kCFFValueStackSizeV1))
+              if (BL_UNLIKELY(++v_idx > v_limit))
                 goto InvalidData;
               v_buf[v_idx - 1] = v_buf[v_idx - 2];
               continue;
@@ -1960,7 +1999,7 @@ static BLResult BL_CDECL get_glyph_bounds(
     BLGlyphId glyph_id = glyph_data[0];
     glyph_data = PtrOps::offset(glyph_data, glyph_advance);
 
-    BLResult local_result = get_glyph_outlines_t<GlyphBoundsConsumer>(face_impl, glyph_id, &transform, consumer, &tmp_buffer);
+    BLResult local_result = get_glyph_outlines_t<GlyphBoundsConsumer>(face_impl, glyph_id, &transform, nullptr, consumer, &tmp_buffer);
     if (local_result) {
       boxes[i].reset();
       result = local_result;
@@ -2045,7 +2084,22 @@ static BLResult BL_CDECL get_glyph_outlines(
   ScopedBuffer* tmp_buffer) noexcept {
 
   GlyphOutlineConsumer consumer(out);
-  BLResult result = get_glyph_outlines_t<GlyphOutlineConsumer>(face_impl, glyph_id, transform, consumer, tmp_buffer);
+  BLResult result = get_glyph_outlines_t<GlyphOutlineConsumer>(face_impl, glyph_id, transform, nullptr, consumer, tmp_buffer);
+
+  *contour_count_out = consumer.contour_count;
+  return result;
+}
+
+BLResult BL_CDECL get_glyph_outlines_var(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords* coords,
+  BLPath* out,
+  size_t* contour_count_out,
+  ScopedBuffer* tmp_buffer) noexcept {
+
+  GlyphOutlineConsumer consumer(out);
+  BLResult result = get_glyph_outlines_t<GlyphOutlineConsumer>(ot_face_impl, glyph_id, &TransformInternal::identity_transform, coords, consumer, tmp_buffer);
 
   *contour_count_out = consumer.contour_count;
   return result;
@@ -2097,6 +2151,7 @@ BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables, uint32_t cff_versi
   uint32_t private_offset = 0;
   uint32_t private_length = 0;
   uint32_t lsubr_offset = 0;
+  uint32_t vstore_offset = 0;
 
   CIDInfo cid {};
   BLArray<CFFData::IndexData> fd_subr_indexes;
@@ -2229,6 +2284,12 @@ BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables, uint32_t cff_versi
         }
         break;
       }
+
+      case CFFTable::kDictOpTopVStore: {
+        if (cff_version == CFFData::kVersion2 && dict_entry.count == 1)
+          vstore_offset = uint32_t(dict_entry.values[0]);
+        break;
+      }
     }
   }
 
@@ -2406,10 +2467,24 @@ BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables, uint32_t cff_versi
     }
   }
 
+  // CFF2 VariationStore
+  // -------------------
+
+  // VariationStore starts with its length followed by ItemVariationStore used by 'blend' operator. It's only used by
+  // variable fonts, thus invalid data only disables variations.
+  if (vstore_offset) {
+    if (vstore_offset >= begin_data_offset && vstore_offset <= cff.size - 2u) {
+      uint32_t vstore_size = MemOps::readU16uBE(cff.data + vstore_offset);
+      if (vstore_size <= cff.size - vstore_offset - 2u)
+        ot_face_impl->var.cff2_var_store.reset(cff.data + vstore_offset + 2u, vstore_size);
+    }
+  }
+
   // Done
   // ----
 
   ot_face_impl->cff.table = cff;
+  ot_face_impl->cff.version = uint8_t(cff_version);
 
   ot_face_impl->cff.index[CFFData::kIndexGSubR].reset(
     DataRange { gsubr_offset, gsubr_index.total_size },
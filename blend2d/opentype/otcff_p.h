@@ -7,6 +7,7 @@
 #define BLEND2D_OPENTYPE_OTCFF_P_H_INCLUDED
 
 #include <blend2d/core/font_p.h>
+#include <blend2d/core/fontface_p.h>
 #include <blend2d/opentype/otdefs_p.h>
 #include <blend2d/support/ptrops_p.h>
 
@@ -96,6 +97,9 @@ struct CFFTable {
     kDictOpTopFDSelect           = 0x0C25,
     kDictOpTopFontName           = 0x0C26,
 
+    // CFF2 Operator Extensions:
+    kDictOpTopVStore             = 0x0018,
+
     // Private Dict Operator Entries.
     kDictOpPrivBlueValues        = 0x0006,
     kDictOpPrivOtherBlues        = 0x0007,
@@ -216,7 +220,9 @@ struct CFFData {
   uint32_t fd_select_offset;
   //! Format of FDSelect data (0 or 3).
   uint8_t fd_select_format;
-  uint8_t reserved[3];
+  //! CFF version, see \ref Version.
+  uint8_t version;
+  uint8_t reserved[2];
 };
 
 namespace CFFImpl {
@@ -271,6 +277,15 @@ public:
   BLResult next(DictEntry& entry) noexcept;
 };
 
+//! Decodes unscaled outlines of `glyph_id` with deltas of 'blend' operators interpolated at `coords` (CFF2 only).
+BL_HIDDEN BLResult BL_CDECL get_glyph_outlines_var(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords* coords,
+  BLPath* out,
+  size_t* contour_count_out,
+  ScopedBuffer* tmp_buffer) noexcept;
+
 BL_HIDDEN BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables, uint32_t cff_version) noexcept;
 
 } // {CFFImpl}
@@ -13,6 +13,43 @@
 #include <blend2d/unicode/unicode_p.h>
 
 namespace bl::OpenType {
+
+// bl::OpenType::CMapCache - Implementation
+// ========================================
+
+const uint16_t* CMapCache::build_page(const BLFontFaceImpl* face_impl, uint32_t index) noexcept {
+  uint32_t content[kPageSize];
+  uint32_t first = index << kPageShift;
+
+  for (uint32_t i = 0; i < kPageSize; i++)
+    content[i] = first + i;
+
+  BLGlyphMappingState state;
+  uncached_func(face_impl, content, kPageSize, &state);
+
+  uint16_t* page = static_cast<uint16_t*>(malloc(kPageSize * sizeof(uint16_t)));
+  if (BL_UNLIKELY(!page))
+    return nullptr;
+
+  for (uint32_t i = 0; i < kPageSize; i++)
+    page[i] = uint16_t(content[i]);
+
+  uint16_t* existing = nullptr;
+  if (!bl_atomic_compare_exchange(&_pages[index], &existing, page)) {
+    free(page);
+    return existing;
+  }
+
+  return page;
+}
+
+void CMapCache::reset() noexcept {
+  for (uint32_t i = 0; i < kPageCount; i++) {
+    free(_pages[i]);
+    _pages[i] = nullptr;
+  }
+}
+
 namespace CMapImpl {
 
 // bl::OpenType::CMapImpl - None
@@ -324,6 +361,107 @@ Done:
   return BL_SUCCESS;
 }
 
+// bl::OpenType::CMapImpl - Cached
+// ===============================
+
+static BL_NOINLINE BLGlyphId map_code_point_uncached(const BLFontFaceImpl* face_impl, const CMapCache& cache, uint32_t uc) noexcept {
+  BLGlyphMappingState state;
+  cache.uncached_func(face_impl, &uc, 1, &state);
+  return uc;
+}
+
+// Maps code points by using `CMapCache` pages, which replaces a binary search per code point by a table lookup.
+static BLResult BL_CDECL map_text_to_glyphs_cached(const BLFontFaceImpl* face_impl, uint32_t* content, size_t count, BLGlyphMappingState* state) noexcept {
+  typedef CMapCache Cache;
+
+  const OTFaceImpl* ot_face_impl = static_cast<const OTFaceImpl*>(face_impl);
+  CMapCache& cache = const_cast<OTFaceImpl*>(ot_face_impl)->cmap_cache;
+
+  uint32_t* ptr = content;
+  uint32_t* end = content + count;
+
+  size_t undefined_count = 0;
+  state->undefined_first = SIZE_MAX;
+
+  // The first page contains ASCII and Latin-1 characters, which is used by most text, so it's always loaded.
+  const uint16_t* latin1_page = cache.page(0);
+  if (!latin1_page)
+    latin1_page = cache.build_page(face_impl, 0);
+
+  uint32_t last_index = 0;
+  const uint16_t* last_page = latin1_page;
+
+  while (ptr != end) {
+    // Latin-1 fast path - maps 4 code points at a time if all of them are within the first page.
+    if (PtrOps::bytes_until(ptr, end) >= 4u * sizeof(uint32_t) && latin1_page) {
+      uint32_t uc0 = ptr[0];
+      uint32_t uc1 = ptr[1];
+      uint32_t uc2 = ptr[2];
+      uint32_t uc3 = ptr[3];
+
+      if ((uc0 | uc1 | uc2 | uc3) < Cache::kPageSize) {
+        uint32_t g0 = latin1_page[uc0];
+        uint32_t g1 = latin1_page[uc1];
+        uint32_t g2 = latin1_page[uc2];
+        uint32_t g3 = latin1_page[uc3];
+
+        ptr[0] = g0;
+        ptr[1] = g1;
+        ptr[2] = g2;
+        ptr[3] = g3;
+
+        if (BL_UNLIKELY(!g0 || !g1 || !g2 || !g3)) {
+          for (size_t i = 0; i < 4u; i++) {
+            if (!ptr[i]) {
+              if (!undefined_count)
+                state->undefined_first = (size_t)(ptr - content) + i;
+              undefined_count++;
+            }
+          }
+        }
+
+        ptr += 4;
+        continue;
+      }
+    }
+
+    uint32_t uc = ptr[0];
+    BLGlyphId glyph_id;
+
+    if (uc <= 0xFFFFu) {
+      uint32_t index = uc >> Cache::kPageShift;
+      if (index != last_index || !last_page) {
+        last_index = index;
+        last_page = cache.page(index);
+        if (!last_page)
+          last_page = cache.build_page(face_impl, index);
+      }
+
+      if (BL_LIKELY(last_page))
+        glyph_id = last_page[uc & (Cache::kPageSize - 1u)];
+      else
+        glyph_id = map_code_point_uncached(face_impl, cache, uc);
+    }
+    else {
+      glyph_id = map_code_point_uncached(face_impl, cache, uc);
+    }
+
+    ptr[0] = glyph_id;
+    if (BL_UNLIKELY(glyph_id == 0)) {
+      if (!undefined_count)
+        state->undefined_first = (size_t)(ptr - content);
+      undefined_count++;
+    }
+
+    ptr++;
+  }
+
+  state->glyph_count = count;
+  state->undefined_count = undefined_count;
+
+  return BL_SUCCESS;
+}
+
 // bl::OpenType::CMapImpl - Validate
 // =================================
 
@@ -727,13 +865,18 @@ static bool is_supported_cmap_format(uint32_t format) noexcept {
 static BLResult init_cmap_funcs(OTFaceImpl* ot_face_impl) noexcept {
   switch (ot_face_impl->cmap_format) {
     case  0: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_format0; break;
-    case  4: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_format4; break;
+    case  4: ot_face_impl->cmap_cache.uncached_func = map_text_to_glyphs_format4; break;
     case  6: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_format6; break;
     case 10: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_format10; break;
-    case 12: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_format12_13<12>; break;
-    case 13: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_format12_13<13>; break;
+    case 12: ot_face_impl->cmap_cache.uncached_func = map_text_to_glyphs_format12_13<12>; break;
+    case 13: ot_face_impl->cmap_cache.uncached_func = map_text_to_glyphs_format12_13<13>; break;
     default: ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_none; break;
   }
+
+  // Formats that require a search use the cache, which is built on demand.
+  if (ot_face_impl->cmap_cache.uncached_func)
+    ot_face_impl->funcs.map_text_to_glyphs = map_text_to_glyphs_cached;
+
   return BL_SUCCESS;
 }
 
@@ -6,8 +6,10 @@
 #ifndef BLEND2D_OPENTYPE_OTCMAP_P_H_INCLUDED
 #define BLEND2D_OPENTYPE_OTCMAP_P_H_INCLUDED
 
+#include <blend2d/core/fontface_p.h>
 #include <blend2d/opentype/otdefs_p.h>
 #include <blend2d/support/ptrops_p.h>
+#include <blend2d/threading/atomic_p.h>
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_opentype_impl
@@ -204,6 +206,56 @@ struct CMapData {
   BL_INLINE void reset() noexcept { memset(this, 0, sizeof(*this)); }
 };
 
+//! Lazily built two-level table that maps BMP code points to glyph ids.
+//!
+//! Formats 4, 12, and 13 require a binary search of segments (or groups) per code point, which is slow when mapping
+//! a lot of text. The cache splits the BMP into pages of 256 code points, which are built on demand by the search
+//! based mapping function and then shared by all threads that use the face. Code points outside of BMP are always
+//! mapped by the search based function.
+class CMapCache {
+public:
+  BL_NONCOPYABLE(CMapCache)
+
+  typedef BLResult (BL_CDECL* MapFunc)(const BLFontFaceImpl* impl, uint32_t* content, size_t count, BLGlyphMappingState* state) noexcept;
+
+  static constexpr uint32_t kPageShift = 8;
+  static constexpr uint32_t kPageSize = 1u << kPageShift;
+  static constexpr uint32_t kPageCount = 0x10000u >> kPageShift;
+
+  //! \name Members
+  //! \{
+
+  //! Search based mapping function used to build pages and to map code points outside of BMP.
+  MapFunc uncached_func {};
+  //! Glyph ids of each page or null if the page was not built yet.
+  uint16_t* _pages[kPageCount] {};
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE CMapCache() noexcept = default;
+  BL_INLINE ~CMapCache() noexcept { reset(); }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Returns a page at `index` or null if it was not built yet.
+  BL_INLINE const uint16_t* page(uint32_t index) const noexcept { return bl_atomic_fetch_strong(&_pages[index]); }
+
+  //! Builds a page at `index` and returns it - if another thread built the same page concurrently its page is
+  //! returned instead. Returns null if the page could not be allocated.
+  BL_HIDDEN const uint16_t* build_page(const BLFontFaceImpl* face_impl, uint32_t index) noexcept;
+
+  //! Releases all pages.
+  BL_HIDDEN void reset() noexcept;
+
+  //! \}
+};
+
 namespace CMapImpl {
 
 //! Validates a CMapTable::Encoding subtable of any format at `sub_table_offset`. On success a valid `CMapEncoding`
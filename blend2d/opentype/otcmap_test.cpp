@@ -0,0 +1,102 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/fontdata.h>
+#include <blend2d/core/fontface.h>
+#include <blend2d/opentype/otcmap_p.h>
+#include <blend2d/opentype/otface_p.h>
+#include <blend2d/support/scopedbuffer_p.h>
+
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+// bl::OpenType::CMapImpl - Tests
+// ==============================
+
+namespace bl::OpenType {
+namespace Tests {
+
+typedef CMapCache::MapFunc MapFunc;
+
+UNIT(opentype_cmap, BL_TEST_GROUP_TEXT_OPENTYPE) {
+  BLFontData font_data;
+  BLFontFace face;
+
+  EXPECT_SUCCESS(font_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)));
+  EXPECT_SUCCESS(face.create_from_data(font_data, 0));
+
+  const OTFaceImpl* ot_face_impl = static_cast<const OTFaceImpl*>(face._d.impl);
+  const CMapCache& cache = ot_face_impl->cmap_cache;
+
+  // ABeeZee uses format 4, which requires a search per code point, thus the cache must be used.
+  EXPECT_EQ(ot_face_impl->cmap_format, 4u);
+  EXPECT_NOT_NULL(cache.uncached_func);
+
+  MapFunc cached_func = ot_face_impl->funcs.map_text_to_glyphs;
+  MapFunc uncached_func = cache.uncached_func;
+
+  // All BMP code points, followed by code points outside of BMP, and followed by invalid code points.
+  constexpr size_t kBMPCount = 0x10000u;
+  constexpr size_t kCount = kBMPCount + 4u;
+
+  ScopedBuffer buffer;
+  uint32_t* expected = static_cast<uint32_t*>(buffer.alloc(kCount * 2u * sizeof(uint32_t)));
+  EXPECT_NOT_NULL(expected);
+  uint32_t* actual = expected + kCount;
+
+  for (uint32_t i = 0; i < kBMPCount; i++)
+    expected[i] = i;
+
+  expected[kBMPCount + 0] = 0x10000u;
+  expected[kBMPCount + 1] = 0x1F600u;
+  expected[kBMPCount + 2] = 0x10FFFFu;
+  expected[kBMPCount + 3] = 0xFFFFFFFFu;
+
+  INFO("Testing whether cached mapping matches the mapping of format 4 sub-table");
+  {
+    memcpy(actual, expected, kCount * sizeof(uint32_t));
+
+    BLGlyphMappingState expected_state;
+    BLGlyphMappingState actual_state;
+
+    EXPECT_SUCCESS(uncached_func(ot_face_impl, expected, kCount, &expected_state));
+    EXPECT_NULL(cache.page(0x10));
+
+    EXPECT_SUCCESS(cached_func(ot_face_impl, actual, kCount, &actual_state));
+    EXPECT_NOT_NULL(cache.page(0x10));
+
+    for (size_t i = 0; i < kCount; i++)
+      EXPECT_EQ(actual[i], expected[i]).message("Code point at #%zu mapped to a different glyph", i);
+
+    EXPECT_EQ(actual_state.glyph_count, expected_state.glyph_count);
+    EXPECT_EQ(actual_state.undefined_first, expected_state.undefined_first);
+    EXPECT_EQ(actual_state.undefined_count, expected_state.undefined_count);
+  }
+
+  INFO("Testing undefined glyphs reported by Latin-1 fast path");
+  {
+    static const uint32_t text[] = { 'A', 'b', 0x80, 'c', 'd', 0x81, 'e', 'f' };
+    uint32_t content[BL_ARRAY_SIZE(text)];
+    memcpy(content, text, sizeof(text));
+
+    BLGlyphMappingState state;
+    EXPECT_SUCCESS(cached_func(ot_face_impl, content, BL_ARRAY_SIZE(text), &state));
+
+    EXPECT_EQ(state.glyph_count, BL_ARRAY_SIZE(text));
+    EXPECT_EQ(state.undefined_first, 2u);
+    EXPECT_EQ(state.undefined_count, 2u);
+    EXPECT_EQ(content[2], 0u);
+    EXPECT_EQ(content[5], 0u);
+    EXPECT_NE(content[0], 0u);
+    EXPECT_NE(content[7], 0u);
+  }
+}
+
+} // {Tests}
+} // {bl::OpenType}
+
+#endif // BL_TEST
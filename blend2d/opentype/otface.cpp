@@ -16,6 +16,7 @@
 #include <blend2d/opentype/otlayout_p.h>
 #include <blend2d/opentype/otmetrics_p.h>
 #include <blend2d/opentype/otname_p.h>
+#include <blend2d/opentype/otvar_p.h>
 
 namespace bl::OpenType {
 
@@ -69,6 +70,9 @@ static BLResult init_open_type_face(OTFaceImpl* ot_face_impl, const BLFontData*
     BL_PROPAGATE(KernImpl::init(ot_face_impl, tables));
   }
 
+  // Font variations require outlines to be initialized, as they select how to apply variation deltas.
+  BL_PROPAGATE(VarImpl::init(ot_face_impl, tables));
+
   BL_PROPAGATE(ot_face_impl->script_tag_set.finalize());
   BL_PROPAGATE(ot_face_impl->feature_tag_set.finalize());
   BL_PROPAGATE(ot_face_impl->variation_tag_set.finalize());
@@ -79,9 +83,11 @@ static BLResult init_open_type_face(OTFaceImpl* ot_face_impl, const BLFontData*
 static BLResult BL_CDECL destroy_open_type_face(BLObjectImpl* impl) noexcept {
   OTFaceImpl* ot_face_impl = static_cast<OTFaceImpl*>(impl);
 
+  bl_call_dtor(ot_face_impl->cmap_cache);
   bl_call_dtor(ot_face_impl->kern);
   bl_call_dtor(ot_face_impl->layout);
   bl_call_dtor(ot_face_impl->cff_fd_subr_indexes);
+  bl_call_dtor(ot_face_impl->var_outline_cache);
   bl_font_face_impl_dtor(ot_face_impl);
 
   return bl_object_free_impl(ot_face_impl);
@@ -102,9 +108,11 @@ BLResult create_open_type_face(BLFontFaceCore* self, const BLFontData* font_data
   ot_face_impl->data.dcast() = *font_data;
   ot_face_impl->cmap_format = uint8_t(0xFF);
 
+  bl_call_ctor(ot_face_impl->cmap_cache);
   bl_call_ctor(ot_face_impl->kern);
   bl_call_ctor(ot_face_impl->layout);
   bl_call_ctor(ot_face_impl->cff_fd_subr_indexes);
+  bl_call_ctor(ot_face_impl->var_outline_cache);
 
   BLResult result = init_open_type_face(ot_face_impl, font_data);
 
@@ -15,6 +15,7 @@
 #include <blend2d/opentype/otlayout_p.h>
 #include <blend2d/opentype/otmetrics_p.h>
 #include <blend2d/opentype/otname_p.h>
+#include <blend2d/opentype/otvar_p.h>
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_opentype_impl
@@ -83,6 +84,8 @@ struct OTFaceImpl : public BLFontFacePrivateImpl {
 
   //! Character to glyph mapping data.
   CMapData cmap;
+  //! Character to glyph mapping cache (only used by formats that require a search).
+  CMapCache cmap_cache;
   //! Metrics data.
   MetricsData metrics;
 
@@ -100,6 +103,11 @@ struct OTFaceImpl : public BLFontFacePrivateImpl {
   //! Array of LSubR indexes used by CID fonts (CFF/CFF2).
   BLArray<CFFData::IndexData> cff_fd_subr_indexes;
 
+  //! Font variations data - 'fvar', 'avar', and 'gvar' tables.
+  VarData var;
+  //! Outlines of variable font instances (only used by fonts that provide variations).
+  VarOutlineCache var_outline_cache;
+
   BL_INLINE uint32_t loca_offset_size() const noexcept {
     return uint32_t(ot_flags & (OTFaceFlags::kLocaOffset16 | OTFaceFlags::kLocaOffset32));
   }
@@ -107,7 +115,7 @@ struct OTFaceImpl : public BLFontFacePrivateImpl {
 
 //! OpenType tables that are used during the initialization of \ref OTFaceImpl.
 union OTFaceTables {
-  enum : uint32_t { kTableCount = 19 };
+  enum : uint32_t { kTableCount = 22 };
 
   BLFontTable tables[kTableCount];
 
@@ -136,6 +144,10 @@ union OTFaceTables {
 
     BLFontTable cff;
     BLFontTable cff2;
+
+    BLFontTable fvar;
+    BLFontTable avar;
+    BLFontTable gvar;
   };
 
   BL_INLINE void init(OTFaceImpl* ot_face_impl, const BLFontData* font_data) noexcept {
@@ -163,7 +175,11 @@ union OTFaceTables {
       BL_MAKE_TAG('l', 'o', 'c', 'a'),
 
       BL_MAKE_TAG('C', 'F', 'F', ' '),
-      BL_MAKE_TAG('C', 'F', 'F', '2')
+      BL_MAKE_TAG('C', 'F', 'F', '2'),
+
+      BL_MAKE_TAG('f', 'v', 'a', 'r'),
+      BL_MAKE_TAG('a', 'v', 'a', 'r'),
+      BL_MAKE_TAG('g', 'v', 'a', 'r')
     };
 
     font_data->get_tables(ot_face_impl->face_info.face_index, tables, tags, kTableCount);
@@ -12,6 +12,7 @@
 #include <blend2d/opentype/otglyf_p.h>
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/lookuptable_p.h>
+#include <blend2d/support/math_p.h>
 #include <blend2d/support/memops_p.h>
 #include <blend2d/support/ptrops_p.h>
 #include <blend2d/support/scopedbuffer_p.h>
@@ -615,6 +616,416 @@ InvalidData:
   return bl_make_error(BL_ERROR_INVALID_DATA);
 }
 
+// bl::OpenType::GlyfImpl - GetGlyphOutlinesVar
+// ============================================
+
+// Variable glyphs cannot be decoded in a single pass as deltas have to be applied to all points of a glyph (or all
+// component offsets of a compound glyph) before the outline can be emitted. This is much slower than decoding static
+// glyphs, which is fine as the outlines of variable glyphs are cached (see `VarOutlineCache`).
+
+namespace {
+
+struct GlyfVarComponent {
+  BLGlyphId glyph_id;
+  uint32_t flags;
+  BLMatrix2D transform;
+};
+
+} // {anonymous}
+
+static BLResult get_glyph_data(const OTFaceImpl* ot_face_impl, BLGlyphId glyph_id, const uint8_t** data_out, size_t* size_out) noexcept {
+  RawTable glyf_table = ot_face_impl->glyf.glyf_table;
+  RawTable loca_table = ot_face_impl->glyf.loca_table;
+
+  size_t offset;
+  size_t end_off;
+
+  if (ot_face_impl->loca_offset_size() == 2) {
+    size_t index = size_t(glyph_id) * 2u;
+    if (BL_UNLIKELY(index + sizeof(UInt16) * 2u > loca_table.size))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+    offset = uint32_t(reinterpret_cast<const UInt16*>(loca_table.data + index + 0)->value()) * 2u;
+    end_off = uint32_t(reinterpret_cast<const UInt16*>(loca_table.data + index + 2)->value()) * 2u;
+  }
+  else {
+    size_t index = size_t(glyph_id) * 4u;
+    if (BL_UNLIKELY(index + sizeof(UInt32) * 2u > loca_table.size))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+    offset = reinterpret_cast<const UInt32*>(loca_table.data + index + 0)->value();
+    end_off = reinterpret_cast<const UInt32*>(loca_table.data + index + 4)->value();
+  }
+
+  // Empty glyph is only ALLOWED when `offset == end_off`.
+  if (BL_UNLIKELY(offset > end_off || end_off > glyf_table.size))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  if (offset != end_off && BL_UNLIKELY(end_off - offset < sizeof(GlyfTable::GlyphData)))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  *data_out = glyf_table.data + offset;
+  *size_out = end_off - offset;
+  return BL_SUCCESS;
+}
+
+// Emits a single TrueType contour [start, end] of transformed `points` to `out`.
+static BLResult emit_var_contour(BLPath* out, const BLPoint* points, const uint8_t* flags, size_t start, size_t end) noexcept {
+  typedef GlyfTable::Simple Simple;
+
+  // A single point contour - the same as static glyphs, only on-curve point emits 'MoveTo'.
+  if (start == end)
+    return (flags[start] & Simple::kOnCurvePoint) ? out->move_to(points[start]) : BLResult(BL_SUCCESS);
+
+  // Find a point where to start the contour - it must be on-curve, which can be implied between two off-curve points.
+  BLPoint start_pt;
+  size_t i = start;
+  size_t i_end = end + 1u;
+
+  if (flags[start] & Simple::kOnCurvePoint) {
+    start_pt = points[start];
+    i++;
+  }
+  else if (flags[end] & Simple::kOnCurvePoint) {
+    start_pt = points[end];
+    i_end--;
+  }
+  else {
+    start_pt = (points[end] + points[start]) * 0.5;
+  }
+
+  BL_PROPAGATE(out->move_to(start_pt));
+
+  BLPoint control_pt;
+  bool has_control = false;
+
+  for (; i < i_end; i++) {
+    const BLPoint& pt = points[i];
+    if (flags[i] & Simple::kOnCurvePoint) {
+      BL_PROPAGATE(has_control ? out->quad_to(control_pt, pt) : out->line_to(pt));
+      has_control = false;
+    }
+    else {
+      if (has_control)
+        BL_PROPAGATE(out->quad_to(control_pt, (control_pt + pt) * 0.5));
+      control_pt = pt;
+      has_control = true;
+    }
+  }
+
+  if (has_control)
+    BL_PROPAGATE(out->quad_to(control_pt, start_pt));
+
+  return out->close();
+}
+
+static BLResult decode_var_simple_glyph(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords& coords,
+  const BLMatrix2D& transform,
+  const uint8_t* gPtr,
+  size_t remaining_size,
+  size_t contour_count,
+  BLPath* out) noexcept {
+
+  typedef GlyfTable::Simple Simple;
+
+  // Minimum data size is:
+  //   10                       [GlyphData header]
+  //   (number_of_contours * 2) [end_pts_of_contours]
+  //   2                        [instruction_length]
+  if (BL_UNLIKELY(remaining_size < sizeof(GlyfTable::GlyphData) + contour_count * 2u + 2u))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  const uint8_t* gEnd = gPtr + remaining_size;
+  gPtr += sizeof(GlyfTable::GlyphData);
+
+  const UInt16* contour_array = reinterpret_cast<const UInt16*>(gPtr);
+  gPtr += contour_count * 2u;
+
+  // We don't use hinting instructions, so skip them.
+  size_t instruction_count = MemOps::readU16uBE(gPtr);
+  gPtr += 2u;
+
+  if (BL_UNLIKELY(instruction_count > PtrOps::bytes_until(gPtr, gEnd)))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+  gPtr += instruction_count;
+
+  size_t tt_vertex_count = size_t(contour_array[contour_count - 1u].value()) + 1u;
+  size_t point_count = tt_vertex_count + 4u;
+
+  // Points (including 4 phantom points) followed by flags.
+  ScopedBufferTmp<2048> buffer;
+  uint8_t* buffer_ptr = static_cast<uint8_t*>(buffer.alloc(point_count * sizeof(BLPoint) + tt_vertex_count));
+  if (BL_UNLIKELY(!buffer_ptr))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  BLPoint* points = reinterpret_cast<BLPoint*>(buffer_ptr);
+  uint8_t* flags = buffer_ptr + point_count * sizeof(BLPoint);
+
+  // Read TrueType Flags Data
+  // ------------------------
+
+  size_t x_coordinates_size = 0;
+  for (size_t i = 0; i < tt_vertex_count;) {
+    if (BL_UNLIKELY(gPtr == gEnd))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    uint32_t tt_flag = *gPtr++ & Simple::kImportantFlagsMask;
+    size_t n = 1;
+
+    if (tt_flag & Simple::kRepeatFlag) {
+      if (BL_UNLIKELY(gPtr == gEnd))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+      n += *gPtr++;
+    }
+
+    if (BL_UNLIKELY(n > tt_vertex_count - i))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    x_coordinates_size += n * (vertex_size_table[tt_flag >> 1] & 0xFFFFu);
+    MemOps::fill_small(flags + i, uint8_t(tt_flag), n);
+    i += n;
+  }
+
+  // Read TrueType Vertex Data
+  // -------------------------
+
+  const uint8_t* xPtr = gPtr;
+  const uint8_t* yPtr = gPtr + x_coordinates_size;
+
+  if (BL_UNLIKELY(x_coordinates_size > PtrOps::bytes_until(gPtr, gEnd)))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  int x = 0;
+  int y = 0;
+
+  for (size_t i = 0; i < tt_vertex_count; i++) {
+    uint32_t f = flags[i];
+    size_t y_size = vertex_size_table[f >> 1] >> 16;
+
+    if (BL_UNLIKELY(y_size > PtrOps::bytes_until(yPtr, gEnd)))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    if (f & Simple::kXIsByte) {
+      x += (f & Simple::kXIsSameOrXByteIsPositive) ? int(xPtr[0]) : -int(xPtr[0]);
+      xPtr += 1;
+    }
+    else if (!(f & Simple::kXIsSameOrXByteIsPositive)) {
+      x += MemOps::readI16uBE(xPtr);
+      xPtr += 2;
+    }
+
+    if (f & Simple::kYIsByte) {
+      y += (f & Simple::kYIsSameOrYByteIsPositive) ? int(yPtr[0]) : -int(yPtr[0]);
+      yPtr += 1;
+    }
+    else if (!(f & Simple::kYIsSameOrYByteIsPositive)) {
+      y += MemOps::readI16uBE(yPtr);
+      yPtr += 2;
+    }
+
+    points[i].reset(double(x), double(y));
+  }
+
+  // Phantom points are only used by metrics, which are not varied by outlines.
+  for (size_t i = tt_vertex_count; i < point_count; i++)
+    points[i].reset();
+
+  BL_PROPAGATE(VarImpl::apply_glyph_deltas(ot_face_impl, glyph_id, coords, points, point_count, contour_array, contour_count));
+
+  for (size_t i = 0; i < tt_vertex_count; i++)
+    points[i] = transform.map_point(points[i]);
+
+  // Emit Contours
+  // -------------
+
+  size_t start = 0;
+  for (size_t contour_index = 0; contour_index < contour_count; contour_index++) {
+    size_t end = contour_array[contour_index].value();
+    if (BL_UNLIKELY(end < start || end >= tt_vertex_count))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    BL_PROPAGATE(emit_var_contour(out, points, flags, start, end));
+    start = end + 1u;
+  }
+
+  return BL_SUCCESS;
+}
+
+static BLResult decode_var_glyph(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords& coords,
+  const BLMatrix2D& transform,
+  BLPath* out,
+  size_t* contour_count_out,
+  uint32_t level) noexcept {
+
+  typedef GlyfTable::Compound Compound;
+
+  if (BL_UNLIKELY(level >= CompoundEntry::kMaxLevel))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  const uint8_t* gPtr;
+  size_t remaining_size;
+  BL_PROPAGATE(get_glyph_data(ot_face_impl, glyph_id, &gPtr, &remaining_size));
+
+  if (!remaining_size)
+    return BL_SUCCESS;
+
+  int contour_count_signed = reinterpret_cast<const GlyfTable::GlyphData*>(gPtr)->number_of_contours();
+  if (contour_count_signed > 0) {
+    size_t contour_count = size_t(unsigned(contour_count_signed));
+    *contour_count_out += contour_count;
+    return decode_var_simple_glyph(ot_face_impl, glyph_id, coords, transform, gPtr, remaining_size, contour_count, out);
+  }
+
+  // Cannot be less than -1, only -1 specifies compound glyph, lesser value is invalid according to the specification.
+  if (contour_count_signed == 0)
+    return BL_SUCCESS;
+
+  if (BL_UNLIKELY(contour_count_signed < -1))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  gPtr += sizeof(GlyfTable::GlyphData);
+  remaining_size -= sizeof(GlyfTable::GlyphData);
+
+  // Each component has at least 6 bytes, component offsets are followed by 4 phantom points.
+  size_t max_component_count = remaining_size / 6u;
+  ScopedBufferTmp<1024> buffer;
+
+  uint8_t* buffer_ptr = static_cast<uint8_t*>(buffer.alloc(max_component_count * sizeof(GlyfVarComponent) + (max_component_count + 4u) * sizeof(BLPoint)));
+  if (BL_UNLIKELY(!buffer_ptr))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  GlyfVarComponent* components = reinterpret_cast<GlyfVarComponent*>(buffer_ptr);
+  BLPoint* offsets = reinterpret_cast<BLPoint*>(components + max_component_count);
+  size_t component_count = 0;
+
+  constexpr double kScaleF2x14 = 1.0 / 16384.0;
+
+  uint32_t flags;
+  do {
+    if (BL_UNLIKELY(remaining_size < 6u || component_count >= max_component_count))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    flags = MemOps::readU16uBE(gPtr);
+    BLGlyphId component_glyph_id = MemOps::readU16uBE(gPtr + 2);
+    if (BL_UNLIKELY(component_glyph_id >= ot_face_impl->face_info.glyph_count))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    int arg1 = MemOps::readI8(gPtr + 4);
+    int arg2 = MemOps::readI8(gPtr + 5);
+    gPtr += 6;
+    remaining_size -= 6;
+
+    if (flags & Compound::kArgsAreWords) {
+      if (BL_UNLIKELY(remaining_size < 2u))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+
+      arg1 = IntOps::shl(arg1, 8) | (arg2 & 0xFF);
+      arg2 = MemOps::readI16uBE(gPtr);
+      gPtr += 2;
+      remaining_size -= 2;
+    }
+
+    if (!(flags & Compound::kArgsAreXYValues)) {
+      // This makes them unsigned - the same as static glyphs (point matching is not implemented).
+      arg1 &= 0xFFFFu;
+      arg2 &= 0xFFFFu;
+    }
+
+    GlyfVarComponent& component = components[component_count];
+    component.glyph_id = component_glyph_id;
+    component.flags = flags;
+
+    BLMatrix2D& cm = component.transform;
+    cm.reset();
+
+    if (flags & Compound::kAnyCompoundScale) {
+      size_t scale_size = (flags & Compound::kWeHaveScale) ? 2u : (flags & Compound::kWeHaveScaleXY) ? 4u : 8u;
+      if (BL_UNLIKELY(remaining_size < scale_size))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+
+      if (flags & Compound::kWeHaveScale) {
+        double scale = double(MemOps::readI16uBE(gPtr)) * kScaleF2x14;
+        cm.m00 = scale;
+        cm.m11 = scale;
+      }
+      else if (flags & Compound::kWeHaveScaleXY) {
+        cm.m00 = double(MemOps::readI16uBE(gPtr + 0)) * kScaleF2x14;
+        cm.m11 = double(MemOps::readI16uBE(gPtr + 2)) * kScaleF2x14;
+      }
+      else {
+        cm.m00 = double(MemOps::readI16uBE(gPtr + 0)) * kScaleF2x14;
+        cm.m01 = double(MemOps::readI16uBE(gPtr + 2)) * kScaleF2x14;
+        cm.m10 = double(MemOps::readI16uBE(gPtr + 4)) * kScaleF2x14;
+        cm.m11 = double(MemOps::readI16uBE(gPtr + 6)) * kScaleF2x14;
+      }
+
+      gPtr += scale_size;
+      remaining_size -= scale_size;
+    }
+
+    offsets[component_count].reset(double(arg1), double(arg2));
+    component_count++;
+  } while (flags & Compound::kMoreComponents);
+
+  for (size_t i = 0; i < 4u; i++)
+    offsets[component_count + i].reset();
+
+  // Component offsets are the points of a compound glyph, deltas of untouched offsets are not inferred.
+  BL_PROPAGATE(VarImpl::apply_glyph_deltas(ot_face_impl, glyph_id, coords, offsets, component_count + 4u, nullptr, 0));
+
+  for (size_t i = 0; i < component_count; i++) {
+    GlyfVarComponent& component = components[i];
+    BLMatrix2D& cm = component.transform;
+
+    // Deltas only apply to offsets, point matching arguments are used as is.
+    if (component.flags & Compound::kArgsAreXYValues) {
+      cm.m20 = offsets[i].x;
+      cm.m21 = offsets[i].y;
+    }
+    else {
+      cm.m20 = Math::round(offsets[i].x);
+      cm.m21 = Math::round(offsets[i].y);
+    }
+
+    // See the static glyph decoder regarding scaled component offsets, which matches FreeType.
+    if ((component.flags & Compound::kAnyCompoundScale) &&
+        (component.flags & (Compound::kArgsAreXYValues | Compound::kAnyCompoundOffset    )) ==
+                           (Compound::kArgsAreXYValues | Compound::kScaledComponentOffset)) {
+      cm.m20 *= Geometry::magnitude(BLPoint(cm.m00, cm.m01));
+      cm.m21 *= Geometry::magnitude(BLPoint(cm.m10, cm.m11));
+    }
+
+    TransformInternal::multiply(cm, cm, transform);
+    BL_PROPAGATE(decode_var_glyph(ot_face_impl, component.glyph_id, coords, cm, out, contour_count_out, level + 1u));
+  }
+
+  return BL_SUCCESS;
+}
+
+BLResult BL_CDECL get_glyph_outlines_var(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords* coords,
+  BLPath* out,
+  size_t* contour_count_out,
+  ScopedBuffer* tmp_buffer) noexcept {
+
+  bl_unused(tmp_buffer);
+  *contour_count_out = 0;
+
+  if (BL_UNLIKELY(glyph_id >= ot_face_impl->face_info.glyph_count))
+    return bl_make_error(BL_ERROR_INVALID_GLYPH);
+
+  BLResult result = decode_var_glyph(ot_face_impl, glyph_id, *coords, TransformInternal::identity_transform, out, contour_count_out, 0);
+  if (BL_UNLIKELY(result != BL_SUCCESS))
+    *contour_count_out = 0;
+  return result;
+}
+
 // bl::OpenType::GlyfImpl - Init
 // =============================
 
@@ -7,6 +7,7 @@
 #define BLEND2D_OPENTYPE_OTGLYF_P_H_INCLUDED
 
 #include <blend2d/core/font_p.h>
+#include <blend2d/core/fontface_p.h>
 #include <blend2d/core/matrix_p.h>
 #include <blend2d/core/path_p.h>
 #include <blend2d/opentype/otdefs_p.h>
@@ -167,6 +168,15 @@ BL_HIDDEN BLResult BL_CDECL get_glyph_outlines_asimd(
   ScopedBuffer* tmp_buffer) noexcept;
 #endif // BL_BUILD_OPT_ASIMD
 
+//! Decodes unscaled outlines of `glyph_id` with 'gvar' deltas applied to all points and component offsets.
+BL_HIDDEN BLResult BL_CDECL get_glyph_outlines_var(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords* coords,
+  BLPath* out,
+  size_t* contour_count_out,
+  ScopedBuffer* tmp_buffer) noexcept;
+
 BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables) noexcept;
 
 } // {GlyfImpl}
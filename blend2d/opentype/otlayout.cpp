@@ -863,7 +863,7 @@ static BL_INLINE bool match_sequence_rule_format2(Table<Array16<Offset16>> rule_
 }
 
 template<uint32_t kCovFmt>
-static BL_INLINE bool match_sequence_format1(Table<GSubGPosTable::SequenceContext1> table, uint32_t rule_set_count, GlyphRange first_glyph_range, const CoverageTableIterator& cov_it, const BLGlyphId* glyph_ptr, size_t max_glyph_count, SequenceMatch* match_out) noexcept {
+static BL_INLINE bool match_sequence_format1(Table<GSubGPosTable::SequenceContext1> table, uint32_t rule_set_count, CoverageFilter first_glyph_range, const CoverageTableIterator& cov_it, const BLGlyphId* glyph_ptr, size_t max_glyph_count, SequenceMatch* match_out) noexcept {
   BLGlyphId glyph_id = glyph_ptr[0];
   if (!first_glyph_range.contains(glyph_id))
     return false;
@@ -886,7 +886,7 @@ template<uint32_t kCovFmt, uint32_t kCDFmt>
 static BL_INLINE bool match_sequence_format2(
   Table<GSubGPosTable::SequenceContext2> table,
   uint32_t rule_set_count,
-  GlyphRange first_glyph_range,
+  CoverageFilter first_glyph_range,
   const CoverageTableIterator& cov_it,
   const ClassDefTableIterator& cd_it,
   const BLGlyphId* glyph_ptr,
@@ -918,7 +918,7 @@ static BL_INLINE bool match_sequence_format2(
 static BL_INLINE bool match_sequence_format3(
   Table<GSubGPosTable::SequenceContext3> table,
   const UInt16* coverage_offset_array,
-  GlyphRange first_glyph_range,
+  CoverageFilter first_glyph_range,
   const CoverageTableIterator& cov0_it,
   uint32_t cov0_fmt,
   const BLGlyphId* glyph_ptr,
@@ -1127,7 +1127,7 @@ static BL_NOINLINE bool validate_chained_context_format3(ValidationContext& vali
 
 struct ChainedMatchContext {
   RawTable table;
-  GlyphRange first_glyph_range;
+  CoverageFilter first_glyph_range;
 
   BLGlyphId* back_glyph_ptr;
   BLGlyphId* ahead_glyph_ptr;
@@ -1385,7 +1385,7 @@ static BL_INLINE bool match_chained_sequence_format3(
   const UInt16* backtrack_coverage_offset_array, uint32_t backtrack_glyph_count,
   const UInt16* input_coverage_offset_array, uint32_t input_glyph_count,
   const UInt16* lookahead_coverage_offset_array, uint32_t lookahead_glyph_count,
-  GlyphRange first_glyph_range,
+  CoverageFilter first_glyph_range,
   CoverageTableIterator& cov0_it, uint32_t cov0_fmt) noexcept {
 
   BL_ASSERT(mCtx.back_glyph_count >= backtrack_glyph_count);
@@ -1459,7 +1459,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type1_format1(GSubConte
   BL_ASSERT(glyph_ptr != glyph_end);
 
   uint32_t glyph_delta = uint16_t(table->delta_glyph_id());
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     BLGlyphId glyph_id = glyph_ptr[0];
@@ -1485,7 +1485,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type1_format2(GSubConte
   BL_ASSERT(glyph_ptr != glyph_end);
 
   uint32_t subst_count = table->glyphs.count();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
   BL_ASSERT_VALIDATED(table.fits(GSubTable::SingleSubst2::kBaseSize + subst_count * 2u));
 
   do {
@@ -1565,7 +1565,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type2_format1(GSubConte
 
   size_t replaced_glyph_count = 0;
   size_t replaced_sequence_size = 0;
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     BLGlyphId glyph_id = glyph_in_ptr[0];
@@ -1686,7 +1686,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type3_format1(GSubConte
   BL_ASSERT(glyph_ptr != glyph_end);
 
   uint32_t alternate_set_count = table->alternate_set_offsets.count();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
   BL_ASSERT_VALIDATED(table.fits(GSubTable::AlternateSubst1::kBaseSize + alternate_set_count * 2u));
 
   // TODO: [OpenType] Not sure how the index should be selected (AlternateSubst1).
@@ -1835,7 +1835,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type4_format1(GSubConte
 
   // Find the first ligature - if no ligature is matched, no buffer operation will be performed.
   BLGlyphId* glyph_out_ptr = nullptr;
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   for (;;) {
     BLGlyphId glyph_id = glyph_in_ptr[0];
@@ -1953,7 +1953,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type5_format1(GSubConte
 
   BLGlyphId* glyph_in_ptr = ctx.glyph_data() + scope.index();
   BLGlyphId* glyph_in_end = ctx.glyph_data() + scope.end();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   while (glyph_in_ptr != glyph_in_end) {
     SequenceMatch match;
@@ -1977,7 +1977,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type5_format2(GSubConte
 
   BLGlyphId* glyph_in_ptr = ctx.glyph_data() + scope.index();
   BLGlyphId* glyph_in_end = ctx.glyph_data() + scope.end();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   while (glyph_in_ptr != glyph_in_end) {
     SequenceMatch match;
@@ -2008,7 +2008,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type5_format3(GSubConte
 
   CoverageTableIterator cov0_it;
   uint32_t cov0_fmt = cov0_it.init(table.sub_table_unchecked(coverage_offset_array[0].value()));
-  GlyphRange glyph_range = cov0_it.glyph_range_with_format(cov0_fmt);
+  CoverageFilter glyph_range = ctx.coverage_filter(cov0_it.glyph_range_with_format(cov0_fmt));
   const GSubTable::SequenceLookupRecord* lookup_record_array = table->lookup_record_array(glyph_count);
 
   BLGlyphId* glyph_in_ptr = ctx.glyph_data() + scope.index();
@@ -2055,7 +2055,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type6_format1(GSubConte
 
   ChainedMatchContext mCtx;
   mCtx.table = table;
-  mCtx.first_glyph_range = cov_it.glyph_range<kCovFmt>();
+  mCtx.first_glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
   mCtx.back_glyph_ptr = ctx.glyph_data();
   mCtx.ahead_glyph_ptr = ctx.glyph_data() + scope.index();
   mCtx.back_glyph_count = scope.index();
@@ -2091,7 +2091,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type6_format2(
 
   ChainedMatchContext mCtx;
   mCtx.table = table;
-  mCtx.first_glyph_range = cov_it.glyph_range<kCovFmt>();
+  mCtx.first_glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
   mCtx.back_glyph_ptr = ctx.glyph_data();
   mCtx.ahead_glyph_ptr = ctx.glyph_data() + scope.index();
   mCtx.back_glyph_count = scope.index();
@@ -2145,11 +2145,11 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type6_format3(GSubConte
 
   CoverageTableIterator cov0_it;
   uint32_t cov0_fmt = cov0_it.init(table.sub_table_unchecked(input_coverage_offsets[0].value()));
-  GlyphRange first_glyph_range = cov0_it.glyph_range_with_format(cov0_fmt);
+  CoverageFilter first_glyph_range = ctx.coverage_filter(cov0_it.glyph_range_with_format(cov0_fmt));
 
   ChainedMatchContext mCtx;
   mCtx.table = table;
-  mCtx.first_glyph_range = cov0_it.glyph_range_with_format(cov0_fmt);
+  mCtx.first_glyph_range = first_glyph_range;
   mCtx.back_glyph_ptr = ctx.glyph_data();
   mCtx.ahead_glyph_ptr = ctx.glyph_data() + scope.index();
   mCtx.back_glyph_count = scope.index();
@@ -2253,7 +2253,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gsub_lookup_type8_format1(GSubConte
 
   CoverageTableIterator cov_it;
   uint32_t cov_fmt = cov_it.init(table.sub_table_unchecked(table->coverage_offset()));
-  GlyphRange glyph_range = cov_it.glyph_range_with_format(cov_fmt);
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range_with_format(cov_fmt));
 
   BLGlyphId* glyph_data = ctx.glyph_data();
   size_t i = scope.end();
@@ -2535,7 +2535,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type1_format1(GPosConte
 
   BLGlyphId* glyph_data = ctx.glyph_data();
   BLGlyphPlacement* placement_data = ctx.placement_data();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     BLGlyphId glyph_id = glyph_data[i];
@@ -2568,7 +2568,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type1_format2(GPosConte
 
   BLGlyphId* glyph_data = ctx.glyph_data();
   BLGlyphPlacement* placement_data = ctx.placement_data();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     BLGlyphId glyph_id = glyph_data[i];
@@ -2681,7 +2681,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type2_format1(GPosConte
 
   BLGlyphId left_glyph_id = glyph_data[i];
   BLGlyphId right_glyph_id = 0;
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     right_glyph_id = glyph_data[i + 1];
@@ -2747,7 +2747,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type2_format2(GPosConte
 
   BLGlyphId left_glyph_id = glyph_data[i];
   BLGlyphId right_glyph_id = 0;
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     right_glyph_id = glyph_data[i + 1];
@@ -2846,7 +2846,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type7_format1(GPosConte
   BL_ASSERT(index < end);
 
   const BLGlyphId* glyph_ptr = ctx.glyph_data();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     SequenceMatch match;
@@ -2871,7 +2871,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type7_format2(GPosConte
   BL_ASSERT(index < end);
 
   const BLGlyphId* glyph_ptr = ctx.glyph_data() + scope.index();
-  GlyphRange glyph_range = cov_it.glyph_range<kCovFmt>();
+  CoverageFilter glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
 
   do {
     SequenceMatch match;
@@ -2908,7 +2908,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type7_format3(GPosConte
   BL_ASSERT(index < end);
 
   const BLGlyphId* glyph_ptr = ctx.glyph_data() + scope.index();
-  GlyphRange glyph_range = cov0_it.glyph_range_with_format(cov0_fmt);
+  CoverageFilter glyph_range = ctx.coverage_filter(cov0_it.glyph_range_with_format(cov0_fmt));
   SequenceMatch match{glyph_count, lookup_record_count, lookup_record_array};
 
   size_t end_minus_glyph_count = end - glyph_count;
@@ -2950,7 +2950,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type8_format1(GPosConte
 
   ChainedMatchContext mCtx;
   mCtx.table = table;
-  mCtx.first_glyph_range = cov_it.glyph_range<kCovFmt>();
+  mCtx.first_glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
   mCtx.back_glyph_ptr = ctx.glyph_data();
   mCtx.ahead_glyph_ptr = ctx.glyph_data() + scope.index();
   mCtx.back_glyph_count = scope.index();
@@ -2986,7 +2986,7 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type8_format2(
 
   ChainedMatchContext mCtx;
   mCtx.table = table;
-  mCtx.first_glyph_range = cov_it.glyph_range<kCovFmt>();
+  mCtx.first_glyph_range = ctx.coverage_filter(cov_it.glyph_range<kCovFmt>());
   mCtx.back_glyph_ptr = ctx.glyph_data();
   mCtx.ahead_glyph_ptr = ctx.glyph_data() + scope.index();
   mCtx.back_glyph_count = scope.index();
@@ -3040,11 +3040,11 @@ static BL_INLINE_IF_NOT_DEBUG BLResult apply_gpos_lookup_type8_format3(GPosConte
 
   CoverageTableIterator cov0_it;
   uint32_t cov0_fmt = cov0_it.init(table.sub_table_unchecked(input_coverage_offsets[0].value()));
-  GlyphRange first_glyph_range = cov0_it.glyph_range_with_format(cov0_fmt);
+  CoverageFilter first_glyph_range = ctx.coverage_filter(cov0_it.glyph_range_with_format(cov0_fmt));
 
   ChainedMatchContext mCtx;
   mCtx.table = table;
-  mCtx.first_glyph_range = cov0_it.glyph_range_with_format(cov0_fmt);
+  mCtx.first_glyph_range = first_glyph_range;
   mCtx.back_glyph_ptr = ctx.glyph_data();
   mCtx.ahead_glyph_ptr = ctx.glyph_data() + scope.index();
   mCtx.back_glyph_count = scope.index();
@@ -3362,6 +3362,139 @@ static BL_NOINLINE LayoutData::LookupStatusBits validate_lookups(const OTFaceImp
   return ot_face_impl->layout.commit_lookup_status_bits(lookup_kind, word_index, LayoutData::LookupStatusBits::make(analyzed_bits, valid_bits));
 }
 
+// bl::OpenType::LayoutImpl - Lookup Coverage
+// ==========================================
+
+// Returns an offset of a coverage table relative to `lookup_header`, which contains all glyphs that can start a match
+// of the lookup subtable, or zero if the subtable has no such coverage table.
+static uint32_t first_glyph_coverage_offset(RawTable lookup_header, LookupKind lookup_kind, uint32_t lookup_type, uint32_t lookup_format) noexcept {
+  // Only sequence context and chained sequence context subtables have format 3, which uses the coverage of the
+  // first input glyph. All other subtables start with a coverage offset (the coverage of marks in case of GPOS
+  // attachment subtables).
+  if (lookup_format == 3u) {
+    uint32_t context_type = lookup_kind == LookupKind::kGSUB ? uint32_t(GSubTable::kLookupContext) : uint32_t(GPosTable::kLookupContext);
+
+    if (lookup_type == context_type) {
+      if (!lookup_header.fits(GSubGPosTable::SequenceContext3::kBaseSize + 2u) || !lookup_header.readU16(2u))
+        return 0u;
+      return lookup_header.readU16(GSubGPosTable::SequenceContext3::kBaseSize);
+    }
+
+    uint32_t chained_context_type = lookup_kind == LookupKind::kGSUB ? uint32_t(GSubTable::kLookupChainedContext) : uint32_t(GPosTable::kLookupChainedContext);
+    if (lookup_type == chained_context_type) {
+      if (!lookup_header.fits(4u))
+        return 0u;
+
+      uint32_t input_offset = 4u + lookup_header.readU16(2u) * 2u;
+      if (!lookup_header.fits(input_offset + 4u) || !lookup_header.readU16(input_offset))
+        return 0u;
+      return lookup_header.readU16(input_offset + 2u);
+    }
+
+    return 0u;
+  }
+
+  if (!lookup_header.fits(GSubGPosTable::LookupHeaderWithCoverage::kBaseSize))
+    return 0u;
+
+  return lookup_header.data_as<GSubGPosTable::LookupHeaderWithCoverage>()->coverage_offset();
+}
+
+// Adds all glyphs of the coverage `table` to `bits` having `glyph_count` bits. Glyphs outside of the bit array are
+// ignored - the caller must treat such glyphs as covered as they are not represented by the bit array.
+static bool add_coverage_to_bits(RawTable table, uint32_t* bits, uint32_t glyph_count) noexcept {
+  if (!table.fits(CoverageTable::kBaseSize))
+    return false;
+
+  uint32_t format = table.data_as<CoverageTable>()->format();
+  uint32_t count = table.data_as<CoverageTable>()->array.count();
+
+  if ((format != 1u && format != 2u) || !table.fits(CoverageTable::kBaseSize + count * CoverageTable::entry_size_by_format(format)))
+    return false;
+
+  if (format == 1u) {
+    const UInt16* glyphs = table.data_as<CoverageTable::Format1>()->glyphs.array();
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t glyph_id = glyphs[i].value();
+      if (glyph_id < glyph_count)
+        BitArrayOps::bit_array_set_bit(bits, glyph_id);
+    }
+  }
+  else {
+    const CoverageTable::Range* ranges = table.data_as<CoverageTable::Format2>()->ranges.array();
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t first_glyph = ranges[i].first_glyph();
+      uint32_t last_glyph = bl_min<uint32_t>(ranges[i].last_glyph(), glyph_count - 1u);
+      if (first_glyph <= last_glyph)
+        BitArrayOps::bit_array_fill(bits, first_glyph, last_glyph - first_glyph + 1u);
+    }
+  }
+
+  return true;
+}
+
+// Builds and publishes a flattened coverage of a validated lookup at `lookup_index`. The coverage is a union of
+// coverages of glyphs that can start a match of each lookup subtable, so if a glyph run has no glyph present in
+// the coverage, the lookup cannot change it and can be skipped.
+static BL_NOINLINE const uint32_t* build_lookup_coverage(const OTFaceImpl* ot_face_impl, LookupKind lookup_kind, uint32_t lookup_index, Table<GSubGPosTable::LookupTable> lookup_table) noexcept {
+  const uint32_t* any_glyph_coverage = LayoutData::any_glyph_coverage();
+  uint32_t glyph_count = ot_face_impl->face_info.glyph_count;
+
+  if (!glyph_count)
+    return ot_face_impl->layout.commit_lookup_coverage(lookup_kind, lookup_index, any_glyph_coverage);
+
+  // Don't commit anything if the allocation failed, the next attempt would try again.
+  uint32_t* bits = static_cast<uint32_t*>(calloc((glyph_count + 31u) / 32u, sizeof(uint32_t)));
+  if (BL_UNLIKELY(!bits))
+    return any_glyph_coverage;
+
+  uint32_t extension_type = lookup_kind == LookupKind::kGSUB ? uint32_t(GSubTable::kLookupExtension) : uint32_t(GPosTable::kLookupExtension);
+  uint32_t lookup_type = lookup_table->lookup_type();
+  uint32_t lookup_entry_count = lookup_table->sub_table_offsets.count();
+  const Offset16* lookup_entry_offsets = lookup_table->sub_table_offsets.array();
+
+  for (uint32_t i = 0; i < lookup_entry_count; i++) {
+    RawTable lookup_header = lookup_table.sub_table(lookup_entry_offsets[i].value());
+    uint32_t subtable_type = lookup_type;
+
+    if (lookup_type == extension_type) {
+      Table<GSubGPosTable::ExtensionLookup> extension_table(lookup_header);
+      if (!extension_table.fits()) {
+        lookup_header.reset();
+      }
+      else {
+        subtable_type = extension_table->lookup_type();
+        lookup_header = extension_table.sub_table(extension_table->offset());
+      }
+    }
+
+    uint32_t coverage_offset = 0u;
+    if (lookup_header.fits(GSubGPosTable::LookupHeader::kBaseSize))
+      coverage_offset = first_glyph_coverage_offset(lookup_header, lookup_kind, subtable_type, lookup_header.readU16(0u));
+
+    if (!coverage_offset || !add_coverage_to_bits(lookup_header.sub_table(coverage_offset), bits, glyph_count)) {
+      free(bits);
+      return ot_face_impl->layout.commit_lookup_coverage(lookup_kind, lookup_index, any_glyph_coverage);
+    }
+  }
+
+  return ot_face_impl->layout.commit_lookup_coverage(lookup_kind, lookup_index, bits);
+}
+
+// Tests whether any glyph of `glyph_data` is present in a flattened lookup `coverage` having `glyph_count` bits.
+static BL_INLINE bool lookup_coverage_matches_any(const uint32_t* coverage, uint32_t glyph_count, const BLGlyphId* glyph_data, size_t size) noexcept {
+  if (coverage == LayoutData::any_glyph_coverage())
+    return true;
+
+  for (size_t i = 0; i < size; i++) {
+    BLGlyphId glyph_id = glyph_data[i];
+    if (glyph_id >= glyph_count || BitArrayOps::bit_array_test_bit(coverage, glyph_id))
+      return true;
+  }
+
+  return false;
+}
+
 // bl::OpenType::LayoutImpl - Apply
 // ================================
 
@@ -3413,6 +3546,7 @@ static BLResult BL_CDECL apply_lookups(const BLFontFaceImpl* face_impl, BLGlyphB
 
   bool did_process_lookup = false;
   uint32_t word_count = uint32_t(bl_min<size_t>(bit_word_count, layout_data.lookup_status_data_size));
+  uint32_t glyph_count = ot_face_impl->face_info.glyph_count;
 
   for (uint32_t word_index = 0; word_index < word_count; word_index++) {
     uint32_t lookup_bits = bit_words[word_index];
@@ -3450,6 +3584,22 @@ static BLResult BL_CDECL apply_lookups(const BLFontFaceImpl* face_impl, BLGlyphB
       uint32_t lookup_flags = lookup_table->lookup_flags();
       BL_ASSERT_VALIDATED(lookup_type - 1u < uint32_t(lookup_info.lookup_max_value));
 
+      // Skip the lookup if none of the glyphs can start a match - testing a bit per glyph is much cheaper than
+      // searching coverage tables of all lookup subtables, which would be done by the lookup itself.
+      const uint32_t* lookup_coverage = ot_face_impl->layout.get_lookup_coverage(kLookupKind, lookup_table_index);
+      if (BL_UNLIKELY(!lookup_coverage))
+        lookup_coverage = build_lookup_coverage(ot_face_impl, kLookupKind, lookup_table_index, lookup_table);
+
+      if (!lookup_coverage_matches_any(lookup_coverage, glyph_count, ctx.glyph_data(), ctx.size()))
+        continue;
+
+      // Subtables test the same bits at each glyph position before searching their coverage tables, so glyphs
+      // that no subtable covers are skipped even when the lookup matches somewhere in the run.
+      if (lookup_coverage == LayoutData::any_glyph_coverage())
+        ctx.set_lookup_coverage(nullptr, 0u);
+      else
+        ctx.set_lookup_coverage(lookup_coverage, glyph_count);
+
       uint32_t lookup_entry_count = lookup_table->sub_table_offsets.count();
       const Offset16* lookup_entry_offsets = lookup_table->sub_table_offsets.array();
 
@@ -3778,12 +3928,43 @@ static BLResult calculateGSubGPosPlan(const OTFaceImpl* ot_face_impl, const BLFo
   return BL_SUCCESS;
 }
 
+// Calculating a plan walks script, language system, and feature tables and tests each feature against the settings,
+// which would be repeated by each shaping call. Since fonts are mostly used with just a few feature settings, recently
+// calculated plans are cached per face and the least recently calculated plan is replaced when the cache is full.
+static BLResult calculate_cached_plan(const OTFaceImpl* ot_face_impl, const BLFontFeatureSettings& settings, LookupKind lookup_kind, BLBitArrayCore* plan) noexcept {
+  const LayoutData& layout = ot_face_impl->layout;
+  LayoutData::PlanEntry* entries = layout._plans[size_t(lookup_kind)];
+
+  {
+    BLLockGuard<BLMutex> guard(layout._plan_mutex);
+    for (uint32_t i = 0; i < LayoutData::kPlanCacheSize; i++) {
+      if (entries[i].valid && entries[i].settings.equals(settings))
+        return bl_bit_array_assign_weak(plan, &entries[i].plan);
+    }
+  }
+
+  BL_PROPAGATE(bl_bit_array_clear(plan));
+  BL_PROPAGATE(calculateGSubGPosPlan(ot_face_impl, settings, lookup_kind, plan));
+
+  BLLockGuard<BLMutex> guard(layout._plan_mutex);
+  uint32_t& replace_index = layout._plan_replace_index[size_t(lookup_kind)];
+
+  LayoutData::PlanEntry& entry = entries[replace_index];
+  replace_index = (replace_index + 1u) % LayoutData::kPlanCacheSize;
+
+  entry.settings.assign(settings);
+  entry.plan.assign(plan->dcast());
+  entry.valid = true;
+
+  return BL_SUCCESS;
+}
+
 BLResult calculate_gsub_plan(const OTFaceImpl* ot_face_impl, const BLFontFeatureSettings& settings, BLBitArrayCore* plan) noexcept {
-  return calculateGSubGPosPlan(ot_face_impl, settings, LookupKind::kGSUB, plan);
+  return calculate_cached_plan(ot_face_impl, settings, LookupKind::kGSUB, plan);
 }
 
 BLResult calculate_gpos_plan(const OTFaceImpl* ot_face_impl, const BLFontFeatureSettings& settings, BLBitArrayCore* plan) noexcept {
-  return calculateGSubGPosPlan(ot_face_impl, settings, LookupKind::kGPOS, plan);
+  return calculate_cached_plan(ot_face_impl, settings, LookupKind::kGPOS, plan);
 }
 
 // bl::OpenType::LayoutImpl - Init
@@ -7,11 +7,14 @@
 #define BLEND2D_OPENTYPE_OTLAYOUT_P_H_INCLUDED
 
 #include <blend2d/core/array.h>
+#include <blend2d/core/bitarray.h>
+#include <blend2d/core/fontfeaturesettings.h>
 #include <blend2d/core/glyphbuffer_p.h>
 #include <blend2d/opentype/otcore_p.h>
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/ptrops_p.h>
 #include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/mutex_p.h>
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_opentype_impl
@@ -173,6 +176,16 @@ public:
     uint16_t lookup_status_data_offset;
   };
 
+  //! Lookup plan calculated for specific feature settings.
+  struct PlanEntry {
+    BLFontFeatureSettings settings;
+    BLBitArray plan;
+    bool valid;
+  };
+
+  //! Number of lookup plans cached per lookup kind.
+  static constexpr uint32_t kPlanCacheSize = 4;
+
   //! \}
 
   //! \name Members
@@ -183,6 +196,18 @@ public:
   GSubGPos kinds[2];
   LookupStatusBits* _lookup_status_bits;
 
+  //! Flattened coverage of glyphs that can start a match of each lookup (GSUB lookups first, followed by GPOS
+  //! lookups). Each coverage is a bit array having a bit per glyph, which is built when the lookup is applied for
+  //! the first time, or \ref any_glyph_coverage if the lookup cannot be skipped based on its coverage.
+  const uint32_t** _lookup_coverage;
+
+  //! Protects cached lookup plans.
+  mutable BLMutex _plan_mutex;
+  //! Cached lookup plans of each lookup kind.
+  mutable PlanEntry _plans[2][kPlanCacheSize];
+  //! Index of a cached lookup plan to be replaced next (per lookup kind).
+  mutable uint32_t _plan_replace_index[2];
+
   //! \}
 
   //! \name Construction & Destruction
@@ -192,11 +217,24 @@ public:
     : tables{},
       gdef{},
       kinds{},
-      _lookup_status_bits(nullptr) {}
+      _lookup_status_bits(nullptr),
+      _lookup_coverage(nullptr),
+      _plans{},
+      _plan_replace_index{} {}
 
   BL_INLINE ~LayoutData() noexcept {
     if (_lookup_status_bits)
       free(_lookup_status_bits);
+
+    if (_lookup_coverage) {
+      size_t lookup_count = size_t(gsub().lookup_count) + size_t(gpos().lookup_count);
+      for (size_t i = 0; i < lookup_count; i++) {
+        const uint32_t* coverage = _lookup_coverage[i];
+        if (coverage && coverage != any_glyph_coverage())
+          free(const_cast<uint32_t*>(coverage));
+      }
+      free(_lookup_coverage);
+    }
   }
 
   //! \}
@@ -234,7 +272,14 @@ public:
     if (BL_UNLIKELY(!lookup_status_bits))
       return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
 
+    const uint32_t** lookup_coverage = static_cast<const uint32_t**>(calloc(size_t(gsub_lookup_count) + size_t(gpos_lookup_count), sizeof(uint32_t*)));
+    if (BL_UNLIKELY(!lookup_coverage)) {
+      free(lookup_status_bits);
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+    }
+
     _lookup_status_bits = lookup_status_bits;
+    _lookup_coverage = lookup_coverage;
     gsub().lookup_status_data_size = uint16_t(gsub_lookup_status_data_size);
     gsub().lookup_status_data_offset = uint16_t(0);
     gpos().lookup_status_data_size = uint16_t(gpos_lookup_status_data_size);
@@ -285,11 +330,47 @@ public:
   }
 
   //! \}
+
+  //! \name Lookup Coverage
+  //! \{
+
+  //! Coverage of lookups that can start a match at any glyph, thus they cannot be skipped.
+  static BL_INLINE const uint32_t* any_glyph_coverage() noexcept {
+    static const uint32_t any_glyph_coverage_data[1] = { 0xFFFFFFFFu };
+    return any_glyph_coverage_data;
+  }
+
+  //! Returns a flattened coverage of a lookup at `lookup_index` or null if it was not built yet.
+  BL_INLINE const uint32_t* get_lookup_coverage(LookupKind lookup_kind, uint32_t lookup_index) const noexcept {
+    BL_ASSERT(lookup_index < kinds[size_t(lookup_kind)].lookup_count);
+    size_t base = lookup_kind == LookupKind::kGSUB ? size_t(0) : size_t(gsub().lookup_count);
+    return bl_atomic_fetch_strong(&_lookup_coverage[base + lookup_index]);
+  }
+
+  //! Publishes a flattened `coverage` of a lookup at `lookup_index` - if another thread published a coverage of the
+  //! same lookup concurrently, `coverage` is released and the already published coverage is returned instead.
+  BL_INLINE const uint32_t* commit_lookup_coverage(LookupKind lookup_kind, uint32_t lookup_index, const uint32_t* coverage) const noexcept {
+    BL_ASSERT(lookup_index < kinds[size_t(lookup_kind)].lookup_count);
+    size_t base = lookup_kind == LookupKind::kGSUB ? size_t(0) : size_t(gsub().lookup_count);
+
+    const uint32_t* expected = nullptr;
+    if (bl_atomic_compare_exchange(&_lookup_coverage[base + lookup_index], &expected, coverage))
+      return coverage;
+
+    if (coverage != any_glyph_coverage())
+      free(const_cast<uint32_t*>(coverage));
+    return expected;
+  }
+
+  //! \}
 };
 
 namespace LayoutImpl {
 
+//! Calculates a GSUB lookup plan of the given feature `settings` - plans are cached per face, so only the first
+//! calculation of a plan for the same `settings` walks script, language, and feature tables.
 BLResult calculate_gsub_plan(const OTFaceImpl* ot_face_impl, const BLFontFeatureSettings& settings, BLBitArrayCore* plan) noexcept;
+//! Calculates a GPOS lookup plan of the given feature `settings`, see \ref calculate_gsub_plan().
 BLResult calculate_gpos_plan(const OTFaceImpl* ot_face_impl, const BLFontFeatureSettings& settings, BLBitArrayCore* plan) noexcept;
 BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables) noexcept;
 
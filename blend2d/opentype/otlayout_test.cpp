@@ -0,0 +1,155 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/bitarray_p.h>
+#include <blend2d/core/font.h>
+#include <blend2d/core/fontdata.h>
+#include <blend2d/core/fontface.h>
+#include <blend2d/core/glyphbuffer.h>
+#include <blend2d/opentype/otface_p.h>
+#include <blend2d/opentype/otlayout_p.h>
+
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+// bl::OpenType::LayoutImpl - Tests
+// ================================
+
+namespace bl::OpenType {
+namespace Tests {
+
+static void BL_CDECL count_debug_messages(const char* message, size_t size, void* user_data) noexcept {
+  bl_unused(message, size);
+  (*static_cast<uint32_t*>(user_data))++;
+}
+
+static void expect_same_shaping(const BLGlyphBuffer& gb, const BLGlyphBuffer& reference_gb) noexcept {
+  EXPECT_EQ(gb.size(), reference_gb.size());
+
+  for (size_t i = 0; i < bl_min(gb.size(), reference_gb.size()); i++) {
+    const BLGlyphPlacement& placement = gb.placement_data()[i];
+    const BLGlyphPlacement& reference_placement = reference_gb.placement_data()[i];
+
+    EXPECT_EQ(gb.content()[i], reference_gb.content()[i]).message("Glyph #%zu differs", i);
+    EXPECT_EQ(placement.placement, reference_placement.placement).message("Placement of glyph #%zu differs", i);
+    EXPECT_EQ(placement.advance, reference_placement.advance).message("Advance of glyph #%zu differs", i);
+  }
+}
+
+UNIT(opentype_layout, BL_TEST_GROUP_TEXT_OPENTYPE) {
+  BLFontData font_data;
+  BLFontFace face;
+  BLFont font;
+
+  EXPECT_SUCCESS(font_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)));
+  EXPECT_SUCCESS(face.create_from_data(font_data, 0));
+  EXPECT_SUCCESS(font.create_from_face(face, 20.0f));
+
+  const OTFaceImpl* ot_face_impl = static_cast<const OTFaceImpl*>(face._d.impl);
+  const LayoutData& layout = ot_face_impl->layout;
+
+  // ABeeZee provides a single GPOS lookup (pair adjustment used by 'kern' feature) and no GSUB lookups.
+  EXPECT_EQ(layout.gsub().lookup_count, 0u);
+  EXPECT_EQ(layout.gpos().lookup_count, 1u);
+
+  INFO("Testing whether lookup plans are cached per feature settings");
+  {
+    BLBitArray plan1;
+    BLBitArray plan2;
+
+    EXPECT_SUCCESS(LayoutImpl::calculate_gpos_plan(ot_face_impl, font.feature_settings(), &plan1));
+    EXPECT_TRUE(layout._plans[size_t(LookupKind::kGPOS)][0].valid);
+
+    EXPECT_SUCCESS(LayoutImpl::calculate_gpos_plan(ot_face_impl, font.feature_settings(), &plan2));
+    EXPECT_FALSE(layout._plans[size_t(LookupKind::kGPOS)][1].valid);
+
+    EXPECT_TRUE(plan1.equals(plan2));
+    EXPECT_TRUE(plan1.has_bit(0));
+  }
+
+  INFO("Testing whether lookups are applied after their coverage is flattened");
+  {
+    BLFontFeatureSettings feature_settings;
+    EXPECT_SUCCESS(feature_settings.set_value(BL_MAKE_TAG('k', 'e', 'r', 'n'), 0u));
+
+    BLFont unkerned_font;
+    EXPECT_SUCCESS(unkerned_font.create_from_face(face, 20.0f, feature_settings));
+
+    BLGlyphBuffer kerned;
+    BLGlyphBuffer unkerned;
+
+    EXPECT_NULL(layout.get_lookup_coverage(LookupKind::kGPOS, 0));
+
+    EXPECT_SUCCESS(kerned.set_utf8_text("AVAV"));
+    EXPECT_SUCCESS(font.shape(kerned));
+
+    EXPECT_SUCCESS(unkerned.set_utf8_text("AVAV"));
+    EXPECT_SUCCESS(unkerned_font.shape(unkerned));
+
+    const uint32_t* coverage = layout.get_lookup_coverage(LookupKind::kGPOS, 0);
+    EXPECT_NOT_NULL(coverage);
+    EXPECT_NE(coverage, LayoutData::any_glyph_coverage());
+    EXPECT_TRUE(BitArrayOps::bit_array_test_bit(coverage, kerned.content()[0]));
+
+    EXPECT_EQ(kerned.size(), unkerned.size());
+    EXPECT_NE(kerned.placement_data()[0].advance.x, unkerned.placement_data()[0].advance.x);
+  }
+
+  INFO("Testing whether lookups are skipped for glyphs outside of their coverage");
+  {
+    // The reference face has its lookup coverage replaced by 'any glyph' coverage, so its lookups are never skipped.
+    BLFontFace reference_face;
+    BLFont reference_font;
+
+    EXPECT_SUCCESS(reference_face.create_from_data(font_data, 0));
+    EXPECT_SUCCESS(reference_font.create_from_face(reference_face, 20.0f));
+
+    const OTFaceImpl* reference_face_impl = static_cast<const OTFaceImpl*>(reference_face._d.impl);
+    const uint32_t* any_glyph_coverage = LayoutData::any_glyph_coverage();
+    EXPECT_EQ(reference_face_impl->layout.commit_lookup_coverage(LookupKind::kGPOS, 0, any_glyph_coverage), any_glyph_coverage);
+
+    // Digits are not kerned by ABeeZee, so the lookup is skipped for the whole run - nothing is reported to the
+    // debug sink, which is only used when a lookup is applied.
+    static const char uncovered_text[] = "1024 75";
+    uint32_t message_count = 0;
+    uint32_t reference_message_count = 0;
+
+    BLGlyphBuffer gb;
+    BLGlyphBuffer reference_gb;
+
+    EXPECT_SUCCESS(gb.set_debug_sink(count_debug_messages, &message_count));
+    EXPECT_SUCCESS(gb.set_utf8_text(uncovered_text));
+    EXPECT_SUCCESS(font.shape(gb));
+
+    EXPECT_SUCCESS(reference_gb.set_debug_sink(count_debug_messages, &reference_message_count));
+    EXPECT_SUCCESS(reference_gb.set_utf8_text(uncovered_text));
+    EXPECT_SUCCESS(reference_font.shape(reference_gb));
+
+    EXPECT_EQ(message_count, 0u);
+    EXPECT_GT(reference_message_count, 0u);
+    expect_same_shaping(gb, reference_gb);
+
+    // The lookup is applied to a paragraph that has both kerned and not kerned glyphs, subtables skip positions
+    // that are not covered, which must not change the result.
+    static const char paragraph[] = "Typography: AVAV To Ta Te Yo WA 1024 px, 75 %. ";
+
+    EXPECT_SUCCESS(gb.reset_debug_sink());
+    EXPECT_SUCCESS(gb.set_utf8_text(paragraph));
+    EXPECT_SUCCESS(font.shape(gb));
+
+    EXPECT_SUCCESS(reference_gb.reset_debug_sink());
+    EXPECT_SUCCESS(reference_gb.set_utf8_text(paragraph));
+    EXPECT_SUCCESS(reference_font.shape(reference_gb));
+
+    expect_same_shaping(gb, reference_gb);
+  }
+}
+
+} // {Tests}
+} // {bl::OpenType}
+
+#endif // BL_TEST
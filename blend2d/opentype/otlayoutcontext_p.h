@@ -8,6 +8,7 @@
 
 #include <blend2d/opentype/otcore_p.h>
 #include <blend2d/opentype/otlayout_p.h>
+#include <blend2d/support/bitops_p.h>
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_opentype_impl
@@ -15,6 +16,23 @@
 
 namespace bl::OpenType {
 
+//! Tests whether a glyph can start a match of a lookup subtable.
+//!
+//! Combines a glyph range of the subtable coverage with a flattened coverage of the whole lookup (see
+//! \ref LayoutData::get_lookup_coverage()), so glyphs that no subtable of the lookup covers are skipped by
+//! testing a single bit instead of searching the coverage table.
+struct CoverageFilter {
+  GlyphRange range;
+  //! Flattened lookup coverage, only used if `bit_count` is non-zero.
+  const uint32_t* bits;
+  //! Number of glyphs represented by `bits` - glyphs outside of the bit array are always considered covered.
+  uint32_t bit_count;
+
+  BL_INLINE_NODEBUG bool contains(BLGlyphId glyph_id) const noexcept {
+    return range.contains(glyph_id) && (glyph_id >= bit_count || BitArrayOps::bit_array_test_bit(bits, glyph_id));
+  }
+};
+
 //! A context used for OpenType glyph substitution (GSUB) processing.
 struct GSubContext {
   enum class AllocMode {
@@ -45,6 +63,11 @@ struct GSubContext {
   DebugSink _debug_sink;
   PrepareOutputBufferFunc _prepare_output_buffer;
 
+  //! Flattened coverage of the lookup being applied (see \ref CoverageFilter).
+  const uint32_t* _lookup_coverage;
+  //! Number of glyphs represented by `_lookup_coverage`, zero if the lookup cannot be filtered.
+  uint32_t _lookup_coverage_size;
+
   //! \}
 
   //! \name Accessors
@@ -60,6 +83,15 @@ struct GSubContext {
   BL_INLINE size_t size() const noexcept { return _work_buffer.size; }
   BL_INLINE size_t capacity() const noexcept { return _work_buffer.capacity; }
 
+  BL_INLINE void set_lookup_coverage(const uint32_t* coverage, uint32_t coverage_size) noexcept {
+    _lookup_coverage = coverage;
+    _lookup_coverage_size = coverage_size;
+  }
+
+  BL_INLINE CoverageFilter coverage_filter(const GlyphRange& range) const noexcept {
+    return CoverageFilter{range, _lookup_coverage, _lookup_coverage_size};
+  }
+
   BL_INLINE void truncate(size_t new_size) noexcept {
     BL_ASSERT(new_size <= _work_buffer.size);
     _work_buffer.size = new_size;
@@ -126,6 +158,7 @@ struct GSubContextNested : public GSubContext {
     // Initialize GSubContext.
     _debug_sink.init(gbd->debug_sink, gbd->debug_sink_user_data);
     _prepare_output_buffer = prepare_output_buffer_impl;
+    set_lookup_coverage(nullptr, 0u);
 
     // Initialize GSubContextNested.
     _next_nested_buffer_id = 0;
@@ -183,6 +216,7 @@ struct GSubContextPrimary : public GSubContext {
     _work_buffer.info_data = gbd->info_data;
     _work_buffer.size = gbd->size;
     _work_buffer.capacity = gbd->capacity[0];
+    set_lookup_coverage(nullptr, 0u);
 
     // Initialize GSubContextPrimary.
     _gbd = gbd;
@@ -227,9 +261,15 @@ struct GPosContext {
   DebugSink _debug_sink;
   BLGlyphBufferPrivateImpl* _gbd;
 
+  //! Flattened coverage of the lookup being applied (see \ref CoverageFilter).
+  const uint32_t* _lookup_coverage;
+  //! Number of glyphs represented by `_lookup_coverage`, zero if the lookup cannot be filtered.
+  uint32_t _lookup_coverage_size;
+
   BL_INLINE void init(BLGlyphBufferPrivateImpl* gbd) noexcept {
     _gbd = gbd;
     _debug_sink.init(gbd->debug_sink, gbd->debug_sink_user_data);
+    set_lookup_coverage(nullptr, 0u);
 
     _work_buffer.glyph_data = gbd->content;
     _work_buffer.info_data = gbd->info_data;
@@ -248,6 +288,15 @@ struct GPosContext {
 
   BL_INLINE bool is_empty() const noexcept { return _work_buffer.size == 0u; }
   BL_INLINE size_t size() const noexcept { return _work_buffer.size; }
+
+  BL_INLINE void set_lookup_coverage(const uint32_t* coverage, uint32_t coverage_size) noexcept {
+    _lookup_coverage = coverage;
+    _lookup_coverage_size = coverage_size;
+  }
+
+  BL_INLINE CoverageFilter coverage_filter(const GlyphRange& range) const noexcept {
+    return CoverageFilter{range, _lookup_coverage, _lookup_coverage_size};
+  }
 };
 
 } // {bl::OpenType}
@@ -0,0 +1,842 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/fontvariationsettings_p.h>
+#include <blend2d/core/trace_p.h>
+#include <blend2d/opentype/otface_p.h>
+#include <blend2d/opentype/otvar_p.h>
+#include <blend2d/support/math_p.h>
+#include <blend2d/support/memops_p.h>
+#include <blend2d/support/ptrops_p.h>
+
+namespace bl::OpenType {
+
+// bl::OpenType::VarOutlineCache - Interface
+// =========================================
+
+bool VarOutlineCache::get(const FontVariationCoords& coords, BLGlyphId glyph_id, BLPath& path_out, size_t& contour_count_out) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  Instance* instance = _find_instance(coords);
+  Node* node = instance ? _map.get(KeyMatcher{instance->id, glyph_id}) : nullptr;
+
+  if (!node) {
+    _miss_count++;
+    return false;
+  }
+
+  _hit_count++;
+  path_out = node->path;
+  contour_count_out = node->contour_count;
+  return true;
+}
+
+BLResult VarOutlineCache::put(const FontVariationCoords& coords, BLGlyphId glyph_id, const BLPath& path, size_t contour_count) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  Instance* instance = _find_instance(coords);
+  if (!instance) {
+    if (_instance_count == kMaxInstances)
+      _evict_instance(_instance_count - 1u);
+
+    // The new instance becomes the most recently used one.
+    memmove(_instances + 1, _instances, _instance_count * sizeof(Instance));
+    _instance_count++;
+
+    instance = &_instances[0];
+    instance->id = ++_instance_id_counter;
+    instance->coords = coords;
+  }
+
+  // Evict least recently used instances if the cache is full, but never the instance being inserted to.
+  while (_map.size() >= kCountLimit && _instance_count > 1u)
+    _evict_instance(_instance_count - 1u);
+
+  if (_map.size() >= kCountLimit)
+    return BL_SUCCESS;
+
+  KeyMatcher matcher{instance->id, glyph_id};
+
+  // Another thread could have inserted the same outline while this one was decoding it.
+  if (_map.get(matcher))
+    return BL_SUCCESS;
+
+  Node* node = _node_pool.alloc(_allocator);
+  if (BL_UNLIKELY(!node))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  bl_call_ctor(*node, matcher.hash_code(), instance->id, glyph_id, path, contour_count);
+  _map.insert(node);
+  return BL_SUCCESS;
+}
+
+void VarOutlineCache::clear() noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  _map.for_each([&](Node* node) {
+    _map.remove(node);
+    bl_call_dtor(*node);
+  });
+
+  _map.reset();
+  _node_pool.reset();
+  _allocator.reset();
+  _instance_count = 0;
+}
+
+// bl::OpenType::VarOutlineCache - Internals
+// =========================================
+
+VarOutlineCache::Instance* VarOutlineCache::_find_instance(const FontVariationCoords& coords) noexcept {
+  for (uint32_t i = 0; i < _instance_count; i++) {
+    if (_instances[i].coords.equals(coords)) {
+      // Keep the instances ordered from the most recently used to the least recently used.
+      if (i != 0) {
+        Instance instance = _instances[i];
+        memmove(_instances + 1, _instances, i * sizeof(Instance));
+        _instances[0] = instance;
+      }
+      return &_instances[0];
+    }
+  }
+
+  return nullptr;
+}
+
+void VarOutlineCache::_evict_instance(uint32_t index) noexcept {
+  BL_ASSERT(index < _instance_count);
+  uint32_t instance_id = _instances[index].id;
+
+  _map.for_each([&](Node* node) {
+    if (node->instance_id == instance_id) {
+      _map.remove(node);
+      bl_call_dtor(*node);
+      _node_pool.free(node);
+    }
+  });
+
+  _instance_count--;
+  memmove(_instances + index, _instances + index + 1, (_instance_count - index) * sizeof(Instance));
+}
+
+namespace VarImpl {
+
+// bl::OpenType::VarImpl - Trace
+// =============================
+
+#if defined(BL_TRACE_OT_ALL) || defined(BL_TRACE_OT_VAR)
+#define Trace BLDebugTrace
+#else
+#define Trace BLDummyTrace
+#endif
+
+// bl::OpenType::VarImpl - Region Scalars
+// ======================================
+
+// Calculates a factor of a single axis of a variation region. All values are F2Dot14.
+static BL_INLINE double calc_axis_factor(int coord, int start, int peak, int end) noexcept {
+  if (peak == 0 || coord == peak)
+    return 1.0;
+
+  // Invalid regions are ignored (the axis doesn't contribute to the scalar).
+  if (start > peak || peak > end || (start < 0 && end > 0))
+    return 1.0;
+
+  if (coord <= start || coord >= end)
+    return 0.0;
+
+  if (coord < peak)
+    return double(coord - start) / double(peak - start);
+  else
+    return double(end - coord) / double(end - peak);
+}
+
+double calc_tuple_scalar(const FontVariationCoords& coords, const uint8_t* peak, const uint8_t* start, const uint8_t* end, bool intermediate) noexcept {
+  double scalar = 1.0;
+
+  for (uint32_t i = 0; i < coords.axis_count; i++) {
+    int p = MemOps::readI16uBE(peak + i * 2u);
+    if (p == 0)
+      continue;
+
+    int c = coords.values[i];
+    int s = p < 0 ? p : 0;
+    int e = p < 0 ? 0 : p;
+
+    if (intermediate) {
+      s = MemOps::readI16uBE(start + i * 2u);
+      e = MemOps::readI16uBE(end + i * 2u);
+    }
+
+    // A region that spans from zero to the peak includes the peak itself, which is handled by `calc_axis_factor()`.
+    double factor = calc_axis_factor(c, s, p, e);
+    if (factor == 0.0)
+      return 0.0;
+
+    scalar *= factor;
+  }
+
+  return scalar;
+}
+
+uint32_t calc_region_scalars(RawTable store, uint32_t outer_index, const FontVariationCoords* coords, double* scalars_out, uint32_t scalars_capacity) noexcept {
+  // ItemVariationStore:
+  //   UInt16 format;
+  //   Offset32 variation_region_list_offset;
+  //   UInt16 item_variation_data_count;
+  //   Offset32 item_variation_data_offsets[item_variation_data_count];
+  if (store.size < 8u)
+    return 0;
+
+  uint32_t region_list_offset = MemOps::readU32uBE(store.data + 2);
+  uint32_t data_count = MemOps::readU16uBE(store.data + 6);
+
+  if (outer_index >= data_count || 8u + data_count * 4u > store.size)
+    return 0;
+
+  uint32_t data_offset = MemOps::readU32uBE(store.data + 8u + outer_index * 4u);
+  if (data_offset > store.size - 6u || region_list_offset > store.size - 4u)
+    return 0;
+
+  // ItemVariationData:
+  //   UInt16 item_count;
+  //   UInt16 word_delta_count;
+  //   UInt16 region_index_count;
+  //   UInt16 region_indexes[region_index_count];
+  const uint8_t* data = store.data + data_offset;
+  uint32_t region_index_count = MemOps::readU16uBE(data + 4);
+
+  if (region_index_count > scalars_capacity || region_index_count * 2u > store.size - data_offset - 6u)
+    return 0;
+
+  // VariationRegionList:
+  //   UInt16 axis_count;
+  //   UInt16 region_count;
+  //   RegionAxisCoordinates regions[region_count][axis_count] { F2Dot14 start, peak, end; };
+  const uint8_t* region_list = store.data + region_list_offset;
+  uint32_t axis_count = MemOps::readU16uBE(region_list + 0);
+  uint32_t region_count = MemOps::readU16uBE(region_list + 2);
+  size_t region_size = size_t(axis_count) * 6u;
+
+  if (size_t(region_count) * region_size > size_t(store.size - region_list_offset - 4u))
+    region_count = 0;
+
+  for (uint32_t i = 0; i < region_index_count; i++) {
+    uint32_t region_index = MemOps::readU16uBE(data + 6u + i * 2u);
+    double scalar = 0.0;
+
+    if (coords && region_index < region_count) {
+      const uint8_t* region = region_list + 4u + region_index * region_size;
+      uint32_t n = bl_min(axis_count, coords->axis_count);
+
+      scalar = 1.0;
+      for (uint32_t a = 0; a < n && scalar != 0.0; a++, region += 6) {
+        scalar *= calc_axis_factor(coords->values[a], MemOps::readI16uBE(region + 0), MemOps::readI16uBE(region + 2), MemOps::readI16uBE(region + 4));
+      }
+    }
+
+    scalars_out[i] = scalar;
+  }
+
+  return region_index_count;
+}
+
+// bl::OpenType::VarImpl - Packed Data
+// ===================================
+
+static bool decode_packed_points(const uint8_t*& ptr, const uint8_t* end, uint16_t* points, size_t capacity, size_t& count_out, bool& all_points_out) noexcept {
+  if (ptr == end)
+    return false;
+
+  size_t count = *ptr++;
+  if (count == 0) {
+    count_out = 0;
+    all_points_out = true;
+    return true;
+  }
+
+  if (count & TupleVariation::kPointsAreWords) {
+    if (ptr == end)
+      return false;
+    count = ((count & TupleVariation::kPointRunCountMask) << 8) | *ptr++;
+  }
+
+  if (count > capacity)
+    return false;
+
+  size_t i = 0;
+  uint32_t point = 0;
+
+  while (i < count) {
+    if (ptr == end)
+      return false;
+
+    uint32_t control = *ptr++;
+    size_t run_count = (control & TupleVariation::kPointRunCountMask) + 1u;
+    size_t value_size = (control & TupleVariation::kPointsAreWords) ? 2u : 1u;
+
+    if (run_count > count - i || size_t(end - ptr) < run_count * value_size)
+      return false;
+
+    for (size_t j = 0; j < run_count; j++, i++) {
+      point += value_size == 2u ? MemOps::readU16uBE(ptr) : uint32_t(ptr[0]);
+      points[i] = uint16_t(point);
+      ptr += value_size;
+    }
+  }
+
+  count_out = count;
+  all_points_out = false;
+  return true;
+}
+
+static bool decode_packed_deltas(const uint8_t*& ptr, const uint8_t* end, double* deltas, size_t count) noexcept {
+  size_t i = 0;
+
+  while (i < count) {
+    if (ptr == end)
+      return false;
+
+    uint32_t control = *ptr++;
+    size_t run_count = (control & TupleVariation::kDeltaRunCountMask) + 1u;
+
+    if (run_count > count - i)
+      return false;
+
+    switch (control & (TupleVariation::kDeltasAreZero | TupleVariation::kDeltasAreWords)) {
+      case 0: {
+        if (size_t(end - ptr) < run_count)
+          return false;
+
+        for (size_t j = 0; j < run_count; j++)
+          deltas[i++] = double(MemOps::readI8(ptr + j));
+        ptr += run_count;
+        break;
+      }
+
+      case TupleVariation::kDeltasAreWords: {
+        if (size_t(end - ptr) < run_count * 2u)
+          return false;
+
+        for (size_t j = 0; j < run_count; j++)
+          deltas[i++] = double(MemOps::readI16uBE(ptr + j * 2u));
+        ptr += run_count * 2u;
+        break;
+      }
+
+      case TupleVariation::kDeltasAreZero: {
+        for (size_t j = 0; j < run_count; j++)
+          deltas[i++] = 0.0;
+        break;
+      }
+
+      default: {
+        // Both flags set means 32-bit deltas.
+        if (size_t(end - ptr) < run_count * 4u)
+          return false;
+
+        for (size_t j = 0; j < run_count; j++)
+          deltas[i++] = double(MemOps::readI32uBE(ptr + j * 4u));
+        ptr += run_count * 4u;
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
+// bl::OpenType::VarImpl - Glyph Deltas
+// ====================================
+
+// Infers a delta of an untouched point at `coord` from two touched points (reference coordinates and their deltas).
+static BL_INLINE double infer_delta(double coord, double c1, double c2, double d1, double d2) noexcept {
+  if (c1 == c2)
+    return d1 == d2 ? d1 : 0.0;
+
+  if (c1 > c2) {
+    BLInternal::swap(c1, c2);
+    BLInternal::swap(d1, d2);
+  }
+
+  if (coord <= c1)
+    return d1;
+
+  if (coord >= c2)
+    return d2;
+
+  return d1 + (coord - c1) * (d2 - d1) / (c2 - c1);
+}
+
+// Interpolates deltas of untouched points (IUP) of a single contour [start, end].
+static void infer_contour_deltas(const BLPoint* orig, BLPoint* deltas, const uint8_t* touched, size_t start, size_t end) noexcept {
+  size_t first_touched = SIZE_MAX;
+  for (size_t i = start; i <= end; i++) {
+    if (touched[i]) {
+      first_touched = i;
+      break;
+    }
+  }
+
+  // No touched point means no deltas at all.
+  if (first_touched == SIZE_MAX)
+    return;
+
+  size_t cur = first_touched;
+  do {
+    // Find the next touched point (cyclic within the contour).
+    size_t next = cur;
+    do {
+      next = next == end ? start : next + 1u;
+    } while (!touched[next]);
+
+    // Infer all untouched points between `cur` and `next`.
+    size_t i = cur == end ? start : cur + 1u;
+    while (i != next) {
+      deltas[i].x = infer_delta(orig[i].x, orig[cur].x, orig[next].x, deltas[cur].x, deltas[next].x);
+      deltas[i].y = infer_delta(orig[i].y, orig[cur].y, orig[next].y, deltas[cur].y, deltas[next].y);
+      i = i == end ? start : i + 1u;
+    }
+
+    cur = next;
+  } while (cur != first_touched);
+}
+
+BLResult apply_glyph_deltas(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords& coords,
+  BLPoint* points,
+  size_t point_count,
+  const UInt16* contour_end_points,
+  size_t contour_count) noexcept {
+
+  RawTable gvar = ot_face_impl->var.gvar;
+  if (!gvar)
+    return BL_SUCCESS;
+
+  // NOTE: The header and offsets were already validated by `init()`.
+  const GVarTable* header = gvar.data_as<GVarTable>();
+  uint32_t axis_count = coords.axis_count;
+
+  if (glyph_id >= header->glyph_count())
+    return BL_SUCCESS;
+
+  uint32_t data_start;
+  uint32_t data_end;
+
+  if (header->flags() & GVarTable::kFlagLongOffsets) {
+    const uint8_t* offsets = gvar.data + sizeof(GVarTable) + size_t(glyph_id) * 4u;
+    data_start = MemOps::readU32uBE(offsets + 0);
+    data_end = MemOps::readU32uBE(offsets + 4);
+  }
+  else {
+    const uint8_t* offsets = gvar.data + sizeof(GVarTable) + size_t(glyph_id) * 2u;
+    data_start = MemOps::readU16uBE(offsets + 0) * 2u;
+    data_end = MemOps::readU16uBE(offsets + 2) * 2u;
+  }
+
+  // No variations of this glyph.
+  if (data_start >= data_end)
+    return BL_SUCCESS;
+
+  uint32_t array_offset = header->glyph_variation_data_array_offset();
+  if (BL_UNLIKELY(data_end > gvar.size - array_offset || data_end - data_start < 4u))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  // GlyphVariationData:
+  //   UInt16 tuple_variation_count;
+  //   Offset16 data_offset;
+  //   TupleVariationHeader tuple_variation_headers[tuple_count];
+  const uint8_t* data = gvar.data + array_offset + data_start;
+  size_t data_size = data_end - data_start;
+
+  uint32_t tuple_variation_count = MemOps::readU16uBE(data + 0);
+  uint32_t serialized_offset = MemOps::readU16uBE(data + 2);
+
+  if (BL_UNLIKELY(serialized_offset > data_size))
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  const uint8_t* header_ptr = data + 4;
+  const uint8_t* header_end = data + serialized_offset;
+  const uint8_t* serialized_ptr = data + serialized_offset;
+  const uint8_t* serialized_end = data + data_size;
+
+  const uint8_t* shared_tuples = gvar.data + header->shared_tuples_offset();
+  uint32_t shared_tuple_count = header->shared_tuple_count();
+  size_t tuple_size = size_t(axis_count) * 2u;
+
+  // Allocate temporary storage for original points, per-tuple deltas, point numbers, and touched flags.
+  ScopedBufferTmp<4096> buffer;
+  size_t buffer_size = point_count * (sizeof(BLPoint) * 2u + sizeof(double) * 2u + sizeof(uint16_t) * 2u + 1u);
+
+  uint8_t* buffer_ptr = static_cast<uint8_t*>(buffer.alloc(buffer_size));
+  if (BL_UNLIKELY(!buffer_ptr))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  BLPoint* orig = reinterpret_cast<BLPoint*>(buffer_ptr);
+  BLPoint* tuple_deltas = orig + point_count;
+  double* packed_deltas = reinterpret_cast<double*>(tuple_deltas + point_count);
+  uint16_t* shared_points = reinterpret_cast<uint16_t*>(packed_deltas + point_count * 2u);
+  uint16_t* private_points = shared_points + point_count;
+  uint8_t* touched = reinterpret_cast<uint8_t*>(private_points + point_count);
+
+  memcpy(orig, points, point_count * sizeof(BLPoint));
+
+  size_t shared_point_count = 0;
+  bool shared_all_points = true;
+
+  if (tuple_variation_count & TupleVariation::kSharedPointNumbers) {
+    if (BL_UNLIKELY(!decode_packed_points(serialized_ptr, serialized_end, shared_points, point_count, shared_point_count, shared_all_points)))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+  }
+
+  // Contour points exclude phantom points, which can only be moved by explicit deltas.
+  size_t contour_point_count = contour_count ? size_t(contour_end_points[contour_count - 1u].value()) + 1u : size_t(0);
+
+  for (uint32_t t = 0; t < (tuple_variation_count & TupleVariation::kCountMask); t++) {
+    // TupleVariationHeader:
+    //   UInt16 variation_data_size;
+    //   UInt16 tuple_index;
+    //   F2Dot14 peak_tuple[axis_count];            [if kEmbeddedPeakTuple]
+    //   F2Dot14 intermediate_start_tuple[axis_count]; [if kIntermediateRegion]
+    //   F2Dot14 intermediate_end_tuple[axis_count];   [if kIntermediateRegion]
+    if (BL_UNLIKELY(PtrOps::bytes_until(header_ptr, header_end) < 4u))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    uint32_t variation_data_size = MemOps::readU16uBE(header_ptr + 0);
+    uint32_t tuple_index = MemOps::readU16uBE(header_ptr + 2);
+    header_ptr += 4;
+
+    const uint8_t* peak = nullptr;
+    const uint8_t* start = nullptr;
+    const uint8_t* end = nullptr;
+
+    if (tuple_index & TupleVariation::kEmbeddedPeakTuple) {
+      if (BL_UNLIKELY(PtrOps::bytes_until(header_ptr, header_end) < tuple_size))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+      peak = header_ptr;
+      header_ptr += tuple_size;
+    }
+    else {
+      uint32_t shared_tuple_index = tuple_index & TupleVariation::kTupleIndexMask;
+      if (BL_UNLIKELY(shared_tuple_index >= shared_tuple_count))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+      peak = shared_tuples + shared_tuple_index * tuple_size;
+    }
+
+    if (tuple_index & TupleVariation::kIntermediateRegion) {
+      if (BL_UNLIKELY(PtrOps::bytes_until(header_ptr, header_end) < tuple_size * 2u))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+      start = header_ptr;
+      end = header_ptr + tuple_size;
+      header_ptr += tuple_size * 2u;
+    }
+
+    const uint8_t* tuple_ptr = serialized_ptr;
+    const uint8_t* tuple_end = serialized_ptr + variation_data_size;
+
+    if (BL_UNLIKELY(variation_data_size > PtrOps::bytes_until(serialized_ptr, serialized_end)))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+    serialized_ptr = tuple_end;
+
+    double scalar = calc_tuple_scalar(coords, peak, start, end, start != nullptr);
+    if (scalar == 0.0)
+      continue;
+
+    const uint16_t* point_numbers = shared_points;
+    size_t point_number_count = shared_point_count;
+    bool all_points = shared_all_points;
+
+    if (tuple_index & TupleVariation::kPrivatePointNumbers) {
+      if (BL_UNLIKELY(!decode_packed_points(tuple_ptr, tuple_end, private_points, point_count, point_number_count, all_points)))
+        return bl_make_error(BL_ERROR_INVALID_DATA);
+      point_numbers = private_points;
+    }
+
+    size_t delta_count = all_points ? point_count : point_number_count;
+    if (BL_UNLIKELY(!decode_packed_deltas(tuple_ptr, tuple_end, packed_deltas, delta_count) ||
+                    !decode_packed_deltas(tuple_ptr, tuple_end, packed_deltas + delta_count, delta_count)))
+      return bl_make_error(BL_ERROR_INVALID_DATA);
+
+    const double* dx = packed_deltas;
+    const double* dy = packed_deltas + delta_count;
+
+    if (all_points) {
+      for (size_t i = 0; i < point_count; i++) {
+        points[i].x += dx[i] * scalar;
+        points[i].y += dy[i] * scalar;
+      }
+      continue;
+    }
+
+    if (!contour_point_count) {
+      // Composite glyphs don't infer deltas of untouched points.
+      for (size_t i = 0; i < point_number_count; i++) {
+        size_t index = point_numbers[i];
+        if (index < point_count) {
+          points[index].x += dx[i] * scalar;
+          points[index].y += dy[i] * scalar;
+        }
+      }
+      continue;
+    }
+
+    memset(tuple_deltas, 0, point_count * sizeof(BLPoint));
+    memset(touched, 0, point_count);
+
+    for (size_t i = 0; i < point_number_count; i++) {
+      size_t index = point_numbers[i];
+      if (index < point_count) {
+        tuple_deltas[index].reset(dx[i], dy[i]);
+        touched[index] = 1;
+      }
+    }
+
+    size_t contour_start = 0;
+    for (size_t i = 0; i < contour_count; i++) {
+      size_t contour_end = contour_end_points[i].value();
+      if (contour_end >= contour_start && contour_end < contour_point_count)
+        infer_contour_deltas(orig, tuple_deltas, touched, contour_start, contour_end);
+      contour_start = contour_end + 1u;
+    }
+
+    for (size_t i = 0; i < point_count; i++) {
+      points[i].x += tuple_deltas[i].x * scalar;
+      points[i].y += tuple_deltas[i].y * scalar;
+    }
+  }
+
+  return BL_SUCCESS;
+}
+
+// bl::OpenType::VarImpl - Variation Coordinates
+// =============================================
+
+// Maps a normalized coordinate through 'avar' segment map (piecewise linear mapping of F2Dot14 values).
+static int map_avar_coord(const uint8_t* map, uint32_t map_count, int value) noexcept {
+  if (map_count == 0)
+    return value;
+
+  int from0 = MemOps::readI16uBE(map + 0);
+  int to0 = MemOps::readI16uBE(map + 2);
+
+  if (value <= from0)
+    return to0;
+
+  for (uint32_t i = 1; i < map_count; i++) {
+    int from1 = MemOps::readI16uBE(map + i * 4u + 0);
+    int to1 = MemOps::readI16uBE(map + i * 4u + 2);
+
+    if (value <= from1) {
+      if (from1 == from0)
+        return to1;
+      return to0 + int(Math::round(double(value - from0) * double(to1 - to0) / double(from1 - from0)));
+    }
+
+    from0 = from1;
+    to0 = to1;
+  }
+
+  return to0;
+}
+
+static BLResult BL_CDECL get_variation_coords(
+  const BLFontFaceImpl* face_impl,
+  const BLFontVariationSettingsCore* settings,
+  FontVariationCoords* coords_out) noexcept {
+
+  const OTFaceImpl* ot_face_impl = static_cast<const OTFaceImpl*>(face_impl);
+  const VarData& var = ot_face_impl->var;
+
+  BLFontVariationSettingsView view;
+  BL_PROPAGATE(bl_font_variation_settings_get_view(settings, &view));
+
+  uint32_t axis_count = var.axis_count;
+  coords_out->axis_count = axis_count;
+
+  for (uint32_t i = 0; i < axis_count; i++) {
+    const VarAxis& axis = var.axes[i];
+    double min_value = double(axis.min_value);
+    double default_value = double(axis.default_value);
+    double max_value = double(axis.max_value);
+    double value = default_value;
+
+    for (const BLFontVariationItem& item : view) {
+      if (item.tag == axis.tag) {
+        value = bl_clamp(double(item.value), min_value, max_value);
+        break;
+      }
+    }
+
+    double normalized = 0.0;
+    if (value < default_value)
+      normalized = (value - default_value) / (default_value - min_value);
+    else if (value > default_value)
+      normalized = (value - default_value) / (max_value - default_value);
+
+    coords_out->values[i] = int16_t(bl_clamp(int(Math::round(normalized * 16384.0)), -16384, 16384));
+  }
+
+  // Apply 'avar' mapping, which was validated by `init()`.
+  if (var.avar) {
+    const uint8_t* map = var.avar.data + sizeof(AVarTable);
+    for (uint32_t i = 0; i < axis_count; i++) {
+      uint32_t map_count = MemOps::readU16uBE(map);
+      coords_out->values[i] = int16_t(bl_clamp(map_avar_coord(map + 2, map_count, coords_out->values[i]), -16384, 16384));
+      map += 2u + map_count * 4u;
+    }
+  }
+
+  return BL_SUCCESS;
+}
+
+// bl::OpenType::VarImpl - GetGlyphOutlinesVar
+// ===========================================
+
+static BLResult BL_CDECL get_glyph_outlines_var(
+  const BLFontFaceImpl* face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords* coords,
+  const BLMatrix2D* transform,
+  BLPath* out,
+  size_t* contour_count_out,
+  ScopedBuffer* tmp_buffer) noexcept {
+
+  const OTFaceImpl* ot_face_impl = static_cast<const OTFaceImpl*>(face_impl);
+  VarOutlineCache& cache = const_cast<OTFaceImpl*>(ot_face_impl)->var_outline_cache;
+
+  *contour_count_out = 0;
+  if (BL_UNLIKELY(glyph_id >= ot_face_impl->face_info.glyph_count))
+    return bl_make_error(BL_ERROR_INVALID_GLYPH);
+
+  BLPath outline;
+  size_t contour_count = 0;
+
+  if (!cache.get(*coords, glyph_id, outline, contour_count)) {
+    BL_PROPAGATE(ot_face_impl->var.decode_outlines(ot_face_impl, glyph_id, coords, &outline, &contour_count, tmp_buffer));
+    BL_PROPAGATE(cache.put(*coords, glyph_id, outline, contour_count));
+  }
+
+  *contour_count_out = contour_count;
+  return out->add_path(outline, *transform);
+}
+
+// bl::OpenType::VarImpl - Init
+// ============================
+
+static bool init_avar(OTFaceImpl* ot_face_impl, Table<AVarTable> avar) noexcept {
+  if (!avar.fits() || avar->major_version() != 1 || avar->axis_count() != ot_face_impl->var.axis_count)
+    return false;
+
+  size_t offset = sizeof(AVarTable);
+  for (uint32_t i = 0; i < ot_face_impl->var.axis_count; i++) {
+    if (offset + 2u > avar.size)
+      return false;
+
+    uint32_t map_count = avar.readU16(offset);
+    offset += 2u + map_count * 4u;
+
+    if (offset > avar.size)
+      return false;
+  }
+
+  ot_face_impl->var.avar = avar;
+  return true;
+}
+
+static bool init_gvar(OTFaceImpl* ot_face_impl, Table<GVarTable> gvar) noexcept {
+  if (!gvar.fits() || gvar->major_version() != 1 || gvar->axis_count() != ot_face_impl->var.axis_count)
+    return false;
+
+  uint32_t glyph_count = gvar->glyph_count();
+  uint32_t offset_size = (gvar->flags() & GVarTable::kFlagLongOffsets) ? 4u : 2u;
+
+  if (sizeof(GVarTable) + (size_t(glyph_count) + 1u) * offset_size > gvar.size)
+    return false;
+
+  uint32_t shared_tuples_offset = gvar->shared_tuples_offset();
+  size_t shared_tuples_size = size_t(gvar->shared_tuple_count()) * gvar->axis_count() * 2u;
+
+  if (shared_tuples_offset > gvar.size || shared_tuples_size > gvar.size - shared_tuples_offset)
+    return false;
+
+  if (gvar->glyph_variation_data_array_offset() > gvar.size)
+    return false;
+
+  ot_face_impl->var.gvar = gvar;
+  return true;
+}
+
+BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables) noexcept {
+  Table<FVarTable> fvar(tables.fvar);
+  if (!fvar)
+    return BL_SUCCESS;
+
+  Trace trace;
+  trace.info("bl::OpenType::OTFaceImpl::InitVar [Size=%u]\n", fvar.size);
+  trace.indent();
+
+  // Invalid variation data is not fatal - the face is used as a static font in that case.
+  if (!fvar.fits() || fvar->major_version() != 1) {
+    trace.warn("Invalid 'fvar' table, ignoring variations\n");
+    return BL_SUCCESS;
+  }
+
+  uint32_t axis_count = fvar->axis_count();
+  uint32_t axis_size = fvar->axis_size();
+  uint32_t axes_offset = fvar->axes_array_offset();
+
+  if (axis_count == 0 || axis_count > kFontVariationMaxAxes || axis_size < sizeof(FVarTable::VariationAxisRecord) ||
+      axes_offset > fvar.size || size_t(axis_count) * axis_size > fvar.size - axes_offset) {
+    trace.warn("Invalid or unsupported axes [Count=%u Size=%u], ignoring variations\n", axis_count, axis_size);
+    return BL_SUCCESS;
+  }
+
+  VarData& var = ot_face_impl->var;
+  for (uint32_t i = 0; i < axis_count; i++) {
+    const FVarTable::VariationAxisRecord* record = fvar.data_as<FVarTable::VariationAxisRecord>(axes_offset + i * axis_size);
+    VarAxis& axis = var.axes[i];
+
+    axis.tag = record->axis_tag();
+    axis.min_value = float(double(int32_t(record->min_value())) * (1.0 / 65536.0));
+    axis.default_value = float(double(int32_t(record->default_value())) * (1.0 / 65536.0));
+    axis.max_value = float(double(int32_t(record->max_value())) * (1.0 / 65536.0));
+
+    // Axes that don't satisfy `min <= default <= max` are invalid and must be ignored (they stay at default).
+    if (!(axis.min_value <= axis.default_value && axis.default_value <= axis.max_value))
+      axis.min_value = axis.max_value = axis.default_value;
+
+    BL_PROPAGATE(ot_face_impl->variation_tag_set.add_tag(axis.tag));
+  }
+
+  var.axis_count = axis_count;
+  ot_face_impl->face_info.face_flags |= BL_FONT_FACE_FLAG_OPENTYPE_VARIATIONS;
+
+  if (tables.avar && !init_avar(ot_face_impl, tables.avar))
+    trace.warn("Invalid 'avar' table, ignoring axis mapping\n");
+
+  if (tables.gvar && ot_face_impl->face_info.outline_type == BL_FONT_OUTLINE_TYPE_TRUETYPE) {
+    if (init_gvar(ot_face_impl, tables.gvar))
+      var.decode_outlines = GlyfImpl::get_glyph_outlines_var;
+    else
+      trace.warn("Invalid 'gvar' table, ignoring glyph variations\n");
+  }
+  else if (ot_face_impl->face_info.outline_type == BL_FONT_OUTLINE_TYPE_CFF2 && var.cff2_var_store.size) {
+    var.decode_outlines = CFFImpl::get_glyph_outlines_var;
+  }
+
+  // Variable outlines are only provided if there is a decoder that can apply variation deltas.
+  if (var.decode_outlines) {
+    ot_face_impl->funcs.get_variation_coords = get_variation_coords;
+    ot_face_impl->funcs.get_glyph_outlines_var = get_glyph_outlines_var;
+  }
+
+  return BL_SUCCESS;
+}
+
+} // {VarImpl}
+} // {bl::OpenType}
@@ -0,0 +1,312 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_OPENTYPE_OTVAR_P_H_INCLUDED
+#define BLEND2D_OPENTYPE_OTVAR_P_H_INCLUDED
+
+#include <blend2d/core/fontface_p.h>
+#include <blend2d/core/path.h>
+#include <blend2d/opentype/otdefs_p.h>
+#include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/arenahashmap_p.h>
+#include <blend2d/support/ptrops_p.h>
+#include <blend2d/support/scopedbuffer_p.h>
+#include <blend2d/threading/mutex_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_opentype_impl
+//! \{
+
+namespace bl::OpenType {
+
+//! OpenType 'fvar' table.
+//!
+//! External Resources:
+//!   - https://docs.microsoft.com/en-us/typography/opentype/spec/fvar
+struct FVarTable {
+  enum : uint32_t { kBaseSize = 16 };
+
+  struct VariationAxisRecord {
+    UInt32 axis_tag;
+    F16x16 min_value;
+    F16x16 default_value;
+    F16x16 max_value;
+    UInt16 flags;
+    UInt16 axis_name_id;
+  };
+
+  UInt16 major_version;
+  UInt16 minor_version;
+  Offset16 axes_array_offset;
+  UInt16 reserved;
+  UInt16 axis_count;
+  UInt16 axis_size;
+  UInt16 instance_count;
+  UInt16 instance_size;
+};
+
+//! OpenType 'avar' table.
+//!
+//! External Resources:
+//!   - https://docs.microsoft.com/en-us/typography/opentype/spec/avar
+struct AVarTable {
+  enum : uint32_t { kBaseSize = 8 };
+
+  struct AxisValueMap {
+    F2x14 from_coordinate;
+    F2x14 to_coordinate;
+  };
+
+  UInt16 major_version;
+  UInt16 minor_version;
+  UInt16 reserved;
+  UInt16 axis_count;
+
+  /*
+  struct SegmentMaps {
+    UInt16 position_map_count;
+    AxisValueMap axis_value_maps[position_map_count];
+  } axis_segment_maps[axis_count];
+  */
+};
+
+//! OpenType 'gvar' table.
+//!
+//! External Resources:
+//!   - https://docs.microsoft.com/en-us/typography/opentype/spec/gvar
+//!   - https://docs.microsoft.com/en-us/typography/opentype/spec/otvarcommonformats
+struct GVarTable {
+  enum : uint32_t { kBaseSize = 20 };
+
+  enum Flags : uint16_t {
+    kFlagLongOffsets = 0x0001u
+  };
+
+  UInt16 major_version;
+  UInt16 minor_version;
+  UInt16 axis_count;
+  UInt16 shared_tuple_count;
+  Offset32 shared_tuples_offset;
+  UInt16 glyph_count;
+  UInt16 flags;
+  Offset32 glyph_variation_data_array_offset;
+
+  /*
+  union {
+    Offset16 glyph_variation_data_offsets16[glyph_count + 1];
+    Offset32 glyph_variation_data_offsets32[glyph_count + 1];
+  };
+  */
+};
+
+//! Constants used by tuple variation store ('gvar' and 'cvar' tables).
+struct TupleVariation {
+  enum : uint32_t {
+    // Tuple variation count.
+    kSharedPointNumbers   = 0x8000u,
+    kCountMask            = 0x0FFFu,
+
+    // Tuple index.
+    kEmbeddedPeakTuple    = 0x8000u,
+    kIntermediateRegion   = 0x4000u,
+    kPrivatePointNumbers  = 0x2000u,
+    kTupleIndexMask       = 0x0FFFu,
+
+    // Packed point numbers.
+    kPointsAreWords       = 0x80u,
+    kPointRunCountMask    = 0x7Fu,
+
+    // Packed deltas.
+    kDeltasAreZero        = 0x80u,
+    kDeltasAreWords       = 0x40u,
+    kDeltaRunCountMask    = 0x3Fu
+  };
+};
+
+//! Variation axis as defined by 'fvar' table.
+struct VarAxis {
+  BLTag tag;
+  float min_value;
+  float default_value;
+  float max_value;
+};
+
+//! Decodes unscaled outlines of a variable glyph - provided by either 'glyf' or 'CFF2' implementation.
+typedef BLResult (BL_CDECL* DecodeVarOutlinesFunc)(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords* coords,
+  BLPath* out,
+  size_t* contour_count_out,
+  ScopedBuffer* tmp_buffer) noexcept;
+
+//! Font variations data stored in \ref OTFaceImpl.
+struct VarData {
+  //! Number of variation axes (limited to \ref kFontVariationMaxAxes).
+  uint32_t axis_count;
+  //! Variation axes provided by 'fvar' table.
+  VarAxis axes[kFontVariationMaxAxes];
+
+  //! Content of 'avar' table (only if its axis count matches 'fvar').
+  RawTable avar;
+  //! Content of 'gvar' table (only if its axis count matches 'fvar').
+  RawTable gvar;
+  //! ItemVariationStore used by 'CFF2' table (blend operator).
+  RawTable cff2_var_store;
+
+  //! Decodes unscaled outlines of a variable glyph, null if the face has no variable outlines.
+  DecodeVarOutlinesFunc decode_outlines;
+};
+
+//! Thread-safe cache of unscaled glyph outlines of variable font instances.
+//!
+//! Applying variation deltas requires to decode the glyph, to interpolate all deltas of all matching regions, and
+//! to infer deltas of untouched points, which is much more expensive than decoding a static glyph. Outlines are thus
+//! cached per instance (normalized variation coordinates) in unscaled font units so the cache is shared by all fonts
+//! that use the same instance regardless of their size and transform. Only the most recently used instances are kept
+//! and the number of cached outlines is limited.
+class VarOutlineCache {
+public:
+  BL_NONCOPYABLE(VarOutlineCache)
+
+  //! Maximum number of instances that can have cached outlines.
+  static constexpr uint32_t kMaxInstances = 8;
+  //! Maximum number of cached outlines (of all instances).
+  static constexpr size_t kCountLimit = 8192;
+
+  class Node : public ArenaHashMapNode {
+  public:
+    BL_NONCOPYABLE(Node)
+
+    uint32_t instance_id;
+    BLGlyphId glyph_id;
+    size_t contour_count;
+    BLPath path;
+
+    BL_INLINE Node(uint32_t hash_code, uint32_t instance_id, BLGlyphId glyph_id, const BLPath& path, size_t contour_count) noexcept
+      : ArenaHashMapNode(hash_code),
+        instance_id(instance_id),
+        glyph_id(glyph_id),
+        contour_count(contour_count),
+        path(path) {}
+  };
+
+  struct KeyMatcher {
+    uint32_t _instance_id;
+    BLGlyphId _glyph_id;
+
+    BL_INLINE uint32_t hash_code() const noexcept { return (_instance_id * 0x9E3779B1u) ^ _glyph_id; }
+    BL_INLINE bool matches(const Node* node) const noexcept { return node->instance_id == _instance_id && node->glyph_id == _glyph_id; }
+  };
+
+  struct Instance {
+    uint32_t id;
+    FontVariationCoords coords;
+  };
+
+  //! \name Members
+  //! \{
+
+  BLMutex _mutex;
+  ArenaAllocator _allocator;
+  ArenaPool<Node> _node_pool;
+  ArenaHashMap<Node> _map;
+
+  //! Instances ordered from the most recently used to the least recently used.
+  Instance _instances[kMaxInstances];
+  uint32_t _instance_count = 0;
+  uint32_t _instance_id_counter = 0;
+
+  uint64_t _hit_count = 0;
+  uint64_t _miss_count = 0;
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE VarOutlineCache() noexcept
+    : _allocator(8192),
+      _map(&_allocator) {}
+
+  BL_INLINE ~VarOutlineCache() noexcept { clear(); }
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  BL_INLINE size_t size() noexcept { return _mutex.protect([&] { return _map.size(); }); }
+  BL_INLINE uint32_t instance_count() noexcept { return _mutex.protect([&] { return _instance_count; }); }
+  BL_INLINE uint64_t hit_count() noexcept { return _mutex.protect([&] { return _hit_count; }); }
+  BL_INLINE uint64_t miss_count() noexcept { return _mutex.protect([&] { return _miss_count; }); }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Looks up outlines of `glyph_id` of an instance described by `coords` and copies them to `path_out`.
+  BL_HIDDEN bool get(const FontVariationCoords& coords, BLGlyphId glyph_id, BLPath& path_out, size_t& contour_count_out) noexcept;
+
+  //! Inserts outlines of `glyph_id` of an instance described by `coords` into the cache.
+  BL_HIDDEN BLResult put(const FontVariationCoords& coords, BLGlyphId glyph_id, const BLPath& path, size_t contour_count) noexcept;
+
+  //! Removes all outlines and instances from the cache.
+  BL_HIDDEN void clear() noexcept;
+
+  //! \}
+
+  //! \name Internals
+  //! \{
+
+  BL_HIDDEN Instance* _find_instance(const FontVariationCoords& coords) noexcept;
+  BL_HIDDEN void _evict_instance(uint32_t index) noexcept;
+
+  //! \}
+};
+
+namespace VarImpl {
+
+//! Calculates a scalar of a region defined by `peak`, `start`, and `end` tuples (all F2Dot14) at `coords`.
+//!
+//! The `start` and `end` tuples are only used when `intermediate` is true, otherwise the region spans from zero
+//! to the peak (as used by 'gvar' tuples that don't specify an intermediate region).
+BL_HIDDEN double calc_tuple_scalar(const FontVariationCoords& coords, const uint8_t* peak, const uint8_t* start, const uint8_t* end, bool intermediate) noexcept;
+
+//! Applies 'gvar' deltas of `glyph_id` to `points`.
+//!
+//! The `points` array must contain `point_count` points, which includes 4 phantom points at the end. Contour end
+//! points are only provided by simple glyphs and are used to infer deltas of untouched points, composite glyphs
+//! use component offsets as points and pass zero `contour_count`.
+BL_HIDDEN BLResult apply_glyph_deltas(
+  const OTFaceImpl* ot_face_impl,
+  BLGlyphId glyph_id,
+  const FontVariationCoords& coords,
+  BLPoint* points,
+  size_t point_count,
+  const UInt16* contour_end_points,
+  size_t contour_count) noexcept;
+
+//! Calculates scalars of all regions referenced by ItemVariationData `outer_index` of ItemVariationStore `store`.
+//!
+//! Returns the number of regions stored to `scalars_out` or zero if the store doesn't provide `outer_index`. If
+//! `coords` is null (default instance) all scalars are zero.
+BL_HIDDEN uint32_t calc_region_scalars(
+  RawTable store,
+  uint32_t outer_index,
+  const FontVariationCoords* coords,
+  double* scalars_out,
+  uint32_t scalars_capacity) noexcept;
+
+BLResult init(OTFaceImpl* ot_face_impl, OTFaceTables& tables) noexcept;
+
+} // {VarImpl}
+} // {bl::OpenType}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_OPENTYPE_OTVAR_P_H_INCLUDED
@@ -0,0 +1,323 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/array.h>
+#include <blend2d/core/font.h>
+#include <blend2d/core/fontdata.h>
+#include <blend2d/core/fontface.h>
+#include <blend2d/core/glyphbuffer.h>
+#include <blend2d/core/path.h>
+#include <blend2d/opentype/otcore_p.h>
+#include <blend2d/opentype/otface_p.h>
+#include <blend2d/opentype/otglyf_p.h>
+#include <blend2d/opentype/otvar_p.h>
+#include <blend2d/support/memops_p.h>
+
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+// bl::OpenType::VarImpl - Tests
+// =============================
+
+namespace bl::OpenType {
+namespace Tests {
+
+// Glyph that receives variation deltas in the synthesized variable font.
+static constexpr uint32_t kVarGlyphChar = 'l';
+
+// Variation deltas of the first point of the glyph at the peak of 'wght' axis.
+static constexpr int kVarDeltaX = 100;
+static constexpr int kVarDeltaY = 50;
+
+class BEWriter {
+public:
+  BLArray<uint8_t>& _data;
+
+  BL_INLINE explicit BEWriter(BLArray<uint8_t>& data) noexcept
+    : _data(data) {}
+
+  BL_INLINE void u8(uint32_t value) noexcept { _data.append(uint8_t(value)); }
+  BL_INLINE void u16(uint32_t value) noexcept { u8(value >> 8); u8(value); }
+  BL_INLINE void u32(uint32_t value) noexcept { u16(value >> 16); u16(value); }
+
+  BL_INLINE void pad4() noexcept {
+    while (_data.size() & 3u)
+      u8(0);
+  }
+};
+
+// Creates 'fvar' table that describes a single 'wght' axis [100, 400, 900].
+static void create_fvar_table(BLArray<uint8_t>& out) noexcept {
+  BEWriter w(out);
+
+  w.u16(1);                   // major_version
+  w.u16(0);                   // minor_version
+  w.u16(FVarTable::kBaseSize);// axes_array_offset
+  w.u16(2);                   // reserved
+  w.u16(1);                   // axis_count
+  w.u16(20);                  // axis_size
+  w.u16(0);                   // instance_count
+  w.u16(8);                   // instance_size
+
+  w.u32(BL_MAKE_TAG('w', 'g', 'h', 't'));
+  w.u32(100u << 16);
+  w.u32(400u << 16);
+  w.u32(900u << 16);
+  w.u16(0);
+  w.u16(256);
+}
+
+// Creates 'gvar' table that only provides deltas of `glyph_id` - a single tuple that moves its first point, the
+// remaining points must be inferred from it.
+static void create_gvar_table(BLArray<uint8_t>& out, uint32_t glyph_count, BLGlyphId glyph_id) noexcept {
+  BEWriter w(out);
+
+  static const uint8_t glyph_data[] = {
+    0x00, 0x01,               // tuple_variation_count (1, no shared points)
+    0x00, 0x0A,               // data_offset
+    0x00, 0x07,               // variation_data_size
+    0xA0, 0x00,               // tuple_index (kEmbeddedPeakTuple | kPrivatePointNumbers)
+    0x40, 0x00,               // peak_tuple[wght] (1.0)
+
+    0x01, 0x00, 0x00,         // private point numbers: count=1, run of 1 byte, point #0
+    0x00, uint8_t(kVarDeltaX),// x deltas: run of 1 byte
+    0x00, uint8_t(kVarDeltaY),// y deltas: run of 1 byte
+    0x00                      // padding
+  };
+
+  uint32_t offsets_size = (glyph_count + 1u) * 4u;
+
+  w.u16(1);                   // major_version
+  w.u16(0);                   // minor_version
+  w.u16(1);                   // axis_count
+  w.u16(0);                   // shared_tuple_count
+  w.u32(GVarTable::kBaseSize + offsets_size);
+  w.u16(glyph_count);
+  w.u16(GVarTable::kFlagLongOffsets);
+  w.u32(GVarTable::kBaseSize + offsets_size);
+
+  for (uint32_t i = 0; i <= glyph_count; i++)
+    w.u32(i > glyph_id ? uint32_t(sizeof(glyph_data)) : 0u);
+
+  out.append_data(glyph_data, sizeof(glyph_data));
+}
+
+// Rebuilds the given SFNT font with additional tables.
+static void create_font_with_tables(BLArray<uint8_t>& out, const uint8_t* src, size_t src_size, const BLTag* tags, const BLArray<uint8_t>* tables, size_t added_count) noexcept {
+  const SFNTHeader* sfnt = reinterpret_cast<const SFNTHeader*>(src);
+  const SFNTHeader::TableRecord* records = sfnt->table_records();
+
+  uint32_t src_count = sfnt->num_tables();
+  uint32_t table_count = src_count + uint32_t(added_count);
+  uint32_t data_offset = uint32_t(sizeof(SFNTHeader) + table_count * sizeof(SFNTHeader::TableRecord));
+
+  BEWriter w(out);
+  w.u32(sfnt->version_tag());
+  w.u16(table_count);
+  w.u16(0);
+  w.u16(0);
+  w.u16(0);
+
+  // Table records.
+  uint32_t offset = data_offset;
+  for (uint32_t i = 0; i < table_count; i++) {
+    uint32_t size = i < src_count ? uint32_t(records[i].length()) : uint32_t(tables[i - src_count].size());
+    w.u32(i < src_count ? uint32_t(records[i].tag()) : tags[i - src_count]);
+    w.u32(0);
+    w.u32(offset);
+    w.u32(size);
+    offset += (size + 3u) & ~3u;
+  }
+
+  // Table data.
+  for (uint32_t i = 0; i < table_count; i++) {
+    if (i < src_count) {
+      uint32_t table_offset = records[i].offset();
+      uint32_t table_size = records[i].length();
+      EXPECT_LE(size_t(table_offset) + table_size, src_size);
+      out.append_data(src + table_offset, table_size);
+    }
+    else {
+      out.append_data(tables[i - src_count].view());
+    }
+    w.pad4();
+  }
+}
+
+static size_t count_contours(const BLPath& path) noexcept {
+  size_t count = 0;
+  const uint8_t* cmd = path.command_data();
+
+  for (size_t i = 0; i < path.size(); i++)
+    count += size_t(cmd[i] == BL_PATH_CMD_MOVE);
+
+  return count;
+}
+
+static BLBox glyph_bounds(const BLFont& font, BLGlyphId glyph_id) noexcept {
+  BLPath path;
+  BLBox box;
+
+  EXPECT_SUCCESS(font.get_glyph_outlines(glyph_id, path));
+  EXPECT_SUCCESS(path.get_bounding_box(&box));
+  return box;
+}
+
+static void expect_box_near(const BLBox& a, const BLBox& b, double tolerance) noexcept {
+  EXPECT_LE(bl_abs(a.x0 - b.x0), tolerance).message("x0 %f != %f", a.x0, b.x0);
+  EXPECT_LE(bl_abs(a.y0 - b.y0), tolerance).message("y0 %f != %f", a.y0, b.y0);
+  EXPECT_LE(bl_abs(a.x1 - b.x1), tolerance).message("x1 %f != %f", a.x1, b.x1);
+  EXPECT_LE(bl_abs(a.y1 - b.y1), tolerance).message("y1 %f != %f", a.y1, b.y1);
+}
+
+UNIT(opentype_var, BL_TEST_GROUP_TEXT_OPENTYPE) {
+  BLFontData static_data;
+  BLFontFace static_face;
+
+  EXPECT_SUCCESS(static_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)));
+  EXPECT_SUCCESS(static_face.create_from_data(static_data, 0));
+
+  uint32_t glyph_count = static_face.glyph_count();
+  const OTFaceImpl* static_impl = static_cast<const OTFaceImpl*>(static_face._d.impl);
+
+  INFO("Testing whether variable outlines of the default instance match static outlines");
+  {
+    FontVariationCoords coords;
+    coords.reset();
+
+    ScopedBufferTmp<1024> tmp_buffer;
+
+    for (BLGlyphId glyph_id = 0; glyph_id < glyph_count; glyph_id++) {
+      BLPath static_path;
+      BLPath var_path;
+      size_t static_contours;
+      size_t var_contours;
+
+      EXPECT_SUCCESS(static_impl->funcs.get_glyph_outlines(static_impl, glyph_id, &TransformInternal::identity_transform, &static_path, &static_contours, &tmp_buffer));
+      EXPECT_SUCCESS(GlyfImpl::get_glyph_outlines_var(static_impl, glyph_id, &coords, &var_path, &var_contours, &tmp_buffer));
+      EXPECT_EQ(var_contours, static_contours).message("Glyph #%u", glyph_id);
+
+      if (static_path.is_empty()) {
+        EXPECT_TRUE(var_path.is_empty());
+        continue;
+      }
+
+      BLBox static_box;
+      BLBox var_box;
+
+      EXPECT_SUCCESS(static_path.get_bounding_box(&static_box));
+      EXPECT_SUCCESS(var_path.get_bounding_box(&var_box));
+      expect_box_near(var_box, static_box, 1e-6);
+    }
+  }
+
+  INFO("Testing 'fvar' and 'gvar' tables of a synthesized variable font");
+  {
+    BLFont static_font;
+    BLGlyphBuffer gb;
+
+    EXPECT_SUCCESS(static_font.create_from_face(static_face, float(static_face.units_per_em())));
+    EXPECT_SUCCESS(gb.set_utf32_text(&kVarGlyphChar, 1));
+    EXPECT_SUCCESS(static_font.shape(gb));
+
+    BLGlyphId glyph_id = gb.content()[0];
+    EXPECT_NE(glyph_id, 0u);
+
+    // The glyph must have a single contour as only its first point is moved, the others must be inferred.
+    BLPath static_path;
+    EXPECT_SUCCESS(static_font.get_glyph_outlines(glyph_id, static_path));
+    EXPECT_EQ(count_contours(static_path), 1u);
+
+    BLArray<uint8_t> tables[2];
+    BLTag tags[2] = { BL_MAKE_TAG('f', 'v', 'a', 'r'), BL_MAKE_TAG('g', 'v', 'a', 'r') };
+
+    create_fvar_table(tables[0]);
+    create_gvar_table(tables[1], glyph_count, glyph_id);
+
+    BLArray<uint8_t> var_font_data;
+    create_font_with_tables(var_font_data, resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf), tags, tables, 2);
+
+    BLFontData var_data;
+    BLFontFace var_face;
+
+    EXPECT_SUCCESS(var_data.create_from_data(var_font_data));
+    EXPECT_SUCCESS(var_face.create_from_data(var_data, 0));
+    EXPECT_TRUE(var_face.has_face_flag(BL_FONT_FACE_FLAG_OPENTYPE_VARIATIONS));
+
+    const OTFaceImpl* var_impl = static_cast<const OTFaceImpl*>(var_face._d.impl);
+    EXPECT_EQ(var_impl->var.axis_count, 1u);
+    EXPECT_EQ(var_impl->var.axes[0].tag, BL_MAKE_TAG('w', 'g', 'h', 't'));
+
+    BLFont var_font;
+    EXPECT_SUCCESS(var_font.create_from_face(var_face, float(var_face.units_per_em())));
+
+    BLBox static_box = glyph_bounds(static_font, glyph_id);
+    expect_box_near(glyph_bounds(var_font, glyph_id), static_box, 1e-6);
+
+    struct TestEntry {
+      float wght;
+      double scale;
+    };
+
+    // Font space is flipped vertically (Y-down), thus Y deltas are negated.
+    static const TestEntry entries[] = {
+      { 400.0f, 0.0 },
+      { 900.0f, 1.0 },
+      { 650.0f, 0.5 },
+      { 100.0f, 0.0 },
+      { 2000.f, 1.0 }
+    };
+
+    for (const TestEntry& entry : entries) {
+      BLFontVariationSettings settings;
+      EXPECT_SUCCESS(settings.set_value(BL_MAKE_TAG('w', 'g', 'h', 't'), entry.wght));
+      EXPECT_SUCCESS(var_font.set_variation_settings(settings));
+
+      // All points of the contour are moved by the same delta, thus the bounding box is only translated.
+      double dx = kVarDeltaX * entry.scale;
+      double dy = kVarDeltaY * entry.scale;
+
+      BLBox expected(static_box.x0 + dx, static_box.y0 - dy, static_box.x1 + dx, static_box.y1 - dy);
+      expect_box_near(glyph_bounds(var_font, glyph_id), expected, 1e-3);
+    }
+
+    INFO("Testing the outline cache of variable instances");
+    {
+      VarOutlineCache& cache = const_cast<OTFaceImpl*>(var_impl)->var_outline_cache;
+
+      // 900 and 2000 map to the same instance (clamped), 650 and 100 are the others. The default instance is never cached.
+      EXPECT_EQ(cache.instance_count(), 3u);
+      EXPECT_EQ(cache.size(), 3u);
+
+      uint64_t hit_count = cache.hit_count();
+      uint64_t miss_count = cache.miss_count();
+
+      BLFontVariationSettings settings;
+      EXPECT_SUCCESS(settings.set_value(BL_MAKE_TAG('w', 'g', 'h', 't'), 650.0f));
+      EXPECT_SUCCESS(var_font.set_variation_settings(settings));
+
+      glyph_bounds(var_font, glyph_id);
+      glyph_bounds(var_font, glyph_id);
+      EXPECT_EQ(cache.hit_count(), hit_count + 2u);
+      EXPECT_EQ(cache.miss_count(), miss_count);
+
+      // Glyphs without deltas are cached as well as they still have to be decoded by the variable decoder.
+      glyph_bounds(var_font, glyph_id + 1u < glyph_count ? glyph_id + 1u : 1u);
+      EXPECT_EQ(cache.miss_count(), miss_count + 1u);
+      EXPECT_EQ(cache.size(), 4u);
+
+      cache.clear();
+      EXPECT_EQ(cache.size(), 0u);
+      EXPECT_EQ(cache.instance_count(), 0u);
+    }
+  }
+}
+
+} // {Tests}
+} // {bl::OpenType}
+
+#endif // BL_TEST
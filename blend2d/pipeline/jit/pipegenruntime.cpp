@@ -13,7 +13,12 @@
 #include <blend2d/pipeline/jit/pipecompiler_p.h>
 #include <blend2d/pipeline/jit/pipecomposer_p.h>
 #include <blend2d/pipeline/jit/pipegenruntime_p.h>
+#include <blend2d/pipeline/reference/fixedpiperuntime_p.h>
+#include <blend2d/core/array.h>
+#include <blend2d/core/filesystem.h>
+#include <blend2d/support/memops_p.h>
 #include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/threadpool_p.h>
 
 namespace bl::Pipeline::JIT {
 
@@ -31,11 +36,29 @@ FunctionCache::FunctionCache() noexcept
 FunctionCache::~FunctionCache() noexcept {}
 
 BLResult FunctionCache::put(uint32_t signature, void* func) noexcept {
+  FuncNode* node = _func_map.get(FuncMatcher(signature));
+  if (node) {
+    if (node->_func)
+      return bl_make_error(BL_ERROR_ALREADY_EXISTS);
+
+    node->_func = func;
+    return BL_SUCCESS;
+  }
+
+  node = _allocator.new_t<FuncNode>(signature, func);
+  if (BL_UNLIKELY(!node))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  _func_map.insert(node);
+  return BL_SUCCESS;
+}
+
+BLResult FunctionCache::put_pending(uint32_t signature) noexcept {
   FuncNode* node = _func_map.get(FuncMatcher(signature));
   if (node)
     return bl_make_error(BL_ERROR_ALREADY_EXISTS);
 
-  node = _allocator.new_t<FuncNode>(signature, func);
+  node = _allocator.new_t<FuncNode>(signature, nullptr);
   if (BL_UNLIKELY(!node))
     return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
 
@@ -87,34 +110,9 @@ static BLResult BL_CDECL bl_pipe_gen_runtime_test(PipeRuntime* self_, uint32_t s
 
 static BLResult BL_CDECL bl_pipe_gen_runtime_get(PipeRuntime* self_, uint32_t signature, DispatchData* out, PipeLookupCache* cache) noexcept {
   PipeDynamicRuntime* self = static_cast<PipeDynamicRuntime*>(self_);
-  FillFunc fill_func = self->_mutex.protect_shared([&] { return (FillFunc)self->_function_cache.get(signature); });
 
-  if (!fill_func) {
-    fill_func = self->_compile_fill_func(signature);
-    if (BL_UNLIKELY(!fill_func))
-      return bl_make_error(BL_ERROR_INVALID_STATE);
-
-    BLResult result = self->_mutex.protect([&] { return self->_function_cache.put(signature, (void*)fill_func); });
-    if (result == BL_SUCCESS) {
-      self->_pipeline_count++;
-    }
-    else {
-      self->_jit_runtime.release(fill_func);
-      if (result != BL_ERROR_ALREADY_EXISTS) {
-        return result;
-      }
-      else {
-        // NOTE: There is a slight chance that some other thread registered the pipeline meanwhile
-        // it was being compiled. In that case we drop the one we have just compiled and use the
-        // one that is already in the function cache.
-        fill_func = self->_mutex.protect_shared([&] { return (FillFunc)self->_function_cache.get(signature); });
-
-        // It must be there...
-        if (!fill_func)
-          return bl_make_error(BL_ERROR_INVALID_STATE);
-      }
-    }
-  }
+  FillFunc fill_func;
+  BL_PROPAGATE(self->_ensure_fill_func(signature, &fill_func));
 
   out->init(fill_func);
   cache->store(signature, out);
@@ -122,10 +120,71 @@ static BLResult BL_CDECL bl_pipe_gen_runtime_get(PipeRuntime* self_, uint32_t si
   return BL_SUCCESS;
 }
 
+// Used by rendering contexts created with `BL_CONTEXT_CREATE_FLAG_ASYNC_JIT_COMPILATION` - instead of blocking until
+// a pipeline is compiled, the compilation is scheduled and a pipeline provided by the static runtime is used in the
+// meantime. The static pipeline is not stored in the lookup cache, so the compiled one is used once it's available.
+static BLResult BL_CDECL bl_pipe_gen_runtime_get_async(PipeRuntime* self_, uint32_t signature, DispatchData* out, PipeLookupCache* cache) noexcept {
+  PipeDynamicRuntime* self = static_cast<PipeDynamicRuntime*>(self_);
+  PipeStaticRuntime* static_runtime = &PipeStaticRuntime::_global;
+
+  bool is_known = false;
+  FillFunc fill_func = self->_mutex.protect_shared([&] {
+    is_known = self->_function_cache.has(signature);
+    return (FillFunc)self->_function_cache.get(signature);
+  });
+
+  if (fill_func) {
+    out->init(fill_func);
+    cache->store(signature, out);
+    return BL_SUCCESS;
+  }
+
+  // Pending pipelines are always provided by the static runtime, otherwise they wouldn't be scheduled.
+  if (is_known)
+    return static_runtime->_funcs.get(static_runtime, signature, out, nullptr);
+
+  // The static runtime only provides the most common pipelines, so compile the others synchronously.
+  if (static_runtime->_funcs.get(static_runtime, signature, out, nullptr) == BL_SUCCESS) {
+    if (self->_schedule_fill_func(signature) == BL_SUCCESS)
+      return BL_SUCCESS;
+  }
+
+  return bl_pipe_gen_runtime_get(self_, signature, out, cache);
+}
+
+static void BL_CDECL bl_pipe_gen_runtime_async_thread_entry(BLThread* thread, void* data) noexcept {
+  bl_unused(thread);
+
+  PipeDynamicRuntime* self = static_cast<PipeDynamicRuntime*>(data);
+  for (;;) {
+    uint32_t signature;
+    {
+      BLLockGuard<BLMutex> guard(self->_async_mutex);
+      if (self->_async_quitting || self->_async_index >= self->_async_queue.size()) {
+        self->_async_queue.clear();
+        self->_async_index = 0;
+        self->_async_running = false;
+        self->_async_condition.broadcast();
+        return;
+      }
+      signature = self->_async_queue[self->_async_index++];
+    }
+
+    // A failure is not fatal - the pipeline stays pending and the static runtime will keep providing it.
+    FillFunc fill_func;
+    self->_ensure_fill_func(signature, &fill_func);
+  }
+}
+
 PipeDynamicRuntime::PipeDynamicRuntime(PipeRuntimeFlags runtime_flags) noexcept
   : _jit_runtime(),
     _function_cache(),
     _pipeline_count(0),
+    _preloaded_pipeline_count(0),
+    _async_index(0),
+    _async_thread(nullptr),
+    _async_running(false),
+    _async_quitting(false),
     _cpu_features(),
     _max_pixels(0),
     _logger_enabled(false),
@@ -143,13 +202,27 @@ PipeDynamicRuntime::PipeDynamicRuntime(PipeRuntimeFlags runtime_flags) noexcept
   _funcs.test = bl_pipe_gen_runtime_test;
   _funcs.get = bl_pipe_gen_runtime_get;
 
+  // PipeDynamicRuntime interface - used by rendering contexts that compile pipelines asynchronously.
+  _async_funcs.test = bl_pipe_gen_runtime_test;
+  _async_funcs.get = bl_pipe_gen_runtime_get_async;
+
   // Initialize CPU features and hints, which are then passed to the compiler.
   const asmjit::CpuInfo& cpu_info = asmjit::CpuInfo::host();
   _cpu_features = cpu_info.features();
   _cpu_hints = cpu_info.hints();
 }
 
-PipeDynamicRuntime::~PipeDynamicRuntime() noexcept {}
+PipeDynamicRuntime::~PipeDynamicRuntime() noexcept {
+  if (_async_thread) {
+    {
+      BLLockGuard<BLMutex> guard(_async_mutex);
+      _async_quitting = true;
+      while (_async_running)
+        _async_condition.wait(_async_mutex);
+    }
+    bl_thread_pool_global()->release_threads(&_async_thread, 1);
+  }
+}
 
 void PipeDynamicRuntime::_restrict_features(uint32_t mask) noexcept {
 #if defined(BL_JIT_ARCH_X86)
@@ -406,6 +479,162 @@ FillFunc PipeDynamicRuntime::_compile_fill_func(uint32_t signature) noexcept {
   return func;
 }
 
+BLResult PipeDynamicRuntime::_ensure_fill_func(uint32_t signature, FillFunc* fill_func_out, bool* added_out) noexcept {
+  FillFunc fill_func = _mutex.protect_shared([&] { return (FillFunc)_function_cache.get(signature); });
+
+  if (!fill_func) {
+    fill_func = _compile_fill_func(signature);
+    if (BL_UNLIKELY(!fill_func))
+      return bl_make_error(BL_ERROR_INVALID_STATE);
+
+    BLResult result = _mutex.protect([&] { return _function_cache.put(signature, (void*)fill_func); });
+    if (result == BL_SUCCESS) {
+      _pipeline_count++;
+      if (added_out)
+        *added_out = true;
+    }
+    else {
+      _jit_runtime.release(fill_func);
+      if (result != BL_ERROR_ALREADY_EXISTS) {
+        return result;
+      }
+      else {
+        // NOTE: There is a slight chance that some other thread registered the pipeline meanwhile
+        // it was being compiled. In that case we drop the one we have just compiled and use the
+        // one that is already in the function cache.
+        fill_func = _mutex.protect_shared([&] { return (FillFunc)_function_cache.get(signature); });
+
+        // It must be there...
+        if (!fill_func)
+          return bl_make_error(BL_ERROR_INVALID_STATE);
+      }
+    }
+  }
+
+  *fill_func_out = fill_func;
+  return BL_SUCCESS;
+}
+
+BLResult PipeDynamicRuntime::_schedule_fill_func(uint32_t signature) noexcept {
+  BLLockGuard<BLMutex> guard(_async_mutex);
+
+  if (BL_UNLIKELY(_async_quitting))
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+
+  if (!_async_thread) {
+    BLResult reason = BL_SUCCESS;
+    if (!bl_thread_pool_global()->acquire_threads(&_async_thread, 1, 0, &reason)) {
+      _async_thread = nullptr;
+      return reason != BL_SUCCESS ? reason : bl_make_error(BL_ERROR_THREAD_POOL_EXHAUSTED);
+    }
+  }
+
+  BL_PROPAGATE(_async_queue.append(signature));
+
+  if (!_async_running) {
+    BLResult result = _async_thread->run(bl_pipe_gen_runtime_async_thread_entry, this);
+    if (BL_UNLIKELY(result != BL_SUCCESS)) {
+      _async_queue.truncate(_async_queue.size() - 1u);
+      return result;
+    }
+    _async_running = true;
+  }
+
+  // NOTE: The signature could have been added by another thread meanwhile, which is fine as the compiler thread
+  // would not compile it twice. It's not a failure as the pipeline is either pending or already compiled.
+  BLResult result = _mutex.protect([&] { return _function_cache.put_pending(signature); });
+  if (result == BL_ERROR_ALREADY_EXISTS)
+    result = BL_SUCCESS;
+  return result;
+}
+
+// bl::Pipeline::JIT::Runtime - Pipeline Cache File
+// ================================================
+
+// Signatures are read from a file, which can be corrupted or written by a different version of Blend2D, so each
+// signature is validated before it's passed to the compiler, which expects valid values of all signature parts.
+static bool is_valid_cache_signature(Signature sig) noexcept {
+  constexpr uint32_t kKnownMask = Signature::kMaskDstFormat | Signature::kMaskSrcFormat | Signature::kMaskCompOp |
+                                  Signature::kMaskFillType  | Signature::kMaskFetchType;
+
+  return (sig.value & ~kKnownMask) == 0u &&
+         uint32_t(sig.dst_format()) < kFormatExtCount &&
+         uint32_t(sig.src_format()) < kFormatExtCount &&
+         uint32_t(sig.comp_op()) < kCompOpExtCount &&
+         uint32_t(sig.fetch_type()) <= uint32_t(FetchType::_kMaxValue);
+}
+
+BLResult PipeDynamicRuntime::load_cache(const char* file_name) noexcept {
+  BLArray<uint8_t> buffer;
+  BL_PROPAGATE(BLFileSystem::read_file(file_name, buffer));
+
+  const uint8_t* data = buffer.data();
+  size_t size = buffer.size();
+
+  if (size < PipelineCacheFile::kHeaderSize)
+    return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+
+  if (MemOps::readU32uLE(data + 0) != PipelineCacheFile::kMagic ||
+      MemOps::readU32uLE(data + 4) != PipelineCacheFile::kVersion ||
+      MemOps::readU32uLE(data + 8) != BL_VERSION) {
+    return bl_make_error(BL_ERROR_INVALID_SIGNATURE);
+  }
+
+  uint32_t count = MemOps::readU32uLE(data + 12);
+  if (count > PipelineCacheFile::kMaxSignatureCount)
+    return bl_make_error(BL_ERROR_INVALID_DATA);
+
+  if ((size - PipelineCacheFile::kHeaderSize) / 4u < count)
+    return bl_make_error(BL_ERROR_DATA_TRUNCATED);
+
+  const uint8_t* signatures = data + PipelineCacheFile::kHeaderSize;
+  for (uint32_t i = 0; i < count; i++) {
+    Signature sig{MemOps::readU32uLE(signatures + i * 4u)};
+
+    // Invalid signatures are skipped - a single invalid signature should not prevent compiling the remaining ones.
+    if (!is_valid_cache_signature(sig))
+      continue;
+
+    FillFunc fill_func;
+    bool added = false;
+
+    if (_ensure_fill_func(sig.value, &fill_func, &added) == BL_SUCCESS && added)
+      _preloaded_pipeline_count++;
+  }
+
+  return BL_SUCCESS;
+}
+
+BLResult PipeDynamicRuntime::save_cache(const char* file_name) noexcept {
+  BLArray<uint8_t> buffer;
+
+  BL_PROPAGATE(_mutex.protect_shared([&]() -> BLResult {
+    uint32_t count = 0;
+    _function_cache.for_each_signature([&](uint32_t) { count++; });
+    count = bl_min(count, PipelineCacheFile::kMaxSignatureCount);
+
+    uint8_t* data;
+    BL_PROPAGATE(buffer.modify_op(BL_MODIFY_OP_ASSIGN_FIT, PipelineCacheFile::kHeaderSize + size_t(count) * 4u, &data));
+
+    MemOps::writeU32uLE(data + 0, PipelineCacheFile::kMagic);
+    MemOps::writeU32uLE(data + 4, PipelineCacheFile::kVersion);
+    MemOps::writeU32uLE(data + 8, BL_VERSION);
+    MemOps::writeU32uLE(data + 12, count);
+
+    uint32_t i = 0;
+    uint8_t* signatures = data + PipelineCacheFile::kHeaderSize;
+
+    _function_cache.for_each_signature([&](uint32_t signature) {
+      if (i < count)
+        MemOps::writeU32uLE(signatures + (i++) * 4u, signature);
+    });
+
+    return BL_SUCCESS;
+  }));
+
+  return BLFileSystem::write_file(file_name, buffer);
+}
+
 } // {bl::Pipeline::JIT}
 
 // bl::Pipeline::JIT::Runtime - Runtime Registration
@@ -422,6 +651,7 @@ static void BL_CDECL bl_dynamic_pipe_rt_resource_info(BLRuntimeContext* rt, BLRu
   resource_info->vm_overhead += pipe_stats.overhead_size();
   resource_info->vm_block_count += pipe_stats.block_count();
   resource_info->dynamic_pipeline_count += pipe_gen_runtime._pipeline_count.load();
+  resource_info->dynamic_pipeline_preloaded_count += pipe_gen_runtime._preloaded_pipeline_count.load();
 }
 
 static void BL_CDECL bl_dynamic_pipe_rt_shutdown(BLRuntimeContext* rt) noexcept {
@@ -429,6 +659,14 @@ static void BL_CDECL bl_dynamic_pipe_rt_shutdown(BLRuntimeContext* rt) noexcept
   bl::Pipeline::JIT::PipeDynamicRuntime::_global.destroy();
 }
 
+BLResult bl_dynamic_pipeline_rt_load_cache(const char* file_name) noexcept {
+  return bl::Pipeline::JIT::PipeDynamicRuntime::_global->load_cache(file_name);
+}
+
+BLResult bl_dynamic_pipeline_rt_save_cache(const char* file_name) noexcept {
+  return bl::Pipeline::JIT::PipeDynamicRuntime::_global->save_cache(file_name);
+}
+
 void bl_dynamic_pipeline_rt_init(BLRuntimeContext* rt) noexcept {
   bl::Pipeline::JIT::PipeDynamicRuntime::_global.init();
 
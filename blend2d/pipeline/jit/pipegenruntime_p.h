@@ -6,10 +6,13 @@
 #ifndef BLEND2D_PIPELINE_JIT_PIPEGENRUNTIME_P_H_INCLUDED
 #define BLEND2D_PIPELINE_JIT_PIPEGENRUNTIME_P_H_INCLUDED
 
+#include <blend2d/core/array.h>
 #include <blend2d/support/arenaallocator_p.h>
 #include <blend2d/support/arenahashmap_p.h>
 #include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/conditionvariable_p.h>
 #include <blend2d/threading/mutex_p.h>
+#include <blend2d/threading/thread_p.h>
 #include <blend2d/pipeline/piperuntime_p.h>
 #include <blend2d/pipeline/jit/pipecompiler_p.h>
 #include <blend2d/pipeline/jit/pipeprimitives_p.h>
@@ -22,11 +25,14 @@ namespace bl::Pipeline::JIT {
 
 //! PipeGen function cache.
 //!
+//! A function cache can also contain pending nodes, which have no function yet - these are nodes of pipelines, which
+//! are being compiled asynchronously.
+//!
 //! \note No locking is preformed implicitly as `BLPipeGenRuntime` synchronizes the access on its own.
 class FunctionCache {
 public:
   struct FuncNode : public ArenaHashMapNode {
-    //! Function pointer.
+    //! Function pointer (null if the function is pending).
     void* _func;
 
     BL_INLINE FuncNode(uint32_t signature, void* func) noexcept
@@ -60,7 +66,42 @@ public:
     return node ? node->func() : nullptr;
   }
 
+  //! Tests whether a function of the given `signature` is either cached or pending.
+  BL_INLINE bool has(uint32_t signature) const noexcept {
+    return _func_map.get(FuncMatcher(signature)) != nullptr;
+  }
+
+  //! Calls `fn` with a signature of each cached function (pending functions are skipped).
+  template<typename Fn>
+  BL_INLINE void for_each_signature(Fn&& fn) const noexcept {
+    _func_map.for_each([&](const FuncNode* node) {
+      if (node->func())
+        fn(node->signature());
+    });
+  }
+
+  //! Adds a function to the cache or assigns it to a pending node.
   BLResult put(uint32_t signature, void* func) noexcept;
+
+  //! Adds a pending node to the cache, which will be assigned a function later by `put()`.
+  BLResult put_pending(uint32_t signature) noexcept;
+};
+
+//! Pipeline cache file that stores signatures of pipelines used by a process, so the next process can compile
+//! them ahead of time. Machine code is never stored as it embeds absolute addresses of tables, which change with
+//! each process, and it also depends on CPU features, which can differ when the file is shared between machines.
+//!
+//! The file starts with a header followed by `count` signatures, all values are 32-bit little-endian integers.
+struct PipelineCacheFile {
+  //! Magic value ('BLPC') used to identify the file.
+  static constexpr uint32_t kMagic = 0x43504C42u;
+  //! Version of the file format, must be incremented when the layout of \ref Signature changes.
+  static constexpr uint32_t kVersion = 1u;
+  //! Size of the file header.
+  static constexpr uint32_t kHeaderSize = 16u;
+
+  //! Maximum number of signatures accepted when loading a file (protects against corrupted files).
+  static constexpr uint32_t kMaxSignatureCount = 65536u;
 };
 
 //! JIT pipeline runtime.
@@ -74,6 +115,25 @@ public:
   FunctionCache _function_cache;
   //! Count of cached pipelines.
   std::atomic<size_t> _pipeline_count;
+  //! Count of pipelines compiled ahead of time from a pipeline cache file.
+  std::atomic<size_t> _preloaded_pipeline_count;
+
+  //! Functions used by rendering contexts that compile pipelines asynchronously (see \ref _schedule_fill_func()).
+  Funcs _async_funcs;
+  //! Mutex that guards the state of asynchronous compilation.
+  BLMutex _async_mutex;
+  //! Condition variable used to wait for the compiler thread when the runtime is being destroyed.
+  BLConditionVariable _async_condition;
+  //! Signatures of pipelines to compile asynchronously.
+  BLArray<uint32_t> _async_queue;
+  //! Index of the next signature in `_async_queue` to compile.
+  size_t _async_index;
+  //! Compiler thread acquired from the global thread pool when the first pipeline is scheduled.
+  BLThread* _async_thread;
+  //! Whether the compiler thread is running.
+  bool _async_running;
+  //! Whether the runtime is being destroyed - the compiler thread stops as soon as possible.
+  bool _async_quitting;
 
   //! CPU features to use (either detected or restricted by the user).
   asmjit::CpuFeatures _cpu_features;
@@ -103,6 +163,20 @@ public:
 
   FillFunc _compile_fill_func(uint32_t signature) noexcept;
 
+  //! Returns a cached fill function of the given `signature` or compiles and caches a new one.
+  //!
+  //! If `added_out` is provided it's set to true when a new function was added to the function cache.
+  BLResult _ensure_fill_func(uint32_t signature, FillFunc* fill_func_out, bool* added_out = nullptr) noexcept;
+
+  //! Schedules an asynchronous compilation of a pipeline of the given `signature` and adds a pending node to the
+  //! function cache, which would be replaced by the compiled function. Succeeds if the pipeline is already pending.
+  BLResult _schedule_fill_func(uint32_t signature) noexcept;
+
+  //! Compiles all pipelines of signatures stored in a pipeline cache file `file_name`, which were not compiled yet.
+  BLResult load_cache(const char* file_name) noexcept;
+  //! Stores signatures of all compiled pipelines to a pipeline cache file `file_name`.
+  BLResult save_cache(const char* file_name) noexcept;
+
   static Wrap<PipeDynamicRuntime> _global;
 };
 
@@ -0,0 +1,271 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST) && !defined(BL_BUILD_NO_JIT)
+
+#include <blend2d/core/array.h>
+#include <blend2d/core/context.h>
+#include <blend2d/core/filesystem.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/path.h>
+#include <blend2d/core/runtime.h>
+#include <blend2d/pipeline/jit/pipegenruntime_p.h>
+#include <blend2d/support/memops_p.h>
+
+#include <stdio.h>
+
+namespace bl::Pipeline::JIT::Tests {
+
+// bl::Pipeline::JIT::Runtime - Tests - Utilities
+// ==============================================
+
+static constexpr const char kCacheFileName[] = "bl_test_pipeline_cache.bin";
+
+static Signature make_solid_signature(CompOpExt comp_op, FillType fill_type) noexcept {
+  return Signature::from_dst_format(FormatExt::kPRGB32) |
+         Signature::from_src_format(FormatExt::kPRGB32) |
+         Signature::from_comp_op(comp_op) |
+         Signature::from_fill_type(fill_type) |
+         Signature::from_fetch_type(FetchType::kSolid);
+}
+
+// Writes a pipeline cache file, which has the given header and `count` signatures. The `count` stored in the header
+// can be overridden by `stored_count` to write a truncated file.
+static BLResult write_cache_file(uint32_t magic, uint32_t version, const uint32_t* signatures, uint32_t count, uint32_t stored_count) noexcept {
+  BLArray<uint8_t> buffer;
+  uint8_t* data;
+  BL_PROPAGATE(buffer.modify_op(BL_MODIFY_OP_ASSIGN_FIT, PipelineCacheFile::kHeaderSize + size_t(count) * 4u, &data));
+
+  MemOps::writeU32uLE(data + 0, magic);
+  MemOps::writeU32uLE(data + 4, version);
+  MemOps::writeU32uLE(data + 8, BL_VERSION);
+  MemOps::writeU32uLE(data + 12, stored_count);
+
+  for (uint32_t i = 0; i < count; i++)
+    MemOps::writeU32uLE(data + PipelineCacheFile::kHeaderSize + i * 4u, signatures[i]);
+
+  return BLFileSystem::write_file(kCacheFileName, buffer);
+}
+
+// Waits until the compiler thread of `runtime` compiles all scheduled pipelines.
+static void wait_for_async_compilation(PipeDynamicRuntime& runtime) noexcept {
+  BLLockGuard<BLMutex> guard(runtime._async_mutex);
+  while (runtime._async_running)
+    runtime._async_condition.wait(runtime._async_mutex);
+}
+
+static void render_async_scene(BLImage& image, const BLContextCreateInfo& create_info) noexcept {
+  BLPath triangle;
+  triangle.move_to(4, 4);
+  triangle.line_to(120, 16);
+  triangle.line_to(24, 124);
+  triangle.close();
+
+  BLContext ctx(image, create_info);
+  ctx.clear_all();
+  ctx.fill_rect(BLRectI(8, 8, 48, 48), BLRgba32(0xFFFF0000u));
+  ctx.fill_rect(BLRect(32.5, 32.5, 64.0, 64.0), BLRgba32(0x800000FFu));
+  ctx.fill_path(triangle, BLRgba32(0xC000FF00u));
+
+  ctx.set_comp_op(BL_COMP_OP_SRC_COPY);
+  ctx.fill_circle(BLCircle(96, 96, 20), BLRgba32(0x80FFFF00u));
+
+  ctx.set_comp_op(BL_COMP_OP_XOR);
+  ctx.fill_rect(BLRectI(64, 8, 56, 40), BLRgba32(0xFF00FFFFu));
+  ctx.fill_circle(BLCircle(24, 100, 18), BLRgba32(0x40FF00FFu));
+  ctx.end();
+}
+
+// bl::Pipeline::JIT::Runtime - Tests - Pipeline Cache
+// ===================================================
+
+UNIT(pipeline_cache, BL_TEST_GROUP_RENDERING_UTILITIES) {
+  const Signature signatures[] = {
+    make_solid_signature(CompOpExt::kSrcOver, FillType::kBoxA),
+    make_solid_signature(CompOpExt::kSrcCopy, FillType::kBoxA),
+    make_solid_signature(CompOpExt::kSrcOver, FillType::kAnalytic)
+  };
+  constexpr uint32_t kSignatureCount = uint32_t(BL_ARRAY_SIZE(signatures));
+
+  INFO("Testing whether saved pipelines are preloaded by a fresh runtime");
+  {
+    {
+      PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+      for (const Signature& sig : signatures) {
+        FillFunc fill_func;
+        EXPECT_SUCCESS(runtime._ensure_fill_func(sig.value, &fill_func));
+        EXPECT_NOT_NULL(fill_func);
+      }
+
+      EXPECT_EQ(runtime._pipeline_count.load(), size_t(kSignatureCount));
+      EXPECT_SUCCESS(runtime.save_cache(kCacheFileName));
+    }
+
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+    EXPECT_SUCCESS(runtime.load_cache(kCacheFileName));
+    EXPECT_EQ(runtime._preloaded_pipeline_count.load(), size_t(kSignatureCount));
+    EXPECT_EQ(runtime._pipeline_count.load(), size_t(kSignatureCount));
+
+    for (const Signature& sig : signatures)
+      EXPECT_NOT_NULL(runtime._function_cache.get(sig.value));
+
+    // Loading the same file again must not compile (and count) the same pipelines twice.
+    EXPECT_SUCCESS(runtime.load_cache(kCacheFileName));
+    EXPECT_EQ(runtime._preloaded_pipeline_count.load(), size_t(kSignatureCount));
+  }
+
+  INFO("Testing whether the global runtime reports preloaded pipelines");
+  {
+    BLRuntimeResourceInfo before;
+    EXPECT_SUCCESS(BLRuntime::query_resource_info(&before));
+
+    EXPECT_SUCCESS(BLRuntime::save_pipeline_cache(kCacheFileName));
+    EXPECT_SUCCESS(BLRuntime::load_pipeline_cache(kCacheFileName));
+
+    // All pipelines in the file were saved by the global runtime, so none of them is compiled again.
+    BLRuntimeResourceInfo after;
+    EXPECT_SUCCESS(BLRuntime::query_resource_info(&after));
+    EXPECT_EQ(after.dynamic_pipeline_preloaded_count, before.dynamic_pipeline_preloaded_count);
+  }
+
+  INFO("Testing whether invalid signatures are skipped");
+  {
+    uint32_t data[] = { 0xFFFFFFFFu, signatures[0].value };
+    EXPECT_SUCCESS(write_cache_file(PipelineCacheFile::kMagic, PipelineCacheFile::kVersion, data, 2u, 2u));
+
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+    EXPECT_SUCCESS(runtime.load_cache(kCacheFileName));
+    EXPECT_EQ(runtime._preloaded_pipeline_count.load(), 1u);
+  }
+
+  INFO("Testing whether a file with a bad magic is rejected");
+  {
+    uint32_t data[] = { signatures[0].value };
+    EXPECT_SUCCESS(write_cache_file(PipelineCacheFile::kMagic ^ 1u, PipelineCacheFile::kVersion, data, 1u, 1u));
+
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+    EXPECT_EQ(runtime.load_cache(kCacheFileName), BL_ERROR_INVALID_SIGNATURE);
+    EXPECT_EQ(runtime._preloaded_pipeline_count.load(), 0u);
+  }
+
+  INFO("Testing whether a file with a bad version is rejected");
+  {
+    uint32_t data[] = { signatures[0].value };
+    EXPECT_SUCCESS(write_cache_file(PipelineCacheFile::kMagic, PipelineCacheFile::kVersion + 1u, data, 1u, 1u));
+
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+    EXPECT_EQ(runtime.load_cache(kCacheFileName), BL_ERROR_INVALID_SIGNATURE);
+    EXPECT_EQ(runtime._preloaded_pipeline_count.load(), 0u);
+  }
+
+  INFO("Testing whether a truncated file is rejected");
+  {
+    // The header says there are 3 signatures, but the file only contains 2.
+    uint32_t data[] = { signatures[0].value, signatures[1].value };
+    EXPECT_SUCCESS(write_cache_file(PipelineCacheFile::kMagic, PipelineCacheFile::kVersion, data, 2u, 3u));
+
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+    EXPECT_EQ(runtime.load_cache(kCacheFileName), BL_ERROR_DATA_TRUNCATED);
+    EXPECT_EQ(runtime._preloaded_pipeline_count.load(), 0u);
+
+    // A file, which is shorter than the header, is truncated as well.
+    EXPECT_SUCCESS(BLFileSystem::write_file(kCacheFileName, data, 8u));
+    EXPECT_EQ(runtime.load_cache(kCacheFileName), BL_ERROR_DATA_TRUNCATED);
+  }
+
+  remove(kCacheFileName);
+}
+
+// bl::Pipeline::JIT::Runtime - Tests - Asynchronous Compilation
+// =============================================================
+
+UNIT(pipeline_async_compilation, BL_TEST_GROUP_RENDERING_UTILITIES) {
+  const Signature sig_box = make_solid_signature(CompOpExt::kSrcOver, FillType::kBoxA);
+  const Signature sig_analytic = make_solid_signature(CompOpExt::kSrcOver, FillType::kAnalytic);
+
+  INFO("Testing whether pending functions are replaced by functions passed to FunctionCache::put()");
+  {
+    FunctionCache cache;
+    void* func = reinterpret_cast<void*>(uintptr_t(0x1000u));
+
+    EXPECT_SUCCESS(cache.put_pending(sig_box.value));
+    EXPECT_TRUE(cache.has(sig_box.value));
+    EXPECT_NULL(cache.get(sig_box.value));
+    EXPECT_EQ(cache.put_pending(sig_box.value), BL_ERROR_ALREADY_EXISTS);
+
+    // Pending functions are not stored in a pipeline cache file.
+    uint32_t signature_count = 0;
+    cache.for_each_signature([&](uint32_t) { signature_count++; });
+    EXPECT_EQ(signature_count, 0u);
+
+    EXPECT_SUCCESS(cache.put(sig_box.value, func));
+    EXPECT_EQ(cache.get(sig_box.value), func);
+    EXPECT_EQ(cache.put(sig_box.value, func), BL_ERROR_ALREADY_EXISTS);
+    EXPECT_EQ(cache.put_pending(sig_box.value), BL_ERROR_ALREADY_EXISTS);
+
+    cache.for_each_signature([&](uint32_t) { signature_count++; });
+    EXPECT_EQ(signature_count, 1u);
+  }
+
+  INFO("Testing whether scheduled pipelines are eventually compiled");
+  {
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+
+    EXPECT_SUCCESS(runtime._schedule_fill_func(sig_analytic.value));
+    EXPECT_TRUE(runtime._function_cache.has(sig_analytic.value));
+
+    // Scheduling the same pipeline again must succeed, it's either pending or compiled already.
+    EXPECT_SUCCESS(runtime._schedule_fill_func(sig_analytic.value));
+
+    wait_for_async_compilation(runtime);
+    EXPECT_NOT_NULL(runtime._function_cache.get(sig_analytic.value));
+    EXPECT_EQ(runtime._pipeline_count.load(), 1u);
+  }
+
+  INFO("Testing whether pending pipelines are provided by the static runtime and not cached");
+  {
+    PipeDynamicRuntime runtime(PipeRuntimeFlags::kIsolated);
+    PipeLookupCache lookup_cache;
+    lookup_cache.reset();
+
+    DispatchData dispatch_data {};
+    EXPECT_SUCCESS(runtime._async_funcs.get(&runtime, sig_box.value, &dispatch_data, &lookup_cache));
+    EXPECT_NOT_NULL(dispatch_data.fill_func);
+    EXPECT_TRUE(runtime._function_cache.has(sig_box.value));
+    EXPECT_EQ(lookup_cache._current_index, 0u);
+
+    wait_for_async_compilation(runtime);
+    FillFunc compiled_func = (FillFunc)runtime._function_cache.get(sig_box.value);
+    EXPECT_NOT_NULL(compiled_func);
+
+    EXPECT_SUCCESS(runtime._async_funcs.get(&runtime, sig_box.value, &dispatch_data, &lookup_cache));
+    EXPECT_EQ(dispatch_data.fill_func, compiled_func);
+    EXPECT_EQ(lookup_cache._current_index, 1u);
+  }
+
+  INFO("Testing whether rendering with BL_CONTEXT_CREATE_FLAG_ASYNC_JIT_COMPILATION matches synchronous compilation");
+  {
+    BLImage sync_image(128, 128, BL_FORMAT_PRGB32);
+    BLImage async_image(128, 128, BL_FORMAT_PRGB32);
+
+    BLContextCreateInfo sync_info {};
+    BLContextCreateInfo async_info {};
+    async_info.flags = BL_CONTEXT_CREATE_FLAG_ASYNC_JIT_COMPILATION;
+
+    // Static and JIT pipelines are bit-exact when rendering solid styles, so it doesn't matter whether a pipeline
+    // used by the asynchronous context was still pending or already compiled. The second iteration mostly renders
+    // with pipelines that were compiled asynchronously during the first one.
+    for (uint32_t i = 0; i < 2; i++) {
+      render_async_scene(async_image, async_info);
+      render_async_scene(sync_image, sync_info);
+      EXPECT_TRUE(sync_image.equals(async_image));
+    }
+  }
+}
+
+} // {bl::Pipeline::JIT::Tests}
+
+#endif // BL_TEST && !BL_BUILD_NO_JIT
@@ -79,6 +79,12 @@ struct PipeProvider {
     _funcs = runtime->_funcs;
   }
 
+  //! Initializes the provider to use `runtime` through `funcs`, which replace the default functions of the runtime.
+  BL_INLINE_NODEBUG void init(PipeRuntime* runtime, const PipeRuntime::Funcs& funcs) noexcept {
+    _runtime = runtime;
+    _funcs = funcs;
+  }
+
   BL_INLINE_NODEBUG void reset() noexcept {
     memset(this, 0, sizeof(*this));
   }
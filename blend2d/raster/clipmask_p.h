@@ -0,0 +1,247 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_RASTER_CLIPMASK_P_H_INCLUDED
+#define BLEND2D_RASTER_CLIPMASK_P_H_INCLUDED
+
+#include <blend2d/core/image_p.h>
+#include <blend2d/pipeline/pipedefs_p.h>
+#include <blend2d/pixelops/scalar_p.h>
+#include <blend2d/raster/workdata_p.h>
+#include <blend2d/support/intops_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_raster_engine_impl
+//! \{
+
+namespace bl::RasterEngine {
+
+//! Clip mask used when the clip mode is \ref BL_CLIP_MODE_MASK.
+//!
+//! Clip mask is an A8 image that holds the coverage of the clip in device space. It's rasterized once when the clip
+//! changes and then combined with the coverage of each render command processed while it's active. The mask covers
+//! exactly `box`, which always contains the final clip box of the rendering context.
+struct ClipMask {
+  //! \name Members
+  //! \{
+
+  //! A8 image that holds the coverage of the clip (retained by the owner of the clip mask).
+  BLImageImpl* image;
+  //! Box of the clip mask in device pixels - the size of the box matches the size of `image`.
+  BLBoxI box;
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  BL_INLINE_NODEBUG bool is_valid() const noexcept { return image != nullptr; }
+  BL_INLINE_NODEBUG intptr_t stride() const noexcept { return image->stride; }
+
+  BL_INLINE const uint8_t* pixel_ptr(int x, int y) const noexcept {
+    BL_ASSERT(x >= box.x0 && x <= box.x1);
+    BL_ASSERT(y >= box.y0 && y <= box.y1);
+
+    return static_cast<const uint8_t*>(image->pixel_data) + intptr_t(y - box.y0) * image->stride + uintptr_t(x - box.x0);
+  }
+
+  //! \}
+};
+
+//! Command processing of commands clipped by a \ref ClipMask.
+//!
+//! The coverage of a command is calculated per a block of scanlines (at most a band), multiplied by the clip mask,
+//! and then composited by the mask fill pipeline, which the rendering context selects when a clip mask is active.
+//! All functions here are used by both synchronous and asynchronous command processors.
+namespace ClipMaskProc {
+
+static BL_INLINE Pipeline::MaskCommandType vmask_type_from_alpha(uint32_t alpha) noexcept {
+  return alpha >= 255 ? Pipeline::MaskCommandType::kVMaskA8WithGA : Pipeline::MaskCommandType::kVMaskA8WithoutGA;
+}
+
+//! Returns the coverage of a pixel at `p` by a span [f0, f1) specified in 24.8 fixed point (0..256).
+static BL_INLINE uint32_t span_coverage_24x8(int p, int f0, int f1) noexcept {
+  int p0 = p << 8;
+  return uint32_t(bl_max(bl_min(f1, p0 + 256) - bl_max(f0, p0), 0));
+}
+
+//! Composites [x0, y0, x1, y1) box by using `mask_data` as a variable mask, having one byte per pixel.
+static BL_INLINE void fill_vmask(
+    WorkData& work_data, Pipeline::FillFunc fill_func, uint32_t alpha,
+    int x0, int y0, int x1, int y1, const uint8_t* mask_data, intptr_t mask_stride, const void* fetch_data) noexcept {
+
+  Pipeline::MaskCommand mask_commands[2];
+  mask_commands[0].init_vmask(vmask_type_from_alpha(alpha), uint32_t(x0), uint32_t(x1), mask_data, mask_stride);
+  mask_commands[1].init_repeat();
+
+  Pipeline::FillData fill_data;
+  fill_data.init_mask_a(alpha, x0, y0, x1, y1, mask_commands);
+  fill_func(&work_data.ctx_data, &fill_data, fetch_data);
+}
+
+//! Fills an aligned box - the clip mask itself is the mask of the fill, so no scratch memory is needed.
+static BL_INLINE void fill_box_a(
+    WorkData& work_data, Pipeline::FillFunc fill_func, uint32_t alpha,
+    const BLBoxI& box_a, const ClipMask& clip_mask, const void* fetch_data) noexcept {
+
+  fill_vmask(work_data, fill_func, alpha,
+             box_a.x0, box_a.y0, box_a.x1, box_a.y1,
+             clip_mask.pixel_ptr(box_a.x0, box_a.y0), clip_mask.stride(), fetch_data);
+}
+
+//! Fills an unaligned box specified in 24.8 fixed point.
+static BL_NOINLINE void fill_box_u(
+    WorkData& work_data, Pipeline::FillFunc fill_func, uint32_t alpha,
+    const BLBoxI& box_u, const ClipMask& clip_mask, const void* fetch_data) noexcept {
+
+  if (box_u.x0 >= box_u.x1 || box_u.y0 >= box_u.y1)
+    return;
+
+  uint8_t* buffer = work_data.ensure_clip_mask_buffer();
+  if (BL_UNLIKELY(!buffer)) {
+    work_data.accumulate_error_flag(BL_CONTEXT_ERROR_FLAG_OUT_OF_MEMORY);
+    return;
+  }
+
+  intptr_t buffer_stride = intptr_t(work_data.clip_mask_buffer_stride);
+  int block_height = int(work_data.band_height());
+
+  int x0 = box_u.x0 >> 8;
+  int y0 = box_u.y0 >> 8;
+  int x1 = (box_u.x1 + 0xFF) >> 8;
+  int y1 = (box_u.y1 + 0xFF) >> 8;
+
+  while (y0 < y1) {
+    int block_y1 = bl_min(y0 + block_height, y1);
+    uint8_t* dst_row = buffer;
+
+    for (int y = y0; y < block_y1; y++, dst_row += buffer_stride) {
+      uint32_t cy = span_coverage_24x8(y, box_u.y0, box_u.y1) * 255u;
+      const uint8_t* clip_row = clip_mask.pixel_ptr(x0, y);
+
+      for (int x = x0; x < x1; x++) {
+        uint32_t m = (span_coverage_24x8(x, box_u.x0, box_u.x1) * cy) >> 16;
+        dst_row[x - x0] = uint8_t(PixelOps::Scalar::udiv255(m * clip_row[x - x0]));
+      }
+    }
+
+    fill_vmask(work_data, fill_func, alpha, x0, y0, x1, block_y1, buffer, buffer_stride, fetch_data);
+    y0 = block_y1;
+  }
+}
+
+//! Fills an aligned box masked by an A8 `mask_data` having `mask_stride`, which points to the pixel at [x0, y0].
+static BL_NOINLINE void fill_box_masked_a(
+    WorkData& work_data, Pipeline::FillFunc fill_func, uint32_t alpha,
+    const BLBoxI& box_a, const uint8_t* mask_data, intptr_t mask_stride, const ClipMask& clip_mask, const void* fetch_data) noexcept {
+
+  uint8_t* buffer = work_data.ensure_clip_mask_buffer();
+  if (BL_UNLIKELY(!buffer)) {
+    work_data.accumulate_error_flag(BL_CONTEXT_ERROR_FLAG_OUT_OF_MEMORY);
+    return;
+  }
+
+  intptr_t buffer_stride = intptr_t(work_data.clip_mask_buffer_stride);
+  int block_height = int(work_data.band_height());
+
+  int x0 = box_a.x0;
+  int y0 = box_a.y0;
+  int w = box_a.x1 - box_a.x0;
+
+  while (y0 < box_a.y1) {
+    int block_y1 = bl_min(y0 + block_height, box_a.y1);
+    uint8_t* dst_row = buffer;
+
+    for (int y = y0; y < block_y1; y++, dst_row += buffer_stride, mask_data += mask_stride) {
+      const uint8_t* clip_row = clip_mask.pixel_ptr(x0, y);
+      for (int i = 0; i < w; i++)
+        dst_row[i] = uint8_t(PixelOps::Scalar::udiv255(uint32_t(mask_data[i]) * clip_row[i]));
+    }
+
+    fill_vmask(work_data, fill_func, alpha, x0, y0, box_a.x1, block_y1, buffer, buffer_stride, fetch_data);
+    y0 = block_y1;
+  }
+}
+
+//! Fills cells accumulated by the analytic rasterizer in a single band described by `analytic`.
+//!
+//! Integrates the cells the same way as the analytic fill pipeline does, multiplies the coverage by the clip mask and
+//! composites it by the mask pipeline. Cells and bits are cleared as the memory is zero memory shared with the
+//! rasterizer - this must happen even if nothing is composited.
+static BL_NOINLINE void fill_analytic(
+    WorkData& work_data, Pipeline::FillFunc fill_func,
+    const Pipeline::FillData::Analytic& analytic, const ClipMask& clip_mask, const void* fetch_data) noexcept {
+
+  constexpr uint32_t kA8Shift = Pipeline::A8Info::kShift;
+  constexpr uint32_t kA8Scale = Pipeline::A8Info::kScale;
+
+  int x0 = analytic.box.x0;
+  int y0 = analytic.box.y0;
+  int x1 = analytic.box.x1;
+  int y1 = analytic.box.y1;
+
+  // The rasterized band can exceed the clip mask vertically as asynchronous rendering processes whole bands and
+  // horizontally as the end of the analytic box is aligned.
+  int clip_x0 = bl_max(x0, clip_mask.box.x0);
+  int clip_y0 = bl_max(y0, clip_mask.box.y0);
+  int clip_x1 = bl_min(x1, clip_mask.box.x1);
+  int clip_y1 = bl_min(y1, clip_mask.box.y1);
+
+  uint8_t* buffer = work_data.ensure_clip_mask_buffer();
+  if (BL_UNLIKELY(!buffer)) {
+    work_data.accumulate_error_flag(BL_CONTEXT_ERROR_FLAG_OUT_OF_MEMORY);
+    clip_x1 = clip_x0;
+  }
+
+  intptr_t buffer_stride = intptr_t(work_data.clip_mask_buffer_stride);
+  uint32_t alpha = analytic.alpha.u;
+  uint32_t fill_rule_mask = analytic.fill_rule_mask;
+
+  BLBitWord* bit_ptr = analytic.bit_top_ptr;
+  uint32_t* cell_ptr = analytic.cell_top_ptr;
+
+  for (int y = y0; y < y1; y++) {
+    uint32_t cov = kA8Scale << (kA8Shift + 1u);
+    bool is_clipped_in = y >= clip_y0 && y < clip_y1 && clip_x0 < clip_x1;
+
+    if (is_clipped_in) {
+      uint8_t* dst_row = buffer + intptr_t(y - clip_y0) * buffer_stride - clip_x0;
+      const uint8_t* clip_row = clip_mask.pixel_ptr(clip_x0, y) - clip_x0;
+
+      for (int x = x0; x < x1; x++) {
+        cov += cell_ptr[x];
+        cell_ptr[x] = 0;
+
+        if (x >= clip_x0 && x < clip_x1) {
+          uint32_t m = (IntOps::sar(cov, kA8Shift + 1u) & fill_rule_mask) - kA8Scale;
+          m = (bl_min<uint32_t>(uint32_t(bl_abs(int32_t(m))), kA8Scale) * alpha) >> 8;
+          dst_row[x] = uint8_t(PixelOps::Scalar::udiv255(m * clip_row[x]));
+        }
+      }
+    }
+    else {
+      for (int x = x0; x < x1; x++)
+        cell_ptr[x] = 0;
+    }
+
+    // There is always one more cell that can be non-zero (the cell after the last one).
+    cell_ptr[x1] = 0;
+    memset(bit_ptr, 0, analytic.bit_stride);
+
+    bit_ptr = PtrOps::offset(bit_ptr, analytic.bit_stride);
+    cell_ptr = PtrOps::offset(cell_ptr, analytic.cell_stride);
+  }
+
+  if (clip_x0 < clip_x1 && clip_y0 < clip_y1)
+    fill_vmask(work_data, fill_func, 255, clip_x0, clip_y0, clip_x1, clip_y1, buffer, buffer_stride, fetch_data);
+}
+
+} // {ClipMaskProc}
+} // {bl::RasterEngine}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_RASTER_CLIPMASK_P_H_INCLUDED
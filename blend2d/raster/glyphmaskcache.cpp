@@ -0,0 +1,197 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/context.h>
+#include <blend2d/core/path.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/raster/glyphmaskcache_p.h>
+#include <blend2d/support/hashops_p.h>
+#include <blend2d/support/math_p.h>
+
+namespace bl::RasterEngine {
+
+// bl::RasterEngine - GlyphMaskCache - Globals
+// ===========================================
+
+Wrap<GlyphMaskCache> glyph_mask_cache_global;
+
+// bl::RasterEngine - GlyphMaskCache - Key
+// =======================================
+
+static BL_INLINE uint64_t bit_cast_u64(double value) noexcept {
+  uint64_t u;
+  memcpy(&u, &value, sizeof(u));
+  return u;
+}
+
+uint32_t GlyphMaskKey::hash_code() const noexcept {
+  uint32_t font_size_bits;
+  memcpy(&font_size_bits, &font_size, sizeof(font_size_bits));
+
+  uint32_t hash = HashOps::hash_mix_u64(0, face_id);
+  hash = HashOps::hash_mix_u64(hash, (uint64_t(glyph_id) << 32) | (uint64_t(phase_y) << 8) | uint64_t(phase_x));
+  hash = HashOps::hash_mix_u64(hash, font_size_bits);
+
+  for (uint32_t i = 0; i < 4; i++)
+    hash = HashOps::hash_mix_u64(hash, bit_cast_u64(transform[i]));
+
+  return hash;
+}
+
+// bl::RasterEngine - GlyphMaskCache - Interface
+// =============================================
+
+void GlyphMaskCache::set_limits(size_t size_limit, size_t count_limit) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  _size_limit = size_limit;
+  _count_limit = count_limit;
+  _evict(0);
+}
+
+bool GlyphMaskCache::get(const GlyphMaskKey& key, GlyphMask& out) noexcept {
+  KeyMatcher matcher{key, key.hash_code()};
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  Node* node = _map.get(matcher);
+  if (!node) {
+    _miss_count++;
+    return false;
+  }
+
+  _hit_count++;
+  if (node != _lru.first()) {
+    _lru.unlink(node);
+    _lru.prepend(node);
+  }
+
+  out.image = node->mask.image;
+  out.offset = node->mask.offset;
+  return true;
+}
+
+BLResult GlyphMaskCache::put(const GlyphMaskKey& key, const GlyphMask& mask) noexcept {
+  BLSizeI size = mask.image.size();
+  size_t mask_size = size_t(uint32_t(size.w)) * size_t(uint32_t(size.h));
+
+  KeyMatcher matcher{key, key.hash_code()};
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  // Don't let a single mask flush a substantial part of the cache.
+  if (mask_size > _size_limit / 4u || !_count_limit)
+    return BL_SUCCESS;
+
+  // Another thread could have inserted the same mask while this one was rasterizing it.
+  if (_map.get(matcher))
+    return BL_SUCCESS;
+
+  _evict(mask_size);
+
+  Node* node = _node_pool.alloc(_allocator);
+  if (BL_UNLIKELY(!node))
+    return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+  bl_call_ctor(*node, matcher.hash_code(), key, mask, mask_size);
+  _map.insert(node);
+  _lru.prepend(node);
+  _mask_size += mask_size;
+
+  return BL_SUCCESS;
+}
+
+void GlyphMaskCache::clear() noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  while (!_lru.is_empty())
+    _remove_node(_lru.last());
+
+  _map.reset();
+  _node_pool.reset();
+  _allocator.reset();
+}
+
+// bl::RasterEngine - GlyphMaskCache - Internals
+// =============================================
+
+void GlyphMaskCache::_evict(size_t required_size) noexcept {
+  while (!_lru.is_empty() && (_mask_size + required_size > _size_limit || _map.size() >= _count_limit))
+    _remove_node(_lru.last());
+}
+
+void GlyphMaskCache::_remove_node(Node* node) noexcept {
+  _map.remove(node);
+  _lru.unlink(node);
+  _mask_size -= node->mask_size;
+
+  bl_call_dtor(*node);
+  _node_pool.free(node);
+}
+
+// bl::RasterEngine - GlyphMaskCache - Rasterization
+// =================================================
+
+BLResult create_glyph_mask(const BLFontCore* font, BLGlyphId glyph_id, const BLMatrix2D& transform, GlyphMask& out) noexcept {
+  BLPath path;
+  BL_PROPAGATE(bl_font_get_glyph_outlines(font, glyph_id, &transform, &path, nullptr, nullptr));
+
+  BLBox bbox;
+  if (path.is_empty() || path.get_bounding_box(&bbox) != BL_SUCCESS || !(bbox.x0 < bbox.x1 && bbox.y0 < bbox.y1)) {
+    out.image.reset();
+    out.offset.reset();
+    return BL_SUCCESS;
+  }
+
+  double x0 = Math::floor(bbox.x0);
+  double y0 = Math::floor(bbox.y0);
+  double x1 = Math::ceil(bbox.x1);
+  double y1 = Math::ceil(bbox.y1);
+
+  // The glyph transform is bounded by the caller, so this can only happen with a malformed font.
+  if (BL_UNLIKELY(!(x1 - x0 <= double(BL_RUNTIME_MAX_IMAGE_SIZE) && y1 - y0 <= double(BL_RUNTIME_MAX_IMAGE_SIZE))))
+    return bl_make_error(BL_ERROR_INVALID_GEOMETRY);
+
+  BL_PROPAGATE(out.image.create(int(x1 - x0), int(y1 - y0), BL_FORMAT_A8));
+  out.offset.reset(int(x0), int(y0));
+
+  BLContext ctx;
+  BL_PROPAGATE(ctx.begin(out.image));
+
+  ctx.clear_all();
+  ctx.set_comp_op(BL_COMP_OP_SRC_OVER);
+  ctx.fill_path(BLPoint(-x0, -y0), path, BLRgba32(0xFFFFFFFFu));
+
+  return ctx.end();
+}
+
+} // {bl::RasterEngine}
+
+// bl::RasterEngine - GlyphMaskCache - Runtime Registration
+// ========================================================
+
+static void BL_CDECL bl_glyph_mask_cache_rt_shutdown(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+  bl::RasterEngine::glyph_mask_cache_global.destroy();
+}
+
+static void BL_CDECL bl_glyph_mask_cache_rt_cleanup(BLRuntimeContext* rt, BLRuntimeCleanupFlags cleanup_flags) noexcept {
+  bl_unused(rt);
+  if (cleanup_flags & BL_RUNTIME_CLEANUP_GLYPH_CACHE)
+    bl::RasterEngine::glyph_mask_cache_global->clear();
+}
+
+static void BL_CDECL bl_glyph_mask_cache_rt_resource_info(BLRuntimeContext* rt, BLRuntimeResourceInfo* resource_info) noexcept {
+  bl_unused(rt);
+  resource_info->glyph_mask_count = bl::RasterEngine::glyph_mask_cache_global->size();
+  resource_info->glyph_mask_size = bl::RasterEngine::glyph_mask_cache_global->mask_size();
+}
+
+void bl_glyph_mask_cache_rt_init(BLRuntimeContext* rt) noexcept {
+  bl::RasterEngine::glyph_mask_cache_global.init();
+
+  rt->shutdown_handlers.add(bl_glyph_mask_cache_rt_shutdown);
+  rt->cleanup_handlers.add(bl_glyph_mask_cache_rt_cleanup);
+  rt->resource_info_handlers.add(bl_glyph_mask_cache_rt_resource_info);
+}
@@ -0,0 +1,195 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_RASTER_GLYPHMASKCACHE_P_H_INCLUDED
+#define BLEND2D_RASTER_GLYPHMASKCACHE_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/font.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/arenahashmap_p.h>
+#include <blend2d/support/arenalist_p.h>
+#include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/mutex_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_raster_engine_impl
+//! \{
+
+namespace bl::RasterEngine {
+
+//! Number of bits used to quantize a glyph origin into subpixel phases (per axis).
+static constexpr uint32_t kGlyphMaskPhaseShift = 2;
+//! Number of subpixel phases (per axis) a glyph origin is quantized to.
+static constexpr uint32_t kGlyphMaskPhaseCount = 1u << kGlyphMaskPhaseShift;
+
+//! Maximum em-size (in device pixels) of a font that can use cached glyph masks. Larger text is always rasterized
+//! directly, because masks of such glyphs would quickly exhaust the cache and they are cheap to rasterize compared
+//! to the area they cover.
+static constexpr double kGlyphMaskMaxEmSize = 128.0;
+
+//! Default size limit (in bytes) of all masks stored in the global glyph mask cache.
+static constexpr size_t kGlyphMaskCacheDefaultSizeLimit = 8u * 1024u * 1024u;
+//! Default limit of entries stored in the global glyph mask cache.
+static constexpr size_t kGlyphMaskCacheDefaultCountLimit = 16384u;
+
+//! Key that identifies a rasterized glyph mask.
+//!
+//! The transform is the linear part of the final (user and meta) transform, which describes the transform class
+//! of the rendered text - translation is not part of the key as it's split into an integral offset, which is used
+//! to position the mask, and a subpixel phase.
+struct GlyphMaskKey {
+  //! Font face unique id.
+  BLUniqueId face_id;
+  //! Linear part of the final transform [m00, m01, m10, m11].
+  double transform[4];
+  //! Font size.
+  float font_size;
+  //! Glyph id.
+  BLGlyphId glyph_id;
+  //! Horizontal subpixel phase [0, kGlyphMaskPhaseCount).
+  uint8_t phase_x;
+  //! Vertical subpixel phase [0, kGlyphMaskPhaseCount).
+  uint8_t phase_y;
+
+  BL_INLINE bool equals(const GlyphMaskKey& other) const noexcept {
+    return face_id == other.face_id &&
+           glyph_id == other.glyph_id &&
+           phase_x == other.phase_x &&
+           phase_y == other.phase_y &&
+           font_size == other.font_size &&
+           transform[0] == other.transform[0] &&
+           transform[1] == other.transform[1] &&
+           transform[2] == other.transform[2] &&
+           transform[3] == other.transform[3];
+  }
+
+  BL_HIDDEN uint32_t hash_code() const noexcept;
+};
+
+//! Rasterized glyph mask (A8) and its offset relative to the integral glyph origin.
+struct GlyphMask {
+  //! A8 coverage mask, empty if the glyph has no outlines (space, for example).
+  BLImage image;
+  //! Offset of the top-left corner of the mask relative to the integral glyph origin.
+  BLPointI offset;
+
+  BL_INLINE bool is_empty() const noexcept { return image.is_empty(); }
+};
+
+//! Bounded and thread-safe cache of rasterized glyph masks.
+//!
+//! Entries are kept in a LRU list and the least recently used entries are evicted when either the size limit or
+//! the count limit is reached. Masks are reference counted images, so a mask that was returned by `get()` remains
+//! valid even when it's evicted from the cache before it's consumed by the rendering context.
+class GlyphMaskCache {
+public:
+  BL_NONCOPYABLE(GlyphMaskCache)
+
+  class Node : public ArenaHashMapNode, public ArenaListNode<Node> {
+  public:
+    BL_NONCOPYABLE(Node)
+
+    GlyphMaskKey key;
+    GlyphMask mask;
+    size_t mask_size;
+
+    BL_INLINE Node(uint32_t hash_code, const GlyphMaskKey& key, const GlyphMask& mask, size_t mask_size) noexcept
+      : ArenaHashMapNode(hash_code),
+        key(key),
+        mask(mask),
+        mask_size(mask_size) {}
+  };
+
+  struct KeyMatcher {
+    const GlyphMaskKey& _key;
+    uint32_t _hash_code;
+
+    BL_INLINE uint32_t hash_code() const noexcept { return _hash_code; }
+    BL_INLINE bool matches(const Node* node) const noexcept { return node->key.equals(_key); }
+  };
+
+  //! \name Members
+  //! \{
+
+  BLMutex _mutex;
+  ArenaAllocator _allocator;
+  ArenaPool<Node> _node_pool;
+  ArenaHashMap<Node> _map;
+  //! LRU list - the first node is the most recently used one.
+  ArenaList<Node> _lru;
+
+  size_t _size_limit = kGlyphMaskCacheDefaultSizeLimit;
+  size_t _count_limit = kGlyphMaskCacheDefaultCountLimit;
+  size_t _mask_size = 0;
+  uint64_t _hit_count = 0;
+  uint64_t _miss_count = 0;
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE GlyphMaskCache() noexcept
+    : _allocator(16384),
+      _map(&_allocator) {}
+
+  BL_INLINE ~GlyphMaskCache() noexcept { clear(); }
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  BL_INLINE size_t size() noexcept { return _mutex.protect([&] { return _map.size(); }); }
+  BL_INLINE size_t mask_size() noexcept { return _mutex.protect([&] { return _mask_size; }); }
+  BL_INLINE uint64_t hit_count() noexcept { return _mutex.protect([&] { return _hit_count; }); }
+  BL_INLINE uint64_t miss_count() noexcept { return _mutex.protect([&] { return _miss_count; }); }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Sets cache limits and evicts entries that exceed them.
+  BL_HIDDEN void set_limits(size_t size_limit, size_t count_limit) noexcept;
+
+  //! Looks up a mask matching `key` and copies it to `out` if found.
+  BL_HIDDEN bool get(const GlyphMaskKey& key, GlyphMask& out) noexcept;
+
+  //! Inserts a mask matching `key` into the cache. Masks larger than a quarter of the size limit are not cached.
+  BL_HIDDEN BLResult put(const GlyphMaskKey& key, const GlyphMask& mask) noexcept;
+
+  //! Removes all masks from the cache and releases memory held by the cache.
+  BL_HIDDEN void clear() noexcept;
+
+  //! \}
+
+  //! \name Internals
+  //! \{
+
+  BL_HIDDEN void _evict(size_t required_size) noexcept;
+  BL_HIDDEN void _remove_node(Node* node) noexcept;
+
+  //! \}
+};
+
+BL_HIDDEN extern Wrap<GlyphMaskCache> glyph_mask_cache_global;
+
+//! Rasterizes a glyph `glyph_id` of `font` transformed by `transform` into an A8 mask.
+//!
+//! The `transform` must only contain the linear part of the final transform and a subpixel phase as translation.
+BL_HIDDEN BLResult create_glyph_mask(const BLFontCore* font, BLGlyphId glyph_id, const BLMatrix2D& transform, GlyphMask& out) noexcept;
+
+} // {bl::RasterEngine}
+
+BL_HIDDEN void bl_glyph_mask_cache_rt_init(BLRuntimeContext* rt) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_RASTER_GLYPHMASKCACHE_P_H_INCLUDED
@@ -0,0 +1,227 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/context.h>
+#include <blend2d/core/font.h>
+#include <blend2d/core/fontdata.h>
+#include <blend2d/core/fontface.h>
+#include <blend2d/core/image.h>
+#include <blend2d/raster/glyphmaskcache_p.h>
+
+#include <blend2d-testing/resources/abeezee_regular_ttf.h>
+
+// bl::RasterEngine - GlyphMaskCache - Tests
+// =========================================
+
+namespace bl::RasterEngine {
+namespace Tests {
+
+static GlyphMaskKey make_test_key(BLGlyphId glyph_id) noexcept {
+  GlyphMaskKey key {};
+  key.face_id = 1;
+  key.transform[0] = 1.0;
+  key.transform[3] = 1.0;
+  key.font_size = 16.0f;
+  key.glyph_id = glyph_id;
+  return key;
+}
+
+static GlyphMask make_test_mask(int w, int h) noexcept {
+  GlyphMask mask;
+  mask.image.create(w, h, BL_FORMAT_A8);
+  mask.offset.reset(0, -h);
+  return mask;
+}
+
+static void test_glyph_mask_cache_container() noexcept {
+  GlyphMaskCache cache;
+  cache.set_limits(1024u, 4u);
+
+  INFO("Testing insertion and lookup");
+  {
+    GlyphMask mask;
+    EXPECT_FALSE(cache.get(make_test_key(1), mask));
+    EXPECT_SUCCESS(cache.put(make_test_key(1), make_test_mask(8, 8)));
+    EXPECT_TRUE(cache.get(make_test_key(1), mask));
+    EXPECT_EQ(mask.image.size(), BLSizeI(8, 8));
+    EXPECT_EQ(mask.offset, BLPointI(0, -8));
+
+    GlyphMaskKey other_phase = make_test_key(1);
+    other_phase.phase_x = 1;
+    EXPECT_FALSE(cache.get(other_phase, mask));
+
+    EXPECT_EQ(cache.hit_count(), 1u);
+    EXPECT_EQ(cache.miss_count(), 2u);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.mask_size(), 64u);
+  }
+
+  INFO("Testing LRU eviction by count");
+  {
+    GlyphMask mask;
+    EXPECT_SUCCESS(cache.put(make_test_key(2), make_test_mask(4, 4)));
+    EXPECT_SUCCESS(cache.put(make_test_key(3), make_test_mask(4, 4)));
+    EXPECT_SUCCESS(cache.put(make_test_key(4), make_test_mask(4, 4)));
+
+    // Makes glyph 1 the most recently used, so glyph 2 must be evicted next.
+    EXPECT_TRUE(cache.get(make_test_key(1), mask));
+    EXPECT_SUCCESS(cache.put(make_test_key(5), make_test_mask(4, 4)));
+
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_TRUE(cache.get(make_test_key(1), mask));
+    EXPECT_FALSE(cache.get(make_test_key(2), mask));
+    EXPECT_TRUE(cache.get(make_test_key(5), mask));
+  }
+
+  INFO("Testing eviction by size and rejection of large masks");
+  {
+    GlyphMask mask;
+    EXPECT_SUCCESS(cache.put(make_test_key(6), make_test_mask(32, 32)));
+    EXPECT_FALSE(cache.get(make_test_key(6), mask));
+
+    EXPECT_SUCCESS(cache.put(make_test_key(7), make_test_mask(16, 16)));
+    EXPECT_SUCCESS(cache.put(make_test_key(8), make_test_mask(16, 16)));
+    EXPECT_SUCCESS(cache.put(make_test_key(9), make_test_mask(16, 16)));
+    EXPECT_SUCCESS(cache.put(make_test_key(10), make_test_mask(16, 16)));
+    EXPECT_LE(cache.mask_size(), 1024u);
+    EXPECT_TRUE(cache.get(make_test_key(10), mask));
+  }
+
+  INFO("Testing that masks returned by the cache outlive it");
+  {
+    GlyphMask mask;
+    EXPECT_TRUE(cache.get(make_test_key(10), mask));
+    cache.clear();
+
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.mask_size(), 0u);
+    EXPECT_EQ(mask.image.size(), BLSizeI(16, 16));
+  }
+}
+
+static uint32_t max_pixel_difference(const BLImage& a, const BLImage& b) noexcept {
+  BLImageData a_data;
+  BLImageData b_data;
+
+  a.get_data(&a_data);
+  b.get_data(&b_data);
+
+  uint32_t max_diff = 0;
+  for (int y = 0; y < a_data.size.h; y++) {
+    const uint8_t* a_line = static_cast<const uint8_t*>(a_data.pixel_data) + intptr_t(y) * a_data.stride;
+    const uint8_t* b_line = static_cast<const uint8_t*>(b_data.pixel_data) + intptr_t(y) * b_data.stride;
+
+    for (size_t x = 0; x < size_t(a_data.size.w) * 4u; x++) {
+      uint32_t diff = uint32_t(bl_abs(int(a_line[x]) - int(b_line[x])));
+      max_diff = bl_max(max_diff, diff);
+    }
+  }
+
+  return max_diff;
+}
+
+static void render_text(BLImage& image, const BLFont& font, uint32_t create_flags, uint32_t thread_count) noexcept {
+  BLContextCreateInfo create_info {};
+  create_info.flags = create_flags;
+  create_info.thread_count = thread_count;
+
+  EXPECT_SUCCESS(image.create(256, 128, BL_FORMAT_PRGB32));
+
+  BLContext ctx;
+  EXPECT_SUCCESS(ctx.begin(image, create_info));
+
+  ctx.fill_all(BLRgba32(0xFF000000u));
+  ctx.set_fill_style(BLRgba32(0xFFFFFFFFu));
+
+  // Glyphs placed at integral positions have no subpixel phase, thus their masks must match analytic rasterization.
+  static const char integral_text[] = "Glyph0123";
+  for (int i = 0; i < 2; i++) {
+    for (size_t j = 0; j < sizeof(integral_text) - 1u; j++) {
+      ctx.fill_utf8_text(BLPoint(4 + int(j) * 16, 24 + i * 30), font, integral_text + j, 1);
+    }
+  }
+
+  // Pixel aligned clip, which must be honored by mask fills.
+  ctx.save();
+  ctx.clip_to_rect(BLRectI(0, 0, 100, 128));
+  ctx.fill_utf8_text(BLPoint(92, 24), font, "W", 1);
+  ctx.restore();
+
+  EXPECT_SUCCESS(ctx.end());
+}
+
+static void render_text_run(BLImage& image, const BLFont& font, uint32_t create_flags, uint32_t thread_count) noexcept {
+  BLContextCreateInfo create_info {};
+  create_info.flags = create_flags;
+  create_info.thread_count = thread_count;
+
+  EXPECT_SUCCESS(image.create(256, 96, BL_FORMAT_PRGB32));
+
+  BLContext ctx;
+  EXPECT_SUCCESS(ctx.begin(image, create_info));
+
+  ctx.fill_all(BLRgba32(0xFF000000u));
+  ctx.set_fill_style(BLRgba32(0xFFFFFFFFu));
+
+  for (int i = 0; i < 3; i++)
+    ctx.fill_utf8_text(BLPoint(4.3, 24 + i * 30), font, "Glyph Cache 0123");
+
+  EXPECT_SUCCESS(ctx.end());
+}
+
+static void test_glyph_mask_cache_rendering() noexcept {
+  BLFontData font_data;
+  BLFontFace font_face;
+  BLFont font;
+
+  EXPECT_SUCCESS(font_data.create_from_data(resource_abeezee_regular_ttf, sizeof(resource_abeezee_regular_ttf)));
+  EXPECT_SUCCESS(font_face.create_from_data(font_data, 0));
+  EXPECT_SUCCESS(font.create_from_face(font_face, 20.0f));
+
+  // Glyph origins are quantized to 1/kGlyphMaskPhaseCount of a pixel, which bounds the coverage error of an edge.
+  constexpr uint32_t kMaxPhaseDifference = 255u / kGlyphMaskPhaseCount;
+
+  BLImage expected;
+  BLImage expected_run;
+
+  render_text(expected, font, BL_CONTEXT_CREATE_NO_FLAGS, 0);
+  render_text_run(expected_run, font, BL_CONTEXT_CREATE_NO_FLAGS, 0);
+
+  uint64_t hit_count = glyph_mask_cache_global->hit_count();
+
+  INFO("Testing that cached glyph masks match analytic rasterization (sync)");
+  {
+    BLImage actual;
+    render_text(actual, font, BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE, 0);
+    EXPECT_LE(max_pixel_difference(expected, actual), 2u);
+    EXPECT_GT(glyph_mask_cache_global->hit_count(), hit_count);
+
+    render_text_run(actual, font, BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE, 0);
+    EXPECT_LE(max_pixel_difference(expected_run, actual), kMaxPhaseDifference);
+  }
+
+  INFO("Testing that cached glyph masks match analytic rasterization (async)");
+  {
+    BLImage actual;
+    render_text(actual, font, BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE, 2);
+    EXPECT_LE(max_pixel_difference(expected, actual), 2u);
+
+    render_text_run(actual, font, BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE, 2);
+    EXPECT_LE(max_pixel_difference(expected_run, actual), kMaxPhaseDifference);
+  }
+}
+
+UNIT(glyph_mask_cache, BL_TEST_GROUP_RENDERING_UTILITIES) {
+  test_glyph_mask_cache_container();
+  test_glyph_mask_cache_rendering();
+}
+
+} // {Tests}
+} // {bl::RasterEngine}
+
+#endif // BL_TEST
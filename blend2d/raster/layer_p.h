@@ -0,0 +1,76 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_RASTER_LAYER_P_H_INCLUDED
+#define BLEND2D_RASTER_LAYER_P_H_INCLUDED
+
+#include <blend2d/core/image_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_raster_engine_impl
+//! \{
+
+namespace bl::RasterEngine {
+
+//! Maximum number of layer images kept by the rendering context for reuse.
+static constexpr uint32_t kLayerPoolCapacity = 4u;
+
+//! Render target of a layer.
+//!
+//! The target describes the layer image as if it had the size of the destination image - `data.pixel_data` points to
+//! a virtual pixel [0, 0] in device space, so pipelines and command processors can address the layer by using device
+//! coordinates. Only pixels within the layer box can be accessed.
+struct LayerTarget {
+  //! \name Members
+  //! \{
+
+  //! Layer image (retained by the owner of the layer target).
+  BLImageImpl* image;
+  //! Layer image data having a virtual origin at [0, 0] in device space.
+  BLImageData data;
+
+  //! \}
+};
+
+//! Layer created by `BLContext::begin_layer()`.
+//!
+//! A layer is an offscreen image that replaces the render target until the layer ends. When the layer ends its content
+//! is composited to the parent target by using the layer alpha and composition operator. The layer is owned by the
+//! \ref SavedState that was created by `begin_layer()`, so layers follow the lifetime of saved states.
+struct Layer {
+  //! \name Members
+  //! \{
+
+  //! Layer image, which is either pooled or newly created (empty if the layer box is empty).
+  BLImageCore image;
+  //! Layer target (image data having a virtual origin), see \ref LayerTarget.
+  LayerTarget target;
+  //! Layer box in device pixels - all pixels that can be rendered to while the layer is active.
+  BLBoxI box;
+  //! Alpha used to composite the layer (0..255 or 0..65535).
+  uint32_t alpha_i;
+  //! Composition operator used to composite the layer.
+  uint8_t comp_op;
+  //! Reserved.
+  uint8_t reserved[3];
+  //! Layer that was active when this layer began (null if it was the destination image).
+  Layer* prev_layer;
+
+  //! \}
+
+  //! \name Accessors
+  //! \{
+
+  BL_INLINE_NODEBUG bool is_empty() const noexcept { return box.x0 >= box.x1 || box.y0 >= box.y1; }
+
+  //! \}
+};
+
+} // {bl::RasterEngine}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_RASTER_LAYER_P_H_INCLUDED
@@ -5,7 +5,9 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/core/compopinfo_p.h>
+#include <blend2d/core/context.h>
 #include <blend2d/core/font_p.h>
+#include <blend2d/core/fontface_p.h>
 #include <blend2d/core/format_p.h>
 #include <blend2d/core/image_p.h>
 #include <blend2d/core/object_p.h>
@@ -19,6 +21,7 @@
 #include <blend2d/pixelops/scalar_p.h>
 #include <blend2d/pipeline/reference/fixedpiperuntime_p.h>
 #include <blend2d/raster/edgebuilder_p.h>
+#include <blend2d/raster/glyphmaskcache_p.h>
 #include <blend2d/raster/rastercontext_p.h>
 #include <blend2d/raster/rastercontextops_p.h>
 #include <blend2d/raster/rendercommand_p.h>
@@ -818,7 +821,38 @@ static BL_INLINE void on_before_clip_box_change(BLRasterContextImpl* ctx_impl) n
   if (bl_test_flag(ctx_impl->context_flags, ContextFlags::kWeakStateClip)) {
     SavedState* state = ctx_impl->saved_state;
     state->final_clip_box_d = ctx_impl->final_clip_box_d();
+    state->clip_mask = ctx_impl->clip_mask();
+
+    if (state->clip_mask.image)
+      ObjectInternal::retain_impl<RCMode::kMaybe>(state->clip_mask.image);
+  }
+}
+
+static BL_INLINE const ClipMask* clip_mask_if_active(const BLRasterContextImpl* ctx_impl) noexcept {
+  return ctx_impl->clip_mode() == BL_CLIP_MODE_MASK ? &ctx_impl->clip_mask() : nullptr;
+}
+
+static BL_INLINE void release_clip_mask(ClipMask& clip_mask) noexcept {
+  if (clip_mask.image) {
+    ImageInternal::release_impl<RCMode::kMaybe>(static_cast<BLImagePrivateImpl*>(clip_mask.image));
+    clip_mask.image = nullptr;
+  }
+}
+
+// Replaces the current clip mask by `clip_mask`, which must be already retained (or have no image).
+static BL_INLINE void replace_clip_mask(BLRasterContextImpl* ctx_impl, const ClipMask& clip_mask) noexcept {
+  if (ctx_impl->internal_state.clip_mask.image == clip_mask.image) {
+    // Nothing changed - only drop the reference that was acquired by the caller.
+    if (clip_mask.image)
+      ImageInternal::release_impl<RCMode::kMaybe>(static_cast<BLImagePrivateImpl*>(clip_mask.image));
+    return;
   }
+
+  release_clip_mask(ctx_impl->internal_state.clip_mask);
+  ctx_impl->internal_state.clip_mask = clip_mask;
+
+  // The mask has to be registered again by the next command that uses it (asynchronous rendering).
+  ctx_impl->clip_mask_slot = 0;
 }
 
 static BL_INLINE void reset_clipping_to_meta_clip_box(BLRasterContextImpl* ctx_impl) noexcept {
@@ -829,7 +863,10 @@ static BL_INLINE void reset_clipping_to_meta_clip_box(BLRasterContextImpl* ctx_i
 }
 
 static BL_INLINE void restore_clipping_from_state(BLRasterContextImpl* ctx_impl, SavedState* saved_state) noexcept {
-  // TODO: [Rendering Context] Path-based clipping.
+  if (saved_state->clip_mask.image)
+    ObjectInternal::retain_impl<RCMode::kMaybe>(saved_state->clip_mask.image);
+  replace_clip_mask(ctx_impl, saved_state->clip_mask);
+
   ctx_impl->internal_state.final_clip_box_d = saved_state->final_clip_box_d;
   ctx_impl->internal_state.final_clip_box_i.reset(
     Math::trunc_to_int(ctx_impl->final_clip_box_d().x0),
@@ -845,6 +882,59 @@ static BL_INLINE void restore_clipping_from_state(BLRasterContextImpl* ctx_impl,
     ctx_impl->final_clip_box_d().y1 * fp_scale));
 }
 
+// bl::RasterEngine - ContextImpl - Internals - Layer State
+// =========================================================
+
+// Must be called when `ctx_impl->layer` changes - the synchronous rendering context renders directly to the target
+// of the current layer and the pipeline signature depends on its pixel format.
+static BL_INLINE void on_after_layer_changed(BLRasterContextImpl* ctx_impl) noexcept {
+  const Layer* layer = ctx_impl->layer;
+
+  if (ctx_impl->is_sync())
+    ctx_impl->sync_work_data.ctx_data.dst = layer ? layer->target.data : ctx_impl->dst_data;
+
+  // The layer has to be registered again by the next command that uses it (asynchronous rendering).
+  ctx_impl->layer_slot = 0;
+  on_after_comp_op_changed(ctx_impl);
+}
+
+// Returns the target of the parent of a layer that would begin now.
+static BL_INLINE LayerTarget current_layer_target(const BLRasterContextImpl* ctx_impl) noexcept {
+  return ctx_impl->layer ? ctx_impl->layer->target : LayerTarget{nullptr, ctx_impl->dst_data};
+}
+
+// Acquires an image that has at least `w` by `h` pixels - images in the pool are only reused when nothing else
+// references them (asynchronous rendering releases images used by a render batch when the batch is flushed).
+static BLResult acquire_layer_image(BLRasterContextImpl* ctx_impl, BLImageCore* dst, int w, int h, BLFormat format) noexcept {
+  for (uint32_t i = 0; i < ctx_impl->layer_pool_size; i++) {
+    BLImagePrivateImpl* image_impl = ImageInternal::get_impl(&ctx_impl->layer_pool[i]);
+
+    if (image_impl->format == uint32_t(format) && image_impl->size.w >= w && image_impl->size.h >= h &&
+        ObjectInternal::is_impl_ref_count_equal_to_base(image_impl)) {
+      *dst = ctx_impl->layer_pool[i];
+      ctx_impl->layer_pool[i] = ctx_impl->layer_pool[--ctx_impl->layer_pool_size];
+      return BL_SUCCESS;
+    }
+  }
+
+  bl_image_init(dst);
+  return bl_image_create(dst, w, h, format);
+}
+
+// Returns the image of `layer` to the pool or releases it if the pool is full.
+static void release_layer_image(BLRasterContextImpl* ctx_impl, Layer& layer) noexcept {
+  if (!layer.is_empty() && ctx_impl->layer_pool_size < kLayerPoolCapacity)
+    ctx_impl->layer_pool[ctx_impl->layer_pool_size++] = layer.image;
+  else
+    ImageInternal::release_instance(&layer.image);
+}
+
+static void release_layer_pool(BLRasterContextImpl* ctx_impl) noexcept {
+  for (uint32_t i = 0; i < ctx_impl->layer_pool_size; i++)
+    ImageInternal::release_instance(&ctx_impl->layer_pool[i]);
+  ctx_impl->layer_pool_size = 0;
+}
+
 // bl::RasterEngine - ContextImpl - Internals - Clip Utilities
 // ===========================================================
 
@@ -1018,6 +1108,79 @@ static BL_INLINE void release_batch_fetch_data(BLRasterContextImpl* ctx_impl, Re
   }
 }
 
+static BL_INLINE void release_batch_clip_masks(RenderBatch* batch) noexcept {
+  for (uint32_t i = 0; i < batch->_clip_mask_count; i++)
+    ImageInternal::release_impl<RCMode::kMaybe>(static_cast<BLImagePrivateImpl*>(batch->_clip_mask_data[i].image));
+}
+
+// Registers the current clip mask in the current batch so commands can reference it by a slot - the batch retains
+// the mask image, so the clip mask can change (or be destroyed) before the batch is processed.
+static BL_NOINLINE BLResult register_clip_mask(BLRasterContextImpl* ctx_impl) noexcept {
+  WorkerManager& mgr = ctx_impl->worker_mgr();
+  RenderBatch* batch = mgr.current_batch();
+
+  uint32_t count = batch->_clip_mask_count;
+  if (count == batch->_clip_mask_capacity) {
+    uint32_t new_capacity = bl_max<uint32_t>(batch->_clip_mask_capacity * 2u, 16u);
+    ClipMask* new_data = mgr._allocator.allocT<ClipMask>(new_capacity * sizeof(ClipMask));
+
+    if (BL_UNLIKELY(!new_data))
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+    if (count)
+      memcpy(new_data, batch->_clip_mask_data, count * sizeof(ClipMask));
+
+    batch->_clip_mask_data = new_data;
+    batch->_clip_mask_capacity = new_capacity;
+  }
+
+  const ClipMask& clip_mask = ctx_impl->clip_mask();
+  ObjectInternal::retain_impl<RCMode::kMaybe>(clip_mask.image);
+
+  batch->_clip_mask_data[count] = clip_mask;
+  batch->_clip_mask_count = count + 1u;
+  ctx_impl->clip_mask_slot = count + 1u;
+
+  return BL_SUCCESS;
+}
+
+static BL_INLINE void release_batch_layer_targets(RenderBatch* batch) noexcept {
+  for (uint32_t i = 0; i < batch->_layer_target_count; i++)
+    ImageInternal::release_impl<RCMode::kMaybe>(static_cast<BLImagePrivateImpl*>(batch->_layer_target_data[i].image));
+}
+
+// Registers the target of the current layer in the current batch so commands can reference it by a slot - the batch
+// retains the layer image, so the layer can end (and its image can be returned to the pool) before the batch is
+// processed.
+static BL_NOINLINE BLResult register_layer(BLRasterContextImpl* ctx_impl) noexcept {
+  WorkerManager& mgr = ctx_impl->worker_mgr();
+  RenderBatch* batch = mgr.current_batch();
+
+  uint32_t count = batch->_layer_target_count;
+  if (count == batch->_layer_target_capacity) {
+    uint32_t new_capacity = bl_max<uint32_t>(batch->_layer_target_capacity * 2u, 16u);
+    LayerTarget* new_data = mgr._allocator.allocT<LayerTarget>(new_capacity * sizeof(LayerTarget));
+
+    if (BL_UNLIKELY(!new_data))
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+    if (count)
+      memcpy(new_data, batch->_layer_target_data, count * sizeof(LayerTarget));
+
+    batch->_layer_target_data = new_data;
+    batch->_layer_target_capacity = new_capacity;
+  }
+
+  const LayerTarget& target = ctx_impl->layer->target;
+  ObjectInternal::retain_impl<RCMode::kMaybe>(target.image);
+
+  batch->_layer_target_data[count] = target;
+  batch->_layer_target_count = count + 1u;
+  ctx_impl->layer_slot = count + 1u;
+
+  return BL_SUCCESS;
+}
+
 static BL_NOINLINE BLResult flush_render_batch(BLRasterContextImpl* ctx_impl) noexcept {
   WorkerManager& mgr = ctx_impl->worker_mgr();
   if (mgr.has_pending_commands()) {
@@ -1033,11 +1196,19 @@ static BL_NOINLINE BLResult flush_render_batch(BLRasterContextImpl* ctx_impl) no
       work_data->init_context_data(ctx_impl->dst_data, ctx_impl->sync_work_data.ctx_data.pixel_origin);
     }
 
-    // Just to make sure that all the changes are visible to the threads.
-    synchronization->before_start(thread_count, batch->job_count() > 0);
+    if (mgr.uses_scheduler()) {
+      // Scheduler threads can be busy with batches of other rendering contexts, so jobs and bands are claimed
+      // dynamically by whichever thread is available - the user thread would process everything in the worst case.
+      synchronization->before_start_shared(thread_count, batch->job_count());
+      mgr._scheduler->submit(mgr._scheduler_tasks, thread_count);
+    }
+    else {
+      // Just to make sure that all the changes are visible to the threads.
+      synchronization->before_start(thread_count, batch->job_count() > 0);
 
-    for (uint32_t i = 0; i < thread_count; i++) {
-      mgr._worker_threads[i]->run(WorkerProc::worker_thread_entry, mgr._work_data_storage[i]);
+      for (uint32_t i = 0; i < thread_count; i++) {
+        mgr._worker_threads[i]->run(WorkerProc::worker_thread_entry, mgr._work_data_storage[i]);
+      }
     }
 
     // User thread acts as a worker too.
@@ -1052,17 +1223,28 @@ static BL_NOINLINE BLResult flush_render_batch(BLRasterContextImpl* ctx_impl) no
       work_state.restore(*work_data);
     }
 
+    if (mgr.uses_scheduler()) {
+      // All the work has been either done or claimed at this point - tasks that haven't started yet are not needed.
+      uint32_t canceled_count = mgr._scheduler->cancel(mgr._scheduler_tasks, thread_count);
+      for (uint32_t i = 0; i < canceled_count; i++)
+        synchronization->thread_done();
+    }
+
     if (thread_count) {
       synchronization->wait_for_threads_to_finish();
       ctx_impl->sync_work_data._accumulated_error_flags |= bl_atomic_fetch_relaxed(&batch->_accumulated_error_flags);
     }
 
     release_batch_fetch_data(ctx_impl, batch->_command_list.first());
+    release_batch_clip_masks(batch);
+    release_batch_layer_targets(batch);
 
     mgr._allocator.clear();
     mgr.init_first_batch();
 
     ctx_impl->sync_work_data.start_over();
+    ctx_impl->clip_mask_slot = 0;
+    ctx_impl->layer_slot = 0;
     ctx_impl->context_flags &= ~ContextFlags::kSharedStateAllFlags;
     ctx_impl->shared_fill_state = nullptr;
     ctx_impl->shared_stroke_state = nullptr;
@@ -1071,6 +1253,33 @@ static BL_NOINLINE BLResult flush_render_batch(BLRasterContextImpl* ctx_impl) no
   return BL_SUCCESS;
 }
 
+// Makes sure that the current clip mask can be registered by the next command - a command references a clip mask by
+// a 16-bit slot, so the batch has to be flushed in the unlikely case that the clip mask table of the batch is full.
+static BL_INLINE BLResult ensure_clip_mask_slot_available(BLRasterContextImpl* ctx_impl) noexcept {
+  constexpr uint32_t kMaxClipMaskCount = 0xFFFFu;
+
+  if (ctx_impl->is_sync() || ctx_impl->clip_mask_slot || !ctx_impl->clip_mask().image)
+    return BL_SUCCESS;
+
+  if (BL_UNLIKELY(ctx_impl->worker_mgr->current_batch()->clip_mask_count() >= kMaxClipMaskCount))
+    return flush_render_batch(ctx_impl);
+
+  return BL_SUCCESS;
+}
+
+// The same as `ensure_clip_mask_slot_available()`, but for the target of the current layer.
+static BL_INLINE BLResult ensure_layer_slot_available(BLRasterContextImpl* ctx_impl) noexcept {
+  constexpr uint32_t kMaxLayerTargetCount = 0xFFFFu;
+
+  if (ctx_impl->is_sync() || ctx_impl->layer_slot || !ctx_impl->layer || !ctx_impl->layer->target.image)
+    return BL_SUCCESS;
+
+  if (BL_UNLIKELY(ctx_impl->worker_mgr->current_batch()->layer_target_count() >= kMaxLayerTargetCount))
+    return flush_render_batch(ctx_impl);
+
+  return BL_SUCCESS;
+}
+
 // bl::RasterEngine - ContextImpl - Internals - Render Call - Data Allocation
 // ==========================================================================
 
@@ -1149,6 +1358,10 @@ static BL_INLINE BLResult ensure_fetch_and_dispatch_data(
     BLRasterContextImpl* ctx_impl,
     Pipeline::Signature signature, RenderFetchDataHeader* fetch_data, Pipeline::DispatchData* out) noexcept {
 
+  // Coverage of all commands is combined with the clip mask and composited by a mask pipeline when it's active.
+  if (ctx_impl->clip_mode() == BL_CLIP_MODE_MASK)
+    signature.set_fill_type(Pipeline::FillType::kMask);
+
   // Must be inlined for greater performance.
   auto m = Pipeline::cache_lookup(ctx_impl->pipe_lookup_cache, signature.value);
 
@@ -1608,6 +1821,16 @@ static void discard_states(BLRasterContextImpl* ctx_impl, SavedState* top_state)
       bl_call_dtor(saved_state->stroke_options.dash_array);
     }
 
+    if (!bl_test_flag(context_flags, ContextFlags::kWeakStateClip)) {
+      release_clip_mask(saved_state->clip_mask);
+    }
+
+    // Layers that were not ended are discarded without being composited.
+    if (saved_state->has_layer) {
+      ctx_impl->layer = saved_state->layer.prev_layer;
+      release_layer_image(ctx_impl, saved_state->layer);
+    }
+
     SavedState* prev_state = saved_state->prev_state;
     context_flags = saved_state->prev_context_flags;
 
@@ -1632,6 +1855,7 @@ static BLResult BL_CDECL save_impl(BLContextImpl* base_impl, BLContextCookie* co
 
   new_state->prev_state = ctx_impl->saved_state;
   new_state->state_id = Traits::max_value<uint64_t>();
+  new_state->has_layer = 0;
 
   ctx_impl->saved_state = new_state;
   ctx_impl->internal_state.saved_state_count++;
@@ -1650,31 +1874,14 @@ static BLResult BL_CDECL save_impl(BLContextImpl* base_impl, BLContextCookie* co
   return BL_SUCCESS;
 }
 
-static BLResult BL_CDECL restore_impl(BLContextImpl* base_impl, const BLContextCookie* cookie) noexcept {
-  BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
-  SavedState* saved_state = ctx_impl->saved_state;
-
-  if (BL_UNLIKELY(!saved_state))
-    return bl_make_error(BL_ERROR_NO_STATES_TO_RESTORE);
-
-  // By default there would be only one state to restore if `cookie` was not provided.
-  uint32_t n = 1;
-
-  if (cookie) {
-    // Verify context origin.
-    if (BL_UNLIKELY(cookie->data[0] != ctx_impl->context_origin_id))
-      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+template<RenderingMode kRM>
+static BLResult composite_layer(BLRasterContextImpl* ctx_impl, const Layer& layer) noexcept;
 
-    // Verify cookie payload and get the number of states we have to restore (if valid).
-    n = get_num_states_to_restore(saved_state, cookie->data[1]);
-    if (BL_UNLIKELY(n == 0))
-      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
-  }
-  else {
-    // A state that has a `state_id` assigned cannot be restored without a matching cookie.
-    if (saved_state->state_id != Traits::max_value<uint64_t>())
-      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
-  }
+// Restores `n` states - each layer that began by a restored state is composited to its parent target when its state
+// is restored. Restoring continues when compositing a layer fails, but the first error is returned.
+static BLResult restore_states(BLRasterContextImpl* ctx_impl, uint32_t n) noexcept {
+  SavedState* saved_state = ctx_impl->saved_state;
+  BLResult result = BL_SUCCESS;
 
   ContextFlags kPreservedFlags = ContextFlags::kPreservedFlags | ContextFlags::kSharedStateAllFlags;
   ContextFlags context_flags_to_keep = ctx_impl->context_flags & kPreservedFlags;
@@ -1694,6 +1901,7 @@ static BLResult BL_CDECL restore_impl(BLContextImpl* base_impl, const BLContextC
 
     if (!bl_test_flag(current_flags, ContextFlags::kWeakStateClip)) {
       restore_clipping_from_state(ctx_impl, saved_state);
+      release_clip_mask(saved_state->clip_mask);
       context_flags_to_keep &= ~ContextFlags::kSharedStateFill;
     }
 
@@ -1745,16 +1953,68 @@ static BLResult BL_CDECL restore_impl(BLContextImpl* base_impl, const BLContextC
 
     SavedState* finished_saved_state = saved_state;
     saved_state = saved_state->prev_state;
-
     ctx_impl->saved_state = saved_state;
-    ctx_impl->free_saved_state(finished_saved_state);
+
+    if (finished_saved_state->has_layer) {
+      // The layer is composited to its parent by using the restored state (clip and clip mask of the parent).
+      Layer layer = finished_saved_state->layer;
+      ctx_impl->free_saved_state(finished_saved_state);
+
+      ctx_impl->layer = layer.prev_layer;
+      on_after_layer_changed(ctx_impl);
+
+      ctx_impl->context_flags = (ctx_impl->context_flags & ~kPreservedFlags) | context_flags_to_keep;
+      BLResult local_result = ctx_impl->is_sync() ? composite_layer<kSync>(ctx_impl, layer)
+                                                  : composite_layer<kAsync>(ctx_impl, layer);
+      release_layer_image(ctx_impl, layer);
+
+      if (result == BL_SUCCESS)
+        result = local_result;
+      context_flags_to_keep = ctx_impl->context_flags & kPreservedFlags;
+    }
+    else {
+      ctx_impl->free_saved_state(finished_saved_state);
+    }
 
     if (--n == 0)
       break;
   }
 
   ctx_impl->context_flags = (ctx_impl->context_flags & ~kPreservedFlags) | context_flags_to_keep;
-  return BL_SUCCESS;
+
+  BLResult slot_result = ensure_clip_mask_slot_available(ctx_impl);
+  if (slot_result == BL_SUCCESS)
+    slot_result = ensure_layer_slot_available(ctx_impl);
+  return result != BL_SUCCESS ? result : slot_result;
+}
+
+static BLResult BL_CDECL restore_impl(BLContextImpl* base_impl, const BLContextCookie* cookie) noexcept {
+  BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
+  SavedState* saved_state = ctx_impl->saved_state;
+
+  if (BL_UNLIKELY(!saved_state))
+    return bl_make_error(BL_ERROR_NO_STATES_TO_RESTORE);
+
+  // By default there would be only one state to restore if `cookie` was not provided.
+  uint32_t n = 1;
+
+  if (cookie) {
+    // Verify context origin.
+    if (BL_UNLIKELY(cookie->data[0] != ctx_impl->context_origin_id))
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+
+    // Verify cookie payload and get the number of states we have to restore (if valid).
+    n = get_num_states_to_restore(saved_state, cookie->data[1]);
+    if (BL_UNLIKELY(n == 0))
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+  }
+  else {
+    // A state that has a `state_id` assigned cannot be restored without a matching cookie.
+    if (saved_state->state_id != Traits::max_value<uint64_t>())
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+  }
+
+  return restore_states(ctx_impl, n);
 }
 
 // bl::RasterEngine - ContextImpl - Frontend - Transformations
@@ -2187,7 +2447,9 @@ static BLResult clip_to_final_box(BLRasterContextImpl* ctx_impl, const BLBox& in
 
     int32_t bits = clipBoxFixedI.x0 | clipBoxFixedI.y0 | clipBoxFixedI.x1 | clipBoxFixedI.y1;
 
-    if ((bits & fpMaskI) == 0)
+    if (ctx_impl->clip_mask().image)
+      ctx_impl->sync_work_data.clip_mode = BL_CLIP_MODE_MASK;
+    else if ((bits & fpMaskI) == 0)
       ctx_impl->sync_work_data.clip_mode = BL_CLIP_MODE_ALIGNED_RECT;
     else
       ctx_impl->sync_work_data.clip_mode = BL_CLIP_MODE_UNALIGNED_RECT;
@@ -2204,6 +2466,18 @@ static BLResult clip_to_final_box(BLRasterContextImpl* ctx_impl, const BLBox& in
   return BL_SUCCESS;
 }
 
+// Clips to the box of `layer` - a layer is never clipped by the clip mask of its parent as the mask is applied when
+// the layer is composited, so the mask is saved (if the clip state is weak) and removed from the current clip.
+static BLResult clip_to_layer(BLRasterContextImpl* ctx_impl, const Layer& layer) noexcept {
+  if (ctx_impl->clip_mask().image) {
+    on_before_clip_box_change(ctx_impl);
+    ctx_impl->context_flags &= ~ContextFlags::kWeakStateClip;
+    replace_clip_mask(ctx_impl, ClipMask{});
+  }
+
+  return clip_to_final_box(ctx_impl, BLBox(double(layer.box.x0), double(layer.box.y0), double(layer.box.x1), double(layer.box.y1)));
+}
+
 static BLResult BL_CDECL clip_to_rect_d_impl(BLContextImpl* base_impl, const BLRect* rect) noexcept {
   BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
 
@@ -2287,16 +2561,126 @@ static BLResult BL_CDECL restore_clipping_impl(BLContextImpl* base_impl) noexcep
       ctx_impl->sync_work_data.clip_mode = state->clip_mode;
       ctx_impl->context_flags &= ~(ContextFlags::kNoClipRect | ContextFlags::kWeakStateClip | ContextFlags::kSharedStateFill);
       ctx_impl->context_flags |= (state->prev_context_flags & ContextFlags::kNoClipRect);
+
+      // The clip of a state that began a layer is the clip of its parent, which must not escape the layer box.
+      if (state->has_layer)
+        clip_to_layer(ctx_impl, state->layer);
     }
     else {
       // If there is no state saved it means that we have to restore clipping to
       // the initial state, which is accessible through `meta_clip_box_i` member.
       ctx_impl->context_flags &= ~(ContextFlags::kNoClipRect | ContextFlags::kSharedStateFill);
       reset_clipping_to_meta_clip_box(ctx_impl);
+
+      if (ctx_impl->clip_mask().image) {
+        replace_clip_mask(ctx_impl, ClipMask{});
+        ctx_impl->sync_work_data.clip_mode = BL_CLIP_MODE_ALIGNED_RECT;
+      }
     }
   }
 
-  return BL_SUCCESS;
+  return ensure_clip_mask_slot_available(ctx_impl);
+}
+
+// Multiplies `dst` (covering `dst_box`) by the coverage of `src` clip mask - pixels outside of `src` are clipped out.
+static void intersect_clip_masks(const BLImageData& dst, const BLBoxI& dst_box, const ClipMask& src) noexcept {
+  int src_x0 = bl_max(dst_box.x0, src.box.x0);
+  int src_x1 = bl_min(dst_box.x1, src.box.x1);
+
+  for (int y = dst_box.y0; y < dst_box.y1; y++) {
+    uint8_t* dst_row = static_cast<uint8_t*>(dst.pixel_data) + intptr_t(y - dst_box.y0) * dst.stride - dst_box.x0;
+
+    if (y < src.box.y0 || y >= src.box.y1 || src_x0 >= src_x1) {
+      memset(dst_row + dst_box.x0, 0, size_t(dst_box.x1 - dst_box.x0));
+      continue;
+    }
+
+    const uint8_t* src_row = src.pixel_ptr(src_x0, y) - src_x0;
+    for (int x = dst_box.x0; x < dst_box.x1; x++) {
+      uint32_t c = (x >= src_x0 && x < src_x1) ? uint32_t(src_row[x]) : 0u;
+      dst_row[x] = uint8_t(PixelOps::Scalar::udiv255(uint32_t(dst_row[x]) * c));
+    }
+  }
+}
+
+static BLResult BL_CDECL clip_to_geometry_impl(BLContextImpl* base_impl, BLGeometryType type, const void* data) noexcept {
+  BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
+
+  if (BL_UNLIKELY(uint32_t(type) > BL_GEOMETRY_TYPE_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  // Clipping to boxes and rectangles doesn't need a clip mask if the transformation keeps them axis aligned.
+  if (ctx_impl->final_transform_type() <= BL_TRANSFORM_TYPE_SCALE) {
+    BLBox box;
+    switch (type) {
+      case BL_GEOMETRY_TYPE_NONE: return clip_to_final_box(ctx_impl, BLBox(0, 0, 0, 0));
+      case BL_GEOMETRY_TYPE_BOXI: box.reset(*static_cast<const BLBoxI*>(data)); break;
+      case BL_GEOMETRY_TYPE_BOXD: box = *static_cast<const BLBox*>(data); break;
+      case BL_GEOMETRY_TYPE_RECTI: {
+        const BLRectI* r = static_cast<const BLRectI*>(data);
+        box.reset(double(r->x), double(r->y), double(r->x) + double(r->w), double(r->y) + double(r->h));
+        break;
+      }
+      case BL_GEOMETRY_TYPE_RECTD: {
+        const BLRect* r = static_cast<const BLRect*>(data);
+        box.reset(r->x, r->y, r->x + r->w, r->y + r->h);
+        break;
+      }
+      default:
+        goto UseMask;
+    }
+    return clip_to_final_box(ctx_impl, TransformInternal::map_box(ctx_impl->final_transform(), box));
+  }
+
+UseMask:
+  BLPath path;
+  BL_PROPAGATE(path.add_geometry(type, data, &ctx_impl->final_transform()));
+
+  BLBox path_box {};
+  if (path.get_bounding_box(&path_box) != BL_SUCCESS)
+    path_box.reset();
+
+  // Narrows the clip box (and saves the clip state if it's weak) - the clip mask only has to cover the clip box.
+  BL_PROPAGATE(clip_to_final_box(ctx_impl, path_box));
+  if (bl_test_flag(ctx_impl->context_flags, ContextFlags::kNoClipRect))
+    return BL_SUCCESS;
+
+  // The integral clip box can be recalculated from the floating point clip box when the clip state is restored, which
+  // can make it one pixel larger than it's now, so the clip mask is one pixel larger in each direction.
+  BLBoxI mask_box;
+  const BLBoxI& clip_box = ctx_impl->final_clip_box_i();
+  Geometry::intersect(mask_box, BLBoxI(clip_box.x0 - 1, clip_box.y0 - 1, clip_box.x1 + 1, clip_box.y1 + 1), ctx_impl->meta_clip_box_i());
+
+  BLImage mask_image;
+  BL_PROPAGATE(mask_image.create(mask_box.x1 - mask_box.x0, mask_box.y1 - mask_box.y0, BL_FORMAT_A8));
+
+  {
+    BLContext mask_ctx;
+    BL_PROPAGATE(mask_ctx.begin(mask_image));
+
+    mask_ctx.clear_all();
+    mask_ctx.set_comp_op(BL_COMP_OP_SRC_OVER);
+    mask_ctx.set_fill_rule(ctx_impl->fill_rule());
+    mask_ctx.fill_path(BLPoint(-mask_box.x0, -mask_box.y0), path, BLRgba32(0xFFFFFFFFu));
+    BL_PROPAGATE(mask_ctx.end());
+  }
+
+  BLImageData mask_data;
+  BL_PROPAGATE(mask_image.get_data(&mask_data));
+
+  // Clipping to a geometry intersects the current clip with it.
+  if (ctx_impl->clip_mask().image)
+    intersect_clip_masks(mask_data, mask_box, ctx_impl->clip_mask());
+
+  ClipMask clip_mask;
+  clip_mask.image = ImageInternal::get_impl(&mask_image);
+  clip_mask.box = mask_box;
+  ObjectInternal::retain_impl<RCMode::kMaybe>(clip_mask.image);
+
+  replace_clip_mask(ctx_impl, clip_mask);
+  ctx_impl->sync_work_data.clip_mode = BL_CLIP_MODE_MASK;
+
+  return ensure_clip_mask_slot_available(ctx_impl);
 }
 
 // bl::RasterEngine - ContextImpl - Mask & Blit Utilities
@@ -2421,6 +2805,19 @@ static BL_INLINE BLResult enqueue_command(
   WorkerManager& mgr = ctx_impl->worker_mgr();
   constexpr uint32_t kRetainsStyleFetchDataShift = IntOps::bit_shift_of(uint32_t(RenderCommandFlags::kRetainsStyleFetchData));
 
+  if (ctx_impl->clip_mode() == BL_CLIP_MODE_MASK) {
+    if (!ctx_impl->clip_mask_slot)
+      BL_PROPAGATE(register_clip_mask(ctx_impl));
+    command->_clip_mask_slot = uint16_t(ctx_impl->clip_mask_slot);
+  }
+
+  // NOTE: An empty layer has the target of its parent, which doesn't have to be a layer.
+  if (ctx_impl->layer && ctx_impl->layer->target.image) {
+    if (!ctx_impl->layer_slot)
+      BL_PROPAGATE(register_layer(ctx_impl));
+    command->_layer_slot = uint16_t(ctx_impl->layer_slot);
+  }
+
   if (fetch_data->is_solid()) {
     command->_source.solid = static_cast<RenderFetchDataSolid*>(fetch_data)->pipeline_data;
   }
@@ -2640,7 +3037,7 @@ BL_INLINE BLResult fill_clipped_box_a<kSync>(BLRasterContextImpl* ctx_impl, Disp
   di.add_fill_type(Pipeline::FillType::kBoxA);
   BL_PROPAGATE(ensure_fetch_and_dispatch_data(ctx_impl, di.signature, ds.fetch_data, &dispatch_data));
 
-  return CommandProcSync::fill_box_a(ctx_impl->sync_work_data, dispatch_data, di.alpha, box_a, ds.fetch_data->get_pipeline_data());
+  return CommandProcSync::fill_box_a(ctx_impl->sync_work_data, dispatch_data, di.alpha, box_a, clip_mask_if_active(ctx_impl), ds.fetch_data->get_pipeline_data());
 }
 
 template<>
@@ -2666,7 +3063,7 @@ BL_INLINE BLResult fill_clipped_box_u<kSync>(BLRasterContextImpl* ctx_impl, Disp
   di.add_fill_type(Pipeline::FillType::kMask);
   BL_PROPAGATE(ensure_fetch_and_dispatch_data(ctx_impl, di.signature, ds.fetch_data, &dispatch_data));
 
-  return CommandProcSync::fill_box_u(ctx_impl->sync_work_data, dispatch_data, di.alpha, box_u, ds.fetch_data->get_pipeline_data());
+  return CommandProcSync::fill_box_u(ctx_impl->sync_work_data, dispatch_data, di.alpha, box_u, clip_mask_if_active(ctx_impl), ds.fetch_data->get_pipeline_data());
 }
 
 template<>
@@ -2748,7 +3145,7 @@ BL_NOINLINE BLResult fill_clipped_edges<kSync>(BLRasterContextImpl* ctx_impl, Di
     return result;
   }
 
-  return CommandProcSync::fill_analytic(work_data, dispatch_data, di.alpha, &edge_storage, fill_rule, ds.fetch_data->get_pipeline_data());
+  return CommandProcSync::fill_analytic(work_data, dispatch_data, di.alpha, &edge_storage, fill_rule, clip_mask_if_active(ctx_impl), ds.fetch_data->get_pipeline_data());
 }
 
 template<>
@@ -3072,16 +3469,223 @@ BLResult BL_NOINLINE fill_unclipped_geometry<kAsync>(BLRasterContextImpl* ctx_im
   }
 }
 
-// bl::RasterEngine - ContextImpl - Internals - Fill Unclipped Text
-// ================================================================
+// bl::RasterEngine - ContextImpl - Internals - Fill Mask
+// ======================================================
 
 template<RenderingMode kRM>
-static BLResult fill_unclipped_text(BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* data) noexcept;
+static BLResult fill_clipped_box_masked_a(
+    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
+    const BLBoxI& box_a, const BLImageCore* mask, const BLPointI& mask_offset_i) noexcept;
 
 template<>
-BL_NOINLINE BLResult fill_unclipped_text<kSync>(BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* data) noexcept {
-  const BLGlyphRun* glyph_run = nullptr;
+BL_NOINLINE BLResult fill_clipped_box_masked_a<kSync>(
+    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
+    const BLBoxI& box_a, const BLImageCore* mask, const BLPointI& mask_offset_i) noexcept {
+
+  Pipeline::DispatchData dispatch_data;
+
+  di.add_fill_type(Pipeline::FillType::kMask);
+  BL_PROPAGATE(ensure_fetch_and_dispatch_data(ctx_impl, di.signature, ds.fetch_data, &dispatch_data));
+
+  RenderCommand::FillBoxMaskA payload;
+  payload.mask_image_i.ptr = ImageInternal::get_impl(mask);
+  payload.mask_offset_i = mask_offset_i;
+  payload.box_i = box_a;
+  return CommandProcSync::fill_box_masked_a(ctx_impl->sync_work_data, dispatch_data, di.alpha, payload, clip_mask_if_active(ctx_impl), ds.fetch_data->get_pipeline_data());
+}
 
+template<>
+BL_NOINLINE BLResult fill_clipped_box_masked_a<kAsync>(
+    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
+    const BLBoxI& box_a, const BLImageCore* mask, const BLPointI& mask_offset_i) noexcept {
+
+  RenderCommand* command = ctx_impl->worker_mgr->current_command();
+
+  di.add_fill_type(Pipeline::FillType::kMask);
+  BL_PROPAGATE(ensure_fetch_and_dispatch_data(ctx_impl, di.signature, ds.fetch_data, command->pipe_dispatch_data()));
+
+  command->init_command(di.alpha);
+  command->init_fill_box_mask_a(box_a, mask, mask_offset_i);
+
+  uint8_t qy0 = uint8_t(box_a.y0 >> ctx_impl->command_quantization_shift_aa());
+
+  return enqueue_command(ctx_impl, command, qy0, ds.fetch_data, [&](RenderCommand* command) noexcept {
+    // The mask is released by `release_batch_fetch_data()`, which only visits commands that have a fetch data mark.
+    ObjectInternal::retain_impl<RCMode::kMaybe>(command->_payload.box_mask_a.mask_image_i.ptr);
+    command->add_flags(RenderCommandFlags::kRetainsMaskImageData);
+    ctx_impl->worker_mgr()._command_appender.mark_fetch_data();
+  });
+}
+
+// bl::RasterEngine - ContextImpl - Internals - Fill Glyph Run Masks
+// =================================================================
+
+// Unlike `handle_queues_full_or_pools_exhausted()` this never flushes the current batch, because it's called by
+// render calls that enqueue more than a single command, which requires the style fetch data to stay valid.
+static BL_NOINLINE BLResult grow_full_command_queue(BLRasterContextImpl* ctx_impl) noexcept {
+  WorkerManager& mgr = ctx_impl->worker_mgr();
+
+  if (mgr.is_command_queue_full()) {
+    mgr.before_grow_command_queue();
+    BL_PROPAGATE(mgr._grow_command_queue());
+  }
+
+  return BL_SUCCESS;
+}
+
+// Glyph masks are only used when they can produce the same coverage as the analytic rasterizer, except the
+// quantization of the glyph origin, which is documented by `BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE`.
+static BL_INLINE bool can_fill_glyph_run_masks(const BLRasterContextImpl* ctx_impl, const BLFontCore* font) noexcept {
+  if (!ctx_impl->glyph_mask_cache_enabled || ctx_impl->clip_mode() != BL_CLIP_MODE_ALIGNED_RECT)
+    return false;
+
+  const BLFontPrivateImpl* font_impl = FontInternal::get_impl(font);
+  if (!font_impl->variation_settings.dcast().is_empty())
+    return false;
+
+  const BLMatrix2D& ft = ctx_impl->final_transform();
+  double scale = bl_max(bl_abs(ft.m00) + bl_abs(ft.m01), bl_abs(ft.m10) + bl_abs(ft.m11));
+  double em_size = double(font_impl->metrics.size) * scale;
+
+  return em_size > 0.0 && em_size <= kGlyphMaskMaxEmSize;
+}
+
+template<RenderingMode kRM>
+static BL_INLINE BLResult fill_glyph_mask(
+    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
+    const BLFontCore* font, GlyphMaskKey& key, const BLPoint& glyph_origin) noexcept {
+
+  // Glyphs that are that far are always clipped, this also rejects NaNs.
+  constexpr double kMaxOrigin = 268435456.0;
+
+  double px = glyph_origin.x * double(kGlyphMaskPhaseCount);
+  double py = glyph_origin.y * double(kGlyphMaskPhaseCount);
+
+  if (!(bl_abs(px) < kMaxOrigin && bl_abs(py) < kMaxOrigin))
+    return BL_SUCCESS;
+
+  int qx = Math::floor_to_int(px + 0.5);
+  int qy = Math::floor_to_int(py + 0.5);
+
+  key.phase_x = uint8_t(uint32_t(qx) & (kGlyphMaskPhaseCount - 1u));
+  key.phase_y = uint8_t(uint32_t(qy) & (kGlyphMaskPhaseCount - 1u));
+
+  GlyphMaskCache& cache = glyph_mask_cache_global();
+  GlyphMask mask;
+
+  if (!cache.get(key, mask)) {
+    constexpr double kPhaseScale = 1.0 / double(kGlyphMaskPhaseCount);
+    BLMatrix2D transform(key.transform[0], key.transform[1], key.transform[2], key.transform[3],
+                         double(key.phase_x) * kPhaseScale, double(key.phase_y) * kPhaseScale);
+
+    BL_PROPAGATE(create_glyph_mask(font, key.glyph_id, transform, mask));
+    BL_PROPAGATE(cache.put(key, mask));
+  }
+
+  if (mask.is_empty())
+    return BL_SUCCESS;
+
+  BLSizeI mask_size = mask.image.size();
+  int mx = ((qx - int(key.phase_x)) >> kGlyphMaskPhaseShift) + mask.offset.x;
+  int my = ((qy - int(key.phase_y)) >> kGlyphMaskPhaseShift) + mask.offset.y;
+
+  const BLBoxI& clip_box = ctx_impl->final_clip_box_i();
+  BLBoxI box(bl_max(mx, clip_box.x0),
+             bl_max(my, clip_box.y0),
+             bl_min(mx + mask_size.w, clip_box.x1),
+             bl_min(my + mask_size.h, clip_box.y1));
+
+  if (box.x0 >= box.x1 || box.y0 >= box.y1)
+    return BL_SUCCESS;
+
+  if constexpr (kRM == kAsync) {
+    if (bl_test_flag(ctx_impl->context_flags, ContextFlags::kMTFullOrExhausted))
+      BL_PROPAGATE(grow_full_command_queue(ctx_impl));
+  }
+
+  return fill_clipped_box_masked_a<kRM>(ctx_impl, di, ds, box, &mask.image, BLPointI(box.x0 - mx, box.y0 - my));
+}
+
+// Composites cached glyph masks instead of rasterizing glyph outlines. Glyph placement must match the placement
+// calculated by `bl_font_get_glyph_run_outlines()`, which is used by the analytic rasterization path.
+template<RenderingMode kRM>
+static BL_NOINLINE BLResult fill_glyph_run_masks(
+    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
+    const BLPoint* origin, const BLFontCore* font, const BLGlyphRun* glyph_run) noexcept {
+
+  const BLFontPrivateImpl* font_impl = FontInternal::get_impl(font);
+  const BLFontFacePrivateImpl* face_impl = FontFaceInternal::get_impl(&font_impl->face);
+  const BLMatrix2D& ft = ctx_impl->final_transform();
+
+  GlyphMaskKey key;
+  key.face_id = face_impl->unique_id;
+  key.transform[0] = ft.m00;
+  key.transform[1] = ft.m01;
+  key.transform[2] = ft.m10;
+  key.transform[3] = ft.m11;
+  key.font_size = font_impl->metrics.size;
+  key.glyph_id = 0;
+  key.phase_x = 0;
+  key.phase_y = 0;
+
+  BLMatrix2D glyph_transform;
+  bl_font_matrix_multiply(&glyph_transform, &font_impl->matrix, &ft);
+
+  BLPoint glyph_origin = ft.map_point(*origin);
+  BLGlyphRunIterator it(*glyph_run);
+  uint32_t placement_type = glyph_run->placement_type;
+
+  if (it.has_placement() && placement_type != BL_GLYPH_PLACEMENT_TYPE_NONE) {
+    const BLMatrix2D& offset_transform = placement_type == BL_GLYPH_PLACEMENT_TYPE_USER_UNITS ? ft : glyph_transform;
+
+    if (placement_type == BL_GLYPH_PLACEMENT_TYPE_ADVANCE_OFFSET) {
+      BLPoint advance_origin = glyph_origin;
+
+      while (!it.at_end()) {
+        const BLGlyphPlacement& pos = it.placement<BLGlyphPlacement>();
+        double px = pos.placement.x;
+        double py = pos.placement.y;
+
+        key.glyph_id = it.glyph_id();
+        BL_PROPAGATE(fill_glyph_mask<kRM>(ctx_impl, di, ds, font, key,
+          BLPoint(px * offset_transform.m00 + py * offset_transform.m10 + advance_origin.x,
+                  px * offset_transform.m01 + py * offset_transform.m11 + advance_origin.y)));
+        it.advance();
+
+        px = pos.advance.x;
+        py = pos.advance.y;
+        advance_origin.x += px * offset_transform.m00 + py * offset_transform.m10;
+        advance_origin.y += px * offset_transform.m01 + py * offset_transform.m11;
+      }
+    }
+    else {
+      while (!it.at_end()) {
+        const BLPoint& placement = it.placement<BLPoint>();
+
+        key.glyph_id = it.glyph_id();
+        BL_PROPAGATE(fill_glyph_mask<kRM>(ctx_impl, di, ds, font, key,
+          BLPoint(placement.x * offset_transform.m00 + placement.y * offset_transform.m10 + glyph_origin.x,
+                  placement.x * offset_transform.m01 + placement.y * offset_transform.m11 + glyph_origin.y)));
+        it.advance();
+      }
+    }
+  }
+  else {
+    while (!it.at_end()) {
+      key.glyph_id = it.glyph_id();
+      BL_PROPAGATE(fill_glyph_mask<kRM>(ctx_impl, di, ds, font, key, glyph_origin));
+      it.advance();
+    }
+  }
+
+  return BL_SUCCESS;
+}
+
+// bl::RasterEngine - ContextImpl - Internals - Fill Unclipped Text
+// ================================================================
+
+// Shapes the text (if the render call is a text call) by using a glyph buffer provided by the synchronous work data.
+static BL_INLINE BLResult get_glyph_run_of_text_op(BLRasterContextImpl* ctx_impl, const BLFontCore* font, BLContextRenderTextOp op_type, const void* data, const BLGlyphRun** out) noexcept {
   if (op_type <= BLContextRenderTextOp(BL_TEXT_ENCODING_MAX_VALUE)) {
     BLTextEncoding encoding = static_cast<BLTextEncoding>(op_type);
     const BLDataView* view = static_cast<const BLDataView*>(data);
@@ -3089,18 +3693,32 @@ BL_NOINLINE BLResult fill_unclipped_text<kSync>(BLRasterContextImpl* ctx_impl, D
     BLGlyphBuffer& gb = ctx_impl->sync_work_data.glyph_buffer;
     BL_PROPAGATE(gb.set_text(view->data, view->size, encoding));
     BL_PROPAGATE(font->dcast().shape(gb));
-    glyph_run = &gb.glyph_run();
+    *out = &gb.glyph_run();
+    return BL_SUCCESS;
   }
   else if (op_type == BL_CONTEXT_RENDER_TEXT_OP_GLYPH_RUN) {
-    glyph_run = static_cast<const BLGlyphRun*>(data);
+    *out = static_cast<const BLGlyphRun*>(data);
+    return BL_SUCCESS;
   }
   else {
     return bl_make_error(BL_ERROR_INVALID_VALUE);
   }
+}
+
+template<RenderingMode kRM>
+static BLResult fill_unclipped_text(BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* data) noexcept;
+
+template<>
+BL_NOINLINE BLResult fill_unclipped_text<kSync>(BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* data) noexcept {
+  const BLGlyphRun* glyph_run = nullptr;
+  BL_PROPAGATE(get_glyph_run_of_text_op(ctx_impl, font, op_type, data, &glyph_run));
 
   if (glyph_run->is_empty())
     return BL_SUCCESS;
 
+  if (can_fill_glyph_run_masks(ctx_impl, font))
+    return fill_glyph_run_masks<kSync>(ctx_impl, di, ds, origin, font, glyph_run);
+
   BLPoint origin_fixed = ctx_impl->final_transform_fixed().map_point(*origin);
   WorkData* work_data = &ctx_impl->sync_work_data;
 
@@ -3110,6 +3728,18 @@ BL_NOINLINE BLResult fill_unclipped_text<kSync>(BLRasterContextImpl* ctx_impl, D
 
 template<>
 BL_NOINLINE BLResult fill_unclipped_text<kAsync>(BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds, const BLPoint* origin, const BLFontCore* font, BLContextRenderTextOp op_type, const void* data) noexcept {
+  // Cached glyph masks are cheap to composite, so the text is shaped by the user thread in this case and only
+  // mask fills are enqueued instead of text jobs.
+  if (can_fill_glyph_run_masks(ctx_impl, font)) {
+    const BLGlyphRun* glyph_run = nullptr;
+    BL_PROPAGATE(get_glyph_run_of_text_op(ctx_impl, font, op_type, data, &glyph_run));
+
+    if (glyph_run->is_empty())
+      return BL_SUCCESS;
+
+    return fill_glyph_run_masks<kAsync>(ctx_impl, di, ds, origin, font, glyph_run);
+  }
+
   if (op_type <= BLContextRenderTextOp(BL_TEXT_ENCODING_MAX_VALUE)) {
     const BLDataView* view = static_cast<const BLDataView*>(data);
     BLTextEncoding encoding = static_cast<BLTextEncoding>(op_type);
@@ -3128,51 +3758,6 @@ BL_NOINLINE BLResult fill_unclipped_text<kAsync>(BLRasterContextImpl* ctx_impl,
   }
 }
 
-// bl::RasterEngine - ContextImpl - Internals - Fill Mask
-// ======================================================
-
-template<RenderingMode kRM>
-static BLResult fill_clipped_box_masked_a(
-    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
-    const BLBoxI& box_a, const BLImageCore* mask, const BLPointI& mask_offset_i) noexcept;
-
-template<>
-BL_NOINLINE BLResult fill_clipped_box_masked_a<kSync>(
-    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
-    const BLBoxI& box_a, const BLImageCore* mask, const BLPointI& mask_offset_i) noexcept {
-
-  Pipeline::DispatchData dispatch_data;
-
-  di.add_fill_type(Pipeline::FillType::kMask);
-  BL_PROPAGATE(ensure_fetch_and_dispatch_data(ctx_impl, di.signature, ds.fetch_data, &dispatch_data));
-
-  RenderCommand::FillBoxMaskA payload;
-  payload.mask_image_i.ptr = ImageInternal::get_impl(mask);
-  payload.mask_offset_i = mask_offset_i;
-  payload.box_i = box_a;
-  return CommandProcSync::fill_box_masked_a(ctx_impl->sync_work_data, dispatch_data, di.alpha, payload, ds.fetch_data->get_pipeline_data());
-}
-
-template<>
-BL_NOINLINE BLResult fill_clipped_box_masked_a<kAsync>(
-    BLRasterContextImpl* ctx_impl, DispatchInfo di, DispatchStyle ds,
-    const BLBoxI& box_a, const BLImageCore* mask, const BLPointI& mask_offset_i) noexcept {
-
-  RenderCommand* command = ctx_impl->worker_mgr->current_command();
-
-  di.add_fill_type(Pipeline::FillType::kMask);
-  BL_PROPAGATE(ensure_fetch_and_dispatch_data(ctx_impl, di.signature, ds.fetch_data, command->pipe_dispatch_data()));
-
-  command->init_command(di.alpha);
-  command->init_fill_box_mask_a(box_a, mask, mask_offset_i);
-
-  uint8_t qy0 = uint8_t(box_a.y0 >> ctx_impl->command_quantization_shift_aa());
-
-  return enqueue_command(ctx_impl, command, qy0, ds.fetch_data, [&](RenderCommand* command) noexcept {
-    ObjectInternal::retain_impl<RCMode::kMaybe>(command->_payload.box_mask_a.mask_image_i.ptr);
-  });
-}
-
 // bl::RasterEngine - ContextImpl - Internals - Stroke Unclipped Path
 // ==================================================================
 
@@ -4148,6 +4733,137 @@ static BLResult BL_CDECL blit_scaled_image_i_impl(BLContextImpl* base_impl, cons
   return finalize_explicit_op<kRM>(ctx_impl, fetch_data.ptr(), fill_unclipped_box_d<kRM>(ctx_impl, di, ds, final_box));
 }
 
+// bl::RasterEngine - ContextImpl - Frontend - Layers
+// ==================================================
+
+// Composites `layer` to the current target (the parent of the layer) like a blit of the layer image would, but by
+// using the layer alpha and composition operator instead of the current ones.
+template<RenderingMode kRM>
+static BLResult composite_layer(BLRasterContextImpl* ctx_impl, const Layer& layer) noexcept {
+  if (layer.is_empty() || !layer.alpha_i || bl_test_flag(ctx_impl->context_flags, ContextFlags::kNoClipRect))
+    return BL_SUCCESS;
+
+  BLBoxI dst_box;
+  if (!Geometry::intersect(dst_box, layer.box, ctx_impl->final_clip_box_i()))
+    return BL_SUCCESS;
+
+  BLImagePrivateImpl* image_impl = ImageInternal::get_impl(&layer.image);
+  const CompOpSimplifyInfo& simplify_info = comp_op_simplify_info(CompOpExt(layer.comp_op), ctx_impl->format(), FormatExt(image_impl->format));
+
+  CompOpSolidId solid_id = simplify_info.solid_id();
+  if (solid_id == CompOpSolidId::kAlwaysNop)
+    return BL_SUCCESS;
+
+  if constexpr (kRM == kAsync) {
+    if (bl_test_flag(ctx_impl->context_flags, ContextFlags::kMTFullOrExhausted))
+      BL_PROPAGATE(handle_queues_full_or_pools_exhausted(ctx_impl));
+  }
+
+  RenderFetchDataStorage<kRM> fetch_data(ctx_impl);
+
+  DispatchInfo di;
+  DispatchStyle ds;
+  di.init(simplify_info.signature(), layer.alpha_i);
+
+  if (solid_id == CompOpSolidId::kNone) {
+    if constexpr (kRM == RenderingMode::kAsync)
+      fetch_data->init_style_object_and_destroy_func(&layer.image, destroy_fetch_data_image);
+
+    fetch_data->init_image_source(image_impl, BLRectI(dst_box.x0 - layer.box.x0, dst_box.y0 - layer.box.y0, dst_box.x1 - dst_box.x0, dst_box.y1 - dst_box.y0));
+    fetch_data->setup_pattern_blit(dst_box.x0, dst_box.y0);
+
+    prepare_non_solid_fetch(ctx_impl, di, ds, fetch_data.ptr());
+  }
+  else {
+    prepare_overridden_fetch(ctx_impl, di, ds, solid_id);
+  }
+
+  return finalize_explicit_op<kRM>(ctx_impl, fetch_data.ptr(), fill_clipped_box_a<kRM>(ctx_impl, di, ds, dst_box));
+}
+
+static BLResult BL_CDECL begin_layer_impl(BLContextImpl* base_impl, const BLRect* bounds, double alpha, BLCompOp comp_op) noexcept {
+  BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
+
+  if (BL_UNLIKELY(Math::is_nan(alpha) || uint32_t(comp_op) > BL_COMP_OP_MAX_VALUE))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  BL_PROPAGATE(save_impl(ctx_impl, nullptr));
+
+  if (bounds)
+    clip_to_rect_d_impl(ctx_impl, bounds);
+
+  SavedState* state = ctx_impl->saved_state;
+  Layer& layer = state->layer;
+
+  bl_image_init(&layer.image);
+  layer.box = bl_test_flag(ctx_impl->context_flags, ContextFlags::kNoClipRect) ? BLBoxI(0, 0, 0, 0) : ctx_impl->final_clip_box_i();
+  layer.alpha_i = uint32_t(Math::round_to_int(bl_clamp(alpha, 0.0, 1.0) * ctx_impl->full_alpha_d()));
+  layer.comp_op = uint8_t(comp_op);
+  layer.prev_layer = ctx_impl->layer;
+
+  if (layer.is_empty()) {
+    // Nothing can be rendered to an empty layer as everything is clipped out, so it doesn't need an image.
+    layer.target = current_layer_target(ctx_impl);
+  }
+  else {
+    int w = layer.box.x1 - layer.box.x0;
+    int h = layer.box.y1 - layer.box.y0;
+    BLFormat format = ctx_impl->dst_data.format == BL_FORMAT_A8 ? BL_FORMAT_A8 : BL_FORMAT_PRGB32;
+
+    BLResult result = acquire_layer_image(ctx_impl, &layer.image, w, h, format);
+    if (BL_UNLIKELY(result != BL_SUCCESS)) {
+      ImageInternal::release_instance(&layer.image);
+      restore_states(ctx_impl, 1);
+      return result;
+    }
+
+    // The layer target has a virtual origin, so the layer can be addressed by using device coordinates.
+    BLImagePrivateImpl* image_impl = ImageInternal::get_impl(&layer.image);
+    uint32_t bytes_per_pixel = image_impl->depth / 8u;
+    uint8_t* pixel_data = static_cast<uint8_t*>(image_impl->pixel_data);
+
+    layer.target.image = image_impl;
+    layer.target.data.pixel_data = pixel_data - intptr_t(layer.box.y0) * image_impl->stride - intptr_t(layer.box.x0) * intptr_t(bytes_per_pixel);
+    layer.target.data.stride = image_impl->stride;
+    layer.target.data.size = ctx_impl->dst_data.size;
+    layer.target.data.format = image_impl->format;
+    layer.target.data.flags = 0;
+
+    // Layers start transparent - the image is only accessed by the user thread at this point, as pooled images
+    // referenced by a render batch are never reused.
+    for (int y = 0; y < h; y++)
+      memset(pixel_data + intptr_t(y) * image_impl->stride, 0, size_t(w) * bytes_per_pixel);
+  }
+
+  state->has_layer = 1;
+  ctx_impl->layer = &layer;
+  on_after_layer_changed(ctx_impl);
+
+  if (!layer.is_empty())
+    BL_PROPAGATE(clip_to_layer(ctx_impl, layer));
+
+  return ensure_layer_slot_available(ctx_impl);
+}
+
+static BLResult BL_CDECL end_layer_impl(BLContextImpl* base_impl) noexcept {
+  BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
+  SavedState* saved_state = ctx_impl->saved_state;
+
+  // Ending a layer restores all states saved since the layer began, which cannot be done if one of them needs a cookie.
+  uint32_t n = 1;
+  while (saved_state && !saved_state->has_layer) {
+    if (saved_state->state_id != Traits::max_value<uint64_t>())
+      return bl_make_error(BL_ERROR_NO_MATCHING_COOKIE);
+    saved_state = saved_state->prev_state;
+    n++;
+  }
+
+  if (BL_UNLIKELY(!saved_state))
+    return bl_make_error(BL_ERROR_INVALID_STATE);
+
+  return restore_states(ctx_impl, n);
+}
+
 // bl::RasterEngine - ContextImpl - Attach & Detach
 // ================================================
 
@@ -4330,6 +5046,7 @@ static BLResult attach(BLRasterContextImpl* ctx_impl, BLImageCore* image, const
   }
 
   ctx_impl->context_flags = ContextFlags::kInfoIntegralTranslation;
+  ctx_impl->glyph_mask_cache_enabled = uint8_t((options->flags & BL_CONTEXT_CREATE_FLAG_GLYPH_MASK_CACHE) != 0);
 
   if (!ctx_impl->is_sync()) {
     ctx_impl->virt = &raster_impl_virt_async;
@@ -4343,6 +5060,13 @@ static BLResult attach(BLRasterContextImpl* ctx_impl, BLImageCore* image, const
 
   // Initialize the pipeline runtime and pipeline lookup cache.
   ctx_impl->pipe_provider.init(pipe_runtime);
+
+#if !defined(BL_BUILD_NO_JIT)
+  if ((options->flags & BL_CONTEXT_CREATE_FLAG_ASYNC_JIT_COMPILATION) && pipe_runtime->runtime_type() == Pipeline::PipeRuntimeType::kJIT) {
+    ctx_impl->pipe_provider.init(pipe_runtime, static_cast<Pipeline::JIT::PipeDynamicRuntime*>(pipe_runtime)->_async_funcs);
+  }
+#endif
+
   ctx_impl->pipe_lookup_cache.reset();
 
   // Initialize the sync work data.
@@ -4414,6 +5138,10 @@ static BLResult attach(BLRasterContextImpl* ctx_impl, BLImageCore* image, const
 
   ctx_impl->internal_state.meta_clip_box_i.reset(0, 0, size.w, size.h);
   // `final_clip_box_i` and `final_clip_box_d` are initialized by `reset_clipping_to_meta_clip_box()`.
+  ctx_impl->internal_state.clip_mask = ClipMask{};
+  ctx_impl->clip_mask_slot = 0;
+  ctx_impl->layer = nullptr;
+  ctx_impl->layer_slot = 0;
 
   if (options->saved_state_limit)
     ctx_impl->saved_state_limit = options->saved_state_limit;
@@ -4455,6 +5183,8 @@ static BLResult detach(BLRasterContextImpl* ctx_impl) noexcept {
   // over all of them and release resources they hold.
   discard_states(ctx_impl, nullptr);
   bl_call_dtor(ctx_impl->internal_state.stroke_options);
+  release_clip_mask(ctx_impl->internal_state.clip_mask);
+  release_layer_pool(ctx_impl);
 
   ContextFlags context_flags = ctx_impl->context_flags;
   if (bl_test_flag(context_flags, ContextFlags::kFetchDataFill))
@@ -4511,6 +5241,8 @@ static void init_virt(BLContextVirt* virt) noexcept {
 
   virt->save                        = save_impl;
   virt->restore                     = restore_impl;
+  virt->begin_layer                 = begin_layer_impl;
+  virt->end_layer                   = end_layer_impl;
 
   virt->apply_transform_op          = apply_transform_op_impl;
   virt->user_to_meta                = user_to_meta_impl;
@@ -4548,6 +5280,7 @@ static void init_virt(BLContextVirt* virt) noexcept {
   virt->clip_to_rect_i              = clip_to_rect_i_impl;
   virt->clip_to_rect_d              = clip_to_rect_d_impl;
   virt->restore_clipping            = restore_clipping_impl;
+  virt->clip_to_geometry            = clip_to_geometry_impl;
 
   virt->clear_all                   = clear_all_impl<kRM>;
   virt->clear_recti                 = clear_rect_i_impl<kRM>;
@@ -4638,9 +5371,23 @@ BLResult bl_raster_context_init_impl(BLContextCore* self, BLImageCore* image, co
   return result;
 }
 
-void bl_raster_context_on_init(BLRuntimeContext* rt) noexcept {
-  bl_unused(rt);
+BLResult bl_raster_context_set_pixel_origin(BLContextCore* self, const BLPointI& pixel_origin) noexcept {
+  BLContextImpl* base_impl = self->_impl();
+
+  if (BL_UNLIKELY(base_impl->context_type != BL_CONTEXT_TYPE_RASTER))
+    return bl_make_error(BL_ERROR_INVALID_STATE);
 
+  BLRasterContextImpl* ctx_impl = static_cast<BLRasterContextImpl*>(base_impl);
+  BL_PROPAGATE(ctx_impl->virt->flush(ctx_impl, BL_CONTEXT_FLUSH_SYNC));
+
+  ctx_impl->sync_work_data.ctx_data.pixel_origin = pixel_origin;
+  return BL_SUCCESS;
+}
+
+void bl_raster_context_on_init(BLRuntimeContext* rt) noexcept {
   bl::RasterEngine::init_virt<bl::RasterEngine::RenderingMode::kSync>(&bl::RasterEngine::raster_impl_virt_sync);
   bl::RasterEngine::init_virt<bl::RasterEngine::RenderingMode::kAsync>(&bl::RasterEngine::raster_impl_virt_async);
+
+  bl_glyph_mask_cache_rt_init(rt);
+  bl_render_scheduler_rt_init(rt);
 }
@@ -17,6 +17,8 @@
 #include <blend2d/pipeline/piperuntime_p.h>
 #include <blend2d/raster/analyticrasterizer_p.h>
 #include <blend2d/raster/edgebuilder_p.h>
+#include <blend2d/raster/glyphmaskcache_p.h>
+#include <blend2d/raster/layer_p.h>
 #include <blend2d/raster/rasterdefs_p.h>
 #include <blend2d/raster/rendercommand_p.h>
 #include <blend2d/raster/renderfetchdata_p.h>
@@ -78,6 +80,8 @@ public:
   uint8_t rendering_mode;
   //! Whether worker_mgr has been initialized.
   uint8_t worker_mgr_initialized;
+  //! Whether filled text should be rendered through the glyph mask cache.
+  uint8_t glyph_mask_cache_enabled;
   //! Precision information.
   bl::RasterEngine::RenderTargetInfo render_target_info;
 
@@ -126,6 +130,17 @@ public:
 
   //! The number of states that can be saved by `BLContext::save()` call.
   uint32_t saved_state_limit;
+  //! Slot of the current clip mask in the current render batch (asynchronous rendering), zero if not registered yet.
+  uint32_t clip_mask_slot;
+  //! Slot of the current layer in the current render batch (asynchronous rendering), zero if not registered yet.
+  uint32_t layer_slot;
+  //! Count of images in `layer_pool`.
+  uint32_t layer_pool_size;
+
+  //! The current layer or null if the render target is the destination image.
+  bl::RasterEngine::Layer* layer;
+  //! Layer images that can be reused by the next `begin_layer()`.
+  BLImageCore layer_pool[bl::RasterEngine::kLayerPoolCapacity];
 
   //! Destination image.
   BLImageCore dst_image;
@@ -149,6 +164,7 @@ public:
     : context_flags(bl::RasterEngine::ContextFlags::kNoFlagsSet),
       rendering_mode(uint8_t(bl::RasterEngine::RenderingMode::kSync)),
       worker_mgr_initialized(false),
+      glyph_mask_cache_enabled(false),
       render_target_info {},
       sync_work_data(this, nullptr),
       pipe_lookup_cache{},
@@ -166,6 +182,11 @@ public:
       context_origin_id(BLUniqueIdGenerator::generate_id(BLUniqueIdGenerator::Domain::kContext)),
       state_id_counter(0),
       saved_state_limit(0),
+      clip_mask_slot(0),
+      layer_slot(0),
+      layer_pool_size(0),
+      layer(nullptr),
+      layer_pool{},
       dst_image{},
       dst_data{},
       fp_min_safe_coord_d(0.0),
@@ -219,7 +240,8 @@ public:
 
   BL_INLINE_NODEBUG bool is_sync() const noexcept { return rendering_mode == uint8_t(bl::RasterEngine::RenderingMode::kSync); }
 
-  BL_INLINE_NODEBUG bl::FormatExt format() const noexcept { return bl::FormatExt(dst_data.format); }
+  //! Returns the pixel format of the current render target, which is either the destination image or a layer.
+  BL_INLINE_NODEBUG bl::FormatExt format() const noexcept { return bl::FormatExt(layer ? layer->target.data.format : dst_data.format); }
   BL_INLINE_NODEBUG double fp_scale_d() const noexcept { return render_target_info.fp_scale_d; }
   BL_INLINE_NODEBUG double full_alpha_d() const noexcept { return render_target_info.full_alpha_d; }
 
@@ -234,6 +256,7 @@ public:
   //! \{
 
   BL_INLINE_NODEBUG uint8_t clip_mode() const noexcept { return sync_work_data.clip_mode; }
+  BL_INLINE_NODEBUG const bl::RasterEngine::ClipMask& clip_mask() const noexcept { return internal_state.clip_mask; }
 
   BL_INLINE_NODEBUG uint8_t comp_op() const noexcept { return internal_state.comp_op; }
   BL_INLINE_NODEBUG BLFillRule fill_rule() const noexcept { return BLFillRule(internal_state.fill_rule); }
@@ -283,6 +306,11 @@ public:
 };
 
 BL_HIDDEN BLResult bl_raster_context_init_impl(BLContextCore* self, BLImageCore* image, const BLContextCreateInfo* options) noexcept;
+
+//! Changes the pixel origin (see \ref BLContextCreateInfo::pixel_origin) of a raster rendering context `self`.
+//!
+//! Pending render commands are flushed first as they must use the pixel origin they were submitted with.
+BL_HIDDEN BLResult bl_raster_context_set_pixel_origin(BLContextCore* self, const BLPointI& pixel_origin) noexcept;
 BL_HIDDEN void bl_raster_context_on_init(BLRuntimeContext* rt) noexcept;
 
 //! \}
@@ -7,6 +7,8 @@
 #define BLEND2D_RASTER_RENDERBATCH_P_H_INCLUDED
 
 #include <blend2d/core/image.h>
+#include <blend2d/raster/clipmask_p.h>
+#include <blend2d/raster/layer_p.h>
 #include <blend2d/raster/rasterdefs_p.h>
 #include <blend2d/raster/renderqueue_p.h>
 #include <blend2d/support/arenaallocator_p.h>
@@ -32,6 +34,10 @@ public:
     //! Can go out of range in case there is no more jobs to process.
     size_t _job_index;
 
+    //! Band index, incremented by each worker when trying to get the next band. Jobs and bands are never processed
+    //! at the same time, so it can share the cache line with `_job_index`.
+    uint32_t _band_index;
+
     //! Accumulated errors, initially zero for each batch. Since all workers
     //! would only OR their errors (if happened) at the end we can share the
     //! cache line with `_job_index`.
@@ -51,12 +57,27 @@ public:
   uint32_t _band_count;
   uint32_t _state_slot_count;
 
+  //! Clip masks referenced by commands of this batch (each clip mask image is retained by the batch).
+  ClipMask* _clip_mask_data;
+  //! Count of clip masks in `_clip_mask_data`.
+  uint32_t _clip_mask_count;
+  //! Capacity of `_clip_mask_data`.
+  uint32_t _clip_mask_capacity;
+
+  //! Layer targets referenced by commands of this batch (each layer image is retained by the batch).
+  LayerTarget* _layer_target_data;
+  //! Count of layer targets in `_layer_target_data`.
+  uint32_t _layer_target_count;
+  //! Capacity of `_layer_target_data`.
+  uint32_t _layer_target_capacity;
+
   //! \}
 
   //! name Accessors
   //! \{
 
   BL_INLINE_NODEBUG size_t next_job_index() noexcept { return bl_atomic_fetch_add_strong(&_job_index); }
+  BL_INLINE_NODEBUG uint32_t next_band_index() noexcept { return bl_atomic_fetch_add_strong(&_band_index); }
 
   BL_INLINE_NODEBUG const ArenaList<RenderJobQueue>& job_list() const noexcept { return _job_list; }
   BL_INLINE_NODEBUG const ArenaList<RenderCommandQueue>& command_list() const noexcept { return _command_list; }
@@ -69,6 +90,22 @@ public:
   BL_INLINE_NODEBUG uint32_t band_count() const noexcept { return _band_count; }
   BL_INLINE_NODEBUG uint32_t state_slot_count() const noexcept { return _state_slot_count; }
 
+  BL_INLINE_NODEBUG uint32_t clip_mask_count() const noexcept { return _clip_mask_count; }
+
+  //! Returns a clip mask referenced by a command's `clip_mask_slot` or null if the command is not clipped by a mask.
+  BL_INLINE const ClipMask* clip_mask_by_slot(uint32_t slot) const noexcept {
+    BL_ASSERT(slot <= _clip_mask_count);
+    return slot ? &_clip_mask_data[slot - 1u] : nullptr;
+  }
+
+  BL_INLINE_NODEBUG uint32_t layer_target_count() const noexcept { return _layer_target_count; }
+
+  //! Returns a layer target referenced by a command's `layer_slot` - the slot must not be zero.
+  BL_INLINE const LayerTarget* layer_target_by_slot(uint32_t slot) const noexcept {
+    BL_ASSERT(slot != 0u && slot <= _layer_target_count);
+    return &_layer_target_data[slot - 1u];
+  }
+
   BL_INLINE void accumulate_error_flags(uint32_t error_flags) noexcept {
     bl_atomic_fetch_or_relaxed(&_accumulated_error_flags, error_flags);
   }
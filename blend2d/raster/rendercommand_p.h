@@ -155,14 +155,16 @@ struct RenderCommand {
   //! Command payload.
   Payload _payload;
 
-  //! Global alpha value.
-  uint32_t _alpha;
+  //! Global alpha value - at most full alpha of the render target, which is 255 or 65535, so 16 bits are enough.
+  uint16_t _alpha;
+  //! Index of a layer target in \ref RenderBatch layer table plus one, zero if the command renders to the destination.
+  uint16_t _layer_slot;
   //! Command type.
   RenderCommandType _type;
   //! Command flags.
   RenderCommandFlags _flags;
-  //! Reserved.
-  uint16_t _reserved;
+  //! Index of a clip mask in \ref RenderBatch clip mask table plus one, zero if the command is not clipped by a mask.
+  uint16_t _clip_mask_slot;
 
   RenderCommandSource _source;
 
@@ -179,10 +181,13 @@ struct RenderCommand {
   //! \{
 
   BL_INLINE void init_command(uint32_t alpha) noexcept {
-    _alpha = alpha;
+    BL_ASSERT(alpha <= 0xFFFFu);
+
+    _alpha = uint16_t(alpha);
+    _layer_slot = 0;
     _type = RenderCommandType::kNone;
     _flags = RenderCommandFlags::kNoFlags;
-    _reserved = 0;
+    _clip_mask_slot = 0;
   }
 
   BL_INLINE void init_fill_box_a(const BLBoxI& box_a) noexcept {
@@ -255,6 +260,8 @@ struct RenderCommand {
   BL_INLINE_NODEBUG bool retains_mask_fetch_data() const noexcept { return has_flag(RenderCommandFlags::kRetainsMaskFetchData); }
 
   BL_INLINE_NODEBUG uint32_t alpha() const noexcept { return _alpha; }
+  BL_INLINE_NODEBUG uint32_t clip_mask_slot() const noexcept { return _clip_mask_slot; }
+  BL_INLINE_NODEBUG uint32_t layer_slot() const noexcept { return _layer_slot; }
   BL_INLINE_NODEBUG const BLBoxI& box_i() const noexcept { return _payload.box.box_i; }
 
   BL_INLINE uint32_t analytic_fill_rule() const noexcept {
@@ -60,6 +60,11 @@ public:
 
   AnalyticActiveEdge<int>* _pooled_edges;
 
+  //! Destination image data - the render target of commands that don't render to a layer.
+  BLImageData _dst_data;
+  //! Layer slot of the current render target (zero if the current render target is the destination image).
+  uint32_t _layer_slot;
+
   //! \}
 
   //! \name Construction & Destruction
@@ -77,7 +82,9 @@ public:
       _pending_command_bit_set_data(nullptr),
       _pending_command_bit_set_size(0),
       _pending_command_bit_set_mask(0),
-      _pooled_edges(nullptr) {}
+      _pooled_edges(nullptr),
+      _dst_data(work_data->ctx_data.dst),
+      _layer_slot(0) {}
 
   //! \}
 
@@ -148,6 +155,20 @@ public:
   }
 
   //! \}
+
+  //! \name Render Target
+  //! \{
+
+  //! Makes the layer referenced by `layer_slot` the render target of the work data (zero selects the destination).
+  BL_INLINE void set_layer_slot(uint32_t layer_slot) noexcept {
+    if (layer_slot == _layer_slot)
+      return;
+
+    _layer_slot = layer_slot;
+    _work_data->ctx_data.dst = layer_slot ? _batch->layer_target_by_slot(layer_slot)->data : _dst_data;
+  }
+
+  //! \}
 };
 
 static BL_INLINE CommandStatus fill_box_a(ProcData& proc_data, const RenderCommand& command) noexcept {
@@ -155,6 +176,13 @@ static BL_INLINE CommandStatus fill_box_a(ProcData& proc_data, const RenderComma
   int y1 = bl_min(command.box_i().y1, int(proc_data.bandY1()));
 
   if (y0 < y1) {
+    const ClipMask* clip_mask = proc_data.batch()->clip_mask_by_slot(command.clip_mask_slot());
+    if (clip_mask) {
+      BLBoxI box_a(command.box_i().x0, y0, command.box_i().x1, y1);
+      ClipMaskProc::fill_box_a(*proc_data.work_data(), command.pipe_dispatch_data()->fill_func, command.alpha(), box_a, *clip_mask, command.get_pipe_fetch_data());
+      return CommandStatus(command.box_i().y1 <= int(proc_data.bandY1()));
+    }
+
     Pipeline::FillData fill_data;
     fill_data.init_box_a_8bpc(command.alpha(), command.box_i().x0, y0, command.box_i().x1, y1);
 
@@ -178,6 +206,13 @@ static BL_INLINE CommandStatus fill_box_u(ProcData& proc_data, const RenderComma
   int y1 = bl_min(command.box_i().y1, int(proc_data.bandFixedY1()));
 
   if (y0 < y1) {
+    const ClipMask* clip_mask = proc_data.batch()->clip_mask_by_slot(command.clip_mask_slot());
+    if (clip_mask) {
+      BLBoxI box_u(command.box_i().x0, y0, command.box_i().x1, y1);
+      ClipMaskProc::fill_box_u(*proc_data.work_data(), command.pipe_dispatch_data()->fill_func, command.alpha(), box_u, *clip_mask, command.get_pipe_fetch_data());
+      return CommandStatus(command.box_i().y1 <= int(proc_data.bandFixedY1()));
+    }
+
     Pipeline::FillData fill_data;
     Pipeline::BoxUToMaskData boxUToMaskData;
 
@@ -212,6 +247,13 @@ static CommandStatus fillBoxMaskA(ProcData& proc_data, const RenderCommand& comm
     const BLImageImpl* mask_impl = payload.mask_image_i.ptr;
     const uint8_t* mask_data = (static_cast<const uint8_t*>(mask_impl->pixel_data) + intptr_t(maskY) * mask_impl->stride) + maskX * (mask_impl->depth / 8u);
 
+    const ClipMask* clip_mask = proc_data.batch()->clip_mask_by_slot(command.clip_mask_slot());
+    if (clip_mask) {
+      BLBoxI box_a(box_i.x0, y0, box_i.x1, y1);
+      ClipMaskProc::fill_box_masked_a(*proc_data.work_data(), command.pipe_dispatch_data()->fill_func, command.alpha(), box_a, mask_data, mask_impl->stride, *clip_mask, command.get_pipe_fetch_data());
+      return CommandStatus(box_i.y1 <= int(proc_data.bandY1()));
+    }
+
     Pipeline::MaskCommand mask_commands[2];
     Pipeline::MaskCommandType vMaskCmd = command.alpha() >= 255 ? Pipeline::MaskCommandType::kVMaskA8WithoutGA : Pipeline::MaskCommandType::kVMaskA8WithGA;
 
@@ -458,7 +500,11 @@ SaveState:
     fill_data.analytic.box.y0 = int(ras._band_offset);
     fill_data.analytic.box.y1 = int(ras._band_end) + 1;
 
-    if (fetch_func == nullptr) {
+    const ClipMask* clip_mask = proc_data.batch()->clip_mask_by_slot(command.clip_mask_slot());
+    if (clip_mask) {
+      ClipMaskProc::fill_analytic(work_data, fill_func, fill_data.analytic, *clip_mask, fetch_data);
+    }
+    else if (fetch_func == nullptr) {
       fill_func(&work_data.ctx_data, &fill_data, fetch_data);
     }
     else {
@@ -470,6 +516,8 @@ SaveState:
 }
 
 static CommandStatus process_command(ProcData& proc_data, const RenderCommand& command, int32_t prevBandFy1, int32_t nextBandFy0) noexcept {
+  proc_data.set_layer_slot(command.layer_slot());
+
   switch (command.type()) {
     case RenderCommandType::kFillBoxA:
       return fill_box_a(proc_data, command);
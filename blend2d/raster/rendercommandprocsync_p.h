@@ -10,6 +10,7 @@
 #include <blend2d/geometry/commons_p.h>
 #include <blend2d/pipeline/pipedefs_p.h>
 #include <blend2d/raster/analyticrasterizer_p.h>
+#include <blend2d/raster/clipmask_p.h>
 #include <blend2d/raster/edgebuilder_p.h>
 #include <blend2d/raster/rendercommand_p.h>
 #include <blend2d/raster/rasterdefs_p.h>
@@ -25,7 +26,12 @@
 namespace bl::RasterEngine {
 namespace CommandProcSync {
 
-static BL_INLINE BLResult fill_box_a(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const BLBoxI& box_a, const void* fetch_data) noexcept {
+static BL_INLINE BLResult fill_box_a(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const BLBoxI& box_a, const ClipMask* clip_mask, const void* fetch_data) noexcept {
+  if (clip_mask) {
+    ClipMaskProc::fill_box_a(work_data, dispatch_data.fill_func, alpha, box_a, *clip_mask, fetch_data);
+    return BL_SUCCESS;
+  }
+
   Pipeline::FillData fill_data;
   fill_data.init_box_a_8bpc(alpha, box_a.x0, box_a.y0, box_a.x1, box_a.y1);
 
@@ -42,7 +48,12 @@ static BL_INLINE BLResult fill_box_a(WorkData& work_data, const Pipeline::Dispat
   return BL_SUCCESS;
 }
 
-static BL_INLINE BLResult fill_box_u(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const BLBoxI& box_u, const void* fetch_data) noexcept {
+static BL_INLINE BLResult fill_box_u(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const BLBoxI& box_u, const ClipMask* clip_mask, const void* fetch_data) noexcept {
+  if (clip_mask) {
+    ClipMaskProc::fill_box_u(work_data, dispatch_data.fill_func, alpha, box_u, *clip_mask, fetch_data);
+    return BL_SUCCESS;
+  }
+
   Pipeline::FillData fill_data;
   Pipeline::BoxUToMaskData boxUToMaskData;
 
@@ -62,13 +73,18 @@ static BL_INLINE BLResult fill_box_u(WorkData& work_data, const Pipeline::Dispat
   return BL_SUCCESS;
 }
 
-static BL_INLINE BLResult fill_box_masked_a(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const RenderCommand::FillBoxMaskA& payload, const void* fetch_data) noexcept {
+static BL_INLINE BLResult fill_box_masked_a(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const RenderCommand::FillBoxMaskA& payload, const ClipMask* clip_mask, const void* fetch_data) noexcept {
   const BLImageImpl* mask_impl = payload.mask_image_i.ptr;
   const BLPointI& mask_offset = payload.mask_offset_i;
   const uint8_t* mask_data = static_cast<const uint8_t*>(mask_impl->pixel_data) + mask_impl->stride * intptr_t(mask_offset.y) + uint32_t(mask_offset.x) * (mask_impl->depth / 8u);
 
   const BLBoxI& box_i = payload.box_i;
 
+  if (clip_mask) {
+    ClipMaskProc::fill_box_masked_a(work_data, dispatch_data.fill_func, alpha, box_i, mask_data, mask_impl->stride, *clip_mask, fetch_data);
+    return BL_SUCCESS;
+  }
+
   Pipeline::MaskCommand mask_commands[2];
   Pipeline::MaskCommandType vMaskCmd = alpha >= 255 ? Pipeline::MaskCommandType::kVMaskA8WithGA : Pipeline::MaskCommandType::kVMaskA8WithoutGA;
 
@@ -84,7 +100,7 @@ static BL_INLINE BLResult fill_box_masked_a(WorkData& work_data, const Pipeline:
   return BL_SUCCESS;
 }
 
-static BL_NOINLINE BLResult fill_analytic(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const EdgeStorage<int>* edge_storage, BLFillRule fill_rule, const void* fetch_data) noexcept {
+static BL_NOINLINE BLResult fill_analytic(WorkData& work_data, const Pipeline::DispatchData& dispatch_data, uint32_t alpha, const EdgeStorage<int>* edge_storage, BLFillRule fill_rule, const ClipMask* clip_mask, const void* fetch_data) noexcept {
   // Rasterizer options to use - do not change unless you are improving the existing rasterizers.
   constexpr uint32_t kRasterizerOptions = AnalyticRasterizer::kOptionBandOffset | AnalyticRasterizer::kOptionRecordMinXMaxX;
 
@@ -243,7 +259,10 @@ SaveState:
       fill_data.analytic.box.y0 = int(ras._band_offset);
       fill_data.analytic.box.y1 = int(ras._band_end) + 1;
 
-      fill_func(&work_data.ctx_data, &fill_data, fetch_data);
+      if (clip_mask)
+        ClipMaskProc::fill_analytic(work_data, fill_func, fill_data.analytic, *clip_mask, fetch_data);
+      else
+        fill_func(&work_data.ctx_data, &fill_data, fetch_data);
     }
 
     ras._band_offset = (ras._band_offset + band_height) & ~band_height_mask;
@@ -0,0 +1,181 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/raster/renderbatch_p.h>
+#include <blend2d/raster/renderscheduler_p.h>
+#include <blend2d/raster/workdata_p.h>
+#include <blend2d/raster/workerproc_p.h>
+#include <blend2d/threading/threadpool_p.h>
+
+namespace bl::RasterEngine {
+
+// bl::RasterEngine::RenderScheduler - Globals
+// ===========================================
+
+Wrap<RenderScheduler> render_scheduler_global;
+
+// bl::RasterEngine::RenderScheduler - Thread Entry
+// ================================================
+
+static void BL_CDECL render_scheduler_thread_entry(BLThread* thread, void* data) noexcept {
+  RenderScheduler* self = static_cast<RenderScheduler*>(data);
+
+  self->_mutex.lock();
+  for (;;) {
+    RenderSchedulerTask* task = self->_first;
+
+    if (task) {
+      self->_first = task->next;
+      if (!self->_first)
+        self->_last = nullptr;
+
+      task->next = nullptr;
+      task->queued = false;
+
+      // The task cannot be accessed after the work is done as the rendering context could be already destroyed.
+      WorkData* work_data = task->work_data;
+
+      self->_mutex.unlock();
+      WorkerProc::worker_thread_entry(thread, work_data);
+      self->_mutex.lock();
+      continue;
+    }
+
+    if (self->_quitting)
+      break;
+
+    self->_task_condition.wait(self->_mutex);
+  }
+
+  self->_running_count--;
+  self->_exit_condition.broadcast();
+  self->_mutex.unlock();
+}
+
+// bl::RasterEngine::RenderScheduler - Interface
+// =============================================
+
+uint32_t RenderScheduler::start(BLResult* reason) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  if (_started || _quitting)
+    return _thread_count;
+
+  // The user thread that flushes a batch always works on it, so use one thread less than the hardware provides.
+  uint32_t thread_count = bl_runtime_context.system_info.thread_count;
+  thread_count = bl_clamp<uint32_t>(thread_count, 2u, BL_RUNTIME_MAX_THREAD_COUNT + 1u) - 1u;
+
+  uint32_t n = bl_thread_pool_global()->acquire_threads(_threads, thread_count, 0, reason);
+  if (!n)
+    return 0;
+
+  for (uint32_t i = 0; i < n; i++) {
+    // Cannot fail - threads were just acquired so there is no work enqueued.
+    BLResult result = _threads[i]->run(render_scheduler_thread_entry, this);
+    BL_ASSERT(result == BL_SUCCESS);
+    bl_unused(result);
+  }
+
+  _thread_count = n;
+  _running_count = n;
+  _started = true;
+
+  return n;
+}
+
+void RenderScheduler::shutdown() noexcept {
+  if (!_thread_count)
+    return;
+
+  {
+    BLLockGuard<BLMutex> guard(_mutex);
+    _quitting = true;
+    _task_condition.broadcast();
+
+    while (_running_count)
+      _exit_condition.wait(_mutex);
+  }
+
+  bl_thread_pool_global()->release_threads(_threads, _thread_count);
+  _thread_count = 0;
+}
+
+void RenderScheduler::submit(RenderSchedulerTask* tasks, uint32_t n) noexcept {
+  if (!n)
+    return;
+
+  for (uint32_t i = 0; i < n; i++) {
+    tasks[i].next = i + 1 < n ? &tasks[i + 1] : nullptr;
+    tasks[i].queued = true;
+  }
+
+  {
+    BLLockGuard<BLMutex> guard(_mutex);
+    if (_last)
+      _last->next = tasks;
+    else
+      _first = tasks;
+    _last = &tasks[n - 1];
+  }
+
+  if (n == 1)
+    _task_condition.signal();
+  else
+    _task_condition.broadcast();
+}
+
+uint32_t RenderScheduler::cancel(RenderSchedulerTask* tasks, uint32_t n) noexcept {
+  BLLockGuard<BLMutex> guard(_mutex);
+
+  uint32_t canceled_count = 0;
+  for (uint32_t i = 0; i < n; i++)
+    canceled_count += uint32_t(tasks[i].queued);
+
+  if (!canceled_count)
+    return 0;
+
+  RenderSchedulerTask* prev = nullptr;
+  RenderSchedulerTask* task = _first;
+
+  while (task) {
+    RenderSchedulerTask* next = task->next;
+
+    if (task >= tasks && task < tasks + n) {
+      if (prev)
+        prev->next = next;
+      else
+        _first = next;
+
+      if (_last == task)
+        _last = prev;
+
+      task->next = nullptr;
+      task->queued = false;
+    }
+    else {
+      prev = task;
+    }
+
+    task = next;
+  }
+
+  return canceled_count;
+}
+
+} // {bl::RasterEngine}
+
+// bl::RasterEngine::RenderScheduler - Runtime Registration
+// ========================================================
+
+static void BL_CDECL bl_render_scheduler_rt_shutdown(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+  bl::RasterEngine::render_scheduler_global.destroy();
+}
+
+void bl_render_scheduler_rt_init(BLRuntimeContext* rt) noexcept {
+  bl::RasterEngine::render_scheduler_global.init();
+  rt->shutdown_handlers.add(bl_render_scheduler_rt_shutdown);
+}
@@ -0,0 +1,110 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_RASTER_RENDERSCHEDULER_P_H_INCLUDED
+#define BLEND2D_RASTER_RENDERSCHEDULER_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/wrap_p.h>
+#include <blend2d/threading/conditionvariable_p.h>
+#include <blend2d/threading/mutex_p.h>
+#include <blend2d/threading/thread_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_raster_engine_impl
+//! \{
+
+namespace bl::RasterEngine {
+
+class WorkData;
+
+//! A task submitted to \ref RenderScheduler - processes a single render batch as one worker of a rendering context.
+//!
+//! Tasks are owned by the rendering context (its worker manager) and linked into the scheduler queue when a batch is
+//! flushed. A task that was not picked up by any scheduler thread until the user thread finished its part of the
+//! work is canceled, thus rendering contexts never wait for scheduler threads that are busy with other contexts.
+struct RenderSchedulerTask {
+  //! Next task in the scheduler queue.
+  RenderSchedulerTask* next;
+  //! Work data to process.
+  WorkData* work_data;
+  //! Whether the task is queued (protected by the scheduler mutex).
+  bool queued;
+};
+
+//! Render scheduler shared by all rendering contexts created with \ref BL_CONTEXT_CREATE_FLAG_SHARED_SCHEDULER.
+//!
+//! The scheduler owns a fixed number of threads acquired from the global thread-pool (one less than the number of
+//! hardware threads as the user thread that flushes a batch works as well) and consumes tasks from a single FIFO
+//! queue. Jobs and bands of a batch are claimed dynamically by all workers that participate on it, which means that
+//! any idle worker can steal remaining work of any batch it picks up, regardless of the number of live contexts.
+class RenderScheduler {
+public:
+  BL_NONCOPYABLE(RenderScheduler)
+
+  //! \name Members
+  //! \{
+
+  BLMutex _mutex;
+  //! Signaled when a task is added to the queue or when the scheduler is shutting down.
+  BLConditionVariable _task_condition;
+  //! Signaled when a scheduler thread exits.
+  BLConditionVariable _exit_condition;
+
+  //! First task in the queue.
+  RenderSchedulerTask* _first {};
+  //! Last task in the queue.
+  RenderSchedulerTask* _last {};
+
+  //! Threads acquired from the global thread-pool.
+  BLThread* _threads[BL_RUNTIME_MAX_THREAD_COUNT] {};
+  //! Number of acquired threads.
+  uint32_t _thread_count {};
+  //! Number of scheduler threads that are running.
+  uint32_t _running_count {};
+  //! Whether the scheduler was started (threads acquired) - it's started lazily by the first rendering context.
+  bool _started {};
+  //! Whether the scheduler is shutting down.
+  bool _quitting {};
+
+  //! \}
+
+  //! \name Construction & Destruction
+  //! \{
+
+  BL_INLINE RenderScheduler() noexcept {}
+  BL_INLINE ~RenderScheduler() noexcept { shutdown(); }
+
+  //! \}
+
+  //! \name Interface
+  //! \{
+
+  //! Starts the scheduler if not started yet and returns the number of its threads (zero in case of failure).
+  uint32_t start(BLResult* reason) noexcept;
+
+  //! Stops all scheduler threads and releases them back to the global thread-pool.
+  void shutdown() noexcept;
+
+  //! Appends `n` tasks to the queue.
+  void submit(RenderSchedulerTask* tasks, uint32_t n) noexcept;
+
+  //! Removes tasks that were not picked up by any thread yet from the queue and returns their count.
+  uint32_t cancel(RenderSchedulerTask* tasks, uint32_t n) noexcept;
+
+  //! \}
+};
+
+BL_HIDDEN extern Wrap<RenderScheduler> render_scheduler_global;
+
+} // {bl::RasterEngine}
+
+BL_HIDDEN void bl_render_scheduler_rt_init(BLRuntimeContext* rt) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_RASTER_RENDERSCHEDULER_P_H_INCLUDED
@@ -0,0 +1,93 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/context.h>
+#include <blend2d/core/image.h>
+#include <blend2d/core/path.h>
+#include <blend2d/core/random.h>
+#include <blend2d/raster/renderscheduler_p.h>
+
+// bl::RasterEngine - RenderScheduler - Tests
+// ==========================================
+
+namespace bl::RasterEngine {
+namespace Tests {
+
+static constexpr uint32_t kContextCount = 3;
+static constexpr uint32_t kFrameCount = 4;
+static constexpr uint32_t kShapeCount = 300;
+
+static void render_shapes(BLContext& ctx, BLRandom& rnd) noexcept {
+  for (uint32_t i = 0; i < kShapeCount; i++) {
+    double x = rnd.next_double() * 240.0;
+    double y = rnd.next_double() * 240.0;
+    double r = 2.0 + rnd.next_double() * 40.0;
+
+    ctx.set_fill_style(BLRgba32(rnd.next_uint32() | 0x40000000u));
+
+    if (i & 1u) {
+      BLPath path;
+      path.move_to(x, y);
+      path.quad_to(x + r, y - r, x + r * 2.0, y + r * 0.5);
+      path.line_to(x + r * 0.3, y + r * 1.7);
+      path.close();
+      ctx.fill_path(path);
+    }
+    else {
+      ctx.fill_circle(x, y, r);
+    }
+  }
+}
+
+static void render_frames(BLImage* images, uint32_t create_flags, uint32_t thread_count) noexcept {
+  BLContextCreateInfo create_info {};
+  create_info.flags = create_flags;
+  create_info.thread_count = thread_count;
+
+  BLContext contexts[kContextCount];
+  BLRandom rnd[kContextCount];
+
+  for (uint32_t i = 0; i < kContextCount; i++) {
+    EXPECT_SUCCESS(images[i].create(256, 256, BL_FORMAT_PRGB32));
+    EXPECT_SUCCESS(contexts[i].begin(images[i], create_info));
+
+    contexts[i].clear_all();
+    rnd[i].reset(0x1234u + i);
+  }
+
+  // Interleave rendering of all contexts so batches of multiple contexts are processed by the scheduler at a time.
+  for (uint32_t frame = 0; frame < kFrameCount; frame++) {
+    for (uint32_t i = 0; i < kContextCount; i++) {
+      render_shapes(contexts[i], rnd[i]);
+      EXPECT_SUCCESS(contexts[i].flush(BL_CONTEXT_FLUSH_SYNC));
+    }
+  }
+
+  for (uint32_t i = 0; i < kContextCount; i++)
+    EXPECT_SUCCESS(contexts[i].end());
+}
+
+UNIT(render_scheduler, BL_TEST_GROUP_RENDERING_CONTEXT) {
+  BLImage expected[kContextCount];
+  render_frames(expected, BL_CONTEXT_CREATE_NO_FLAGS, 0);
+
+  for (uint32_t thread_count : { 2u, 4u }) {
+    INFO("Testing shared scheduler rendering with %u threads per context", thread_count);
+
+    BLImage actual[kContextCount];
+    render_frames(actual, BL_CONTEXT_CREATE_FLAG_SHARED_SCHEDULER, thread_count);
+
+    for (uint32_t i = 0; i < kContextCount; i++)
+      EXPECT_TRUE(actual[i].equals(expected[i])).message("Context #%u doesn't match synchronous rendering", i);
+  }
+}
+
+} // {Tests}
+} // {bl::RasterEngine}
+
+#endif // BL_TEST
@@ -9,6 +9,8 @@
 #include <blend2d/core/geometry.h>
 #include <blend2d/core/matrix_p.h>
 #include <blend2d/core/path_p.h>
+#include <blend2d/raster/clipmask_p.h>
+#include <blend2d/raster/layer_p.h>
 #include <blend2d/raster/styledata_p.h>
 
 //! \cond INTERNAL
@@ -67,6 +69,9 @@ public:
   alignas(16) BLBoxI final_clip_box_i;
   //! Final clip-box (double).
   alignas(16) BLBox final_clip_box_d;
+
+  //! Clip mask, only valid if the clip mode is \ref BL_CLIP_MODE_MASK (the image is retained by the state).
+  ClipMask clip_mask;
 };
 
 //! Structure that holds a previously saved state, see \ref BLContext::save() and \ref BLContext::restore().
@@ -90,8 +95,10 @@ struct alignas(16) SavedState {
 
   //! Clip mode.
   uint8_t clip_mode;
+  //! Whether this state was created by `begin_layer()`, in that case `layer` is valid.
+  uint8_t has_layer;
   //! Padding at the moment.
-  uint8_t reserved[7];
+  uint8_t reserved[6];
 
   //! Copy of previous `BLRasterContextImpl::_context_flags`.
   ContextFlags prev_context_flags;
@@ -128,6 +135,8 @@ struct alignas(16) SavedState {
 
   //! Final clip_box (double).
   BLBox final_clip_box_d;
+  //! Clip mask (the image is retained by the saved state, if not null).
+  ClipMask clip_mask;
 
   //! Integral translation, if possible.
   BLPointI translation_i;
@@ -135,6 +144,9 @@ struct alignas(16) SavedState {
   BLMatrix2D alt_transform;
   //! User transformation matrix.
   BLMatrix2D user_transform;
+
+  //! Layer that ends when this state is restored (only valid if `has_layer` is non-zero).
+  Layer layer;
 };
 
 struct Matrix2x2 {
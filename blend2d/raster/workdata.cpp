@@ -6,6 +6,7 @@
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/raster/rastercontext_p.h>
 #include <blend2d/raster/workdata_p.h>
+#include <blend2d/support/heap_p.h>
 
 namespace bl::RasterEngine {
 
@@ -31,6 +32,8 @@ WorkData::WorkData(BLRasterContextImpl* ctx_impl, WorkerSynchronization* synchro
     edge_builder(&work_zone, &edge_storage) {}
 
 WorkData::~WorkData() noexcept {
+  Heap::free(BL_ALLOCATOR_CATEGORY_ARENA, clip_mask_buffer);
+
   if (edge_storage.band_edges())
     bl_zero_allocator_release(edge_storage.band_edges(), edge_storage.band_capacity() * kEdgeListSize);
 }
@@ -69,6 +72,23 @@ BLResult WorkData::init_band_data(uint32_t band_height, uint32_t band_count, uin
   return BL_SUCCESS;
 }
 
+// bl::RasterEngine::WorkData - Clip Mask Buffer
+// ==============================================
+
+uint8_t* WorkData::_alloc_clip_mask_buffer(size_t stride) noexcept {
+  // The buffer only grows - a smaller destination (after the context is reattached) would reuse it.
+  size_t required_size = stride * band_height();
+
+  if (required_size > clip_mask_buffer_size) {
+    Heap::free(BL_ALLOCATOR_CATEGORY_ARENA, clip_mask_buffer);
+    clip_mask_buffer = static_cast<uint8_t*>(Heap::alloc(BL_ALLOCATOR_CATEGORY_ARENA, required_size));
+    clip_mask_buffer_size = clip_mask_buffer ? required_size : size_t(0);
+  }
+
+  clip_mask_buffer_stride = stride;
+  return clip_mask_buffer;
+}
+
 // bl::RasterEngine::WorkData - Error Accumulation
 // ===============================================
 
@@ -12,6 +12,7 @@
 #include <blend2d/raster/edgebuilder_p.h>
 #include <blend2d/raster/rasterdefs_p.h>
 #include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/intops_p.h>
 #include <blend2d/support/zeroallocator_p.h>
 
 //! \cond INTERNAL
@@ -74,6 +75,13 @@ public:
   //! Edge builder.
   EdgeBuilder<int> edge_builder;
 
+  //! Scratch buffer used to combine coverage with a clip mask (allocated on demand, see \ref ensure_clip_mask_buffer()).
+  uint8_t* clip_mask_buffer {};
+  //! Size of `clip_mask_buffer` in bytes.
+  size_t clip_mask_buffer_size {};
+  //! Stride of `clip_mask_buffer` in bytes.
+  size_t clip_mask_buffer_stride {};
+
   explicit WorkData(BLRasterContextImpl* ctx_impl, WorkerSynchronization* synchronization, uint32_t worker_id = kSyncWorkerId) noexcept;
   ~WorkData() noexcept;
 
@@ -129,6 +137,17 @@ public:
     work_zone.restore_state(work_state);
   }
 
+  //! Returns a scratch buffer that can hold A8 coverage of `band_height()` scanlines having the width of the destination
+  //! image (with `clip_mask_buffer_stride`) or null if the buffer couldn't be allocated.
+  BL_INLINE uint8_t* ensure_clip_mask_buffer() noexcept {
+    size_t required_stride = IntOps::align_up(size_t(uint32_t(dst_size().w)), 16u);
+    if (BL_LIKELY(clip_mask_buffer_stride == required_stride && clip_mask_buffer_size >= required_stride * band_height()))
+      return clip_mask_buffer;
+    return _alloc_clip_mask_buffer(required_stride);
+  }
+
+  BL_HIDDEN uint8_t* _alloc_clip_mask_buffer(size_t stride) noexcept;
+
   //! Accumulates the error result into error flags of this work-data. Used by both synchronous and asynchronous
   //! rendering context to accumulate errors that may happen during the rendering.
   BLResult accumulate_error(BLResult error) noexcept;
@@ -49,29 +49,48 @@ BLResult WorkerManager::init(BLRasterContextImpl* ctx_impl, const BLContextCreat
 
   // Allocate space for worker threads data.
   if (worker_count) {
-    BLThread** worker_threads = zone.allocT<BLThread*>(IntOps::align_up(worker_count * sizeof(void*), 8));
+    bool use_scheduler = (init_flags & BL_CONTEXT_CREATE_FLAG_SHARED_SCHEDULER) != 0;
+
+    BLThread** worker_threads = nullptr;
+    RenderSchedulerTask* scheduler_tasks = nullptr;
     WorkData** work_data_storage = zone.allocT<WorkData*>(IntOps::align_up(worker_count * sizeof(void*), 8));
 
-    if (!worker_threads || !work_data_storage) {
+    if (use_scheduler)
+      scheduler_tasks = zone.allocT<RenderSchedulerTask>(IntOps::align_up(worker_count * sizeof(RenderSchedulerTask), 8));
+    else
+      worker_threads = zone.allocT<BLThread*>(IntOps::align_up(worker_count * sizeof(void*), 8));
+
+    if ((!worker_threads && !scheduler_tasks) || !work_data_storage) {
       zone.restore_state(zone_state);
       return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
     }
 
-    // Get global thread-pool or create an isolated one.
     BLThreadPool* thread_pool = nullptr;
-    if (init_flags & BL_CONTEXT_CREATE_FLAG_ISOLATED_THREAD_POOL) {
-      thread_pool = bl_thread_pool_create();
-      if (!thread_pool)
-        return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+    RenderScheduler* scheduler = nullptr;
+
+    BLResult reason = BL_SUCCESS;
+    uint32_t n = 0;
+
+    if (use_scheduler) {
+      // The shared scheduler has a fixed number of threads - there is no point in having more workers than that.
+      scheduler = &render_scheduler_global;
+      n = bl_min(worker_count, scheduler->start(&reason));
     }
     else {
-      thread_pool = bl_thread_pool_global()->add_ref();
-    }
+      // Get global thread-pool or create an isolated one.
+      if (init_flags & BL_CONTEXT_CREATE_FLAG_ISOLATED_THREAD_POOL) {
+        thread_pool = bl_thread_pool_create();
+        if (!thread_pool)
+          return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+      }
+      else {
+        thread_pool = bl_thread_pool_global()->add_ref();
+      }
 
-    // Acquire threads passed to thread-pool.
-    BLResult reason = BL_SUCCESS;
-    uint32_t acquire_thread_flags = 0;
-    uint32_t n = thread_pool->acquire_threads(worker_threads, worker_count, acquire_thread_flags, &reason);
+      // Acquire threads passed to thread-pool.
+      uint32_t acquire_thread_flags = 0;
+      n = thread_pool->acquire_threads(worker_threads, worker_count, acquire_thread_flags, &reason);
+    }
 
     if (reason != BL_SUCCESS)
       ctx_impl->sync_work_data.accumulate_error(reason);
@@ -84,16 +103,21 @@ BLResult WorkerManager::init(BLRasterContextImpl* ctx_impl, const BLContextCreat
 
       if (!work_data) {
         ctx_impl->sync_work_data.accumulate_error(bl_make_error(BL_ERROR_OUT_OF_MEMORY));
-        thread_pool->release_threads(worker_threads, n);
+        if (thread_pool)
+          thread_pool->release_threads(worker_threads, n);
         n = 0;
         break;
       }
     }
 
     if (!n) {
-      thread_pool->release();
+      if (thread_pool)
+        thread_pool->release();
+
       thread_pool = nullptr;
+      scheduler = nullptr;
       worker_threads = nullptr;
+      scheduler_tasks = nullptr;
       work_data_storage = nullptr;
       zone.restore_state(zone_state);
 
@@ -107,11 +131,16 @@ BLResult WorkerManager::init(BLRasterContextImpl* ctx_impl, const BLContextCreat
       for (uint32_t i = 0; i < n; i++) {
         bl_call_ctor(*work_data_storage[i], ctx_impl, synchronization, i + 1);
         work_data_storage[i]->init_band_data(ctx_impl->band_height(), ctx_impl->band_count(), ctx_impl->command_quantization_shift_aa());
+
+        if (scheduler_tasks)
+          scheduler_tasks[i] = RenderSchedulerTask{nullptr, work_data_storage[i], false};
       }
     }
 
     _thread_pool = thread_pool;
     _worker_threads = worker_threads;
+    _scheduler = scheduler;
+    _scheduler_tasks = scheduler_tasks;
     _work_data_storage = work_data_storage;
     _thread_count = n;
   }
@@ -145,15 +174,19 @@ void WorkerManager::reset() noexcept {
 
   _is_active = false;
 
-  if (_thread_pool) {
+  if (_thread_pool || _scheduler) {
     for (uint32_t i = 0; i < _thread_count; i++)
       bl_call_dtor(*_work_data_storage[i]);
 
-    _thread_pool->release_threads(_worker_threads, _thread_count);
-    _thread_pool->release();
+    if (_thread_pool) {
+      _thread_pool->release_threads(_worker_threads, _thread_count);
+      _thread_pool->release();
+    }
 
     _thread_pool = nullptr;
     _worker_threads = nullptr;
+    _scheduler = nullptr;
+    _scheduler_tasks = nullptr;
     _work_data_storage = nullptr;
     _thread_count = 0;
   }
@@ -13,6 +13,7 @@
 #include <blend2d/raster/rasterdefs_p.h>
 #include <blend2d/raster/renderbatch_p.h>
 #include <blend2d/raster/renderqueue_p.h>
+#include <blend2d/raster/renderscheduler_p.h>
 #include <blend2d/raster/statedata_p.h>
 #include <blend2d/raster/workdata_p.h>
 #include <blend2d/raster/workersynchronization_p.h>
@@ -171,6 +172,10 @@ public:
   BLThreadPool* _thread_pool;
   //! Worker threads acquired from `_thread_pool`.
   BLThread** _worker_threads;
+  //! Shared scheduler used instead of `_thread_pool` (see \ref BL_CONTEXT_CREATE_FLAG_SHARED_SCHEDULER).
+  RenderScheduler* _scheduler;
+  //! Tasks submitted to `_scheduler`, one per work data.
+  RenderSchedulerTask* _scheduler_tasks;
   //! Work data for each worker thread.
   WorkData** _work_data_storage;
 
@@ -206,6 +211,8 @@ public:
       _shared_data_pool{},
       _thread_pool{},
       _worker_threads{},
+      _scheduler{},
+      _scheduler_tasks{},
       _work_data_storage{},
       _synchronization(),
       _is_active{},
@@ -276,6 +283,9 @@ public:
 
   BL_INLINE_NODEBUG uint32_t thread_count() const noexcept { return _thread_count; }
 
+  //! Returns `true` when batches are processed by a shared scheduler instead of threads owned by this manager.
+  BL_INLINE_NODEBUG bool uses_scheduler() const noexcept { return _scheduler != nullptr; }
+
   //! \}
 
   //! \name Command Data
@@ -37,6 +37,9 @@ static BL_NOINLINE void process_jobs(WorkData* work_data, RenderBatch* batch) no
   const RenderJobQueue* queue = batch->job_list().first();
   BL_ASSERT(queue != nullptr);
 
+  WorkerSynchronization* synchronization = work_data->synchronization;
+  bool count_jobs = synchronization->count_jobs();
+
   size_t queue_index = 0;
   size_t queue_end = queue_index + queue->size();
 
@@ -57,10 +60,13 @@ static BL_NOINLINE void process_jobs(WorkData* work_data, RenderBatch* batch) no
     BL_ASSERT(job != nullptr);
 
     JobProc::process_job(work_data, job);
+
+    if (count_jobs)
+      synchronization->job_finished();
   }
 
   work_data->avoid_cache_line_sharing();
-  work_data->synchronization->wait_for_jobs_to_finish();
+  synchronization->wait_for_jobs_to_finish();
 }
 
 // bl::RasterEngine::WorkerProc - ProcessBand
@@ -267,34 +273,26 @@ static void process_commands(WorkData* work_data, RenderBatch* batch) noexcept {
     return;
   }
 
-  uint32_t worker_count = batch->worker_count();
   uint32_t band_count = batch->band_count();
 
-  // We can process several consecutive bands at once when there is enough of bands for all the threads.
-  //
-  // TODO: [Rendering Context] At the moment this feature is not used as it regressed bl_bench using 4+ threads.
-  uint32_t consecutive_band_count = 1;
-
-  uint32_t band_id = work_data->worker_id() * consecutive_band_count;
-  uint32_t consecutive_index = 0;
-
-  uint32_t current_band_id = band_id + consecutive_index;
+  // Bands are claimed dynamically - each worker takes the next band that hasn't been processed yet. This distributes
+  // the work fairly even when most of it is concentrated in a few bands (for example at the top of the frame), which
+  // would leave workers idle in case that bands were assigned to workers statically. Bands claimed by a worker are
+  // always increasing, which is required by `process_band()` as it continues with commands processed in earlier bands.
+  uint32_t current_band_id = batch->next_band_index();
   uint32_t prev_band_id = current_band_id;
 
   while (current_band_id < band_count) {
-    // Calculate the next band so we can pass it to `process_band()`.
-    if (++consecutive_index == consecutive_band_count) {
-      consecutive_index = 0;
-      band_id += worker_count * consecutive_band_count;
-    }
-
-    uint32_t next_band_id = band_id + consecutive_index;
-    process_band(proc_data, current_band_id, prev_band_id, next_band_id);
+    // The band that the worker would process next is not known at this point, however, it's only a hint for command
+    // processors, so just pass the band that follows.
+    process_band(proc_data, current_band_id, prev_band_id, current_band_id + 1u);
 
     prev_band_id = current_band_id;
-    current_band_id = next_band_id;
+    current_band_id = batch->next_band_index();
   }
 
+  // Commands can switch the render target to a layer - the work data must always end with the destination image.
+  proc_data.set_layer_slot(0);
   work_data->work_zone.restore_state(zone_state);
 }
 
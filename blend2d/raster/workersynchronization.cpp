@@ -26,7 +26,41 @@ WorkerSynchronization::~WorkerSynchronization() noexcept {
   }
 }
 
+void WorkerSynchronization::job_finished() noexcept {
+  BL_ASSERT(count_jobs());
+
+  if (use_futex()) {
+    if (bl_atomic_fetch_sub_strong(&_status.jobs_running_count) == 1) {
+      bl_atomic_fetch_add_strong(&_status.futex_jobs_finished);
+      Futex::wake_all(&_status.futex_jobs_finished);
+    }
+  }
+  else {
+    BLLockGuard<BLMutex> guard(_portable_data.mutex);
+    if (--_status.jobs_running_count == 0) {
+      guard.release();
+      _portable_data.jobs_condition.broadcast();
+    }
+  }
+}
+
 void WorkerSynchronization::wait_for_jobs_to_finish() noexcept {
+  if (count_jobs()) {
+    // Only wait for jobs that other threads are still processing.
+    if (use_futex()) {
+      while (bl_atomic_fetch_strong(&_status.futex_jobs_finished) != 1) {
+        Futex::wait(&_status.futex_jobs_finished, 0u);
+      }
+    }
+    else {
+      BLLockGuard<BLMutex> guard(_portable_data.mutex);
+      while (_status.jobs_running_count) {
+        _portable_data.jobs_condition.wait(_portable_data.mutex);
+      }
+    }
+    return;
+  }
+
   if (use_futex()) {
     if (bl_atomic_fetch_sub_strong(&_status.jobs_running_count) == 1) {
       bl_atomic_fetch_add_strong(&_status.futex_jobs_finished);
@@ -23,6 +23,8 @@ public:
 
   struct alignas(BL_CACHE_LINE_SIZE) Header {
     bool use_futex;
+    //! Whether `jobs_running_count` counts jobs instead of threads (see \ref before_start_shared()).
+    bool count_jobs;
     Threading::TSanBarrier barrier;
   };
 
@@ -57,7 +59,10 @@ public:
 
   BL_INLINE_NODEBUG bool use_futex() const noexcept { return _header.use_futex; }
 
+  BL_INLINE_NODEBUG bool count_jobs() const noexcept { return _header.count_jobs; }
+
   BL_INLINE void before_start(uint32_t thread_count, bool has_jobs) noexcept {
+    _header.count_jobs = false;
     bl_atomic_store_relaxed(&_status.jobs_running_count, has_jobs ? uint32_t(thread_count + 1) : uint32_t(0));
     bl_atomic_store_relaxed(&_status.threads_running_count, thread_count);
     bl_atomic_store_strong(&_status.futex_jobs_finished, 0u);
@@ -65,6 +70,20 @@ public:
     _header.barrier.release();
   }
 
+  //! Prepares the synchronization for a batch processed by a shared scheduler.
+  //!
+  //! Threads that work on a batch submitted to a shared scheduler are not guaranteed to start, thus the jobs barrier
+  //! cannot count participating threads. Instead, it counts the remaining jobs, which are decremented by
+  //! \ref job_finished(), so any thread that reaches the barrier only waits for jobs that are being processed.
+  BL_INLINE void before_start_shared(uint32_t thread_count, uint32_t job_count) noexcept {
+    _header.count_jobs = true;
+    bl_atomic_store_relaxed(&_status.jobs_running_count, job_count);
+    bl_atomic_store_relaxed(&_status.threads_running_count, thread_count);
+    bl_atomic_store_strong(&_status.futex_jobs_finished, 0u);
+
+    _header.barrier.release();
+  }
+
   BL_INLINE void thread_started() noexcept {
     _header.barrier.acquire();
   }
@@ -76,6 +95,9 @@ public:
     );
   }
 
+  //! Called after a job has been processed, only used when counting jobs.
+  void job_finished() noexcept;
+
   void wait_for_jobs_to_finish() noexcept;
   void thread_done() noexcept;
   void wait_for_threads_to_finish() noexcept;
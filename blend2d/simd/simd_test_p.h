@@ -259,6 +259,20 @@ template<typename T> struct iop_mul : public op_base_2<T, iop_mul<T>> {
   static BL_INLINE_NODEBUG T apply_one(const T& a, const T& b) noexcept { return T(T(uint64_t(a) * uint64_t(b)) & T(~T(0))); }
 };
 
+struct iop_maddw_i16_i32 {
+  template<uint32_t kW>
+  static BL_INLINE VecOverlay<kW, int16_t> apply(const VecOverlay<kW, int16_t>& a, const VecOverlay<kW, int16_t>& b) noexcept {
+    VecOverlay<kW, int16_t> out{};
+    for (uint32_t i = 0; i < kW / 4u; i++) {
+      uint32_t p0 = uint32_t(int32_t(a.items[i * 2 + 0]) * int32_t(b.items[i * 2 + 0]));
+      uint32_t p1 = uint32_t(int32_t(a.items[i * 2 + 1]) * int32_t(b.items[i * 2 + 1]));
+      uint32_t sum = p0 + p1;
+      memcpy(&out.items[i * 2], &sum, sizeof(sum));
+    }
+    return out;
+  }
+};
+
 template<typename T> struct iop_min : public op_base_2<T, iop_min<T>> {
   static BL_INLINE_NODEBUG T apply_one(const T& a, const T& b) noexcept { return a < b ? a : b; }
 };
@@ -1072,6 +1086,8 @@ static BL_NOINLINE void test_integer(const char* ext) noexcept {
     test_iop2<V_U16, iop_mul<uint16_t>>([](const V_U16& a, const V_U16& b) { return mul_u16(a, b); });
     test_iop2<V_U32, iop_mul<uint32_t>>([](const V_U32& a, const V_U32& b) { return mul_u32(a, b); });
     test_iop2<V_U64, iop_mul<uint64_t>>([](const V_U64& a, const V_U64& b) { return mul_u64(a, b); });
+
+    test_iop2<V_I16, iop_maddw_i16_i32>([](const V_I16& a, const V_I16& b) { return maddw_i16_i32(a, b); });
   }
 
   INFO("Testing %d-bit %s vector ops - cmp", kW*8, ext);
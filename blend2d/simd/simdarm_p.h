@@ -498,7 +498,7 @@ template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, float> vec_f32(const Vec
 template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, double> vec_f64(const Vec<W, T>& src) noexcept { return vec_cast<Vec<W, double>>(src); }
 
 template<typename DstVectorT, typename SrcT>
-BL_INLINE_NODEBUG const DstVectorT& vec_const(const SrcT* src) noexcept { return *static_cast<const DstVectorT*>(static_cast<void*>(src)); }
+BL_INLINE_NODEBUG const DstVectorT& vec_const(const SrcT* src) noexcept { return *static_cast<const DstVectorT*>(static_cast<const void*>(src)); }
 
 // Converts a native SimdT register type to a wrapped V.
 template<typename V, typename SimdT>
@@ -1542,6 +1542,17 @@ BL_INLINE_NODEBUG uint16x8_t simd_mul_hi_u8_u16(const uint8x16_t& a, const uint8
 BL_INLINE_NODEBUG uint32x4_t simd_mul_lo_u16_u32(const uint16x8_t& a, const uint16x8_t& b) noexcept { return vmull_u16(vget_low_u16(a), vget_low_u16(b)); }
 BL_INLINE_NODEBUG uint32x4_t simd_mul_hi_u16_u32(const uint16x8_t& a, const uint16x8_t& b) noexcept { return vmull_u16(vget_high_u16(a), vget_high_u16(b)); }
 
+// Multiplies 16-bit signed integers and adds adjacent pairs of 32-bit products (the same as X86's PMADDWD).
+BL_INLINE_NODEBUG int32x4_t simd_maddw_i16_i32(const int16x8_t& a, const int16x8_t& b) noexcept {
+  int32x4_t lo = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+  int32x4_t hi = vmull_s16(vget_high_s16(a), vget_high_s16(b));
+#if defined(BL_SIMD_AARCH64)
+  return vpaddq_s32(lo, hi);
+#else
+  return vcombine_s32(vpadd_s32(vget_low_s32(lo), vget_high_s32(lo)), vpadd_s32(vget_low_s32(hi), vget_high_s32(hi)));
+#endif
+}
+
 BL_INLINE_NODEBUG int8x16_t simd_cmp_eq_i8(const int8x16_t& a, const int8x16_t& b) noexcept { return simd_i8(vceqq_s8(a, b)); }
 BL_INLINE_NODEBUG int16x8_t simd_cmp_eq_i16(const int16x8_t& a, const int16x8_t& b) noexcept { return simd_i16(vceqq_s16(a, b)); }
 BL_INLINE_NODEBUG int32x4_t simd_cmp_eq_i32(const int32x4_t& a, const int32x4_t& b) noexcept { return simd_i32(vceqq_s32(a, b)); }
@@ -2532,6 +2543,7 @@ template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, uint16_t> mul_lo_u8_u16(
 template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, uint16_t> mul_hi_u8_u16(const Vec<W, T>& a, const Vec<W, T>& b) noexcept { return vec_wt<W, uint16_t>(I::simd_mul_hi_u8_u16(simd_u8(a.v), simd_u8(b.v))); }
 template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, uint32_t> mul_lo_u16_u32(const Vec<W, T>& a, const Vec<W, T>& b) noexcept { return vec_wt<W, uint32_t>(I::simd_mul_lo_u16_u32(simd_u16(a.v), simd_u16(b.v))); }
 template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, uint32_t> mul_hi_u16_u32(const Vec<W, T>& a, const Vec<W, T>& b) noexcept { return vec_wt<W, uint32_t>(I::simd_mul_hi_u16_u32(simd_u16(a.v), simd_u16(b.v))); }
+template<size_t W, typename T> BL_INLINE_NODEBUG Vec<W, T> maddw_i16_i32(const Vec<W, T>& a, const Vec<W, T>& b) noexcept { return vec_wt<W, T>(I::simd_maddw_i16_i32(simd_i16(a.v), simd_i16(b.v))); }
 
 template<size_t W> BL_INLINE_NODEBUG Vec<W, int8_t> mul(const Vec<W, int8_t>& a, const Vec<W, int8_t>& b) noexcept { return mul_i8(a, b); }
 template<size_t W> BL_INLINE_NODEBUG Vec<W, int16_t> mul(const Vec<W, int16_t>& a, const Vec<W, int16_t>& b) noexcept { return mul_i16(a, b); }
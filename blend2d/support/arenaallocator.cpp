@@ -5,6 +5,7 @@
 
 #include <blend2d/core/api-build_p.h>
 #include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/heap_p.h>
 #include <blend2d/support/intops_p.h>
 
 namespace bl {
@@ -95,14 +96,14 @@ void ArenaAllocator::reset() noexcept {
       break;
     }
 
-    ::free(cur);
+    Heap::free(BL_ALLOCATOR_CATEGORY_ARENA, cur);
     cur = prev;
   } while (cur);
 
   cur = next;
   while (cur) {
     next = cur->next;
-    ::free(cur);
+    Heap::free(BL_ALLOCATOR_CATEGORY_ARENA, cur);
     cur = next;
   }
 }
@@ -148,7 +149,7 @@ void* ArenaAllocator::_alloc(size_t size, size_t alignment) noexcept {
   // properly aligned there will be size for the requested memory. In 99.9999% cases this is never a problem, but
   // we must be sure that even rare border cases would allocate properly.
   size_t alignment_overhead = required_block_alignment - bl_min<size_t>(required_block_alignment, BL_ALLOC_ALIGNMENT);
-  size_t block_size_overhead = kBlockSize + BL_ALLOC_OVERHEAD + alignment_overhead;
+  size_t block_size_overhead = kBlockSize + BL_ALLOC_OVERHEAD + Heap::kHeaderSize + alignment_overhead;
 
   // If the requested size is larger than a default calculated block size -> increase block size so the allocation
   // would be enough to fit the requested size.
@@ -163,11 +164,11 @@ void* ArenaAllocator::_alloc(size_t size, size_t alignment) noexcept {
     final_block_size = size + alignment_overhead + kBlockSize;
   }
   else {
-    final_block_size -= BL_ALLOC_OVERHEAD;
+    final_block_size -= BL_ALLOC_OVERHEAD + Heap::kHeaderSize;
   }
 
   // Allocate new block.
-  Block* new_block = static_cast<Block*>(::malloc(final_block_size));
+  Block* new_block = static_cast<Block*>(Heap::alloc(BL_ALLOCATOR_CATEGORY_ARENA, final_block_size));
 
   if (BL_UNLIKELY(!new_block)) {
     return nullptr;
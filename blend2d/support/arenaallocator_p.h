@@ -18,8 +18,9 @@ namespace bl {
 //! Arena memory allocator.
 //!
 //! Arena allocator is an incremental memory allocator that allocates memory by simply incrementing a pointer.
-//! It allocates blocks of memory by using standard C library `malloc/free`, but divides these blocks into
-//! smaller chunks requested by calling `ArenaAllocator::alloc()` and friends.
+//! It allocates blocks of memory through `Heap` (the allocator installed by \ref bl_runtime_set_allocator() or
+//! standard C library `malloc/free`), but divides these blocks into smaller chunks requested by calling
+//! `ArenaAllocator::alloc()` and friends.
 //!
 //! Arena allocators are designed to either allocate memory for data that has a short lifetime or data in containers
 //! where it's expected that many small chunks will be allocated.
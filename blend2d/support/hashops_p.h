@@ -56,6 +56,15 @@ static BL_INLINE uint32_t hash_stringCI(BLStringView view) noexcept {
   return hash_stringCI(view.data, view.size);
 }
 
+// Mixes a 64-bit `value` into `hash`. Used to hash keys composed of integers, which could differ only in a few bits,
+// so all bits of `value` are mixed before they are combined with `hash`.
+static BL_INLINE uint32_t hash_mix_u64(uint32_t hash, uint64_t value) noexcept {
+  value ^= value >> 33;
+  value *= 0xFF51AFD7ED558CCDu;
+  value ^= value >> 33;
+  return (hash ^ uint32_t(value)) * 0x9E3779B1u + uint32_t(value >> 32);
+}
+
 //! \}
 
 } // {anonymous}
@@ -0,0 +1,214 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/core/runtime_p.h>
+#include <blend2d/support/heap_p.h>
+#include <blend2d/support/intops_p.h>
+#include <blend2d/support/ptrops_p.h>
+#include <blend2d/threading/atomic_p.h>
+#include <blend2d/threading/mutex_p.h>
+
+namespace bl {
+namespace Heap {
+
+// bl::Heap - Default Allocator
+// ============================
+
+static void* BL_CDECL default_alloc(void* user_data, size_t size, size_t alignment, BLAllocatorCategory category) noexcept {
+  bl_unused(user_data, alignment, category);
+  return ::malloc(size);
+}
+
+static void* BL_CDECL default_realloc(void* user_data, void* ptr, size_t old_size, size_t new_size, size_t alignment, BLAllocatorCategory category) noexcept {
+  bl_unused(user_data, old_size, alignment, category);
+  return ::realloc(ptr, new_size);
+}
+
+static void BL_CDECL default_free(void* user_data, void* ptr, size_t size, size_t alignment, BLAllocatorCategory category) noexcept {
+  bl_unused(user_data, size, alignment, category);
+  ::free(ptr);
+}
+
+// bl::Heap - Globals
+// ==================
+
+//! Maximum number of distinct allocators that can be installed during the lifetime of the process (including the
+//! default one). Allocators are never removed as there could still be memory allocated by them.
+static constexpr uint32_t kMaxAllocatorCount = 16u;
+
+//! Header that precedes each allocation, see \ref kHeaderSize.
+struct Header {
+  size_t size;
+  size_t allocator_index;
+};
+
+static_assert(sizeof(Header) <= kHeaderSize, "bl::Heap::Header must fit into kHeaderSize");
+
+static BLAllocator heap_allocators[kMaxAllocatorCount] = {
+  { default_alloc, default_realloc, default_free, nullptr }
+};
+
+static uint32_t heap_allocator_count = 1u;
+static uint32_t heap_current_index;
+static size_t heap_used[BL_ALLOCATOR_CATEGORY_MAX_VALUE + 1];
+static BLMutex heap_mutex;
+
+static BL_INLINE Header* header_from_ptr(void* ptr) noexcept {
+  return PtrOps::deoffset<Header>(ptr, kHeaderSize);
+}
+
+static BL_INLINE void* init_header(void* raw, size_t size, uint32_t allocator_index, BLAllocatorCategory category) noexcept {
+  Header* header = static_cast<Header*>(raw);
+  header->size = size;
+  header->allocator_index = allocator_index;
+
+  bl_atomic_fetch_add_relaxed(&heap_used[category], size);
+  return PtrOps::offset(raw, kHeaderSize);
+}
+
+// bl::Heap - API
+// ==============
+
+void* alloc(BLAllocatorCategory category, size_t size) noexcept {
+  if (BL_UNLIKELY(size > SIZE_MAX - kHeaderSize))
+    return nullptr;
+
+  uint32_t allocator_index = bl_atomic_fetch_strong(&heap_current_index);
+  const BLAllocator& allocator = heap_allocators[allocator_index];
+
+  size_t raw_size = size + kHeaderSize;
+  void* raw = allocator.alloc_func(allocator.user_data, raw_size, kAlignment, category);
+
+  if (BL_UNLIKELY(!raw))
+    return nullptr;
+
+  return init_header(raw, raw_size, allocator_index, category);
+}
+
+void* alloc_zeroed(BLAllocatorCategory category, size_t size) noexcept {
+  if (BL_UNLIKELY(size > SIZE_MAX - kHeaderSize))
+    return nullptr;
+
+  uint32_t allocator_index = bl_atomic_fetch_strong(&heap_current_index);
+  size_t raw_size = size + kHeaderSize;
+
+  // The default allocator uses `calloc()` as the C library can avoid clearing memory that is already zeroed, which
+  // is always the case of memory that was freshly mapped.
+  if (allocator_index == 0u) {
+    void* raw = ::calloc(1, raw_size);
+    if (BL_UNLIKELY(!raw))
+      return nullptr;
+    return init_header(raw, raw_size, 0u, category);
+  }
+
+  void* p = alloc(category, size);
+  if (BL_LIKELY(p))
+    memset(p, 0, size);
+  return p;
+}
+
+void* realloc(BLAllocatorCategory category, void* ptr, size_t size) noexcept {
+  if (!ptr)
+    return alloc(category, size);
+
+  if (BL_UNLIKELY(size > SIZE_MAX - kHeaderSize))
+    return nullptr;
+
+  Header* header = header_from_ptr(ptr);
+  size_t old_raw_size = header->size;
+  size_t new_raw_size = size + kHeaderSize;
+  uint32_t allocator_index = uint32_t(header->allocator_index);
+  const BLAllocator& allocator = heap_allocators[allocator_index];
+
+  if (allocator.realloc_func) {
+    void* raw = allocator.realloc_func(allocator.user_data, header, old_raw_size, new_raw_size, kAlignment, category);
+    if (BL_UNLIKELY(!raw))
+      return nullptr;
+
+    bl_atomic_fetch_sub_relaxed(&heap_used[category], old_raw_size);
+    return init_header(raw, new_raw_size, allocator_index, category);
+  }
+
+  void* p = alloc(category, size);
+  if (BL_UNLIKELY(!p))
+    return nullptr;
+
+  memcpy(p, ptr, bl_min(old_raw_size, new_raw_size) - kHeaderSize);
+  free(category, ptr);
+  return p;
+}
+
+void free(BLAllocatorCategory category, void* ptr) noexcept {
+  if (!ptr)
+    return;
+
+  Header* header = header_from_ptr(ptr);
+  size_t raw_size = header->size;
+  const BLAllocator& allocator = heap_allocators[header->allocator_index];
+
+  bl_atomic_fetch_sub_relaxed(&heap_used[category], raw_size);
+  allocator.free_func(allocator.user_data, header, raw_size, kAlignment, category);
+}
+
+size_t used_size(BLAllocatorCategory category) noexcept {
+  return bl_atomic_fetch_relaxed(&heap_used[category]);
+}
+
+BLResult set_allocator(const BLAllocator* allocator) noexcept {
+  if (!allocator) {
+    bl_atomic_store_strong(&heap_current_index, 0u);
+    return BL_SUCCESS;
+  }
+
+  if (BL_UNLIKELY(!allocator->alloc_func || !allocator->free_func))
+    return bl_make_error(BL_ERROR_INVALID_VALUE);
+
+  return heap_mutex.protect([&]() -> BLResult {
+    uint32_t count = heap_allocator_count;
+
+    // Reuse an allocator that was already installed, which is common when switching between a few allocators.
+    for (uint32_t i = 0; i < count; i++) {
+      const BLAllocator& a = heap_allocators[i];
+      if (a.alloc_func == allocator->alloc_func &&
+          a.realloc_func == allocator->realloc_func &&
+          a.free_func == allocator->free_func &&
+          a.user_data == allocator->user_data) {
+        bl_atomic_store_strong(&heap_current_index, i);
+        return BL_SUCCESS;
+      }
+    }
+
+    if (BL_UNLIKELY(count >= kMaxAllocatorCount))
+      return bl_make_error(BL_ERROR_OUT_OF_MEMORY);
+
+    heap_allocators[count] = *allocator;
+    heap_allocator_count = count + 1u;
+    bl_atomic_store_strong(&heap_current_index, count);
+    return BL_SUCCESS;
+  });
+}
+
+BLResult get_allocator(BLAllocator* allocator_out) noexcept {
+  *allocator_out = heap_allocators[bl_atomic_fetch_strong(&heap_current_index)];
+  return BL_SUCCESS;
+}
+
+} // {Heap}
+} // {bl}
+
+// bl::Heap - Runtime
+// ==================
+
+static void BL_CDECL bl_heap_rt_memory_info(BLRuntimeContext* rt, BLRuntimeMemoryInfo* memory_info) noexcept {
+  bl_unused(rt);
+  memory_info->object_heap_used = bl::Heap::used_size(BL_ALLOCATOR_CATEGORY_OBJECT);
+  memory_info->arena_heap_used = bl::Heap::used_size(BL_ALLOCATOR_CATEGORY_ARENA);
+  memory_info->zeroed_heap_used = bl::Heap::used_size(BL_ALLOCATOR_CATEGORY_ZEROED);
+}
+
+void bl_heap_rt_init(BLRuntimeContext* rt) noexcept {
+  rt->memory_info_handlers.add(bl_heap_rt_memory_info);
+}
@@ -0,0 +1,59 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_SUPPORT_HEAP_P_H_INCLUDED
+#define BLEND2D_SUPPORT_HEAP_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/core/runtime.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+namespace bl {
+namespace Heap {
+
+//! Size of a header that precedes each allocation made by `Heap`.
+//!
+//! The header stores the size of the allocation and an index of the allocator that made it, so the memory is always
+//! released by the same allocator, even when a different allocator was installed in the meantime. The size of the
+//! header is 16 bytes so the returned memory keeps the alignment that `malloc()` provides on 64-bit targets.
+static constexpr size_t kHeaderSize = 16u;
+
+//! Alignment requested from allocators installed by \ref bl_runtime_set_allocator().
+static constexpr size_t kAlignment = 16u;
+
+//! Allocates `size` bytes of memory of the given `category` through the current allocator.
+[[nodiscard]]
+BL_HIDDEN void* alloc(BLAllocatorCategory category, size_t size) noexcept;
+
+//! Allocates `size` bytes of zeroed memory of the given `category` through the current allocator.
+[[nodiscard]]
+BL_HIDDEN void* alloc_zeroed(BLAllocatorCategory category, size_t size) noexcept;
+
+//! Reallocates memory `ptr` to `size` bytes, the content is preserved up to the minimum of both sizes.
+//!
+//! The memory is reallocated by the allocator that allocated `ptr` (or the current allocator if `ptr` is null).
+//! The original memory stays valid if the reallocation fails.
+[[nodiscard]]
+BL_HIDDEN void* realloc(BLAllocatorCategory category, void* ptr, size_t size) noexcept;
+
+//! Releases memory `ptr` allocated by `alloc()`, `alloc_zeroed()`, or `realloc()`.
+BL_HIDDEN void free(BLAllocatorCategory category, void* ptr) noexcept;
+
+//! Returns the size of memory allocated by `Heap` of the given `category` (including headers).
+BL_HIDDEN size_t used_size(BLAllocatorCategory category) noexcept;
+
+BL_HIDDEN BLResult set_allocator(const BLAllocator* allocator) noexcept;
+BL_HIDDEN BLResult get_allocator(BLAllocator* allocator_out) noexcept;
+
+} // {Heap}
+} // {bl}
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_SUPPORT_HEAP_P_H_INCLUDED
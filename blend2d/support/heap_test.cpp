@@ -0,0 +1,125 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_test_p.h>
+#if defined(BL_TEST)
+
+#include <blend2d/core/image.h>
+#include <blend2d/core/runtime.h>
+#include <blend2d/support/arenaallocator_p.h>
+#include <blend2d/support/heap_p.h>
+
+// bl::Heap - Tests
+// ================
+
+namespace bl {
+namespace Tests {
+
+struct HeapTestAllocator {
+  size_t alloc_count;
+  size_t free_count;
+  size_t used_size;
+};
+
+static void* BL_CDECL heap_test_alloc(void* user_data, size_t size, size_t alignment, BLAllocatorCategory category) noexcept {
+  bl_unused(alignment, category);
+  HeapTestAllocator* allocator = static_cast<HeapTestAllocator*>(user_data);
+
+  allocator->alloc_count++;
+  allocator->used_size += size;
+  return malloc(size);
+}
+
+static void BL_CDECL heap_test_free(void* user_data, void* ptr, size_t size, size_t alignment, BLAllocatorCategory category) noexcept {
+  bl_unused(alignment, category);
+  HeapTestAllocator* allocator = static_cast<HeapTestAllocator*>(user_data);
+
+  allocator->free_count++;
+  allocator->used_size -= size;
+  free(ptr);
+}
+
+UNIT(support_heap, BL_TEST_GROUP_SUPPORT_UTILITIES) {
+  INFO("Testing per-category counters");
+  {
+    size_t object_used = Heap::used_size(BL_ALLOCATOR_CATEGORY_OBJECT);
+
+    void* p = Heap::alloc(BL_ALLOCATOR_CATEGORY_OBJECT, 100);
+    EXPECT_NE(p, nullptr);
+    EXPECT_EQ(Heap::used_size(BL_ALLOCATOR_CATEGORY_OBJECT), object_used + 100 + Heap::kHeaderSize);
+
+    Heap::free(BL_ALLOCATOR_CATEGORY_OBJECT, p);
+    EXPECT_EQ(Heap::used_size(BL_ALLOCATOR_CATEGORY_OBJECT), object_used);
+  }
+
+  INFO("Testing zeroed allocation and reallocation");
+  {
+    uint8_t* p = static_cast<uint8_t*>(Heap::alloc_zeroed(BL_ALLOCATOR_CATEGORY_ZEROED, 256));
+    EXPECT_NE(p, nullptr);
+
+    for (size_t i = 0; i < 256; i++) {
+      EXPECT_EQ(p[i], 0u);
+      p[i] = uint8_t(i);
+    }
+
+    p = static_cast<uint8_t*>(Heap::realloc(BL_ALLOCATOR_CATEGORY_ZEROED, p, 4096));
+    EXPECT_NE(p, nullptr);
+
+    for (size_t i = 0; i < 256; i++)
+      EXPECT_EQ(p[i], uint8_t(i));
+
+    Heap::free(BL_ALLOCATOR_CATEGORY_ZEROED, p);
+  }
+
+  INFO("Testing custom allocator");
+  {
+    HeapTestAllocator counters {};
+    BLAllocator allocator {};
+    allocator.alloc_func = heap_test_alloc;
+    allocator.free_func = heap_test_free;
+    allocator.user_data = &counters;
+
+    BLAllocator invalid {};
+    EXPECT_EQ(BLRuntime::set_allocator(&invalid), BL_ERROR_INVALID_VALUE);
+
+    BLAllocator default_allocator {};
+    EXPECT_SUCCESS(BLRuntime::get_allocator(&default_allocator));
+    EXPECT_SUCCESS(BLRuntime::set_allocator(&allocator));
+
+    BLAllocator current {};
+    EXPECT_SUCCESS(BLRuntime::get_allocator(&current));
+    EXPECT_TRUE(current.alloc_func == heap_test_alloc);
+    EXPECT_TRUE(current.user_data == &counters);
+
+    BLImage img(64, 64, BL_FORMAT_PRGB32);
+    EXPECT_EQ(counters.alloc_count, 1u);
+
+    // Arena blocks must be allocated by the custom allocator as well.
+    {
+      ArenaAllocator arena(8192);
+      EXPECT_NE(arena.alloc(1024), nullptr);
+      EXPECT_EQ(counters.alloc_count, 2u);
+    }
+    EXPECT_EQ(counters.free_count, 1u);
+
+    // Memory must be released by the allocator that allocated it, even if a different allocator is installed.
+    EXPECT_SUCCESS(BLRuntime::set_allocator(nullptr));
+    EXPECT_SUCCESS(BLRuntime::get_allocator(&current));
+    EXPECT_TRUE(current.alloc_func == default_allocator.alloc_func);
+
+    img.reset();
+    EXPECT_EQ(counters.free_count, 2u);
+    EXPECT_EQ(counters.used_size, 0u);
+
+    BLRuntimeMemoryInfo info {};
+    EXPECT_SUCCESS(BLRuntime::query_memory_info(&info));
+    EXPECT_EQ(info.object_heap_used, Heap::used_size(BL_ALLOCATOR_CATEGORY_OBJECT));
+  }
+}
+
+} // {Tests}
+} // {bl}
+
+#endif // BL_TEST
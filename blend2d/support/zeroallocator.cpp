@@ -9,6 +9,7 @@
 #include <blend2d/support/arenalist_p.h>
 #include <blend2d/support/arenatree_p.h>
 #include <blend2d/support/bitops_p.h>
+#include <blend2d/support/heap_p.h>
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/traits_p.h>
 #include <blend2d/support/wrap_p.h>
@@ -195,17 +196,13 @@ public:
     uint32_t num_bit_words = (area_size + IntOps::bit_size_of<BLBitWord>() - 1u) / IntOps::bit_size_of<BLBitWord>();
 
     size_t block_struct_size = sizeof(Block) + size_t(num_bit_words - 1) * sizeof(BLBitWord);
-    Block* block = static_cast<Block*>(malloc(block_struct_size));
-    uint8_t* buffer = static_cast<uint8_t*>(::calloc(1, block_size + kBlockAlignment));
+    Block* block = static_cast<Block*>(Heap::alloc(BL_ALLOCATOR_CATEGORY_ZEROED, block_struct_size));
+    uint8_t* buffer = static_cast<uint8_t*>(Heap::alloc_zeroed(BL_ALLOCATOR_CATEGORY_ZEROED, block_size + kBlockAlignment));
 
     // Out of memory.
     if (BL_UNLIKELY(!block || !buffer)) {
-      if (buffer)
-        free(buffer);
-
-      if (block)
-        free(block);
-
+      Heap::free(BL_ALLOCATOR_CATEGORY_ZEROED, buffer);
+      Heap::free(BL_ALLOCATOR_CATEGORY_ZEROED, block);
       return nullptr;
     }
 
@@ -217,8 +214,8 @@ public:
   void delete_block(Block* block) noexcept {
     BL_ASSERT(!(block->has_flag(Block::kFlagStatic)));
 
-    free(block->_buffer);
-    free(block);
+    Heap::free(BL_ALLOCATOR_CATEGORY_ZEROED, block->_buffer);
+    Heap::free(BL_ALLOCATOR_CATEGORY_ZEROED, block);
   }
 
   void insert_block(Block* block) noexcept {
@@ -0,0 +1,85 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#include <blend2d/threading/conditionvariable_p.h>
+#include <blend2d/threading/mutex_p.h>
+#include <blend2d/threading/paralleljob_p.h>
+#include <blend2d/threading/threadpool_p.h>
+
+// BLParallelJob - Completion
+// ==========================
+
+// Worker threads decrement `running_count` and signal the condition while holding `mutex`. The calling thread waits
+// for zero under the same mutex, so it cannot observe zero (and destroy the state, which lives on its stack) before
+// the last worker has released the mutex and stopped touching it.
+struct BLParallelJobState {
+  BLParallelJobFunc func;
+  void* data;
+  uint32_t running_count;
+
+  BLMutex mutex;
+  BLConditionVariable condition;
+};
+
+static void BL_CDECL bl_parallel_job_thread_entry(BLThread* thread, void* data) noexcept {
+  bl_unused(thread);
+
+  BLParallelJobState* state = static_cast<BLParallelJobState*>(data);
+  state->func(state->data);
+
+  BLLockGuard<BLMutex> guard(state->mutex);
+  if (--state->running_count == 0u)
+    state->condition.signal();
+}
+
+// BLParallelJob - Run
+// ===================
+
+uint32_t bl_run_parallel_job(BLParallelJobFunc func, void* data, uint32_t thread_count) noexcept {
+  constexpr uint32_t kMaxThreads = 32;
+
+  BLThread* threads[kMaxThreads];
+  BLThreadPool* thread_pool = bl_thread_pool_global();
+
+  uint32_t worker_count = bl_clamp<uint32_t>(thread_count, 1u, kMaxThreads) - 1u;
+  uint32_t n = 0;
+
+  if (worker_count) {
+    // Not a failure if no threads were acquired - the thread pool is exhausted, so the calling thread does everything.
+    BLResult reason = BL_SUCCESS;
+    n = thread_pool->acquire_threads(threads, worker_count, 0, &reason);
+  }
+
+  if (!n) {
+    func(data);
+    return 1u;
+  }
+
+  BLParallelJobState state;
+  state.func = func;
+  state.data = data;
+  state.running_count = n;
+
+  uint32_t started = n;
+  for (uint32_t i = 0; i < n; i++) {
+    if (threads[i]->run(bl_parallel_job_thread_entry, &state) != BL_SUCCESS) {
+      BLLockGuard<BLMutex> guard(state.mutex);
+      state.running_count--;
+      started--;
+    }
+  }
+
+  func(data);
+
+  {
+    BLLockGuard<BLMutex> guard(state.mutex);
+    while (state.running_count != 0u)
+      state.condition.wait(state.mutex);
+  }
+
+  thread_pool->release_threads(threads, n);
+  return started + 1u;
+}
@@ -0,0 +1,30 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_THREADING_PARALLELJOB_P_H_INCLUDED
+#define BLEND2D_THREADING_PARALLELJOB_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+
+//! \cond INTERNAL
+//! \addtogroup blend2d_internal
+//! \{
+
+//! Function called by each thread participating in a parallel job, including the calling thread.
+typedef void (BL_CDECL* BLParallelJobFunc)(void* data) noexcept;
+
+//! Calls `func(data)` from the calling thread and from up to `thread_count - 1` threads acquired from the global
+//! thread pool (at most 32 threads in total) and returns after all of them have returned, so `data` can live on the caller's stack.
+//!
+//! It's not guaranteed that any thread is acquired (the thread pool may be exhausted) and threads may start late,
+//! so `func` must claim work items atomically until there is nothing left instead of processing a fixed share.
+//!
+//! Returns the number of threads that called `func`, including the calling thread.
+BL_HIDDEN uint32_t bl_run_parallel_job(BLParallelJobFunc func, void* data, uint32_t thread_count) noexcept;
+
+//! \}
+//! \endcond
+
+#endif // BLEND2D_THREADING_PARALLELJOB_P_H_INCLUDED
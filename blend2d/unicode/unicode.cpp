@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: Zlib
 
 #include <blend2d/core/api-build_p.h>
+#include <blend2d/core/runtime_p.h>
 #include <blend2d/unicode/unicode_p.h>
 #include <blend2d/support/intops_p.h>
 #include <blend2d/support/memops_p.h>
@@ -34,6 +35,49 @@ const uint8_t utf8_size_data[256] = {
   4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0  // 240 - 255
 };
 
+// bl::Unicode - ASCII Fast-Forwarding
+// ===================================
+
+FunctionTable function_table;
+
+size_t BL_CDECL ascii_size_u8_ref(const uint8_t* src, size_t size) noexcept {
+  size_t i = 0;
+  while (i < size && src[i] < 0x80u)
+    i++;
+  return i;
+}
+
+size_t BL_CDECL ascii_size_u16_ref(const void* src, size_t size) noexcept {
+  const uint8_t* src8 = static_cast<const uint8_t*>(src);
+
+  size_t i = 0;
+  while (i < size && MemOps::readU16u(src8 + i * 2u) < 0x80u)
+    i++;
+  return i;
+}
+
+size_t BL_CDECL ascii_to_utf16_ref(void* dst, const uint8_t* src, size_t size) noexcept {
+  uint8_t* dst8 = static_cast<uint8_t*>(dst);
+
+  size_t i = 0;
+  while (i < size && src[i] < 0x80u) {
+    MemOps::writeU16u(dst8 + i * 2u, src[i]);
+    i++;
+  }
+  return i;
+}
+
+size_t BL_CDECL ascii_to_utf32_ref(void* dst, const uint8_t* src, size_t size) noexcept {
+  uint8_t* dst8 = static_cast<uint8_t*>(dst);
+
+  size_t i = 0;
+  while (i < size && src[i] < 0x80u) {
+    MemOps::writeU32u(dst8 + i * 4u, src[i]);
+    i++;
+  }
+  return i;
+}
+
 // bl::Unicode - Validation
 // ========================
 
@@ -66,6 +110,45 @@ static BL_INLINE BLResult validate_unicode_string(const void* data, size_t size,
   return result;
 }
 
+// Validates UTF-8 and UTF-16 strings, which are mostly ASCII in practice, so runs of ASCII characters are skipped
+// by `ascii_size` function and only the remaining characters are decoded and validated by the iterator.
+template<typename Iterator, IOFlags kFlags, typename AsciiSizeFunc>
+static BL_INLINE BLResult validate_unicode_string_ff(const void* data, size_t size, ValidationState& state, const AsciiSizeFunc& ascii_size) noexcept {
+  constexpr uint32_t kCharSize = Iterator::kCharSize;
+
+  Iterator it(data, size);
+  BLResult result = BL_SUCCESS;
+
+  while (it.has_next()) {
+    size_t remaining = it.remaining_byte_size() / kCharSize;
+    if (remaining >= kAsciiFastForwardThreshold) {
+      size_t n = ascii_size(it._ptr, remaining);
+      it.skip_ascii(n);
+
+      if (!it.has_next())
+        break;
+    }
+
+    uint32_t uc;
+    result = it.template next<kFlags | IOFlags::kCalcIndex>(uc);
+    if (result)
+      break;
+  }
+
+  state.utf8_index = it.utf8_index(data);
+  state.utf16_index = it.utf16_index(data);
+  state.utf32_index = it.utf32_index(data);
+  return result;
+}
+
+static BL_INLINE size_t ascii_size_utf8(const char* src, size_t size) noexcept {
+  return function_table.ascii_size_u8(reinterpret_cast<const uint8_t*>(src), size);
+}
+
+static BL_INLINE size_t ascii_size_utf16(const char* src, size_t size) noexcept {
+  return function_table.ascii_size_u16(src, size);
+}
+
 BLResult bl_validate_unicode(const void* data, size_t size_in_bytes, BLTextEncoding encoding, ValidationState& state) noexcept {
   BLResult result;
   state.reset();
@@ -75,14 +158,14 @@ BLResult bl_validate_unicode(const void* data, size_t size_in_bytes, BLTextEncod
       return validate_latin1_string(static_cast<const char*>(data), size_in_bytes, state);
 
     case BL_TEXT_ENCODING_UTF8:
-      return validate_unicode_string<Utf8Reader, IOFlags::kStrict>(data, size_in_bytes, state);
+      return validate_unicode_string_ff<Utf8Reader, IOFlags::kStrict>(data, size_in_bytes, state, ascii_size_utf8);
 
     case BL_TEXT_ENCODING_UTF16:
       // This will make sure we won't compile specialized code for architectures that don't penalize unaligned reads.
       if (MemOps::kUnalignedMem16 || !IntOps::is_aligned(data, 2))
-        result = validate_unicode_string<Utf16Reader, IOFlags::kStrict | IOFlags::kUnaligned>(data, size_in_bytes, state);
+        result = validate_unicode_string_ff<Utf16Reader, IOFlags::kStrict | IOFlags::kUnaligned>(data, size_in_bytes, state, ascii_size_utf16);
       else
-        result = validate_unicode_string<Utf16Reader, IOFlags::kStrict>(data, size_in_bytes, state);
+        result = validate_unicode_string_ff<Utf16Reader, IOFlags::kStrict>(data, size_in_bytes, state, ascii_size_utf16);
 
       if (result == BL_SUCCESS && BL_UNLIKELY(size_in_bytes & 0x1))
         result = bl_make_error(BL_ERROR_DATA_TRUNCATED);
@@ -147,6 +230,47 @@ static BL_INLINE BLResult convert_unicode_impl(void* dst, size_t dst_size_in_byt
     return result;
 }
 
+// UTF-8 to UTF-16 or UTF-32 conversion, which fast-forwards runs of ASCII characters by `ascii_to_wide` function
+// and uses the iterator only for the remaining characters.
+template<typename Writer, IOFlags kFlags>
+static BL_INLINE BLResult convert_utf8_impl(void* dst, size_t dst_size_in_bytes, const void* src, size_t src_size_in_bytes, ConversionState& state, FunctionTable::AsciiToWideFunc ascii_to_wide) noexcept {
+  typedef typename Writer::CharType DstChar;
+
+  Writer writer(static_cast<DstChar*>(dst), dst_size_in_bytes / sizeof(DstChar));
+  Utf8Reader iter(src, src_size_in_bytes);
+
+  BLResult result = BL_SUCCESS;
+  while (iter.has_next()) {
+    size_t remaining = bl_min(iter.remaining_byte_size(), writer.remaining_size());
+    if (remaining >= kAsciiFastForwardThreshold) {
+      size_t n = ascii_to_wide(writer._ptr, reinterpret_cast<const uint8_t*>(iter._ptr), remaining);
+      iter.skip_ascii(n);
+      writer._ptr += n;
+
+      if (!iter.has_next())
+        break;
+    }
+
+    uint32_t uc;
+    size_t uc_size_in_bytes;
+
+    result = iter.template next<kFlags>(uc, uc_size_in_bytes);
+    if (BL_UNLIKELY(result != BL_SUCCESS))
+      break;
+
+    result = writer.write(uc);
+    if (BL_UNLIKELY(result != BL_SUCCESS)) {
+      state.dst_index = offset_of_ptr(dst, writer._ptr);
+      state.src_index = offset_of_ptr(src, iter._ptr) - uc_size_in_bytes;
+      return result;
+    }
+  }
+
+  state.dst_index = offset_of_ptr(dst, writer._ptr);
+  state.src_index = offset_of_ptr(src, iter._ptr);
+  return result;
+}
+
 BLResult convert_unicode(
   void* dst, size_t dst_size_in_bytes, uint32_t dst_encoding,
   const void* src, size_t src_size_in_bytes, uint32_t src_encoding,
@@ -284,9 +408,9 @@ BLResult convert_unicode(
 
     case (BL_TEXT_ENCODING_UTF16 << 2) | BL_TEXT_ENCODING_UTF8: {
       if (MemOps::kUnalignedMem16 || !IntOps::is_aligned(dst, 2))
-        result = convert_unicode_impl<Utf16Writer<BL_BYTE_ORDER_NATIVE, 1>, Utf8Reader, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state);
+        result = convert_utf8_impl<Utf16Writer<BL_BYTE_ORDER_NATIVE, 1>, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state, function_table.ascii_to_utf16);
       else
-        result = convert_unicode_impl<Utf16Writer<BL_BYTE_ORDER_NATIVE, 2>, Utf8Reader, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state);
+        result = convert_utf8_impl<Utf16Writer<BL_BYTE_ORDER_NATIVE, 2>, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state, function_table.ascii_to_utf16);
       break;
     }
 
@@ -355,9 +479,9 @@ BLResult convert_unicode(
 
     case (BL_TEXT_ENCODING_UTF32 << 2) | BL_TEXT_ENCODING_UTF8: {
       if (MemOps::kUnalignedMem32 || !IntOps::is_aligned(dst, 4))
-        result = convert_unicode_impl<Utf32Writer<BL_BYTE_ORDER_NATIVE, 1>, Utf8Reader, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state);
+        result = convert_utf8_impl<Utf32Writer<BL_BYTE_ORDER_NATIVE, 1>, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state, function_table.ascii_to_utf32);
       else
-        result = convert_unicode_impl<Utf32Writer<BL_BYTE_ORDER_NATIVE, 4>, Utf8Reader, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state);
+        result = convert_utf8_impl<Utf32Writer<BL_BYTE_ORDER_NATIVE, 4>, IOFlags::kStrict>(dst, dst_size_in_bytes, src, src_size_in_bytes, state, function_table.ascii_to_utf32);
       break;
     }
 
@@ -395,3 +519,41 @@ BLResult convert_unicode(
 }
 
 } // {bl::Unicode}
+
+// bl::Unicode - Runtime Registration
+// ==================================
+
+void bl_unicode_rt_init(BLRuntimeContext* rt) noexcept {
+  bl_unused(rt);
+
+  bl::Unicode::FunctionTable& ft = bl::Unicode::function_table;
+  ft.ascii_size_u8 = bl::Unicode::ascii_size_u8_ref;
+  ft.ascii_size_u16 = bl::Unicode::ascii_size_u16_ref;
+  ft.ascii_to_utf16 = bl::Unicode::ascii_to_utf16_ref;
+  ft.ascii_to_utf32 = bl::Unicode::ascii_to_utf32_ref;
+
+#if defined(BL_BUILD_OPT_SSE4_2)
+  if (bl_runtime_has_sse4_2(rt)) {
+    ft.ascii_size_u8 = bl::Unicode::ascii_size_u8_sse4_2;
+    ft.ascii_size_u16 = bl::Unicode::ascii_size_u16_sse4_2;
+    ft.ascii_to_utf16 = bl::Unicode::ascii_to_utf16_sse4_2;
+    ft.ascii_to_utf32 = bl::Unicode::ascii_to_utf32_sse4_2;
+  }
+#endif // BL_BUILD_OPT_SSE4_2
+
+#if defined(BL_BUILD_OPT_AVX2)
+  if (bl_runtime_has_avx2(rt)) {
+    ft.ascii_size_u8 = bl::Unicode::ascii_size_u8_avx2;
+    ft.ascii_size_u16 = bl::Unicode::ascii_size_u16_avx2;
+  }
+#endif // BL_BUILD_OPT_AVX2
+
+#if defined(BL_BUILD_OPT_ASIMD)
+  if (bl_runtime_has_asimd(rt)) {
+    ft.ascii_size_u8 = bl::Unicode::ascii_size_u8_asimd;
+    ft.ascii_size_u16 = bl::Unicode::ascii_size_u16_asimd;
+    ft.ascii_to_utf16 = bl::Unicode::ascii_to_utf16_asimd;
+    ft.ascii_to_utf32 = bl::Unicode::ascii_to_utf32_asimd;
+  }
+#endif // BL_BUILD_OPT_ASIMD
+}
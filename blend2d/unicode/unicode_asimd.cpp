@@ -0,0 +1,35 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#if defined(BL_TARGET_OPT_ASIMD)
+
+#include <blend2d/unicode/unicode_p.h>
+#include <blend2d/unicode/unicodesimdimpl_p.h>
+
+namespace bl::Unicode {
+
+// bl::Unicode - ASCII Fast-Forwarding (ASIMD)
+// ===========================================
+
+size_t BL_CDECL ascii_size_u8_asimd(const uint8_t* src, size_t size) noexcept {
+  return ascii_size_u8_simd<SIMD::Vec16xU8>(src, size);
+}
+
+size_t BL_CDECL ascii_size_u16_asimd(const void* src, size_t size) noexcept {
+  return ascii_size_u16_simd<SIMD::Vec8xU16>(src, size);
+}
+
+size_t BL_CDECL ascii_to_utf16_asimd(void* dst, const uint8_t* src, size_t size) noexcept {
+  return ascii_to_wide_simd<uint16_t>(dst, src, size);
+}
+
+size_t BL_CDECL ascii_to_utf32_asimd(void* dst, const uint8_t* src, size_t size) noexcept {
+  return ascii_to_wide_simd<uint32_t>(dst, src, size);
+}
+
+} // {bl::Unicode}
+
+#endif // BL_TARGET_OPT_ASIMD
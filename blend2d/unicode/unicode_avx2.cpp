@@ -0,0 +1,30 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#include <blend2d/core/api-build_p.h>
+#if defined(BL_TARGET_OPT_AVX2)
+
+#include <blend2d/unicode/unicode_p.h>
+#include <blend2d/unicode/unicodesimdimpl_p.h>
+
+namespace bl::Unicode {
+
+// bl::Unicode - ASCII Fast-Forwarding (AVX2)
+// ==========================================
+
+// NOTE: Only scanning benefits from 256-bit vectors. Widening ASCII to UTF-16 and UTF-32 is bound by stores, which
+// is handled well enough by the SSE4.2 implementation.
+
+size_t BL_CDECL ascii_size_u8_avx2(const uint8_t* src, size_t size) noexcept {
+  return ascii_size_u8_simd<SIMD::Vec32xU8>(src, size);
+}
+
+size_t BL_CDECL ascii_size_u16_avx2(const void* src, size_t size) noexcept {
+  return ascii_size_u16_simd<SIMD::Vec16xU16>(src, size);
+}
+
+} // {bl::Unicode}
+
+#endif // BL_TARGET_OPT_AVX2
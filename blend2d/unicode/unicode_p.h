@@ -63,6 +63,56 @@ BL_DEFINE_ENUM_FLAGS(IOFlags)
 
 BL_HIDDEN extern const uint8_t utf8_size_data[256];
 
+// bl::Unicode - ASCII Fast-Forwarding
+// ===================================
+
+//! Minimum number of remaining code units required to fast-forward an ASCII run by \ref FunctionTable functions -
+//! shorter runs are cheaper to process by unicode readers directly.
+static constexpr size_t kAsciiFastForwardThreshold = 16u;
+
+//! Functions used to fast-forward runs of ASCII characters, selected at runtime based on CPU features.
+struct FunctionTable {
+  //! Returns the number of leading ASCII characters of a UTF-8 (or Latin1) string `src` having `size` bytes.
+  using AsciiSizeU8Func = size_t (BL_CDECL*)(const uint8_t* src, size_t size) noexcept;
+  //! Returns the number of leading ASCII characters of a native UTF-16 string `src` having `size` code units, which
+  //! doesn't have to be aligned.
+  using AsciiSizeU16Func = size_t (BL_CDECL*)(const void* src, size_t size) noexcept;
+  //! Converts leading ASCII characters of `src` having `size` bytes to native UTF-16 (or UTF-32) code units stored
+  //! to `dst`, which doesn't have to be aligned, and returns the number of converted characters.
+  using AsciiToWideFunc = size_t (BL_CDECL*)(void* dst, const uint8_t* src, size_t size) noexcept;
+
+  AsciiSizeU8Func ascii_size_u8;
+  AsciiSizeU16Func ascii_size_u16;
+  AsciiToWideFunc ascii_to_utf16;
+  AsciiToWideFunc ascii_to_utf32;
+};
+
+BL_HIDDEN extern FunctionTable function_table;
+
+BL_HIDDEN size_t BL_CDECL ascii_size_u8_ref(const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_size_u16_ref(const void* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_to_utf16_ref(void* dst, const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_to_utf32_ref(void* dst, const uint8_t* src, size_t size) noexcept;
+
+#if defined(BL_BUILD_OPT_SSE4_2)
+BL_HIDDEN size_t BL_CDECL ascii_size_u8_sse4_2(const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_size_u16_sse4_2(const void* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_to_utf16_sse4_2(void* dst, const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_to_utf32_sse4_2(void* dst, const uint8_t* src, size_t size) noexcept;
+#endif // BL_BUILD_OPT_SSE4_2
+
+#if defined(BL_BUILD_OPT_AVX2)
+BL_HIDDEN size_t BL_CDECL ascii_size_u8_avx2(const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_size_u16_avx2(const void* src, size_t size) noexcept;
+#endif // BL_BUILD_OPT_AVX2
+
+#if defined(BL_BUILD_OPT_ASIMD)
+BL_HIDDEN size_t BL_CDECL ascii_size_u8_asimd(const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_size_u16_asimd(const void* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_to_utf16_asimd(void* dst, const uint8_t* src, size_t size) noexcept;
+BL_HIDDEN size_t BL_CDECL ascii_to_utf32_asimd(void* dst, const uint8_t* src, size_t size) noexcept;
+#endif // BL_BUILD_OPT_ASIMD
+
 // bl::Unicode - Utilities
 // =======================
 
@@ -343,6 +393,12 @@ TruncatedString:
     _ptr++;
   }
 
+  //! Skips `n` ASCII characters (as returned by \ref FunctionTable::ascii_size_u8), which don't affect indexes.
+  BL_INLINE void skip_ascii(size_t n) noexcept {
+    BL_ASSERT(n <= remaining_byte_size());
+    _ptr += n;
+  }
+
   template<IOFlags kFlags = IOFlags::kNoFlags>
   [[nodiscard]]
   BL_INLINE BLResult validate() noexcept {
@@ -484,6 +540,12 @@ TruncatedString:
     _ptr += 2;
   }
 
+  //! Skips `n` ASCII characters (as returned by \ref FunctionTable::ascii_size_u16), which don't affect indexes.
+  BL_INLINE void skip_ascii(size_t n) noexcept {
+    BL_ASSERT(n <= remaining_byte_size() / 2u);
+    _ptr += n * 2u;
+  }
+
   //! \}
 
   //! \name Validator
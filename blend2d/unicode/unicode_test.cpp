@@ -342,6 +342,144 @@ UNIT(unicode_io, BL_TEST_GROUP_CORE_UTILITIES) {
   }
 }
 
+UNIT(unicode_ascii_fast_forward, BL_TEST_GROUP_CORE_UTILITIES) {
+  // Optimized functions selected at runtime must match reference implementations for all sizes and positions of
+  // the first non-ASCII character, and they must never write past the converted characters.
+  constexpr size_t kMaxSize = 100;
+  constexpr uint32_t kSentinel = 0xCDCDCDCDu;
+
+  uint8_t src8[kMaxSize + 1];
+  uint16_t src16[kMaxSize + 1];
+  uint32_t dst32[kMaxSize + 2];
+  uint16_t dst16[kMaxSize + 2];
+
+  for (size_t i = 0; i <= kMaxSize; i++) {
+    src8[i] = uint8_t('a' + (i % 26u));
+    src16[i] = uint16_t('A' + (i % 26u));
+  }
+
+  INFO("Testing ASCII fast-forwarding functions against reference implementations");
+  for (size_t size = 0; size <= kMaxSize; size++) {
+    for (size_t pos = 0; pos <= size; pos++) {
+      for (uint32_t offset = 0; offset < 2; offset++) {
+        if (offset > size)
+          continue;
+
+        uint8_t saved8 = src8[pos];
+        uint16_t saved16 = src16[pos];
+
+        src8[pos] = uint8_t(0x80u + (pos & 0x3Fu));
+        src16[pos] = uint16_t(0x80u << (pos % 9u));
+
+        const uint8_t* s8 = src8 + offset;
+        const uint16_t* s16 = src16 + offset;
+        size_t n = size - offset;
+
+        EXPECT_EQ(function_table.ascii_size_u8(s8, n), ascii_size_u8_ref(s8, n))
+          .message("ascii_size_u8() failed (size=%zu non-ascii at %zu)", n, pos);
+
+        EXPECT_EQ(function_table.ascii_size_u16(s16, n), ascii_size_u16_ref(s16, n))
+          .message("ascii_size_u16() failed (size=%zu non-ascii at %zu)", n, pos);
+
+        for (size_t i = 0; i < kMaxSize + 2; i++) {
+          dst32[i] = kSentinel;
+          dst16[i] = uint16_t(kSentinel);
+        }
+
+        size_t count32 = function_table.ascii_to_utf32(dst32, s8, n);
+        size_t count16 = function_table.ascii_to_utf16(dst16, s8, n);
+        size_t expected = ascii_size_u8_ref(s8, n);
+
+        EXPECT_EQ(count32, expected).message("ascii_to_utf32() failed (size=%zu non-ascii at %zu)", n, pos);
+        EXPECT_EQ(count16, expected).message("ascii_to_utf16() failed (size=%zu non-ascii at %zu)", n, pos);
+
+        for (size_t i = 0; i < kMaxSize + 2; i++) {
+          uint32_t expected32 = i < expected ? uint32_t(s8[i]) : kSentinel;
+          uint16_t expected16 = i < expected ? uint16_t(s8[i]) : uint16_t(kSentinel);
+
+          EXPECT_EQ(dst32[i], expected32).message("ascii_to_utf32() wrote invalid data at %zu (size=%zu)", i, n);
+          EXPECT_EQ(dst16[i], expected16).message("ascii_to_utf16() wrote invalid data at %zu (size=%zu)", i, n);
+        }
+
+        src8[pos] = saved8;
+        src16[pos] = saved16;
+      }
+    }
+  }
+
+  INFO("Testing validation and conversion of long strings having both ASCII and non-ASCII characters");
+  {
+    // "Grüße" is 7 bytes in UTF-8 (5 characters), "😀" is 4 bytes (2 UTF-16 code units).
+    static const char ascii[] = "The quick brown fox jumps over the lazy dog. ";
+    static const char mixed[] = "Gr\xC3\xBC\xC3\x9F" "e \xF0\x9F\x98\x80 ";
+
+    char text[512];
+    size_t text_size = 0;
+    size_t char_count = 0;
+    size_t smp_count = 0;
+
+    for (uint32_t i = 0; i < 4; i++) {
+      memcpy(text + text_size, ascii, sizeof(ascii) - 1u);
+      text_size += sizeof(ascii) - 1u;
+      char_count += sizeof(ascii) - 1u;
+
+      memcpy(text + text_size, mixed, sizeof(mixed) - 1u);
+      text_size += sizeof(mixed) - 1u;
+      char_count += 8u;
+      smp_count++;
+    }
+
+    ValidationState vs;
+    EXPECT_SUCCESS(bl_validate_utf8(text, text_size, vs));
+    EXPECT_EQ(vs.utf8_index, text_size);
+    EXPECT_EQ(vs.utf16_index, char_count + smp_count);
+    EXPECT_EQ(vs.utf32_index, char_count);
+
+    uint32_t utf32[512];
+    uint16_t utf16[512];
+    ConversionState cs;
+
+    EXPECT_SUCCESS(convert_unicode(utf32, sizeof(utf32), BL_TEXT_ENCODING_UTF32, text, text_size, BL_TEXT_ENCODING_UTF8, cs));
+    EXPECT_EQ(cs.src_index, text_size);
+    EXPECT_EQ(cs.dst_index, char_count * 4u);
+
+    EXPECT_SUCCESS(convert_unicode(utf16, sizeof(utf16), BL_TEXT_ENCODING_UTF16, text, text_size, BL_TEXT_ENCODING_UTF8, cs));
+    EXPECT_EQ(cs.src_index, text_size);
+    EXPECT_EQ(cs.dst_index, (char_count + smp_count) * 2u);
+
+    // Compare against characters decoded by the reader.
+    Utf8Reader reader(text, text_size);
+    size_t index = 0;
+    while (reader.has_next()) {
+      uint32_t uc;
+      EXPECT_SUCCESS(reader.next(uc));
+      EXPECT_EQ(utf32[index], uc).message("Invalid character converted at #%zu", index);
+      index++;
+    }
+
+    EXPECT_SUCCESS(bl_validate_utf16(utf16, char_count + smp_count, vs));
+    EXPECT_EQ(vs.utf8_index, text_size);
+    EXPECT_EQ(vs.utf32_index, char_count);
+
+    // Invalid and truncated sequences following a long ASCII run must be reported at the right index.
+    text[100] = char(0xFF);
+    EXPECT_EQ(bl_validate_utf8(text, text_size, vs), BL_ERROR_INVALID_STRING);
+    EXPECT_EQ(vs.utf8_index, 100u);
+
+    EXPECT_EQ(convert_unicode(utf32, sizeof(utf32), BL_TEXT_ENCODING_UTF32, ascii, sizeof(ascii) - 1u, BL_TEXT_ENCODING_UTF8, cs), BL_SUCCESS);
+    EXPECT_EQ(cs.dst_index, (sizeof(ascii) - 1u) * 4u);
+
+    static const char truncated[] = "0123456789ABCDEF0123456789ABCDEF\xC3";
+    EXPECT_EQ(bl_validate_utf8(truncated, sizeof(truncated) - 1u, vs), BL_ERROR_DATA_TRUNCATED);
+    EXPECT_EQ(vs.utf8_index, 32u);
+
+    // Not enough space in the destination must not be reported as truncated input.
+    EXPECT_EQ(convert_unicode(utf32, 20u * 4u, BL_TEXT_ENCODING_UTF32, truncated, sizeof(truncated) - 1u, BL_TEXT_ENCODING_UTF8, cs), BL_ERROR_NO_SPACE_LEFT);
+    EXPECT_EQ(cs.src_index, 20u);
+    EXPECT_EQ(cs.dst_index, 20u * 4u);
+  }
+}
+
 } // {bl::Unicode::Tests}
 
 #endif // BL_TEST
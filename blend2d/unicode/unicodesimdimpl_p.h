@@ -0,0 +1,168 @@
+// This file is part of Blend2D project <https://blend2d.com>
+//
+// See blend2d.h or LICENSE.md for license and copyright information
+// SPDX-License-Identifier: Zlib
+
+#ifndef BLEND2D_UNICODE_UNICODESIMDIMPL_P_H_INCLUDED
+#define BLEND2D_UNICODE_UNICODESIMDIMPL_P_H_INCLUDED
+
+#include <blend2d/core/api-internal_p.h>
+#include <blend2d/simd/simd_p.h>
+#include <blend2d/support/intops_p.h>
+#include <blend2d/unicode/unicode_p.h>
+
+//! \cond INTERNAL
+
+namespace bl::Unicode {
+namespace {
+
+using namespace SIMD;
+
+// bl::Unicode - SIMD - Non-ASCII Mask
+// ===================================
+
+// Extracting MSB bits from 8-bit elements is different on X86 and ARM. X86 uses [V]PMOVMSKB, which provides a single
+// bit per byte, whereas ARM uses a narrowing shift, which provides a nibble per byte. The index of the first non-ASCII
+// code unit is calculated as `ctz(mask) >> kNonAsciiShiftU8` (or `kNonAsciiShiftU16` in case of UTF-16 code units).
+#if BL_TARGET_ARCH_X86
+
+static constexpr uint32_t kNonAsciiShiftU8 = 0u;
+static constexpr uint32_t kNonAsciiShiftU16 = 1u;
+
+template<typename V>
+static BL_INLINE_NODEBUG uint64_t non_ascii_mask_u8(const V& v) noexcept {
+  return uint64_t(extract_sign_bits_i8(v));
+}
+
+template<typename V>
+static BL_INLINE_NODEBUG uint64_t non_ascii_mask_u16(const V& v) noexcept {
+  return uint64_t(extract_sign_bits_i8(cmp_gt_u16(v, make_u16<V>(0x7Fu))));
+}
+
+#elif BL_TARGET_ARCH_ARM
+
+static constexpr uint32_t kNonAsciiShiftU8 = 2u;
+static constexpr uint32_t kNonAsciiShiftU16 = 3u;
+
+static BL_INLINE_NODEBUG uint64_t non_ascii_mask_u8(const Vec16xU8& v) noexcept {
+  return vget_lane_u64(simd_u64(vshrn_n_u16(simd_u16(srai_i8<7>(v).v), 4)), 0);
+}
+
+static BL_INLINE_NODEBUG uint64_t non_ascii_mask_u16(const Vec8xU16& v) noexcept {
+  return vget_lane_u64(simd_u64(vmovn_u16(simd_u16(cmp_gt_u16(v, make128_u16(0x7Fu)).v))), 0);
+}
+
+#endif
+
+// bl::Unicode - SIMD - ASCII Size
+// ===============================
+
+// Returns the number of leading ASCII code units in `src` of `size` code units, each having `kUnitSize` bytes. Vectors
+// of type `V` are used to scan the input and the last vector overlaps with the already scanned input to avoid a scalar
+// tail. The input must provide at least a single vector.
+template<typename V, uint32_t kUnitSize>
+static BL_INLINE size_t ascii_size_simd_impl(const uint8_t* src, size_t size) noexcept {
+  constexpr size_t kUnitsPerVec = sizeof(V) / kUnitSize;
+  BL_ASSERT(size >= kUnitsPerVec);
+
+  size_t i = 0;
+  size_t end = size - kUnitsPerVec;
+
+  for (;;) {
+    if (i > end)
+      i = end;
+
+    uint64_t mask;
+    if constexpr (kUnitSize == 1u)
+      mask = non_ascii_mask_u8(loadu<V>(src + i));
+    else
+      mask = non_ascii_mask_u16(loadu<V>(src + i * 2u));
+
+    if (mask)
+      return i + (IntOps::ctz(mask) >> (kUnitSize == 1u ? kNonAsciiShiftU8 : kNonAsciiShiftU16));
+
+    if (i == end)
+      return size;
+
+    i += kUnitsPerVec;
+  }
+}
+
+template<typename V>
+static BL_INLINE size_t ascii_size_u8_simd(const uint8_t* src, size_t size) noexcept {
+  if (size < sizeof(V)) {
+    size_t i = 0;
+    while (i < size && src[i] < 0x80u)
+      i++;
+    return i;
+  }
+
+  return ascii_size_simd_impl<V, 1>(src, size);
+}
+
+// Native UTF-16 code units, which don't have to be aligned - the scalar path uses unaligned reads as well.
+template<typename V>
+static BL_INLINE size_t ascii_size_u16_simd(const void* src, size_t size) noexcept {
+  const uint8_t* src8 = static_cast<const uint8_t*>(src);
+
+  if (size < sizeof(V) / 2u) {
+    size_t i = 0;
+    while (i < size && MemOps::readU16u(src8 + i * 2u) < 0x80u)
+      i++;
+    return i;
+  }
+
+  return ascii_size_simd_impl<V, 2>(src8, size);
+}
+
+// bl::Unicode - SIMD - ASCII To UTF-16 & UTF-32
+// =============================================
+
+// Converts leading ASCII code units of `src` to `dst` 16 code units at a time. A vector that contains a non-ASCII code
+// unit is not stored, its leading ASCII code units are converted by the scalar tail instead, so `dst` is never written
+// past the returned size.
+template<typename DstT>
+static BL_INLINE size_t ascii_to_wide_simd(void* dst, const uint8_t* src, size_t size) noexcept {
+  uint8_t* dst8 = static_cast<uint8_t*>(dst);
+  size_t i = 0;
+
+  while (size - i >= 16u) {
+    Vec16xU8 v = loadu<Vec16xU8>(src + i);
+    if (non_ascii_mask_u8(v))
+      break;
+
+    Vec16xU8 zero = make_zero<Vec16xU8>();
+    Vec16xU8 w0 = interleave_lo_u8(v, zero);
+    Vec16xU8 w1 = interleave_hi_u8(v, zero);
+
+    if constexpr (sizeof(DstT) == 2u) {
+      storeu(dst8 + i * 2u +  0u, w0);
+      storeu(dst8 + i * 2u + 16u, w1);
+    }
+    else {
+      storeu(dst8 + i * 4u +  0u, interleave_lo_u16(w0, zero));
+      storeu(dst8 + i * 4u + 16u, interleave_hi_u16(w0, zero));
+      storeu(dst8 + i * 4u + 32u, interleave_lo_u16(w1, zero));
+      storeu(dst8 + i * 4u + 48u, interleave_hi_u16(w1, zero));
+    }
+
+    i += 16u;
+  }
+
+  while (i < size && src[i] < 0x80u) {
+    if constexpr (sizeof(DstT) == 2u)
+      MemOps::writeU16u(dst8 + i * 2u, src[i]);
+    else
+      MemOps::writeU32u(dst8 + i * 4u, src[i]);
+    i++;
+  }
+
+  return i;
+}
+
+} // {anonymous}
+} // {bl::Unicode}
+
+//! \endcond
+
+#endif // BLEND2D_UNICODE_UNICODESIMDIMPL_P_H_INCLUDED